@@ -0,0 +1,67 @@
+#pragma once
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Benchmarks
+		{
+			///	\brief	Hardware performance counters, read around benchmark kernels
+			///
+			///	Uses perf_event_open on Linux. Counters only count user-mode events on the calling thread. On
+			///	other platforms, or if the kernel refuses access (see /proc/sys/kernel/perf_event_paranoid),
+			///	Open() returns false and benchmarks fall back to timing only.
+			///
+			class PerfCounters
+			{
+				public :
+
+					///	\brief	Counters
+					enum Counter
+					{
+						Cycles,
+						Instructions,
+						L1DataMisses,
+						LastLevelCacheMisses,
+						BranchMisses,
+
+						NumCounters
+					};
+
+					///	\brief	Default constructor. Counters are not opened until Open() is called
+					PerfCounters( );
+
+					///	\brief	Destructor. Closes counters
+					~PerfCounters( );
+
+					///	\brief	Opens counters. Returns false if no counters could be opened
+					bool Open( );
+
+					///	\brief	Returns true if a given counter was opened
+					bool IsAvailable( const Counter counter ) const;
+
+					///	\brief	Resets and starts all open counters
+					void Start( );
+
+					///	\brief	Stops all open counters, and reads their values
+					void Stop( );
+
+					///	\brief	Gets the value of a counter from the last Start()/Stop() pair. Scaled up if the counter was multiplexed
+					long long Get( const Counter counter ) const;
+
+					///	\brief	Gets the name of a counter
+					static const char* GetName( const Counter counter );
+
+				private :
+
+					int			m_Fds[ NumCounters ];
+					long long	m_Values[ NumCounters ];
+
+					//	Not copyable (owns file descriptors)
+					PerfCounters( const PerfCounters& );
+					PerfCounters& operator = ( const PerfCounters& );
+			};
+
+		}; //Benchmarks
+	}; //Fast
+}; //Poc1
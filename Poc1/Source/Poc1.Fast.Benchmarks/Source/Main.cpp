@@ -0,0 +1,824 @@
+#include "PerfCounters.h"
+#include "Instrumentation.h"
+#include "Mem.h"
+#include "Sse/SseNoise.h"
+#include "Sse/SseSimpleFractal.h"
+#include "Sse/SseRidgedFractal.h"
+#include "Sse/SsePlanetFractal.h"
+#include "Sse/SseHeightmapFunction.h"
+#include "Sse/SseCompositeFunctions.h"
+#include "Sse/SseSphereTerrainGenerator.h"
+#include "USphereCloudsAnimation.h"
+#include "USphereCloudsBitmap.h"
+#include "UTerrainTypeSelector.h"
+#include "UTerrainTileCodec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+///	\file	Native benchmark runner for the Poc1.Fast kernels
+///
+///	Usage: Poc1.Fast.Benchmarks [--perf] [--repeat <n>] [--filter <substring>]
+///
+///	Each kernel is run once to warm up, then <n> times (default 5). The fastest run is reported. With --perf,
+///	hardware counters are read around each run, and IPC and per-sample cycles, cache misses and branch
+///	misses are reported alongside the time.
+///
+
+using namespace Poc1::Fast;
+using namespace Poc1::Fast::Terrain;
+using namespace Poc1::Fast::Benchmarks;
+
+namespace
+{
+	///	\brief	Benchmark kernel interface
+	class Kernel
+	{
+		public :
+
+			virtual ~Kernel( ) { }
+
+			///	\brief	Gets the name of this kernel
+			virtual const char* GetName( ) const = 0;
+
+			///	\brief	Gets the number of samples (points, vertices or pixels) produced by each Run() call
+			virtual long long GetSamples( ) const = 0;
+
+			///	\brief	Runs the kernel
+			virtual void Run( ) = 0;
+	};
+
+	///	\brief	Sample points shared by the noise and fractal kernels
+	class SamplePoints
+	{
+		public :
+
+			enum { NumPoints = 1 << 16 };
+
+			SamplePoints( )
+			{
+				m_X = new ( Aligned( 16 ) ) float[ NumPoints ];
+				m_Y = new ( Aligned( 16 ) ) float[ NumPoints ];
+				m_Z = new ( Aligned( 16 ) ) float[ NumPoints ];
+				m_Results = new ( Aligned( 16 ) ) float[ NumPoints ];
+				srand( 1 );
+				for ( int index = 0; index < NumPoints; ++index )
+				{
+					m_X[ index ] = ( float( rand( ) ) / float( RAND_MAX ) ) * 64.0f;
+					m_Y[ index ] = ( float( rand( ) ) / float( RAND_MAX ) ) * 64.0f;
+					m_Z[ index ] = ( float( rand( ) ) / float( RAND_MAX ) ) * 64.0f;
+				}
+			}
+
+			~SamplePoints( )
+			{
+				AlignedArrayDelete( m_X );
+				AlignedArrayDelete( m_Y );
+				AlignedArrayDelete( m_Z );
+				AlignedArrayDelete( m_Results );
+			}
+
+			float* m_X;
+			float* m_Y;
+			float* m_Z;
+			float* m_Results;
+	};
+
+	///	\brief	Evaluates a function (noise or fractal) over the sample points
+	template < typename FunctionType >
+	class FunctionKernel : public Kernel
+	{
+		public :
+
+			FunctionKernel( const char* name, const FunctionType& function, SamplePoints& points ) :
+				m_Name( name ),
+				m_Function( function ),
+				m_Points( points )
+			{
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return m_Name;
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return SamplePoints::NumPoints;
+			}
+
+			virtual void Run( )
+			{
+				for ( int index = 0; index < SamplePoints::NumPoints; index += 4 )
+				{
+					const __m128 xxxx = _mm_load_ps( m_Points.m_X + index );
+					const __m128 yyyy = _mm_load_ps( m_Points.m_Y + index );
+					const __m128 zzzz = _mm_load_ps( m_Points.m_Z + index );
+					_mm_store_ps( m_Points.m_Results + index, Evaluate( m_Function, xxxx, yyyy, zzzz ) );
+				}
+			}
+
+		private :
+
+			static __m128 Evaluate( const SseNoise& noise, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz )
+			{
+				return noise.Noise( xxxx, yyyy, zzzz );
+			}
+
+			template < typename FractalType >
+			static __m128 Evaluate( const FractalType& fractal, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz )
+			{
+				return fractal.GetValue( xxxx, yyyy, zzzz );
+			}
+
+			const char*			m_Name;
+			const FunctionType&	m_Function;
+			SamplePoints&		m_Points;
+	};
+
+	///	\brief	Generates a sphere terrain patch with SseSphereTerrainGeneratorT::GenerateVertices()
+	template < typename GeneratorType >
+	class SpherePatchKernel : public Kernel
+	{
+		public :
+
+			enum { PatchSize = 129 };
+
+			SpherePatchKernel( const char* name ) :
+				m_Name( name )
+			{
+				m_Generator = new ( Aligned( 16 ) ) GeneratorType;
+				m_Vertices.resize( PatchSize * PatchSize );
+			}
+
+			~SpherePatchKernel( )
+			{
+				AlignedDelete( m_Generator );
+			}
+
+			GeneratorType& GetGenerator( )
+			{
+				return *m_Generator;
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return m_Name;
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return PatchSize * PatchSize;
+			}
+
+			virtual void Run( )
+			{
+				//	Patch covers the positive y cube face
+				const float origin[ 3 ] = { -1, 1, -1 };
+				const float xStep[ 3 ] = { 2.0f / ( PatchSize - 1 ), 0, 0 };
+				const float zStep[ 3 ] = { 0, 0, 2.0f / ( PatchSize - 1 ) };
+				const float uv[ 2 ] = { 0, 0 };
+				m_Generator->GenerateVertices( origin, xStep, zStep, PatchSize, PatchSize, uv, 1.0f, &m_Vertices[ 0 ] );
+			}
+
+		private :
+
+			const char*						m_Name;
+			GeneratorType*					m_Generator;
+			std::vector< UTerrainVertex >	m_Vertices;
+	};
+
+	///	\brief	Decodes a baked terrain tile with UTerrainTileCodec::Decode(), to compare with generating the patch
+	template < typename GeneratorType >
+	class TerrainTileDecodeKernel : public Kernel
+	{
+		public :
+
+			enum { PatchSize = 129 };
+
+			TerrainTileDecodeKernel( const char* name ) :
+				m_Name( name )
+			{
+				//	The tile is the same patch as SpherePatchKernel, encoded once
+				GeneratorType* generator = new ( Aligned( 16 ) ) GeneratorType;
+				m_Vertices.resize( PatchSize * PatchSize );
+				const float origin[ 3 ] = { -1, 1, -1 };
+				const float xStep[ 3 ] = { 2.0f / ( PatchSize - 1 ), 0, 0 };
+				const float zStep[ 3 ] = { 0, 0, 2.0f / ( PatchSize - 1 ) };
+				const float uv[ 2 ] = { 0, 0 };
+				generator->GenerateVertices( origin, xStep, zStep, PatchSize, PatchSize, uv, 1.0f, &m_Vertices[ 0 ] );
+				UTerrainTileCodec::Encode( ( const float* )&m_Vertices[ 0 ], PatchSize, PatchSize, VertexChannels, m_Encoded );
+				AlignedDelete( generator );
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return m_Name;
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return PatchSize * PatchSize;
+			}
+
+			virtual void Run( )
+			{
+				UTerrainTileCodec::Decode( &m_Encoded[ 0 ], int( m_Encoded.size( ) ), PatchSize, PatchSize, VertexChannels, ( float* )&m_Vertices[ 0 ] );
+			}
+
+		private :
+
+			enum { VertexChannels = sizeof( UTerrainVertex ) / sizeof( float ) };
+
+			const char*						m_Name;
+			std::vector< unsigned char >	m_Encoded;
+			std::vector< UTerrainVertex >	m_Vertices;
+	};
+
+	///	\brief	Generates a terrain property cube map face with SseSphereTerrainGeneratorT::GenerateTerrainPropertyCubeMapFace()
+	///
+	///	If mipLevels is not 0, the face is generated with that many mip levels below it. If compress is true, the
+	///	face is also compressed to BC5 blocks.
+	///
+	template < typename GeneratorType >
+	class PropertyFaceKernel : public Kernel
+	{
+		public :
+
+			enum { FaceSize = 256 };
+
+			PropertyFaceKernel( const char* name, const int mipLevels = 0, const bool compress = false ) :
+				m_Name( name ),
+				m_Compressor( UBlockCompressor::Bc5, 0, UBlockCompressor::GetBlockRowSize( UBlockCompressor::Bc5, FaceSize ) )
+			{
+				m_Generator = new ( Aligned( 16 ) ) GeneratorType;
+				m_Pixels.resize( FaceSize * FaceSize * 3 );
+				m_MipPixels.resize( mipLevels );
+				for ( int level = 0; level < mipLevels; ++level )
+				{
+					const int size = UMipChain::GetLevelSize( FaceSize, level );
+					m_MipPixels[ level ].resize( size * size * 3 );
+					m_MipChain.AddLevel( &m_MipPixels[ level ][ 0 ], size * 3 );
+				}
+				if ( compress )
+				{
+					m_Blocks.resize( ( FaceSize / 4 ) * UBlockCompressor::GetBlockRowSize( UBlockCompressor::Bc5, FaceSize ) );
+					m_Compressor = UBlockCompressor( UBlockCompressor::Bc5, &m_Blocks[ 0 ], UBlockCompressor::GetBlockRowSize( UBlockCompressor::Bc5, FaceSize ) );
+				}
+			}
+
+			~PropertyFaceKernel( )
+			{
+				AlignedDelete( m_Generator );
+			}
+
+			GeneratorType& GetGenerator( )
+			{
+				return *m_Generator;
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return m_Name;
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return FaceSize * FaceSize;
+			}
+
+			virtual void Run( )
+			{
+				m_Generator->GenerateTerrainPropertyCubeMapFace( PositiveY, FaceSize, FaceSize, FaceSize * 3, &m_Pixels[ 0 ], m_MipChain.GetLevels( ) > 0 ? &m_MipChain : 0, m_Blocks.empty( ) ? 0 : &m_Compressor );
+			}
+
+		private :
+
+			const char*										m_Name;
+			GeneratorType*									m_Generator;
+			std::vector< unsigned char >					m_Pixels;
+			std::vector< std::vector< unsigned char > >	m_MipPixels;
+			UMipChain										m_MipChain;
+			std::vector< unsigned char >					m_Blocks;
+			UBlockCompressor								m_Compressor;
+	};
+
+	///	\brief	Generates all six terrain property cube map faces with SseSphereTerrainGeneratorT::GenerateTerrainPropertyCubeMap()
+	template < typename GeneratorType >
+	class PropertyCubeMapKernel : public Kernel
+	{
+		public :
+
+			enum { FaceSize = 256 };
+
+			PropertyCubeMapKernel( const char* name ) :
+				m_Name( name )
+			{
+				m_Generator = new ( Aligned( 16 ) ) GeneratorType;
+				m_Pixels.resize( FaceSize * FaceSize * 3 * 6 );
+				for ( int face = 0; face < 6; ++face )
+				{
+					m_FacePixels[ face ] = &m_Pixels[ face * FaceSize * FaceSize * 3 ];
+				}
+			}
+
+			~PropertyCubeMapKernel( )
+			{
+				AlignedDelete( m_Generator );
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return m_Name;
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return FaceSize * FaceSize * 6;
+			}
+
+			virtual void Run( )
+			{
+				m_Generator->GenerateTerrainPropertyCubeMap( FaceSize, FaceSize * 3, m_FacePixels, 0, 0 );
+			}
+
+		private :
+
+			const char*						m_Name;
+			GeneratorType*					m_Generator;
+			std::vector< unsigned char >	m_Pixels;
+			unsigned char*					m_FacePixels[ 6 ];
+	};
+
+	///	\brief	Generates a terrain type cube map face with SseSphereTerrainGeneratorT::GenerateTerrainTypeCubeMapFace()
+	template < typename GeneratorType >
+	class TerrainTypeFaceKernel : public Kernel
+	{
+		public :
+
+			enum { FaceSize = 256 };
+
+			TerrainTypeFaceKernel( const char* name ) :
+				m_Name( name )
+			{
+				m_Generator = new ( Aligned( 16 ) ) GeneratorType;
+				m_Pixels.resize( FaceSize * FaceSize * 4 );
+
+				//	A 2x4x4 table, so every colour is blended from 8 different cells
+				m_Selector.SetSize( 2, 4, 4 );
+				for ( int latitude = 0; latitude < 2; ++latitude )
+				{
+					for ( int height = 0; height < 4; ++height )
+					{
+						for ( int slope = 0; slope < 4; ++slope )
+						{
+							const unsigned char type = ( unsigned char )( ( latitude * 4 + height ) * 4 + slope );
+							m_Selector.SetCell( latitude, height, slope, UColour( type * 8, height * 64, slope * 64, 255 ), type );
+						}
+					}
+				}
+			}
+
+			~TerrainTypeFaceKernel( )
+			{
+				AlignedDelete( m_Generator );
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return m_Name;
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return FaceSize * FaceSize;
+			}
+
+			virtual void Run( )
+			{
+				m_Generator->GenerateTerrainTypeCubeMapFace( PositiveY, m_Selector, FormatR8G8B8A8, FaceSize, FaceSize, FaceSize * 4, &m_Pixels[ 0 ], 0 );
+			}
+
+		private :
+
+			const char*						m_Name;
+			GeneratorType*					m_Generator;
+			UTerrainTypeSelector			m_Selector;
+			std::vector< unsigned char >	m_Pixels;
+	};
+
+	///	\brief	Generates a cloud cube map face with USphereCloudsBitmap::GenerateCloudsFace()
+	class CloudsFaceKernel : public Kernel
+	{
+		public :
+
+			enum { FaceSize = 256 };
+
+			CloudsFaceKernel( )
+			{
+				m_Clouds = new ( Aligned( 16 ) ) USphereCloudsBitmap;
+				m_Clouds->Setup( 0, 0, 0.1f, 0.4f );
+				m_Pixels.resize( FaceSize * FaceSize * 4 );
+			}
+
+			~CloudsFaceKernel( )
+			{
+				AlignedDelete( m_Clouds );
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return "GenerateCloudsFace";
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return FaceSize * FaceSize;
+			}
+
+			virtual void Run( )
+			{
+				m_Clouds->GenerateCloudsFace( PositiveY, FormatR8G8B8A8, FaceSize, FaceSize, FaceSize * 4, &m_Pixels[ 0 ], 0, 0 );
+			}
+
+		private :
+
+			USphereCloudsBitmap*			m_Clouds;
+			std::vector< unsigned char >	m_Pixels;
+	};
+
+	///	\brief	Advances a cloud animation by a frame, and writes all 6 blended faces
+	class CloudsAnimationKernel : public Kernel
+	{
+		public :
+
+			enum { FaceSize = 256, FramesPerKey = 60 };
+
+			CloudsAnimationKernel( ) :
+				m_Animation( FaceSize, FaceSize, FramesPerKey )
+			{
+				m_Animation.Start( 0, 0, 0.05f, 0.02f, 0.1f, 0.4f );
+				m_Pixels.resize( FaceSize * FaceSize * 4 );
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return "CloudsAnimation(frame)";
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return FaceSize * FaceSize * 6;
+			}
+
+			virtual void Run( )
+			{
+				m_Animation.Update( );
+				for ( int face = 0; face < 6; ++face )
+				{
+					m_Animation.GetCloudsFace( UCubeMapFace( face ), FormatR8G8B8A8, FaceSize * 4, &m_Pixels[ 0 ], 0, 0 );
+				}
+			}
+
+		private :
+
+			USphereCloudsAnimation			m_Animation;
+			std::vector< unsigned char >	m_Pixels;
+	};
+
+	///	\brief	Generates a 3 channel tiled noise bitmap with SseNoise::GenerateTiledBitmap()
+	class TiledBitmapKernel : public Kernel
+	{
+		public :
+
+			enum { BitmapSize = 256 };
+
+			TiledBitmapKernel( const SseNoise& noise ) :
+				m_Noise( noise ),
+				m_Pixels( BitmapSize * BitmapSize * 3 )
+			{
+			}
+
+			virtual const char* GetName( ) const
+			{
+				return "TiledBitmap(3 channels)";
+			}
+
+			virtual long long GetSamples( ) const
+			{
+				return BitmapSize * BitmapSize;
+			}
+
+			virtual void Run( )
+			{
+				m_Noise.GenerateTiledBitmap( BitmapSize, BitmapSize, BitmapSize * 3, 3, true, &m_Pixels[ 0 ], 0, 0, 16, 16 );
+			}
+
+		private :
+
+			const SseNoise&					m_Noise;
+			std::vector< unsigned char >	m_Pixels;
+	};
+
+	///	\brief	Function scale (sphere radius) of the planet fractal kernels
+	const float PlanetRadius = 6.0f;
+
+	///	\brief	Sets up the planet fractal displacer of a generator. Uses a continent mask if mask is not null
+	template < typename GeneratorType >
+	void SetupPlanet( GeneratorType& generator, const SseContinentMask* mask )
+	{
+		generator.GetDisplacer( ).SetFunctionScale( PlanetRadius );
+		generator.GetDisplacer( ).Setup( 64, 1.0f, 3.0f );
+		generator.GetDisplacer( ).GetFunction( ).SetContinentMask( mask );
+	}
+
+	///	\brief	Heightmap file written for the heightmap kernels
+	const char* HeightmapPath = "Poc1.Fast.Benchmarks.heightmap";
+
+	///	\brief	Writes a 16-bit heightmap of fractal heights, as an authoring tool would. Returns false if the file could not be written
+	template < typename FractalType >
+	bool WriteHeightmap( const FractalType& fractal, const int resolution )
+	{
+		UHeightmapWriter writer;
+		if ( !writer.Start( HeightmapPath, HeightmapUnsigned16, ProjectionGnomonic, resolution, 64, 0, 1 ) )
+		{
+			return false;
+		}
+		FAST_ALIGN( 16 ) float heights[ 4 ];
+		std::vector< float > row( resolution );
+		const float inc = 2.0f / float( resolution - 1 );
+		for ( int face = 0; face < 6; ++face )
+		{
+			for ( int rowIndex = 0; rowIndex < resolution; ++rowIndex )
+			{
+				const __m128 vvvv = _mm_set1_ps( -1.0f + inc * float( rowIndex ) );
+				for ( int col = 0; col < resolution; col += 4 )
+				{
+					const __m128 uuuu = _mm_add_ps( _mm_set1_ps( -1.0f + inc * float( col ) ), _mm_set_ps( inc * 3, inc * 2, inc, 0 ) );
+					__m128 xxxx, yyyy, zzzz;
+					CubeFacePosition( UCubeMapFace( face ), uuuu, vvvv, xxxx, yyyy, zzzz );
+					_mm_store_ps( heights, fractal.GetValue( xxxx, yyyy, zzzz ) );
+					for ( int lane = 0; ( lane < 4 ) && ( col + lane < resolution ); ++lane )
+					{
+						row[ col + lane ] = heights[ lane ];
+					}
+				}
+				writer.WriteRow( &row[ 0 ] );
+			}
+		}
+		return writer.Finish( );
+	}
+
+	///	\brief	Sets up the heightmap displacer of a generator, to sample the file written by WriteHeightmap()
+	template < typename GeneratorType >
+	void SetupHeightmap( GeneratorType& generator, const SseHeightmapFunction::Filter filter )
+	{
+		generator.GetDisplacer( ).Setup( 64, 1.0f, 3.0f );
+		generator.GetDisplacer( ).GetFunction( ).Open( HeightmapPath );
+		generator.GetDisplacer( ).GetFunction( ).SetFilter( filter );
+	}
+
+	///	\brief	Composite planet function: plains or ridged mountains, selected by a low frequency fractal, blended into smooth poles
+	typedef SseLatitudeBlendFunction
+	<
+		SseSelectFunction< SseSimpleFractal, SseScaleFunction< SseSimpleFractal >, SseRidgedFractal >,
+		SseScaleFunction< SseSimpleFractal >
+	> CompositeFunction;
+
+	///	\brief	Sets up the composite function displacer of a generator
+	template < typename GeneratorType >
+	void SetupComposite( GeneratorType& generator )
+	{
+		CompositeFunction& function = generator.GetDisplacer( ).GetFunction( );
+		function.GetEquator( ).GetControl( ).Setup( 2.0f, 0.5f, 2 );
+		function.GetEquator( ).GetFirst( ).GetFunction( ).Setup( 2.0f, 0.5f, 8 );
+		function.GetEquator( ).GetFirst( ).SetScale( 0.25f, 0 );
+		function.GetPole( ).GetFunction( ).Setup( 2.0f, 0.5f, 4 );
+		function.GetPole( ).SetScale( 0.5f, 0.25f );
+	}
+
+	///	\brief	Sets up the ground function of a ground displacer generator, and its ground field (SseSphereFunction3dGroundDisplacer::SetGroundField())
+	template < typename GeneratorType >
+	void SetupGround( GeneratorType& generator, const bool groundField, const float spacing )
+	{
+		generator.GetDisplacer( ).GetFunction( ).Setup( 2.0f, 0.5f, 8 );
+		generator.GetDisplacer( ).SetGroundField( groundField, spacing );
+	}
+
+	///	\brief	Runs a kernel and prints its results
+	void RunKernel( Kernel& kernel, const int repeat, PerfCounters* counters )
+	{
+		const double secondsPerTick = 1.0 / double( Instrumentation::GetTicksPerSecond( ) );
+
+		kernel.Run( );
+
+		double bestSeconds = 0;
+		long long bestValues[ PerfCounters::NumCounters ] = { 0 };
+		for ( int run = 0; run < repeat; ++run )
+		{
+			if ( counters )
+			{
+				counters->Start( );
+			}
+			const long long start = Instrumentation::GetTicks( );
+			kernel.Run( );
+			const double seconds = double( Instrumentation::GetTicks( ) - start ) * secondsPerTick;
+			if ( counters )
+			{
+				counters->Stop( );
+			}
+
+			if ( ( run == 0 ) || ( seconds < bestSeconds ) )
+			{
+				bestSeconds = seconds;
+				for ( int counter = 0; counters && ( counter < PerfCounters::NumCounters ); ++counter )
+				{
+					bestValues[ counter ] = counters->Get( ( PerfCounters::Counter )counter );
+				}
+			}
+		}
+
+		const long long samples = kernel.GetSamples( );
+		printf( "%-40s %10lld %12.3f", kernel.GetName( ), samples, ( bestSeconds * 1e9 ) / double( samples ) );
+		if ( counters )
+		{
+			if ( counters->IsAvailable( PerfCounters::Cycles ) && counters->IsAvailable( PerfCounters::Instructions ) && ( bestValues[ PerfCounters::Cycles ] > 0 ) )
+			{
+				printf( " %8.2f", double( bestValues[ PerfCounters::Instructions ] ) / double( bestValues[ PerfCounters::Cycles ] ) );
+			}
+			else
+			{
+				printf( " %8s", "-" );
+			}
+			for ( int counter = 0; counter < PerfCounters::NumCounters; ++counter )
+			{
+				if ( counter == PerfCounters::Instructions )
+				{
+					continue;
+				}
+				if ( counters->IsAvailable( ( PerfCounters::Counter )counter ) )
+				{
+					printf( " %12.3f", double( bestValues[ counter ] ) / double( samples ) );
+				}
+				else
+				{
+					printf( " %12s", "-" );
+				}
+			}
+		}
+		printf( "\n" );
+	}
+}
+
+int main( int argc, char** argv )
+{
+	bool usePerf = false;
+	int repeat = 5;
+	const char* filter = 0;
+	for ( int arg = 1; arg < argc; ++arg )
+	{
+		if ( strcmp( argv[ arg ], "--perf" ) == 0 )
+		{
+			usePerf = true;
+		}
+		else if ( ( strcmp( argv[ arg ], "--repeat" ) == 0 ) && ( arg + 1 < argc ) )
+		{
+			repeat = atoi( argv[ ++arg ] );
+			repeat = repeat < 1 ? 1 : repeat;
+		}
+		else if ( ( strcmp( argv[ arg ], "--filter" ) == 0 ) && ( arg + 1 < argc ) )
+		{
+			filter = argv[ ++arg ];
+		}
+		else
+		{
+			fprintf( stderr, "Usage: %s [--perf] [--repeat <n>] [--filter <substring>]\n", argv[ 0 ] );
+			return 1;
+		}
+	}
+
+	PerfCounters perfCounters;
+	PerfCounters* counters = 0;
+	if ( usePerf )
+	{
+		if ( perfCounters.Open( ) )
+		{
+			counters = &perfCounters;
+		}
+		else
+		{
+			fprintf( stderr, "Hardware performance counters are not available; reporting timings only\n" );
+		}
+	}
+
+	SamplePoints points;
+	SseNoise* noise = new ( Aligned( 16 ) ) SseNoise( 1 );
+	SseSimpleFractal* simpleFractal = new ( Aligned( 16 ) ) SseSimpleFractal( 1 );
+	simpleFractal->Setup( 2.0f, 0.5f, 8 );
+	SseRidgedFractal* ridgedFractal = new ( Aligned( 16 ) ) SseRidgedFractal( 1 );
+	SsePlanetFractal* planetFractal = new ( Aligned( 16 ) ) SsePlanetFractal( 1 );
+
+	//	The continent mask is baked once, outside the timed runs, as it would be once per planet
+	SseContinentMask* continentMask = new ( Aligned( 16 ) ) SseContinentMask;
+	continentMask->Bake< SseExactPrecision >( *planetFractal, PlanetRadius, planetFractal->GetContinentMaskResolution( PlanetRadius, 8 ) );
+
+	typedef SseSphereTerrainGeneratorT< SseFlatSphereTerrainDisplacer > FlatSphereGenerator;
+	typedef SseSphereTerrainGeneratorT< SseSphereFunction3dDisplacer< SseRidgedFractal > > RidgedSphereGenerator;
+	typedef SseSphereTerrainGeneratorT< SseSphereFunction3dGroundDisplacer< SseSphereFunction3dDisplacer< SseRidgedFractal >, SseSimpleFractal > > GroundSphereGenerator;
+	typedef SseSphereTerrainGeneratorT< SseSphereFunction3dDisplacer< SsePlanetFractal > > PlanetSphereGenerator;
+	typedef SseSphereTerrainGeneratorT< SseSphereFunction3dDisplacer< SseHeightmapFunction > > HeightmapSphereGenerator;
+	typedef SseSphereTerrainGeneratorT< SseSphereFunction3dDisplacer< CompositeFunction > > CompositeSphereGenerator;
+
+	std::vector< Kernel* > kernels;
+	kernels.push_back( new FunctionKernel< SseNoise >( "SseNoise::Noise", *noise, points ) );
+	kernels.push_back( new FunctionKernel< SseSimpleFractal >( "SseSimpleFractal::GetValue(8 octaves)", *simpleFractal, points ) );
+	kernels.push_back( new FunctionKernel< SseRidgedFractal >( "SseRidgedFractal::GetValue(8 octaves)", *ridgedFractal, points ) );
+	kernels.push_back( new FunctionKernel< SsePlanetFractal >( "SsePlanetFractal::GetValue(8 octaves)", *planetFractal, points ) );
+	kernels.push_back( new TiledBitmapKernel( *noise ) );
+
+	//	The flat displacer patch measures vertex setup, normals and stores without any noise evaluation
+	kernels.push_back( new SpherePatchKernel< FlatSphereGenerator >( "GenerateVertices(flat)" ) );
+	kernels.push_back( new SpherePatchKernel< RidgedSphereGenerator >( "GenerateVertices(ridged)" ) );
+	SpherePatchKernel< GroundSphereGenerator >* groundPatch = new SpherePatchKernel< GroundSphereGenerator >( "GenerateVertices(ridged+ground)" );
+	SpherePatchKernel< GroundSphereGenerator >* groundFieldPatch = new SpherePatchKernel< GroundSphereGenerator >( "GenerateVertices(ridged+ground field)" );
+	SpherePatchKernel< GroundSphereGenerator >* reducedGroundFieldPatch = new SpherePatchKernel< GroundSphereGenerator >( "GenerateVertices(ridged+ground field/2)" );
+	SetupGround( groundPatch->GetGenerator( ), false, 0 );
+	SetupGround( groundFieldPatch->GetGenerator( ), true, 0 );
+	SetupGround( reducedGroundFieldPatch->GetGenerator( ), true, 1.0f );
+	kernels.push_back( groundPatch );
+	kernels.push_back( groundFieldPatch );
+	kernels.push_back( reducedGroundFieldPatch );
+	kernels.push_back( new TerrainTileDecodeKernel< GroundSphereGenerator >( "UTerrainTileCodec::Decode(ridged+ground)" ) );
+	SpherePatchKernel< CompositeSphereGenerator >* compositePatch = new SpherePatchKernel< CompositeSphereGenerator >( "GenerateVertices(composite)" );
+	SetupComposite( compositePatch->GetGenerator( ) );
+	kernels.push_back( compositePatch );
+	kernels.push_back( new PropertyFaceKernel< RidgedSphereGenerator >( "GenerateTerrainPropertyCubeMapFace" ) );
+	kernels.push_back( new PropertyFaceKernel< RidgedSphereGenerator >( "GenerateTerrainPropertyCubeMapFace(mips)", 8 ) );
+	kernels.push_back( new PropertyFaceKernel< RidgedSphereGenerator >( "GenerateTerrainPropertyCubeMapFace(bc5)", 0, true ) );
+	kernels.push_back( new PropertyCubeMapKernel< RidgedSphereGenerator >( "GenerateTerrainPropertyCubeMap(6 faces)" ) );
+	kernels.push_back( new TerrainTypeFaceKernel< RidgedSphereGenerator >( "GenerateTerrainTypeCubeMapFace" ) );
+	kernels.push_back( new CloudsFaceKernel );
+	kernels.push_back( new CloudsAnimationKernel );
+
+	SpherePatchKernel< PlanetSphereGenerator >* planetPatch = new SpherePatchKernel< PlanetSphereGenerator >( "GenerateVertices(planet)" );
+	SpherePatchKernel< PlanetSphereGenerator >* maskedPlanetPatch = new SpherePatchKernel< PlanetSphereGenerator >( "GenerateVertices(planet+mask)" );
+	PropertyFaceKernel< PlanetSphereGenerator >* planetFace = new PropertyFaceKernel< PlanetSphereGenerator >( "PropertyCubeMapFace(planet)" );
+	PropertyFaceKernel< PlanetSphereGenerator >* maskedPlanetFace = new PropertyFaceKernel< PlanetSphereGenerator >( "PropertyCubeMapFace(planet+mask)" );
+	SetupPlanet( planetPatch->GetGenerator( ), 0 );
+	SetupPlanet( maskedPlanetPatch->GetGenerator( ), continentMask );
+	SetupPlanet( planetFace->GetGenerator( ), 0 );
+	SetupPlanet( maskedPlanetFace->GetGenerator( ), continentMask );
+	kernels.push_back( planetPatch );
+	kernels.push_back( maskedPlanetPatch );
+	kernels.push_back( planetFace );
+	kernels.push_back( maskedPlanetFace );
+
+	//	The heightmap is written once, outside the timed runs. Patches cover about 4 texels per vertex
+	if ( WriteHeightmap( *ridgedFractal, 513 ) )
+	{
+		SpherePatchKernel< HeightmapSphereGenerator >* heightmapPatch = new SpherePatchKernel< HeightmapSphereGenerator >( "GenerateVertices(heightmap)" );
+		SpherePatchKernel< HeightmapSphereGenerator >* bicubicHeightmapPatch = new SpherePatchKernel< HeightmapSphereGenerator >( "GenerateVertices(heightmap bicubic)" );
+		SetupHeightmap( heightmapPatch->GetGenerator( ), SseHeightmapFunction::FilterBilinear );
+		SetupHeightmap( bicubicHeightmapPatch->GetGenerator( ), SseHeightmapFunction::FilterBicubic );
+		kernels.push_back( heightmapPatch );
+		kernels.push_back( bicubicHeightmapPatch );
+	}
+	else
+	{
+		fprintf( stderr, "Failed to write \"%s\"; skipping heightmap kernels\n", HeightmapPath );
+	}
+
+	printf( "%-40s %10s %12s", "kernel", "samples", "ns/sample" );
+	if ( counters )
+	{
+		printf( " %8s", "IPC" );
+		for ( int counter = 0; counter < PerfCounters::NumCounters; ++counter )
+		{
+			if ( counter != PerfCounters::Instructions )
+			{
+				printf( " %12s", PerfCounters::GetName( ( PerfCounters::Counter )counter ) );
+			}
+		}
+		printf( "\n%-40s %10s %12s %8s %12s %12s %12s %12s", "", "", "", "", "/sample", "/sample", "/sample", "/sample" );
+	}
+	printf( "\n" );
+
+	for ( size_t index = 0; index < kernels.size( ); ++index )
+	{
+		if ( ( filter == 0 ) || ( strstr( kernels[ index ]->GetName( ), filter ) != 0 ) )
+		{
+			RunKernel( *kernels[ index ], repeat, counters );
+		}
+		delete kernels[ index ];
+	}
+
+	remove( HeightmapPath );
+	AlignedDelete( continentMask );
+	AlignedDelete( planetFractal );
+	AlignedDelete( ridgedFractal );
+	AlignedDelete( simpleFractal );
+	AlignedDelete( noise );
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Benchmarks
+		{
+			PerfCounters::PerfCounters( )
+			{
+				for ( int counter = 0; counter < NumCounters; ++counter )
+				{
+					m_Fds[ counter ] = -1;
+					m_Values[ counter ] = 0;
+				}
+			}
+
+			PerfCounters::~PerfCounters( )
+			{
+			#ifdef __linux__
+				for ( int counter = 0; counter < NumCounters; ++counter )
+				{
+					if ( m_Fds[ counter ] >= 0 )
+					{
+						close( m_Fds[ counter ] );
+					}
+				}
+			#endif
+			}
+
+			const char* PerfCounters::GetName( const Counter counter )
+			{
+				switch ( counter )
+				{
+					case Cycles					: return "cycles";
+					case Instructions			: return "instructions";
+					case L1DataMisses			: return "L1D misses";
+					case LastLevelCacheMisses	: return "LLC misses";
+					case BranchMisses			: return "branch misses";
+					default						: break;
+				}
+				return "unknown";
+			}
+
+			bool PerfCounters::IsAvailable( const Counter counter ) const
+			{
+				return m_Fds[ counter ] >= 0;
+			}
+
+			long long PerfCounters::Get( const Counter counter ) const
+			{
+				return m_Values[ counter ];
+			}
+
+		#ifdef __linux__
+
+			bool PerfCounters::Open( )
+			{
+				const unsigned int types[ NumCounters ] =
+				{
+					PERF_TYPE_HARDWARE,
+					PERF_TYPE_HARDWARE,
+					PERF_TYPE_HW_CACHE,
+					PERF_TYPE_HARDWARE,
+					PERF_TYPE_HARDWARE
+				};
+				const unsigned long long configs[ NumCounters ] =
+				{
+					PERF_COUNT_HW_CPU_CYCLES,
+					PERF_COUNT_HW_INSTRUCTIONS,
+					PERF_COUNT_HW_CACHE_L1D | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ),
+					PERF_COUNT_HW_CACHE_MISSES,
+					PERF_COUNT_HW_BRANCH_MISSES
+				};
+
+				//	Counters are opened individually rather than as a group, so that a counter the PMU can't
+				//	schedule doesn't stop the others from counting. Multiplexed counters are scaled in Stop()
+				bool anyOpen = false;
+				for ( int counter = 0; counter < NumCounters; ++counter )
+				{
+					perf_event_attr attr;
+					memset( &attr, 0, sizeof( attr ) );
+					attr.size = sizeof( attr );
+					attr.type = types[ counter ];
+					attr.config = configs[ counter ];
+					attr.disabled = 1;
+					attr.exclude_kernel = 1;
+					attr.exclude_hv = 1;
+					attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+					m_Fds[ counter ] = ( int )syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+					anyOpen = anyOpen || ( m_Fds[ counter ] >= 0 );
+				}
+				return anyOpen;
+			}
+
+			void PerfCounters::Start( )
+			{
+				for ( int counter = 0; counter < NumCounters; ++counter )
+				{
+					if ( m_Fds[ counter ] >= 0 )
+					{
+						ioctl( m_Fds[ counter ], PERF_EVENT_IOC_RESET, 0 );
+						ioctl( m_Fds[ counter ], PERF_EVENT_IOC_ENABLE, 0 );
+					}
+				}
+			}
+
+			void PerfCounters::Stop( )
+			{
+				for ( int counter = 0; counter < NumCounters; ++counter )
+				{
+					if ( m_Fds[ counter ] >= 0 )
+					{
+						ioctl( m_Fds[ counter ], PERF_EVENT_IOC_DISABLE, 0 );
+					}
+				}
+				for ( int counter = 0; counter < NumCounters; ++counter )
+				{
+					m_Values[ counter ] = 0;
+
+					//	value, time enabled, time running
+					unsigned long long values[ 3 ];
+					if ( ( m_Fds[ counter ] < 0 ) || ( read( m_Fds[ counter ], values, sizeof( values ) ) != sizeof( values ) ) )
+					{
+						continue;
+					}
+					if ( ( values[ 2 ] > 0 ) && ( values[ 2 ] < values[ 1 ] ) )
+					{
+						m_Values[ counter ] = ( long long )( double( values[ 0 ] ) * double( values[ 1 ] ) / double( values[ 2 ] ) );
+					}
+					else
+					{
+						m_Values[ counter ] = ( long long )values[ 0 ];
+					}
+				}
+			}
+
+		#else
+
+			bool PerfCounters::Open( )
+			{
+				return false;
+			}
+
+			void PerfCounters::Start( )
+			{
+			}
+
+			void PerfCounters::Stop( )
+			{
+			}
+
+		#endif
+
+		}; //Benchmarks
+	}; //Fast
+}; //Poc1
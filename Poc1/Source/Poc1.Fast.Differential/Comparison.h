@@ -0,0 +1,77 @@
+#pragma once
+
+#include "UTerrainVertex.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Differential
+		{
+			///	\brief	Tolerances used when comparing an optimized variant against the scalar reference
+			struct Tolerance
+			{
+				long long	m_Ulps;		///<	Largest allowed difference between floats, in units in the last place
+				float		m_Absolute;	///<	Float differences up to this size are allowed whatever their ULP difference (for values near zero)
+				int			m_Bytes;	///<	Largest allowed difference between bytes, measured modulo 256
+			};
+
+			///	\brief	Gets the distance between two floats, in units in the last place
+			///
+			///	+0 and -0 are the same. NaNs are equal to each other, and infinitely far from everything else.
+			///
+			long long GetUlpDistance( const float a, const float b );
+
+			///	\brief	Accumulates the differences between reference and optimized outputs for a single check
+			class Comparison
+			{
+				public :
+
+					///	\brief	Sets up a comparison. check and variant must outlive this object
+					Comparison( const char* check, const char* variant, const Tolerance& tolerance );
+
+					///	\brief	Compares a float value
+					void Compare( const float expected, const float actual );
+
+					///	\brief	Compares arrays of float values
+					void Compare( const float* expected, const float* actual, const int count );
+
+					///	\brief	Compares arrays of vertices, field by field
+					void Compare( const UTerrainVertex* expected, const UTerrainVertex* actual, const int count );
+
+					///	\brief	Compares arrays of bytes
+					void CompareBytes( const unsigned char* expected, const unsigned char* actual, const int count );
+
+					///	\brief	Checks that a value is inside the range [minValue,maxValue]. Values outside are compared against the nearest bound
+					void CompareBounds( const float minValue, const float maxValue, const float actual );
+
+					///	\brief	Returns true if all values compared so far were within tolerance
+					bool Passed( ) const;
+
+					///	\brief	Prints a line summarizing this comparison, and the first failure, if there was one
+					void Report( ) const;
+
+					///	\brief	Prints the column headings for Report()
+					static void ReportHeadings( );
+
+				private :
+
+					const char*	m_Check;
+					const char*	m_Variant;
+					Tolerance	m_Tolerance;
+					long long	m_Values;
+					long long	m_Failures;
+					long long	m_MaxUlps;
+					float		m_MaxAbsolute;
+					int			m_MaxBytes;
+					long long	m_FirstFailure;
+					float		m_FirstExpected;
+					float		m_FirstActual;
+
+					///	\brief	Records a failure
+					void AddFailure( const float expected, const float actual );
+			};
+
+		}; //Differential
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,143 @@
+#include "Comparison.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Differential
+		{
+			///	\brief	Maps a float onto an integer, so that adjacent floats map onto adjacent integers
+			static long long GetOrderedBits( const float value )
+			{
+				int bits;
+				memcpy( &bits, &value, sizeof( bits ) );
+				return ( bits < 0 ) ? ( -2147483647LL - 1 ) - bits : bits;
+			}
+
+			long long GetUlpDistance( const float a, const float b )
+			{
+				const bool aIsNan = ( a != a );
+				const bool bIsNan = ( b != b );
+				if ( aIsNan || bIsNan )
+				{
+					return ( aIsNan && bIsNan ) ? 0 : 0x7fffffffffffffffLL;
+				}
+				const long long distance = GetOrderedBits( a ) - GetOrderedBits( b );
+				return distance < 0 ? -distance : distance;
+			}
+
+			//	---------------------------------------------------------------- Comparison Methods
+
+			Comparison::Comparison( const char* check, const char* variant, const Tolerance& tolerance ) :
+				m_Check( check ),
+				m_Variant( variant ),
+				m_Tolerance( tolerance ),
+				m_Values( 0 ),
+				m_Failures( 0 ),
+				m_MaxUlps( 0 ),
+				m_MaxAbsolute( 0 ),
+				m_MaxBytes( 0 ),
+				m_FirstFailure( -1 ),
+				m_FirstExpected( 0 ),
+				m_FirstActual( 0 )
+			{
+			}
+
+			void Comparison::AddFailure( const float expected, const float actual )
+			{
+				if ( m_Failures++ == 0 )
+				{
+					m_FirstFailure = m_Values;
+					m_FirstExpected = expected;
+					m_FirstActual = actual;
+				}
+			}
+
+			void Comparison::Compare( const float expected, const float actual )
+			{
+				const long long ulps = GetUlpDistance( expected, actual );
+				const float absolute = fabsf( expected - actual );
+				m_MaxUlps = ulps > m_MaxUlps ? ulps : m_MaxUlps;
+				m_MaxAbsolute = absolute > m_MaxAbsolute ? absolute : m_MaxAbsolute;
+
+				if ( ( ulps > m_Tolerance.m_Ulps ) && !( absolute <= m_Tolerance.m_Absolute ) )
+				{
+					AddFailure( expected, actual );
+				}
+				++m_Values;
+			}
+
+			void Comparison::Compare( const float* expected, const float* actual, const int count )
+			{
+				for ( int index = 0; index < count; ++index )
+				{
+					Compare( expected[ index ], actual[ index ] );
+				}
+			}
+
+			void Comparison::Compare( const UTerrainVertex* expected, const UTerrainVertex* actual, const int count )
+			{
+				//	UTerrainVertex is a plain block of floats
+				const int floatsPerVertex = sizeof( UTerrainVertex ) / sizeof( float );
+				Compare( ( const float* )expected, ( const float* )actual, count * floatsPerVertex );
+			}
+
+			void Comparison::CompareBytes( const unsigned char* expected, const unsigned char* actual, const int count )
+			{
+				for ( int index = 0; index < count; ++index, ++m_Values )
+				{
+					//	Packed channels wrap at 256 (a slope of 1 packs to 0), so differences are measured around the wrap
+					int difference = abs( int( expected[ index ] ) - int( actual[ index ] ) );
+					difference = difference > 128 ? 256 - difference : difference;
+					m_MaxBytes = difference > m_MaxBytes ? difference : m_MaxBytes;
+					if ( difference > m_Tolerance.m_Bytes )
+					{
+						AddFailure( expected[ index ], actual[ index ] );
+					}
+				}
+			}
+
+			void Comparison::CompareBounds( const float minValue, const float maxValue, const float actual )
+			{
+				//	NaNs are compared against maxValue, so they fail
+				const bool inside = ( actual >= minValue ) && ( actual <= maxValue );
+				Compare( inside ? actual : ( actual < minValue ? minValue : maxValue ), actual );
+			}
+
+			bool Comparison::Passed( ) const
+			{
+				return m_Failures == 0;
+			}
+
+			void Comparison::ReportHeadings( )
+			{
+				printf( "%-36s %-8s %10s %10s %12s %5s  %s\n", "Check", "Variant", "Values", "Max ULPs", "Max abs", "Bytes", "Result" );
+			}
+
+			void Comparison::Report( ) const
+			{
+				printf
+				(
+					"%-36s %-8s %10lld %10lld %12.4g %5d  %s\n",
+					m_Check,
+					m_Variant,
+					m_Values,
+					m_MaxUlps,
+					double( m_MaxAbsolute ),
+					m_MaxBytes,
+					Passed( ) ? "ok" : "FAILED"
+				);
+				if ( !Passed( ) )
+				{
+					printf( "    %lld values out of tolerance. First at value %lld: expected %.9g, got %.9g\n", m_Failures, m_FirstFailure, double( m_FirstExpected ), double( m_FirstActual ) );
+				}
+			}
+
+		}; //Differential
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,2465 @@
+#include "Comparison.h"
+#include "Mem.h"
+#include "Sse/SseNoise.h"
+#include "Sse/SseSimpleFractal.h"
+#include "Sse/SseRidgedFractal.h"
+#include "Sse/SsePlanetFractal.h"
+#include "Sse/SseCompositeFunctions.h"
+#include "Sse/SseHeightmapFunction.h"
+#include "Sse/SseSphereTerrainGenerator.h"
+#include "Sse/SsePlaneTerrainGenerator.h"
+#include "USphereCloudsAnimation.h"
+#include "Scalar/ScalarNoise.h"
+#include "Scalar/ScalarSimpleFractal.h"
+#include "Scalar/ScalarRidgedFractal.h"
+#include "Scalar/ScalarPlanetFractal.h"
+#include "Scalar/ScalarCompositeFunctions.h"
+#include "Scalar/ScalarHeightmapFunction.h"
+#include "Scalar/ScalarSphereTerrainGenerator.h"
+#include "Scalar/ScalarPlaneTerrainGenerator.h"
+#include "Scalar/ScalarMipChain.h"
+#include "Scalar/ScalarBlockCompressor.h"
+#include "UTerrainTileCodec.h"
+#include "UTerrainTilePyramid.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+///	\file	Differential test harness for the SSE kernels
+///
+///	Usage: Poc1.Fast.Differential [--seed <n>] [--iterations <n>] [--precision exact|fast|fastest|all]
+///			[--ulps <n>] [--abs <x>] [--bytes <n>]
+///
+///	Runs SseNoise, the SSE fractals, displacers and terrain generators on randomized inputs, and compares
+///	their output against the scalar reference implementations (Poc1.Fast/Scalar, Poc1.Fast.Terrain/Scalar).
+///	Inputs are generated from the seed (default 1), so a failing run can be repeated exactly.
+///
+///	Exact precision must match the reference bit for bit. The approximate precisions have loose default
+///	tolerances (see DefaultTolerance); --ulps, --abs and --bytes override the tolerances of every
+///	precision that is run. A value passes if it is within the ULP or the absolute tolerance. Returns 0 if every check passes, 1 if any fails, and 2 for bad arguments.
+///
+
+using namespace Poc1::Fast;
+using namespace Poc1::Fast::Terrain;
+using namespace Poc1::Fast::Differential;
+
+namespace
+{
+	///	\brief	Deterministic random number generator (xorshift32)
+	class Random
+	{
+		public :
+
+			Random( const unsigned int seed ) :
+				m_State( seed == 0 ? 0x9e3779b9 : seed )
+			{
+			}
+
+			unsigned int Next( )
+			{
+				m_State ^= m_State << 13;
+				m_State ^= m_State >> 17;
+				m_State ^= m_State << 5;
+				return m_State;
+			}
+
+			///	\brief	Returns a value in the range [min,max)
+			float Float( const float min, const float max )
+			{
+				return min + ( max - min ) * ( float( Next( ) >> 8 ) / 16777216.0f );
+			}
+
+			///	\brief	Returns a value in the range [min,max]
+			int Int( const int min, const int max )
+			{
+				return min + int( Next( ) % ( unsigned int )( max - min + 1 ) );
+			}
+
+			///	\brief	Returns true one time in n
+			bool OneIn( const int n )
+			{
+				return ( Next( ) % ( unsigned int )n ) == 0;
+			}
+
+		private :
+
+			unsigned int m_State;
+	};
+
+	///	\brief	Harness options
+	struct Options
+	{
+		unsigned int	m_Seed;
+		int				m_Iterations;
+		const char*		m_Precision;
+		long long		m_Ulps;			///<	ULP tolerance override, or -1
+		float			m_Absolute;		///<	Absolute tolerance override, or -1
+		int				m_Bytes;		///<	Byte tolerance override, or -1
+	};
+
+	///	\brief	Gets the default tolerances of the SSE precisions, relative to the scalar reference
+	///
+	///	Exact precision must match bit for bit. The approximate precisions replace divides and square roots
+	///	with reciprocal estimates. The resulting small position errors are amplified by high frequency
+	///	octaves, and by the finite differences used for normals and slopes, so their output can only be
+	///	loosely bounded pointwise. Their defaults (the largest differences measured over seeds 1-24, rounded
+	///	up) catch gross errors such as wrong lanes or NaNs, and don't bound packed bytes at all. Tighter
+	///	bounds can be set from the command line. Checks whose errors depend on the terrain (see CheckPatches)
+	///	add derived allowances when Approximate is true.
+	///
+	template < typename Precision >
+	struct DefaultTolerance
+	{
+	};
+
+	template < >
+	struct DefaultTolerance< SseExactPrecision >
+	{
+		static const bool Approximate = false;
+
+		static Tolerance Get( )
+		{
+			const Tolerance tolerance = { 0, 0, 0 };
+			return tolerance;
+		}
+	};
+
+	template < >
+	struct DefaultTolerance< SseFastPrecision >
+	{
+		static const bool Approximate = true;
+
+		static Tolerance Get( )
+		{
+			const Tolerance tolerance = { 64, 0.05f, 128 };
+			return tolerance;
+		}
+	};
+
+	template < >
+	struct DefaultTolerance< SseFastestPrecision >
+	{
+		static const bool Approximate = true;
+
+		static Tolerance Get( )
+		{
+			const Tolerance tolerance = { 8192, 8.0f, 128 };
+			return tolerance;
+		}
+	};
+
+	///	\brief	Per-run state. Collects the results of every comparison
+	class Run
+	{
+		public :
+
+			Run( const Options& options, const char* variant, const Tolerance& defaultTolerance ) :
+				m_Random( options.m_Seed ),
+				m_Iterations( options.m_Iterations ),
+				m_Variant( variant ),
+				m_Tolerance( defaultTolerance ),
+				m_Failures( 0 )
+			{
+				m_Tolerance.m_Ulps = options.m_Ulps >= 0 ? options.m_Ulps : m_Tolerance.m_Ulps;
+				m_Tolerance.m_Absolute = options.m_Absolute >= 0 ? options.m_Absolute : m_Tolerance.m_Absolute;
+				m_Tolerance.m_Bytes = options.m_Bytes >= 0 ? options.m_Bytes : m_Tolerance.m_Bytes;
+			}
+
+			Comparison CreateComparison( const char* check ) const
+			{
+				return Comparison( check, m_Variant, m_Tolerance );
+			}
+
+			void Finish( const Comparison& comparison )
+			{
+				comparison.Report( );
+				m_Failures += comparison.Passed( ) ? 0 : 1;
+			}
+
+			Random		m_Random;
+			int			m_Iterations;
+			const char*	m_Variant;
+			Tolerance	m_Tolerance;
+			int			m_Failures;
+	};
+
+	///	\brief	Loads 4 floats into an SSE register
+	inline __m128 Load( const float* values )
+	{
+		return _mm_loadu_ps( values );
+	}
+
+	///	\brief	Stores an SSE register to 4 floats
+	inline void Store( float* values, const __m128 v )
+	{
+		_mm_storeu_ps( values, v );
+	}
+
+	///	\brief	Gets a random noise input. Some inputs are snapped to half-integers, where SSE rounding ties
+	float GetNoiseInput( Random& random, const float range )
+	{
+		const float value = random.Float( -range, range );
+		return random.OneIn( 4 ) ? float( int( value * 2 ) ) * 0.5f : value;
+	}
+
+	//	------------------------------------------------------------------------- Function checks
+
+	template < typename Precision >
+	void CheckNoise( Run& run )
+	{
+		Comparison comparison( run.CreateComparison( "noise" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const unsigned int seed = run.m_Random.Next( ) % 16;
+			SseNoise sseNoise( seed );
+			ScalarNoise scalarNoise( seed );
+			for ( int block = 0; block < 256; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ], actual[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					x[ lane ] = GetNoiseInput( run.m_Random, 300 );
+					y[ lane ] = GetNoiseInput( run.m_Random, 300 );
+					z[ lane ] = GetNoiseInput( run.m_Random, 300 );
+					expected[ lane ] = scalarNoise.Noise( x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( actual, sseNoise.Noise< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				comparison.Compare( expected, actual, 4 );
+			}
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks the tangent-adjusted cube face coordinate warp and its inverse, which have no precision parameter
+	///
+	///	The warp must map -1, 0 and 1 exactly onto themselves, so faces still meet at their edges. The inverse
+	///	(the cube map lookup) must undo the warp to within the accuracy of the two polynomials.
+	///
+	void CheckTangentCubeFaceCoordinates( Run& run )
+	{
+		const Tolerance roundTripTolerance = { 0, 1e-6f, 0 };
+		Comparison comparison( run.CreateComparison( "tangent cube face coordinates" ) );
+		Comparison roundTripComparison( "tangent cube face round trip", run.m_Variant, roundTripTolerance );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			for ( int block = 0; block < 256; ++block )
+			{
+				float t[ 4 ], expected[ 4 ], actual[ 4 ], expectedInverse[ 4 ], actualInverse[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					t[ lane ] = run.m_Random.OneIn( 16 ) ? float( run.m_Random.Int( -1, 1 ) ) : run.m_Random.Float( -1, 1 );
+					expected[ lane ] = ScalarTangentCubeFaceCoordinate( t[ lane ] );
+					expectedInverse[ lane ] = ScalarInverseTangentCubeFaceCoordinate( expected[ lane ] );
+				}
+				Store( actual, TangentCubeFaceCoordinate( Load( t ) ) );
+				Store( actualInverse, InverseTangentCubeFaceCoordinate( Load( actual ) ) );
+				comparison.Compare( expected, actual, 4 );
+				comparison.Compare( expectedInverse, actualInverse, 4 );
+				roundTripComparison.Compare( t, actualInverse, 4 );
+			}
+		}
+
+		const float ends[ 4 ] = { -1, 0, 1, 0 };
+		float warpedEnds[ 4 ];
+		Store( warpedEnds, TangentCubeFaceCoordinate( Load( ends ) ) );
+		comparison.Compare( ends, warpedEnds, 4 );
+		Store( warpedEnds, InverseTangentCubeFaceCoordinate( Load( ends ) ) );
+		comparison.Compare( ends, warpedEnds, 4 );
+
+		run.Finish( comparison );
+		run.Finish( roundTripComparison );
+	}
+
+	///	\brief	Checks SseNoise::PeriodicNoise(), which has no precision parameter
+	void CheckPeriodicNoise( Run& run )
+	{
+		Comparison comparison( run.CreateComparison( "periodic noise" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const unsigned int seed = run.m_Random.Next( ) % 16;
+			const int periodX = run.m_Random.Int( 1, 256 );
+			const int periodY = run.m_Random.Int( 1, 256 );
+			const int originX = run.m_Random.Int( 0, 1000 );
+			const int originY = run.m_Random.Int( 0, 1000 );
+			const __m128i periodXxxx = _mm_set1_epi32( periodX );
+			const __m128i periodYyyy = _mm_set1_epi32( periodY );
+			const __m128i originXxxx = _mm_set1_epi32( originX );
+			const __m128i originYyyy = _mm_set1_epi32( originY );
+			SseNoise sseNoise( seed );
+			ScalarNoise scalarNoise( seed );
+			for ( int block = 0; block < 256; ++block )
+			{
+				//	Inputs are kept inside the range that PeriodicNoise() can wrap
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ], actual[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					x[ lane ] = run.m_Random.Float( float( 1 - periodX ), float( periodX * 2 - 1 ) );
+					y[ lane ] = run.m_Random.Float( float( 1 - periodY ), float( periodY * 2 - 1 ) );
+					z[ lane ] = GetNoiseInput( run.m_Random, 300 );
+					expected[ lane ] = scalarNoise.PeriodicNoise( x[ lane ], y[ lane ], z[ lane ], periodX, periodY, originX, originY );
+				}
+				Store( actual, sseNoise.PeriodicNoise( Load( x ), Load( y ), Load( z ), periodXxxx, periodYyyy, originXxxx, originYyyy ) );
+				comparison.Compare( expected, actual, 4 );
+			}
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Random fractal parameters, applied in the same way as FractalTerrainParameters::Setup()
+	struct FractalParameters
+	{
+		unsigned int	m_Seed;
+		float			m_Frequency;
+		float			m_Persistence;		///<	Persistence for simple fractals, gain for ridged fractals
+		int				m_Octaves;
+
+		void Randomize( Random& random )
+		{
+			m_Seed = random.Next( ) % 16;
+			m_Frequency = random.Float( 1.5f, 2.5f );
+			m_Persistence = random.Float( 0.3f, 1.0f );
+			m_Octaves = random.Int( 1, 10 );
+		}
+
+		template < typename FractalType >
+		void Apply( FractalType& fractal ) const
+		{
+			fractal.GetNoise( ).SetNewSeed( m_Seed );
+			fractal.Setup( m_Frequency, m_Persistence, m_Octaves );
+		}
+	};
+
+	template < typename Precision, typename SseFractal, typename ScalarFractal >
+	void CheckFractal( Run& run, const char* valueCheck, const char* signedValueCheck, const char* clampedValueCheck )
+	{
+		Comparison values( run.CreateComparison( valueCheck ) );
+		Comparison signedValues( run.CreateComparison( signedValueCheck ) );
+		Comparison clampedValues( run.CreateComparison( clampedValueCheck ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			FractalParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			SseFractal sseFractal;
+			ScalarFractal scalarFractal;
+			parameters.Apply( sseFractal );
+			parameters.Apply( scalarFractal );
+
+			for ( int block = 0; block < 64; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ], actual[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					x[ lane ] = GetNoiseInput( run.m_Random, 50 );
+					y[ lane ] = GetNoiseInput( run.m_Random, 50 );
+					z[ lane ] = GetNoiseInput( run.m_Random, 50 );
+					expected[ lane ] = scalarFractal.GetValue( x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( actual, sseFractal.template GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				values.Compare( expected, actual, 4 );
+
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					expected[ lane ] = scalarFractal.GetSignedValue( x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( actual, sseFractal.template GetSignedValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				signedValues.Compare( expected, actual, 4 );
+
+				//	Clamped values may skip octaves, but must match the clamped full value
+				const float minValue = run.m_Random.Float( 0, 1 );
+				const float maxValue = minValue + run.m_Random.Float( 0, 0.5f );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					const float value = scalarFractal.GetValue( x[ lane ], y[ lane ], z[ lane ] );
+					expected[ lane ] = value < minValue ? minValue : ( value > maxValue ? maxValue : value );
+				}
+				Store( actual, sseFractal.template GetClampedValue< Precision >( Load( x ), Load( y ), Load( z ), _mm_set1_ps( minValue ), _mm_set1_ps( maxValue ) ) );
+				clampedValues.Compare( expected, actual, 4 );
+			}
+		}
+		run.Finish( values );
+		run.Finish( signedValues );
+		run.Finish( clampedValues );
+	}
+
+	///	\brief	Gets a random region around a position. Sizes range from a fraction of a noise lattice cell to many cells
+	SseFunctionRegion GetRandomRegion( Random& random, const float* centre )
+	{
+		float minimum[ 3 ], maximum[ 3 ];
+		for ( int axis = 0; axis < 3; ++axis )
+		{
+			const float halfSize = powf( 10, random.Float( -3, 1 ) );
+			minimum[ axis ] = centre[ axis ] - halfSize * random.Float( 0, 1 );
+			maximum[ axis ] = minimum[ axis ] + halfSize * 2;
+		}
+		return SseFunctionRegion( minimum, maximum );
+	}
+
+	///	\brief	Gets a random position inside a region. Some positions are on the region boundary
+	void GetRegionInput( Random& random, const SseFunctionRegion& region, float& x, float& y, float& z )
+	{
+		float position[ 3 ];
+		for ( int axis = 0; axis < 3; ++axis )
+		{
+			const float minimum = region.GetMinimum( )[ axis ];
+			const float maximum = region.GetMaximum( )[ axis ];
+			position[ axis ] = random.OneIn( 8 ) ? ( random.OneIn( 2 ) ? minimum : maximum ) : random.Float( minimum, maximum );
+		}
+		x = position[ 0 ];
+		y = position[ 1 ];
+		z = position[ 2 ];
+	}
+
+	template < typename Precision, typename SseFractal >
+	void CheckFractalBounds( Run& run, const char* check )
+	{
+		Comparison comparison( run.CreateComparison( check ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			FractalParameters parameters;
+			parameters.Randomize( run.m_Random );
+			SseFractal fractal;
+			parameters.Apply( fractal );
+
+			const float centre[ 3 ] = { GetNoiseInput( run.m_Random, 50 ), GetNoiseInput( run.m_Random, 50 ), GetNoiseInput( run.m_Random, 50 ) };
+			const SseFunctionRegion region( GetRandomRegion( run.m_Random, centre ) );
+			float minValue, maxValue, minSignedValue, maxSignedValue;
+			fractal.GetBounds( region, minValue, maxValue );
+			fractal.GetSignedBounds( region, minSignedValue, maxSignedValue );
+
+			for ( int block = 0; block < 16; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], values[ 4 ], signedValues[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					GetRegionInput( run.m_Random, region, x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( values, fractal.template GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				Store( signedValues, fractal.template GetSignedValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					comparison.CompareBounds( minValue, maxValue, values[ lane ] );
+					comparison.CompareBounds( minSignedValue, maxSignedValue, signedValues[ lane ] );
+				}
+			}
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks ranges read through UMappedFileWindows against the bytes written to random files
+	///
+	///	Windows are a page long, and only a few are mapped at once, so reads cross window boundaries and evict
+	///	windows. Ranges longer than the overlap, or past the end of the file, must not be readable.
+	///
+	void CheckMappedFileWindows( Run& run )
+	{
+		const char* path = "Poc1.Fast.Differential.windows";
+		Comparison comparison( run.CreateComparison( "mapped file windows" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			std::vector< unsigned char > bytes( run.m_Random.Int( 1, 64 * 1024 ) );
+			for ( size_t index = 0; index < bytes.size( ); ++index )
+			{
+				bytes[ index ] = ( unsigned char )run.m_Random.Int( 0, 255 );
+			}
+			FILE* file = fopen( path, "wb" );
+			const bool written = ( file != 0 ) && ( fwrite( &bytes[ 0 ], bytes.size( ), 1, file ) == 1 );
+			const bool closed = ( file != 0 ) && ( fclose( file ) == 0 );
+
+			const long long size = ( long long )bytes.size( );
+			const long long overlap = run.m_Random.Int( 0, 64 );
+			UMappedFileWindows windows;
+			const bool opened = written && closed && windows.Open( path, 1, overlap, run.m_Random.Int( 1, 3 ) );
+			comparison.Compare( 1.0f, opened ? 1.0f : 0.0f );
+			if ( !opened )
+			{
+				continue;
+			}
+			comparison.Compare( float( size ), float( windows.GetSize( ) ) );
+
+			for ( int read = 0; read < 256; ++read )
+			{
+				const long long offset = run.m_Random.Int( 0, int( size ) - 1 );
+				const long long rangeSize = run.m_Random.Int( 0, int( overlap < size - offset ? overlap : size - offset ) );
+				const unsigned char* range = windows.GetRange( offset, rangeSize );
+				comparison.Compare( 1.0f, range != 0 ? 1.0f : 0.0f );
+				if ( range != 0 )
+				{
+					comparison.CompareBytes( &bytes[ size_t( offset ) ], range, int( rangeSize ) );
+				}
+			}
+			comparison.Compare( 0.0f, windows.GetRange( 0, overlap + 1 ) != 0 ? 1.0f : 0.0f );
+			comparison.Compare( 0.0f, windows.GetRange( size, 1 ) != 0 ? 1.0f : 0.0f );
+			comparison.Compare( 0.0f, windows.GetRange( -1, 0 ) != 0 ? 1.0f : 0.0f );
+			windows.Close( );
+			remove( path );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks SseHeightmapFunction against the scalar reference, and against the heights written to random heightmap files
+	///
+	///	Texels sampled at their own face coordinates must return their heights, which checks the tile layout
+	///	of the file and the orientation of the faces, as well as the filters.
+	///
+	void CheckHeightmapFunction( Run& run )
+	{
+		const char* path = "Poc1.Fast.Differential.heightmap";
+		const Tolerance texelTolerance = { 0, 1e-3f, 0 };
+		Comparison comparison( run.CreateComparison( "heightmap function" ) );
+		Comparison texelComparison( "heightmap function texels", run.m_Variant, texelTolerance );
+		Comparison boundsComparison( run.CreateComparison( "heightmap function bounds" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const UHeightmapFormat format = run.m_Random.OneIn( 2 ) ? HeightmapUnsigned16 : HeightmapFloat32;
+			const UCubeMapProjection projection = run.m_Random.OneIn( 2 ) ? ProjectionGnomonic : ProjectionTangent;
+			const int resolution = run.m_Random.Int( 2, 40 );
+			const int tileSize = 1 << run.m_Random.Int( 0, 4 );
+
+			//	Some files have a small range far from zero, which loses precision unless the minimum height is
+			//	subtracted before texels are scaled
+			const bool offset = run.m_Random.OneIn( 4 );
+			const float minHeight = offset ? run.m_Random.Float( -20000, -5000 ) : run.m_Random.Float( -100, 0 );
+			const float maxHeight = minHeight + ( offset ? run.m_Random.Float( 1, 5 ) : run.m_Random.Float( 1, 200 ) );
+			const float margin = ( maxHeight - minHeight ) * 0.05f;
+
+			//	Some heights are outside the range, and are clamped by the writer
+			std::vector< float > heights( resolution * resolution * 6 );
+			UHeightmapWriter writer;
+			bool written = writer.Start( path, format, projection, resolution, tileSize, minHeight, maxHeight );
+			for ( int row = 0; ( row < resolution * 6 ) && written; ++row )
+			{
+				float* rowHeights = &heights[ row * resolution ];
+				for ( int col = 0; col < resolution; ++col )
+				{
+					const float height = run.m_Random.Float( minHeight - margin, maxHeight + margin );
+					rowHeights[ col ] = height < minHeight ? minHeight : ( height > maxHeight ? maxHeight : height );
+				}
+				writer.WriteRow( rowHeights );
+			}
+			written = writer.Finish( ) && written;
+
+			SseHeightmapFunction* function = new ( Aligned( 16 ) ) SseHeightmapFunction;
+			const bool opened = written && function->Open( path );
+			comparison.Compare( 1.0f, opened ? 1.0f : 0.0f );
+			if ( !opened )
+			{
+				AlignedDelete( function );
+				continue;
+			}
+			const UHeightmapFile& file = function->GetFile( );
+			const bool bicubic = run.m_Random.OneIn( 2 );
+			function->SetFilter( bicubic ? SseHeightmapFunction::FilterBicubic : SseHeightmapFunction::FilterBilinear );
+			ScalarHeightmapFunction scalarFunction( file, bicubic );
+
+			//	Texels are quantized to 16 bits, or normalized from floats
+			const float texelError = ( format == HeightmapUnsigned16 ? 0.5f / 65535.0f : 0 ) + 1e-6f;
+			for ( int face = 0; face < 6; ++face )
+			{
+				for ( int row = 0; row < resolution; ++row )
+				{
+					for ( int col = 0; col < resolution; ++col )
+					{
+						const float height = ( heights[ ( face * resolution + row ) * resolution + col ] - minHeight ) / ( maxHeight - minHeight );
+						comparison.CompareBounds( height - texelError, height + texelError, file.GetTexel( face, row, col ) );
+					}
+				}
+			}
+
+			//	Reading through a few small windows (rounded up to a page) gives the same texels and ranges
+			UHeightmapFile windowedFile;
+			comparison.Compare( 1.0f, windowedFile.Open( path, 1, run.m_Random.Int( 1, 3 ) ) ? 1.0f : 0.0f );
+			for ( int texel = 0; ( texel < 256 ) && windowedFile.IsOpen( ); ++texel )
+			{
+				const int face = run.m_Random.Int( 0, 5 );
+				const int row = run.m_Random.Int( 0, resolution - 1 );
+				const int col = run.m_Random.Int( 0, resolution - 1 );
+				comparison.Compare( file.GetTexel( face, row, col ), windowedFile.GetTexel( face, row, col ) );
+
+				float expectedMin, expectedMax, actualMin, actualMax;
+				file.GetRange( face, row - tileSize, col, row, col + tileSize, expectedMin, expectedMax );
+				windowedFile.GetRange( face, row - tileSize, col, row, col + tileSize, actualMin, actualMax );
+				comparison.Compare( expectedMin, actualMin );
+				comparison.Compare( expectedMax, actualMax );
+			}
+			windowedFile.Close( );
+
+			//	Edge texels are in more than one face, but were written with different heights, so only texels
+			//	inside faces are checked
+			for ( int block = 0; ( block < 16 ) && ( resolution > 2 ); ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ], actual[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					const int face = run.m_Random.Int( 0, 5 );
+					const int row = run.m_Random.Int( 1, resolution - 2 );
+					const int col = run.m_Random.Int( 1, resolution - 2 );
+					const float u = float( col ) * 2.0f / float( resolution - 1 ) - 1.0f;
+					const float v = float( row ) * 2.0f / float( resolution - 1 ) - 1.0f;
+					ScalarCubeFacePosition( UCubeMapFace( face ), projection, u, v, x[ lane ], y[ lane ], z[ lane ] );
+					expected[ lane ] = file.GetTexel( face, row, col );
+				}
+				Store( actual, function->GetValue( Load( x ), Load( y ), Load( z ) ) );
+				texelComparison.Compare( expected, actual, 4 );
+			}
+
+			if ( run.m_Random.OneIn( 2 ) )
+			{
+				FractalParameters detail;
+				detail.Randomize( run.m_Random );
+				detail.Apply( function->GetDetail( ) );
+				detail.Apply( scalarFunction.GetDetail( ) );
+				const float amplitude = run.m_Random.Float( 0.01f, 0.2f );
+				function->SetDetailAmplitude( amplitude );
+				scalarFunction.SetDetailAmplitude( amplitude );
+			}
+
+			for ( int block = 0; block < 64; ++block )
+			{
+				//	Some inputs are on the edges and corners of the cube, where faces meet
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ], actual[ 4 ], expectedSigned[ 4 ], actualSigned[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					x[ lane ] = GetNoiseInput( run.m_Random, 8 );
+					y[ lane ] = run.m_Random.OneIn( 8 ) ? x[ lane ] : GetNoiseInput( run.m_Random, 8 );
+					z[ lane ] = run.m_Random.OneIn( 8 ) ? -y[ lane ] : GetNoiseInput( run.m_Random, 8 );
+					expected[ lane ] = scalarFunction.GetValue( x[ lane ], y[ lane ], z[ lane ] );
+					expectedSigned[ lane ] = scalarFunction.GetSignedValue( x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( actual, function->GetValue( Load( x ), Load( y ), Load( z ) ) );
+				Store( actualSigned, function->GetSignedValue( Load( x ), Load( y ), Load( z ) ) );
+				comparison.Compare( expected, actual, 4 );
+				comparison.Compare( expectedSigned, actualSigned, 4 );
+			}
+
+			for ( int regionIndex = 0; regionIndex < 4; ++regionIndex )
+			{
+				const float centre[ 3 ] = { GetNoiseInput( run.m_Random, 4 ), GetNoiseInput( run.m_Random, 4 ), GetNoiseInput( run.m_Random, 4 ) };
+				const SseFunctionRegion region( GetRandomRegion( run.m_Random, centre ) );
+				float minValue, maxValue, minSignedValue, maxSignedValue;
+				function->GetBounds( region, minValue, maxValue );
+				function->GetSignedBounds( region, minSignedValue, maxSignedValue );
+				for ( int block = 0; block < 16; ++block )
+				{
+					float x[ 4 ], y[ 4 ], z[ 4 ], values[ 4 ], signedValues[ 4 ];
+					for ( int lane = 0; lane < 4; ++lane )
+					{
+						GetRegionInput( run.m_Random, region, x[ lane ], y[ lane ], z[ lane ] );
+					}
+					Store( values, function->GetValue( Load( x ), Load( y ), Load( z ) ) );
+					Store( signedValues, function->GetSignedValue( Load( x ), Load( y ), Load( z ) ) );
+					for ( int lane = 0; lane < 4; ++lane )
+					{
+						boundsComparison.CompareBounds( minValue, maxValue, values[ lane ] );
+						boundsComparison.CompareBounds( minSignedValue, maxSignedValue, signedValues[ lane ] );
+					}
+				}
+			}
+
+			AlignedDelete( function );
+			remove( path );
+		}
+		run.Finish( comparison );
+		run.Finish( texelComparison );
+		run.Finish( boundsComparison );
+	}
+
+	///	\brief	Composite function using every composite function type (see SseCompositeFunctions.h)
+	typedef SseLatitudeBlendFunction
+	<
+		SseSumFunction< SseScaleFunction< SseSimpleFractal >, SseSelectFunction< SseSimpleFractal, SseRidgedFractal, SseWarpFunction< SseSimpleFractal, SseRidgedFractal > > >,
+		SseMinFunction< SseMaxFunction< SseSimpleFractal, SseRidgedFractal >, SseScaleFunction< SseRidgedFractal > >
+	> SseComposite;
+
+	///	\brief	Scalar reference implementation of SseComposite
+	typedef ScalarLatitudeBlendFunction
+	<
+		ScalarSumFunction< ScalarScaleFunction< ScalarSimpleFractal >, ScalarSelectFunction< ScalarSimpleFractal, ScalarRidgedFractal, ScalarWarpFunction< ScalarSimpleFractal, ScalarRidgedFractal > > >,
+		ScalarMinFunction< ScalarMaxFunction< ScalarSimpleFractal, ScalarRidgedFractal >, ScalarScaleFunction< ScalarRidgedFractal > >
+	> ScalarComposite;
+
+	///	\brief	Parameters of SseComposite and ScalarComposite
+	struct CompositeParameters
+	{
+		FractalParameters	m_SimpleFractal;	///<	Parameters of the simple fractals. Each fractal has a different seed
+		FractalParameters	m_RidgedFractal;	///<	Parameters of the ridged fractals. Each fractal has a different seed
+		float				m_Scale;
+		float				m_Offset;
+		float				m_Threshold;
+		float				m_Falloff;
+		float				m_WarpAmplitude;
+		float				m_StartLatitude;
+		float				m_EndLatitude;
+
+		void Randomize( Random& random )
+		{
+			m_SimpleFractal.Randomize( random );
+			m_RidgedFractal.Randomize( random );
+			m_Scale = random.Float( -1, 1 );
+			m_Offset = random.Float( 0, 1 );
+			m_Threshold = random.Float( 0.2f, 0.8f );
+			m_Falloff = random.OneIn( 8 ) ? 0 : random.Float( 0.01f, 0.3f );
+			m_WarpAmplitude = random.Float( 0, 2 );
+			m_StartLatitude = random.Float( 0, 0.8f );
+			m_EndLatitude = m_StartLatitude + random.Float( 0.01f, 0.2f );
+		}
+
+		///	\brief	Gets the select falloff used by SetFractals()
+		static float GetTerrainFalloff( )
+		{
+			return 0.1f;
+		}
+
+		///	\brief	Gets the largest slope of a select blend, relative to its control function
+		///
+		///	The blend is SmoothStep() over a width of twice the falloff (SseSelectFunction::SetThreshold()), and
+		///	SmoothStep() has a slope of up to 1.5. Errors in the control value are scaled by this slope, and by the
+		///	difference between the selected functions.
+		///
+		static float GetBlendSlope( const float falloff )
+		{
+			return 1.5f / ( 2 * falloff );
+		}
+
+		///	\brief	Sets up parameters from the fractal parameters of a terrain, without using any random numbers
+		void SetFractals( const FractalParameters& simpleFractal, const FractalParameters& ridgedFractal )
+		{
+			m_SimpleFractal = simpleFractal;
+			m_RidgedFractal = ridgedFractal;
+			m_Scale = 0.5f;
+			m_Offset = 0.25f;
+			m_Threshold = 0.5f;
+			m_Falloff = GetTerrainFalloff( );
+			m_WarpAmplitude = 0.2f;
+			m_StartLatitude = 0.6f;
+			m_EndLatitude = 0.8f;
+		}
+
+		template < typename CompositeType >
+		void Apply( CompositeType& function ) const
+		{
+			function.SetLatitudes( m_StartLatitude, m_EndLatitude );
+			ApplyFractal( m_SimpleFractal, 0, function.GetEquator( ).GetFirst( ).GetFunction( ) );
+			function.GetEquator( ).GetFirst( ).SetScale( m_Scale, m_Offset );
+			function.GetEquator( ).GetSecond( ).SetThreshold( m_Threshold, m_Falloff );
+			ApplyFractal( m_SimpleFractal, 1, function.GetEquator( ).GetSecond( ).GetControl( ) );
+			ApplyFractal( m_RidgedFractal, 2, function.GetEquator( ).GetSecond( ).GetFirst( ) );
+			ApplyFractal( m_SimpleFractal, 3, function.GetEquator( ).GetSecond( ).GetSecond( ).GetWarp( ) );
+			ApplyFractal( m_RidgedFractal, 4, function.GetEquator( ).GetSecond( ).GetSecond( ).GetFunction( ) );
+			function.GetEquator( ).GetSecond( ).GetSecond( ).SetAmplitude( m_WarpAmplitude );
+			ApplyFractal( m_SimpleFractal, 5, function.GetPole( ).GetFirst( ).GetFirst( ) );
+			ApplyFractal( m_RidgedFractal, 6, function.GetPole( ).GetFirst( ).GetSecond( ) );
+			ApplyFractal( m_RidgedFractal, 7, function.GetPole( ).GetSecond( ).GetFunction( ) );
+			function.GetPole( ).GetSecond( ).SetScale( m_Scale, m_Offset );
+		}
+
+		template < typename FractalType >
+		static void ApplyFractal( const FractalParameters& parameters, const unsigned int seedOffset, FractalType& fractal )
+		{
+			FractalParameters fractalParameters( parameters );
+			fractalParameters.m_Seed = ( fractalParameters.m_Seed + seedOffset ) % 16;
+			fractalParameters.Apply( fractal );
+		}
+	};
+
+	///	\brief	Checks the composite functions against the scalar reference, and checks their bounds
+	template < typename Precision >
+	void CheckCompositeFunction( Run& run )
+	{
+		Comparison comparison( run.CreateComparison( "composite function" ) );
+		Comparison boundsComparison( run.CreateComparison( "composite function bounds" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			CompositeParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			//	A zero falloff makes the select a step, so approximate control values near the threshold select the
+			//	other function outright. Approximate precisions use the smallest random falloff instead
+			if ( DefaultTolerance< Precision >::Approximate && ( parameters.m_Falloff == 0 ) )
+			{
+				parameters.m_Falloff = 0.01f;
+			}
+			SseComposite* sseFunction = new ( Aligned( 16 ) ) SseComposite;
+			ScalarComposite scalarFunction;
+			parameters.Apply( *sseFunction );
+			parameters.Apply( scalarFunction );
+
+			for ( int block = 0; block < 64; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 8 ], actual[ 8 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					x[ lane ] = GetNoiseInput( run.m_Random, 50 );
+					y[ lane ] = GetNoiseInput( run.m_Random, 50 );
+					z[ lane ] = GetNoiseInput( run.m_Random, 50 );
+					expected[ lane ] = scalarFunction.GetValue( x[ lane ], y[ lane ], z[ lane ] );
+					expected[ lane + 4 ] = scalarFunction.GetSignedValue( x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( actual, sseFunction->template GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				Store( actual + 4, sseFunction->template GetSignedValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				comparison.Compare( expected, actual, 8 );
+			}
+
+			const float centre[ 3 ] = { GetNoiseInput( run.m_Random, 50 ), GetNoiseInput( run.m_Random, 50 ), GetNoiseInput( run.m_Random, 50 ) };
+			const SseFunctionRegion region( GetRandomRegion( run.m_Random, centre ) );
+			float minValue, maxValue, minSignedValue, maxSignedValue;
+			sseFunction->GetBounds( region, minValue, maxValue );
+			sseFunction->GetSignedBounds( region, minSignedValue, maxSignedValue );
+			for ( int block = 0; block < 16; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], values[ 4 ], signedValues[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					GetRegionInput( run.m_Random, region, x[ lane ], y[ lane ], z[ lane ] );
+				}
+				Store( values, sseFunction->template GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				Store( signedValues, sseFunction->template GetSignedValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					boundsComparison.CompareBounds( minValue, maxValue, values[ lane ] );
+					boundsComparison.CompareBounds( minSignedValue, maxSignedValue, signedValues[ lane ] );
+				}
+			}
+
+			AlignedDelete( sseFunction );
+		}
+		run.Finish( comparison );
+		run.Finish( boundsComparison );
+	}
+
+	//	------------------------------------------------------------------------- Terrain configurations
+
+	///	\brief	Random terrain parameters, applied in the same way as TerrainGenerator
+	struct TerrainParameters
+	{
+		FractalParameters	m_HeightFractal;
+		FractalParameters	m_GroundFractal;
+		float				m_HeightFunctionScale;
+		float				m_HeightOutputScale;
+		float				m_GroundFunctionScale;
+		float				m_GroundOutputScale;
+		float				m_PatchScale;
+		float				m_MinHeight;
+		float				m_MaxHeight;
+
+		void Randomize( Random& random )
+		{
+			m_HeightFractal.Randomize( random );
+			m_GroundFractal.Randomize( random );
+			m_HeightFunctionScale = random.Float( 1, 16 );
+			m_HeightOutputScale = random.Float( 0.5f, 2 );
+			m_GroundFunctionScale = random.Float( 1, 16 );
+			m_GroundOutputScale = random.Float( 0.01f, 0.2f );
+			m_PatchScale = random.Float( 1, 1000 );
+			m_MinHeight = random.Float( 0, 10 );
+			m_MaxHeight = m_MinHeight + random.Float( 0.1f, 50 );
+		}
+	};
+
+	///	\brief	Configuration with a flat displacer
+	///
+	///	Every configuration sets GroundOffsets if its displacer moves samples across the surface, and returns
+	///	the factor its functions scale the absolute tolerance of approximate patches by from GetToleranceScale()
+	///	(see CheckPatches).
+	///
+	template < typename SseDisplacerType, typename ScalarDisplacerType >
+	struct FlatConfig
+	{
+		typedef SseDisplacerType	SseDisplacer;
+		typedef ScalarDisplacerType	ScalarDisplacer;
+
+		static const bool GroundOffsets = false;
+
+		static float GetToleranceScale( )
+		{
+			return 1;
+		}
+
+		template < typename DisplacerType >
+		static void Setup( DisplacerType& displacer, const TerrainParameters& parameters )
+		{
+			displacer.Setup( parameters.m_PatchScale, parameters.m_MinHeight, parameters.m_MaxHeight );
+		}
+	};
+
+	///	\brief	Configuration with a height function displacer
+	template < typename SseDisplacerType, typename ScalarDisplacerType >
+	struct HeightConfig
+	{
+		typedef SseDisplacerType	SseDisplacer;
+		typedef ScalarDisplacerType	ScalarDisplacer;
+
+		static const bool GroundOffsets = false;
+
+		static float GetToleranceScale( )
+		{
+			return 1;
+		}
+
+		template < typename DisplacerType >
+		static void Setup( DisplacerType& displacer, const TerrainParameters& parameters )
+		{
+			displacer.SetFunctionScale( parameters.m_HeightFunctionScale );
+			displacer.SetOutputScale( parameters.m_HeightOutputScale );
+			parameters.m_HeightFractal.Apply( displacer.GetFunction( ) );
+			displacer.Setup( parameters.m_PatchScale, parameters.m_MinHeight, parameters.m_MaxHeight );
+		}
+	};
+
+	///	\brief	Configuration with a ground function displacer decorating a height function displacer
+	template < typename SseDisplacerType, typename ScalarDisplacerType >
+	struct GroundConfig
+	{
+		typedef SseDisplacerType	SseDisplacer;
+		typedef ScalarDisplacerType	ScalarDisplacer;
+
+		static const bool GroundOffsets = true;
+
+		static float GetToleranceScale( )
+		{
+			return 1;
+		}
+
+		template < typename DisplacerType >
+		static void Setup( DisplacerType& displacer, const TerrainParameters& parameters )
+		{
+			displacer.GetBaseDisplacer( ).SetFunctionScale( parameters.m_HeightFunctionScale );
+			displacer.GetBaseDisplacer( ).SetOutputScale( parameters.m_HeightOutputScale );
+			parameters.m_HeightFractal.Apply( displacer.GetBaseDisplacer( ).GetFunction( ) );
+			displacer.SetFunctionScale( parameters.m_GroundFunctionScale );
+			displacer.SetOutputScale( parameters.m_GroundOutputScale );
+			parameters.m_GroundFractal.Apply( displacer.GetFunction( ) );
+			displacer.Setup( parameters.m_PatchScale, parameters.m_MinHeight, parameters.m_MaxHeight );
+		}
+	};
+
+	///	\brief	Configuration with a sphere ground displacer that generates patches with its ground field
+	///
+	///	The reduced configuration has a ground field spacing larger than any patch step, so patches with odd
+	///	sizes evaluate the field at every second vertex.
+	///
+	template < typename SseDisplacerType, typename ScalarDisplacerType, bool Reduced >
+	struct GroundFieldConfig : public GroundConfig< SseDisplacerType, ScalarDisplacerType >
+	{
+		template < typename DisplacerType >
+		static void Setup( DisplacerType& displacer, const TerrainParameters& parameters )
+		{
+			GroundConfig< SseDisplacerType, ScalarDisplacerType >::Setup( displacer, parameters );
+			displacer.SetGroundField( true, Reduced ? 1e6f : 0 );
+		}
+	};
+
+	///	\brief	Configuration with a composite function displacer (SseComposite)
+	template < typename SseDisplacerType, typename ScalarDisplacerType >
+	struct CompositeConfig
+	{
+		typedef SseDisplacerType	SseDisplacer;
+		typedef ScalarDisplacerType	ScalarDisplacer;
+
+		static const bool GroundOffsets = false;
+
+		///	\brief	The select blend amplifies errors in its control function by its slope
+		static float GetToleranceScale( )
+		{
+			return CompositeParameters::GetBlendSlope( CompositeParameters::GetTerrainFalloff( ) );
+		}
+
+		template < typename DisplacerType >
+		static void Setup( DisplacerType& displacer, const TerrainParameters& parameters )
+		{
+			CompositeParameters composite;
+			composite.SetFractals( parameters.m_GroundFractal, parameters.m_HeightFractal );
+			displacer.SetFunctionScale( parameters.m_HeightFunctionScale );
+			displacer.SetOutputScale( parameters.m_HeightOutputScale );
+			composite.Apply( displacer.GetFunction( ) );
+			displacer.Setup( parameters.m_PatchScale, parameters.m_MinHeight, parameters.m_MaxHeight );
+		}
+	};
+
+	///	\brief	Sphere geometry
+	struct SphereGeometry
+	{
+		template < typename Displacer, typename Precision >
+		struct SseGenerator
+		{
+			typedef SseSphereTerrainGeneratorT< Displacer, Precision > Type;
+		};
+
+		template < typename Displacer >
+		struct ScalarGenerator
+		{
+			typedef ScalarSphereTerrainGeneratorT< Displacer > Type;
+		};
+
+		///	\brief	Gets a random point to displace, in displacement space (on the surface of a sphere of radius scale)
+		static void GetDisplacerInput( Random& random, const float scale, float* position )
+		{
+			float length = 0;
+			while ( length < 0.01f )
+			{
+				position[ 0 ] = random.Float( -1, 1 );
+				position[ 1 ] = random.Float( -1, 1 );
+				position[ 2 ] = random.Float( -1, 1 );
+				length = ScalarGetLength( position[ 0 ], position[ 1 ], position[ 2 ] );
+			}
+			ScalarSetLength( position[ 0 ], position[ 1 ], position[ 2 ], scale );
+		}
+
+		///	\brief	Gets a random patch on a cube face
+		static void GetPatch( Random& random, const TerrainParameters&, float* origin, float* xStep, float* zStep )
+		{
+			const int axis = random.Int( 0, 2 );
+			const float step = random.Float( 0.002f, 0.05f );
+			origin[ axis ] = random.OneIn( 2 ) ? -1.0f : 1.0f;
+			origin[ ( axis + 1 ) % 3 ] = random.Float( -1, 0.5f );
+			origin[ ( axis + 2 ) % 3 ] = random.Float( -1, 0.5f );
+			xStep[ 0 ] = xStep[ 1 ] = xStep[ 2 ] = 0;
+			zStep[ 0 ] = zStep[ 1 ] = zStep[ 2 ] = 0;
+			xStep[ ( axis + 1 ) % 3 ] = step;
+			zStep[ ( axis + 2 ) % 3 ] = step;
+		}
+	};
+
+	///	\brief	Plane geometry
+	struct PlaneGeometry
+	{
+		template < typename Displacer, typename Precision >
+		struct SseGenerator
+		{
+			typedef SsePlaneTerrainGeneratorT< Displacer, Precision > Type;
+		};
+
+		template < typename Displacer >
+		struct ScalarGenerator
+		{
+			typedef ScalarPlaneTerrainGeneratorT< Displacer > Type;
+		};
+
+		///	\brief	Gets a random point to displace, in displacement space
+		static void GetDisplacerInput( Random& random, const float scale, float* position )
+		{
+			position[ 0 ] = random.Float( -scale, scale );
+			position[ 1 ] = random.Float( -1, 1 );
+			position[ 2 ] = random.Float( -scale, scale );
+		}
+
+		///	\brief	Gets a random patch on the plane
+		static void GetPatch( Random& random, const TerrainParameters& parameters, float* origin, float* xStep, float* zStep )
+		{
+			const float step = random.Float( 0.001f, 0.02f ) * parameters.m_PatchScale;
+			origin[ 0 ] = random.Float( -parameters.m_PatchScale, 0 );
+			origin[ 1 ] = 0;
+			origin[ 2 ] = random.Float( -parameters.m_PatchScale, 0 );
+			xStep[ 0 ] = step;
+			xStep[ 1 ] = xStep[ 2 ] = 0;
+			zStep[ 0 ] = zStep[ 1 ] = 0;
+			zStep[ 2 ] = step;
+		}
+	};
+
+	//	------------------------------------------------------------------------- Planet fractal checks
+
+	///	\brief	Continent mask texels per noise lattice cell (see SsePlanetFractal::GetContinentMaskResolution())
+	const float ContinentMaskTexelsPerCell = 8;
+
+	///	\brief	Gets the largest difference between planet fractal values that use a continent mask, and the values without one
+	///
+	///	SseContinentMask::Sample() bilinearly interpolates each continent octave across cells h = 2/(resolution-1)
+	///	wide in face coordinates, which is out by at most h^2/8 times the sum of the second derivatives along u
+	///	and v. The noise n(f*r*P(u,v)) of an octave at frequency f changes along u by (f*r)^2 times the noise
+	///	curvature along P_u (|P_u| <= 1 on a face), plus f*r times the noise slope along P_uu (whose components
+	///	sum to at most 1.5). A noise error e changes the ridge signal (1-|n|)^2 by at most 2e+e^2, and each signal
+	///	weights the next octave by up to gain times itself, so the error carries on through the detail octaves.
+	///
+	float GetContinentMaskAbsolute( const float frequency, const float gain, const int lowOctaves, const int highOctaves, const float radius, const int resolution )
+	{
+		const float cellSize = 2.0f / float( resolution - 1 );
+		float octaveFrequency = 1;
+		float signalError = 0;
+		float error = 0;
+		float max = 1;
+		for ( int octave = 0; octave < highOctaves; ++octave )
+		{
+			float noiseError = 0;
+			if ( octave < lowOctaves )
+			{
+				const float scale = octaveFrequency * radius;
+				const float curvature = scale * scale * FunctionBounds::NoiseMaxCurvature + scale * 1.5f * FunctionBounds::NoiseMaxSlope;
+				noiseError = cellSize * cellSize / 8 * curvature * 2;
+				max += 1 / octaveFrequency;
+			}
+			signalError = noiseError * ( 2 + noiseError ) + gain * signalError;
+
+			//	SsePlanetFractal adds octave n > 0 with an amplitude of 1/freq^(n-1), and divides the sum by max
+			error += signalError * ( octave == 0 ? 1 : frequency / octaveFrequency );
+			octaveFrequency *= frequency;
+		}
+		return error / max;
+	}
+
+	template < typename Precision >
+	void CheckPlanetFractal( Run& run )
+	{
+		Comparison values( run.CreateComparison( "planet fractal" ) );
+		Comparison maskValues( "planet fractal (continent mask)", run.m_Variant, run.m_Tolerance );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const unsigned int seed = run.m_Random.Next( ) % 16;
+			const float frequency = run.m_Random.Float( 1.5f, 2.5f );
+			const float gain = run.m_Random.Float( 0.3f, 1.0f );
+			const int lowOctaves = run.m_Random.Int( 1, 2 );
+			const int highOctaves = run.m_Random.Int( lowOctaves, 10 );
+			const float radius = run.m_Random.Float( 1, 6 );
+
+			SsePlanetFractal* sseFractal = new ( Aligned( 16 ) ) SsePlanetFractal( seed );
+			ScalarPlanetFractal scalarFractal( seed );
+			sseFractal->Setup( frequency, gain, lowOctaves, highOctaves, 2.0f );
+			scalarFractal.Setup( frequency, gain, lowOctaves, highOctaves );
+
+			const int resolution = sseFractal->GetContinentMaskResolution( radius, ContinentMaskTexelsPerCell );
+			SseContinentMask* mask = new ( Aligned( 16 ) ) SseContinentMask;
+			mask->Bake< Precision >( *sseFractal, radius, resolution );
+
+			const float maskError = GetContinentMaskAbsolute( frequency, gain, lowOctaves, highOctaves, radius, resolution );
+
+			for ( int block = 0; block < 64; ++block )
+			{
+				float position[ 3 ];
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ], actual[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					SphereGeometry::GetDisplacerInput( run.m_Random, radius, position );
+					x[ lane ] = position[ 0 ];
+					y[ lane ] = position[ 1 ];
+					z[ lane ] = position[ 2 ];
+					expected[ lane ] = scalarFractal.GetValue( x[ lane ], y[ lane ], z[ lane ] );
+				}
+				sseFractal->SetContinentMask( 0 );
+				Store( actual, sseFractal->GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				values.Compare( expected, actual, 4 );
+
+				sseFractal->SetContinentMask( mask );
+				Store( actual, sseFractal->GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					maskValues.CompareBounds( expected[ lane ] - maskError, expected[ lane ] + maskError, actual[ lane ] );
+				}
+			}
+
+			AlignedDelete( mask );
+			AlignedDelete( sseFractal );
+		}
+		run.Finish( values );
+		run.Finish( maskValues );
+	}
+
+	template < typename Precision >
+	void CheckPlanetFractalBounds( Run& run )
+	{
+		Comparison comparison( run.CreateComparison( "planet fractal bounds" ) );
+		Comparison maskComparison( run.CreateComparison( "planet fractal bounds (continent mask)" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const unsigned int seed = run.m_Random.Next( ) % 16;
+			const float frequency = run.m_Random.Float( 1.5f, 2.5f );
+			const float gain = run.m_Random.Float( 0.3f, 1.0f );
+			const int lowOctaves = run.m_Random.Int( 1, 2 );
+			const int highOctaves = run.m_Random.Int( lowOctaves, 10 );
+			const float radius = run.m_Random.Float( 1, 6 );
+
+			SsePlanetFractal* fractal = new ( Aligned( 16 ) ) SsePlanetFractal( seed );
+			fractal->Setup( frequency, gain, lowOctaves, highOctaves, 2.0f );
+			SseContinentMask* mask = new ( Aligned( 16 ) ) SseContinentMask;
+			mask->Bake< Precision >( *fractal, radius, fractal->GetContinentMaskResolution( radius, ContinentMaskTexelsPerCell ) );
+
+			//	Regions are centred on the sphere that the mask was baked for
+			float centre[ 3 ];
+			SphereGeometry::GetDisplacerInput( run.m_Random, radius, centre );
+			const SseFunctionRegion region( GetRandomRegion( run.m_Random, centre ) );
+			float minValue, maxValue, minMaskValue, maxMaskValue;
+			fractal->SetContinentMask( 0 );
+			fractal->GetBounds( region, minValue, maxValue );
+			fractal->SetContinentMask( mask );
+			fractal->GetBounds( region, minMaskValue, maxMaskValue );
+
+			for ( int block = 0; block < 16; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], values[ 4 ], maskValues[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					GetRegionInput( run.m_Random, region, x[ lane ], y[ lane ], z[ lane ] );
+				}
+				fractal->SetContinentMask( 0 );
+				Store( values, fractal->GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				fractal->SetContinentMask( mask );
+				Store( maskValues, fractal->GetValue< Precision >( Load( x ), Load( y ), Load( z ) ) );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					comparison.CompareBounds( minValue, maxValue, values[ lane ] );
+					maskComparison.CompareBounds( minMaskValue, maxMaskValue, maskValues[ lane ] );
+				}
+			}
+
+			AlignedDelete( mask );
+			AlignedDelete( fractal );
+		}
+		run.Finish( comparison );
+		run.Finish( maskComparison );
+	}
+
+	//	------------------------------------------------------------------------- Terrain checks
+
+	template < typename Precision, typename Geometry, typename Config >
+	void CheckDisplacer( Run& run, const char* check )
+	{
+		Comparison comparison( run.CreateComparison( check ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			typename Config::SseDisplacer* sseDisplacer = new ( Aligned( 16 ) ) typename Config::SseDisplacer;
+			typename Config::ScalarDisplacer scalarDisplacer;
+			Config::Setup( *sseDisplacer, parameters );
+			Config::Setup( scalarDisplacer, parameters );
+
+			for ( int block = 0; block < 64; ++block )
+			{
+				//	Compare the heights, and the displaced positions
+				float position[ 4 ][ 3 ];
+				float x[ 4 ], y[ 4 ], z[ 4 ], expected[ 4 ][ 4 ], actual[ 4 ][ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					Geometry::GetDisplacerInput( run.m_Random, scalarDisplacer.GetFunctionScale( ), position[ lane ] );
+					x[ lane ] = position[ lane ][ 0 ];
+					y[ lane ] = position[ lane ][ 1 ];
+					z[ lane ] = position[ lane ][ 2 ];
+					expected[ 0 ][ lane ] = scalarDisplacer.Displace( position[ lane ][ 0 ], position[ lane ][ 1 ], position[ lane ][ 2 ] );
+					expected[ 1 ][ lane ] = position[ lane ][ 0 ];
+					expected[ 2 ][ lane ] = position[ lane ][ 1 ];
+					expected[ 3 ][ lane ] = position[ lane ][ 2 ];
+				}
+				__m128 xxxx = Load( x );
+				__m128 yyyy = Load( y );
+				__m128 zzzz = Load( z );
+				Store( actual[ 0 ], sseDisplacer->template Displace< Precision >( xxxx, yyyy, zzzz ) );
+				Store( actual[ 1 ], xxxx );
+				Store( actual[ 2 ], yyyy );
+				Store( actual[ 3 ], zzzz );
+				comparison.Compare( expected[ 0 ], actual[ 0 ], 16 );
+			}
+
+			AlignedDelete( sseDisplacer );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Compares patch vertices. Positions may be up to positionAllowance from the reference, other fields use the comparison tolerance
+	void ComparePatchVertices( Comparison& comparison, const UTerrainVertex* expected, const UTerrainVertex* actual, const int count, const float positionAllowance )
+	{
+		const int floatsPerVertex = sizeof( UTerrainVertex ) / sizeof( float );
+		for ( int index = 0; index < count; ++index )
+		{
+			const float* expectedValues = ( const float* )&expected[ index ];
+			const float* actualValues = ( const float* )&actual[ index ];
+			for ( int value = 0; value < floatsPerVertex; ++value )
+			{
+				if ( value < 3 )
+				{
+					comparison.CompareBounds( expectedValues[ value ] - positionAllowance, expectedValues[ value ] + positionAllowance, actualValues[ value ] );
+				}
+				else
+				{
+					comparison.Compare( expectedValues[ value ], actualValues[ value ] );
+				}
+			}
+		}
+	}
+
+	///	\brief	Compares SSE patches against scalar patches
+	///
+	///	At approximate precisions, ground displacers move each sample by an offset computed from approximate
+	///	noise. Where the terrain is steep, a slightly different offset samples a different part of the height
+	///	function, so no pointwise tolerance holds for every seed. The moved sample still lies in the patch,
+	///	so its height is inside the patch height bounds, and positions are allowed to move by up to the
+	///	displacer's height range times the height range of the patch. Functions that amplify their input
+	///	errors, such as selects, scale the absolute tolerance (see Config::GetToleranceScale()).
+	///
+	template < typename Precision, typename Geometry, typename Config >
+	void CheckPatches( Run& run, const char* check, const char* errorCheck )
+	{
+		typedef typename Geometry::template SseGenerator< typename Config::SseDisplacer, Precision >::Type SseGenerator;
+		typedef typename Geometry::template ScalarGenerator< typename Config::ScalarDisplacer >::Type ScalarGenerator;
+
+		Tolerance tolerance = run.m_Tolerance;
+		if ( DefaultTolerance< Precision >::Approximate )
+		{
+			tolerance.m_Absolute *= Config::GetToleranceScale( );
+		}
+		Comparison comparison( check, run.m_Variant, tolerance );
+		Comparison errorComparison( errorCheck, run.m_Variant, tolerance );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			SseGenerator* sseGenerator = new ( Aligned( 16 ) ) SseGenerator;
+			ScalarGenerator* scalarGenerator = new ScalarGenerator;
+			Config::Setup( sseGenerator->GetDisplacer( ), parameters );
+			Config::Setup( scalarGenerator->GetDisplacer( ), parameters );
+
+			float origin[ 3 ], xStep[ 3 ], zStep[ 3 ];
+			Geometry::GetPatch( run.m_Random, parameters, origin, xStep, zStep );
+			const float smallestStep = xStep[ 0 ] + xStep[ 1 ] + xStep[ 2 ];
+			sseGenerator->SetSmallestStepSize( smallestStep, smallestStep );
+			scalarGenerator->SetSmallestStepSize( smallestStep, smallestStep );
+
+			const float uv[ 2 ] = { run.m_Random.Float( 0, 1 ), run.m_Random.Float( 0, 1 ) };
+			const float uvRes = run.m_Random.Float( 0.01f, 1 );
+			const int width = run.m_Random.Int( 2, 33 );
+			const int height = run.m_Random.Int( 2, 33 );
+
+			std::vector< UTerrainVertex > expected( width * height );
+			std::vector< UTerrainVertex > actual( width * height );
+			memset( &expected[ 0 ], 0, sizeof( UTerrainVertex ) * expected.size( ) );
+			memset( &actual[ 0 ], 0, sizeof( UTerrainVertex ) * actual.size( ) );
+			scalarGenerator->GenerateVertices( origin, xStep, zStep, width, height, uv, uvRes, &expected[ 0 ] );
+			sseGenerator->GenerateVertices( origin, xStep, zStep, width, height, uv, uvRes, &actual[ 0 ] );
+
+			float positionAllowance = 0;
+			if ( DefaultTolerance< Precision >::Approximate && Config::GroundOffsets )
+			{
+				float minHeight, maxHeight;
+				sseGenerator->GetPatchHeightBounds( origin, xStep, zStep, width, height, minHeight, maxHeight );
+				positionAllowance = ( parameters.m_MaxHeight - parameters.m_MinHeight ) * ( maxHeight - minHeight );
+			}
+			ComparePatchVertices( comparison, &expected[ 0 ], &actual[ 0 ], width * height, positionAllowance );
+
+			//	The error generator modifies the step vectors
+			float scalarXStep[ 3 ] = { xStep[ 0 ], xStep[ 1 ], xStep[ 2 ] };
+			float scalarZStep[ 3 ] = { zStep[ 0 ], zStep[ 1 ], zStep[ 2 ] };
+			float expectedError = 0;
+			float actualError = 0;
+			memset( &expected[ 0 ], 0, sizeof( UTerrainVertex ) * expected.size( ) );
+			memset( &actual[ 0 ], 0, sizeof( UTerrainVertex ) * actual.size( ) );
+			scalarGenerator->GenerateVertices( origin, scalarXStep, scalarZStep, width, height, uv, uvRes, &expected[ 0 ], expectedError );
+			sseGenerator->GenerateVertices( origin, xStep, zStep, width, height, uv, uvRes, &actual[ 0 ], actualError );
+			ComparePatchVertices( errorComparison, &expected[ 0 ], &actual[ 0 ], width * height, positionAllowance );
+			errorComparison.CompareBounds( expectedError - positionAllowance, expectedError + positionAllowance, actualError );
+
+			delete scalarGenerator;
+			AlignedDelete( sseGenerator );
+		}
+		run.Finish( comparison );
+		run.Finish( errorComparison );
+	}
+
+	template < typename Precision, typename Geometry, typename Config >
+	void CheckPatchBounds( Run& run, const char* check )
+	{
+		typedef typename Geometry::template SseGenerator< typename Config::SseDisplacer, Precision >::Type SseGenerator;
+
+		Comparison comparison( run.CreateComparison( check ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			SseGenerator* generator = new ( Aligned( 16 ) ) SseGenerator;
+			Config::Setup( generator->GetDisplacer( ), parameters );
+
+			//	Some patches are stretched to cover most of a cube face, or a large area of the plane
+			float origin[ 3 ], xStep[ 3 ], zStep[ 3 ];
+			Geometry::GetPatch( run.m_Random, parameters, origin, xStep, zStep );
+			int width = run.m_Random.Int( 2, 33 );
+			int height = run.m_Random.Int( 2, 33 );
+			if ( run.m_Random.OneIn( 8 ) )
+			{
+				width = height = 65;
+			}
+
+			float minHeight, maxHeight;
+			generator->GetPatchHeightBounds( origin, xStep, zStep, width, height, minHeight, maxHeight );
+
+			for ( int block = 0; block < 16; ++block )
+			{
+				float x[ 4 ], y[ 4 ], z[ 4 ], heights[ 4 ];
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					const float col = float( run.m_Random.Int( 0, width - 1 ) );
+					const float row = float( run.m_Random.Int( 0, height - 1 ) );
+					x[ lane ] = origin[ 0 ] + xStep[ 0 ] * col + zStep[ 0 ] * row;
+					y[ lane ] = origin[ 1 ] + xStep[ 1 ] * col + zStep[ 1 ] * row;
+					z[ lane ] = origin[ 2 ] + xStep[ 2 ] * col + zStep[ 2 ] * row;
+				}
+				__m128 xxxx = Load( x );
+				__m128 yyyy = Load( y );
+				__m128 zzzz = Load( z );
+				generator->GetDisplacer( ).template MapToDisplacementSpace< Precision >( xxxx, yyyy, zzzz );
+				Store( heights, generator->GetDisplacer( ).template Displace< Precision >( xxxx, yyyy, zzzz ) );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					comparison.CompareBounds( minHeight, maxHeight, heights[ lane ] );
+				}
+			}
+
+			AlignedDelete( generator );
+		}
+		run.Finish( comparison );
+	}
+
+	template < typename Precision, typename Config >
+	void CheckCubeMapFaces( Run& run, const char* check )
+	{
+		typedef SseSphereTerrainGeneratorT< typename Config::SseDisplacer, Precision > SseGenerator;
+		typedef ScalarSphereTerrainGeneratorT< typename Config::ScalarDisplacer > ScalarGenerator;
+
+		Comparison comparison( run.CreateComparison( check ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			SseGenerator* sseGenerator = new ( Aligned( 16 ) ) SseGenerator;
+			ScalarGenerator* scalarGenerator = new ScalarGenerator;
+			Config::Setup( sseGenerator->GetDisplacer( ), parameters );
+			Config::Setup( scalarGenerator->GetDisplacer( ), parameters );
+			const float smallestStep = run.m_Random.Float( 0.001f, 0.01f );
+			sseGenerator->SetSmallestStepSize( smallestStep, smallestStep );
+			scalarGenerator->SetSmallestStepSize( smallestStep, smallestStep );
+			const UCubeMapProjection projection = run.m_Random.OneIn( 2 ) ? ProjectionTangent : ProjectionGnomonic;
+			sseGenerator->SetCubeMapProjection( projection );
+			scalarGenerator->SetCubeMapProjection( projection );
+
+			const int width = run.m_Random.Int( 4, 40 );
+			const int height = run.m_Random.Int( 2, 40 );
+			const int stride = width * 3 + run.m_Random.Int( 0, 3 );
+			for ( int face = 0; face < 6; ++face )
+			{
+				//	Buffers are prefilled, so pixels that aren't written (padding, or columns past the last whole block) must match too
+				std::vector< unsigned char > expected( stride * height, 0xcd );
+				std::vector< unsigned char > actual( stride * height, 0xcd );
+				scalarGenerator->GenerateTerrainPropertyCubeMapFace( UCubeMapFace( face ), width, height, stride, &expected[ 0 ] );
+
+				//	BC5 blocks made while the face is generated must match the written columns of the face, compressed afterwards
+				const int writtenWidth = ( width / 4 ) * 4;
+				const int blockRowStride = UBlockCompressor::GetBlockRowSize( UBlockCompressor::Bc5, writtenWidth ) + run.m_Random.Int( 0, 3 );
+				std::vector< unsigned char > expectedBlocks( blockRowStride * ( ( height + 3 ) / 4 ), 0xcd );
+				std::vector< unsigned char > actualBlocks( expectedBlocks );
+				const UBlockCompressor compressor( UBlockCompressor::Bc5, &actualBlocks[ 0 ], blockRowStride );
+				sseGenerator->GenerateTerrainPropertyCubeMapFace( UCubeMapFace( face ), width, height, stride, &actual[ 0 ], 0, &compressor );
+				comparison.CompareBytes( &expected[ 0 ], &actual[ 0 ], stride * height );
+
+				ScalarBlockCompressor::Compress( UBlockCompressor::Bc5, UPixelChannels( 3, 2, 1, 0, -1 ), writtenWidth, height, &actual[ 0 ], stride, &expectedBlocks[ 0 ], blockRowStride );
+				comparison.CompareBytes( &expectedBlocks[ 0 ], &actualBlocks[ 0 ], int( expectedBlocks.size( ) ) );
+			}
+
+			delete scalarGenerator;
+			AlignedDelete( sseGenerator );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks six-face cube maps against the scalar reference, and checks that texels shared by faces are identical in every face
+	template < typename Precision, typename Config >
+	void CheckCubeMap( Run& run, const char* check, const char* seamCheck )
+	{
+		typedef SseSphereTerrainGeneratorT< typename Config::SseDisplacer, Precision > SseGenerator;
+		typedef ScalarSphereTerrainGeneratorT< typename Config::ScalarDisplacer > ScalarGenerator;
+
+		//	Seams must match exactly at every precision
+		const Tolerance exactTolerance = { 0, 0, 0 };
+		Comparison comparison( run.CreateComparison( check ) );
+		Comparison seamComparison( seamCheck, run.m_Variant, exactTolerance );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			SseGenerator* sseGenerator = new ( Aligned( 16 ) ) SseGenerator;
+			ScalarGenerator* scalarGenerator = new ScalarGenerator;
+			Config::Setup( sseGenerator->GetDisplacer( ), parameters );
+			Config::Setup( scalarGenerator->GetDisplacer( ), parameters );
+			const UCubeMapProjection projection = run.m_Random.OneIn( 2 ) ? ProjectionTangent : ProjectionGnomonic;
+			sseGenerator->SetCubeMapProjection( projection );
+			scalarGenerator->SetCubeMapProjection( projection );
+
+			const int size = run.m_Random.Int( 1, 10 ) * 4;
+			const int stride = size * 3 + run.m_Random.Int( 0, 3 );
+			const int blockRowStride = UBlockCompressor::GetBlockRowSize( UBlockCompressor::Bc5, size ) + run.m_Random.Int( 0, 3 );
+			std::vector< std::vector< unsigned char > > expected( 6, std::vector< unsigned char >( stride * size, 0xcd ) );
+			std::vector< std::vector< unsigned char > > actual( expected );
+			std::vector< std::vector< unsigned char > > actualBlocks( 6, std::vector< unsigned char >( blockRowStride * ( size / 4 ), 0xcd ) );
+			std::vector< UBlockCompressor > compressors;
+			unsigned char* expectedPixels[ 6 ];
+			unsigned char* actualPixels[ 6 ];
+			const UBlockCompressor* facesCompressors[ 6 ];
+			for ( int face = 0; face < 6; ++face )
+			{
+				expectedPixels[ face ] = &expected[ face ][ 0 ];
+				actualPixels[ face ] = &actual[ face ][ 0 ];
+				compressors.push_back( UBlockCompressor( UBlockCompressor::Bc5, &actualBlocks[ face ][ 0 ], blockRowStride ) );
+			}
+			for ( int face = 0; face < 6; ++face )
+			{
+				facesCompressors[ face ] = &compressors[ face ];
+			}
+			scalarGenerator->GenerateTerrainPropertyCubeMap( size, stride, expectedPixels );
+			sseGenerator->GenerateTerrainPropertyCubeMap( size, stride, actualPixels, 0, facesCompressors );
+
+			for ( int face = 0; face < 6; ++face )
+			{
+				comparison.CompareBytes( expectedPixels[ face ], actualPixels[ face ], stride * size );
+
+				std::vector< unsigned char > expectedBlocks( actualBlocks[ face ].size( ), 0xcd );
+				ScalarBlockCompressor::Compress( UBlockCompressor::Bc5, UPixelChannels( 3, 2, 1, 0, -1 ), size, size, actualPixels[ face ], stride, &expectedBlocks[ 0 ], blockRowStride );
+				comparison.CompareBytes( &expectedBlocks[ 0 ], &actualBlocks[ face ][ 0 ], int( expectedBlocks.size( ) ) );
+
+				for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
+				{
+					for ( int k = 0; k < size - 1; ++k )
+					{
+						UCubeMapFace faces[ 3 ];
+						int rows[ 3 ], cols[ 3 ];
+						const int texels = UCubeMapSeams::GetEdgeTexels( size, UCubeMapFace( face ), UCubeMapSeams::Side( side ), k, faces, rows, cols );
+						for ( int texel = 1; texel < texels; ++texel )
+						{
+							seamComparison.CompareBytes( actualPixels[ face ] + rows[ 0 ] * stride + cols[ 0 ] * 3, actualPixels[ faces[ texel ] ] + rows[ texel ] * stride + cols[ texel ] * 3, 3 );
+						}
+					}
+				}
+			}
+
+			delete scalarGenerator;
+			AlignedDelete( sseGenerator );
+		}
+		run.Finish( comparison );
+		run.Finish( seamComparison );
+	}
+
+	///	\brief	Buffers for the levels of a UMipChain. Rows are padded by a random amount, and prefilled
+	class MipLevels
+	{
+		public :
+
+			MipLevels( Random& random, const int bytesPerPixel, const int width, const int height, const int levels )
+			{
+				for ( int level = 0; level < levels; ++level )
+				{
+					const int stride = UMipChain::GetLevelSize( width, level ) * bytesPerPixel + random.Int( 0, 3 );
+					m_Strides.push_back( stride );
+					m_Pixels.push_back( std::vector< unsigned char >( stride * UMipChain::GetLevelSize( height, level ), 0xcd ) );
+				}
+				SetupChain( );
+			}
+
+			///	\brief	Copies the layout and contents of another set of levels
+			MipLevels( const MipLevels& levels ) :
+				m_Pixels( levels.m_Pixels ),
+				m_Strides( levels.m_Strides )
+			{
+				SetupChain( );
+			}
+
+			const UMipChain& GetChain( ) const
+			{
+				return m_Chain;
+			}
+
+			///	\brief	Compares every level (including padding) with the same level of another set of levels
+			void Compare( Comparison& comparison, const MipLevels& actual ) const
+			{
+				for ( int level = 0; level < int( m_Pixels.size( ) ); ++level )
+				{
+					comparison.CompareBytes( &m_Pixels[ level ][ 0 ], &actual.m_Pixels[ level ][ 0 ], int( m_Pixels[ level ].size( ) ) );
+				}
+			}
+
+		private :
+
+			std::vector< std::vector< unsigned char > >	m_Pixels;
+			std::vector< int >							m_Strides;
+			UMipChain									m_Chain;
+
+			void SetupChain( )
+			{
+				for ( int level = 0; level < int( m_Pixels.size( ) ); ++level )
+				{
+					m_Chain.AddLevel( &m_Pixels[ level ][ 0 ], m_Strides[ level ] );
+				}
+			}
+
+			MipLevels& operator = ( const MipLevels& );
+	};
+
+	///	\brief	Checks that mip chains filled a row at a time match mip chains built a level at a time by ScalarMipChain
+	void CheckMipChain( Run& run )
+	{
+		const UPixelFormat formats[] = { FormatR8G8B8, FormatR8G8B8A8, FormatB8G8R8A8, FormatA8, FormatR8, FormatB8G8R8 };
+		const int formatCount = sizeof( formats ) / sizeof( formats[ 0 ] );
+
+		Comparison comparison( run.CreateComparison( "mip chain" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const UPixelFormat format = formats[ run.m_Random.Int( 0, formatCount - 1 ) ];
+			const UMipChain::Filter filter = run.m_Random.OneIn( 2 ) ? UMipChain::PointFilter : UMipChain::BoxFilter;
+			const int bytesPerPixel = GetBytesPerPixel( format );
+			const int width = run.m_Random.Int( 1, 80 );
+			const int height = run.m_Random.Int( 1, 40 );
+			const int stride = width * bytesPerPixel + run.m_Random.Int( 0, 3 );
+
+			std::vector< unsigned char > base( stride * height );
+			for ( int index = 0; index < int( base.size( ) ); ++index )
+			{
+				base[ index ] = ( unsigned char )run.m_Random.Int( 0, 255 );
+			}
+
+			MipLevels expected( run.m_Random, bytesPerPixel, width, height, run.m_Random.Int( 1, 8 ) );
+			MipLevels actual( expected );
+			ScalarMipChain::Build( format, filter, &base[ 0 ], width, height, stride, expected.GetChain( ) );
+			for ( int row = 0; row < height; ++row )
+			{
+				actual.GetChain( ).WriteRow( format, filter, width, height, &base[ 0 ], stride, row );
+			}
+			expected.Compare( comparison, actual );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Decodes a value from a BC4 block
+	int DecodeBc4Value( const unsigned char* block, const int texel )
+	{
+		unsigned long long indices = 0;
+		for ( int byte = 0; byte < 6; ++byte )
+		{
+			indices |= ( unsigned long long )block[ 2 + byte ] << ( byte * 8 );
+		}
+		const int index = int( ( indices >> ( texel * 3 ) ) & 7 );
+		const int value0 = block[ 0 ];
+		const int value1 = block[ 1 ];
+		if ( index < 2 )
+		{
+			return index == 0 ? value0 : value1;
+		}
+		if ( value0 > value1 )
+		{
+			return ( ( 8 - index ) * value0 + ( index - 1 ) * value1 ) / 7;
+		}
+		if ( index >= 6 )
+		{
+			return index == 6 ? 0 : 255;
+		}
+		return ( ( 6 - index ) * value0 + ( index - 1 ) * value1 ) / 5;
+	}
+
+	///	\brief	Checks that faces compressed a row at a time by UBlockCompressor match faces compressed by ScalarBlockCompressor
+	///
+	///	Also checks that every value decoded from a BC4 block is within half a palette step (plus rounding) of the
+	///	value that was compressed.
+	///
+	void CheckBlockCompression( Run& run )
+	{
+		const UPixelFormat formats[] = { FormatR8G8B8, FormatR8G8B8A8, FormatB8G8R8A8, FormatA8, FormatR8, FormatB8G8R8 };
+		const int formatCount = sizeof( formats ) / sizeof( formats[ 0 ] );
+		const UBlockCompressor::Format blockFormats[] = { UBlockCompressor::Bc3, UBlockCompressor::Bc4, UBlockCompressor::Bc5 };
+
+		Comparison comparison( run.CreateComparison( "block compression" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const UPixelFormat format = formats[ run.m_Random.Int( 0, formatCount - 1 ) ];
+			const UBlockCompressor::Format blockFormat = blockFormats[ run.m_Random.Int( 0, 2 ) ];
+			const UPixelChannels channels( UPixelChannels::FromFormat( format ) );
+			const int bytesPerPixel = GetBytesPerPixel( format );
+			const int width = run.m_Random.Int( 1, 70 );
+			const int height = run.m_Random.Int( 1, 30 );
+			const int stride = width * bytesPerPixel + run.m_Random.Int( 0, 3 );
+
+			//	Narrow ranges of values are as likely as wide ones, so that every palette step size is covered
+			const int base = run.m_Random.Int( 0, 255 );
+			const int range = run.m_Random.Int( 0, 255 - base );
+			std::vector< unsigned char > pixels( stride * height );
+			for ( int index = 0; index < int( pixels.size( ) ); ++index )
+			{
+				pixels[ index ] = ( unsigned char )( base + run.m_Random.Int( 0, range ) );
+			}
+
+			const int blockRowStride = UBlockCompressor::GetBlockRowSize( blockFormat, width ) + run.m_Random.Int( 0, 3 );
+			std::vector< unsigned char > expected( blockRowStride * ( ( height + 3 ) / 4 ), 0xcd );
+			std::vector< unsigned char > actual( expected );
+			ScalarBlockCompressor::Compress( blockFormat, channels, width, height, &pixels[ 0 ], stride, &expected[ 0 ], blockRowStride );
+			const UBlockCompressor compressor( blockFormat, &actual[ 0 ], blockRowStride );
+			for ( int row = 0; row < height; ++row )
+			{
+				compressor.WriteRow( channels, width, height, &pixels[ 0 ], stride, row );
+			}
+			comparison.CompareBytes( &expected[ 0 ], &actual[ 0 ], int( expected.size( ) ) );
+
+			//	The first BC4 block of a Bc4 or Bc5 face holds red (or alpha for Bc4 faces without red)
+			if ( blockFormat == UBlockCompressor::Bc3 )
+			{
+				continue;
+			}
+			const int redOffset = channels.GetOffset( UPixelChannels::Red );
+			const int offset = redOffset >= 0 ? redOffset : ( blockFormat == UBlockCompressor::Bc4 ? channels.GetOffset( UPixelChannels::Alpha ) : -1 );
+			for ( int row = 0; row < height; ++row )
+			{
+				for ( int col = 0; col < width; ++col )
+				{
+					const unsigned char* block = &actual[ ( row / 4 ) * blockRowStride + ( col / 4 ) * UBlockCompressor::GetBlockSize( blockFormat ) ];
+					const int value = offset < 0 ? 0 : pixels[ row * stride + col * bytesPerPixel + offset ];
+					const float error = float( block[ 0 ] - block[ 1 ] ) / 14.0f + 1.0f;
+					comparison.CompareBounds( float( value ) - error, float( value ) + error, float( DecodeBc4Value( block, ( row & 3 ) * 4 + ( col & 3 ) ) ) );
+				}
+			}
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks that USphereCloudsAnimation keyframes, generated a few rows per frame, match faces generated in one go
+	void CheckCloudsAnimation( Run& run )
+	{
+		Comparison comparison( run.CreateComparison( "clouds animation" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const int width = run.m_Random.Int( 2, 37 );
+			const int height = run.m_Random.Int( 2, 20 );
+			const int framesPerKey = run.m_Random.Int( 1, 7 );
+			const float xOffset = run.m_Random.Float( -10, 10 );
+			const float zOffset = run.m_Random.Float( -10, 10 );
+			const float xVelocity = run.m_Random.Float( -0.5f, 0.5f );
+			const float zVelocity = run.m_Random.Float( -0.5f, 0.5f );
+
+			USphereCloudsAnimation animation( width, height, framesPerKey );
+			USphereCloudsBitmap* clouds = new ( Aligned( 16 ) ) USphereCloudsBitmap;
+			animation.Start( xOffset, zOffset, xVelocity, zVelocity, 0.1f, 0.4f );
+
+			const int frames = framesPerKey * 2 + run.m_Random.Int( 0, framesPerKey * 2 );
+			std::vector< unsigned char > expected( width * height );
+			for ( int frame = 0; frame <= frames; ++frame )
+			{
+				if ( ( frame % framesPerKey ) == 0 )
+				{
+					//	Keyframes have just been swapped. Compare the current and next keyframes
+					for ( int key = 0; key < 2; ++key )
+					{
+						const float keyframe = float( frame / framesPerKey + key );
+						clouds->Setup( xOffset + xVelocity * keyframe, zOffset + zVelocity * keyframe, 0.1f, 0.4f );
+						for ( int face = 0; face < 6; ++face )
+						{
+							clouds->GenerateCloudsAlpha( UCubeMapFace( face ), width, height, 0, height, width, &expected[ 0 ] );
+							comparison.CompareBytes( &expected[ 0 ], animation.GetKeyframeFace( key, UCubeMapFace( face ) ), width * height );
+						}
+					}
+				}
+				if ( frame < frames )
+				{
+					animation.Update( );
+				}
+			}
+
+			//	Compare blended faces against the blend of the keyframes
+			const int blend = animation.GetBlend( );
+			const int stride = width * 4 + run.m_Random.Int( 0, 3 );
+			std::vector< unsigned char > expectedPixels( stride * height, 0xcd );
+			std::vector< unsigned char > actualPixels( stride * height, 0xcd );
+			for ( int face = 0; face < 6; ++face )
+			{
+				const unsigned char* current = animation.GetKeyframeFace( 0, UCubeMapFace( face ) );
+				const unsigned char* next = animation.GetKeyframeFace( 1, UCubeMapFace( face ) );
+				for ( int row = 0; row < height; ++row )
+				{
+					for ( int col = 0; col < width; ++col )
+					{
+						const int index = row * width + col;
+						unsigned char* pixel = &expectedPixels[ row * stride + col * 4 ];
+						pixel[ 0 ] = pixel[ 1 ] = pixel[ 2 ] = 0xff;
+						pixel[ 3 ] = ( unsigned char )( ( current[ index ] * ( 256 - blend ) + next[ index ] * blend ) >> 8 );
+					}
+				}
+				animation.GetCloudsFace( UCubeMapFace( face ), FormatR8G8B8A8, stride, &actualPixels[ 0 ], 0, 0 );
+				comparison.CompareBytes( &expectedPixels[ 0 ], &actualPixels[ 0 ], stride * height );
+			}
+
+			AlignedDelete( clouds );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks that every cloud face pixel format holds the alpha values from USphereCloudsBitmap::GenerateCloudsAlpha()
+	void CheckCloudsFormats( Run& run )
+	{
+		const UPixelFormat formats[] = { FormatR8G8B8, FormatR8G8B8A8, FormatB8G8R8A8, FormatA8, FormatR8, FormatB8G8R8 };
+		const int formatCount = sizeof( formats ) / sizeof( formats[ 0 ] );
+
+		Comparison comparison( run.CreateComparison( "clouds formats" ) );
+		USphereCloudsBitmap* clouds = new ( Aligned( 16 ) ) USphereCloudsBitmap;
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const int width = run.m_Random.Int( 2, 53 );
+			const int height = run.m_Random.Int( 2, 20 );
+			const UCubeMapFace face = UCubeMapFace( run.m_Random.Int( 0, 5 ) );
+			clouds->Setup( run.m_Random.Float( -10, 10 ), run.m_Random.Float( -10, 10 ), 0.1f, 0.4f );
+
+			std::vector< unsigned char > alpha( width * height );
+			clouds->GenerateCloudsAlpha( face, width, height, 0, height, width, &alpha[ 0 ] );
+
+			const UPixelFormat format = formats[ run.m_Random.Int( 0, formatCount - 1 ) ];
+			const int bytesPerPixel = GetBytesPerPixel( format );
+			const int stride = width * bytesPerPixel + run.m_Random.Int( 0, 3 );
+
+			//	Padding past the end of each row must not be written
+			std::vector< unsigned char > expected( stride * height, 0xcd );
+			std::vector< unsigned char > actual( stride * height, 0xcd );
+			for ( int row = 0; row < height; ++row )
+			{
+				for ( int col = 0; col < width; ++col )
+				{
+					unsigned char* pixel = &expected[ row * stride + col * bytesPerPixel ];
+					for ( int channel = 0; channel < bytesPerPixel; ++channel )
+					{
+						pixel[ channel ] = 0xff;
+					}
+					if ( bytesPerPixel != 3 )
+					{
+						pixel[ bytesPerPixel - 1 ] = alpha[ row * width + col ];
+					}
+				}
+			}
+			//	Mip levels are built from the expected face
+			MipLevels expectedLevels( run.m_Random, bytesPerPixel, width, height, run.m_Random.Int( 0, 6 ) );
+			MipLevels actualLevels( expectedLevels );
+			ScalarMipChain::Build( format, UMipChain::BoxFilter, &expected[ 0 ], width, height, stride, expectedLevels.GetChain( ) );
+
+			//	Compressed blocks are made from the expected face too
+			const UBlockCompressor::Format blockFormat = USphereCloudsBitmap::GetCompressedFormat( format );
+			const int blockRowStride = UBlockCompressor::GetBlockRowSize( blockFormat, width ) + run.m_Random.Int( 0, 3 );
+			std::vector< unsigned char > expectedBlocks( blockRowStride * ( ( height + 3 ) / 4 ), 0xcd );
+			std::vector< unsigned char > actualBlocks( expectedBlocks );
+			ScalarBlockCompressor::Compress( blockFormat, UPixelChannels::FromFormat( format ), width, height, &expected[ 0 ], stride, &expectedBlocks[ 0 ], blockRowStride );
+			const UBlockCompressor compressor( blockFormat, &actualBlocks[ 0 ], blockRowStride );
+
+			clouds->GenerateCloudsFace( face, format, width, height, stride, &actual[ 0 ], &actualLevels.GetChain( ), &compressor );
+			comparison.CompareBytes( &expected[ 0 ], &actual[ 0 ], stride * height );
+			expectedLevels.Compare( comparison, actualLevels );
+			comparison.CompareBytes( &expectedBlocks[ 0 ], &actualBlocks[ 0 ], int( expectedBlocks.size( ) ) );
+		}
+		AlignedDelete( clouds );
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks that six-face cloud cube maps match single faces, with edges and corners taken from the faces that own them
+	void CheckCloudsCubeMap( Run& run )
+	{
+		const UPixelFormat formats[] = { FormatR8G8B8A8, FormatB8G8R8A8, FormatA8, FormatR8 };
+		const int formatCount = sizeof( formats ) / sizeof( formats[ 0 ] );
+
+		Comparison comparison( run.CreateComparison( "clouds cube map" ) );
+		USphereCloudsBitmap* clouds = new ( Aligned( 16 ) ) USphereCloudsBitmap;
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			const int size = run.m_Random.Int( 2, 40 );
+			clouds->Setup( run.m_Random.Float( -10, 10 ), run.m_Random.Float( -10, 10 ), 0.1f, 0.4f );
+			clouds->SetProjection( run.m_Random.OneIn( 2 ) ? ProjectionTangent : ProjectionGnomonic );
+
+			const UPixelFormat format = formats[ run.m_Random.Int( 0, formatCount - 1 ) ];
+			const int bytesPerPixel = GetBytesPerPixel( format );
+			const int stride = size * bytesPerPixel + run.m_Random.Int( 0, 3 );
+			std::vector< std::vector< unsigned char > > faces( 6, std::vector< unsigned char >( stride * size, 0xcd ) );
+			std::vector< std::vector< unsigned char > > actual( faces );
+			unsigned char* actualPixels[ 6 ];
+			for ( int face = 0; face < 6; ++face )
+			{
+				clouds->GenerateCloudsFace( UCubeMapFace( face ), format, size, size, stride, &faces[ face ][ 0 ], 0, 0 );
+				actualPixels[ face ] = &actual[ face ][ 0 ];
+			}
+			clouds->GenerateCloudsCubeMap( format, size, stride, actualPixels, 0, 0 );
+
+			std::vector< std::vector< unsigned char > > expected( faces );
+			for ( int face = 0; face < 6; ++face )
+			{
+				for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
+				{
+					for ( int k = 0; k < size - 1; ++k )
+					{
+						UCubeMapFace ownerFace = UCubeMapFace( face );
+						UCubeMapSeams::Side ownerSide = UCubeMapSeams::Side( side );
+						int ownerK = k;
+						if ( k == 0 )
+						{
+							UCubeMapSeams::GetCornerOwner( UCubeMapFace( face ), UCubeMapSeams::Side( side ), ownerFace, ownerSide );
+						}
+						else if ( !UCubeMapSeams::OwnsEdge( UCubeMapFace( face ), UCubeMapSeams::Side( side ) ) )
+						{
+							UCubeMapSeams::GetNeighbour( UCubeMapFace( face ), UCubeMapSeams::Side( side ), ownerFace, ownerSide );
+							ownerK = size - 1 - k;
+						}
+						int row, col, ownerRow, ownerCol;
+						UCubeMapSeams::GetSideTexel( size, UCubeMapSeams::Side( side ), 0, k, row, col );
+						UCubeMapSeams::GetSideTexel( size, ownerSide, 0, ownerK, ownerRow, ownerCol );
+						memcpy( &expected[ face ][ row * stride + col * bytesPerPixel ], &faces[ ownerFace ][ ownerRow * stride + ownerCol * bytesPerPixel ], bytesPerPixel );
+					}
+				}
+			}
+			for ( int face = 0; face < 6; ++face )
+			{
+				comparison.CompareBytes( &expected[ face ][ 0 ], actualPixels[ face ], stride * size );
+			}
+		}
+		AlignedDelete( clouds );
+		run.Finish( comparison );
+	}
+
+	///	\brief	Fills a terrain type selector with random cells
+	void RandomizeSelector( Random& random, UTerrainTypeSelector& selector )
+	{
+		selector.SetSize( random.Int( 1, 4 ), random.Int( 1, 8 ), random.Int( 1, 8 ) );
+		for ( int latitude = 0; latitude < selector.GetCells( UTerrainTypeSelector::LatitudeAxis ); ++latitude )
+		{
+			for ( int height = 0; height < selector.GetCells( UTerrainTypeSelector::HeightAxis ); ++height )
+			{
+				for ( int slope = 0; slope < selector.GetCells( UTerrainTypeSelector::SlopeAxis ); ++slope )
+				{
+					const UColour colour( ( unsigned char )random.Int( 0, 255 ), ( unsigned char )random.Int( 0, 255 ), ( unsigned char )random.Int( 0, 255 ), ( unsigned char )random.Int( 0, 255 ) );
+					selector.SetCell( latitude, height, slope, colour, ( unsigned char )random.Int( 0, 15 ) );
+				}
+			}
+		}
+	}
+
+	///	\brief	Checks the byte order of terrain type pixels against a known colour. GDI+ bitmaps are blue first, so
+	///	Format24bppRgb maps to FormatB8G8R8, and Format32bppArgb to FormatB8G8R8A8
+	void CheckTerrainTypeByteOrder( Run& run )
+	{
+		const UPixelFormat formats[] = { FormatR8G8B8, FormatR8G8B8A8, FormatB8G8R8A8, FormatB8G8R8 };
+		const unsigned char expectedPixels[][ 4 ] = { { 200, 100, 50, 0 }, { 200, 100, 50, 255 }, { 50, 100, 200, 255 }, { 50, 100, 200, 0 } };
+		const int formatCount = sizeof( formats ) / sizeof( formats[ 0 ] );
+
+		UTerrainTypeSelector selector;
+		selector.SetSize( 1, 1, 1 );
+		selector.SetCell( 0, 0, 0, UColour( 200, 100, 50, 255 ), 0 );
+
+		Comparison comparison( run.CreateComparison( "terrain type byte order" ) );
+		for ( int format = 0; format < formatCount; ++format )
+		{
+			const int bytesPerPixel = GetBytesPerPixel( formats[ format ] );
+			unsigned char expected[ 16 ];
+			unsigned char actual[ 16 ];
+			for ( int pixel = 0; pixel < 4; ++pixel )
+			{
+				memcpy( expected + pixel * bytesPerPixel, expectedPixels[ format ], bytesPerPixel );
+			}
+			const __m128 half = _mm_set1_ps( 0.5f );
+			selector.WritePixels( formats[ format ], half, half, half, actual );
+			comparison.CompareBytes( expected, actual, bytesPerPixel * 4 );
+		}
+		run.Finish( comparison );
+	}
+
+	template < typename Precision, typename Config >
+	void CheckTerrainTypeFaces( Run& run, const char* check )
+	{
+		typedef SseSphereTerrainGeneratorT< typename Config::SseDisplacer, Precision > SseGenerator;
+		typedef ScalarSphereTerrainGeneratorT< typename Config::ScalarDisplacer > ScalarGenerator;
+		const UPixelFormat formats[] = { FormatR8G8B8, FormatR8G8B8A8, FormatB8G8R8A8, FormatA8, FormatR8, FormatB8G8R8 };
+		const int formatCount = sizeof( formats ) / sizeof( formats[ 0 ] );
+
+		Comparison comparison( run.CreateComparison( check ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+
+			SseGenerator* sseGenerator = new ( Aligned( 16 ) ) SseGenerator;
+			ScalarGenerator* scalarGenerator = new ScalarGenerator;
+			Config::Setup( sseGenerator->GetDisplacer( ), parameters );
+			Config::Setup( scalarGenerator->GetDisplacer( ), parameters );
+
+			UTerrainTypeSelector selector;
+			RandomizeSelector( run.m_Random, selector );
+
+			const UPixelFormat format = formats[ run.m_Random.Int( 0, formatCount - 1 ) ];
+			const int width = run.m_Random.Int( 4, 40 );
+			const int height = run.m_Random.Int( 2, 40 );
+			const int stride = width * GetBytesPerPixel( format ) + run.m_Random.Int( 0, 3 );
+			const UCubeMapFace face = UCubeMapFace( run.m_Random.Int( 0, 5 ) );
+
+			std::vector< unsigned char > expected( stride * height, 0xcd );
+			std::vector< unsigned char > actual( stride * height, 0xcd );
+			scalarGenerator->GenerateTerrainTypeCubeMapFace( face, selector, format, width, height, stride, &expected[ 0 ] );
+
+			//	Mip levels are built from the written columns of the expected face. Terrain types are point sampled
+			const int writtenWidth = ( width / 4 ) * 4;
+			const UMipChain::Filter filter = GetBytesPerPixel( format ) == 1 ? UMipChain::PointFilter : UMipChain::BoxFilter;
+			MipLevels expectedLevels( run.m_Random, GetBytesPerPixel( format ), writtenWidth, height, run.m_Random.Int( 0, 6 ) );
+			MipLevels actualLevels( expectedLevels );
+			ScalarMipChain::Build( format, filter, &expected[ 0 ], writtenWidth, height, stride, expectedLevels.GetChain( ) );
+
+			sseGenerator->GenerateTerrainTypeCubeMapFace( face, selector, format, width, height, stride, &actual[ 0 ], &actualLevels.GetChain( ) );
+			comparison.CompareBytes( &expected[ 0 ], &actual[ 0 ], stride * height );
+			expectedLevels.Compare( comparison, actualLevels );
+
+			delete scalarGenerator;
+			AlignedDelete( sseGenerator );
+		}
+		run.Finish( comparison );
+	}
+
+	//	------------------------------------------------------------------------- Runs
+
+	typedef FlatConfig< SseFlatSphereTerrainDisplacer, ScalarFlatSphereTerrainDisplacer > SphereFlatConfig;
+	typedef HeightConfig< SseSphereFunction3dDisplacer< SseSimpleFractal >, ScalarSphereFunction3dDisplacer< ScalarSimpleFractal > > SphereSimpleConfig;
+	typedef HeightConfig< SseSphereFunction3dDisplacer< SseRidgedFractal >, ScalarSphereFunction3dDisplacer< ScalarRidgedFractal > > SphereRidgedConfig;
+	typedef GroundConfig
+	<
+		SseSphereFunction3dGroundDisplacer< SseSphereFunction3dDisplacer< SseRidgedFractal >, SseSimpleFractal >,
+		ScalarSphereFunction3dGroundDisplacer< ScalarSphereFunction3dDisplacer< ScalarRidgedFractal >, ScalarSimpleFractal >
+	> SphereGroundConfig;
+	typedef GroundFieldConfig
+	<
+		SseSphereFunction3dGroundDisplacer< SseSphereFunction3dDisplacer< SseRidgedFractal >, SseSimpleFractal >,
+		ScalarSphereFunction3dGroundDisplacer< ScalarSphereFunction3dDisplacer< ScalarRidgedFractal >, ScalarSimpleFractal >,
+		false
+	> SphereGroundFieldConfig;
+	typedef GroundFieldConfig
+	<
+		SseSphereFunction3dGroundDisplacer< SseSphereFunction3dDisplacer< SseRidgedFractal >, SseSimpleFractal >,
+		ScalarSphereFunction3dGroundDisplacer< ScalarSphereFunction3dDisplacer< ScalarRidgedFractal >, ScalarSimpleFractal >,
+		true
+	> SphereReducedGroundFieldConfig;
+
+	typedef FlatConfig< SseFlatPlaneTerrainDisplacer, ScalarFlatPlaneTerrainDisplacer > PlaneFlatConfig;
+	typedef HeightConfig< SsePlaneFunction3dDisplacer< SseSimpleFractal >, ScalarPlaneFunction3dDisplacer< ScalarSimpleFractal > > PlaneSimpleConfig;
+	typedef HeightConfig< SsePlaneFunction3dDisplacer< SseRidgedFractal >, ScalarPlaneFunction3dDisplacer< ScalarRidgedFractal > > PlaneRidgedConfig;
+	typedef GroundConfig
+	<
+		SsePlaneFunction3dGroundDisplacer< SsePlaneFunction3dDisplacer< SseRidgedFractal >, SseSimpleFractal >,
+		ScalarPlaneFunction3dGroundDisplacer< ScalarPlaneFunction3dDisplacer< ScalarRidgedFractal >, ScalarSimpleFractal >
+	> PlaneGroundConfig;
+
+	typedef CompositeConfig< SseSphereFunction3dDisplacer< SseComposite >, ScalarSphereFunction3dDisplacer< ScalarComposite > > SphereCompositeConfig;
+	typedef CompositeConfig< SsePlaneFunction3dDisplacer< SseComposite >, ScalarPlaneFunction3dDisplacer< ScalarComposite > > PlaneCompositeConfig;
+
+	///	\brief	Checks that every patch of a LOD level, on every cube face, makes the same ground field reduction choice
+	///
+	///	Neighbouring patches that made different choices would sample their shared edges differently, and crack.
+	///
+	void CheckGroundFieldLevels( Run& run )
+	{
+		typedef SphereGroundFieldConfig::SseDisplacer Displacer;
+		Comparison comparison( run.CreateComparison( "ground field levels" ) );
+		UTerrainTileRoot roots[ 6 ];
+		UTerrainTilePyramid::GetCubeRoots( roots );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			Displacer* displacer = new ( Aligned( 16 ) ) Displacer;
+			displacer->SetFunctionScale( run.m_Random.Float( 0.5f, 8 ) );
+			displacer->SetGroundField( true, run.m_Random.Float( 0.001f, 1 ) );
+
+			const int level = run.m_Random.Int( 0, 8 );
+			const int steps = run.m_Random.Int( 1, 16 ) * 2;
+			const float stepScale = 1.0f / float( steps << level );
+			bool expected = false;
+			for ( int face = 0; face < 6; ++face )
+			{
+				const UTerrainTileRoot& root = roots[ face ];
+				const float xStep[ 3 ] = { root.m_UAxis[ 0 ] * stepScale, root.m_UAxis[ 1 ] * stepScale, root.m_UAxis[ 2 ] * stepScale };
+				const float zStep[ 3 ] = { root.m_VAxis[ 0 ] * stepScale, root.m_VAxis[ 1 ] * stepScale, root.m_VAxis[ 2 ] * stepScale };
+				for ( int patch = 0; patch < 8; ++patch )
+				{
+					const float u = float( run.m_Random.Int( 0, ( 1 << level ) - 1 ) ) / float( 1 << level );
+					const float v = float( run.m_Random.Int( 0, ( 1 << level ) - 1 ) ) / float( 1 << level );
+					float origin[ 3 ];
+					for ( int axis = 0; axis < 3; ++axis )
+					{
+						origin[ axis ] = root.m_Origin[ axis ] + root.m_UAxis[ axis ] * u + root.m_VAxis[ axis ] * v;
+					}
+					const bool reduced = displacer->IsGroundFieldReduced( origin, xStep, zStep );
+					expected = ( ( face == 0 ) && ( patch == 0 ) ) ? reduced : expected;
+					comparison.Compare( expected ? 1.0f : 0.0f, reduced ? 1.0f : 0.0f );
+				}
+			}
+			AlignedDelete( displacer );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	A tile requested from a UTerrainTileStreamer
+	struct TileRequest
+	{
+		float	m_Priority;
+		int		m_Face;
+		int		m_Level;
+		int		m_X;
+		int		m_Y;
+
+		bool operator < ( const TileRequest& request ) const
+		{
+			return m_Priority > request.m_Priority;
+		}
+	};
+
+	///	\brief	Checks that tiles streamed from a baked UTerrainTilePyramid match the patches they were generated from
+	///
+	///	Decoded vertices must be within UTerrainTileCodec::GetMaxError() of UTerrainTilePyramid::GetTileVertices(), and index entries
+	///	must hold the generated error exactly and bound every vertex. The streamer must keep the highest priority
+	///	tiles resident, up to its limit, and replace tiles that weren't requested when it runs out of room.
+	///
+	void CheckTerrainTilePyramid( Run& run )
+	{
+		typedef SseSphereTerrainGeneratorT< SphereSimpleConfig::SseDisplacer, SseExactPrecision > Generator;
+		const char* path = "Poc1.Fast.Differential.tiles";
+		const int channels = sizeof( UTerrainVertex ) / sizeof( float );
+
+		Comparison comparison( run.CreateComparison( "terrain tile pyramid" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+			Generator* generator = new ( Aligned( 16 ) ) Generator;
+			SphereSimpleConfig::Setup( generator->GetDisplacer( ), parameters );
+
+			const int resolution = run.m_Random.Int( 2, 12 );
+			const int depth = run.m_Random.Int( 1, 3 );
+			const float smallestStep = 2.0f / float( ( resolution - 1 ) << ( depth - 1 ) );
+			generator->SetSmallestStepSize( smallestStep, smallestStep );
+
+			UTerrainTileRoot roots[ 6 ];
+			UTerrainTilePyramid::GetCubeRoots( roots );
+			//	Small windows (rounded up to a page) spread the file over many windows
+			const int maxResidentTiles = run.m_Random.Int( 1, 8 );
+			const long long windowSize = run.m_Random.OneIn( 2 ) ? 1 : UTerrainTileStreamer::DefaultWindowSize;
+			UTerrainTileStreamer streamer;
+			const bool opened = UTerrainTilePyramid::Bake( path, *generator, roots, resolution, depth ) && streamer.Open( path, maxResidentTiles, windowSize, run.m_Random.Int( 1, 4 ) );
+			comparison.Compare( 1.0f, opened ? 1.0f : 0.0f );
+			if ( !opened )
+			{
+				AlignedDelete( generator );
+				continue;
+			}
+
+			//	Request distinct tiles with distinct priorities
+			std::vector< TileRequest > requests;
+			const int requestCount = run.m_Random.Int( 1, 12 );
+			for ( int request = 0; request < requestCount; ++request )
+			{
+				TileRequest tile;
+				tile.m_Face = run.m_Random.Int( 0, 5 );
+				tile.m_Level = run.m_Random.Int( 0, depth - 1 );
+				tile.m_X = run.m_Random.Int( 0, ( 1 << tile.m_Level ) - 1 );
+				tile.m_Y = run.m_Random.Int( 0, ( 1 << tile.m_Level ) - 1 );
+				tile.m_Priority = float( request ) + run.m_Random.Float( 0, 0.5f );
+				bool repeated = false;
+				for ( int previous = 0; previous < int( requests.size( ) ); ++previous )
+				{
+					repeated = repeated || ( ( requests[ previous ].m_Face == tile.m_Face ) && ( requests[ previous ].m_Level == tile.m_Level ) && ( requests[ previous ].m_X == tile.m_X ) && ( requests[ previous ].m_Y == tile.m_Y ) );
+				}
+				if ( !repeated )
+				{
+					requests.push_back( tile );
+					streamer.Request( tile.m_Face, tile.m_Level, tile.m_X, tile.m_Y, tile.m_Priority );
+				}
+			}
+			const int residentCount = int( requests.size( ) ) < maxResidentTiles ? int( requests.size( ) ) : maxResidentTiles;
+			comparison.Compare( float( residentCount ), float( streamer.Update( 1000 ) ) );
+			comparison.Compare( float( residentCount ), float( streamer.GetResidentCount( ) ) );
+
+			const int vertexCount = resolution * resolution;
+			std::vector< UTerrainVertex > expected( vertexCount );
+			std::sort( requests.begin( ), requests.end( ) );
+			for ( int request = 0; request < int( requests.size( ) ); ++request )
+			{
+				const TileRequest& tile = requests[ request ];
+				const UTerrainVertex* actual = streamer.GetTile( tile.m_Face, tile.m_Level, tile.m_X, tile.m_Y );
+				comparison.Compare( request < residentCount ? 1.0f : 0.0f, actual != 0 ? 1.0f : 0.0f );
+				if ( actual == 0 )
+				{
+					continue;
+				}
+
+				float error = 0;
+				UTerrainTilePyramid::GetTileVertices( *generator, roots[ tile.m_Face ], resolution, tile.m_Level, tile.m_X, tile.m_Y, &expected[ 0 ], error );
+
+				UTerrainTileEntry entry;
+				comparison.Compare( 1.0f, streamer.GetEntry( tile.m_Face, tile.m_Level, tile.m_X, tile.m_Y, entry ) ? 1.0f : 0.0f );
+				comparison.Compare( error, entry.m_Error );
+				for ( int vertex = 0; vertex < vertexCount; ++vertex )
+				{
+					const float dx = expected[ vertex ].X( ) - entry.m_Centre[ 0 ];
+					const float dy = expected[ vertex ].Y( ) - entry.m_Centre[ 1 ];
+					const float dz = expected[ vertex ].Z( ) - entry.m_Centre[ 2 ];
+					comparison.CompareBounds( 0, entry.m_Radius, sqrtf( dx * dx + dy * dy + dz * dz ) );
+				}
+
+				const float* expectedValues = ( const float* )&expected[ 0 ];
+				const float* actualValues = ( const float* )actual;
+				for ( int channel = 0; channel < channels; ++channel )
+				{
+					float minValue = expectedValues[ channel ];
+					float maxValue = expectedValues[ channel ];
+					for ( int vertex = 1; vertex < vertexCount; ++vertex )
+					{
+						minValue = expectedValues[ vertex * channels + channel ] < minValue ? expectedValues[ vertex * channels + channel ] : minValue;
+						maxValue = expectedValues[ vertex * channels + channel ] > maxValue ? expectedValues[ vertex * channels + channel ] : maxValue;
+					}
+					const float maxError = UTerrainTileCodec::GetMaxError( minValue, maxValue );
+					for ( int vertex = 0; vertex < vertexCount; ++vertex )
+					{
+						const float value = expectedValues[ vertex * channels + channel ];
+						comparison.CompareBounds( value - maxError, value + maxError, actualValues[ vertex * channels + channel ] );
+					}
+				}
+			}
+
+			//	Requesting only the tiles left out replaces the least recently used tiles, a decode at a time
+			const int leftOut = int( requests.size( ) ) - residentCount;
+			for ( int request = residentCount; request < int( requests.size( ) ); ++request )
+			{
+				streamer.Request( requests[ request ].m_Face, requests[ request ].m_Level, requests[ request ].m_X, requests[ request ].m_Y, requests[ request ].m_Priority );
+			}
+			comparison.Compare( leftOut > 0 ? 1.0f : 0.0f, float( streamer.Update( 1 ) ) );
+			comparison.Compare( float( residentCount ), float( streamer.GetResidentCount( ) ) );
+			if ( leftOut > 0 )
+			{
+				//	Resident tiles were all last requested in the same frame, so the first one decoded is replaced
+				const TileRequest& decoded = requests[ residentCount ];
+				const TileRequest& replaced = requests[ 0 ];
+				comparison.Compare( 1.0f, streamer.GetTile( decoded.m_Face, decoded.m_Level, decoded.m_X, decoded.m_Y ) != 0 ? 1.0f : 0.0f );
+				comparison.Compare( 0.0f, streamer.GetTile( replaced.m_Face, replaced.m_Level, replaced.m_X, replaced.m_Y ) != 0 ? 1.0f : 0.0f );
+			}
+
+			streamer.Close( );
+			remove( path );
+			AlignedDelete( generator );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Checks that neighbouring tiles streamed from a baked UTerrainTilePyramid decode to the same vertices
+	///	along their shared edge, bit for bit, so that meshes made from them don't crack
+	void CheckTerrainTileEdges( Run& run )
+	{
+		typedef SseSphereTerrainGeneratorT< SphereSimpleConfig::SseDisplacer, SseExactPrecision > Generator;
+		const char* path = "Poc1.Fast.Differential.tiles";
+
+		Comparison comparison( run.CreateComparison( "terrain tile edges" ) );
+		for ( int iteration = 0; iteration < run.m_Iterations; ++iteration )
+		{
+			TerrainParameters parameters;
+			parameters.Randomize( run.m_Random );
+			Generator* generator = new ( Aligned( 16 ) ) Generator;
+			SphereSimpleConfig::Setup( generator->GetDisplacer( ), parameters );
+
+			const int resolution = run.m_Random.Int( 2, 12 );
+			const int depth = run.m_Random.Int( 2, 3 );
+			const float smallestStep = 2.0f / float( ( resolution - 1 ) << ( depth - 1 ) );
+			generator->SetSmallestStepSize( smallestStep, smallestStep );
+
+			UTerrainTileRoot roots[ 6 ];
+			UTerrainTilePyramid::GetCubeRoots( roots );
+			UTerrainTileStreamer streamer;
+			const bool opened = UTerrainTilePyramid::Bake( path, *generator, roots, resolution, depth ) && streamer.Open( path, 2 );
+			comparison.Compare( 1.0f, opened ? 1.0f : 0.0f );
+			if ( !opened )
+			{
+				AlignedDelete( generator );
+				continue;
+			}
+
+			//	Pick a tile and its neighbour to the right, or below
+			const int face = run.m_Random.Int( 0, 5 );
+			const int level = run.m_Random.Int( 1, depth - 1 );
+			const bool right = run.m_Random.Int( 0, 1 ) == 0;
+			const int x = run.m_Random.Int( 0, ( 1 << level ) - ( right ? 2 : 1 ) );
+			const int y = run.m_Random.Int( 0, ( 1 << level ) - ( right ? 1 : 2 ) );
+			const int neighbourX = right ? x + 1 : x;
+			const int neighbourY = right ? y : y + 1;
+			streamer.Request( face, level, x, y, 1 );
+			streamer.Request( face, level, neighbourX, neighbourY, 1 );
+			streamer.Update( 2 );
+
+			const UTerrainVertex* tile = streamer.GetTile( face, level, x, y );
+			const UTerrainVertex* neighbour = streamer.GetTile( face, level, neighbourX, neighbourY );
+			comparison.Compare( 1.0f, ( tile != 0 ) && ( neighbour != 0 ) ? 1.0f : 0.0f );
+			if ( ( tile != 0 ) && ( neighbour != 0 ) )
+			{
+				for ( int k = 0; k < resolution; ++k )
+				{
+					const int index = right ? k * resolution + resolution - 1 : ( resolution - 1 ) * resolution + k;
+					const int neighbourIndex = right ? k * resolution : k;
+					comparison.CompareBytes( ( const unsigned char* )&tile[ index ], ( const unsigned char* )&neighbour[ neighbourIndex ], sizeof( UTerrainVertex ) );
+				}
+			}
+
+			streamer.Close( );
+			remove( path );
+			AlignedDelete( generator );
+		}
+		run.Finish( comparison );
+	}
+
+	///	\brief	Runs all checks for a precision. Returns the number of checks that failed
+	template < typename Precision >
+	int RunChecks( const Options& options, const char* variant )
+	{
+		Run run( options, variant, DefaultTolerance< Precision >::Get( ) );
+
+		CheckNoise< Precision >( run );
+		CheckFractal< Precision, SseSimpleFractal, ScalarSimpleFractal >( run, "simple fractal", "simple fractal (signed)", "simple fractal (clamped)" );
+		CheckFractal< Precision, SseRidgedFractal, ScalarRidgedFractal >( run, "ridged fractal", "ridged fractal (signed)", "ridged fractal (clamped)" );
+		CheckPlanetFractal< Precision >( run );
+		CheckFractalBounds< Precision, SseSimpleFractal >( run, "simple fractal bounds" );
+		CheckFractalBounds< Precision, SseRidgedFractal >( run, "ridged fractal bounds" );
+		CheckPlanetFractalBounds< Precision >( run );
+
+		CheckDisplacer< Precision, SphereGeometry, SphereFlatConfig >( run, "sphere flat displacer" );
+		CheckDisplacer< Precision, SphereGeometry, SphereSimpleConfig >( run, "sphere simple displacer" );
+		CheckDisplacer< Precision, SphereGeometry, SphereRidgedConfig >( run, "sphere ridged displacer" );
+		CheckDisplacer< Precision, SphereGeometry, SphereGroundConfig >( run, "sphere ground displacer" );
+		CheckDisplacer< Precision, PlaneGeometry, PlaneFlatConfig >( run, "plane flat displacer" );
+		CheckDisplacer< Precision, PlaneGeometry, PlaneSimpleConfig >( run, "plane simple displacer" );
+		CheckDisplacer< Precision, PlaneGeometry, PlaneRidgedConfig >( run, "plane ridged displacer" );
+		CheckDisplacer< Precision, PlaneGeometry, PlaneGroundConfig >( run, "plane ground displacer" );
+
+		CheckPatches< Precision, SphereGeometry, SphereFlatConfig >( run, "sphere flat patch", "sphere flat patch (error)" );
+		CheckPatches< Precision, SphereGeometry, SphereSimpleConfig >( run, "sphere simple patch", "sphere simple patch (error)" );
+		CheckPatches< Precision, SphereGeometry, SphereRidgedConfig >( run, "sphere ridged patch", "sphere ridged patch (error)" );
+		CheckPatches< Precision, SphereGeometry, SphereGroundConfig >( run, "sphere ground patch", "sphere ground patch (error)" );
+		CheckPatches< Precision, PlaneGeometry, PlaneFlatConfig >( run, "plane flat patch", "plane flat patch (error)" );
+		CheckPatches< Precision, PlaneGeometry, PlaneSimpleConfig >( run, "plane simple patch", "plane simple patch (error)" );
+		CheckPatches< Precision, PlaneGeometry, PlaneRidgedConfig >( run, "plane ridged patch", "plane ridged patch (error)" );
+		CheckPatches< Precision, PlaneGeometry, PlaneGroundConfig >( run, "plane ground patch", "plane ground patch (error)" );
+
+		CheckPatchBounds< Precision, SphereGeometry, SphereFlatConfig >( run, "sphere flat patch bounds" );
+		CheckPatchBounds< Precision, SphereGeometry, SphereSimpleConfig >( run, "sphere simple patch bounds" );
+		CheckPatchBounds< Precision, SphereGeometry, SphereRidgedConfig >( run, "sphere ridged patch bounds" );
+		CheckPatchBounds< Precision, SphereGeometry, SphereGroundConfig >( run, "sphere ground patch bounds" );
+		CheckPatchBounds< Precision, PlaneGeometry, PlaneFlatConfig >( run, "plane flat patch bounds" );
+		CheckPatchBounds< Precision, PlaneGeometry, PlaneSimpleConfig >( run, "plane simple patch bounds" );
+		CheckPatchBounds< Precision, PlaneGeometry, PlaneRidgedConfig >( run, "plane ridged patch bounds" );
+		CheckPatchBounds< Precision, PlaneGeometry, PlaneGroundConfig >( run, "plane ground patch bounds" );
+
+		CheckCubeMapFaces< Precision, SphereSimpleConfig >( run, "sphere simple cube map faces" );
+		CheckCubeMapFaces< Precision, SphereRidgedConfig >( run, "sphere ridged cube map faces" );
+		CheckCubeMapFaces< Precision, SphereGroundConfig >( run, "sphere ground cube map faces" );
+		CheckCubeMap< Precision, SphereSimpleConfig >( run, "sphere simple cube map", "sphere simple cube map seams" );
+		CheckCubeMap< Precision, SphereRidgedConfig >( run, "sphere ridged cube map", "sphere ridged cube map seams" );
+		CheckCubeMap< Precision, SphereGroundConfig >( run, "sphere ground cube map", "sphere ground cube map seams" );
+		CheckTerrainTypeFaces< Precision, SphereRidgedConfig >( run, "sphere ridged terrain type faces" );
+
+		CheckCompositeFunction< Precision >( run );
+		CheckDisplacer< Precision, SphereGeometry, SphereCompositeConfig >( run, "sphere composite displacer" );
+		CheckDisplacer< Precision, PlaneGeometry, PlaneCompositeConfig >( run, "plane composite displacer" );
+		CheckPatches< Precision, SphereGeometry, SphereCompositeConfig >( run, "sphere composite patch", "sphere composite patch (error)" );
+		CheckPatches< Precision, PlaneGeometry, PlaneCompositeConfig >( run, "plane composite patch", "plane composite patch (error)" );
+		CheckPatchBounds< Precision, SphereGeometry, SphereCompositeConfig >( run, "sphere composite patch bounds" );
+		CheckPatchBounds< Precision, PlaneGeometry, PlaneCompositeConfig >( run, "plane composite patch bounds" );
+
+		CheckPatches< Precision, SphereGeometry, SphereGroundFieldConfig >( run, "sphere ground field patch", "sphere ground field patch (error)" );
+		CheckPatches< Precision, SphereGeometry, SphereReducedGroundFieldConfig >( run, "sphere reduced ground field patch", "sphere reduced ground field patch (error)" );
+		CheckPatchBounds< Precision, SphereGeometry, SphereGroundFieldConfig >( run, "sphere ground field patch bounds" );
+		CheckPatchBounds< Precision, SphereGeometry, SphereReducedGroundFieldConfig >( run, "sphere reduced ground field patch bounds" );
+
+		return run.m_Failures;
+	}
+}
+
+int main( int argc, char** argv )
+{
+	Options options;
+	options.m_Seed = 1;
+	options.m_Iterations = 16;
+	options.m_Precision = "all";
+	options.m_Ulps = -1;
+	options.m_Absolute = -1;
+	options.m_Bytes = -1;
+
+	bool valid = true;
+	for ( int arg = 1; valid && ( arg < argc ); ++arg )
+	{
+		const bool hasValue = ( arg + 1 < argc );
+		if ( hasValue && ( strcmp( argv[ arg ], "--seed" ) == 0 ) )
+		{
+			options.m_Seed = ( unsigned int )strtoul( argv[ ++arg ], 0, 10 );
+		}
+		else if ( hasValue && ( strcmp( argv[ arg ], "--iterations" ) == 0 ) )
+		{
+			options.m_Iterations = atoi( argv[ ++arg ] );
+			options.m_Iterations = options.m_Iterations < 1 ? 1 : options.m_Iterations;
+		}
+		else if ( hasValue && ( strcmp( argv[ arg ], "--precision" ) == 0 ) )
+		{
+			options.m_Precision = argv[ ++arg ];
+		}
+		else if ( hasValue && ( strcmp( argv[ arg ], "--ulps" ) == 0 ) )
+		{
+			options.m_Ulps = atoi( argv[ ++arg ] );
+		}
+		else if ( hasValue && ( strcmp( argv[ arg ], "--abs" ) == 0 ) )
+		{
+			options.m_Absolute = float( atof( argv[ ++arg ] ) );
+		}
+		else if ( hasValue && ( strcmp( argv[ arg ], "--bytes" ) == 0 ) )
+		{
+			options.m_Bytes = atoi( argv[ ++arg ] );
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+
+	const bool all = ( strcmp( options.m_Precision, "all" ) == 0 );
+	const bool exact = all || ( strcmp( options.m_Precision, "exact" ) == 0 );
+	const bool fast = all || ( strcmp( options.m_Precision, "fast" ) == 0 );
+	const bool fastest = all || ( strcmp( options.m_Precision, "fastest" ) == 0 );
+	if ( !valid || !( exact || fast || fastest ) )
+	{
+		fprintf( stderr, "Usage: %s [--seed <n>] [--iterations <n>] [--precision exact|fast|fastest|all] [--ulps <n>] [--abs <x>] [--bytes <n>]\n", argv[ 0 ] );
+		return 2;
+	}
+
+	printf( "seed %u, %d iterations per check\n", options.m_Seed, options.m_Iterations );
+	Comparison::ReportHeadings( );
+
+	int failures = 0;
+	if ( exact )
+	{
+		failures += RunChecks< SseExactPrecision >( options, "exact" );
+
+		Run run( options, "exact", DefaultTolerance< SseExactPrecision >::Get( ) );
+		CheckTangentCubeFaceCoordinates( run );
+		CheckPeriodicNoise( run );
+		CheckMappedFileWindows( run );
+		CheckHeightmapFunction( run );
+		CheckCloudsAnimation( run );
+		CheckCloudsFormats( run );
+		CheckCloudsCubeMap( run );
+		CheckTerrainTypeByteOrder( run );
+		CheckMipChain( run );
+		CheckBlockCompression( run );
+		CheckTerrainTilePyramid( run );
+		CheckTerrainTileEdges( run );
+		CheckGroundFieldLevels( run );
+		failures += run.m_Failures;
+	}
+	if ( fast )
+	{
+		failures += RunChecks< SseFastPrecision >( options, "fast" );
+	}
+	if ( fastest )
+	{
+		failures += RunChecks< SseFastestPrecision >( options, "fastest" );
+	}
+
+	if ( failures > 0 )
+	{
+		printf( "%d check(s) FAILED\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "UTerrainGeneratorConfig.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			class UTerrainGenerator;
+		};
+
+		namespace Replay
+		{
+			///	\brief	Creates a terrain generator from a recorded configuration
+			///
+			///	Mirrors TerrainFunction::CreateGenerator(), and TerrainGenerator::Setup() and SetSmallestStepSize(),
+			///	without going through the managed function and parameter classes. Returns 0 if the configuration
+			///	contains a geometry, precision or function type that the factory doesn't know about. The returned
+			///	generator must be freed with AlignedDelete().
+			///
+			Terrain::UTerrainGenerator* CreateGenerator( const Terrain::UTerrainGeneratorConfig& config );
+
+		}; //Replay
+	}; //Fast
+}; //Poc1
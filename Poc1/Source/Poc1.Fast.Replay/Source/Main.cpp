@@ -0,0 +1,293 @@
+#include "ReplayFactory.h"
+#include "UTerrainRecorder.h"
+#include "UTerrainGenerator.h"
+#include "Instrumentation.h"
+#include "Mem.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+///	\file	Native replay tool for terrain recordings
+///
+///	Usage: Poc1.Fast.Replay <recording> [--threads <n>] [--repeat <n>]
+///
+///	Re-runs the GenerateVertices() calls captured by TerrainRecorder against generators rebuilt from the
+///	recorded configurations. Calls are handed out in recorded order to <n> threads (default 1), each of which
+///	has its own generators. The sequence is run once to warm up, then <n> times (default 3). Throughput is
+///	reported for the fastest run, and latency percentiles over all runs, alongside the latencies measured
+///	when the recording was made.
+///
+
+using namespace Poc1::Fast;
+using namespace Poc1::Fast::Terrain;
+
+namespace
+{
+	///	\brief	Per-thread replay state
+	class ReplayThread
+	{
+		public :
+
+			ReplayThread( const UTerrainRecording& recording, const std::vector< int >& configIndices, std::vector< long long >& latencies, volatile long& nextCall ) :
+				m_Recording( recording ),
+				m_ConfigIndices( configIndices ),
+				m_Latencies( latencies ),
+				m_NextCall( nextCall )
+			{
+				for ( size_t config = 0; config < recording.m_Configs.size( ); ++config )
+				{
+					m_Generators.push_back( Replay::CreateGenerator( recording.m_Configs[ config ] ) );
+				}
+
+				size_t maxVertices = 0;
+				for ( size_t call = 0; call < recording.m_Calls.size( ); ++call )
+				{
+					const size_t vertices = size_t( recording.m_Calls[ call ].m_Width ) * size_t( recording.m_Calls[ call ].m_Height );
+					maxVertices = ( vertices > maxVertices ) ? vertices : maxVertices;
+				}
+				m_Vertices.resize( maxVertices > 0 ? maxVertices : 1 );
+			}
+
+			~ReplayThread( )
+			{
+				for ( size_t generator = 0; generator < m_Generators.size( ); ++generator )
+				{
+					AlignedDelete( m_Generators[ generator ] );
+				}
+			}
+
+			///	\brief	Runs calls until there are none left
+			void Run( )
+			{
+				const long numCalls = long( m_Recording.m_Calls.size( ) );
+				for ( long call = FetchNextCall( ); call < numCalls; call = FetchNextCall( ) )
+				{
+					const UTerrainGenerationCall& recorded = m_Recording.m_Calls[ call ];
+					UTerrainGenerator* generator = m_Generators[ m_ConfigIndices[ call ] ];
+
+					//	The error generator modifies the step vectors
+					float xStep[ 3 ] = { recorded.m_XStep[ 0 ], recorded.m_XStep[ 1 ], recorded.m_XStep[ 2 ] };
+					float zStep[ 3 ] = { recorded.m_ZStep[ 0 ], recorded.m_ZStep[ 1 ], recorded.m_ZStep[ 2 ] };
+
+					const long long start = Instrumentation::GetTicks( );
+					if ( recorded.m_Flags & UTerrainGenerationCall::CallError )
+					{
+						float error;
+						generator->GenerateVertices( recorded.m_Origin, xStep, zStep, recorded.m_Width, recorded.m_Height, recorded.m_Uv, recorded.m_UvRes, &m_Vertices[ 0 ], error );
+					}
+					else
+					{
+						generator->GenerateVertices( recorded.m_Origin, xStep, zStep, recorded.m_Width, recorded.m_Height, recorded.m_Uv, recorded.m_UvRes, &m_Vertices[ 0 ] );
+					}
+					m_Latencies[ call ] = Instrumentation::GetTicks( ) - start;
+				}
+			}
+
+		private :
+
+			long FetchNextCall( )
+			{
+			#ifdef _WIN32
+				return InterlockedIncrement( &m_NextCall ) - 1;
+			#else
+				return __sync_fetch_and_add( &m_NextCall, 1 );
+			#endif
+			}
+
+			const UTerrainRecording&			m_Recording;
+			const std::vector< int >&			m_ConfigIndices;
+			std::vector< long long >&			m_Latencies;
+			volatile long&						m_NextCall;
+			std::vector< UTerrainGenerator* >	m_Generators;
+			std::vector< UTerrainVertex >		m_Vertices;
+	};
+
+#ifdef _WIN32
+	DWORD WINAPI ReplayThreadProc( void* thread )
+	{
+		( ( ReplayThread* )thread )->Run( );
+		return 0;
+	}
+#else
+	void* ReplayThreadProc( void* thread )
+	{
+		( ( ReplayThread* )thread )->Run( );
+		return 0;
+	}
+#endif
+
+	///	\brief	Runs all calls once, over all threads. The calling thread runs the first thread. Returns the elapsed time in ticks
+	long long RunCalls( std::vector< ReplayThread* >& threads, volatile long& nextCall )
+	{
+		nextCall = 0;
+		const long long start = Instrumentation::GetTicks( );
+
+	#ifdef _WIN32
+		std::vector< HANDLE > handles;
+		for ( size_t thread = 1; thread < threads.size( ); ++thread )
+		{
+			handles.push_back( CreateThread( 0, 0, ReplayThreadProc, threads[ thread ], 0, 0 ) );
+		}
+		threads[ 0 ]->Run( );
+		for ( size_t handle = 0; handle < handles.size( ); ++handle )
+		{
+			WaitForSingleObject( handles[ handle ], INFINITE );
+			CloseHandle( handles[ handle ] );
+		}
+	#else
+		std::vector< pthread_t > handles( threads.size( ) );
+		for ( size_t thread = 1; thread < threads.size( ); ++thread )
+		{
+			pthread_create( &handles[ thread ], 0, ReplayThreadProc, threads[ thread ] );
+		}
+		threads[ 0 ]->Run( );
+		for ( size_t thread = 1; thread < threads.size( ); ++thread )
+		{
+			pthread_join( handles[ thread ], 0 );
+		}
+	#endif
+
+		return Instrumentation::GetTicks( ) - start;
+	}
+
+	///	\brief	Prints the p50, p90, p99 and maximum of a set of latencies, in microseconds
+	void PrintPercentiles( const char* name, std::vector< long long >& latencies, const long long ticksPerSecond )
+	{
+		if ( latencies.empty( ) || ( ticksPerSecond <= 0 ) )
+		{
+			return;
+		}
+		std::sort( latencies.begin( ), latencies.end( ) );
+		const double microsecondsPerTick = 1000000.0 / double( ticksPerSecond );
+		const size_t last = latencies.size( ) - 1;
+		printf
+		(
+			"%-10s p50 %10.1fus  p90 %10.1fus  p99 %10.1fus  max %10.1fus\n",
+			name,
+			double( latencies[ ( last * 50 ) / 100 ] ) * microsecondsPerTick,
+			double( latencies[ ( last * 90 ) / 100 ] ) * microsecondsPerTick,
+			double( latencies[ ( last * 99 ) / 100 ] ) * microsecondsPerTick,
+			double( latencies[ last ] ) * microsecondsPerTick
+		);
+	}
+}
+
+int main( int argc, char** argv )
+{
+	const char* path = 0;
+	int numThreads = 1;
+	int repeat = 3;
+	for ( int arg = 1; arg < argc; ++arg )
+	{
+		if ( ( strcmp( argv[ arg ], "--threads" ) == 0 ) && ( arg + 1 < argc ) )
+		{
+			numThreads = atoi( argv[ ++arg ] );
+			numThreads = numThreads < 1 ? 1 : numThreads;
+		}
+		else if ( ( strcmp( argv[ arg ], "--repeat" ) == 0 ) && ( arg + 1 < argc ) )
+		{
+			repeat = atoi( argv[ ++arg ] );
+			repeat = repeat < 1 ? 1 : repeat;
+		}
+		else if ( ( path == 0 ) && ( argv[ arg ][ 0 ] != '-' ) )
+		{
+			path = argv[ arg ];
+		}
+		else
+		{
+			path = 0;
+			break;
+		}
+	}
+	if ( path == 0 )
+	{
+		fprintf( stderr, "Usage: %s <recording> [--threads <n>] [--repeat <n>]\n", argv[ 0 ] );
+		return 1;
+	}
+
+	UTerrainRecording recording;
+	if ( !recording.Load( path ) )
+	{
+		fprintf( stderr, "Failed to load terrain recording \"%s\"\n", path );
+		return 1;
+	}
+
+	//	Resolve the configuration of each call, and check that every configuration can be rebuilt
+	std::vector< int > configIndices( recording.m_Calls.size( ) );
+	long long numVertices = 0;
+	for ( size_t call = 0; call < recording.m_Calls.size( ); ++call )
+	{
+		const UTerrainGeneratorConfig* config = recording.FindConfig( recording.m_Calls[ call ].m_ConfigHash );
+		if ( config == 0 )
+		{
+			fprintf( stderr, "Call %u refers to a missing generator configuration\n", ( unsigned int )call );
+			return 1;
+		}
+		configIndices[ call ] = int( config - &recording.m_Configs[ 0 ] );
+		numVertices += ( long long )recording.m_Calls[ call ].m_Width * recording.m_Calls[ call ].m_Height;
+	}
+	for ( size_t config = 0; config < recording.m_Configs.size( ); ++config )
+	{
+		UTerrainGenerator* generator = Replay::CreateGenerator( recording.m_Configs[ config ] );
+		if ( generator == 0 )
+		{
+			fprintf( stderr, "Generator configuration %u is not supported by this build\n", ( unsigned int )config );
+			return 1;
+		}
+		AlignedDelete( generator );
+	}
+	if ( recording.m_Calls.empty( ) )
+	{
+		printf( "Recording contains no calls\n" );
+		return 0;
+	}
+
+	printf( "%u calls, %u configurations, %lld vertices, %d thread(s)\n", ( unsigned int )recording.m_Calls.size( ), ( unsigned int )recording.m_Configs.size( ), numVertices, numThreads );
+
+	volatile long nextCall = 0;
+	std::vector< long long > latencies( recording.m_Calls.size( ) );
+	std::vector< ReplayThread* > threads;
+	for ( int thread = 0; thread < numThreads; ++thread )
+	{
+		threads.push_back( new ReplayThread( recording, configIndices, latencies, nextCall ) );
+	}
+
+	RunCalls( threads, nextCall );
+
+	long long bestTicks = 0;
+	std::vector< long long > allLatencies;
+	for ( int run = 0; run < repeat; ++run )
+	{
+		const long long ticks = RunCalls( threads, nextCall );
+		bestTicks = ( ( run == 0 ) || ( ticks < bestTicks ) ) ? ticks : bestTicks;
+		allLatencies.insert( allLatencies.end( ), latencies.begin( ), latencies.end( ) );
+	}
+
+	const long long ticksPerSecond = Instrumentation::GetTicksPerSecond( );
+	const double seconds = double( bestTicks ) / double( ticksPerSecond );
+	printf( "best run %.3fms: %.1f patches/s, %.2f Mvertices/s\n", seconds * 1000.0, double( recording.m_Calls.size( ) ) / seconds, ( double( numVertices ) / seconds ) * 1e-6 );
+
+	PrintPercentiles( "replayed", allLatencies, ticksPerSecond );
+
+	std::vector< long long > recordedLatencies( recording.m_Calls.size( ) );
+	for ( size_t call = 0; call < recording.m_Calls.size( ); ++call )
+	{
+		recordedLatencies[ call ] = recording.m_Calls[ call ].m_DurationTicks;
+	}
+	PrintPercentiles( "recorded", recordedLatencies, recording.m_TicksPerSecond );
+
+	for ( size_t thread = 0; thread < threads.size( ); ++thread )
+	{
+		delete threads[ thread ];
+	}
+	return 0;
+}
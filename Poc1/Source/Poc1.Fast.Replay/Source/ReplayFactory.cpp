@@ -0,0 +1,230 @@
+#include "ReplayFactory.h"
+#include "Mem.h"
+#include "Sse/SseSimpleFractal.h"
+#include "Sse/SseRidgedFractal.h"
+#include "Sse/SseSphereTerrainGenerator.h"
+#include "Sse/SsePlaneTerrainGenerator.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Replay
+		{
+			using namespace Terrain;
+
+			//	---------------------------------------------------------------------------------------------
+
+			template < UTerrainGeometry >
+			struct GeometryTypes
+			{
+			};
+
+			template < >
+			struct GeometryTypes< GeometrySphere >
+			{
+				typedef SseFlatSphereTerrainDisplacer FlatDisplacer;
+
+				template < typename FunctionClass >
+				struct HeightDisplacer
+				{
+					typedef SseSphereFunction3dDisplacer< FunctionClass > Type;
+				};
+
+				template < typename FunctionClass, typename BaseDisplacer >
+				struct GroundDisplacer
+				{
+					typedef SseSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionClass > Type;
+				};
+
+				template < typename Displacer, typename Precision >
+				struct TerrainGenerator
+				{
+					typedef SseSphereTerrainGeneratorT< Displacer, Precision > Type;
+				};
+
+				///	\brief	Equivalent of TerrainFunction.cpp GeometryTypes< TerrainGeometry::Sphere >::SetupGroundField()
+				template < typename Displacer >
+				static void SetupGroundField( Displacer& displacer, const float finestWavelength )
+				{
+					displacer.SetGroundField( true, finestWavelength * 0.25f );
+				}
+			};
+
+			template < >
+			struct GeometryTypes< GeometryPlane >
+			{
+				typedef SseFlatPlaneTerrainDisplacer FlatDisplacer;
+
+				template < typename FunctionClass >
+				struct HeightDisplacer
+				{
+					typedef SsePlaneFunction3dDisplacer< FunctionClass > Type;
+				};
+
+				template < typename FunctionClass, typename BaseDisplacer >
+				struct GroundDisplacer
+				{
+					typedef SsePlaneFunction3dGroundDisplacer< BaseDisplacer, FunctionClass > Type;
+				};
+
+				template < typename Displacer, typename Precision >
+				struct TerrainGenerator
+				{
+					typedef SsePlaneTerrainGeneratorT< Displacer, Precision > Type;
+				};
+
+				///	\brief	Plane ground displacers have no ground field
+				template < typename Displacer >
+				static void SetupGroundField( Displacer&, const float )
+				{
+				}
+			};
+
+			template < UTerrainFunctionType FunctionType >
+			struct FunctionTypes
+			{
+			};
+
+			template < >
+			struct FunctionTypes< FunctionSimpleFractal >
+			{
+				typedef SseSimpleFractal ClassType;
+			};
+
+			template < >
+			struct FunctionTypes< FunctionRidgedFractal >
+			{
+				typedef SseRidgedFractal ClassType;
+			};
+
+			//	---------------------------------------------------------------------------------------------
+
+			///	\brief	Equivalent of TerrainFunctionParameters::Setup()
+			void SetupDisplacer( SseTerrainDisplacer& displacer, const UTerrainFunctionConfig& config )
+			{
+				displacer.SetFunctionScale( config.m_FunctionScale );
+				displacer.SetOutputScale( config.m_OutputScale );
+			}
+
+			///	\brief	Equivalent of FractalTerrainParameters::Setup()
+			template < typename FractalType >
+			void SetupFractal( FractalType& fractal, const UTerrainFunctionConfig& config )
+			{
+				if ( config.m_Seed != -1 )
+				{
+					fractal.GetNoise( ).SetNewSeed( config.m_Seed );
+				}
+				fractal.Setup( config.m_Frequency, config.m_Lacunarity, config.m_Octaves );
+			}
+
+			template < UTerrainGeometry Geometry, typename Precision >
+			struct GeneratorFactory : public GeometryTypes< Geometry >
+			{
+				typedef GeometryTypes< Geometry > Types;
+
+				static UTerrainGenerator* Create( )
+				{
+					return new ( Aligned( 16 ) ) typename Types::template TerrainGenerator< typename Types::FlatDisplacer, Precision >::Type( );
+				}
+
+				template < UTerrainFunctionType HeightFunctionType >
+				static UTerrainGenerator* Create( const UTerrainGeneratorConfig& config )
+				{
+					typedef typename FunctionTypes< HeightFunctionType >::ClassType HClass;
+					typedef typename Types::template HeightDisplacer< HClass >::Type HeightDisplacerType;
+					typedef typename Types::template TerrainGenerator< HeightDisplacerType, Precision >::Type GeneratorType;
+
+					GeneratorType* generator = new ( Aligned( 16 ) ) GeneratorType( );
+
+					SetupDisplacer( generator->GetDisplacer( ), config.m_Height );
+					SetupFractal( generator->GetDisplacer( ).GetFunction( ), config.m_Height );
+
+					return generator;
+				}
+
+				template < UTerrainFunctionType HeightFunctionType, UTerrainFunctionType GroundFunctionType >
+				static UTerrainGenerator* Create( const UTerrainGeneratorConfig& config )
+				{
+					typedef typename FunctionTypes< HeightFunctionType >::ClassType HClass;
+					typedef typename FunctionTypes< GroundFunctionType >::ClassType GClass;
+					typedef typename Types::template HeightDisplacer< HClass >::Type HeightDisplacerType;
+					typedef typename Types::template GroundDisplacer< GClass, HeightDisplacerType >::Type GroundDisplacerType;
+					typedef typename Types::template TerrainGenerator< GroundDisplacerType, Precision >::Type GeneratorType;
+
+					GeneratorType* generator = new ( Aligned( 16 ) ) GeneratorType( );
+
+					SetupDisplacer( generator->GetDisplacer( ).GetBaseDisplacer( ), config.m_Height );
+					SetupDisplacer( generator->GetDisplacer( ), config.m_Ground );
+
+					SetupFractal( generator->GetDisplacer( ).GetBaseDisplacer( ).GetFunction( ), config.m_Height );
+					SetupFractal( generator->GetDisplacer( ).GetFunction( ), config.m_Ground );
+					Types::SetupGroundField( generator->GetDisplacer( ), generator->GetDisplacer( ).GetFunction( ).GetFinestWavelength( ) );
+
+					return generator;
+				}
+
+				template < UTerrainFunctionType HeightFunctionType >
+				static UTerrainGenerator* CreateWithGround( const UTerrainGeneratorConfig& config )
+				{
+					switch ( config.m_Ground.m_FunctionType )
+					{
+						case FunctionFlat			: return Create< HeightFunctionType >( config );
+						case FunctionSimpleFractal	: return Create< HeightFunctionType, FunctionSimpleFractal >( config );
+						case FunctionRidgedFractal	: return Create< HeightFunctionType, FunctionRidgedFractal >( config );
+					}
+					return 0;
+				}
+
+				static UTerrainGenerator* Create( const UTerrainGeneratorConfig& config )
+				{
+					switch ( config.m_Height.m_FunctionType )
+					{
+						case FunctionFlat			: return Create( );
+						case FunctionSimpleFractal	: return CreateWithGround< FunctionSimpleFractal >( config );
+						case FunctionRidgedFractal	: return CreateWithGround< FunctionRidgedFractal >( config );
+					}
+
+					//	Heightmap functions sample a file that isn't recorded in the configuration, so they can't be replayed
+					return 0;
+				}
+			};
+
+			template < typename Precision >
+			UTerrainGenerator* CreateGenerator( const UTerrainGeneratorConfig& config )
+			{
+				switch ( config.m_Geometry )
+				{
+					case GeometrySphere	: return GeneratorFactory< GeometrySphere, Precision >::Create( config );
+					case GeometryPlane	: return GeneratorFactory< GeometryPlane, Precision >::Create( config );
+				}
+				return 0;
+			}
+
+			//	---------------------------------------------------------------------------------------------
+
+			UTerrainGenerator* CreateGenerator( const UTerrainGeneratorConfig& config )
+			{
+				UTerrainGenerator* generator = 0;
+				switch ( config.m_Precision )
+				{
+					case PrecisionExact		: generator = CreateGenerator< SseExactPrecision >( config );	break;
+					case PrecisionFast		: generator = CreateGenerator< SseFastPrecision >( config );		break;
+					case PrecisionFastest	: generator = CreateGenerator< SseFastestPrecision >( config );	break;
+				}
+				if ( generator == 0 )
+				{
+					return 0;
+				}
+
+				if ( config.m_IsSetup )
+				{
+					generator->GetBaseDisplacer( ).Setup( config.m_PatchScale, config.m_MinHeight, config.m_MaxHeight );
+				}
+				generator->SetSmallestStepSize( config.m_SmallestX, config.m_SmallestZ );
+				return generator;
+			}
+
+		}; //Replay
+	}; //Fast
+}; //Poc1
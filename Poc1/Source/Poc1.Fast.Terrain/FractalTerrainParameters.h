@@ -30,6 +30,9 @@ namespace Poc1
 					///	\brief	Sets up a ridged fractal from these parameters
 					void Setup( SseRidgedFractal& fractal );
 
+					///	\brief	Copies these parameters into a function configuration
+					virtual void GetConfig( UTerrainFunctionConfig& config ) override;
+
 					///	\brief	Gets/sets the seed value used to initialize the noise basis function of the fractal
 					property int Seed
 					{
@@ -0,0 +1,63 @@
+#pragma once
+#include "FractalTerrainParameters.h"
+
+#pragma managed( push, on )
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		#pragma managed( off )
+
+		class SseHeightmapFunction;
+
+		#pragma managed( on )
+
+
+		namespace Terrain
+		{
+			///	\brief	Parameters of heightmap terrain functions. The fractal parameters set up the detail fractal
+			public ref class HeightmapTerrainParameters : public FractalTerrainParameters
+			{
+				public :
+
+					///	\brief	Sets up parameters with no heightmap file, a bilinear filter, and no detail
+					HeightmapTerrainParameters( );
+
+					///	\brief	Sets up a heightmap function from these parameters. Throws an IOException if the heightmap file can't be opened
+					void Setup( SseHeightmapFunction& function );
+
+					///	\brief	Gets/sets the path of the heightmap file (see UHeightmapFile)
+					property System::String^ Path
+					{
+						System::String^ get( ) { return m_Path; }
+						void set( System::String^ value ) { m_Path = value; }
+					}
+
+					///	\brief	Gets/sets the heightmap filter. If true, heights are filtered bicubically, otherwise bilinearly. Default is false
+					property bool Bicubic
+					{
+						bool get( ) { return m_Bicubic; }
+						void set( bool value ) { m_Bicubic = value; }
+					}
+
+					///	\brief	Gets/sets the amount of fractal detail added to normalized heights. Default is 0 (no detail)
+					property float DetailAmplitude
+					{
+						float get( ) { return m_DetailAmplitude; }
+						void set( float value ) { m_DetailAmplitude = value; }
+					}
+
+				private :
+
+					System::String^	m_Path;
+					bool			m_Bicubic;
+					float			m_DetailAmplitude;
+
+			}; //HeightmapTerrainParameters
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed( pop )
@@ -0,0 +1,169 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UBlockCompressor.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar reference for UBlockCompressor. Compresses a whole face, a block and a texel at a time
+			class ScalarBlockCompressor
+			{
+				public :
+
+					///	\brief	Compresses a face
+					static void Compress( const UBlockCompressor::Format format, const UPixelChannels& channels, const int width, const int height, const unsigned char* pixels, const int stride, unsigned char* blocks, const int blockRowStride );
+
+				private :
+
+					///	\brief	Gets a channel of the 16 texels of the block at a given pixel, in texel order
+					static void GetBlockChannel( const UPixelChannels& channels, const UPixelChannels::Channel channel, const unsigned char fill, const int width, const int height, const unsigned char* pixels, const int stride, const int x, const int y, int* values );
+
+					///	\brief	Encodes 16 values as a BC4 block
+					static void EncodeBc4Block( const int* values, unsigned char* block );
+
+					///	\brief	Encodes 16 colours as a BC1 colour block
+					static void EncodeColourBlock( const int* reds, const int* greens, const int* blues, unsigned char* block );
+			};
+
+			//	--------------------------------------------- ScalarBlockCompressor Inline Methods
+
+			inline void ScalarBlockCompressor::Compress( const UBlockCompressor::Format format, const UPixelChannels& channels, const int width, const int height, const unsigned char* pixels, const int stride, unsigned char* blocks, const int blockRowStride )
+			{
+				const int blockSize = UBlockCompressor::GetBlockSize( format );
+				const UPixelChannels::Channel bc4Channel = channels.GetOffset( UPixelChannels::Red ) >= 0 ? UPixelChannels::Red : UPixelChannels::Alpha;
+				for ( int y = 0; y < height; y += 4 )
+				{
+					for ( int x = 0; x < width; x += 4 )
+					{
+						unsigned char* block = blocks + ( y / 4 ) * blockRowStride + ( x / 4 ) * blockSize;
+						int first[ 16 ], second[ 16 ], third[ 16 ], fourth[ 16 ];
+						switch ( format )
+						{
+							case UBlockCompressor::Bc4 :
+								GetBlockChannel( channels, bc4Channel, 0, width, height, pixels, stride, x, y, first );
+								EncodeBc4Block( first, block );
+								break;
+
+							case UBlockCompressor::Bc5 :
+								GetBlockChannel( channels, UPixelChannels::Red, 0, width, height, pixels, stride, x, y, first );
+								GetBlockChannel( channels, UPixelChannels::Green, 0, width, height, pixels, stride, x, y, second );
+								EncodeBc4Block( first, block );
+								EncodeBc4Block( second, block + 8 );
+								break;
+
+							case UBlockCompressor::Bc3 :
+								GetBlockChannel( channels, UPixelChannels::Red, 0, width, height, pixels, stride, x, y, first );
+								GetBlockChannel( channels, UPixelChannels::Green, 0, width, height, pixels, stride, x, y, second );
+								GetBlockChannel( channels, UPixelChannels::Blue, 0, width, height, pixels, stride, x, y, third );
+								GetBlockChannel( channels, UPixelChannels::Alpha, 0xff, width, height, pixels, stride, x, y, fourth );
+								EncodeBc4Block( fourth, block );
+								EncodeColourBlock( first, second, third, block + 8 );
+								break;
+						};
+					}
+				}
+			}
+
+			inline void ScalarBlockCompressor::GetBlockChannel( const UPixelChannels& channels, const UPixelChannels::Channel channel, const unsigned char fill, const int width, const int height, const unsigned char* pixels, const int stride, const int x, const int y, int* values )
+			{
+				const int offset = channels.GetOffset( channel );
+				for ( int texel = 0; texel < 16; ++texel )
+				{
+					//	Texels past the edges of the face repeat the last column or row
+					int col = x + ( texel % 4 );
+					int row = y + ( texel / 4 );
+					col = col < width ? col : width - 1;
+					row = row < height ? row : height - 1;
+					values[ texel ] = offset < 0 ? fill : pixels[ row * stride + col * channels.GetBytesPerPixel( ) + offset ];
+				}
+			}
+
+			inline void ScalarBlockCompressor::EncodeBc4Block( const int* values, unsigned char* block )
+			{
+				int minValue = values[ 0 ];
+				int maxValue = values[ 0 ];
+				for ( int texel = 1; texel < 16; ++texel )
+				{
+					minValue = values[ texel ] < minValue ? values[ texel ] : minValue;
+					maxValue = values[ texel ] > maxValue ? values[ texel ] : maxValue;
+				}
+
+				//	Palette entries by position between the minimum (0) and the maximum (7)
+				static const int PositionIndices[ 8 ] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+				const int range = maxValue - minValue;
+				unsigned long long indices = 0;
+				for ( int texel = 0; texel < 16; ++texel )
+				{
+					const int position = range == 0 ? 7 : ( ( values[ texel ] - minValue ) * 14 + range ) / ( range * 2 );
+					indices |= ( unsigned long long )PositionIndices[ position ] << ( texel * 3 );
+				}
+
+				block[ 0 ] = ( unsigned char )maxValue;
+				block[ 1 ] = ( unsigned char )minValue;
+				for ( int byte = 0; byte < 6; ++byte )
+				{
+					block[ 2 + byte ] = ( unsigned char )( indices >> ( byte * 8 ) );
+				}
+			}
+
+			inline void ScalarBlockCompressor::EncodeColourBlock( const int* reds, const int* greens, const int* blues, unsigned char* block )
+			{
+				const int* texels[ 3 ] = { reds, greens, blues };
+				int minColour[ 3 ], maxColour[ 3 ], colour565[ 2 ] = { 0, 0 };
+				const int bits[ 3 ] = { 31, 63, 31 };
+				const int shifts[ 3 ] = { 11, 5, 0 };
+				for ( int channel = 0; channel < 3; ++channel )
+				{
+					minColour[ channel ] = maxColour[ channel ] = texels[ channel ][ 0 ];
+					for ( int texel = 1; texel < 16; ++texel )
+					{
+						minColour[ channel ] = texels[ channel ][ texel ] < minColour[ channel ] ? texels[ channel ][ texel ] : minColour[ channel ];
+						maxColour[ channel ] = texels[ channel ][ texel ] > maxColour[ channel ] ? texels[ channel ][ texel ] : maxColour[ channel ];
+					}
+					colour565[ 0 ] |= ( ( maxColour[ channel ] * bits[ channel ] + 127 ) / 255 ) << shifts[ channel ];
+					colour565[ 1 ] |= ( ( minColour[ channel ] * bits[ channel ] + 127 ) / 255 ) << shifts[ channel ];
+				}
+
+				unsigned int indices = 0;
+				if ( colour565[ 0 ] != colour565[ 1 ] )
+				{
+					//	Palette entries by position between the minimum (0) and the maximum (3)
+					static const unsigned int PositionIndices[ 4 ] = { 1, 3, 2, 0 };
+					int sqrLength = 0;
+					for ( int channel = 0; channel < 3; ++channel )
+					{
+						sqrLength += ( maxColour[ channel ] - minColour[ channel ] ) * ( maxColour[ channel ] - minColour[ channel ] );
+					}
+					for ( int texel = 0; texel < 16; ++texel )
+					{
+						int distance = 0;
+						for ( int channel = 0; channel < 3; ++channel )
+						{
+							distance += ( texels[ channel ][ texel ] - minColour[ channel ] ) * ( maxColour[ channel ] - minColour[ channel ] );
+						}
+						indices |= PositionIndices[ ( distance * 6 + sqrLength ) / ( sqrLength * 2 ) ] << ( texel * 2 );
+					}
+				}
+
+				for ( int endpoint = 0; endpoint < 2; ++endpoint )
+				{
+					block[ endpoint * 2 ] = ( unsigned char )colour565[ endpoint ];
+					block[ endpoint * 2 + 1 ] = ( unsigned char )( colour565[ endpoint ] >> 8 );
+				}
+				for ( int byte = 0; byte < 4; ++byte )
+				{
+					block[ 4 + byte ] = ( unsigned char )( indices >> ( byte * 8 ) );
+				}
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,78 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UMipChain.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar reference for UMipChain. Builds each level from the whole of the level above it, one pixel at a time
+			class ScalarMipChain
+			{
+				public :
+
+					///	\brief	Builds a mip level from the level above it
+					///
+					///	dst is srcWidth/2 x srcHeight/2 pixels, with sizes of 1 staying at 1.
+					///
+					static void Downsample( const int bytesPerPixel, const UMipChain::Filter filter, const unsigned char* src, const int srcWidth, const int srcHeight, const int srcStride, unsigned char* dst, const int dstStride );
+
+					///	\brief	Builds all the levels of a chain from a base level
+					static void Build( const UPixelFormat format, const UMipChain::Filter filter, const unsigned char* base, const int width, const int height, const int stride, const UMipChain& chain );
+			};
+
+			//	---------------------------------------------------- ScalarMipChain Inline Methods
+
+			inline void ScalarMipChain::Downsample( const int bytesPerPixel, const UMipChain::Filter filter, const unsigned char* src, const int srcWidth, const int srcHeight, const int srcStride, unsigned char* dst, const int dstStride )
+			{
+				const int dstWidth = srcWidth > 1 ? srcWidth / 2 : 1;
+				const int dstHeight = srcHeight > 1 ? srcHeight / 2 : 1;
+				for ( int row = 0; row < dstHeight; ++row )
+				{
+					const int srcRow0 = srcHeight > 1 ? row * 2 : 0;
+					const int srcRow1 = srcHeight > 1 ? row * 2 + 1 : 0;
+					for ( int col = 0; col < dstWidth; ++col )
+					{
+						const int srcCol0 = srcWidth > 1 ? col * 2 : 0;
+						const int srcCol1 = srcWidth > 1 ? col * 2 + 1 : 0;
+						for ( int channel = 0; channel < bytesPerPixel; ++channel )
+						{
+							const int topLeft = src[ srcRow0 * srcStride + srcCol0 * bytesPerPixel + channel ];
+							int value = topLeft;
+							if ( filter == UMipChain::BoxFilter )
+							{
+								const int topRight = src[ srcRow0 * srcStride + srcCol1 * bytesPerPixel + channel ];
+								const int bottomLeft = src[ srcRow1 * srcStride + srcCol0 * bytesPerPixel + channel ];
+								const int bottomRight = src[ srcRow1 * srcStride + srcCol1 * bytesPerPixel + channel ];
+								value = ( topLeft + topRight + bottomLeft + bottomRight + 2 ) / 4;
+							}
+							dst[ row * dstStride + col * bytesPerPixel + channel ] = ( unsigned char )value;
+						}
+					}
+				}
+			}
+
+			inline void ScalarMipChain::Build( const UPixelFormat format, const UMipChain::Filter filter, const unsigned char* base, const int width, const int height, const int stride, const UMipChain& chain )
+			{
+				const unsigned char* src = base;
+				int srcStride = stride;
+				for ( int level = 0; level < chain.GetLevels( ); ++level )
+				{
+					const int srcWidth = level == 0 ? width : UMipChain::GetLevelSize( width, level - 1 );
+					const int srcHeight = level == 0 ? height : UMipChain::GetLevelSize( height, level - 1 );
+					Downsample( GetBytesPerPixel( format ), filter, src, srcWidth, srcHeight, srcStride, chain.GetPixels( level ), chain.GetStride( level ) );
+					src = chain.GetPixels( level );
+					srcStride = chain.GetStride( level );
+				}
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,162 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <Scalar/ScalarSimpleFractal.h>
+#include <Scalar/ScalarRidgedFractal.h>
+
+#include "ScalarTerrainDisplacer.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			//	----------------------------------------------------------------------------- Types
+
+			///	\brief	Scalar reference implementation of SsePlaneTerrainDisplacer
+			class ScalarPlaneTerrainDisplacer : public ScalarTerrainDisplacer
+			{
+				public :
+
+					inline void GetUpVector( float& x, float& y, float& z ) const
+					{
+						x = 0;
+						y = 1;
+						z = 0;
+					}
+
+					inline void MapToDisplacementSpace( float& x, float& y, float& z ) const
+					{
+					}
+			};
+
+			///	\brief	Scalar reference implementation of SseFlatPlaneTerrainDisplacer
+			class ScalarFlatPlaneTerrainDisplacer : public ScalarPlaneTerrainDisplacer
+			{
+				public :
+
+					///	\brief	Maps an (x,y,z) vector onto the minimum distance of this displacer
+					inline float Displace( float& x, float& y, float& z ) const
+					{
+						y += m_MinHeight;
+						return 0;
+					}
+			};
+
+			///	\brief	Scalar reference implementation of SsePlaneFunction3dGroundDisplacer
+			template < typename BaseDisplacer, typename FunctionType >
+			class ScalarPlaneFunction3dGroundDisplacer : public ScalarPlaneTerrainDisplacer
+			{
+				public :
+
+					ScalarPlaneFunction3dGroundDisplacer( )
+					{
+						m_XOffset = 3.14f;
+						m_ZOffset = 6.28f;
+					}
+
+					///	\brief	Gets the function object used to generate ground displacement values
+					FunctionType& GetFunction( )
+					{
+						return m_Function;
+					}
+
+					///	\brief	Gets the function object used to generate ground displacement values
+					const FunctionType& GetFunction( ) const
+					{
+						return m_Function;
+					}
+
+					///	\brief	Gets the base displacer object
+					BaseDisplacer& GetBaseDisplacer( )
+					{
+						return m_Base;
+					}
+
+					///	\brief	Gets the base displacer object
+					const BaseDisplacer& GetBaseDisplacer( ) const
+					{
+						return m_Base;
+					}
+
+					///	\brief	Sets up this function object
+					virtual void Setup( float patchScale, float minHeight, float maxHeight )
+					{
+						ScalarTerrainDisplacer::Setup( patchScale, minHeight, maxHeight );
+
+						//	Same as SsePlaneFunction3dGroundDisplacer::Setup(), including the accumulation of
+						//	output scale and offsets over repeated calls
+						m_OutputScale = m_OutputScale * m_HeightRange;
+						m_XOffset = m_XOffset + m_Scale;
+						m_ZOffset = m_ZOffset + m_Scale;
+						m_Base.Setup( patchScale, minHeight, maxHeight );
+					}
+
+					///	\brief	Maps an (x,y,z) vector onto the minimum distance of this displacer
+					inline float Displace( float& x, float& y, float& z ) const
+					{
+						const float fX = x * m_PatchScaleToFunctionScale;
+						const float fY = y * m_PatchScaleToFunctionScale;
+						const float fZ = z * m_PatchScaleToFunctionScale;
+						const float dispX = m_Function.GetSignedValue( fX, fY, fZ ) * m_OutputScale;
+						const float dispZ = m_Function.GetSignedValue( fX + m_XOffset, fY, fZ + m_ZOffset ) * m_OutputScale;
+
+						const float magnitude = ScalarGetLength( dispX, 0, dispZ );
+
+						x += dispX;
+						y += magnitude;
+						z += dispZ;
+
+						return m_Base.Displace( x, y, z );
+					}
+
+				private :
+
+					float			m_XOffset;
+					float			m_ZOffset;
+					BaseDisplacer	m_Base;
+					FunctionType	m_Function;
+			};
+
+			///	\brief	Scalar reference implementation of SsePlaneFunction3dDisplacer
+			template < typename FunctionType >
+			class ScalarPlaneFunction3dDisplacer : public ScalarPlaneTerrainDisplacer
+			{
+				public :
+
+					///	\brief	Gets the function object
+					FunctionType& GetFunction( )
+					{
+						return m_Function;
+					}
+
+					///	\brief	Gets the function object
+					const FunctionType& GetFunction( ) const
+					{
+						return m_Function;
+					}
+
+					///	\brief	Maps an (x,y,z) vector onto the minimum distance of this displacer
+					inline float Displace( float& x, float& y, float& z ) const
+					{
+						const float fX = x * m_PatchScaleToFunctionScale + m_Scale;
+						const float fY = y * m_PatchScaleToFunctionScale + m_Scale;
+						const float fZ = z * m_PatchScaleToFunctionScale + m_Scale;
+						const float height = m_Function.GetValue( fX, fY, fZ );
+						y += MapToHeightRange( height ) * m_OutputScale;
+						return height;
+					}
+
+				private :
+
+					FunctionType m_Function;
+			};
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
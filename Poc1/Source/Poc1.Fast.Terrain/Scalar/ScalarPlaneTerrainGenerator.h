@@ -0,0 +1,245 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "ScalarTerrainGenerator.h"
+#include "ScalarPlaneTerrainDisplacers.h"
+
+#include <string.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar reference implementation of SsePlaneTerrainGeneratorT, at exact precision
+			template < typename DisplaceType >
+			class ScalarPlaneTerrainGeneratorT : public ScalarTerrainGenerator
+			{
+				public :
+
+					///	\brief	Gets the object used to displace vertices from the plane
+					DisplaceType& GetDisplacer( )
+					{
+						return m_Displacer;
+					}
+
+					///	\brief	Gets the object used to displace vertices from the plane
+					const DisplaceType& GetDisplacer( ) const
+					{
+						return m_Displacer;
+					}
+
+					///	\brief	Generates terrain vertex points and normals
+					void GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices );
+
+					///	\brief	Generates terrain vertex points and normals. Gets maximum patch error
+					void GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& maxError );
+
+				private :
+
+					DisplaceType m_Displacer;
+
+					///	\brief	Displaces a position. Returns the height
+					float GetHeight( const float* position ) const;
+
+					///	\brief	Generates a vertex from a position on the patch, for the error generator (SsePlaneTerrainGeneratorT::SetErrorVertices())
+					float SetErrorVertex( UTerrainVertex& vertex, const float* position, const float u, const float v ) const;
+
+					///	\brief	Gets the error heights at the start of an error row (SsePlaneTerrainGeneratorT::GetInitialErrorHeights())
+					void GetInitialErrorHeights( const float ( &positions )[ Lanes ][ 3 ], float& lastHeight, float& lastIntHeight ) const;
+
+					///	\brief	Gets the maximum error along an intermediate row (SsePlaneTerrainGeneratorT::GetRowMaxError())
+					void GetRowMaxError( float ( &positions )[ Lanes ][ 3 ], const float* increment, const int rowLength, float& maxError ) const;
+			};
+
+			//	------------------------------------------- ScalarPlaneTerrainGeneratorT Inline Methods
+
+			template < typename DisplaceType >
+			inline float ScalarPlaneTerrainGeneratorT< DisplaceType >::GetHeight( const float* position ) const
+			{
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				return m_Displacer.Displace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+			}
+
+			template < typename DisplaceType >
+			inline float ScalarPlaneTerrainGeneratorT< DisplaceType >::SetErrorVertex( UTerrainVertex& vertex, const float* position, const float u, const float v ) const
+			{
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				const float height = m_Displacer.Displace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+
+				//	Left, up, right and down neighbours
+				float neighbours[ 4 ][ 3 ] =
+				{
+					{ position[ 0 ] - m_ShiftRight[ 0 ], position[ 1 ] - m_ShiftRight[ 1 ], position[ 2 ] - m_ShiftRight[ 2 ] },
+					{ position[ 0 ] - m_ShiftDown[ 0 ], position[ 1 ] - m_ShiftDown[ 1 ], position[ 2 ] - m_ShiftDown[ 2 ] },
+					{ position[ 0 ] + m_ShiftRight[ 0 ], position[ 1 ] + m_ShiftRight[ 1 ], position[ 2 ] + m_ShiftRight[ 2 ] },
+					{ position[ 0 ] + m_ShiftDown[ 0 ], position[ 1 ] + m_ShiftDown[ 1 ], position[ 2 ] + m_ShiftDown[ 2 ] }
+				};
+				for ( int neighbour = 0; neighbour < 4; ++neighbour )
+				{
+					float* n = neighbours[ neighbour ];
+					m_Displacer.Displace( n[ 0 ], n[ 1 ], n[ 2 ] );
+				}
+
+				const float yAxis[ 3 ] = { 0, 1, 0 };
+				float normal[ 3 ];
+				const float slope = GetNormalAndSlope( origin, neighbours, yAxis, 0.4f, normal );
+				SetupVertex( vertex, origin, normal, slope, height, u, v );
+				return height;
+			}
+
+			template < typename DisplaceType >
+			inline void ScalarPlaneTerrainGeneratorT< DisplaceType >::GetInitialErrorHeights( const float ( &positions )[ Lanes ][ 3 ], float& lastHeight, float& lastIntHeight ) const
+			{
+				//	NOTE: SsePlaneTerrainGeneratorT projects these positions onto the function sphere, like the sphere generator
+				float heights[ Lanes ];
+				for ( int lane = 2; lane < Lanes; ++lane )
+				{
+					float origin[ 3 ] = { positions[ lane ][ 0 ], positions[ lane ][ 1 ], positions[ lane ][ 2 ] };
+					ScalarSetLength( origin[ 0 ], origin[ 1 ], origin[ 2 ], m_Displacer.GetFunctionScale( ) );
+					heights[ lane ] = m_Displacer.Displace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+				}
+				lastHeight = heights[ 2 ];
+				lastIntHeight = heights[ 3 ];
+			}
+
+			template < typename DisplaceType >
+			inline void ScalarPlaneTerrainGeneratorT< DisplaceType >::GetRowMaxError( float ( &positions )[ Lanes ][ 3 ], const float* increment, const int rowLength, float& maxError ) const
+			{
+				float lastHeight = 0;
+				float lastIntHeight = 0;
+				GetInitialErrorHeights( positions, lastHeight, lastIntHeight );
+
+				for ( int i = 0; i < rowLength; ++i )
+				{
+					float heights[ Lanes ];
+					for ( int lane = 0; lane < Lanes; ++lane )
+					{
+						heights[ lane ] = GetHeight( positions[ lane ] );
+					}
+					UpdateError( heights, lastHeight, lastIntHeight, maxError );
+					AddToLanes( positions, increment );
+				}
+			}
+
+			template < typename DisplaceType >
+			void ScalarPlaneTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices )
+			{
+				AssignShiftVectors( xStep, zStep );
+
+				float starts[ Lanes ][ 3 ];
+				SetLaneStarts( starts, origin, xStep );
+				const float colInc[ 3 ] = { xStep[ 0 ] * 4, xStep[ 1 ] * 4, xStep[ 2 ] * 4 };
+
+				const float uInc = uvRes / ( float )( width - 1 );
+				const float vInc = uvRes / ( float )( height - 1 );
+				const float uIncLanes = uInc * 4;
+				float v = uv[ 1 ];
+
+				for ( int row = 0; row < height; ++row, v += vInc )
+				{
+					float u[ Lanes ] = { uv[ 0 ], uv[ 0 ] + uInc, uv[ 0 ] + uInc * 2, uv[ 0 ] + uInc * 3 };
+					float positions[ Lanes ][ 3 ];
+					memcpy( positions, starts, sizeof( positions ) );
+
+					UTerrainVertex* rowVertices = vertices + row * width;
+					for ( int col = 0; col < width; col += Lanes )
+					{
+						for ( int lane = 0; ( lane < Lanes ) && ( ( col + lane ) < width ); ++lane )
+						{
+							DisplaceVertex( m_Displacer, rowVertices[ col + lane ], positions[ lane ], u[ lane ], v );
+							u[ lane ] += uIncLanes;
+						}
+						AddToLanes( positions, colInc );
+					}
+
+					AddToLanes( starts, zStep );
+				}
+			}
+
+			template < typename DisplaceType >
+			void ScalarPlaneTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& error )
+			{
+				AssignShiftVectors( xStep, zStep );
+
+				//	Same as GenerateVertices() without error, except that the resolution is doubled
+				xStep[ 0 ] /= 2; xStep[ 1 ] /= 2; xStep[ 2 ] /= 2;
+				zStep[ 0 ] /= 2; zStep[ 1 ] /= 2; zStep[ 2 ] /= 2;
+				const int outputWidth = width;
+				width = ( width * 2 ) - 1;
+				height = ( height * 2 ) - 1;
+
+				//	Lanes start one block to the left of the origin. The first block only supplies error heights
+				float starts[ Lanes ][ 3 ];
+				SetLaneStarts( starts, origin, xStep );
+				const float colInc[ 3 ] = { xStep[ 0 ] * 4, xStep[ 1 ] * 4, xStep[ 2 ] * 4 };
+				const float negColInc[ 3 ] = { -colInc[ 0 ], -colInc[ 1 ], -colInc[ 2 ] };
+				AddToLanes( starts, negColInc );
+
+				const float uInc = uvRes / ( float )( width - 1 );
+				const float vInc = uvRes / ( float )( height - 1 );
+				const float uIncLanes = uInc * 4;
+				float v = uv[ 1 ];
+
+				const int widthDiv4 = width / 4;
+				const int widthMod4 = width % 4;
+
+				error = 0;
+
+				float lastHeight = 0;
+				float lastIntHeight = 0;
+
+				for ( int row = 0; row < height; ++row, v += vInc )
+				{
+					float positions[ Lanes ][ 3 ];
+					memcpy( positions, starts, sizeof( positions ) );
+
+					if ( ( row % 2 ) != 0 )
+					{
+						GetRowMaxError( positions, colInc, widthDiv4, error );
+					}
+					else
+					{
+						float u[ Lanes ] = { uv[ 0 ], uv[ 0 ] + uInc, uv[ 0 ] + uInc * 2, uv[ 0 ] + uInc * 3 };
+
+						GetInitialErrorHeights( positions, lastHeight, lastIntHeight );
+						AddToLanes( positions, colInc );
+
+						//	Vertices come from the even lanes of every second row. Odd lanes are only used for the
+						//	error estimate. The last block may be partial
+						UTerrainVertex* rowVertices = vertices + ( row / 2 ) * outputWidth;
+						const int numBlocks = widthDiv4 + ( widthMod4 != 0 ? 1 : 0 );
+						for ( int block = 0; block < numBlocks; ++block )
+						{
+							float heights[ Lanes ];
+							for ( int lane = 0; lane < Lanes; ++lane )
+							{
+								const int vertex = ( block * Lanes + lane ) / 2;
+								if ( ( ( lane % 2 ) == 0 ) && ( vertex < outputWidth ) )
+								{
+									heights[ lane ] = SetErrorVertex( rowVertices[ vertex ], positions[ lane ], u[ lane ], v );
+								}
+								else
+								{
+									heights[ lane ] = GetHeight( positions[ lane ] );
+								}
+								u[ lane ] += uIncLanes;
+							}
+							UpdateError( heights, lastHeight, lastIntHeight, error );
+							AddToLanes( positions, colInc );
+						}
+					}
+
+					AddToLanes( starts, zStep );
+				}
+				error = m_Displacer.MapToHeightScale( error );
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,262 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <Scalar/ScalarSimpleFractal.h>
+#include <Scalar/ScalarRidgedFractal.h>
+
+#include "ScalarTerrainDisplacer.h"
+
+#include <math.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			//	----------------------------------------------------------------------------- Types
+
+			///	\brief	Scalar reference implementation of SseSphereTerrainDisplacer
+			class ScalarSphereTerrainDisplacer : public ScalarTerrainDisplacer
+			{
+				public :
+
+					inline void GetUpVector( float& x, float& y, float& z ) const
+					{
+						ScalarSetLength( x, y, z, 1 );
+					}
+
+					inline void MapToDisplacementSpace( float& x, float& y, float& z ) const
+					{
+						ScalarSetLength( x, y, z, GetFunctionScale( ) );
+					}
+
+				protected :
+
+					///	\brief	Returns true if the height ranges for this displacer should be divided through by the function scale
+					virtual bool PreMultiplyHeightRange( ) { return true; }
+			};
+
+			///	\brief	Scalar reference implementation of SseFlatSphereTerrainDisplacer
+			class ScalarFlatSphereTerrainDisplacer : public ScalarSphereTerrainDisplacer
+			{
+				public :
+
+					///	\brief	Maps an (x,y,z) vector onto the minimum distance of this displacer
+					inline float Displace( float& x, float& y, float& z ) const
+					{
+						if ( ( x > 0.0f ) && ( x < 0.1f ) )
+						{
+							x *= m_MaxHeight;
+							y *= m_MaxHeight;
+							z *= m_MaxHeight;
+							return 1;
+						}
+
+						x *= m_MinHeight;
+						y *= m_MinHeight;
+						z *= m_MinHeight;
+						return 0.1f;
+					}
+			};
+
+			///	\brief	Scalar reference implementation of SseSphereFunction3dGroundDisplacer
+			template < typename BaseDisplacer, typename FunctionType >
+			class ScalarSphereFunction3dGroundDisplacer : public ScalarSphereTerrainDisplacer
+			{
+				public :
+
+					///	\brief	Scalar equivalent of SseSphereFunction3dGroundDisplacer::OffsetDisplacer
+					class OffsetDisplacer
+					{
+						public :
+
+							OffsetDisplacer( const ScalarSphereFunction3dGroundDisplacer& displacer, const float* offsets ) :
+								m_Displacer( displacer ),
+								m_Offsets( offsets )
+							{
+							}
+
+							///	\brief	Maps an (x,y,z) vector onto the minimum distance of the displacer
+							float Displace( float& x, float& y, float& z ) const
+							{
+								return m_Displacer.DisplaceOffsets( x, y, z, m_Offsets );
+							}
+
+						private :
+
+							const ScalarSphereFunction3dGroundDisplacer&	m_Displacer;
+							const float*									m_Offsets;
+
+							OffsetDisplacer& operator = ( const OffsetDisplacer& );
+					};
+
+					ScalarSphereFunction3dGroundDisplacer( )
+					{
+						m_XOffset = 3.14f;
+						m_ZOffset = 6.28f;
+						m_Influence = 0.1f;
+						m_GroundField = false;
+						m_GroundFieldSpacing = 0;
+					}
+
+					///	\brief	Sets the influence of this displacer
+					void SetInfluence( const float influence )
+					{
+						m_Influence = influence;
+					}
+
+					///	\brief	Sets up the ground field (SseSphereFunction3dGroundDisplacer::SetGroundField())
+					void SetGroundField( const bool enabled, const float spacing = 0 )
+					{
+						m_GroundField = enabled;
+						m_GroundFieldSpacing = spacing;
+					}
+
+					///	\brief	Returns true if the ground field is used by ScalarSphereTerrainGeneratorT::GenerateVertices()
+					bool IsGroundFieldEnabled( ) const
+					{
+						return m_GroundField;
+					}
+
+					///	\brief	Same as SseSphereFunction3dGroundDisplacer::IsGroundFieldReduced()
+					bool IsGroundFieldReduced( const float* origin, const float* xStep, const float* zStep ) const
+					{
+						const float faceDistance = fabsf( origin[ 0 ] ) > fabsf( origin[ 1 ] ) ? fabsf( origin[ 0 ] ) : fabsf( origin[ 1 ] );
+						const float limit = m_GroundFieldSpacing * ( fabsf( origin[ 2 ] ) > faceDistance ? fabsf( origin[ 2 ] ) : faceDistance );
+						const float xLength = sqrtf( xStep[ 0 ] * xStep[ 0 ] + ( xStep[ 1 ] * xStep[ 1 ] + xStep[ 2 ] * xStep[ 2 ] ) ) * 2 * GetFunctionScale( );
+						const float zLength = sqrtf( zStep[ 0 ] * zStep[ 0 ] + ( zStep[ 1 ] * zStep[ 1 ] + zStep[ 2 ] * zStep[ 2 ] ) ) * 2 * GetFunctionScale( );
+						return ( xLength <= limit ) && ( zLength <= limit );
+					}
+
+					///	\brief	Gets the function object used to generate ground displacement values
+					FunctionType& GetFunction( )
+					{
+						return m_Function;
+					}
+
+					///	\brief	Gets the function object used to generate ground displacement values
+					const FunctionType& GetFunction( ) const
+					{
+						return m_Function;
+					}
+
+					///	\brief	Gets the base displacer object
+					BaseDisplacer& GetBaseDisplacer( )
+					{
+						return m_Base;
+					}
+
+					///	\brief	Gets the base displacer object
+					const BaseDisplacer& GetBaseDisplacer( ) const
+					{
+						return m_Base;
+					}
+
+					///	\brief	Sets up this function object
+					virtual void Setup( float patchScale, float minHeight, float maxHeight )
+					{
+						ScalarTerrainDisplacer::Setup( patchScale, minHeight, maxHeight );
+						m_Base.Setup( patchScale, minHeight, maxHeight );
+					}
+
+					///	\brief	Maps an (x,y,z) vector onto the minimum distance of this displacer
+					inline float Displace( float& x, float& y, float& z ) const
+					{
+						float offsets[ 3 ];
+						GetGroundOffsets( x, y, z, offsets );
+						return DisplaceOffsets( x, y, z, offsets );
+					}
+
+					///	\brief	Gets the ground offsets that Displace() adds to an (x,y,z) vector (SseSphereFunction3dGroundDisplacer::GetGroundOffsets())
+					inline void GetGroundOffsets( const float x, const float y, const float z, float* offsets ) const
+					{
+						float values[ 2 ];
+						GetGroundValues( x, y, z, values );
+						GetFrameOffsets( x, y, z, values, offsets );
+					}
+
+					///	\brief	Gets the 2 ground values of an (x,y,z) vector (SseSphereFunction3dGroundDisplacer::GetGroundValues())
+					inline void GetGroundValues( const float x, const float y, const float z, float* values ) const
+					{
+						values[ 0 ] = m_Function.GetSignedValue( x, y, z ) * m_Influence;
+						values[ 1 ] = m_Function.GetSignedValue( x + m_XOffset, y, z + m_ZOffset ) * m_Influence;
+					}
+
+					///	\brief	Turns the ground values of an (x,y,z) vector into offsets in its tangent frame (SseSphereFunction3dGroundDisplacer::GetFrameOffsets())
+					inline void GetFrameOffsets( const float x, const float y, const float z, const float* values, float* offsets ) const
+					{
+						const float dispX = values[ 0 ];
+						const float dispZ = values[ 1 ];
+						const float horizontal = x * x + z * z;
+						const float invHorizontal = 1 / sqrtf( horizontal );
+						const float xScale = dispX * invHorizontal;
+						const float upScale = dispZ / sqrtf( x * x + ( y * y + z * z ) );
+						const float zScale = upScale * invHorizontal;
+
+						offsets[ 0 ] = ( x * upScale - z * xScale ) + ( x * y ) * zScale;
+						offsets[ 1 ] = y * upScale - horizontal * zScale;
+						offsets[ 2 ] = ( x * xScale + z * upScale ) + ( y * z ) * zScale;
+					}
+
+					///	\brief	Moves an (x,y,z) vector by ground offsets, then maps it onto the minimum distance of the base displacer
+					inline float DisplaceOffsets( float& x, float& y, float& z, const float* offsets ) const
+					{
+						x = x + offsets[ 0 ];
+						y = y + offsets[ 1 ];
+						z = z + offsets[ 2 ];
+						return m_Base.Displace( x, y, z );
+					}
+
+				private :
+
+					float			m_XOffset;
+					float			m_ZOffset;
+					float			m_Influence;
+					BaseDisplacer	m_Base;
+					FunctionType	m_Function;
+					float			m_GroundFieldSpacing;
+					bool			m_GroundField;
+			};
+
+			///	\brief	Scalar reference implementation of SseSphereFunction3dDisplacer
+			template < typename FunctionType >
+			class ScalarSphereFunction3dDisplacer : public ScalarSphereTerrainDisplacer
+			{
+				public :
+
+					///	\brief	Gets the function object
+					FunctionType& GetFunction( )
+					{
+						return m_Function;
+					}
+
+					///	\brief	Gets the function object
+					const FunctionType& GetFunction( ) const
+					{
+						return m_Function;
+					}
+
+					///	\brief	Maps an (x,y,z) vector onto the minimum distance of this displacer
+					inline float Displace( float& x, float& y, float& z ) const
+					{
+						const float height = m_Function.GetValue( x, y, z );
+						const float actualHeight = MapToHeightRange( height );
+						x *= actualHeight;
+						y *= actualHeight;
+						z *= actualHeight;
+						return height;
+					}
+
+				private :
+
+					FunctionType m_Function;
+			};
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,775 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "ScalarTerrainGenerator.h"
+#include "ScalarSphereTerrainDisplacers.h"
+#include "ScalarTerrainTypeSelector.h"
+#include "UCubeMapSeams.h"
+
+#include <limits.h>
+#include <string.h>
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar equivalent of SsePropertyPixelWriter, one pixel at a time
+			class ScalarPropertyPixelWriter
+			{
+				public :
+
+					///	\brief	Gets the size of a pixel, in bytes
+					int GetPixelSize( ) const
+					{
+						return 3;
+					}
+
+					///	\brief	Writes a pixel
+					void Write( unsigned char* pixel, const float latitude, const float height, const float slope ) const
+					{
+						pixel[ 2 ] = GetPropertyByte( slope * 256 );
+						pixel[ 1 ] = GetPropertyByte( height * 200 );
+						pixel[ 0 ] = 0;
+					}
+
+				private :
+
+					///	\brief	Converts a property value to a byte, in the same way as the SSE writer (truncate, then saturate)
+					static unsigned char GetPropertyByte( const float value )
+					{
+						//	_mm_cvttps_epi32() gives 0x80000000 for NaNs and values out of int range
+						const int truncated = ( value > -2147483648.0f ) && ( value < 2147483648.0f ) ? int( value ) : INT_MIN;
+						return ( unsigned char )( truncated < 0 ? 0 : ( truncated > 255 ? 255 : truncated ) );
+					}
+			};
+
+			///	\brief	Scalar equivalent of SseTerrainTypePixelWriter, one pixel at a time
+			class ScalarTerrainTypePixelWriter
+			{
+				public :
+
+					ScalarTerrainTypePixelWriter( const UTerrainTypeSelector& selector, const UPixelFormat format ) :
+						m_Selector( selector ),
+						m_Format( format )
+					{
+					}
+
+					///	\brief	Gets the size of a pixel, in bytes
+					int GetPixelSize( ) const
+					{
+						return GetBytesPerPixel( m_Format );
+					}
+
+					///	\brief	Writes a pixel
+					void Write( unsigned char* pixel, const float latitude, const float height, const float slope ) const
+					{
+						m_Selector.WritePixel( m_Format, latitude, height, slope, pixel );
+					}
+
+				private :
+
+					ScalarTerrainTypeSelector	m_Selector;
+					const UPixelFormat			m_Format;
+			};
+
+			///	\brief	Scalar reference implementation of SseSphereTerrainGeneratorT, at exact precision
+			template < typename DisplaceType >
+			class ScalarSphereTerrainGeneratorT : public ScalarTerrainGenerator
+			{
+				public :
+
+					///	\brief	Gets the object used to displace vertices from the sphere surface
+					DisplaceType& GetDisplacer( )
+					{
+						return m_Displacer;
+					}
+
+					///	\brief	Gets the object used to displace vertices from the sphere surface
+					const DisplaceType& GetDisplacer( ) const
+					{
+						return m_Displacer;
+					}
+
+					///	\brief	Generates terrain vertex points and normals
+					void GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices );
+
+					///	\brief	Generates terrain vertex points and normals. Gets maximum patch error
+					void GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& maxError );
+
+					///	\brief	Generates a terrain property cube map face (slope in byte 2, height in byte 1 of each 3 byte pixel)
+					///
+					///	Like SseSphereTerrainGeneratorT, each texel is displaced once, and normals come from the
+					///	displaced positions of neighbouring texels.
+					///
+					void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels );
+
+					///	\brief	Generates all six terrain property cube map faces, with shared edges (SseSphereTerrainGeneratorT::GenerateTerrainPropertyCubeMap())
+					///
+					///	Every texel of every face is displaced, then edge texels are replaced by the texels of the faces
+					///	that own them. u and v are calculated for each texel, like the SSE generator.
+					///
+					void GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels );
+
+					///	\brief	Generates a terrain colour (or type) cube map face, from the same heights and slopes as GenerateTerrainPropertyCubeMapFace()
+					void GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels );
+
+				private :
+
+					DisplaceType m_Displacer;
+
+					///	\brief	Projects a position onto the function sphere, and displaces it. Returns the height
+					float GetHeight( const float* position ) const;
+
+					///	\brief	Generates a vertex from a position on the patch
+					float SetVertex( UTerrainVertex& vertex, const float* position, const float u, const float v ) const;
+
+					///	\brief	Generates a vertex from a position on the patch, using a displacer for the vertex and the neighbours used for its normal
+					template < typename SampleDisplacer >
+					float SetVertex( const SampleDisplacer& displacer, UTerrainVertex& vertex, const float* position, const float u, const float v ) const;
+
+					///	\brief	Generates vertices with the ground field of a ground displacer (SseSphereTerrainGeneratorT::GenerateGroundFieldVertices())
+					template < typename BaseDisplacer, typename FunctionType >
+					bool GenerateGroundFieldVertices( const ScalarSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionType >& displacer, const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, const float uvRes, UTerrainVertex* vertices ) const;
+
+					///	\brief	Displacers without ground displacement have no ground field
+					bool GenerateGroundFieldVertices( const ScalarSphereTerrainDisplacer&, const float*, const float*, const float*, const int, const int, const float*, const float, UTerrainVertex* ) const
+					{
+						return false;
+					}
+
+					///	\brief	Gets the ground values of every vertex in a row, from values evaluated at every second vertex (SseSphereTerrainGeneratorT::FillGroundFieldLine())
+					///
+					///	starts has the positions of vertices 0, 2, 4 and 6, and increment moves them on 8 vertices. The line
+					///	has the 2 ground values of each vertex. width must be odd.
+					///
+					template < typename GroundDisplacer >
+					void FillGroundFieldLine( const GroundDisplacer& displacer, const int width, const float ( &starts )[ Lanes ][ 3 ], const float* increment, float* line ) const;
+
+					///	\brief	Gets the ground offsets of a vertex, from its position on the patch
+					template < typename GroundDisplacer >
+					void GetGroundOffsets( const GroundDisplacer& displacer, const float* position, float* offsets ) const;
+
+					///	\brief	Gets the ground values of a vertex, from its position on the patch
+					template < typename GroundDisplacer >
+					void GetGroundValues( const GroundDisplacer& displacer, const float* position, float* values ) const;
+
+					///	\brief	Gets the ground offsets of a vertex, from its position on the patch and its ground values
+					template < typename GroundDisplacer >
+					void GetFrameOffsets( const GroundDisplacer& displacer, const float* position, const float* values, float* offsets ) const;
+
+					///	\brief	Generates the heights, slopes and latitudes of a cube map face, and passes each texel to a pixel writer
+					template < typename PixelWriter >
+					void GenerateCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const PixelWriter& writer );
+
+					///	\brief	Gets the error heights at the start of an error row (SseSphereTerrainGeneratorT::GetInitialErrorHeights())
+					void GetInitialErrorHeights( const float ( &positions )[ Lanes ][ 3 ], float& lastHeight, float& lastIntHeight ) const;
+
+					///	\brief	Gets the maximum error along an intermediate row (SseSphereTerrainGeneratorT::GetRowMaxError())
+					void GetRowMaxError( float ( &positions )[ Lanes ][ 3 ], const float* increment, const int rowLength, float& maxError ) const;
+			};
+
+			//	------------------------------------------ ScalarSphereTerrainGeneratorT Inline Methods
+
+			template < typename DisplaceType >
+			inline float ScalarSphereTerrainGeneratorT< DisplaceType >::GetHeight( const float* position ) const
+			{
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				ScalarSetLength( origin[ 0 ], origin[ 1 ], origin[ 2 ], m_Displacer.GetFunctionScale( ) );
+				return m_Displacer.Displace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+			}
+
+			template < typename DisplaceType >
+			inline float ScalarSphereTerrainGeneratorT< DisplaceType >::SetVertex( UTerrainVertex& vertex, const float* position, const float u, const float v ) const
+			{
+				return SetVertex( m_Displacer, vertex, position, u, v );
+			}
+
+			template < typename DisplaceType >
+			template < typename SampleDisplacer >
+			inline float ScalarSphereTerrainGeneratorT< DisplaceType >::SetVertex( const SampleDisplacer& displacer, UTerrainVertex& vertex, const float* position, const float u, const float v ) const
+			{
+				const float scale = m_Displacer.GetFunctionScale( );
+
+				float up[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				ScalarSetLength( up[ 0 ], up[ 1 ], up[ 2 ], 1 );
+
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				ScalarSetLength( origin[ 0 ], origin[ 1 ], origin[ 2 ], scale );
+				const float height = displacer.Displace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+
+				//	Left, up, right and down neighbours, offset from the undisplaced position
+				float neighbours[ 4 ][ 3 ] =
+				{
+					{ position[ 0 ] - m_ShiftRight[ 0 ], position[ 1 ] - m_ShiftRight[ 1 ], position[ 2 ] - m_ShiftRight[ 2 ] },
+					{ position[ 0 ] - m_ShiftDown[ 0 ], position[ 1 ] - m_ShiftDown[ 1 ], position[ 2 ] - m_ShiftDown[ 2 ] },
+					{ position[ 0 ] + m_ShiftRight[ 0 ], position[ 1 ] + m_ShiftRight[ 1 ], position[ 2 ] + m_ShiftRight[ 2 ] },
+					{ position[ 0 ] + m_ShiftDown[ 0 ], position[ 1 ] + m_ShiftDown[ 1 ], position[ 2 ] + m_ShiftDown[ 2 ] }
+				};
+				for ( int neighbour = 0; neighbour < 4; ++neighbour )
+				{
+					float* n = neighbours[ neighbour ];
+					ScalarSetLength( n[ 0 ], n[ 1 ], n[ 2 ], scale );
+					displacer.Displace( n[ 0 ], n[ 1 ], n[ 2 ] );
+				}
+
+				float normal[ 3 ];
+				const float slope = GetNormalAndSlope( origin, neighbours, up, 0.6f, normal );
+				SetupVertex( vertex, origin, normal, slope, height, u, v );
+				return height;
+			}
+
+			template < typename DisplaceType >
+			inline void ScalarSphereTerrainGeneratorT< DisplaceType >::GetInitialErrorHeights( const float ( &positions )[ Lanes ][ 3 ], float& lastHeight, float& lastIntHeight ) const
+			{
+				lastHeight = GetHeight( positions[ 2 ] );
+				lastIntHeight = GetHeight( positions[ 3 ] );
+			}
+
+			template < typename DisplaceType >
+			inline void ScalarSphereTerrainGeneratorT< DisplaceType >::GetRowMaxError( float ( &positions )[ Lanes ][ 3 ], const float* increment, const int rowLength, float& maxError ) const
+			{
+				float lastHeight = 0;
+				float lastIntHeight = 0;
+				GetInitialErrorHeights( positions, lastHeight, lastIntHeight );
+
+				for ( int i = 0; i < rowLength; ++i )
+				{
+					float heights[ Lanes ];
+					for ( int lane = 0; lane < Lanes; ++lane )
+					{
+						heights[ lane ] = GetHeight( positions[ lane ] );
+					}
+					UpdateError( heights, lastHeight, lastIntHeight, maxError );
+					AddToLanes( positions, increment );
+				}
+			}
+
+			template < typename DisplaceType >
+			template < typename GroundDisplacer >
+			inline void ScalarSphereTerrainGeneratorT< DisplaceType >::GetGroundOffsets( const GroundDisplacer& displacer, const float* position, float* offsets ) const
+			{
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				ScalarSetLength( origin[ 0 ], origin[ 1 ], origin[ 2 ], displacer.GetFunctionScale( ) );
+				displacer.GetGroundOffsets( origin[ 0 ], origin[ 1 ], origin[ 2 ], offsets );
+			}
+
+			template < typename DisplaceType >
+			template < typename GroundDisplacer >
+			inline void ScalarSphereTerrainGeneratorT< DisplaceType >::GetGroundValues( const GroundDisplacer& displacer, const float* position, float* values ) const
+			{
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				ScalarSetLength( origin[ 0 ], origin[ 1 ], origin[ 2 ], displacer.GetFunctionScale( ) );
+				displacer.GetGroundValues( origin[ 0 ], origin[ 1 ], origin[ 2 ], values );
+			}
+
+			template < typename DisplaceType >
+			template < typename GroundDisplacer >
+			inline void ScalarSphereTerrainGeneratorT< DisplaceType >::GetFrameOffsets( const GroundDisplacer& displacer, const float* position, const float* values, float* offsets ) const
+			{
+				float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+				ScalarSetLength( origin[ 0 ], origin[ 1 ], origin[ 2 ], displacer.GetFunctionScale( ) );
+				displacer.GetFrameOffsets( origin[ 0 ], origin[ 1 ], origin[ 2 ], values, offsets );
+			}
+
+			template < typename DisplaceType >
+			template < typename GroundDisplacer >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::FillGroundFieldLine( const GroundDisplacer& displacer, const int width, const float ( &starts )[ Lanes ][ 3 ], const float* increment, float* line ) const
+			{
+				//	Even vertices are evaluated a lane at a time, and the lanes move on together, like the SSE generator
+				const int samples = ( width + 1 ) / 2;
+				std::vector< float > even( samples * 2 );
+				float positions[ Lanes ][ 3 ];
+				memcpy( positions, starts, sizeof( positions ) );
+				for ( int sample = 0; sample < samples; ++sample )
+				{
+					if ( ( sample > 0 ) && ( ( sample % Lanes ) == 0 ) )
+					{
+						AddToLanes( positions, increment );
+					}
+					GetGroundValues( displacer, positions[ sample % Lanes ], &even[ sample * 2 ] );
+				}
+
+				//	Odd vertices are halfway between their neighbours
+				for ( int col = 0; col < width; ++col )
+				{
+					const float* previous = &even[ ( col / 2 ) * 2 ];
+					for ( int value = 0; value < 2; ++value )
+					{
+						line[ col * 2 + value ] = ( ( col % 2 ) == 0 ) ? previous[ value ] : ( previous[ value ] + previous[ 2 + value ] ) * 0.5f;
+					}
+				}
+			}
+
+			template < typename DisplaceType >
+			template < typename BaseDisplacer, typename FunctionType >
+			bool ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateGroundFieldVertices( const ScalarSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionType >& displacer, const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, const float uvRes, UTerrainVertex* vertices ) const
+			{
+				typedef typename ScalarSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionType >::OffsetDisplacer OffsetDisplacer;
+				if ( !displacer.IsGroundFieldEnabled( ) )
+				{
+					return false;
+				}
+				const bool reduced = ( width > 1 ) && ( height > 1 ) && ( ( width % 2 ) != 0 ) && ( ( height % 2 ) != 0 ) && displacer.IsGroundFieldReduced( origin, xStep, zStep );
+
+				float starts[ Lanes ][ 3 ];
+				SetLaneStarts( starts, origin, xStep );
+				const float colInc[ 3 ] = { xStep[ 0 ] * 4, xStep[ 1 ] * 4, xStep[ 2 ] * 4 };
+
+				//	Field samples start at vertices 0, 2, 4 and 6 of the first row, and move on 8 vertices, or 2 rows
+				float fieldStarts[ Lanes ][ 3 ];
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					fieldStarts[ 0 ][ axis ] = origin[ axis ];
+					fieldStarts[ 1 ][ axis ] = origin[ axis ] + xStep[ axis ] * 2;
+					fieldStarts[ 2 ][ axis ] = origin[ axis ] + xStep[ axis ] * 4;
+					fieldStarts[ 3 ][ axis ] = origin[ axis ] + xStep[ axis ] * 6;
+				}
+				const float fieldColInc[ 3 ] = { xStep[ 0 ] * 8, xStep[ 1 ] * 8, xStep[ 2 ] * 8 };
+				const float fieldRowInc[ 3 ] = { zStep[ 0 ] * 2, zStep[ 1 ] * 2, zStep[ 2 ] * 2 };
+
+				std::vector< float > field( width * 2 );
+				std::vector< float > nextField( width * 2 );
+				if ( reduced )
+				{
+					FillGroundFieldLine( displacer, width, fieldStarts, fieldColInc, &field[ 0 ] );
+				}
+
+				const float uInc = uvRes / ( float )( width - 1 );
+				const float vInc = uvRes / ( float )( height - 1 );
+				const float uIncLanes = uInc * 4;
+				float v = uv[ 1 ];
+
+				for ( int row = 0; row < height; ++row, v += vInc )
+				{
+					const bool oddRow = ( row % 2 ) != 0;
+					if ( reduced && oddRow )
+					{
+						AddToLanes( fieldStarts, fieldRowInc );
+						FillGroundFieldLine( displacer, width, fieldStarts, fieldColInc, &nextField[ 0 ] );
+					}
+					else if ( reduced && ( row > 0 ) )
+					{
+						field.swap( nextField );
+					}
+
+					float u[ Lanes ] = { uv[ 0 ], uv[ 0 ] + uInc, uv[ 0 ] + uInc * 2, uv[ 0 ] + uInc * 3 };
+					float positions[ Lanes ][ 3 ];
+					memcpy( positions, starts, sizeof( positions ) );
+
+					UTerrainVertex* rowVertices = vertices + row * width;
+					for ( int col = 0; col < width; col += Lanes )
+					{
+						for ( int lane = 0; ( lane < Lanes ) && ( ( col + lane ) < width ); ++lane )
+						{
+							float offsets[ 3 ];
+							if ( reduced )
+							{
+								const float* vertexField = &field[ ( col + lane ) * 2 ];
+								const float* nextVertexField = &nextField[ ( col + lane ) * 2 ];
+								float values[ 2 ];
+								for ( int value = 0; value < 2; ++value )
+								{
+									values[ value ] = oddRow ? ( vertexField[ value ] + nextVertexField[ value ] ) * 0.5f : vertexField[ value ];
+								}
+								GetFrameOffsets( displacer, positions[ lane ], values, offsets );
+							}
+							else
+							{
+								GetGroundOffsets( displacer, positions[ lane ], offsets );
+							}
+							const OffsetDisplacer offsetDisplacer( displacer, offsets );
+							SetVertex( offsetDisplacer, rowVertices[ col + lane ], positions[ lane ], u[ lane ], v );
+							u[ lane ] += uIncLanes;
+						}
+						AddToLanes( positions, colInc );
+					}
+
+					AddToLanes( starts, zStep );
+				}
+				return true;
+			}
+
+			template < typename DisplaceType >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices )
+			{
+				AssignShiftVectors( xStep, zStep );
+
+				if ( GenerateGroundFieldVertices( m_Displacer, origin, xStep, zStep, width, height, uv, uvRes, vertices ) )
+				{
+					return;
+				}
+
+				float starts[ Lanes ][ 3 ];
+				SetLaneStarts( starts, origin, xStep );
+				const float colInc[ 3 ] = { xStep[ 0 ] * 4, xStep[ 1 ] * 4, xStep[ 2 ] * 4 };
+
+				const float uInc = uvRes / ( float )( width - 1 );
+				const float vInc = uvRes / ( float )( height - 1 );
+				const float uIncLanes = uInc * 4;
+				float v = uv[ 1 ];
+
+				for ( int row = 0; row < height; ++row, v += vInc )
+				{
+					float u[ Lanes ] = { uv[ 0 ], uv[ 0 ] + uInc, uv[ 0 ] + uInc * 2, uv[ 0 ] + uInc * 3 };
+					float positions[ Lanes ][ 3 ];
+					memcpy( positions, starts, sizeof( positions ) );
+
+					UTerrainVertex* rowVertices = vertices + row * width;
+					for ( int col = 0; col < width; col += Lanes )
+					{
+						for ( int lane = 0; ( lane < Lanes ) && ( ( col + lane ) < width ); ++lane )
+						{
+							SetVertex( rowVertices[ col + lane ], positions[ lane ], u[ lane ], v );
+							u[ lane ] += uIncLanes;
+						}
+						AddToLanes( positions, colInc );
+					}
+
+					AddToLanes( starts, zStep );
+				}
+			}
+
+			template < typename DisplaceType >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& error )
+			{
+				AssignShiftVectors( xStep, zStep );
+
+				//	Same as GenerateVertices() without error, except that the resolution is doubled
+				xStep[ 0 ] /= 2; xStep[ 1 ] /= 2; xStep[ 2 ] /= 2;
+				zStep[ 0 ] /= 2; zStep[ 1 ] /= 2; zStep[ 2 ] /= 2;
+				const int outputWidth = width;
+				width = ( width * 2 ) - 1;
+				height = ( height * 2 ) - 1;
+
+				//	Lanes start one block to the left of the origin. The first block only supplies error heights
+				float starts[ Lanes ][ 3 ];
+				SetLaneStarts( starts, origin, xStep );
+				const float colInc[ 3 ] = { xStep[ 0 ] * 4, xStep[ 1 ] * 4, xStep[ 2 ] * 4 };
+				const float negColInc[ 3 ] = { -colInc[ 0 ], -colInc[ 1 ], -colInc[ 2 ] };
+				AddToLanes( starts, negColInc );
+
+				const float uInc = uvRes / ( float )( width - 1 );
+				const float vInc = uvRes / ( float )( height - 1 );
+				const float uIncLanes = uInc * 4;
+				float v = uv[ 1 ];
+
+				const int widthDiv4 = width / 4;
+				const int widthMod4 = width % 4;
+
+				error = 0;
+
+				float lastHeight = 0;
+				float lastIntHeight = 0;
+
+				for ( int row = 0; row < height; ++row, v += vInc )
+				{
+					float positions[ Lanes ][ 3 ];
+					memcpy( positions, starts, sizeof( positions ) );
+
+					if ( ( row % 2 ) != 0 )
+					{
+						GetRowMaxError( positions, colInc, widthDiv4, error );
+					}
+					else
+					{
+						float u[ Lanes ] = { uv[ 0 ], uv[ 0 ] + uInc, uv[ 0 ] + uInc * 2, uv[ 0 ] + uInc * 3 };
+
+						GetInitialErrorHeights( positions, lastHeight, lastIntHeight );
+						AddToLanes( positions, colInc );
+
+						//	Vertices come from the even lanes of every second row. Odd lanes are only used for the
+						//	error estimate. The last block may be partial
+						UTerrainVertex* rowVertices = vertices + ( row / 2 ) * outputWidth;
+						const int numBlocks = widthDiv4 + ( widthMod4 != 0 ? 1 : 0 );
+						for ( int block = 0; block < numBlocks; ++block )
+						{
+							float heights[ Lanes ];
+							for ( int lane = 0; lane < Lanes; ++lane )
+							{
+								const int vertex = ( block * Lanes + lane ) / 2;
+								if ( ( ( lane % 2 ) == 0 ) && ( vertex < outputWidth ) )
+								{
+									heights[ lane ] = SetVertex( rowVertices[ vertex ], positions[ lane ], u[ lane ], v );
+								}
+								else
+								{
+									heights[ lane ] = GetHeight( positions[ lane ] );
+								}
+								u[ lane ] += uIncLanes;
+							}
+							UpdateError( heights, lastHeight, lastIntHeight, error );
+							AddToLanes( positions, colInc );
+						}
+					}
+
+					AddToLanes( starts, zStep );
+				}
+				error = m_Displacer.MapToHeightScale( error );
+			}
+
+			template < typename DisplaceType >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels )
+			{
+				GenerateCubeMapFace( face, width, height, stride, pixels, ScalarPropertyPixelWriter( ) );
+			}
+
+			template < typename DisplaceType >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels )
+			{
+				if ( ( size < 4 ) || ( ( size % 4 ) != 0 ) )
+				{
+					return;
+				}
+
+				const float scale = m_Displacer.GetFunctionScale( );
+				const float inc = 2.0f / float( size - 1 );
+				const int faceTexels = size * size;
+
+				//	Displaced positions and heights of every texel of every face
+				std::vector< float > positions( faceTexels * 6 * 3 );
+				std::vector< float > heights( faceTexels * 6 );
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int row = 0; row < size; ++row )
+					{
+						for ( int col = 0; col < size; ++col )
+						{
+							const int index = face * faceTexels + row * size + col;
+							float* position = &positions[ index * 3 ];
+							ScalarCubeFacePosition( UCubeMapFace( face ), m_CubeMapProjection, -1 + inc * float( col ), -1 + inc * float( row ), position[ 0 ], position[ 1 ], position[ 2 ] );
+							ScalarSetLength( position[ 0 ], position[ 1 ], position[ 2 ], scale );
+							heights[ index ] = m_Displacer.Displace( position[ 0 ], position[ 1 ], position[ 2 ] );
+						}
+					}
+				}
+
+				//	Edge texels take the position and height of the face that owns them
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
+					{
+						for ( int k = 0; k < size - 1; ++k )
+						{
+							UCubeMapFace ownerFace = UCubeMapFace( face );
+							UCubeMapSeams::Side ownerSide = UCubeMapSeams::Side( side );
+							int ownerK = k;
+							if ( k == 0 )
+							{
+								UCubeMapSeams::GetCornerOwner( UCubeMapFace( face ), UCubeMapSeams::Side( side ), ownerFace, ownerSide );
+							}
+							else if ( !UCubeMapSeams::OwnsEdge( UCubeMapFace( face ), UCubeMapSeams::Side( side ) ) )
+							{
+								UCubeMapSeams::GetNeighbour( UCubeMapFace( face ), UCubeMapSeams::Side( side ), ownerFace, ownerSide );
+								ownerK = size - 1 - k;
+							}
+							int row, col, ownerRow, ownerCol;
+							UCubeMapSeams::GetSideTexel( size, UCubeMapSeams::Side( side ), 0, k, row, col );
+							UCubeMapSeams::GetSideTexel( size, ownerSide, 0, ownerK, ownerRow, ownerCol );
+							const int index = face * faceTexels + row * size + col;
+							const int ownerIndex = ownerFace * faceTexels + ownerRow * size + ownerCol;
+							memcpy( &positions[ index * 3 ], &positions[ ownerIndex * 3 ], sizeof( float ) * 3 );
+							heights[ index ] = heights[ ownerIndex ];
+						}
+					}
+				}
+
+				//	Slopes and latitudes. Edge texels are calculated by the face that owns them, with neighbours taken
+				//	along the edge (SseSphereTerrainGeneratorT::SetSideEdgeValues()), then copied to the other faces
+				std::vector< float > slopes( faceTexels * 6 );
+				std::vector< float > latitudes( faceTexels * 6 );
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
+					{
+						UCubeMapFace neighbourFace, cornerFace;
+						UCubeMapSeams::Side neighbourSide, cornerSide;
+						UCubeMapSeams::GetNeighbour( UCubeMapFace( face ), UCubeMapSeams::Side( side ), neighbourFace, neighbourSide );
+						UCubeMapSeams::GetCornerOwner( UCubeMapFace( face ), UCubeMapSeams::Side( side ), cornerFace, cornerSide );
+						for ( int k = 0; k < size - 1; ++k )
+						{
+							const bool owned = k == 0 ? cornerFace == face : UCubeMapSeams::OwnsEdge( UCubeMapFace( face ), UCubeMapSeams::Side( side ) );
+							if ( !owned )
+							{
+								continue;
+							}
+
+							//	Up, left, down and right neighbours (GetNormalAndSlope() order)
+							int rows[ 4 ], cols[ 4 ], row, col;
+							const int faces[ 4 ] = { neighbourFace, k == 0 ? neighbourFace : face, face, face };
+							UCubeMapSeams::GetSideTexel( size, UCubeMapSeams::Side( side ), 0, k, row, col );
+							UCubeMapSeams::GetSideTexel( size, neighbourSide, 1, size - 1 - k, rows[ 0 ], cols[ 0 ] );
+							UCubeMapSeams::GetSideTexel( size, UCubeMapSeams::Side( side ), 1, k, rows[ 2 ], cols[ 2 ] );
+							UCubeMapSeams::GetSideTexel( size, UCubeMapSeams::Side( side ), 0, k + 1, rows[ 3 ], cols[ 3 ] );
+							if ( k == 0 )
+							{
+								rows[ 1 ] = rows[ 0 ];
+								cols[ 1 ] = cols[ 0 ];
+							}
+							else
+							{
+								UCubeMapSeams::GetSideTexel( size, UCubeMapSeams::Side( side ), 0, k - 1, rows[ 1 ], cols[ 1 ] );
+							}
+
+							float neighbours[ 4 ][ 3 ];
+							for ( int neighbour = 0; neighbour < 4; ++neighbour )
+							{
+								memcpy( neighbours[ neighbour ], &positions[ ( faces[ neighbour ] * faceTexels + rows[ neighbour ] * size + cols[ neighbour ] ) * 3 ], sizeof( float ) * 3 );
+							}
+
+							float up[ 3 ];
+							ScalarCubeFacePosition( UCubeMapFace( face ), m_CubeMapProjection, -1 + inc * float( col ), -1 + inc * float( row ), up[ 0 ], up[ 1 ], up[ 2 ] );
+							ScalarSetLength( up[ 0 ], up[ 1 ], up[ 2 ], 1 );
+
+							float normal[ 3 ];
+							float slope = GetNormalAndSlope( &positions[ ( face * faceTexels + row * size + col ) * 3 ], neighbours, up, 0.6f, normal );
+							slope = slope < 1 ? slope : 1;
+							slope = slope > 0 ? slope : 0;
+
+							UCubeMapFace texelFaces[ 3 ];
+							int texelRows[ 3 ], texelCols[ 3 ];
+							const int texels = UCubeMapSeams::GetEdgeTexels( size, UCubeMapFace( face ), UCubeMapSeams::Side( side ), k, texelFaces, texelRows, texelCols );
+							for ( int texel = 0; texel < texels; ++texel )
+							{
+								const int index = texelFaces[ texel ] * faceTexels + texelRows[ texel ] * size + texelCols[ texel ];
+								slopes[ index ] = slope;
+								latitudes[ index ] = fabsf( up[ 1 ] );
+							}
+						}
+					}
+				}
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int row = 1; row < size - 1; ++row )
+					{
+						for ( int col = 1; col < size - 1; ++col )
+						{
+							const int index = face * faceTexels + row * size + col;
+
+							//	Above, left, below and right neighbours
+							float neighbours[ 4 ][ 3 ];
+							memcpy( neighbours[ 0 ], &positions[ ( index - size ) * 3 ], sizeof( float ) * 3 );
+							memcpy( neighbours[ 1 ], &positions[ ( index - 1 ) * 3 ], sizeof( float ) * 3 );
+							memcpy( neighbours[ 2 ], &positions[ ( index + size ) * 3 ], sizeof( float ) * 3 );
+							memcpy( neighbours[ 3 ], &positions[ ( index + 1 ) * 3 ], sizeof( float ) * 3 );
+
+							float up[ 3 ];
+							ScalarCubeFacePosition( UCubeMapFace( face ), m_CubeMapProjection, -1 + inc * float( col ), -1 + inc * float( row ), up[ 0 ], up[ 1 ], up[ 2 ] );
+							ScalarSetLength( up[ 0 ], up[ 1 ], up[ 2 ], 1 );
+
+							float normal[ 3 ];
+							float slope = GetNormalAndSlope( &positions[ index * 3 ], neighbours, up, 0.6f, normal );
+							slope = slope < 1 ? slope : 1;
+							slope = slope > 0 ? slope : 0;
+							slopes[ index ] = slope;
+							latitudes[ index ] = fabsf( up[ 1 ] );
+						}
+					}
+				}
+
+				const ScalarPropertyPixelWriter writer;
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int row = 0; row < size; ++row )
+					{
+						unsigned char* curPixel = facePixels[ face ] + row * stride;
+						for ( int col = 0; col < size; ++col, curPixel += writer.GetPixelSize( ) )
+						{
+							const int index = face * faceTexels + row * size + col;
+							writer.Write( curPixel, latitudes[ index ], heights[ index ], slopes[ index ] );
+						}
+					}
+				}
+			}
+
+			template < typename DisplaceType >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels )
+			{
+				GenerateCubeMapFace( face, width, height, stride, pixels, ScalarTerrainTypePixelWriter( selector, format ) );
+			}
+
+			template < typename DisplaceType >
+			template < typename PixelWriter >
+			void ScalarSphereTerrainGeneratorT< DisplaceType >::GenerateCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const PixelWriter& writer )
+			{
+				const int w4 = width / 4;
+				if ( w4 == 0 )
+				{
+					return;
+				}
+
+				const float scale = m_Displacer.GetFunctionScale( );
+				const float incU = 2.0f / float( width - 1 );
+				const float incV = 2.0f / float( height - 1 );
+				const float incULanes = incU * 4;
+
+				//	Displaced positions of every texel, with a border block either side of each row, and a border
+				//	row above and below the face. Lanes accumulate u in the same way as the SSE generator
+				const int cacheWidth = ( w4 + 2 ) * 4;
+				const float uStart[ Lanes ] = { -1 - incULanes, ( -1 + incU ) - incULanes, ( -1 + incU * 2 ) - incULanes, ( -1 + incU * 3 ) - incULanes };
+				std::vector< float > positions( cacheWidth * ( height + 2 ) * 3 );
+				std::vector< float > heights( cacheWidth * ( height + 2 ) );
+				for ( int row = -1; row <= height; ++row )
+				{
+					const float v = row < 0 ? -1 - incV : -1 + incV * float( row );
+					float u[ Lanes ] = { uStart[ 0 ], uStart[ 1 ], uStart[ 2 ], uStart[ 3 ] };
+					for ( int col = 0; col < cacheWidth; col += Lanes )
+					{
+						for ( int lane = 0; lane < Lanes; ++lane )
+						{
+							const int index = ( row + 1 ) * cacheWidth + col + lane;
+							float* position = &positions[ index * 3 ];
+							ScalarCubeFacePosition( face, m_CubeMapProjection, u[ lane ], v, position[ 0 ], position[ 1 ], position[ 2 ] );
+							ScalarSetLength( position[ 0 ], position[ 1 ], position[ 2 ], scale );
+							heights[ index ] = m_Displacer.Displace( position[ 0 ], position[ 1 ], position[ 2 ] );
+							u[ lane ] += incULanes;
+						}
+					}
+				}
+
+				unsigned char* rowPixel = pixels;
+				for ( int row = 0; row < height; ++row, rowPixel += stride )
+				{
+					const float v = -1 + incV * float( row );
+					float u[ Lanes ] = { uStart[ 0 ] + incULanes, uStart[ 1 ] + incULanes, uStart[ 2 ] + incULanes, uStart[ 3 ] + incULanes };
+					unsigned char* curPixel = rowPixel;
+					for ( int col = Lanes; col < ( w4 + 1 ) * Lanes; col += Lanes )
+					{
+						for ( int lane = 0; lane < Lanes; ++lane, curPixel += writer.GetPixelSize( ) )
+						{
+							const int index = ( row + 1 ) * cacheWidth + col + lane;
+							const float* origin = &positions[ index * 3 ];
+
+							//	Above, left, below and right neighbours. GetNormalAndSlope() winds them in the same order as the SSE generator
+							float neighbours[ 4 ][ 3 ];
+							memcpy( neighbours[ 0 ], &positions[ ( index - cacheWidth ) * 3 ], sizeof( float ) * 3 );
+							memcpy( neighbours[ 1 ], &positions[ ( index - 1 ) * 3 ], sizeof( float ) * 3 );
+							memcpy( neighbours[ 2 ], &positions[ ( index + cacheWidth ) * 3 ], sizeof( float ) * 3 );
+							memcpy( neighbours[ 3 ], &positions[ ( index + 1 ) * 3 ], sizeof( float ) * 3 );
+
+							float up[ 3 ];
+							ScalarCubeFacePosition( face, m_CubeMapProjection, u[ lane ], v, up[ 0 ], up[ 1 ], up[ 2 ] );
+							ScalarSetLength( up[ 0 ], up[ 1 ], up[ 2 ], 1 );
+
+							float normal[ 3 ];
+							float slope = GetNormalAndSlope( origin, neighbours, up, 0.6f, normal );
+							slope = slope < 1 ? slope : 1;
+							slope = slope > 0 ? slope : 0;
+
+							writer.Write( curPixel, fabsf( up[ 1 ] ), heights[ index ], slope );
+
+							u[ lane ] += incULanes;
+						}
+					}
+				}
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,108 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <Scalar/ScalarUtils.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar reference implementation of SseTerrainDisplacer
+			///
+			///	The scalar displacers have the same interface as the SSE displacers, except that Displace()
+			///	takes and returns single values. They share set up code paths (including the call to the virtual
+			///	PreMultiplyHeightRange() from the constructor), so a reference displacer set up in the same way
+			///	as an SSE displacer has the same parameters.
+			///
+			class ScalarTerrainDisplacer
+			{
+				public :
+
+					///	\brief	Sets up reasonable defaults
+					ScalarTerrainDisplacer( )
+					{
+						m_OutputScale = 1;
+						SetFunctionScale( 6.0f );
+						Setup( 64, 1.0f, 3.0f );
+					}
+
+					virtual ~ScalarTerrainDisplacer( )
+					{
+					}
+
+					///	\brief Gets the scale of the displacement function input (e.g. sphere radius)
+					float GetFunctionScale( ) const
+					{
+						return m_Scale;
+					}
+
+					///	\brief Gets the minimum height generated by this displacer
+					float GetMinimumHeight( ) const
+					{
+						return m_MinHeight;
+					}
+
+					///	\brief	Changes the function scale. Must be called before Setup(), for premultiplied displacers
+					void SetFunctionScale( float functionScale )
+					{
+						m_Scale = functionScale;
+					}
+
+					///	\brief	Sets the output scale
+					void SetOutputScale( float outputScale )
+					{
+						m_OutputScale = outputScale;
+					}
+
+					///	\brief	Sets up this displacer. SetFunctionScale() must be called first or pre-multiplied displacers
+					virtual void Setup( float patchScale, float minHeight, float maxHeight )
+					{
+						m_PatchScaleToFunctionScale = m_Scale / patchScale;
+
+						m_MinHeight = minHeight;
+						m_MaxHeight = maxHeight;
+						m_HeightRange = m_MaxHeight - m_MinHeight;
+
+						if ( PreMultiplyHeightRange( ) )
+						{
+							m_HeightRange = m_HeightRange / m_Scale;
+							m_MinHeight = m_MinHeight / m_Scale;
+							m_MaxHeight = m_MaxHeight / m_Scale;
+						}
+
+						m_HeightRangeF = maxHeight - minHeight;
+					}
+
+					///	\brief	Maps a height value into the height range of this displacer
+					float MapToHeightRange( const float height ) const
+					{
+						return m_MinHeight + height * m_HeightRange;
+					}
+
+					///	\brief	Maps a single normalized height value into the height scale of this displacer (does not add minimum height)
+					float MapToHeightScale( float height ) const
+					{
+						return m_HeightRangeF * height;
+					}
+
+				protected :
+
+					float m_HeightRangeF;
+					float m_OutputScale;
+					float m_Scale;
+					float m_PatchScaleToFunctionScale;
+					float m_MinHeight;
+					float m_MaxHeight;
+					float m_HeightRange;
+
+					///	\brief	Returns true if the height ranges for this displacer should be divided through by the function scale
+					virtual bool PreMultiplyHeightRange( ) { return false; }
+			};
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
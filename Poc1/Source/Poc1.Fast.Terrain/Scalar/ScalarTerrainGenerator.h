@@ -0,0 +1,223 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UTerrainVertex.h"
+
+#include <Scalar/ScalarUtils.h>
+#include <UVector3.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar reference implementation of SseTerrainGenerator
+			///
+			///	The scalar generators produce the output that the SSE generators are expected to produce, one
+			///	vertex (or pixel) at a time. They walk patches in the same order as the SSE generators, keeping
+			///	a position per SSE lane, so positions are accumulated in the same way, and the patch error is
+			///	estimated from the same samples. With exact precision, the SSE generators should match them
+			///	bit for bit (see Poc1.Fast.Differential).
+			///
+			class ScalarTerrainGenerator
+			{
+				public :
+
+					ScalarTerrainGenerator( ) :
+						m_SmallestX( 0 ),
+						m_SmallestZ( 0 ),
+						m_CubeMapProjection( ProjectionGnomonic )
+					{
+					}
+
+					///	\brief	Sets the smallest possible step size (finest LOD)
+					void SetSmallestStepSize( const float x, const float z )
+					{
+						m_SmallestX = x;
+						m_SmallestZ = z;
+					}
+
+					///	\brief	Sets the mapping from cube map face coordinates to sphere positions (UTerrainGenerator::SetCubeMapProjection())
+					void SetCubeMapProjection( const UCubeMapProjection projection )
+					{
+						m_CubeMapProjection = projection;
+					}
+
+				protected :
+
+					///	\brief	Number of SSE lanes that the scalar generators keep positions for
+					enum { Lanes = 4 };
+
+					float m_SmallestX;
+					float m_SmallestZ;
+					UCubeMapProjection m_CubeMapProjection;
+					float m_ShiftRight[ 3 ];
+					float m_ShiftDown[ 3 ];
+
+					void AssignCubeFaceShiftVectors( const UCubeMapFace face );
+
+					void AssignShiftVectors( const float* xStep, const float* zStep );
+
+					///	\brief	Sets up the positions of the first vertices in a row, in the same way as the SSE generators
+					static void SetLaneStarts( float ( &starts )[ Lanes ][ 3 ], const float* origin, const float* xStep );
+
+					///	\brief	Adds an increment to all lane positions
+					static void AddToLanes( float ( &positions )[ Lanes ][ 3 ], const float* increment );
+
+					///	\brief	Gets the slope at a displaced position from its displaced neighbours, and the up vector
+					static float GetNormalAndSlope( const float* origin, float ( &neighbours )[ 4 ][ 3 ], const float* up, const float maxSlope, float* normal );
+
+					///	\brief	Sets up a vertex
+					///
+					///	Height and slope are passed to UTerrainVertex::SetTerrainParameters() in the same order as
+					///	SseTerrainGenerator::SetupVertex() passes them.
+					///
+					static void SetupVertex( UTerrainVertex& vertex, const float* position, const float* normal, const float slope, const float height, const float u, const float v );
+
+					///	\brief	Gets the largest error between heights interpolated from even samples and the odd samples in a block of 4 lanes
+					static void UpdateError( const float ( &heights )[ Lanes ], float& lastHeight, float& lastIntHeight, float& maxError );
+
+					///	\brief	Scalar equivalent of SseTerrainGenerator::DisplaceVertices(), for a single lane
+					template < typename DisplaceType >
+					void DisplaceVertex( const DisplaceType& displacer, UTerrainVertex& vertex, const float* position, const float u, const float v ) const
+					{
+						float up[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+						displacer.GetUpVector( up[ 0 ], up[ 1 ], up[ 2 ] );
+
+						float origin[ 3 ] = { position[ 0 ], position[ 1 ], position[ 2 ] };
+						displacer.MapToDisplacementSpace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+						const float height = displacer.Displace( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+
+						//	Left, up, right and down neighbours
+						float neighbours[ 4 ][ 3 ] =
+						{
+							{ position[ 0 ] - m_ShiftRight[ 0 ], position[ 1 ] - m_ShiftRight[ 1 ], position[ 2 ] - m_ShiftRight[ 2 ] },
+							{ position[ 0 ] - m_ShiftDown[ 0 ], position[ 1 ] - m_ShiftDown[ 1 ], position[ 2 ] - m_ShiftDown[ 2 ] },
+							{ position[ 0 ] + m_ShiftRight[ 0 ], position[ 1 ] + m_ShiftRight[ 1 ], position[ 2 ] + m_ShiftRight[ 2 ] },
+							{ position[ 0 ] + m_ShiftDown[ 0 ], position[ 1 ] + m_ShiftDown[ 1 ], position[ 2 ] + m_ShiftDown[ 2 ] }
+						};
+						for ( int neighbour = 0; neighbour < 4; ++neighbour )
+						{
+							float* n = neighbours[ neighbour ];
+							displacer.MapToDisplacementSpace( n[ 0 ], n[ 1 ], n[ 2 ] );
+							displacer.Displace( n[ 0 ], n[ 1 ], n[ 2 ] );
+						}
+
+						//	DisplaceVertices() measures slope against the y axis, for all geometries
+						const float yAxis[ 3 ] = { 0, 1, 0 };
+						float normal[ 3 ];
+						const float slope = GetNormalAndSlope( origin, neighbours, yAxis, 0.3f, normal );
+						SetupVertex( vertex, origin, normal, slope, height, u, v );
+					}
+
+			}; //ScalarTerrainGenerator
+
+			//	-------------------------------------------------- ScalarTerrainGenerator Inline Methods
+
+			inline void ScalarTerrainGenerator::AssignCubeFaceShiftVectors( const UCubeMapFace face )
+			{
+				float xStep[ 3 ] = { 0, 0, 0 };
+				float yStep[ 3 ] = { 0, 0, 0 };
+				switch ( face )
+				{
+					case NegativeX	: xStep[ 2 ] = 1;	yStep[ 1 ] = -1;	break;
+					case PositiveX	: xStep[ 2 ] = -1;	yStep[ 1 ] = 1;		break;
+					case NegativeY	: xStep[ 0 ] = 1;	yStep[ 2 ] = 1;		break;
+					case PositiveY	: xStep[ 0 ] = 1;	yStep[ 2 ] = 1;		break;
+					case NegativeZ	: xStep[ 0 ] = 1;	yStep[ 1 ] = 1;		break;
+					case PositiveZ	: xStep[ 0 ] = -1;	yStep[ 1 ] = 1;		break;
+				}
+				AssignShiftVectors( xStep, yStep );
+			}
+
+			inline void ScalarTerrainGenerator::AssignShiftVectors( const float* xStep, const float* zStep )
+			{
+				UVector3 xStepVec( xStep );
+				UVector3 zStepVec( zStep );
+				xStepVec.SetLength( m_SmallestX );
+				zStepVec.SetLength( m_SmallestZ );
+
+				m_ShiftRight[ 0 ] = xStepVec.m_X;
+				m_ShiftRight[ 1 ] = xStepVec.m_Y;
+				m_ShiftRight[ 2 ] = xStepVec.m_Z;
+				m_ShiftDown[ 0 ] = zStepVec.m_X;
+				m_ShiftDown[ 1 ] = zStepVec.m_Y;
+				m_ShiftDown[ 2 ] = zStepVec.m_Z;
+			}
+
+			inline void ScalarTerrainGenerator::SetLaneStarts( float ( &starts )[ Lanes ][ 3 ], const float* origin, const float* xStep )
+			{
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					starts[ 0 ][ axis ] = origin[ axis ];
+					starts[ 1 ][ axis ] = origin[ axis ] + xStep[ axis ];
+					starts[ 2 ][ axis ] = origin[ axis ] + xStep[ axis ] * 2;
+					starts[ 3 ][ axis ] = origin[ axis ] + xStep[ axis ] * 3;
+				}
+			}
+
+			inline void ScalarTerrainGenerator::AddToLanes( float ( &positions )[ Lanes ][ 3 ], const float* increment )
+			{
+				for ( int lane = 0; lane < Lanes; ++lane )
+				{
+					positions[ lane ][ 0 ] += increment[ 0 ];
+					positions[ lane ][ 1 ] += increment[ 1 ];
+					positions[ lane ][ 2 ] += increment[ 2 ];
+				}
+			}
+
+			inline float ScalarTerrainGenerator::GetNormalAndSlope( const float* origin, float ( &neighbours )[ 4 ][ 3 ], const float* up, const float maxSlope, float* normal )
+			{
+				//	Move positions to the origin
+				for ( int neighbour = 0; neighbour < 4; ++neighbour )
+				{
+					neighbours[ neighbour ][ 0 ] -= origin[ 0 ];
+					neighbours[ neighbour ][ 1 ] -= origin[ 1 ];
+					neighbours[ neighbour ][ 2 ] -= origin[ 2 ];
+				}
+				const float* left = neighbours[ 0 ];
+				const float* above = neighbours[ 1 ];
+				const float* right = neighbours[ 2 ];
+				const float* below = neighbours[ 3 ];
+
+				ScalarGetCrossProduct( normal[ 0 ], normal[ 1 ], normal[ 2 ], above[ 0 ], above[ 1 ], above[ 2 ], left[ 0 ], left[ 1 ], left[ 2 ] );
+				ScalarAccumulateCrossProduct( normal[ 0 ], normal[ 1 ], normal[ 2 ], right[ 0 ], right[ 1 ], right[ 2 ], above[ 0 ], above[ 1 ], above[ 2 ] );
+				ScalarAccumulateCrossProduct( normal[ 0 ], normal[ 1 ], normal[ 2 ], below[ 0 ], below[ 1 ], below[ 2 ], right[ 0 ], right[ 1 ], right[ 2 ] );
+				ScalarAccumulateCrossProduct( normal[ 0 ], normal[ 1 ], normal[ 2 ], left[ 0 ], left[ 1 ], left[ 2 ], below[ 0 ], below[ 1 ], below[ 2 ] );
+				ScalarSetLength( normal[ 0 ], normal[ 1 ], normal[ 2 ], 1 );
+
+				//	NOTE: The SSE generators don't clamp slopes (the result of Clamp() is discarded)
+				return ( 1 - ScalarDot( normal[ 0 ], normal[ 1 ], normal[ 2 ], up[ 0 ], up[ 1 ], up[ 2 ] ) ) / maxSlope;
+			}
+
+			inline void ScalarTerrainGenerator::SetupVertex( UTerrainVertex& vertex, const float* position, const float* normal, const float slope, const float height, const float u, const float v )
+			{
+				vertex.SetPosition( position[ 0 ], position[ 1 ], position[ 2 ] );
+				vertex.SetNormal( normal[ 0 ], normal[ 1 ], normal[ 2 ] );
+				vertex.SetTerrainUv( u, v );
+				vertex.SetTerrainParameters( height, slope );
+			}
+
+			inline void ScalarTerrainGenerator::UpdateError( const float ( &heights )[ Lanes ], float& lastHeight, float& lastIntHeight, float& maxError )
+			{
+				const float estHeight0 = ( lastHeight + heights[ 0 ] ) / 2;
+				const float estHeight1 = ( heights[ 0 ] + heights[ 2 ] ) / 2;
+
+				const float error0 = fabsf( estHeight0 - lastIntHeight );
+				const float error1 = fabsf( estHeight1 - heights[ 1 ] );
+
+				lastHeight = heights[ 2 ];
+				lastIntHeight = heights[ 3 ];
+
+				const float bigError = error0 > error1 ? error0 : error1;
+				maxError = bigError > maxError ? bigError : maxError;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
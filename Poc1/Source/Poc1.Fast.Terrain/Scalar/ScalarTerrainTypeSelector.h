@@ -0,0 +1,141 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UTerrainTypeSelector.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Scalar reference implementation of UTerrainTypeSelector::WritePixels(), one pixel at a time
+			class ScalarTerrainTypeSelector
+			{
+				public :
+
+					ScalarTerrainTypeSelector( const UTerrainTypeSelector& selector ) :
+						m_Selector( selector )
+					{
+					}
+
+					///	\brief	Writes a pixel
+					void WritePixel( const UPixelFormat format, const float latitude, const float height, const float slope, unsigned char* pixel ) const;
+
+				private :
+
+					///	\brief	Cells either side of a value along an axis, and the 8-bit weight of the second cell
+					struct CellCoordinate
+					{
+						int m_Cell;
+						int m_Step;
+						int m_Weight;
+					};
+
+					const UTerrainTypeSelector& m_Selector;
+
+					///	\brief	Gets the cells either side of a value along an axis with a given number of cells
+					static CellCoordinate GetCellCoordinate( const float value, const int cells );
+
+					///	\brief	Blends two channel values, in the same way as UTerrainTypeSelector
+					static unsigned char Blend( const unsigned char a, const unsigned char b, const int weight );
+			};
+
+			//	--------------------------------------------- ScalarTerrainTypeSelector Inline Methods
+
+			inline void ScalarTerrainTypeSelector::WritePixel( const UPixelFormat format, const float latitude, const float height, const float slope, unsigned char* pixel ) const
+			{
+				const float values[ 3 ] = { latitude, height, slope };
+				CellCoordinate coordinates[ 3 ];
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					coordinates[ axis ] = GetCellCoordinate( values[ axis ], m_Selector.GetCells( UTerrainTypeSelector::Axis( axis ) ) );
+				}
+				const CellCoordinate& latitudeCell = coordinates[ UTerrainTypeSelector::LatitudeAxis ];
+				const CellCoordinate& heightCell = coordinates[ UTerrainTypeSelector::HeightAxis ];
+				const CellCoordinate& slopeCell = coordinates[ UTerrainTypeSelector::SlopeAxis ];
+
+				if ( GetBytesPerPixel( format ) == 1 )
+				{
+					pixel[ 0 ] = m_Selector.GetCellType
+						(
+							latitudeCell.m_Cell + ( latitudeCell.m_Weight >= 128 ? latitudeCell.m_Step : 0 ),
+							heightCell.m_Cell + ( heightCell.m_Weight >= 128 ? heightCell.m_Step : 0 ),
+							slopeCell.m_Cell + ( slopeCell.m_Weight >= 128 ? slopeCell.m_Step : 0 )
+						);
+					return;
+				}
+
+				//	Corners are numbered like UTerrainTypeSelector::WritePixels(), and blended in the same order
+				unsigned char channels[ 8 ][ 4 ];
+				for ( int corner = 0; corner < 8; ++corner )
+				{
+					const UColour colour = m_Selector.GetCellColour
+						(
+							latitudeCell.m_Cell + ( ( corner & 4 ) ? latitudeCell.m_Step : 0 ),
+							heightCell.m_Cell + ( ( corner & 2 ) ? heightCell.m_Step : 0 ),
+							slopeCell.m_Cell + ( ( corner & 1 ) ? slopeCell.m_Step : 0 )
+						);
+					channels[ corner ][ 0 ] = colour.R( );
+					channels[ corner ][ 1 ] = colour.G( );
+					channels[ corner ][ 2 ] = colour.B( );
+					channels[ corner ][ 3 ] = colour.A( );
+				}
+				for ( int channel = 0; channel < 4; ++channel )
+				{
+					for ( int corner = 0; corner < 4; ++corner )
+					{
+						channels[ corner ][ channel ] = Blend( channels[ corner * 2 ][ channel ], channels[ corner * 2 + 1 ][ channel ], slopeCell.m_Weight );
+					}
+					for ( int corner = 0; corner < 2; ++corner )
+					{
+						channels[ corner ][ channel ] = Blend( channels[ corner * 2 ][ channel ], channels[ corner * 2 + 1 ][ channel ], heightCell.m_Weight );
+					}
+					channels[ 0 ][ channel ] = Blend( channels[ 0 ][ channel ], channels[ 1 ][ channel ], latitudeCell.m_Weight );
+				}
+
+				const unsigned char* colour = channels[ 0 ];
+				switch ( format )
+				{
+					case FormatR8G8B8A8 :
+						pixel[ 0 ] = colour[ 0 ]; pixel[ 1 ] = colour[ 1 ]; pixel[ 2 ] = colour[ 2 ]; pixel[ 3 ] = colour[ 3 ];
+						break;
+					case FormatB8G8R8A8 :
+						pixel[ 0 ] = colour[ 2 ]; pixel[ 1 ] = colour[ 1 ]; pixel[ 2 ] = colour[ 0 ]; pixel[ 3 ] = colour[ 3 ];
+						break;
+					case FormatB8G8R8 :
+						pixel[ 0 ] = colour[ 2 ]; pixel[ 1 ] = colour[ 1 ]; pixel[ 2 ] = colour[ 0 ];
+						break;
+					default :
+						pixel[ 0 ] = colour[ 0 ]; pixel[ 1 ] = colour[ 1 ]; pixel[ 2 ] = colour[ 2 ];
+						break;
+				}
+			}
+
+			inline ScalarTerrainTypeSelector::CellCoordinate ScalarTerrainTypeSelector::GetCellCoordinate( const float value, const int cells )
+			{
+				//	Clamped in the same order as Clamp() (_mm_min_ps(), then _mm_max_ps()), so NaNs go to the last cell
+				const float lastCell = float( cells - 1 );
+				float position = value * lastCell;
+				position = position < lastCell ? position : lastCell;
+				position = position > 0 ? position : 0;
+
+				CellCoordinate coordinate;
+				coordinate.m_Cell = int( position );
+				coordinate.m_Weight = int( ( position - float( coordinate.m_Cell ) ) * 256 );
+				coordinate.m_Step = coordinate.m_Cell < ( cells - 1 ) ? 1 : 0;
+				return coordinate;
+			}
+
+			inline unsigned char ScalarTerrainTypeSelector::Blend( const unsigned char a, const unsigned char b, const int weight )
+			{
+				return ( unsigned char )( ( a * ( 256 - weight ) + b * weight ) >> 8 );
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -1,7 +1,8 @@
 #include "stdafx.h"
 #include "FractalTerrainParameters.h"
-#include "Sse\SseSimpleFractal.h"
-#include "Sse\SseRidgedFractal.h"
+#include "UTerrainGeneratorConfig.h"
+#include "Sse/SseSimpleFractal.h"
+#include "Sse/SseRidgedFractal.h"
 
 #pragma managed
 
@@ -43,6 +44,15 @@ namespace Poc1
 				fractal.Setup( Frequency, Lacunarity, Octaves );
 			}
 
+			void FractalTerrainParameters::GetConfig( UTerrainFunctionConfig& config )
+			{
+				TerrainFunctionParameters::GetConfig( config );
+				config.m_Seed = Seed;
+				config.m_Octaves = Octaves;
+				config.m_Frequency = Frequency;
+				config.m_Lacunarity = Lacunarity;
+			}
+
 		};
 	};
 };
\ No newline at end of file
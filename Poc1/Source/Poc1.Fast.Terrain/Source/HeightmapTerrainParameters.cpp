@@ -0,0 +1,40 @@
+#include "stdafx.h"
+#include "HeightmapTerrainParameters.h"
+#include "Sse/SseHeightmapFunction.h"
+
+#pragma managed
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+
+			HeightmapTerrainParameters::HeightmapTerrainParameters( )
+			{
+				m_Bicubic = false;
+				m_DetailAmplitude = 0;
+			}
+
+			void HeightmapTerrainParameters::Setup( SseHeightmapFunction& function )
+			{
+				if ( Path == nullptr )
+				{
+					throw gcnew System::InvalidOperationException( "No heightmap file was specified" );
+				}
+				System::IntPtr ansiPath = System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi( Path );
+				bool opened = function.Open( ( const char* )ansiPath.ToPointer( ) );
+				System::Runtime::InteropServices::Marshal::FreeHGlobal( ansiPath );
+				if ( !opened )
+				{
+					throw gcnew System::IO::IOException( System::String::Format( "Failed to open heightmap \"{0}\"", Path ) );
+				}
+				function.SetFilter( Bicubic ? SseHeightmapFunction::FilterBicubic : SseHeightmapFunction::FilterBilinear );
+				function.SetDetailAmplitude( DetailAmplitude );
+				FractalTerrainParameters::Setup( function.GetDetail( ) );
+			}
+
+		};
+	};
+};
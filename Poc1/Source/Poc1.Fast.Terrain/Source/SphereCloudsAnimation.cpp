@@ -0,0 +1,59 @@
+#include "StdAfx.h"
+#include "SphereCloudsAnimation.h"
+#include "USphereCloudsAnimation.h"
+#include "UBlockCompressor.h"
+#include "UMipChain.h"
+#include "UEnums.h"
+
+using namespace Rb::Rendering::Interfaces::Objects;
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			SphereCloudsAnimation::SphereCloudsAnimation( const int width, const int height, const int framesPerKey )
+			{
+				m_pImpl = new USphereCloudsAnimation( width, height, framesPerKey );
+			}
+
+			SphereCloudsAnimation::~SphereCloudsAnimation( )
+			{
+				delete m_pImpl;
+				m_pImpl = 0;
+			}
+
+			SphereCloudsAnimation::!SphereCloudsAnimation( )
+			{
+				delete m_pImpl;
+				m_pImpl = 0;
+			}
+
+			void SphereCloudsAnimation::Start( float xOffset, float zOffset, float xVelocity, float zVelocity, float cloudCutoff, float cloudBorder )
+			{
+				m_pImpl->Start( xOffset, zOffset, xVelocity, zVelocity, cloudCutoff, cloudBorder );
+			}
+
+			void SphereCloudsAnimation::Update( )
+			{
+				m_pImpl->Update( );
+			}
+
+			void SphereCloudsAnimation::GetFace( CubeMapFace face, PixelFormat format, const int stride, unsigned char* pixels )
+			{
+				m_pImpl->GetCloudsFace( GetUCubeMapFace( face ), GetUPixelFormat( format ), stride, pixels, 0, 0 );
+			}
+
+			void SphereCloudsAnimation::GetFace( CubeMapFace face, PixelFormat format, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides, unsigned char* blocks, const int blockRowStride )
+			{
+				const UPixelFormat uFormat = GetUPixelFormat( format );
+				const UMipChain mipChain = GetUMipChain( mipPixels, mipStrides );
+				const UBlockCompressor compressor( USphereCloudsBitmap::GetCompressedFormat( uFormat ), blocks, blockRowStride );
+				m_pImpl->GetCloudsFace( GetUCubeMapFace( face ), uFormat, stride, pixels, &mipChain, blocks ? &compressor : 0 );
+			}
+
+		}; //Terrain
+
+	}; //Fast
+}; //Poc1
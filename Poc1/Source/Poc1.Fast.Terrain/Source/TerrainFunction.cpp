@@ -1,9 +1,12 @@
 #include "stdafx.h"
 #include "TerrainFunction.h"
 #include "FractalTerrainParameters.h"
+#include "HeightmapTerrainParameters.h"
+#include "UTerrainGeneratorConfig.h"
 #include "Mem.h"
-#include "Sse\SseSphereTerrainGenerator.h"
-#include "Sse\SsePlaneTerrainGenerator.h"
+#include "Sse/SseSphereTerrainGenerator.h"
+#include "Sse/SsePlaneTerrainGenerator.h"
+#include "Sse/SseHeightmapFunction.h"
 
 ///	\page	Adding new terrain function types
 ///
@@ -14,6 +17,10 @@
 ///	4) Associate the function class and the parameters by overloading the FunctionTypes class (see TerrainFunction.cpp for details)
 ///	5) Add support for the new function in the switch statement of TerrainGeneratorFactory<>::Create()
 ///	6) Add support for the new function in the switch statement of CreateTerrainGenerator()
+///	7) Add to the UTerrainFunctionType enum, and store any new parameters in UTerrainFunctionConfig (see
+///		FractalTerrainParameters::GetConfig()), so recorded workloads can be replayed
+///	8) Add support for the new function to the replay tool factory (see Poc1.Fast.Replay/Source/ReplayFactory.cpp), if
+///		the configuration holds everything the function needs (heightmaps, for example, need their file)
 ///	Done!
 ///
 
@@ -25,6 +32,7 @@
 ///	3) Add to the TerrainGeometry enum
 ///	4) Associate the new geometry enum value with the displacer types using the GeometryTypes class (see TerrainFunction.cpp for details)
 ///	5) Add support for the new geometry type in the switch statements of CreateTerrainGenerator()
+///	6) Add to the UTerrainGeometry enum, and add support to the replay tool factory (see Poc1.Fast.Replay/Source/ReplayFactory.cpp)
 ///	Done!
 ///
 
@@ -59,11 +67,19 @@ namespace Poc1
 					typedef SseSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionClass > Type;
 				};
 
-				template < typename Displacer >
+				template < typename Displacer, typename Precision >
 				struct TerrainGenerator
 				{
-					typedef SseSphereTerrainGeneratorT< Displacer > Type;
+					typedef SseSphereTerrainGeneratorT< Displacer, Precision > Type;
 				};
+
+				///	\brief	Enables the ground field of a ground displacer, reduced for patches whose steps are small next to the finest wavelength of its function
+				template < typename Displacer >
+				static void SetupGroundField( Displacer& displacer, const float finestWavelength )
+				{
+					//	See SseSphereFunction3dGroundDisplacer::SetGroundField()
+					displacer.SetGroundField( true, finestWavelength * 0.25f );
+				}
 			};
 			
 			template < >
@@ -83,11 +99,17 @@ namespace Poc1
 					typedef SsePlaneFunction3dGroundDisplacer< BaseDisplacer, FunctionClass > Type;
 				};
 
-				template < typename Displacer >
+				template < typename Displacer, typename Precision >
 				struct TerrainGenerator
 				{
-					typedef SsePlaneTerrainGeneratorT< Displacer > Type;
+					typedef SsePlaneTerrainGeneratorT< Displacer, Precision > Type;
 				};
+
+				///	\brief	Plane ground displacers have no ground field
+				template < typename Displacer >
+				static void SetupGroundField( Displacer&, const float )
+				{
+				}
 			};
 
 			template < TerrainFunctionType FunctionType >
@@ -105,6 +127,11 @@ namespace Poc1
 			{
 				typedef SseSimpleFractal			ClassType;
 				typedef FractalTerrainParameters	ParametersType;
+
+				static float GetFinestWavelength( const ClassType& function )
+				{
+					return function.GetFinestWavelength( );
+				}
 			};
 			
 			template < >
@@ -112,14 +139,33 @@ namespace Poc1
 			{
 				typedef SseRidgedFractal			ClassType;
 				typedef FractalTerrainParameters	ParametersType;
+
+				static float GetFinestWavelength( const ClassType& function )
+				{
+					return function.GetFinestWavelength( );
+				}
+			};
+
+			template < >
+			struct FunctionTypes< TerrainFunctionType::Heightmap >
+			{
+				typedef SseHeightmapFunction		ClassType;
+				typedef HeightmapTerrainParameters	ParametersType;
+
+				static float GetFinestWavelength( const ClassType& )
+				{
+					//	Heightmaps are looked up by direction, so their texels have no fixed wavelength in function
+					//	space. The ground field is shared at every vertex, and never reduced
+					return 0;
+				}
 			};
 
-			template < TerrainGeometry Geometry >
+			template < TerrainGeometry Geometry, typename Precision >
 			struct TerrainGeneratorFactory : public GeometryTypes< Geometry >
 			{
 				static UTerrainGenerator* Create( )
 				{
-					return new ( Aligned( 16 ) ) TerrainGenerator< FlatDisplacer >::Type( );
+					return new ( Aligned( 16 ) ) TerrainGenerator< FlatDisplacer, Precision >::Type( );
 				}
 
 				template < TerrainFunctionType HeightFunctionType >
@@ -127,7 +173,7 @@ namespace Poc1
 				{
 					typedef FunctionTypes< HeightFunctionType >::ClassType HClass;
 					typedef FunctionTypes< HeightFunctionType >::ParametersType HParamsType;
-					typedef TerrainGenerator< HeightDisplacer< HClass >::Type >::Type GeneratorType;
+					typedef TerrainGenerator< HeightDisplacer< HClass >::Type, Precision >::Type GeneratorType;
 
 					GeneratorType* generator = new ( Aligned( 16 ) ) GeneratorType( );
 					
@@ -148,7 +194,7 @@ namespace Poc1
 
 					typedef HeightDisplacer< HClass >::Type HeightDisplacerType;
 					typedef GroundDisplacer< GClass, HeightDisplacerType >::Type GroundDisplacerType;
-					typedef TerrainGenerator< GroundDisplacerType >::Type GeneratorType;
+					typedef TerrainGenerator< GroundDisplacerType, Precision >::Type GeneratorType;
 
 					GeneratorType* generator = new ( Aligned( 16 ) ) GeneratorType( );
 
@@ -157,6 +203,7 @@ namespace Poc1
 
 					( ( HParamsType^ )heightParams )->Setup( generator->GetDisplacer( ).GetBaseDisplacer( ).GetFunction( ) );
 					( ( GParamsType^ )groundParams )->Setup( generator->GetDisplacer( ).GetFunction( ) );
+					SetupGroundField( generator->GetDisplacer( ), FunctionTypes< GroundFunctionType >::GetFinestWavelength( generator->GetDisplacer( ).GetFunction( ) ) );
 
 					return generator;
 				}
@@ -173,6 +220,7 @@ namespace Poc1
 						case TerrainFunctionType::Flat			: return Create< HeightFunctionType >( heightParams );
 						case TerrainFunctionType::SimpleFractal	: return Create< HeightFunctionType, TerrainFunctionType::SimpleFractal >( heightParams, groundFunction->Parameters );
 						case TerrainFunctionType::RidgedFractal	: return Create< HeightFunctionType, TerrainFunctionType::RidgedFractal >( heightParams, groundFunction->Parameters );
+						case TerrainFunctionType::Heightmap		: return Create< HeightFunctionType, TerrainFunctionType::Heightmap >( heightParams, groundFunction->Parameters );
 					}
 
 					throw gcnew System::NotSupportedException( "Unsupported ground function type" );
@@ -182,6 +230,7 @@ namespace Poc1
 			
 			//	---------------------------------------------------------------------------------------------
 
+			template < typename Precision >
 			UTerrainGenerator* CreateTerrainGenerator( TerrainGeometry geometry, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
 			{
 				TerrainFunctionType functionType = ( heightFunction == nullptr ) ? TerrainFunctionType::Flat : heightFunction->FunctionType;
@@ -190,30 +239,49 @@ namespace Poc1
 					case TerrainFunctionType::Flat :
 						switch ( geometry )
 						{
-							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere >::Create( );
-							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane >::Create( );
+							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere, Precision >::Create( );
+							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane, Precision >::Create( );
 						}
 						throw gcnew System::NotSupportedException( "Geometry type not supported for flat terrain" );
 
 					case TerrainFunctionType::SimpleFractal :
 						switch ( geometry )
 						{
-							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere >::Create< TerrainFunctionType::SimpleFractal >( heightFunction->Parameters, groundFunction );
-							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane >::Create< TerrainFunctionType::SimpleFractal >( heightFunction->Parameters, groundFunction );
+							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere, Precision >::Create< TerrainFunctionType::SimpleFractal >( heightFunction->Parameters, groundFunction );
+							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane, Precision >::Create< TerrainFunctionType::SimpleFractal >( heightFunction->Parameters, groundFunction );
 						}
 						throw gcnew System::NotSupportedException( "Geometry type not supported for simple fractals" );
 
 					case TerrainFunctionType::RidgedFractal	:
 						switch ( geometry )
 						{
-							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere >::Create< TerrainFunctionType::RidgedFractal >( heightFunction->Parameters, groundFunction );
-							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane >::Create< TerrainFunctionType::RidgedFractal >( heightFunction->Parameters, groundFunction );
+							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere, Precision >::Create< TerrainFunctionType::RidgedFractal >( heightFunction->Parameters, groundFunction );
+							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane, Precision >::Create< TerrainFunctionType::RidgedFractal >( heightFunction->Parameters, groundFunction );
 						}
 						throw gcnew System::NotSupportedException( "Geometry type not supported for ridged fractals" );
+
+					case TerrainFunctionType::Heightmap	:
+						switch ( geometry )
+						{
+							case TerrainGeometry::Sphere	: return TerrainGeneratorFactory< TerrainGeometry::Sphere, Precision >::Create< TerrainFunctionType::Heightmap >( heightFunction->Parameters, groundFunction );
+							case TerrainGeometry::Plane		: return TerrainGeneratorFactory< TerrainGeometry::Plane, Precision >::Create< TerrainFunctionType::Heightmap >( heightFunction->Parameters, groundFunction );
+						}
+						throw gcnew System::NotSupportedException( "Geometry type not supported for heightmaps" );
 				}
 				throw gcnew System::NotSupportedException( "Height function type not supported" );
 			}
 
+			UTerrainGenerator* CreateTerrainGenerator( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
+			{
+				switch ( precision )
+				{
+					case TerrainPrecision::Exact	: return CreateTerrainGenerator< SseExactPrecision >( geometry, heightFunction, groundFunction );
+					case TerrainPrecision::Fast		: return CreateTerrainGenerator< SseFastPrecision >( geometry, heightFunction, groundFunction );
+					case TerrainPrecision::Fastest	: return CreateTerrainGenerator< SseFastestPrecision >( geometry, heightFunction, groundFunction );
+				}
+				throw gcnew System::NotSupportedException( "Precision not supported" );
+			}
+
 			//	---------------------------------------------------------------------------------------------
 
 			//	---------------------------------------------------------------------------------------------
@@ -224,6 +292,12 @@ namespace Poc1
 				displacer.SetOutputScale( OutputScale );
 			}
 
+			void TerrainFunctionParameters::GetConfig( UTerrainFunctionConfig& config )
+			{
+				config.m_FunctionScale = FunctionScale;
+				config.m_OutputScale = OutputScale;
+			}
+
 			//	---------------------------------------------------------------------------------------------
 
 			//	---------------------------------------------------------------------------------------------
@@ -241,10 +315,25 @@ namespace Poc1
 				{
 					case TerrainFunctionType::SimpleFractal : return "Simple Fractal";
 					case TerrainFunctionType::RidgedFractal : return "Ridged Fractal";
+					case TerrainFunctionType::Heightmap		: return "Heightmap";
 				}
 				throw gcnew System::NotImplementedException( );
 			}
 
+			void TerrainFunction::GetConfig( TerrainFunction^ function, UTerrainFunctionConfig& config )
+			{
+				config.Reset( );
+				if ( function == nullptr )
+				{
+					return;
+				}
+				config.m_FunctionType = ( int )function->FunctionType;
+				if ( function->Parameters != nullptr )
+				{
+					function->Parameters->GetConfig( config );
+				}
+			}
+
 			TerrainFunctionParameters^ TerrainFunction::CreateParameters( TerrainFunctionType functionType )
 			{
 				switch ( functionType )
@@ -252,6 +341,7 @@ namespace Poc1
 					case TerrainFunctionType::Flat			: return nullptr;
 					case TerrainFunctionType::SimpleFractal	: return gcnew FractalTerrainParameters( );
 					case TerrainFunctionType::RidgedFractal	: return gcnew FractalTerrainParameters( );
+					case TerrainFunctionType::Heightmap		: return gcnew HeightmapTerrainParameters( );
 				}
 				throw gcnew System::NotImplementedException( );
 			}
@@ -262,7 +352,7 @@ namespace Poc1
 				{
 					throw gcnew System::ArgumentNullException( "heightFunction" );
 				}
-				return CreateTerrainGenerator( geometry, heightFunction, nullptr );
+				return CreateTerrainGenerator( geometry, TerrainPrecision::Exact, heightFunction, nullptr );
 			}
 
 			UTerrainGenerator* TerrainFunction::CreateGenerator( TerrainGeometry geometry, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
@@ -277,9 +367,18 @@ namespace Poc1
 				}
 				if ( groundFunction == nullptr )
 				{
-					return CreateTerrainGenerator( geometry, heightFunction, nullptr );
+					return CreateTerrainGenerator( geometry, TerrainPrecision::Exact, heightFunction, nullptr );
+				}
+				return CreateTerrainGenerator( geometry, TerrainPrecision::Exact, heightFunction, groundFunction );
+			}
+
+			UTerrainGenerator* TerrainFunction::CreateGenerator( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
+			{
+				if ( heightFunction == nullptr )
+				{
+					throw gcnew System::ArgumentNullException( "heightFunction" );
 				}
-				return CreateTerrainGenerator( geometry, heightFunction, groundFunction );
+				return CreateTerrainGenerator( geometry, precision, heightFunction, groundFunction );
 			}
 			
 			//	---------------------------------------------------------------------------------------------
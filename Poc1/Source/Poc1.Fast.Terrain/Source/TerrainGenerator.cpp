@@ -1,7 +1,13 @@
 #include "StdAfx.h"
 #include "Mem.h"
 #include "TerrainGenerator.h"
+#include "TerrainTypeSelector.h"
+#include "UBlockCompressor.h"
+#include "UCubeMapSeams.h"
+#include "UMipChain.h"
 #include "UTerrainGenerator.h"
+#include "UTerrainRecorder.h"
+#include "UTerrainTypeSelector.h"
 #include "UEnums.h"
 #include "Sse/SseTerrainDisplacer.h"
 
@@ -54,36 +60,94 @@ namespace Poc1
 				}
 				*/
 				m_pImpl = TerrainFunction::CreateGenerator( geometry, heightFunction );
+				SetConfig( geometry, TerrainPrecision::Exact, heightFunction, nullptr );
 			}
 
 			TerrainGenerator::TerrainGenerator( TerrainGeometry geometry, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
 			{
 				m_pImpl = TerrainFunction::CreateGenerator( geometry, heightFunction, groundFunction );
+				SetConfig( geometry, TerrainPrecision::Exact, heightFunction, groundFunction );
+			}
+
+			TerrainGenerator::TerrainGenerator( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
+			{
+				m_pImpl = TerrainFunction::CreateGenerator( geometry, precision, heightFunction, groundFunction );
+				SetConfig( geometry, precision, heightFunction, groundFunction );
 			}
 
 			TerrainGenerator::!TerrainGenerator( )
 			{
 				AlignedDelete( m_pImpl );
+				delete m_pConfig;
 			}
 
 			TerrainGenerator::~TerrainGenerator( )
 			{
 				AlignedDelete( m_pImpl );
+				delete m_pConfig;
 			}
 
 			void TerrainGenerator::SetSmallestStepSize( const float x, const float z )
 			{
 				m_pImpl->SetSmallestStepSize( x, z );
+				m_pConfig->m_SmallestX = x;
+				m_pConfig->m_SmallestZ = z;
+			}
+
+			void TerrainGenerator::SetCubeMapProjection( CubeMapProjection projection )
+			{
+				m_pImpl->SetCubeMapProjection( UCubeMapProjection( projection ) );
 			}
 
 			void TerrainGenerator::Setup( const float patchScale, const float minHeight, const float maxHeight )
 			{
 				m_pImpl->GetBaseDisplacer( ).Setup( patchScale, minHeight, maxHeight );
+				m_pConfig->m_IsSetup = 1;
+				m_pConfig->m_PatchScale = patchScale;
+				m_pConfig->m_MinHeight = minHeight;
+				m_pConfig->m_MaxHeight = maxHeight;
 			}
 
 			void TerrainGenerator::GenerateTerrainPropertyCubeMapFace( const CubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels )
 			{
-				m_pImpl->GenerateTerrainPropertyCubeMapFace( GetUCubeMapFace( face ), width,  height, stride, pixels );
+				m_pImpl->GenerateTerrainPropertyCubeMapFace( GetUCubeMapFace( face ), width,  height, stride, pixels, 0, 0 );
+			}
+
+			void TerrainGenerator::GenerateTerrainPropertyCubeMapFace( const CubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides, unsigned char* blocks, const int blockRowStride )
+			{
+				const UMipChain mipChain = GetUMipChain( mipPixels, mipStrides );
+				const UBlockCompressor compressor( UBlockCompressor::Bc5, blocks, blockRowStride );
+				m_pImpl->GenerateTerrainPropertyCubeMapFace( GetUCubeMapFace( face ), width,  height, stride, pixels, &mipChain, blocks ? &compressor : 0 );
+			}
+
+			void TerrainGenerator::GenerateTerrainPropertyCubeMap( const int size, const int stride, array< System::IntPtr >^ facePixels )
+			{
+				if ( ( size < 4 ) || ( ( size % 4 ) != 0 ) )
+				{
+					throw gcnew System::ArgumentException( "Cube map size must be a multiple of 4, and at least 4", "size" );
+				}
+				unsigned char* uFacePixels[ 6 ];
+				GetUCubeMapFacePixels( facePixels, uFacePixels );
+				m_pImpl->GenerateTerrainPropertyCubeMap( size, stride, uFacePixels, 0, 0 );
+			}
+
+			void TerrainGenerator::GenerateTerrainTypeCubeMapFace( const CubeMapFace face, TerrainTypeSelector^ selector, PixelFormat format, const int width, const int height, const int stride, unsigned char* pixels )
+			{
+				if ( selector == nullptr )
+				{
+					throw gcnew System::ArgumentNullException( "selector" );
+				}
+				m_pImpl->GenerateTerrainTypeCubeMapFace( GetUCubeMapFace( face ), selector->GetImpl( ), GetUPixelFormat( format ), width, height, stride, pixels, 0 );
+			}
+
+			void TerrainGenerator::GenerateTerrainTypeCubeMapFace( const CubeMapFace face, TerrainTypeSelector^ selector, PixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides )
+			{
+				if ( selector == nullptr )
+				{
+					throw gcnew System::ArgumentNullException( "selector" );
+				}
+				const UMipChain mipChain = GetUMipChain( mipPixels, mipStrides );
+				m_pImpl->GenerateTerrainTypeCubeMapFace( GetUCubeMapFace( face ), selector->GetImpl( ), GetUPixelFormat( format ), width, height, stride, pixels, &mipChain );
 			}
 
 			void TerrainGenerator::GenerateVertices( Point3^ origin, Vector3^ xStep, Vector3^ zStep, const int width, const int height, Point2^ uv, float uvRes, void* vertices )
@@ -93,7 +157,12 @@ namespace Poc1
 				float zStepArr[] = { zStep->X, zStep->Y, zStep->Z };
 				float uvArr[] = { uv->X, uv->Y };
 
+				const long long startTicks = UTerrainRecorder::IsRecording( ) ? Instrumentation::GetTicks( ) : 0;
 				m_pImpl->GenerateVertices( originArr, xStepArr, zStepArr, width, height, uvArr, uvRes, ( UTerrainVertex* )vertices );
+				if ( UTerrainRecorder::IsRecording( ) )
+				{
+					RecordCall( startTicks, 0, originArr, xStepArr, zStepArr, width, height, uvArr, uvRes );
+				}
 			}
 
 			void TerrainGenerator::GenerateVertices( Point3^ origin, Vector3^ xStep, Vector3^ zStep, const int width, const int height, Point2^ uv, float uvRes, void* vertices, [System::Runtime::InteropServices::Out]float% error )
@@ -103,10 +172,63 @@ namespace Poc1
 				float zStepArr[] = { zStep->X, zStep->Y, zStep->Z };
 				float uvArr[] = { uv->X, uv->Y };
 
+				//	The error generator modifies the step vectors, so the recorded call needs the originals
+				float originalXStep[] = { xStep->X, xStep->Y, xStep->Z };
+				float originalZStep[] = { zStep->X, zStep->Y, zStep->Z };
+
 				float err;
+				const long long startTicks = UTerrainRecorder::IsRecording( ) ? Instrumentation::GetTicks( ) : 0;
 				m_pImpl->GenerateVertices( originArr, xStepArr, zStepArr, width, height, uvArr, uvRes, ( UTerrainVertex* )vertices, err );
+				if ( UTerrainRecorder::IsRecording( ) )
+				{
+					RecordCall( startTicks, UTerrainGenerationCall::CallError, originArr, originalXStep, originalZStep, width, height, uvArr, uvRes );
+				}
 				error = err;
 			}
+
+			void TerrainGenerator::GetPatchHeightBounds( Point3^ origin, Vector3^ xStep, Vector3^ zStep, const int width, const int height, [System::Runtime::InteropServices::Out]float% minHeight, [System::Runtime::InteropServices::Out]float% maxHeight )
+			{
+				float originArr[] = { origin->X, origin->Y, origin->Z };
+				float xStepArr[] = { xStep->X, xStep->Y, xStep->Z };
+				float zStepArr[] = { zStep->X, zStep->Y, zStep->Z };
+
+				float minH, maxH;
+				m_pImpl->GetPatchHeightBounds( originArr, xStepArr, zStepArr, width, height, minH, maxH );
+				minHeight = minH;
+				maxHeight = maxH;
+			}
+
+			void TerrainGenerator::SetConfig( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction )
+			{
+				m_pConfig = new UTerrainGeneratorConfig;
+				m_pConfig->Reset( );
+				m_pConfig->m_Geometry = ( int )geometry;
+				m_pConfig->m_Precision = ( int )precision;
+				TerrainFunction::GetConfig( heightFunction, m_pConfig->m_Height );
+				TerrainFunction::GetConfig( groundFunction, m_pConfig->m_Ground );
+			}
+
+			void TerrainGenerator::RecordCall( const long long startTicks, const int flags, const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, const float uvRes )
+			{
+				UTerrainGenerationCall call;
+				call.m_StartTicks = startTicks;
+				call.m_DurationTicks = Instrumentation::GetTicks( ) - startTicks;
+				call.m_ConfigHash = m_pConfig->GetHash( );
+				call.m_Flags = flags;
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					call.m_Origin[ axis ] = origin[ axis ];
+					call.m_XStep[ axis ] = xStep[ axis ];
+					call.m_ZStep[ axis ] = zStep[ axis ];
+				}
+				call.m_Width = width;
+				call.m_Height = height;
+				call.m_Uv[ 0 ] = uv[ 0 ];
+				call.m_Uv[ 1 ] = uv[ 1 ];
+				call.m_UvRes = uvRes;
+
+				UTerrainRecorder::Record( *m_pConfig, call );
+			}
 			
 			//	-----------------------------------------------------------------------------------
 		}; //Fast
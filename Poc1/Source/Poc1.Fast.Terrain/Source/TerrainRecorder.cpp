@@ -0,0 +1,32 @@
+#include "StdAfx.h"
+#include "TerrainRecorder.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			void TerrainRecorder::Start( System::String^ path )
+			{
+				if ( path == nullptr )
+				{
+					throw gcnew System::ArgumentNullException( "path" );
+				}
+				System::IntPtr ansiPath = System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi( path );
+				bool started = UTerrainRecorder::Start( ( const char* )ansiPath.ToPointer( ) );
+				System::Runtime::InteropServices::Marshal::FreeHGlobal( ansiPath );
+				if ( !started )
+				{
+					throw gcnew System::IO::IOException( System::String::Format( "Failed to open terrain recording \"{0}\"", path ) );
+				}
+			}
+
+			void TerrainRecorder::Stop( )
+			{
+				UTerrainRecorder::Stop( );
+			}
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
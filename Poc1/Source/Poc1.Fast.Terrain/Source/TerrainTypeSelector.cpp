@@ -0,0 +1,58 @@
+#include "StdAfx.h"
+#include "TerrainTypeSelector.h"
+#include "UTerrainTypeSelector.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			TerrainTypeSelector::TerrainTypeSelector( )
+			{
+				m_pImpl = new UTerrainTypeSelector;
+			}
+
+			TerrainTypeSelector::~TerrainTypeSelector( )
+			{
+				delete m_pImpl;
+				m_pImpl = 0;
+			}
+
+			TerrainTypeSelector::!TerrainTypeSelector( )
+			{
+				delete m_pImpl;
+				m_pImpl = 0;
+			}
+
+			void TerrainTypeSelector::SetSize( int latitudes, int heights, int slopes )
+			{
+				m_pImpl->SetSize( latitudes, heights, slopes );
+			}
+
+			void TerrainTypeSelector::SetCell( int latitude, int height, int slope, System::Drawing::Color colour, int type )
+			{
+				if ( ( latitude < 0 ) || ( latitude >= m_pImpl->GetCells( UTerrainTypeSelector::LatitudeAxis ) ) )
+				{
+					throw gcnew System::ArgumentOutOfRangeException( "latitude" );
+				}
+				if ( ( height < 0 ) || ( height >= m_pImpl->GetCells( UTerrainTypeSelector::HeightAxis ) ) )
+				{
+					throw gcnew System::ArgumentOutOfRangeException( "height" );
+				}
+				if ( ( slope < 0 ) || ( slope >= m_pImpl->GetCells( UTerrainTypeSelector::SlopeAxis ) ) )
+				{
+					throw gcnew System::ArgumentOutOfRangeException( "slope" );
+				}
+				m_pImpl->SetCell( latitude, height, slope, UColour( colour.R, colour.G, colour.B, colour.A ), ( unsigned char )type );
+			}
+
+			const UTerrainTypeSelector& TerrainTypeSelector::GetImpl( )
+			{
+				return *m_pImpl;
+			}
+
+		}; //Terrain
+
+	}; //Fast
+}; //Poc1
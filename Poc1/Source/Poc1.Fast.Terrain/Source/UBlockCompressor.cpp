@@ -0,0 +1,242 @@
+#include "Stdafx.h"
+#include "UBlockCompressor.h"
+
+#include <Sse/SseUtils.h>
+
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Gets the smallest and largest of 16 bytes
+			inline void GetRange( const __m128i& values, int& minValue, int& maxValue )
+			{
+				__m128i minValues = _mm_min_epu8( values, _mm_srli_si128( values, 8 ) );
+				__m128i maxValues = _mm_max_epu8( values, _mm_srli_si128( values, 8 ) );
+				minValues = _mm_min_epu8( minValues, _mm_srli_si128( minValues, 4 ) );
+				maxValues = _mm_max_epu8( maxValues, _mm_srli_si128( maxValues, 4 ) );
+				minValues = _mm_min_epu8( minValues, _mm_srli_si128( minValues, 2 ) );
+				maxValues = _mm_max_epu8( maxValues, _mm_srli_si128( maxValues, 2 ) );
+				minValues = _mm_min_epu8( minValues, _mm_srli_si128( minValues, 1 ) );
+				maxValues = _mm_max_epu8( maxValues, _mm_srli_si128( maxValues, 1 ) );
+				minValue = _mm_cvtsi128_si32( minValues ) & 0xff;
+				maxValue = _mm_cvtsi128_si32( maxValues ) & 0xff;
+			}
+
+			///	\brief	Gets the positions of 8 values between the ends of a range, from 0 (minimum) to 7 (maximum)
+			///
+			///	The position is round( 7 * ( value - min ) / range ), rounding halves up. It is counted exactly, without
+			///	a division, as the number of thresholds ( 2k - 1 ) * range (k = 1 to 7) that ( value - min ) * 14 reaches.
+			///
+			inline __m128i GetRangePositions( const __m128i& values16, const __m128i& min16, const __m128i* thresholds16 )
+			{
+				const __m128i scaled = _mm_mullo_epi16( _mm_sub_epi16( values16, min16 ), _mm_set1_epi16( 14 ) );
+				__m128i positions = _mm_setzero_si128( );
+				for ( int threshold = 0; threshold < 7; ++threshold )
+				{
+					positions = _mm_sub_epi16( positions, _mm_cmpgt_epi16( scaled, thresholds16[ threshold ] ) );
+				}
+				return positions;
+			}
+
+			///	\brief	Encodes 16 values (in texel order) as a BC4 block
+			///
+			///	The endpoints are the largest and smallest values, in that order, so the block uses the 8 value palette.
+			///	Each value gets the palette entry nearest to it.
+			///
+			inline void EncodeBc4Block( const __m128i& values, unsigned char* block )
+			{
+				int minValue, maxValue;
+				GetRange( values, minValue, maxValue );
+				block[ 0 ] = ( unsigned char )maxValue;
+				block[ 1 ] = ( unsigned char )minValue;
+				if ( minValue == maxValue )
+				{
+					memset( block + 2, 0, 6 );
+					return;
+				}
+
+				//	Thresholds are one less than ( 2k - 1 ) * range, for signed greater-than compares
+				const int range = maxValue - minValue;
+				__m128i thresholds16[ 7 ];
+				for ( int threshold = 0; threshold < 7; ++threshold )
+				{
+					thresholds16[ threshold ] = _mm_set1_epi16( short( ( threshold * 2 + 1 ) * range - 1 ) );
+				}
+				const __m128i zero = _mm_setzero_si128( );
+				const __m128i min16 = _mm_set1_epi16( short( minValue ) );
+				const __m128i positions = _mm_packus_epi16
+					(
+						GetRangePositions( _mm_unpacklo_epi8( values, zero ), min16, thresholds16 ),
+						GetRangePositions( _mm_unpackhi_epi8( values, zero ), min16, thresholds16 )
+					);
+
+				//	Palette entry 0 is the maximum (position 7), entry 1 the minimum (position 0), and entries 2-7 run
+				//	from position 6 down to position 1. ( 8 - position ) & 7 gets every entry but the ends, which are swapped
+				const __m128i ends = _mm_or_si128( _mm_cmpeq_epi8( positions, zero ), _mm_cmpeq_epi8( positions, _mm_set1_epi8( 7 ) ) );
+				const __m128i indices = _mm_xor_si128
+					(
+						_mm_and_si128( _mm_sub_epi8( _mm_set1_epi8( 8 ), positions ), _mm_set1_epi8( 7 ) ),
+						_mm_and_si128( ends, _mm_set1_epi8( 1 ) )
+					);
+
+				//	Pack the 3-bit indices: pairs into 16-bit lanes, then quads into 32-bit lanes, then 8 indices into the low
+				//	24 bits of each 64-bit lane
+				const __m128i pairs = _mm_add_epi16( _mm_and_si128( indices, _mm_set1_epi16( 0x00ff ) ), _mm_slli_epi16( _mm_srli_epi16( indices, 8 ), 3 ) );
+				const __m128i quads = _mm_madd_epi16( pairs, _mm_set1_epi32( 0x00400001 ) );
+				const __m128i octets = _mm_or_si128( quads, _mm_srli_epi64( quads, 20 ) );
+				const unsigned int low = ( unsigned int )_mm_cvtsi128_si32( octets ) & 0xffffff;
+				const unsigned int high = ( unsigned int )_mm_cvtsi128_si32( _mm_srli_si128( octets, 8 ) ) & 0xffffff;
+				block[ 2 ] = ( unsigned char )low;
+				block[ 3 ] = ( unsigned char )( low >> 8 );
+				block[ 4 ] = ( unsigned char )( low >> 16 );
+				block[ 5 ] = ( unsigned char )high;
+				block[ 6 ] = ( unsigned char )( high >> 8 );
+				block[ 7 ] = ( unsigned char )( high >> 16 );
+			}
+
+			///	\brief	Converts an 8-bit colour to a 5:6:5 colour
+			inline int GetColour565( const int red, const int green, const int blue )
+			{
+				return ( ( ( red * 31 + 127 ) / 255 ) << 11 ) | ( ( ( green * 63 + 127 ) / 255 ) << 5 ) | ( ( blue * 31 + 127 ) / 255 );
+			}
+
+			///	\brief	Encodes 16 colours (in texel order) as a BC1 colour block, in 4 colour mode
+			///
+			///	The endpoints are the corners of the bounding box of the colours, largest first. Each colour is projected
+			///	onto the box diagonal, and gets the nearest of the 4 palette entries along it.
+			///
+			inline void EncodeColourBlock( const __m128i& reds, const __m128i& greens, const __m128i& blues, unsigned char* block )
+			{
+				int minColour[ 3 ], maxColour[ 3 ];
+				GetRange( reds, minColour[ 0 ], maxColour[ 0 ] );
+				GetRange( greens, minColour[ 1 ], maxColour[ 1 ] );
+				GetRange( blues, minColour[ 2 ], maxColour[ 2 ] );
+
+				const int colour0 = GetColour565( maxColour[ 0 ], maxColour[ 1 ], maxColour[ 2 ] );
+				const int colour1 = GetColour565( minColour[ 0 ], minColour[ 1 ], minColour[ 2 ] );
+				unsigned int indices = 0;
+				if ( colour0 != colour1 )
+				{
+					FAST_ALIGN( 16 ) unsigned char texels[ 3 ][ 16 ];
+					_mm_store_si128( ( __m128i* )texels[ 0 ], reds );
+					_mm_store_si128( ( __m128i* )texels[ 1 ], greens );
+					_mm_store_si128( ( __m128i* )texels[ 2 ], blues );
+
+					const int axis[ 3 ] = { maxColour[ 0 ] - minColour[ 0 ], maxColour[ 1 ] - minColour[ 1 ], maxColour[ 2 ] - minColour[ 2 ] };
+					const int sqrLength = axis[ 0 ] * axis[ 0 ] + axis[ 1 ] * axis[ 1 ] + axis[ 2 ] * axis[ 2 ];
+
+					//	Palette entries by position along the axis, from the minimum (position 0) to the maximum (position 3)
+					static const unsigned int PositionIndices[ 4 ] = { 1, 3, 2, 0 };
+					for ( int texel = 0; texel < 16; ++texel )
+					{
+						int distance = 0;
+						for ( int channel = 0; channel < 3; ++channel )
+						{
+							distance += ( texels[ channel ][ texel ] - minColour[ channel ] ) * axis[ channel ];
+						}
+						const int position = ( distance * 6 + sqrLength ) / ( sqrLength * 2 );
+						indices |= PositionIndices[ position ] << ( texel * 2 );
+					}
+				}
+
+				block[ 0 ] = ( unsigned char )colour0;
+				block[ 1 ] = ( unsigned char )( colour0 >> 8 );
+				block[ 2 ] = ( unsigned char )colour1;
+				block[ 3 ] = ( unsigned char )( colour1 >> 8 );
+				block[ 4 ] = ( unsigned char )indices;
+				block[ 5 ] = ( unsigned char )( indices >> 8 );
+				block[ 6 ] = ( unsigned char )( indices >> 16 );
+				block[ 7 ] = ( unsigned char )( indices >> 24 );
+			}
+
+			///	\brief	Gathers a channel of the 16 texels of a block, in texel order. Missing channels get a fill value
+			inline __m128i GatherChannel( const UPixelChannels& channels, const UPixelChannels::Channel channel, const unsigned char fill, const unsigned char* const* rows, const int* columns )
+			{
+				const int offset = channels.GetOffset( channel );
+				if ( offset < 0 )
+				{
+					return _mm_set1_epi8( char( fill ) );
+				}
+
+				const int bytesPerPixel = channels.GetBytesPerPixel( );
+				FAST_ALIGN( 16 ) unsigned char values[ 16 ];
+				for ( int row = 0; row < 4; ++row )
+				{
+					const unsigned char* rowChannel = rows[ row ] + offset;
+					for ( int col = 0; col < 4; ++col )
+					{
+						values[ row * 4 + col ] = rowChannel[ columns[ col ] * bytesPerPixel ];
+					}
+				}
+				return _mm_load_si128( ( const __m128i* )values );
+			}
+
+			//	----------------------------------------------------------- UBlockCompressor Methods
+
+			void UBlockCompressor::WriteRow( const UPixelChannels& channels, const int width, const int height, const unsigned char* pixels, const int stride, const int row ) const
+			{
+				//	A row of blocks is compressed once its last row has been written. The last rows of a face whose
+				//	height isn't a multiple of 4 are repeated
+				if ( ( ( row & 3 ) != 3 ) && ( row != height - 1 ) )
+				{
+					return;
+				}
+				const int firstRow = row & ~3;
+				const unsigned char* rows[ 4 ];
+				for ( int blockRow = 0; blockRow < 4; ++blockRow )
+				{
+					const int pixelRow = firstRow + blockRow;
+					rows[ blockRow ] = pixels + ( pixelRow < row ? pixelRow : row ) * stride;
+				}
+				CompressBlockRow( m_Format, channels, width, rows, m_Blocks + ( row / 4 ) * m_BlockRowStride );
+			}
+
+			void UBlockCompressor::CompressBlockRow( const Format format, const UPixelChannels& channels, const int width, const unsigned char* const* rows, unsigned char* blocks )
+			{
+				const int blockSize = GetBlockSize( format );
+				const UPixelChannels::Channel bc4Channel = channels.GetOffset( UPixelChannels::Red ) >= 0 ? UPixelChannels::Red : UPixelChannels::Alpha;
+				unsigned char* block = blocks;
+				for ( int firstColumn = 0; firstColumn < width; firstColumn += 4, block += blockSize )
+				{
+					int columns[ 4 ];
+					for ( int col = 0; col < 4; ++col )
+					{
+						columns[ col ] = firstColumn + col < width ? firstColumn + col : width - 1;
+					}
+
+					switch ( format )
+					{
+						case Bc4 :
+							EncodeBc4Block( GatherChannel( channels, bc4Channel, 0, rows, columns ), block );
+							break;
+
+						case Bc5 :
+							EncodeBc4Block( GatherChannel( channels, UPixelChannels::Red, 0, rows, columns ), block );
+							EncodeBc4Block( GatherChannel( channels, UPixelChannels::Green, 0, rows, columns ), block + 8 );
+							break;
+
+						case Bc3 :
+							EncodeBc4Block( GatherChannel( channels, UPixelChannels::Alpha, 0xff, rows, columns ), block );
+							EncodeColourBlock
+								(
+									GatherChannel( channels, UPixelChannels::Red, 0, rows, columns ),
+									GatherChannel( channels, UPixelChannels::Green, 0, rows, columns ),
+									GatherChannel( channels, UPixelChannels::Blue, 0, rows, columns ),
+									block + 8
+								);
+							break;
+					};
+				}
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
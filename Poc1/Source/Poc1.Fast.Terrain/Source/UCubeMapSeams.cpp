@@ -0,0 +1,183 @@
+#include "Stdafx.h"
+#include "UCubeMapSeams.h"
+
+#include <Mem.h>
+
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	The face and side on the other side of each side of each face, from CubeFacePosition()
+			static const int CubeMapNeighbours[ 6 ][ 4 ][ 2 ] =
+			{
+				{ { NegativeY, UCubeMapSeams::Right }, { PositiveZ, UCubeMapSeams::Left }, { PositiveY, UCubeMapSeams::Right }, { NegativeZ, UCubeMapSeams::Right } },	//	NegativeX
+				{ { NegativeY, UCubeMapSeams::Left }, { NegativeZ, UCubeMapSeams::Left }, { PositiveY, UCubeMapSeams::Left }, { PositiveZ, UCubeMapSeams::Right } },	//	PositiveX
+				{ { PositiveZ, UCubeMapSeams::Top }, { NegativeX, UCubeMapSeams::Top }, { NegativeZ, UCubeMapSeams::Top }, { PositiveX, UCubeMapSeams::Top } },			//	NegativeY
+				{ { NegativeZ, UCubeMapSeams::Bottom }, { NegativeX, UCubeMapSeams::Bottom }, { PositiveZ, UCubeMapSeams::Bottom }, { PositiveX, UCubeMapSeams::Bottom } },	//	PositiveY
+				{ { NegativeY, UCubeMapSeams::Bottom }, { NegativeX, UCubeMapSeams::Left }, { PositiveY, UCubeMapSeams::Top }, { PositiveX, UCubeMapSeams::Right } },	//	NegativeZ
+				{ { NegativeY, UCubeMapSeams::Top }, { PositiveX, UCubeMapSeams::Left }, { PositiveY, UCubeMapSeams::Bottom }, { NegativeX, UCubeMapSeams::Right } }		//	PositiveZ
+			};
+
+			//	---------------------------------------------------------- UCubeMapSeams Methods
+
+			UCubeMapSeams::UCubeMapSeams( ) :
+				m_Size( 0 ),
+				m_RingRows( 0 ),
+				m_RingColumns( 0 ),
+				m_EdgeValues( 0 )
+			{
+			}
+
+			UCubeMapSeams::~UCubeMapSeams( )
+			{
+				AlignedArrayDelete( m_RingRows );
+				AlignedArrayDelete( m_RingColumns );
+				AlignedArrayDelete( m_EdgeValues );
+			}
+
+			void UCubeMapSeams::SetSize( const int size )
+			{
+				if ( size == m_Size )
+				{
+					return;
+				}
+				AlignedArrayDelete( m_RingRows );
+				AlignedArrayDelete( m_RingColumns );
+				AlignedArrayDelete( m_EdgeValues );
+
+				//	6 faces, with 4 ring rows and 4 ring columns of 4 planes each, and 4 sides of 3 edge values each
+				m_Size = size;
+				const int ringRowFloats = 6 * 4 * 4 * GetRowLineSize( );
+				m_RingRows = new ( Aligned( 16 ) ) float[ ringRowFloats ];
+				m_RingColumns = new ( Aligned( 16 ) ) float[ 6 * 4 * 4 * size ];
+				m_EdgeValues = new ( Aligned( 16 ) ) float[ 6 * 4 * 3 * size ];
+
+				//	Row padding is read as the neighbours of the first and last columns, which are then replaced by edge values
+				memset( m_RingRows, 0, ringRowFloats * sizeof( float ) );
+			}
+
+			void UCubeMapSeams::GetNeighbour( const UCubeMapFace face, const Side side, UCubeMapFace& neighbourFace, Side& neighbourSide )
+			{
+				neighbourFace = UCubeMapFace( CubeMapNeighbours[ face ][ side ][ 0 ] );
+				neighbourSide = Side( CubeMapNeighbours[ face ][ side ][ 1 ] );
+			}
+
+			bool UCubeMapSeams::OwnsEdge( const UCubeMapFace face, const Side side )
+			{
+				return int( face ) < CubeMapNeighbours[ face ][ side ][ 0 ];
+			}
+
+			void UCubeMapSeams::GetCornerOwner( const UCubeMapFace face, const Side side, UCubeMapFace& ownerFace, Side& ownerSide )
+			{
+				//	The corner at the start of a side is at the end of the neighbour's side, and at the start of the
+				//	neighbour's side across the previous side of the face
+				UCubeMapFace nextFace, previousFace;
+				Side nextSide, previousSide;
+				GetNeighbour( face, side, nextFace, nextSide );
+				GetNeighbour( face, Side( ( side + 3 ) % 4 ), previousFace, previousSide );
+
+				ownerFace = face;
+				ownerSide = side;
+				if ( nextFace < ownerFace )
+				{
+					ownerFace = nextFace;
+					ownerSide = Side( ( nextSide + 1 ) % 4 );
+				}
+				if ( previousFace < ownerFace )
+				{
+					ownerFace = previousFace;
+					ownerSide = previousSide;
+				}
+			}
+
+			int UCubeMapSeams::GetEdgeTexels( const int size, const UCubeMapFace face, const Side side, const int k, UCubeMapFace* faces, int* rows, int* cols )
+			{
+				faces[ 0 ] = face;
+				GetSideTexel( size, side, 0, k, rows[ 0 ], cols[ 0 ] );
+
+				Side neighbourSide;
+				GetNeighbour( face, side, faces[ 1 ], neighbourSide );
+				GetSideTexel( size, neighbourSide, 0, size - 1 - k, rows[ 1 ], cols[ 1 ] );
+				if ( k != 0 )
+				{
+					return 2;
+				}
+
+				//	The corner is also at the start of the side across the previous side of the face
+				GetNeighbour( face, Side( ( side + 3 ) % 4 ), faces[ 2 ], neighbourSide );
+				GetSideTexel( size, neighbourSide, 0, 0, rows[ 2 ], cols[ 2 ] );
+				return 3;
+			}
+
+			void UCubeMapSeams::SetSample( const UCubeMapFace face, const int row, const int col, const float x, const float y, const float z, const float height )
+			{
+				const float sample[ 4 ] = { x, y, z, height };
+				if ( IsRingLine( row ) )
+				{
+					float* line = GetRingRow( face, row ) + LinePadding + col;
+					for ( int plane = 0; plane < 4; ++plane )
+					{
+						line[ plane * GetRowLineSize( ) ] = sample[ plane ];
+					}
+				}
+				if ( IsRingLine( col ) )
+				{
+					float* line = GetRingColumn( face, col ) + row;
+					for ( int plane = 0; plane < 4; ++plane )
+					{
+						line[ plane * m_Size ] = sample[ plane ];
+					}
+				}
+			}
+
+			void UCubeMapSeams::GetSample( const UCubeMapFace face, const int row, const int col, float* sample ) const
+			{
+				if ( IsRingLine( row ) )
+				{
+					const float* line = GetRingRow( face, row ) + LinePadding + col;
+					for ( int plane = 0; plane < 4; ++plane )
+					{
+						sample[ plane ] = line[ plane * GetRowLineSize( ) ];
+					}
+				}
+				else
+				{
+					const float* line = GetRingColumn( face, col ) + row;
+					for ( int plane = 0; plane < 4; ++plane )
+					{
+						sample[ plane ] = line[ plane * m_Size ];
+					}
+				}
+			}
+
+			void UCubeMapSeams::SetEdgeValue( const UCubeMapFace face, const int row, const int col, const float height, const float slope, const float latitude )
+			{
+				const float values[ 3 ] = { height, slope, latitude };
+				for ( int side = Top; side <= Left; ++side )
+				{
+					//	Corner texels are on two sides
+					const bool onSide =
+						( ( side == Top ) && ( row == 0 ) ) || ( ( side == Bottom ) && ( row == m_Size - 1 ) ) ||
+						( ( side == Left ) && ( col == 0 ) ) || ( ( side == Right ) && ( col == m_Size - 1 ) );
+					if ( onSide )
+					{
+						float* edge = GetEdgeValues( face, Side( side ) ) + ( ( ( side == Top ) || ( side == Bottom ) ) ? col : row );
+						for ( int value = 0; value < 3; ++value )
+						{
+							edge[ value * m_Size ] = values[ value ];
+						}
+					}
+				}
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,183 @@
+#include "Stdafx.h"
+#include "UMipChain.h"
+
+#include <Sse/SseUtils.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Downsamples pixels [firstPixel,dstWidth) of a row, one channel at a time
+			inline void DownsamplePixels( const int bytesPerPixel, const UMipChain::Filter filter, const unsigned char* row0, const unsigned char* row1, const int srcWidth, unsigned char* dst, const int firstPixel, const int dstWidth )
+			{
+				const int rightOffset = srcWidth > 1 ? bytesPerPixel : 0;
+				for ( int pixel = firstPixel; pixel < dstWidth; ++pixel )
+				{
+					const int srcOffset = pixel * 2 * bytesPerPixel;
+					const unsigned char* topLeft = row0 + srcOffset;
+					const unsigned char* bottomLeft = row1 + srcOffset;
+					unsigned char* out = dst + pixel * bytesPerPixel;
+					for ( int channel = 0; channel < bytesPerPixel; ++channel )
+					{
+						out[ channel ] = filter == UMipChain::PointFilter ?
+							topLeft[ channel ] :
+							( unsigned char )( ( topLeft[ channel ] + topLeft[ rightOffset + channel ] + bottomLeft[ channel ] + bottomLeft[ rightOffset + channel ] + 2 ) >> 2 );
+					}
+				}
+			}
+
+			///	\brief	Gets the rounded averages of 16-bit sums of 4 bytes, saturated back to bytes
+			inline __m128i AverageSums( const __m128i& sums0, const __m128i& sums1 )
+			{
+				const __m128i two = _mm_set1_epi16( 2 );
+				return _mm_packus_epi16( _mm_srli_epi16( _mm_add_epi16( sums0, two ), 2 ), _mm_srli_epi16( _mm_add_epi16( sums1, two ), 2 ) );
+			}
+
+			///	\brief	Box filters 16 single channel pixels, from 32 pixels in each row
+			inline __m128i BoxFilter1( const unsigned char* row0, const unsigned char* row1 )
+			{
+				//	Each 16-bit lane holds a horizontal pair of pixels
+				const __m128i lowBytes = _mm_set1_epi16( 0x00ff );
+				__m128i sums[ 2 ];
+				for ( int half = 0; half < 2; ++half )
+				{
+					const __m128i pairs0 = _mm_loadu_si128( ( const __m128i* )( row0 + half * 16 ) );
+					const __m128i pairs1 = _mm_loadu_si128( ( const __m128i* )( row1 + half * 16 ) );
+					const __m128i left = _mm_add_epi16( _mm_and_si128( pairs0, lowBytes ), _mm_and_si128( pairs1, lowBytes ) );
+					const __m128i right = _mm_add_epi16( _mm_srli_epi16( pairs0, 8 ), _mm_srli_epi16( pairs1, 8 ) );
+					sums[ half ] = _mm_add_epi16( left, right );
+				}
+				return AverageSums( sums[ 0 ], sums[ 1 ] );
+			}
+
+			///	\brief	Point filters 16 single channel pixels, from 32 pixels in a row
+			inline __m128i PointFilter1( const unsigned char* row0 )
+			{
+				const __m128i lowBytes = _mm_set1_epi16( 0x00ff );
+				const __m128i left0 = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )row0 ), lowBytes );
+				const __m128i left1 = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )( row0 + 16 ) ), lowBytes );
+				return _mm_packus_epi16( left0, left1 );
+			}
+
+			///	\brief	Gets the sums of 2 horizontal pairs of 4 channel pixels, from 4 pixels in each row
+			inline __m128i SumPairs4( const unsigned char* row0, const unsigned char* row1 )
+			{
+				const __m128i zero = _mm_setzero_si128( );
+				const __m128i pixels0 = _mm_loadu_si128( ( const __m128i* )row0 );
+				const __m128i pixels1 = _mm_loadu_si128( ( const __m128i* )row1 );
+
+				//	low has pixels 0 and 1 of both rows, high has pixels 2 and 3
+				const __m128i low = _mm_add_epi16( _mm_unpacklo_epi8( pixels0, zero ), _mm_unpacklo_epi8( pixels1, zero ) );
+				const __m128i high = _mm_add_epi16( _mm_unpackhi_epi8( pixels0, zero ), _mm_unpackhi_epi8( pixels1, zero ) );
+				return _mm_add_epi16( _mm_unpacklo_epi64( low, high ), _mm_unpackhi_epi64( low, high ) );
+			}
+
+			///	\brief	Gets the sums of 2 horizontal pairs of 3 channel pixels, with pixel pairs at row offsets of 0 and 6 bytes
+			///
+			///	Each pair is read with an 8 byte load, so 2 bytes past the second pair are read. Lanes 0-2 of the
+			///	result hold the first sum, and lanes 3-5 the second.
+			///
+			inline __m128i SumPairs3( const unsigned char* row0, const unsigned char* row1 )
+			{
+				const __m128i zero = _mm_setzero_si128( );
+				const __m128i pixels0 = _mm_unpacklo_epi64( _mm_loadl_epi64( ( const __m128i* )row0 ), _mm_loadl_epi64( ( const __m128i* )( row0 + 6 ) ) );
+				const __m128i pixels1 = _mm_unpacklo_epi64( _mm_loadl_epi64( ( const __m128i* )row1 ), _mm_loadl_epi64( ( const __m128i* )( row1 + 6 ) ) );
+
+				//	Lanes 0-2 of each column sum hold the left pixel of a pair, and lanes 3-5 the right pixel
+				const __m128i firstPair = _mm_add_epi16( _mm_unpacklo_epi8( pixels0, zero ), _mm_unpacklo_epi8( pixels1, zero ) );
+				const __m128i secondPair = _mm_add_epi16( _mm_unpackhi_epi8( pixels0, zero ), _mm_unpackhi_epi8( pixels1, zero ) );
+				const __m128i lanes012 = _mm_set_epi16( 0, 0, 0, 0, 0, -1, -1, -1 );
+				const __m128i firstSum = _mm_and_si128( _mm_add_epi16( firstPair, _mm_srli_si128( firstPair, 6 ) ), lanes012 );
+				const __m128i secondSum = _mm_and_si128( _mm_add_epi16( secondPair, _mm_srli_si128( secondPair, 6 ) ), lanes012 );
+				return _mm_or_si128( firstSum, _mm_slli_si128( secondSum, 6 ) );
+			}
+
+			//	------------------------------------------------------------------ UMipChain Methods
+
+			void UMipChain::WriteRow( const UPixelFormat format, const Filter filter, const int width, const int height, const unsigned char* base, const int baseStride, const int row ) const
+			{
+				const int bytesPerPixel = GetBytesPerPixel( format );
+				const unsigned char* src = base;
+				int srcStride = baseStride;
+				int srcWidth = width;
+				int srcHeight = height;
+				int srcRow = row;
+				for ( int level = 0; level < m_Levels; ++level )
+				{
+					//	A row of this level is made once both rows above it have been written
+					const unsigned char* row1 = src + srcRow * srcStride;
+					const unsigned char* row0 = row1;
+					int dstRow = srcRow;
+					if ( srcHeight > 1 )
+					{
+						if ( ( srcRow & 1 ) == 0 )
+						{
+							return;
+						}
+						row0 = row1 - srcStride;
+						dstRow = srcRow / 2;
+					}
+
+					const int dstWidth = srcWidth > 1 ? srcWidth / 2 : 1;
+					DownsampleRow( bytesPerPixel, filter, row0, row1, srcWidth, m_Pixels[ level ] + dstRow * m_Strides[ level ], dstWidth );
+
+					src = m_Pixels[ level ];
+					srcStride = m_Strides[ level ];
+					srcWidth = dstWidth;
+					srcHeight = srcHeight > 1 ? srcHeight / 2 : 1;
+					srcRow = dstRow;
+				}
+			}
+
+			void UMipChain::DownsampleRow( const int bytesPerPixel, const Filter filter, const unsigned char* row0, const unsigned char* row1, const int srcWidth, unsigned char* dst, const int dstWidth )
+			{
+				int pixel = 0;
+				if ( srcWidth > 1 )
+				{
+					if ( bytesPerPixel == 1 )
+					{
+						//	16 pixels at a time
+						for ( ; pixel + 16 <= dstWidth; pixel += 16 )
+						{
+							const __m128i pixels = filter == PointFilter ? PointFilter1( row0 + pixel * 2 ) : BoxFilter1( row0 + pixel * 2, row1 + pixel * 2 );
+							_mm_storeu_si128( ( __m128i* )( dst + pixel ), pixels );
+						}
+					}
+					else if ( ( bytesPerPixel == 4 ) && ( filter == BoxFilter ) )
+					{
+						//	4 pixels at a time
+						for ( ; pixel + 4 <= dstWidth; pixel += 4 )
+						{
+							const int srcOffset = pixel * 8;
+							const __m128i sums0 = SumPairs4( row0 + srcOffset, row1 + srcOffset );
+							const __m128i sums1 = SumPairs4( row0 + srcOffset + 16, row1 + srcOffset + 16 );
+							_mm_storeu_si128( ( __m128i* )( dst + pixel * 4 ), AverageSums( sums0, sums1 ) );
+						}
+					}
+					else if ( ( bytesPerPixel == 3 ) && ( filter == BoxFilter ) )
+					{
+						//	4 pixels at a time. Loads and stores run 2 bytes past the 4 pixels, so there must be another
+						//	pixel after them, in the source and destination rows
+						for ( ; pixel + 5 <= dstWidth; pixel += 4 )
+						{
+							const int srcOffset = pixel * 6;
+							const __m128i sums0 = SumPairs3( row0 + srcOffset, row1 + srcOffset );
+							const __m128i sums1 = SumPairs3( row0 + srcOffset + 12, row1 + srcOffset + 12 );
+							const __m128i pixels = AverageSums( sums0, sums1 );
+							_mm_storel_epi64( ( __m128i* )( dst + pixel * 3 ), pixels );
+							_mm_storel_epi64( ( __m128i* )( dst + pixel * 3 + 6 ), _mm_srli_si128( pixels, 8 ) );
+						}
+					}
+				}
+				DownsamplePixels( bytesPerPixel, filter, row0, row1, srcWidth, dst, pixel, dstWidth );
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,190 @@
+#include "Stdafx.h"
+#include "USphereCloudsAnimation.h"
+#include "Mem.h"
+#include "Trace.h"
+
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			//	---------------------------------------------------- USphereCloudsAnimation Methods
+
+			USphereCloudsAnimation::USphereCloudsAnimation( const int width, const int height, const int framesPerKey ) :
+				m_Width( width ),
+				m_Height( height ),
+				m_FramesPerKey( framesPerKey < 1 ? 1 : framesPerKey ),
+				m_Keyframe( 0 ),
+				m_Frame( 0 ),
+				m_NextRow( 0 ),
+				m_XOffset( 0 ),
+				m_ZOffset( 0 ),
+				m_XVelocity( 0 ),
+				m_ZVelocity( 0 ),
+				m_CloudCutoff( 0 ),
+				m_CloudBorder( 0 )
+			{
+				//	Enough rows per frame to finish the generating keyframe by the time it is needed
+				const int rows = m_Height * 6;
+				m_RowsPerFrame = ( rows + m_FramesPerKey - 1 ) / m_FramesPerKey;
+
+				m_Clouds = new ( Aligned( 16 ) ) USphereCloudsBitmap;
+				for ( int key = 0; key < NumKeyframes; ++key )
+				{
+					m_Keyframes[ key ] = new unsigned char[ m_Width * rows ];
+					memset( m_Keyframes[ key ], 0, m_Width * rows );
+				}
+			}
+
+			USphereCloudsAnimation::~USphereCloudsAnimation( )
+			{
+				for ( int key = 0; key < NumKeyframes; ++key )
+				{
+					delete [] m_Keyframes[ key ];
+				}
+				AlignedDelete( m_Clouds );
+			}
+
+			void USphereCloudsAnimation::Start( const float xOffset, const float zOffset, const float xVelocity, const float zVelocity, const float cloudCutoff, const float cloudBorder )
+			{
+				FAST_TRACE_SCOPE( "CloudsAnimationStart" );
+
+				m_XOffset = xOffset;
+				m_ZOffset = zOffset;
+				m_XVelocity = xVelocity;
+				m_ZVelocity = zVelocity;
+				m_CloudCutoff = cloudCutoff;
+				m_CloudBorder = cloudBorder;
+				m_Keyframe = 0;
+				m_Frame = 0;
+				m_NextRow = 0;
+
+				GenerateKeyframeRows( 0, m_Keyframes[ 0 ], 0, m_Height * 6 );
+				GenerateKeyframeRows( 1, m_Keyframes[ 1 ], 0, m_Height * 6 );
+			}
+
+			void USphereCloudsAnimation::Update( )
+			{
+				FAST_TRACE_SCOPE( "CloudsAnimationUpdate" );
+
+				const int totalRows = m_Height * 6;
+				const int rows = ( totalRows - m_NextRow ) < m_RowsPerFrame ? ( totalRows - m_NextRow ) : m_RowsPerFrame;
+				GenerateKeyframeRows( m_Keyframe + 2, m_Keyframes[ 2 ], m_NextRow, rows );
+				m_NextRow += rows;
+
+				if ( ++m_Frame < m_FramesPerKey )
+				{
+					return;
+				}
+
+				//	The generating keyframe is complete. It becomes the next keyframe, and the current keyframe buffer is reused
+				unsigned char* current = m_Keyframes[ 0 ];
+				m_Keyframes[ 0 ] = m_Keyframes[ 1 ];
+				m_Keyframes[ 1 ] = m_Keyframes[ 2 ];
+				m_Keyframes[ 2 ] = current;
+				++m_Keyframe;
+				m_Frame = 0;
+				m_NextRow = 0;
+			}
+
+			int USphereCloudsAnimation::GetRowsPerFrame( ) const
+			{
+				return m_RowsPerFrame;
+			}
+
+			int USphereCloudsAnimation::GetBlend( ) const
+			{
+				return ( m_Frame * 256 ) / m_FramesPerKey;
+			}
+
+			const unsigned char* USphereCloudsAnimation::GetKeyframeFace( const int key, const UCubeMapFace face ) const
+			{
+				return m_Keyframes[ key ] + int( face ) * m_Width * m_Height;
+			}
+
+			void USphereCloudsAnimation::GetCloudsFace( const UCubeMapFace face, const UPixelFormat format, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor ) const
+			{
+				FAST_TRACE_SCOPE_ARG( "CloudsAnimationFace", face );
+
+				const unsigned char* current = GetKeyframeFace( 0, face );
+				const unsigned char* next = GetKeyframeFace( 1, face );
+				const int blend = GetBlend( );
+
+				//	alpha = ( current * ( 256 - blend ) + next * blend ) / 256, 16 pixels at a time. Rows are blended into alpha,
+				//	then written in the requested format
+				const __m128i zero = _mm_setzero_si128( );
+				const __m128i currentWeight = _mm_set1_epi16( short( 256 - blend ) );
+				const __m128i nextWeight = _mm_set1_epi16( short( blend ) );
+				const bool inPlace = GetBytesPerPixel( format ) == 1;
+				unsigned char* alphaRow = inPlace ? 0 : new unsigned char[ m_Width ];
+				const UPixelChannels channels = UPixelChannels::FromFormat( format );
+
+				unsigned char* rowPixel = pixels;
+				for ( int row = 0; row < m_Height; ++row, current += m_Width, next += m_Width, rowPixel += stride )
+				{
+					unsigned char* alpha = inPlace ? rowPixel : alphaRow;
+					int col = 0;
+					for ( ; col + 16 <= m_Width; col += 16 )
+					{
+						const __m128i currentAlpha = _mm_loadu_si128( ( const __m128i* )( current + col ) );
+						const __m128i nextAlpha = _mm_loadu_si128( ( const __m128i* )( next + col ) );
+						const __m128i low = _mm_srli_epi16( _mm_add_epi16
+							(
+								_mm_mullo_epi16( _mm_unpacklo_epi8( currentAlpha, zero ), currentWeight ),
+								_mm_mullo_epi16( _mm_unpacklo_epi8( nextAlpha, zero ), nextWeight )
+							), 8 );
+						const __m128i high = _mm_srli_epi16( _mm_add_epi16
+							(
+								_mm_mullo_epi16( _mm_unpackhi_epi8( currentAlpha, zero ), currentWeight ),
+								_mm_mullo_epi16( _mm_unpackhi_epi8( nextAlpha, zero ), nextWeight )
+							), 8 );
+						_mm_storeu_si128( ( __m128i* )( alpha + col ), _mm_packus_epi16( low, high ) );
+					}
+					for ( ; col < m_Width; ++col )
+					{
+						alpha[ col ] = ( unsigned char )( ( current[ col ] * ( 256 - blend ) + next[ col ] * blend ) >> 8 );
+					}
+					USphereCloudsBitmap::WriteCloudsPixels( format, m_Width, alpha, rowPixel );
+					if ( mipChain )
+					{
+						mipChain->WriteRow( format, UMipChain::BoxFilter, m_Width, m_Height, pixels, stride, row );
+					}
+					if ( compressor )
+					{
+						compressor->WriteRow( channels, m_Width, m_Height, pixels, stride, row );
+					}
+				}
+
+				delete [] alphaRow;
+			}
+
+			void USphereCloudsAnimation::GenerateKeyframeRows( const int keyframe, unsigned char* alpha, const int firstRow, const int rows )
+			{
+				if ( rows <= 0 )
+				{
+					return;
+				}
+				m_Clouds->Setup( m_XOffset + m_XVelocity * float( keyframe ), m_ZOffset + m_ZVelocity * float( keyframe ), m_CloudCutoff, m_CloudBorder );
+
+				int row = firstRow;
+				while ( row < firstRow + rows )
+				{
+					//	Rows of different faces are generated separately
+					const int face = row / m_Height;
+					const int faceRow = row % m_Height;
+					const int faceRows = ( m_Height - faceRow ) < ( firstRow + rows - row ) ? ( m_Height - faceRow ) : ( firstRow + rows - row );
+					m_Clouds->GenerateCloudsAlpha( UCubeMapFace( face ), m_Width, m_Height, faceRow, faceRows, m_Width, alpha + row * m_Width );
+					row += faceRows;
+				}
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
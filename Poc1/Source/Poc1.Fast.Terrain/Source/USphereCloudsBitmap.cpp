@@ -0,0 +1,382 @@
+#include "Stdafx.h"
+#include "USphereCloudsBitmap.h"
+#include "Sse/SseRidgedFractal.h"
+#include "Trace.h"
+
+#include <math.h>
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			template < typename Precision >
+			inline __m128 CubeFaceFractal( const SseRidgedFractal& fractal, const UCubeMapFace face, const UCubeMapProjection projection, const __m128& uuuu, const __m128& vvvv, const __m128& xOffset, const __m128& zOffset )
+			{
+				__m128 xxxx, yyyy, zzzz;
+				CubeFacePosition( face, projection, uuuu, vvvv, xxxx, yyyy, zzzz );
+				SetLength< Precision >( xxxx, yyyy, zzzz, _mm_set1_ps( 3.0f ) );
+			//	return fractal.GetValue( _mm_add_ps( xxxx, xOffset ), yyyy, _mm_add_ps( zzzz, zOffset ) );
+				__m128 res = fractal.GetValue< Precision >( _mm_add_ps( xxxx, xOffset ), yyyy, _mm_add_ps( zzzz, zOffset ) );
+				return res;
+			}
+
+			///	\brief	Squared cloud fractal values below this are clear sky
+			const float CloudOffset = 0.25f;
+
+			///	\brief	Cloud alpha is the cloud value, scaled by this and saturated
+			const float CloudAlphaScale = 8.0f;
+
+			///	\brief	Gets 4 cloud values. The caller must treat cloud values from fractal values above maxFractalValue as saturated
+			///
+			///	The cloud value is 0 wherever the second fractal is below minFractalValue (sqrt( CloudOffset )), so its
+			///	octaves stop early wherever the remaining octaves can't move it into [minFractalValue, maxFractalValue].
+			///
+			template < typename Precision >
+			inline __m128 CubeFaceFractal( const SseSimpleFractal& fractal, const UCubeMapFace face, const UCubeMapProjection projection, const __m128& uuuu, const __m128& vvvv, const __m128& xOffset, const __m128& zOffset, const __m128& minFractalValue, const __m128& maxFractalValue )
+			{
+				__m128 xxxx, yyyy, zzzz;
+				CubeFacePosition( face, projection, uuuu, vvvv, xxxx, yyyy, zzzz );
+				SetLength< Precision >( xxxx, yyyy, zzzz, _mm_set1_ps( 6.0f ) );
+			//	__m128 res = fractal.GetValue( _mm_add_ps( xxxx, xOffset ), yyyy, _mm_add_ps( zzzz, zOffset ) );
+			//	return _mm_mul_ps( _mm_set1_ps( 255 ), res );
+				xxxx = _mm_add_ps( xxxx, xOffset );
+				zzzz = _mm_add_ps( zzzz, zOffset );
+				__m128 res = fractal.GetValue< Precision >( xxxx, yyyy, zzzz );
+				xxxx = _mm_add_ps( res, xxxx );
+				zzzz = _mm_add_ps( res, zzzz );
+				res = fractal.GetClampedValue< Precision >( xxxx, yyyy, zzzz, minFractalValue, maxFractalValue );
+
+				res = _mm_mul_ps( res, res ); // TODO: AP: ^1.55 is better - need an SSE2 pow function though - see: http://jrfonseca.blogspot.com/2008/09/fast-sse2-pow-tables-or-polynomials.html
+
+				__m128 offset = _mm_set1_ps( CloudOffset );
+				__m128 invOffset = _mm_sub_ps( _mm_set1_ps( 1 ), offset );
+				res = Precision::Div( _mm_sub_ps( res, offset ), invOffset );
+				
+				//	Clamp to 0-1 range
+				res = Clamp( res, _mm_set1_ps( 0 ), _mm_set1_ps( 1 ) );
+
+				return res;
+			}
+
+			//	-------------------------------------------------------- USphereCloudsBitmap Methods
+
+			USphereCloudsBitmap::USphereCloudsBitmap( ) :
+				m_Projection( ProjectionGnomonic )
+			{
+			//	m_Gen.Setup( 2.5f, 0.8f, 8 );
+				m_Gen.Setup( 1.5f, 0.8f, 8 );
+
+				//	Alpha saturates once the cloud value reaches 1 / CloudAlphaScale. The fractal value that produces that
+				//	is raised by 1%, so that rounding can't pull saturated alpha values down to 254
+				const float saturatedCloud = 1.01f / CloudAlphaScale;
+				m_MinFractalValue = _mm_set1_ps( sqrtf( CloudOffset ) );
+				m_MaxFractalValue = _mm_set1_ps( sqrtf( CloudOffset + ( 1 - CloudOffset ) * saturatedCloud ) );
+			}
+
+			void USphereCloudsBitmap::Setup( const float xOffset, const float zOffset, const float cloudCutoff, const float cloudBorder )
+			{
+				m_XOffset = _mm_set1_ps( xOffset );
+				m_ZOffset = _mm_set1_ps( zOffset );
+				m_CloudCutoff = _mm_mul_ps( _mm_set1_ps( cloudCutoff ), _mm_set1_ps( 255.0f ) );
+				m_CloudBorder = _mm_mul_ps( _mm_set1_ps( cloudBorder ), _mm_set1_ps( 255.0f ) );
+				m_CloudBorderDiff = _mm_div_ps( _mm_set1_ps( 255.0f ), _mm_sub_ps( m_CloudBorder, m_CloudCutoff ) );
+			}
+
+			void USphereCloudsBitmap::SetProjection( const UCubeMapProjection projection )
+			{
+				m_Projection = projection;
+			}
+
+			inline __m128 USphereCloudsBitmap::GetCloudAlpha( const UCubeMapFace face, const __m128& uuuu, const __m128& vvvv ) const
+			{
+				__m128 value = CubeFaceFractal< Precision >( m_Gen, face, m_Projection, uuuu, vvvv, m_XOffset, m_ZOffset, m_MinFractalValue, m_MaxFractalValue );
+				return _mm_min_ps( _mm_set1_ps( 255 ), _mm_mul_ps( value, _mm_set1_ps( 255 * CloudAlphaScale ) ) );
+			}
+
+			void USphereCloudsBitmap::GenerateCloudsAlpha( const UCubeMapFace face, const int width, const int height, const int firstRow, const int rows, const int stride, unsigned char* alpha ) const
+			{
+				FAST_TRACE_SCOPE_ARG( "CloudsAlpha", face );
+
+				//	Lane 0 is the leftmost pixel, so packed alpha values can be stored in order
+				const float incU = 2.0f / float( width - 1 );
+				const float incV = 2.0f / float( height - 1 );
+				const __m128 uuuuStart = _mm_add_ps( _mm_set1_ps( -1 ), _mm_set_ps( incU * 3, incU * 2, incU, 0 ) );
+				const __m128 uuuuInc = _mm_set1_ps( incU * 4 );
+
+				FAST_ALIGN( 16 ) unsigned char lastBlock[ 16 ];
+				unsigned char* rowAlpha = alpha;
+				for ( int row = firstRow; row < firstRow + rows; ++row, rowAlpha += stride )
+				{
+					const __m128 vvvv = _mm_set1_ps( -1 + incV * float( row ) );
+					__m128 uuuu = uuuuStart;
+					for ( int col = 0; col < width; col += 16 )
+					{
+						//	16 pixels at a time. Alpha values are in [0,255], so truncating and packing with saturation
+						//	gives the same bytes as casting each value. The last blocks of a row only evaluate the
+						//	4 pixel blocks that reach into the row
+						const int blocks = ( col + 16 <= width ) ? 4 : ( width - col + 3 ) / 4;
+						__m128i alpha32[ 4 ] = { _mm_setzero_si128( ), _mm_setzero_si128( ), _mm_setzero_si128( ), _mm_setzero_si128( ) };
+						for ( int block = 0; block < blocks; ++block )
+						{
+							alpha32[ block ] = _mm_cvttps_epi32( GetCloudAlpha( face, uuuu, vvvv ) );
+							uuuu = _mm_add_ps( uuuu, uuuuInc );
+						}
+						const __m128i alpha16Low = _mm_packs_epi32( alpha32[ 0 ], alpha32[ 1 ] );
+						const __m128i alpha16High = _mm_packs_epi32( alpha32[ 2 ], alpha32[ 3 ] );
+						const __m128i alpha8 = _mm_packus_epi16( alpha16Low, alpha16High );
+
+						if ( col + 16 <= width )
+						{
+							_mm_storeu_si128( ( __m128i* )( rowAlpha + col ), alpha8 );
+						}
+						else
+						{
+							//	The last block runs past the end of the row
+							_mm_store_si128( ( __m128i* )lastBlock, alpha8 );
+							memcpy( rowAlpha + col, lastBlock, width - col );
+						}
+					}
+				}
+			}
+
+			void USphereCloudsBitmap::WriteCloudsPixels( const UPixelFormat format, const int width, const unsigned char* alpha, unsigned char* pixels )
+			{
+				switch ( format )
+				{
+					case FormatR8G8B8 :
+					case FormatB8G8R8 :
+						//	Colour channels are always white
+						memset( pixels, 0xff, width * 3 );
+						break;
+
+					case FormatA8 :
+					case FormatR8 :
+						if ( pixels != alpha )
+						{
+							memcpy( pixels, alpha, width );
+						}
+						break;
+
+					case FormatR8G8B8A8 :
+					case FormatB8G8R8A8 :
+						{
+							//	Colour channels are white, so both channel orders are ( 0xff, 0xff, 0xff, alpha ) in memory
+							const __m128i white = _mm_set1_epi8( -1 );
+							int col = 0;
+							for ( ; col + 16 <= width; col += 16 )
+							{
+								const __m128i alpha8 = _mm_loadu_si128( ( const __m128i* )( alpha + col ) );
+								const __m128i lowPairs = _mm_unpacklo_epi8( white, alpha8 );
+								const __m128i highPairs = _mm_unpackhi_epi8( white, alpha8 );
+								__m128i* out = ( __m128i* )( pixels + col * 4 );
+								_mm_storeu_si128( out + 0, _mm_unpacklo_epi16( white, lowPairs ) );
+								_mm_storeu_si128( out + 1, _mm_unpackhi_epi16( white, lowPairs ) );
+								_mm_storeu_si128( out + 2, _mm_unpacklo_epi16( white, highPairs ) );
+								_mm_storeu_si128( out + 3, _mm_unpackhi_epi16( white, highPairs ) );
+							}
+							for ( ; col < width; ++col )
+							{
+								unsigned char* pixel = pixels + col * 4;
+								pixel[ 0 ] = pixel[ 1 ] = pixel[ 2 ] = 0xff;
+								pixel[ 3 ] = alpha[ col ];
+							}
+							break;
+						}
+				};
+			}
+
+			UBlockCompressor::Format USphereCloudsBitmap::GetCompressedFormat( const UPixelFormat format )
+			{
+				return GetBytesPerPixel( format ) == 1 ? UBlockCompressor::Bc4 : UBlockCompressor::Bc3;
+			}
+
+			void USphereCloudsBitmap::GenerateCloudsFace( const UCubeMapFace face, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor )
+			{
+				FAST_TRACE_SCOPE_ARG( "CloudsFace", face );
+				FAST_INSTRUMENT_TIME( CounterFaces, CounterFaceTicks );
+				FAST_INSTRUMENT_COUNT( CounterFaceBytes, height * stride );
+
+				//	Alpha is generated a row at a time, then expanded, so mip levels and compressed blocks can be made from
+				//	rows still in the cache. A8 and R8 rows are the alpha values themselves, and 3 byte formats have no alpha, so no clouds
+				//	need to be generated
+				const bool hasAlpha = GetBytesPerPixel( format ) != 3;
+				const bool inPlace = GetBytesPerPixel( format ) == 1;
+				unsigned char* alphaRow = ( hasAlpha && !inPlace ) ? new unsigned char[ width ] : 0;
+				const UPixelChannels channels = UPixelChannels::FromFormat( format );
+
+				FAST_TRACE_PHASES( );
+				unsigned char* rowPixel = pixels;
+				for ( int row = 0; row < height; ++row, rowPixel += stride )
+				{
+					unsigned char* alpha = inPlace ? rowPixel : alphaRow;
+					if ( hasAlpha )
+					{
+						FAST_TRACE_PHASE( TracePhaseDisplacement );
+						GenerateCloudsAlpha( face, width, height, row, 1, width, alpha );
+					}
+					FAST_TRACE_PHASE( TracePhaseStore );
+					WriteCloudsPixels( format, width, alpha, rowPixel );
+					if ( mipChain )
+					{
+						mipChain->WriteRow( format, UMipChain::BoxFilter, width, height, pixels, stride, row );
+					}
+					if ( compressor )
+					{
+						compressor->WriteRow( channels, width, height, pixels, stride, row );
+					}
+				}
+
+				delete [] alphaRow;
+
+			/*
+			
+		private void Cyclone( ref float x, ref float y, float cX, float cY, float
+cR )
+		{
+			float dX = x - cX;
+			float dY = y - cY;
+			float dC2 = ( dX * dX ) + ( dY * dY );
+			if ( dC2 > cR * cR )
+			{
+				return;
+			}
+			float dC = ( float )Math.Sqrt( dC2 );
+			float rS = ( 1 - ( dC / cR ) );
+			float rot = ( rS * rS ) * 0.6f * ( float )Math.PI;
+			rot += m_Noise.GetNoise( rot, 1.124570f, 1.124570f ) * 0.2f * rS;
+		
+			float sRot = ( float )Math.Sin( rot );
+			float cRot = ( float )Math.Cos( rot );
+			x = cX + ( float )( dX * cRot - dY * sRot );
+			y = cY + ( float )( dX * sRot + dY * cRot );
+		}
+
+		private Color GetValue( float x, float y )
+		{
+		//	Cyclone( ref x, ref y, 0.5f, 0.5f, 0.4f );
+
+		//	float n0 = m_Noise.GetNoise( 2.0098f + x * 15.917894f, 5.0973502375f +
+y * 15.917894f, 0 );
+		//	float res = m_Noise.GetNoise( n0 + x * 10.109175f, n0 + y *
+10.109175f, 0 );
+
+			float res = fBm( 2.0098f + x * 3.012839f, 3.0973502375f + y * 5.012839f,
+2.2f, 12, 0.51f );
+			res = fBm( res + x * 6.012839f, res + y * 6.012839f, 2.1f, 16, 0.5f );
+
+			res = res < 0 ? 0 : res > 1 ? 1 : res;
+			res = ( float )Math.Pow( res, 1.55f );
+			float offset = 0.3f;
+			if ( res < offset )
+			{
+				return Color.Black;
+			}
+			res = ( res - offset ) / ( 1 - offset );
+			res *= 255.0f;
+
+			int c = ( int )( Math.Max( 0, Math.Min( res, 255 ) ) );
+			return Color.FromArgb( c, c, c );
+		}
+
+			*/
+			}
+
+			void USphereCloudsBitmap::GenerateCloudsCubeMap( const UPixelFormat format, const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors )
+			{
+				FAST_TRACE_SCOPE_ARG( "CloudsCubeMap", size );
+
+				//	Faces are generated in order, so the edges a face shares with lower numbered faces have already been
+				//	written, and are copied from the alpha values kept along the edges of every face
+				const bool hasAlpha = GetBytesPerPixel( format ) != 3;
+				unsigned char* alpha = new unsigned char[ size ];
+				unsigned char* edgeAlpha = new unsigned char[ 6 * 4 * size ];
+				const UPixelChannels channels = UPixelChannels::FromFormat( format );
+
+				FAST_TRACE_PHASES( );
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					FAST_INSTRUMENT_TIME( CounterFaces, CounterFaceTicks );
+					FAST_INSTRUMENT_COUNT( CounterFaceBytes, size * stride );
+
+					const UCubeMapFace uFace = UCubeMapFace( face );
+					unsigned char* pixels = facePixels[ face ];
+					const UMipChain* mipChain = mipChains ? mipChains[ face ] : 0;
+					const UBlockCompressor* compressor = compressors ? compressors[ face ] : 0;
+
+					unsigned char* rowPixel = pixels;
+					for ( int row = 0; row < size; ++row, rowPixel += stride )
+					{
+						if ( hasAlpha )
+						{
+							//	The top and bottom rows come from the face across the edge, if it owns the edge
+							const bool topRow = row == 0;
+							const bool sharedRow = ( topRow || ( row == size - 1 ) ) && !UCubeMapSeams::OwnsEdge( uFace, topRow ? UCubeMapSeams::Top : UCubeMapSeams::Bottom );
+							if ( !sharedRow )
+							{
+								FAST_TRACE_PHASE( TracePhaseDisplacement );
+								GenerateCloudsAlpha( uFace, size, size, row, 1, size, alpha );
+							}
+							FAST_TRACE_PHASE( TracePhaseStore );
+							if ( topRow || ( row == size - 1 ) )
+							{
+								for ( int col = 0; col < size; ++col )
+								{
+									CopySharedAlpha( uFace, topRow ? UCubeMapSeams::Top : UCubeMapSeams::Bottom, topRow ? col : size - 1 - col, size, edgeAlpha, alpha[ col ] );
+								}
+							}
+							CopySharedAlpha( uFace, UCubeMapSeams::Left, size - 1 - row, size, edgeAlpha, alpha[ 0 ] );
+							CopySharedAlpha( uFace, UCubeMapSeams::Right, row, size, edgeAlpha, alpha[ size - 1 ] );
+
+							//	Keep the final edge values for the faces still to be generated
+							unsigned char* faceEdges = edgeAlpha + face * 4 * size;
+							if ( topRow || ( row == size - 1 ) )
+							{
+								for ( int col = 0; col < size; ++col )
+								{
+									if ( topRow )
+									{
+										faceEdges[ UCubeMapSeams::Top * size + col ] = alpha[ col ];
+									}
+									else
+									{
+										faceEdges[ UCubeMapSeams::Bottom * size + size - 1 - col ] = alpha[ col ];
+									}
+								}
+							}
+							faceEdges[ UCubeMapSeams::Left * size + size - 1 - row ] = alpha[ 0 ];
+							faceEdges[ UCubeMapSeams::Right * size + row ] = alpha[ size - 1 ];
+						}
+						WriteCloudsPixels( format, size, alpha, rowPixel );
+						if ( mipChain )
+						{
+							mipChain->WriteRow( format, UMipChain::BoxFilter, size, size, pixels, stride, row );
+						}
+						if ( compressor )
+						{
+							compressor->WriteRow( channels, size, size, pixels, stride, row );
+						}
+					}
+				}
+
+				delete [] alpha;
+				delete [] edgeAlpha;
+			}
+
+			void USphereCloudsBitmap::CopySharedAlpha( const UCubeMapFace face, const UCubeMapSeams::Side side, const int k, const int size, const unsigned char* edgeAlpha, unsigned char& alpha )
+			{
+				UCubeMapFace neighbourFace;
+				UCubeMapSeams::Side neighbourSide;
+				UCubeMapSeams::GetNeighbour( face, side, neighbourFace, neighbourSide );
+				if ( neighbourFace < face )
+				{
+					alpha = edgeAlpha[ ( neighbourFace * 4 + neighbourSide ) * size + size - 1 - k ];
+				}
+			}
+		}; //Terrain
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,189 @@
+#include "Stdafx.h"
+#include "UTerrainRecorder.h"
+#include <Instrumentation.h>
+#include <Platform.h>
+
+#include <stdio.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Recording file. Null if not recording
+			static FILE* volatile s_File = 0;
+
+			///	\brief	Time that the current recording started, in ticks
+			static long long s_StartTicks = 0;
+
+			///	\brief	Hashes of the configurations written to the current recording
+			static std::vector< unsigned int >* s_WrittenConfigs = 0;
+
+			///	\brief	Recording lock. Zero-initialized, so it can be used before any dynamic initializers run
+			static volatile long s_RecorderLock = 0;
+
+			///	\brief	Scoped spin lock around s_RecorderLock
+			class RecorderLock
+			{
+				public :
+
+					RecorderLock( )
+					{
+						while ( Platform::AtomicExchange( &s_RecorderLock, 1 ) != 0 )
+						{
+							Platform::YieldThread( );
+						}
+					}
+
+					~RecorderLock( )
+					{
+						Platform::AtomicExchange( &s_RecorderLock, 0 );
+					}
+			};
+
+			///	\brief	Writes a tagged block to the recording file
+			static void WriteBlock( const unsigned int tag, const void* block, const size_t size )
+			{
+				fwrite( &tag, sizeof( tag ), 1, s_File );
+				fwrite( block, size, 1, s_File );
+			}
+
+			//	---------------------------------------------------------- UTerrainRecorder Methods
+
+			bool UTerrainRecorder::Start( const char* path )
+			{
+				Stop( );
+
+				FILE* file = fopen( path, "wb" );
+				if ( file == 0 )
+				{
+					return false;
+				}
+
+				const unsigned int header[ 2 ] = { Magic, Version };
+				const long long ticksPerSecond = Instrumentation::GetTicksPerSecond( );
+				fwrite( header, sizeof( header ), 1, file );
+				fwrite( &ticksPerSecond, sizeof( ticksPerSecond ), 1, file );
+
+				RecorderLock lock;
+				if ( s_WrittenConfigs == 0 )
+				{
+					s_WrittenConfigs = new std::vector< unsigned int >;
+				}
+				s_WrittenConfigs->clear( );
+				s_StartTicks = Instrumentation::GetTicks( );
+				s_File = file;
+				return true;
+			}
+
+			void UTerrainRecorder::Stop( )
+			{
+				RecorderLock lock;
+				if ( s_File != 0 )
+				{
+					fclose( s_File );
+					s_File = 0;
+				}
+			}
+
+			bool UTerrainRecorder::IsRecording( )
+			{
+				return s_File != 0;
+			}
+
+			void UTerrainRecorder::Record( const UTerrainGeneratorConfig& config, const UTerrainGenerationCall& call )
+			{
+				RecorderLock lock;
+				if ( s_File == 0 )
+				{
+					return;
+				}
+
+				bool configWritten = false;
+				for ( size_t index = 0; !configWritten && ( index < s_WrittenConfigs->size( ) ); ++index )
+				{
+					configWritten = ( ( *s_WrittenConfigs )[ index ] == call.m_ConfigHash );
+				}
+				if ( !configWritten )
+				{
+					WriteBlock( ConfigTag, &config, sizeof( config ) );
+					s_WrittenConfigs->push_back( call.m_ConfigHash );
+				}
+
+				UTerrainGenerationCall relativeCall = call;
+				relativeCall.m_StartTicks -= s_StartTicks;
+				WriteBlock( CallTag, &relativeCall, sizeof( relativeCall ) );
+			}
+
+			//	--------------------------------------------------------- UTerrainRecording Methods
+
+			bool UTerrainRecording::Load( const char* path )
+			{
+				m_Configs.clear( );
+				m_Calls.clear( );
+
+				FILE* file = fopen( path, "rb" );
+				if ( file == 0 )
+				{
+					return false;
+				}
+
+				unsigned int header[ 2 ];
+				bool ok =	( fread( header, sizeof( header ), 1, file ) == 1 ) &&
+							( header[ 0 ] == UTerrainRecorder::Magic ) &&
+							( header[ 1 ] == UTerrainRecorder::Version ) &&
+							( fread( &m_TicksPerSecond, sizeof( m_TicksPerSecond ), 1, file ) == 1 );
+
+				//	A truncated last block (e.g. from a session that crashed while recording) is ignored
+				unsigned int tag;
+				bool more = ok;
+				while ( more && ( fread( &tag, sizeof( tag ), 1, file ) == 1 ) )
+				{
+					if ( tag == UTerrainRecorder::ConfigTag )
+					{
+						UTerrainGeneratorConfig config;
+						more = ( fread( &config, sizeof( config ), 1, file ) == 1 );
+						if ( more )
+						{
+							m_Configs.push_back( config );
+						}
+					}
+					else if ( tag == UTerrainRecorder::CallTag )
+					{
+						UTerrainGenerationCall call;
+						more = ( fread( &call, sizeof( call ), 1, file ) == 1 );
+						if ( more )
+						{
+							m_Calls.push_back( call );
+						}
+					}
+					else
+					{
+						ok = more = false;
+					}
+				}
+
+				fclose( file );
+				return ok;
+			}
+
+			const UTerrainGeneratorConfig* UTerrainRecording::FindConfig( const unsigned int hash ) const
+			{
+				for ( size_t index = 0; index < m_Configs.size( ); ++index )
+				{
+					if ( m_Configs[ index ].GetHash( ) == hash )
+					{
+						return &m_Configs[ index ];
+					}
+				}
+				return 0;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
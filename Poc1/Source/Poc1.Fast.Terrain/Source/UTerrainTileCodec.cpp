@@ -0,0 +1,200 @@
+#include "Stdafx.h"
+#include "UTerrainTileCodec.h"
+
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Largest quantized value
+			static const int MaxQuantized = 65535;
+
+			///	\brief	Returns true if a sample is on the edge of its grid
+			inline bool IsEdge( const int width, const int height, const int x, const int y )
+			{
+				return ( x == 0 ) || ( y == 0 ) || ( x == width - 1 ) || ( y == height - 1 );
+			}
+
+			///	\brief	Quantizes a value in a channel's range. Worked in doubles, so values are rounded to the nearest step
+			inline int Quantize( const float value, const float minValue, const float maxValue )
+			{
+				if ( !( maxValue > minValue ) )
+				{
+					return 0;
+				}
+				const int quantized = int( ( double( value ) - double( minValue ) ) * double( MaxQuantized ) / ( double( maxValue ) - double( minValue ) ) + 0.5 );
+				return quantized < 0 ? 0 : ( quantized > MaxQuantized ? MaxQuantized : quantized );
+			}
+
+			///	\brief	Gets the value of a quantized step. Worked in doubles, so it is only rounded once
+			inline float Dequantize( const int quantized, const float minValue, const float maxValue )
+			{
+				return float( double( minValue ) + double( quantized ) * ( double( maxValue ) - double( minValue ) ) / double( MaxQuantized ) );
+			}
+
+			///	\brief	Gets the bits of a float
+			inline unsigned int GetBits( const float value )
+			{
+				unsigned int bits;
+				memcpy( &bits, &value, sizeof( bits ) );
+				return bits;
+			}
+
+			///	\brief	Predicts the bits of an edge sample from the previous sample along its edge
+			inline unsigned int PredictEdge( const float* samples, const int channels, const int width, const int x, const int y )
+			{
+				if ( ( y == 0 ) || ( ( x > 0 ) && ( x < width - 1 ) ) )
+				{
+					return x == 0 ? 0 : GetBits( samples[ ( y * width + x - 1 ) * channels ] );
+				}
+				return GetBits( samples[ ( ( y - 1 ) * width + x ) * channels ] );
+			}
+
+			///	\brief	Writes a zig-zag coded difference, 7 bits per byte
+			inline void WriteDifference( const int difference, std::vector< unsigned char >& encoded )
+			{
+				unsigned int zigZag = ( ( unsigned int )difference << 1 ) ^ ( unsigned int )( difference >> 31 );
+				while ( zigZag >= 0x80 )
+				{
+					encoded.push_back( ( unsigned char )( zigZag | 0x80 ) );
+					zigZag >>= 7;
+				}
+				encoded.push_back( ( unsigned char )zigZag );
+			}
+
+			///	\brief	Reads a difference written by WriteDifference(). Returns false if the encoded bytes run out
+			inline bool ReadDifference( const unsigned char*& read, const unsigned char* end, int& difference )
+			{
+				unsigned int zigZag = 0;
+				for ( int shift = 0; ; shift += 7 )
+				{
+					if ( read == end || shift > 28 )
+					{
+						return false;
+					}
+					const unsigned int byte = *read++;
+					zigZag |= ( byte & 0x7f ) << shift;
+					if ( byte < 0x80 )
+					{
+						break;
+					}
+				}
+				difference = int( zigZag >> 1 ) ^ -int( zigZag & 1 );
+				return true;
+			}
+
+			///	\brief	Predicts a quantized value from its left, upper and upper-left neighbours
+			inline int Predict( const int* quantized, const int width, const int x, const int y )
+			{
+				const int index = y * width + x;
+				if ( y == 0 )
+				{
+					return x == 0 ? 0 : quantized[ index - 1 ];
+				}
+				if ( x == 0 )
+				{
+					return quantized[ index - width ];
+				}
+				return quantized[ index - 1 ] + quantized[ index - width ] - quantized[ index - width - 1 ];
+			}
+
+			//	------------------------------------------------------- UTerrainTileCodec Methods
+
+			void UTerrainTileCodec::Encode( const float* samples, const int width, const int height, const int channels, std::vector< unsigned char >& encoded )
+			{
+				const int count = width * height;
+				std::vector< int > quantized( count );
+				encoded.resize( channels * 2 * sizeof( float ) );
+				encoded.reserve( encoded.size( ) + channels * count * 2 );
+				for ( int channel = 0; channel < channels; ++channel )
+				{
+					float minValue = samples[ channel ];
+					float maxValue = samples[ channel ];
+					for ( int index = 1; index < count; ++index )
+					{
+						const float value = samples[ index * channels + channel ];
+						minValue = value < minValue ? value : minValue;
+						maxValue = value > maxValue ? value : maxValue;
+					}
+					memcpy( &encoded[ channel * 2 * sizeof( float ) ], &minValue, sizeof( float ) );
+					memcpy( &encoded[ ( channel * 2 + 1 ) * sizeof( float ) ], &maxValue, sizeof( float ) );
+
+					for ( int index = 0; index < count; ++index )
+					{
+						quantized[ index ] = Quantize( samples[ index * channels + channel ], minValue, maxValue );
+					}
+
+					for ( int y = 0; y < height; ++y )
+					{
+						for ( int x = 0; x < width; ++x )
+						{
+							const int index = y * width + x;
+							if ( IsEdge( width, height, x, y ) )
+							{
+								const unsigned int bits = GetBits( samples[ index * channels + channel ] );
+								WriteDifference( int( bits - PredictEdge( samples + channel, channels, width, x, y ) ), encoded );
+							}
+							else
+							{
+								WriteDifference( quantized[ index ] - Predict( &quantized[ 0 ], width, x, y ), encoded );
+							}
+						}
+					}
+				}
+			}
+
+			bool UTerrainTileCodec::Decode( const unsigned char* encoded, const int size, const int width, const int height, const int channels, float* samples )
+			{
+				const int count = width * height;
+				if ( size < int( channels * 2 * sizeof( float ) ) )
+				{
+					return false;
+				}
+				std::vector< int > quantized( count );
+				const unsigned char* read = encoded + channels * 2 * sizeof( float );
+				const unsigned char* end = encoded + size;
+				for ( int channel = 0; channel < channels; ++channel )
+				{
+					float minValue, maxValue;
+					memcpy( &minValue, encoded + channel * 2 * sizeof( float ), sizeof( float ) );
+					memcpy( &maxValue, encoded + ( channel * 2 + 1 ) * sizeof( float ), sizeof( float ) );
+
+					for ( int y = 0; y < height; ++y )
+					{
+						for ( int x = 0; x < width; ++x )
+						{
+							int difference;
+							if ( !ReadDifference( read, end, difference ) )
+							{
+								return false;
+							}
+							const int index = y * width + x;
+							float& sample = samples[ index * channels + channel ];
+							if ( IsEdge( width, height, x, y ) )
+							{
+								//	Edge samples are quantized too, as neighbours of the samples inside the edges
+								const unsigned int bits = PredictEdge( samples + channel, channels, width, x, y ) + ( unsigned int )difference;
+								memcpy( &sample, &bits, sizeof( sample ) );
+								quantized[ index ] = Quantize( sample, minValue, maxValue );
+							}
+							else
+							{
+								quantized[ index ] = Predict( &quantized[ 0 ], width, x, y ) + difference;
+								sample = Dequantize( quantized[ index ], minValue, maxValue );
+							}
+						}
+					}
+				}
+				return true;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,496 @@
+#include "Stdafx.h"
+#include "UTerrainTilePyramid.h"
+#include "UTerrainTileCodec.h"
+#include "UTerrainGenerator.h"
+#include <Mem.h>
+#include <Scalar/ScalarUtils.h>
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Number of floats in a vertex, as encoded by UTerrainTileCodec
+			static const int VertexChannels = sizeof( UTerrainVertex ) / sizeof( float );
+
+			///	\brief	Gets a sphere around the positions of the vertices of a tile
+			static void GetTileBounds( const UTerrainVertex* vertices, const int count, float* centre, float& radius )
+			{
+				float minPos[ 3 ] = { vertices[ 0 ].X( ), vertices[ 0 ].Y( ), vertices[ 0 ].Z( ) };
+				float maxPos[ 3 ] = { minPos[ 0 ], minPos[ 1 ], minPos[ 2 ] };
+				for ( int index = 1; index < count; ++index )
+				{
+					const float pos[ 3 ] = { vertices[ index ].X( ), vertices[ index ].Y( ), vertices[ index ].Z( ) };
+					for ( int axis = 0; axis < 3; ++axis )
+					{
+						minPos[ axis ] = pos[ axis ] < minPos[ axis ] ? pos[ axis ] : minPos[ axis ];
+						maxPos[ axis ] = pos[ axis ] > maxPos[ axis ] ? pos[ axis ] : maxPos[ axis ];
+					}
+				}
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					centre[ axis ] = ( minPos[ axis ] + maxPos[ axis ] ) * 0.5f;
+				}
+
+				float sqrRadius = 0;
+				for ( int index = 0; index < count; ++index )
+				{
+					const float dx = vertices[ index ].X( ) - centre[ 0 ];
+					const float dy = vertices[ index ].Y( ) - centre[ 1 ];
+					const float dz = vertices[ index ].Z( ) - centre[ 2 ];
+					const float sqrDistance = dx * dx + dy * dy + dz * dz;
+					sqrRadius = sqrDistance > sqrRadius ? sqrDistance : sqrRadius;
+				}
+
+				//	Pad the radius, so that it still contains every vertex after rounding
+				radius = sqrtf( sqrRadius ) * 1.0001f;
+			}
+
+			///	\brief	Replaces the left column and top row of a tile with the edges of the tiles to its left and above. Either edge can be null
+			static void CopySharedEdges( UTerrainVertex* vertices, const int resolution, const UTerrainVertex* leftEdge, const UTerrainVertex* topEdge )
+			{
+				for ( int k = 0; leftEdge && ( k < resolution ); ++k )
+				{
+					vertices[ k * resolution ] = leftEdge[ k ];
+				}
+				for ( int k = 0; topEdge && ( k < resolution ); ++k )
+				{
+					vertices[ k ] = topEdge[ k ];
+				}
+			}
+
+			//	----------------------------------------------------- UTerrainTilePyramid Methods
+
+			void UTerrainTilePyramid::GetTilePatch( const UTerrainTileRoot& root, const int resolution, const int level, const int x, const int y, float* origin, float* xStep, float* zStep, float* uv, float& uvRes )
+			{
+				const float scale = ldexpf( 1.0f, -level );
+				const float stepScale = scale / float( resolution - 1 );
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					origin[ axis ] = root.m_Origin[ axis ] + root.m_UAxis[ axis ] * ( float( x ) * scale ) + root.m_VAxis[ axis ] * ( float( y ) * scale );
+					xStep[ axis ] = root.m_UAxis[ axis ] * stepScale;
+					zStep[ axis ] = root.m_VAxis[ axis ] * stepScale;
+				}
+				uvRes = root.m_UvRes * scale;
+				uv[ 0 ] = root.m_Uv[ 0 ] + float( x ) * uvRes;
+				uv[ 1 ] = root.m_Uv[ 1 ] + float( y ) * uvRes;
+			}
+
+			void UTerrainTilePyramid::GetTileVertices( UTerrainGenerator& generator, const UTerrainTileRoot& root, const int resolution, const int level, const int x, const int y, UTerrainVertex* vertices, float& error )
+			{
+				float origin[ 3 ], xStep[ 3 ], zStep[ 3 ], uv[ 2 ], uvRes;
+				GetTilePatch( root, resolution, level, x, y, origin, xStep, zStep, uv, uvRes );
+				error = 0;
+				generator.GenerateVertices( origin, xStep, zStep, resolution, resolution, uv, uvRes, vertices, error );
+				if ( ( x == 0 ) && ( y == 0 ) )
+				{
+					return;
+				}
+
+				//	The right column of the tile to the left, and the bottom row of the tile above. When there are both,
+				//	the first vertex of the bottom row comes from the tile above and to the left, as it does in Bake()
+				const int vertexCount = resolution * resolution;
+				UTerrainVertex* neighbour = new ( Aligned( 16 ) ) UTerrainVertex[ vertexCount ];
+				std::vector< UTerrainVertex > leftEdge( resolution );
+				std::vector< UTerrainVertex > topEdge( resolution );
+				float neighbourError = 0;
+				if ( x > 0 )
+				{
+					GetTilePatch( root, resolution, level, x - 1, y, origin, xStep, zStep, uv, uvRes );
+					generator.GenerateVertices( origin, xStep, zStep, resolution, resolution, uv, uvRes, neighbour, neighbourError );
+					for ( int k = 0; k < resolution; ++k )
+					{
+						leftEdge[ k ] = neighbour[ k * resolution + resolution - 1 ];
+					}
+				}
+				if ( y > 0 )
+				{
+					GetTilePatch( root, resolution, level, x, y - 1, origin, xStep, zStep, uv, uvRes );
+					generator.GenerateVertices( origin, xStep, zStep, resolution, resolution, uv, uvRes, neighbour, neighbourError );
+					for ( int k = 0; k < resolution; ++k )
+					{
+						topEdge[ k ] = neighbour[ vertexCount - resolution + k ];
+					}
+				}
+				if ( ( x > 0 ) && ( y > 0 ) )
+				{
+					GetTilePatch( root, resolution, level, x - 1, y - 1, origin, xStep, zStep, uv, uvRes );
+					generator.GenerateVertices( origin, xStep, zStep, resolution, resolution, uv, uvRes, neighbour, neighbourError );
+					topEdge[ 0 ] = neighbour[ vertexCount - 1 ];
+				}
+				AlignedArrayDelete( neighbour );
+
+				CopySharedEdges( vertices, resolution, x > 0 ? &leftEdge[ 0 ] : 0, y > 0 ? &topEdge[ 0 ] : 0 );
+			}
+
+			void UTerrainTilePyramid::GetCubeRoots( UTerrainTileRoot* roots )
+			{
+				for ( int face = 0; face < 6; ++face )
+				{
+					float corners[ 3 ][ 3 ];
+					ScalarCubeFacePosition( UCubeMapFace( face ), -1, -1, corners[ 0 ][ 0 ], corners[ 0 ][ 1 ], corners[ 0 ][ 2 ] );
+					ScalarCubeFacePosition( UCubeMapFace( face ), 1, -1, corners[ 1 ][ 0 ], corners[ 1 ][ 1 ], corners[ 1 ][ 2 ] );
+					ScalarCubeFacePosition( UCubeMapFace( face ), -1, 1, corners[ 2 ][ 0 ], corners[ 2 ][ 1 ], corners[ 2 ][ 2 ] );
+					for ( int axis = 0; axis < 3; ++axis )
+					{
+						roots[ face ].m_Origin[ axis ] = corners[ 0 ][ axis ];
+						roots[ face ].m_UAxis[ axis ] = corners[ 1 ][ axis ] - corners[ 0 ][ axis ];
+						roots[ face ].m_VAxis[ axis ] = corners[ 2 ][ axis ] - corners[ 0 ][ axis ];
+					}
+					roots[ face ].m_Uv[ 0 ] = 0;
+					roots[ face ].m_Uv[ 1 ] = 0;
+					roots[ face ].m_UvRes = 1;
+				}
+			}
+
+			bool UTerrainTilePyramid::Bake( const char* path, UTerrainGenerator& generator, const UTerrainTileRoot* roots, const int resolution, const int depth )
+			{
+				if ( ( resolution < 2 ) || ( depth < 1 ) || ( depth > MaxDepth ) )
+				{
+					return false;
+				}
+				FILE* file = fopen( path, "wb" );
+				if ( file == 0 )
+				{
+					return false;
+				}
+
+				UTerrainTilePyramidHeader header;
+				memset( &header, 0, sizeof( header ) );
+				header.m_Magic = Magic;
+				header.m_Version = Version;
+				header.m_Resolution = resolution;
+				header.m_Depth = depth;
+				memcpy( header.m_Roots, roots, sizeof( header.m_Roots ) );
+				bool written = fwrite( &header, sizeof( header ), 1, file ) == 1;
+
+				const int vertexCount = resolution * resolution;
+				const int tileCount = GetTilesPerFace( depth ) * 6;
+				UTerrainVertex* vertices = new ( Aligned( 16 ) ) UTerrainVertex[ vertexCount ];
+				std::vector< UTerrainTileEntry > entries( tileCount );
+				std::vector< unsigned char > encoded;
+				long long offset = sizeof( header );
+
+				//	Bottom rows of the previous row of tiles, and the right column of the previous tile, for CopySharedEdges()
+				std::vector< UTerrainVertex > bottomEdges( resolution << ( depth - 1 ) );
+				std::vector< UTerrainVertex > rightEdge( resolution );
+
+				//	Tiles are generated in index order, so they are written in index order
+				for ( int face = 0; ( face < 6 ) && written; ++face )
+				{
+					for ( int level = 0; ( level < depth ) && written; ++level )
+					{
+						for ( int y = 0; ( y < ( 1 << level ) ) && written; ++y )
+						{
+							for ( int x = 0; ( x < ( 1 << level ) ) && written; ++x )
+							{
+								float origin[ 3 ], xStep[ 3 ], zStep[ 3 ], uv[ 2 ], uvRes;
+								GetTilePatch( roots[ face ], resolution, level, x, y, origin, xStep, zStep, uv, uvRes );
+
+								UTerrainTileEntry& entry = entries[ GetTileIndex( depth, face, level, x, y ) ];
+								entry.m_Error = 0;
+								generator.GenerateVertices( origin, xStep, zStep, resolution, resolution, uv, uvRes, vertices, entry.m_Error );
+
+								UTerrainVertex* bottomEdge = &bottomEdges[ x * resolution ];
+								CopySharedEdges( vertices, resolution, x > 0 ? &rightEdge[ 0 ] : 0, y > 0 ? bottomEdge : 0 );
+								for ( int k = 0; k < resolution; ++k )
+								{
+									rightEdge[ k ] = vertices[ k * resolution + resolution - 1 ];
+									bottomEdge[ k ] = vertices[ vertexCount - resolution + k ];
+								}
+								GetTileBounds( vertices, vertexCount, entry.m_Centre, entry.m_Radius );
+
+								UTerrainTileCodec::Encode( ( const float* )vertices, resolution, resolution, VertexChannels, encoded );
+								entry.m_Offset = offset;
+								entry.m_Size = int( encoded.size( ) );
+								written = fwrite( &encoded[ 0 ], encoded.size( ), 1, file ) == 1;
+								offset += encoded.size( );
+							}
+						}
+					}
+				}
+				AlignedArrayDelete( vertices );
+
+				//	The index starts on a multiple of 8 bytes, so that it can be read straight from the mapped file
+				if ( written )
+				{
+					const unsigned char padding[ 8 ] = { 0 };
+					const int paddingSize = int( ( 8 - ( offset % 8 ) ) % 8 );
+					written = ( paddingSize == 0 ) || ( fwrite( padding, paddingSize, 1, file ) == 1 );
+					header.m_IndexOffset = offset + paddingSize;
+				}
+				if ( written )
+				{
+					written = fwrite( &entries[ 0 ], sizeof( UTerrainTileEntry ) * entries.size( ), 1, file ) == 1;
+				}
+				if ( written )
+				{
+					written = ( fseek( file, 0, SEEK_SET ) == 0 ) && ( fwrite( &header, sizeof( header ), 1, file ) == 1 );
+				}
+				written = ( fclose( file ) == 0 ) && written;
+				return written;
+			}
+
+			//	---------------------------------------------------- UTerrainTileStreamer Methods
+
+			UTerrainTileStreamer::UTerrainTileStreamer( ) :
+				m_TileCount( 0 ),
+				m_Frame( 0 )
+			{
+				memset( &m_Header, 0, sizeof( m_Header ) );
+			}
+
+			UTerrainTileStreamer::~UTerrainTileStreamer( )
+			{
+				Close( );
+			}
+
+			bool UTerrainTileStreamer::Open( const char* path, const int maxResidentTiles, const long long windowSize, const int maxWindows )
+			{
+				//	Windows overlap by enough to read the header or an index entry from any window, until the largest tile is known
+				Close( );
+				if ( ( maxResidentTiles < 1 ) || !m_Windows.Open( path, windowSize, sizeof( UTerrainTilePyramidHeader ), maxWindows ) )
+				{
+					return false;
+				}
+
+				//	Check that the header, the index, and every tile it points to, are inside the file
+				const UTerrainTilePyramidHeader* header = ( const UTerrainTilePyramidHeader* )m_Windows.GetRange( 0, sizeof( UTerrainTilePyramidHeader ) );
+				bool valid =
+					( header != 0 ) &&
+					( header->m_Magic == UTerrainTilePyramid::Magic ) && ( header->m_Version == UTerrainTilePyramid::Version ) &&
+					( header->m_Resolution >= 2 ) && ( header->m_Depth >= 1 ) && ( header->m_Depth <= UTerrainTilePyramid::MaxDepth ) &&
+					( ( header->m_IndexOffset % 8 ) == 0 ) && ( header->m_IndexOffset >= ( long long )sizeof( UTerrainTilePyramidHeader ) );
+				const int tileCount = valid ? UTerrainTilePyramid::GetTilesPerFace( header->m_Depth ) * 6 : 0;
+				valid = valid && ( header->m_IndexOffset + ( long long )sizeof( UTerrainTileEntry ) * tileCount <= m_Windows.GetSize( ) );
+				if ( !valid )
+				{
+					m_Windows.Close( );
+					return false;
+				}
+				m_Header = *header;
+				m_TileCount = tileCount;
+
+				long long maxTileSize = 0;
+				UTerrainTileEntry entry = { 0 };
+				for ( int tile = 0; ( tile < tileCount ) && valid; ++tile )
+				{
+					valid = ReadEntry( tile, entry ) && ( entry.m_Offset >= 0 ) && ( entry.m_Size >= 0 ) && ( entry.m_Offset + entry.m_Size <= m_Header.m_IndexOffset );
+					maxTileSize = entry.m_Size > maxTileSize ? entry.m_Size : maxTileSize;
+				}
+
+				//	Reopen the file with windows that overlap by the largest tile, so that every tile can be read from one window
+				const long long overlap = maxTileSize > ( long long )sizeof( UTerrainTilePyramidHeader ) ? maxTileSize : sizeof( UTerrainTilePyramidHeader );
+				m_Windows.Close( );
+				valid = valid && m_Windows.Open( path, windowSize, overlap, maxWindows ) && ( m_Windows.GetSize( ) >= m_Header.m_IndexOffset + ( long long )sizeof( UTerrainTileEntry ) * tileCount );
+				if ( !valid )
+				{
+					Close( );
+					return false;
+				}
+
+				m_Frame = 0;
+				Slot emptySlot = { -1, 0, 0 };
+				m_Slots.assign( maxResidentTiles, emptySlot );
+				return true;
+			}
+
+			void UTerrainTileStreamer::Close( )
+			{
+				for ( size_t slot = 0; slot < m_Slots.size( ); ++slot )
+				{
+					AlignedArrayDelete( m_Slots[ slot ].m_Vertices );
+				}
+				m_Slots.clear( );
+				m_Resident.clear( );
+				m_Requests.clear( );
+				memset( &m_Header, 0, sizeof( m_Header ) );
+				m_TileCount = 0;
+				m_Windows.Close( );
+			}
+
+			int UTerrainTileStreamer::GetTileIndex( const int face, const int level, const int x, const int y ) const
+			{
+				if ( !IsOpen( ) || ( face < 0 ) || ( face >= 6 ) || ( level < 0 ) || ( level >= m_Header.m_Depth ) )
+				{
+					return -1;
+				}
+				if ( ( x < 0 ) || ( y < 0 ) || ( x >= ( 1 << level ) ) || ( y >= ( 1 << level ) ) )
+				{
+					return -1;
+				}
+				return UTerrainTilePyramid::GetTileIndex( m_Header.m_Depth, face, level, x, y );
+			}
+
+			bool UTerrainTileStreamer::ReadEntry( const int tile, UTerrainTileEntry& entry )
+			{
+				const unsigned char* data = m_Windows.GetRange( m_Header.m_IndexOffset + ( long long )sizeof( UTerrainTileEntry ) * tile, sizeof( UTerrainTileEntry ) );
+				if ( data == 0 )
+				{
+					return false;
+				}
+				memcpy( &entry, data, sizeof( UTerrainTileEntry ) );
+				return true;
+			}
+
+			bool UTerrainTileStreamer::GetEntry( const int face, const int level, const int x, const int y, UTerrainTileEntry& entry )
+			{
+				const int tile = GetTileIndex( face, level, x, y );
+				return ( tile >= 0 ) && ReadEntry( tile, entry );
+			}
+
+			float UTerrainTileStreamer::GetPriority( const UTerrainTileEntry& entry, const float* position )
+			{
+				const float dx = entry.m_Centre[ 0 ] - position[ 0 ];
+				const float dy = entry.m_Centre[ 1 ] - position[ 1 ];
+				const float dz = entry.m_Centre[ 2 ] - position[ 2 ];
+
+				//	Distance to the bounding sphere, rather than its centre, so that tiles around the position come first
+				const float distance = sqrtf( dx * dx + dy * dy + dz * dz ) - entry.m_Radius;
+				const float minDistance = entry.m_Radius * 0.001f;
+				return entry.m_Radius / ( distance > minDistance ? distance : minDistance );
+			}
+
+			void UTerrainTileStreamer::Request( const int face, const int level, const int x, const int y, const float priority )
+			{
+				const int tile = GetTileIndex( face, level, x, y );
+				if ( tile >= 0 )
+				{
+					const TileRequest request = { priority, tile };
+					m_Requests.push_back( request );
+				}
+			}
+
+			int UTerrainTileStreamer::FindFreeSlot( ) const
+			{
+				int freeSlot = -1;
+				for ( int slot = 0; slot < int( m_Slots.size( ) ); ++slot )
+				{
+					if ( m_Slots[ slot ].m_Tile < 0 )
+					{
+						return slot;
+					}
+					if ( ( m_Slots[ slot ].m_LastUsed != m_Frame ) && ( ( freeSlot < 0 ) || ( m_Slots[ slot ].m_LastUsed < m_Slots[ freeSlot ].m_LastUsed ) ) )
+					{
+						freeSlot = slot;
+					}
+				}
+				return freeSlot;
+			}
+
+			void UTerrainTileStreamer::PrefetchChildren( const int tile )
+			{
+				//	Find the level and position of the tile, and the first of its children
+				const int depth = m_Header.m_Depth;
+				const int tilesPerFace = UTerrainTilePyramid::GetTilesPerFace( depth );
+				const int face = tile / tilesPerFace;
+				int level = 0;
+				while ( UTerrainTilePyramid::GetTilesPerFace( level + 1 ) <= tile % tilesPerFace )
+				{
+					++level;
+				}
+				if ( level + 1 >= depth )
+				{
+					return;
+				}
+				const int position = tile % tilesPerFace - UTerrainTilePyramid::GetTilesPerFace( level );
+				const int x = position & ( ( 1 << level ) - 1 );
+				const int y = position >> level;
+
+				//	Children are stored in two runs of two tiles, one for each row. Each is prefetched from the window
+				//	it starts in, as a run can be longer than the overlap between windows
+				for ( int child = 0; child < 4; ++child )
+				{
+					UTerrainTileEntry entry;
+					if ( ReadEntry( UTerrainTilePyramid::GetTileIndex( depth, face, level + 1, x * 2 + ( child & 1 ), y * 2 + ( child >> 1 ) ), entry ) )
+					{
+						m_Windows.Prefetch( entry.m_Offset, entry.m_Size );
+					}
+				}
+			}
+
+			int UTerrainTileStreamer::Update( const int maxDecodes )
+			{
+				if ( !IsOpen( ) )
+				{
+					return 0;
+				}
+				++m_Frame;
+				std::sort( m_Requests.begin( ), m_Requests.end( ) );
+
+				//	Mark resident tiles first, so that no requested tile is replaced
+				for ( size_t request = 0; request < m_Requests.size( ); ++request )
+				{
+					std::map< int, int >::const_iterator resident = m_Resident.find( m_Requests[ request ].m_Tile );
+					if ( resident != m_Resident.end( ) )
+					{
+						m_Slots[ resident->second ].m_LastUsed = m_Frame;
+					}
+				}
+
+				const int vertexCount = m_Header.m_Resolution * m_Header.m_Resolution;
+				int decodes = 0;
+				for ( size_t request = 0; ( request < m_Requests.size( ) ) && ( decodes < maxDecodes ); ++request )
+				{
+					const int tile = m_Requests[ request ].m_Tile;
+					if ( m_Resident.find( tile ) != m_Resident.end( ) )
+					{
+						continue;
+					}
+					const int slot = FindFreeSlot( );
+					if ( slot < 0 )
+					{
+						break;
+					}
+
+					Slot& freeSlot = m_Slots[ slot ];
+					if ( freeSlot.m_Tile >= 0 )
+					{
+						m_Resident.erase( freeSlot.m_Tile );
+						freeSlot.m_Tile = -1;
+					}
+					if ( freeSlot.m_Vertices == 0 )
+					{
+						freeSlot.m_Vertices = new ( Aligned( 16 ) ) UTerrainVertex[ vertexCount ];
+					}
+
+					//	Tiles that don't decode (or can't be mapped) are left out, so their patches are generated at runtime
+					UTerrainTileEntry entry;
+					++decodes;
+					const unsigned char* encoded = ReadEntry( tile, entry ) ? m_Windows.GetRange( entry.m_Offset, entry.m_Size ) : 0;
+					if ( ( encoded != 0 ) && UTerrainTileCodec::Decode( encoded, entry.m_Size, m_Header.m_Resolution, m_Header.m_Resolution, VertexChannels, ( float* )freeSlot.m_Vertices ) )
+					{
+						freeSlot.m_Tile = tile;
+						freeSlot.m_LastUsed = m_Frame;
+						m_Resident[ tile ] = slot;
+					}
+				}
+
+				//	Read ahead the children of the requested tiles, in case the camera moves closer to them
+				for ( size_t request = 0; request < m_Requests.size( ); ++request )
+				{
+					PrefetchChildren( m_Requests[ request ].m_Tile );
+				}
+				m_Requests.clear( );
+				return decodes;
+			}
+
+			const UTerrainVertex* UTerrainTileStreamer::GetTile( const int face, const int level, const int x, const int y ) const
+			{
+				std::map< int, int >::const_iterator resident = m_Resident.find( GetTileIndex( face, level, x, y ) );
+				return resident == m_Resident.end( ) ? 0 : m_Slots[ resident->second ].m_Vertices;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
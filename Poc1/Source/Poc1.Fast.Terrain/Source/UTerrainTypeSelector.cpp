@@ -0,0 +1,178 @@
+#include "Stdafx.h"
+#include "UTerrainTypeSelector.h"
+
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Gets the cells either side of 4 values along an axis of a terrain type table
+			///
+			///	firstCells gets the offset of the first cell, steps gets the offset from the first cell to the second
+			///	cell (0 if the first cell is the last cell), and weights gets the 8-bit weight of the second cell.
+			///
+			inline void GetCellCoordinates( const __m128& values, const int cells, const int stride, int* firstCells, int* steps, __m128i& weights )
+			{
+				const __m128 lastCell = _mm_set1_ps( float( cells - 1 ) );
+				const __m128 positions = Clamp( _mm_mul_ps( values, lastCell ), _mm_setzero_ps( ), lastCell );
+				const __m128i firstCells32 = _mm_cvttps_epi32( positions );
+				weights = _mm_cvttps_epi32( _mm_mul_ps( _mm_sub_ps( positions, _mm_cvtepi32_ps( firstCells32 ) ), _mm_set1_ps( 256 ) ) );
+
+				_mm_store_si128( ( __m128i* )firstCells, firstCells32 );
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					steps[ lane ] = firstCells[ lane ] < ( cells - 1 ) ? stride : 0;
+					firstCells[ lane ] *= stride;
+				}
+			}
+
+			///	\brief	Blends 4 pairs of R, G, B, A colours, as ( a * ( 256 - w ) + b * w ) >> 8 for each channel
+			///
+			///	The products and their sum fit in unsigned 16-bit lanes, for weights in [0,256].
+			///
+			inline __m128i BlendColours( const __m128i& a, const __m128i& b, const __m128i& weights )
+			{
+				//	Each weight is repeated across the 4 channels of its pixel
+				const __m128i weights16 = _mm_packs_epi32( weights, weights );
+				const __m128i pairs = _mm_unpacklo_epi16( weights16, weights16 );
+				const __m128i weightsLow = _mm_unpacklo_epi32( pairs, pairs );
+				const __m128i weightsHigh = _mm_unpackhi_epi32( pairs, pairs );
+				const __m128i full = _mm_set1_epi16( 256 );
+
+				const __m128i zero = _mm_setzero_si128( );
+				const __m128i low = _mm_srli_epi16( _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( a, zero ), _mm_sub_epi16( full, weightsLow ) ), _mm_mullo_epi16( _mm_unpacklo_epi8( b, zero ), weightsLow ) ), 8 );
+				const __m128i high = _mm_srli_epi16( _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( a, zero ), _mm_sub_epi16( full, weightsHigh ) ), _mm_mullo_epi16( _mm_unpackhi_epi8( b, zero ), weightsHigh ) ), 8 );
+				return _mm_packus_epi16( low, high );
+			}
+
+			//	---------------------------------------------------- UTerrainTypeSelector Methods
+
+			UTerrainTypeSelector::UTerrainTypeSelector( )
+			{
+				SetSize( 1, 1, 1 );
+			}
+
+			void UTerrainTypeSelector::SetSize( const int latitudes, const int heights, const int slopes )
+			{
+				m_Cells[ LatitudeAxis ] = latitudes < 1 ? 1 : latitudes;
+				m_Cells[ HeightAxis ] = heights < 1 ? 1 : heights;
+				m_Cells[ SlopeAxis ] = slopes < 1 ? 1 : slopes;
+
+				const int size = m_Cells[ LatitudeAxis ] * m_Cells[ HeightAxis ] * m_Cells[ SlopeAxis ];
+				m_Colours.assign( size, 0xffffffff );
+				m_Types.assign( size, 0 );
+			}
+
+			void UTerrainTypeSelector::SetCell( const int latitude, const int height, const int slope, const UColour& colour, const unsigned char type )
+			{
+				const int index = GetCellIndex( latitude, height, slope );
+				const unsigned char bytes[ 4 ] = { colour.R( ), colour.G( ), colour.B( ), colour.A( ) };
+				memcpy( &m_Colours[ index ], bytes, sizeof( bytes ) );
+				m_Types[ index ] = type;
+			}
+
+			UColour UTerrainTypeSelector::GetCellColour( const int latitude, const int height, const int slope ) const
+			{
+				unsigned char bytes[ 4 ];
+				memcpy( bytes, &m_Colours[ GetCellIndex( latitude, height, slope ) ], sizeof( bytes ) );
+				return UColour( bytes[ 0 ], bytes[ 1 ], bytes[ 2 ], bytes[ 3 ] );
+			}
+
+			void UTerrainTypeSelector::WritePixels( const UPixelFormat format, const __m128& latitudes, const __m128& heights, const __m128& slopes, unsigned char* pixels ) const
+			{
+				const __m128 values[ 3 ] = { latitudes, heights, slopes };
+				const int strides[ 3 ] = { m_Cells[ HeightAxis ] * m_Cells[ SlopeAxis ], m_Cells[ SlopeAxis ], 1 };
+
+				FAST_ALIGN( 16 ) int firstCells[ 3 ][ 4 ];
+				int steps[ 3 ][ 4 ];
+				__m128i weights[ 3 ];
+				for ( int axis = 0; axis < 3; ++axis )
+				{
+					GetCellCoordinates( values[ axis ], m_Cells[ axis ], strides[ axis ], firstCells[ axis ], steps[ axis ], weights[ axis ] );
+				}
+
+				if ( GetBytesPerPixel( format ) == 1 )
+				{
+					//	Types are not blended. Step to the second cell along each axis where it has the larger weight
+					FAST_ALIGN( 16 ) int weightValues[ 3 ][ 4 ];
+					for ( int axis = 0; axis < 3; ++axis )
+					{
+						_mm_store_si128( ( __m128i* )weightValues[ axis ], weights[ axis ] );
+					}
+					for ( int pixel = 0; pixel < 4; ++pixel )
+					{
+						int index = 0;
+						for ( int axis = 0; axis < 3; ++axis )
+						{
+							index += firstCells[ axis ][ pixel ] + ( weightValues[ axis ][ pixel ] >= 128 ? steps[ axis ][ pixel ] : 0 );
+						}
+						pixels[ pixel ] = m_Types[ index ];
+					}
+					return;
+				}
+
+				//	Gather the 8 cells around each pixel. Bit 2 of the corner steps along the latitude axis, bit 1
+				//	along the height axis, and bit 0 along the slope axis
+				__m128i corners[ 8 ];
+				for ( int corner = 0; corner < 8; ++corner )
+				{
+					FAST_ALIGN( 16 ) unsigned int colours[ 4 ];
+					for ( int pixel = 0; pixel < 4; ++pixel )
+					{
+						int index = firstCells[ LatitudeAxis ][ pixel ] + firstCells[ HeightAxis ][ pixel ] + firstCells[ SlopeAxis ][ pixel ];
+						index += ( corner & 4 ) ? steps[ LatitudeAxis ][ pixel ] : 0;
+						index += ( corner & 2 ) ? steps[ HeightAxis ][ pixel ] : 0;
+						index += ( corner & 1 ) ? steps[ SlopeAxis ][ pixel ] : 0;
+						colours[ pixel ] = m_Colours[ index ];
+					}
+					corners[ corner ] = _mm_load_si128( ( const __m128i* )colours );
+				}
+
+				//	Blend along the slope axis, then the height axis, then the latitude axis
+				for ( int corner = 0; corner < 4; ++corner )
+				{
+					corners[ corner ] = BlendColours( corners[ corner * 2 ], corners[ corner * 2 + 1 ], weights[ SlopeAxis ] );
+				}
+				for ( int corner = 0; corner < 2; ++corner )
+				{
+					corners[ corner ] = BlendColours( corners[ corner * 2 ], corners[ corner * 2 + 1 ], weights[ HeightAxis ] );
+				}
+				const __m128i colours = BlendColours( corners[ 0 ], corners[ 1 ], weights[ LatitudeAxis ] );
+
+				//	Blue first formats swap bytes 0 and 2 of each pixel
+				const bool blueFirst = ( format == FormatB8G8R8A8 ) || ( format == FormatB8G8R8 );
+				const __m128i redBlue = _mm_and_si128( colours, _mm_set1_epi32( 0x00ff00ff ) );
+				const __m128i greenAlpha = _mm_andnot_si128( _mm_set1_epi32( 0x00ff00ff ), colours );
+				const __m128i blueRed = _mm_or_si128( _mm_slli_epi32( redBlue, 16 ), _mm_srli_epi32( redBlue, 16 ) );
+				const __m128i ordered = blueFirst ? _mm_or_si128( greenAlpha, blueRed ) : colours;
+
+				switch ( format )
+				{
+					case FormatR8G8B8A8 :
+					case FormatB8G8R8A8 :
+						_mm_storeu_si128( ( __m128i* )pixels, ordered );
+						break;
+
+					default :
+						{
+							FAST_ALIGN( 16 ) unsigned char bytes[ 16 ];
+							_mm_store_si128( ( __m128i* )bytes, ordered );
+							for ( int pixel = 0; pixel < 4; ++pixel )
+							{
+								memcpy( pixels + pixel * 3, bytes + pixel * 4, 3 );
+							}
+							break;
+						}
+				};
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,56 @@
+#pragma once
+
+//	Erk...
+using namespace System::Drawing::Imaging;
+using namespace Rb::Rendering::Interfaces::Objects;
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			class USphereCloudsAnimation;
+
+			///	\brief	Generates animated cloud cube maps, spreading cloud generation evenly over frames
+			///
+			///	Faces are blended between keyframes. Each call to Update() generates a fixed share of a future keyframe,
+			///	so there are no full regenerations after Start().
+			///
+			public ref class SphereCloudsAnimation
+			{
+				public :
+
+					///	\brief	Sets up the face size, and the number of frames between keyframes
+					SphereCloudsAnimation( const int width, const int height, const int framesPerKey );
+
+					~SphereCloudsAnimation( );
+
+					!SphereCloudsAnimation( );
+
+					///	\brief	Starts the animation. xVelocity and zVelocity are the offset changes between keyframes
+					void Start( float xOffset, float zOffset, float xVelocity, float zVelocity, float cloudCutoff, float cloudBorder );
+
+					///	\brief	Advances the animation by a frame
+					void Update( );
+
+					///	\brief	Writes a face of the cube map for the current frame
+					void GetFace( CubeMapFace face, PixelFormat format, const int stride, unsigned char* pixels );
+
+					///	\brief	Writes a face of the cube map for the current frame, its mip levels, and a compressed copy, in one pass
+					///
+					///	Levels and blocks are laid out in the same way as SphereCloudsBitmap::GenerateFace().
+					///
+					void GetFace( CubeMapFace face, PixelFormat format, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides, unsigned char* blocks, const int blockRowStride );
+
+				private :
+
+					USphereCloudsAnimation* m_pImpl;
+
+			}; //SphereCloudsAnimation
+
+		}; //Terrain
+
+	}; //Fast
+
+}; //Poc1
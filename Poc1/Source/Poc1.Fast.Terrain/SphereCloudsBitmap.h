@@ -1,5 +1,7 @@
 #pragma once
 
+#include "TerrainFunction.h"
+
 //	Erk...
 using namespace System::Drawing::Imaging;
 using namespace Rb::Rendering::Interfaces::Objects;
@@ -10,7 +12,7 @@ namespace Poc1
 	{
 		namespace Terrain
 		{
-			class SphereCloudsBitmapImpl;
+			class USphereCloudsBitmap;
 
 			///	\brief	Generates cloud bitmaps for cube mapping onto a sphere
 			public ref class SphereCloudsBitmap
@@ -26,12 +28,29 @@ namespace Poc1
 					///	\brief	Sets generation parameters
 					void Setup( float xOffset, float zOffset, float cloudCutoff, float cloudBorder );
 
+					///	\brief	Sets the mapping from face coordinates to sphere positions
+					void SetProjection( CubeMapProjection projection );
+
 					///	\brief	Generates a face of a cube map
 					void GenerateFace( CubeMapFace face, PixelFormat format, const int width, const int height, const int stride, unsigned char* pixels );
 
+					///	\brief	Generates a face of a cube map, its mip levels, and a compressed copy, in one pass
+					///
+					///	mipPixels and mipStrides describe the levels below the face, starting with the level half its size.
+					///	If blocks is not null, the face is also compressed, blockRowStride bytes apart: BC4 blocks for
+					///	Format8bppIndexed faces, and BC3 blocks for the rest.
+					///
+					void GenerateFace( CubeMapFace face, PixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides, unsigned char* blocks, const int blockRowStride );
+
+					///	\brief	Generates all six faces of a cube map, with seams that match across faces
+					///
+					///	facePixels has the pixels of each face, indexed by CubeMapFace. Faces are size x size pixels.
+					///
+					void GenerateCubeMap( PixelFormat format, const int size, const int stride, array< System::IntPtr >^ facePixels );
+
 				private :
 
-					SphereCloudsBitmapImpl* m_pImpl;
+					USphereCloudsBitmap* m_pImpl;
 
 			}; //SphereCloudsBitmap
 
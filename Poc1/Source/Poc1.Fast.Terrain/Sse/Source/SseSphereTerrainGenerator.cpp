@@ -1,5 +1,5 @@
-#include "stdafx.h"
-#include "Sse\SseSphereTerrainGenerator.h"
+#include "Stdafx.h"
+#include "Sse/SseSphereTerrainGenerator.h"
 
 #pragma unmanaged
 
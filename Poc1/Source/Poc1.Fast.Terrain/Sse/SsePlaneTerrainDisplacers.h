@@ -1,7 +1,10 @@
 #pragma once
 #pragma managed( push, off )
 
+#include <Sse/SseFunctionBounds.h>
+
 #include "SseTerrainDisplacer.h"
+#include <math.h>
 
 namespace Poc1
 {
@@ -14,6 +17,7 @@ namespace Poc1
 			{
 				public :
 
+					template < typename Precision >
 					inline void GetUpVector( __m128& xxxx, __m128& yyyy, __m128& zzzz )
 					{
 						xxxx = Constants::Fc_0;
@@ -21,6 +25,7 @@ namespace Poc1
 						zzzz = Constants::Fc_0;
 					}
 
+					template < typename Precision >
 					inline void MapToDisplacementSpace( __m128& xxxx, __m128& yyyy, __m128& zzzz )
 					{
 					}
@@ -32,17 +37,26 @@ namespace Poc1
 				public :
 
 					///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of this displacer.
+					template < typename Precision >
 					inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
 					{
+						FAST_INSTRUMENT_COUNT( CounterDisplaceCalls, 1 );
 						yyyy = _mm_add_ps( yyyy, m_MinHeight );	//	TODO: AP: Take into account function scale, etc.
 						return _mm_set1_ps( 0 );
 					}
+
+					///	\brief	Gets the range of heights that Displace() can return for positions in a region
+					void GetHeightBounds( const SseFunctionRegion&, float& minHeight, float& maxHeight ) const
+					{
+						minHeight = 0;
+						maxHeight = 0;
+					}
 			}; //SseFlatPlaneTerrainDisplacer
 			
 			
 			///	\brief	Displacer decorator class. Adds x-z displacement to an existing displacer
 			template < typename BaseDisplacer, typename FunctionType >
-			class _CRT_ALIGN( 16 ) SsePlaneFunction3dGroundDisplacer : public SsePlaneTerrainDisplacer
+			class FAST_ALIGN( 16 ) SsePlaneFunction3dGroundDisplacer : public SsePlaneTerrainDisplacer
 			{
 				public :
 
@@ -91,13 +105,14 @@ namespace Poc1
 					}
 					
 					///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of this displacer.
+					template < typename Precision >
 					inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
 					{
 						__m128 fXxxx = _mm_mul_ps( xxxx, m_PatchScaleToFunctionScale );
 						__m128 fYyyy = _mm_mul_ps( yyyy, m_PatchScaleToFunctionScale );
 						__m128 fZzzz = _mm_mul_ps( zzzz, m_PatchScaleToFunctionScale );
-						__m128 dispXxxx = m_Function.GetSignedValue( fXxxx, fYyyy, fZzzz );
-						__m128 dispZzzz = m_Function.GetSignedValue( _mm_add_ps( fXxxx, m_XOffset ), fYyyy, _mm_add_ps( fZzzz, m_ZOffset ) );
+						__m128 dispXxxx = m_Function.template GetSignedValue< Precision >( fXxxx, fYyyy, fZzzz );
+						__m128 dispZzzz = m_Function.template GetSignedValue< Precision >( _mm_add_ps( fXxxx, m_XOffset ), fYyyy, _mm_add_ps( fZzzz, m_ZOffset ) );
 						dispXxxx = _mm_mul_ps( dispXxxx, m_OutputScale );
 						dispZzzz = _mm_mul_ps( dispZzzz, m_OutputScale );
 
@@ -107,22 +122,52 @@ namespace Poc1
 						yyyy = _mm_add_ps( yyyy, magnitudes );
 						zzzz = _mm_add_ps( zzzz, dispZzzz );
 
-						return m_Base.Displace( xxxx, yyyy, zzzz );
+						return m_Base.template Displace< Precision >( xxxx, yyyy, zzzz );
+					}
+
+					///	\brief	Gets the range of heights that Displace() can return for positions in a region
+					void GetHeightBounds( const SseFunctionRegion& region, float& minHeight, float& maxHeight ) const
+					{
+						//	Displace() moves positions by dispX along x, dispZ along z, and the length of (dispX,dispZ) up
+						//	along y, then passes them to the base displacer
+						SseFunctionRegion functionRegion( region );
+						functionRegion.Scale( GetLane( m_PatchScaleToFunctionScale, 0 ) );
+						float minDispX, maxDispX, minDispZ, maxDispZ;
+						m_Function.GetSignedBounds( functionRegion, minDispX, maxDispX );
+						functionRegion.Offset( GetLane( m_XOffset, 0 ), 0, GetLane( m_ZOffset, 0 ) );
+						m_Function.GetSignedBounds( functionRegion, minDispZ, maxDispZ );
+
+						const float outputScale = GetLane( m_OutputScale, 0 );
+						FunctionBounds::Scale( minDispX, maxDispX, outputScale );
+						FunctionBounds::Scale( minDispZ, maxDispZ, outputScale );
+						const float maxDispXMagnitude = FunctionBounds::GetMaxMagnitude( minDispX, maxDispX );
+						const float maxDispZMagnitude = FunctionBounds::GetMaxMagnitude( minDispZ, maxDispZ );
+
+						const float* minimum = region.GetMinimum( );
+						const float* maximum = region.GetMaximum( );
+						const float displacedMin[ 3 ] = { minimum[ 0 ] + minDispX, minimum[ 1 ], minimum[ 2 ] + minDispZ };
+						const float displacedMax[ 3 ] =
+						{
+							maximum[ 0 ] + maxDispX,
+							maximum[ 1 ] + sqrtf( maxDispXMagnitude * maxDispXMagnitude + maxDispZMagnitude * maxDispZMagnitude ),
+							maximum[ 2 ] + maxDispZ
+						};
+						m_Base.GetHeightBounds( SseFunctionRegion( displacedMin, displacedMax ), minHeight, maxHeight );
 					}
 
 				private :
 
 					__m128 m_XOffset;
 					__m128 m_ZOffset;
-					_CRT_ALIGN( 16 ) BaseDisplacer m_Base;
-					_CRT_ALIGN( 16 ) FunctionType m_Function;
+					FAST_ALIGN( 16 ) BaseDisplacer m_Base;
+					FAST_ALIGN( 16 ) FunctionType m_Function;
 
 			}; //SseFractalOffsetDisplacer
 
 
 			///	\brief	SsePlaneTerrainGenerator Displacer type. Uses a function taking 4 3d input vectors to generate 4 heights
 			template < typename FunctionType >
-			class _CRT_ALIGN( 16 ) SsePlaneFunction3dDisplacer : public SsePlaneTerrainDisplacer
+			class FAST_ALIGN( 16 ) SsePlaneFunction3dDisplacer : public SsePlaneTerrainDisplacer
 			{
 				public :
 
@@ -139,20 +184,32 @@ namespace Poc1
 					}
 
 					///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of this displacer.
+					template < typename Precision >
 					inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
 					{
+						FAST_INSTRUMENT_COUNT( CounterDisplaceCalls, 1 );
+
 						//	TODO: AP: This gets done twice if there's a ground displacer decorating this height displacer
 						__m128 fXxxx = _mm_add_ps( _mm_mul_ps( xxxx, m_PatchScaleToFunctionScale ), m_Scale );
 						__m128 fYyyy = _mm_add_ps( _mm_mul_ps( yyyy, m_PatchScaleToFunctionScale ), m_Scale );
 						__m128 fZzzz = _mm_add_ps( _mm_mul_ps( zzzz, m_PatchScaleToFunctionScale ), m_Scale );
-						__m128 heights = m_Function.GetValue( fXxxx, fYyyy, fZzzz );
+						__m128 heights = m_Function.template GetValue< Precision >( fXxxx, fYyyy, fZzzz );
 						yyyy = _mm_add_ps( yyyy, _mm_mul_ps( MapToHeightRange( heights ), m_OutputScale ) );
 						return heights;
 					}
 
+					///	\brief	Gets the range of heights that Displace() can return for positions in a region
+					void GetHeightBounds( const SseFunctionRegion& region, float& minHeight, float& maxHeight ) const
+					{
+						SseFunctionRegion functionRegion( region );
+						functionRegion.Scale( GetLane( m_PatchScaleToFunctionScale, 0 ) );
+						functionRegion.Offset( GetLane( m_Scale, 0 ), GetLane( m_Scale, 0 ), GetLane( m_Scale, 0 ) );
+						m_Function.GetBounds( functionRegion, minHeight, maxHeight );
+					}
+
 				private :
 
-					_CRT_ALIGN( 16 ) FunctionType m_Function;
+					FAST_ALIGN( 16 ) FunctionType m_Function;
 			};
 
 
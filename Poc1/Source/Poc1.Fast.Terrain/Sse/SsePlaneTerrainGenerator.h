@@ -17,7 +17,11 @@ namespace Poc1
 			//	----------------------------------------------------------------------------- Types
 
 			///	\brief	Generates terrain for planar geometries
-			template < typename DisplaceType = SseNoDisplacement >
+			///
+			///	Precision is one of the precision policies in SsePrecision.h. It controls the square roots and
+			///	divides used by the displacer and by the normal and slope calculations.
+			///
+			template < typename DisplaceType = SseFlatPlaneTerrainDisplacer, typename Precision = SseExactPrecision >
 			class SsePlaneTerrainGeneratorT : public SseTerrainGenerator
 			{
 				public :
@@ -38,17 +42,32 @@ namespace Poc1
 					virtual const SseTerrainDisplacer& GetBaseDisplacer( ) const;
 
 					///	\brief	Generates a cube map face bitmap
-					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels )
+					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor )
 					{
 						//	TODO: AP: ....
 					}
 
+					///	\brief	Generates all six cube map face bitmaps
+					virtual void GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors )
+					{
+						//	Plane terrain has no cube map faces
+					}
+
+					///	\brief	Generates a cube map face bitmap of terrain colours
+					virtual void GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain )
+					{
+						//	Plane terrain has no cube map faces
+					}
+
 					///	\brief	Generates terrain vertex points and normals
 					virtual void GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices );
 
 					///	\brief	Generates terrain vertex points and normals. Gets maximum patch error
 					virtual void GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& maxError );
 
+					///	\brief	Gets the range of heights that GenerateVertices() can produce for a patch, without generating it
+					virtual void GetPatchHeightBounds( const float* origin, const float* xStep, const float* zStep, const int width, const int height, float& minHeight, float& maxHeight );
+
 				private :
 
 					DisplaceType m_Displacer;
@@ -69,63 +88,63 @@ namespace Poc1
 
 			//	------------------------------------------------- SsePlaneTerrainGeneratorT Methods
 
-			template < typename DisplaceType >
-			inline DisplaceType& SsePlaneTerrainGeneratorT< DisplaceType >::GetDisplacer( )
+			template < typename DisplaceType, typename Precision >
+			inline DisplaceType& SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetDisplacer( )
 			{
 				return m_Displacer;
 			}
 			
-			template < typename DisplaceType >
-			inline const DisplaceType& SsePlaneTerrainGeneratorT< DisplaceType >::GetDisplacer( ) const
+			template < typename DisplaceType, typename Precision >
+			inline const DisplaceType& SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetDisplacer( ) const
 			{
 				return m_Displacer;
 			}
 
-			template < typename DisplaceType >
-			inline SseTerrainDisplacer& SsePlaneTerrainGeneratorT< DisplaceType >::GetBaseDisplacer( )
+			template < typename DisplaceType, typename Precision >
+			inline SseTerrainDisplacer& SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetBaseDisplacer( )
 			{
 				return m_Displacer;
 			}
 			
-			template < typename DisplaceType >
-			inline const SseTerrainDisplacer& SsePlaneTerrainGeneratorT< DisplaceType >::GetBaseDisplacer( ) const
+			template < typename DisplaceType, typename Precision >
+			inline const SseTerrainDisplacer& SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetBaseDisplacer( ) const
 			{
 				return m_Displacer;
 			}
 
-			template < typename DisplaceType >
-			void SsePlaneTerrainGeneratorT< DisplaceType >::SetVertices( UTerrainVertex& v0, UTerrainVertex& v1, UTerrainVertex& v2, UTerrainVertex& v3, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v )
+			template < typename DisplaceType, typename Precision >
+			void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::SetVertices( UTerrainVertex& v0, UTerrainVertex& v1, UTerrainVertex& v2, UTerrainVertex& v3, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v )
 			{
-				DisplaceVertices( m_Displacer, v0, v1, v2, v3, xxxx, yyyy, zzzz, uuuu, v );
+				DisplaceVertices< Precision >( m_Displacer, v0, v1, v2, v3, xxxx, yyyy, zzzz, uuuu, v );
 			}
 
-			template < typename DisplaceType >
-			inline void SsePlaneTerrainGeneratorT< DisplaceType >::SetErrorVertices( UTerrainVertex& v0, UTerrainVertex& v1, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v, float& lastHeight, float& lastIntHeight, float& maxError )
+			template < typename DisplaceType, typename Precision >
+			inline void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::SetErrorVertices( UTerrainVertex& v0, UTerrainVertex& v1, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v, float& lastHeight, float& lastIntHeight, float& maxError )
 			{
 				__m128 originXxxx = xxxx;
 				__m128 originYyyy = yyyy;
 				__m128 originZzzz = zzzz;
-				__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+				__m128 heights = m_Displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
 				__m128 leftXxxx = _mm_sub_ps( xxxx, m_ShiftRightXxxx );
 				__m128 leftYyyy = _mm_sub_ps( yyyy, m_ShiftRightYyyy );
 				__m128 leftZzzz = _mm_sub_ps( zzzz, m_ShiftRightZzzz );
-				m_Displacer.Displace( leftXxxx, leftYyyy, leftZzzz );
+				m_Displacer.template Displace< Precision >( leftXxxx, leftYyyy, leftZzzz );
 
 				__m128 upXxxx = _mm_sub_ps( xxxx, m_ShiftDownXxxx );
 				__m128 upYyyy = _mm_sub_ps( yyyy, m_ShiftDownYyyy );
 				__m128 upZzzz = _mm_sub_ps( zzzz, m_ShiftDownZzzz );
-				m_Displacer.Displace( upXxxx, upYyyy, upZzzz );
+				m_Displacer.template Displace< Precision >( upXxxx, upYyyy, upZzzz );
 				
 				__m128 rightXxxx = _mm_add_ps( xxxx, m_ShiftRightXxxx );
 				__m128 rightYyyy = _mm_add_ps( yyyy, m_ShiftRightYyyy );
 				__m128 rightZzzz = _mm_add_ps( zzzz, m_ShiftRightZzzz );
-				m_Displacer.Displace( rightXxxx, rightYyyy, rightZzzz );
+				m_Displacer.template Displace< Precision >( rightXxxx, rightYyyy, rightZzzz );
 
 				__m128 downXxxx = _mm_add_ps( xxxx, m_ShiftDownXxxx );
 				__m128 downYyyy = _mm_add_ps( yyyy, m_ShiftDownYyyy );
 				__m128 downZzzz = _mm_add_ps( zzzz, m_ShiftDownZzzz );
-				m_Displacer.Displace( downXxxx, downYyyy, downZzzz );
+				m_Displacer.template Displace< Precision >( downXxxx, downYyyy, downZzzz );
 
 				//	Move positions to the origin
 				leftXxxx = _mm_sub_ps( leftXxxx, originXxxx );
@@ -146,36 +165,36 @@ namespace Poc1
 				AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, rightXxxx, rightYyyy, rightZzzz, upXxxx, upYyyy, upZzzz );
 				AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, downXxxx, downYyyy, downZzzz, rightXxxx, rightYyyy, rightZzzz );
 				AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, leftXxxx, leftYyyy, leftZzzz, downXxxx, downYyyy, downZzzz );
-				SetLength( cpXxxx, cpYyyy, cpZzzz, Constants::Fc_1 );
+				SetLength< Precision >( cpXxxx, cpYyyy, cpZzzz, Constants::Fc_1 );
 
 				__m128 slopes = _mm_sub_ps( Constants::Fc_1, Dot( cpXxxx, cpYyyy, cpZzzz, Constants::Fc_0, Constants::Fc_1, Constants::Fc_0 ) );
-				slopes = _mm_div_ps( slopes, _mm_set1_ps( 0.4f ) );
+				slopes = Precision::DivConstant( slopes, 0.4f );
 
 				//	TODO: AP: Clamp slopes to 0-1 range
 				SetupVertex( v0, 0, originXxxx, originYyyy, originZzzz, cpXxxx, cpYyyy, cpZzzz, slopes, heights, uuuu, v );
 				SetupVertex( v1, 2, originXxxx, originYyyy, originZzzz, cpXxxx, cpYyyy, cpZzzz, slopes, heights, uuuu, v );
 
 				const float currHeight0 = lastHeight;
-				const float currHeight1 = heights.m128_f32[ 0 ];
-				const float currHeight2 = heights.m128_f32[ 2 ];
+				const float currHeight1 = GetLane( heights, 0 );
+				const float currHeight2 = GetLane( heights, 2 );
 
 				const float estHeight0 = ( currHeight0 + currHeight1 ) / 2;
 				const float estHeight1 = ( currHeight1 + currHeight2 ) / 2;
 				const float actHeight0 = lastIntHeight;
-				const float actHeight1 = heights.m128_f32[ 1 ];
+				const float actHeight1 = GetLane( heights, 1 );
 
 				const float error0 = abs( estHeight0 - actHeight0 );
 				const float error1 = abs( estHeight1 - actHeight1 );
 
 				lastHeight = currHeight2;
-				lastIntHeight = heights.m128_f32[ 3 ];
+				lastIntHeight = GetLane( heights, 3 );
 
 				const float bigError = error0 > error1 ? error0 : error1;
 				maxError = bigError > maxError ? bigError : maxError;
 			}
 
-			template < typename DisplaceType >
-			inline void SsePlaneTerrainGeneratorT< DisplaceType >::GetRowMaxError( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& incXxxx, const __m128& incYyyy, const __m128& incZzzz, const int rowLength, float& maxError )
+			template < typename DisplaceType, typename Precision >
+			inline void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetRowMaxError( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& incXxxx, const __m128& incYyyy, const __m128& incZzzz, const int rowLength, float& maxError )
 			{
 				float lastHeight = 0;
 				float lastIntHeight = 0;
@@ -186,22 +205,22 @@ namespace Poc1
 					__m128 originXxxx = xxxx;
 					__m128 originYyyy = yyyy;
 					__m128 originZzzz = zzzz;
-					__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+					__m128 heights = m_Displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
 					const float currHeight0 = lastHeight;
-					const float currHeight1 = heights.m128_f32[ 0 ];
-					const float currHeight2 = heights.m128_f32[ 2 ];
+					const float currHeight1 = GetLane( heights, 0 );
+					const float currHeight2 = GetLane( heights, 2 );
 
 					const float estHeight0 = ( currHeight0 + currHeight1 ) / 2;
 					const float estHeight1 = ( currHeight1 + currHeight2 ) / 2;
 					const float actHeight0 = lastIntHeight;
-					const float actHeight1 = heights.m128_f32[ 1 ];
+					const float actHeight1 = GetLane( heights, 1 );
 
 					const float error0 = abs( estHeight0 - actHeight0 );
 					const float error1 = abs( estHeight1 - actHeight1 );
 
 					lastHeight = currHeight2;
-					lastIntHeight = heights.m128_f32[ 3 ];
+					lastIntHeight = GetLane( heights, 3 );
 
 					const float bigError = error0 > error1 ? error0 : error1;
 					maxError = bigError > maxError ? bigError : maxError;
@@ -212,9 +231,13 @@ namespace Poc1
 				}
 			}
 
-			template < typename DisplaceType >
-			void SsePlaneTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices )
+			template < typename DisplaceType, typename Precision >
+			void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices )
 			{
+				FAST_TRACE_SCOPE_ARG( "PlaneTerrainPatch", width * height );
+				FAST_INSTRUMENT_TIME( CounterPatches, CounterPatchTicks );
+				FAST_INSTRUMENT_COUNT( CounterPatchVertices, width * height );
+
 				//*
 				AssignShiftVectors( xStep, zStep );
 
@@ -285,22 +308,26 @@ namespace Poc1
 				}
 			}
 
-			template < typename DisplaceType >
-			inline void SsePlaneTerrainGeneratorT< DisplaceType >::GetInitialErrorHeights( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, float& lastHeight, float& lastIntHeight )
+			template < typename DisplaceType, typename Precision >
+			inline void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetInitialErrorHeights( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, float& lastHeight, float& lastIntHeight )
 			{
 				__m128 originXxxx = xxxx;
 				__m128 originYyyy = yyyy;
 				__m128 originZzzz = zzzz;
-				SetLength( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
-				__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+				SetLength< Precision >( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
+				__m128 heights = m_Displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
-				lastHeight = heights.m128_f32[ 2 ];
-				lastIntHeight = heights.m128_f32[ 3 ];
+				lastHeight = GetLane( heights, 2 );
+				lastIntHeight = GetLane( heights, 3 );
 			}
 
-			template < typename DisplaceType >
-			inline void SsePlaneTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& error )
+			template < typename DisplaceType, typename Precision >
+			inline void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& error )
 			{
+				FAST_TRACE_SCOPE_ARG( "PlaneTerrainErrorPatch", width * height );
+				FAST_INSTRUMENT_TIME( CounterPatches, CounterPatchTicks );
+				FAST_INSTRUMENT_COUNT( CounterPatchVertices, width * height );
+
 				AssignShiftVectors( xStep, zStep );
 
 				//	Same as GenerateVertices() without error, except that the resolution is doubled
@@ -387,8 +414,9 @@ namespace Poc1
 							case 3 : SetErrorVertices( *v0, *v1, xxxx, yyyy, zzzz, uuuu, v, lastHeight, lastIntHeight, error ); break;
 						}
 
-						v0 += widthMod4;
-						v1 += widthMod4;
+						//	The last block writes the vertices from its even lanes (1 or 2 of them)
+						v0 += ( widthMod4 + 1 ) / 2;
+						v1 += ( widthMod4 + 1 ) / 2;
 					}
 
 					startXxxx = _mm_add_ps( startXxxx, rowXInc );
@@ -398,6 +426,27 @@ namespace Poc1
 				error = m_Displacer.MapToHeightScale( error );
 			}
 
+			template < typename DisplaceType, typename Precision >
+			void SsePlaneTerrainGeneratorT< DisplaceType, Precision >::GetPatchHeightBounds( const float* origin, const float* xStep, const float* zStep, const int width, const int height, float& minHeight, float& maxHeight )
+			{
+				//	Patch positions are displaced as they are, so the patch corners bound them
+				const float cols = float( width - 1 );
+				const float rows = float( height - 1 );
+				SseFunctionRegion region;
+				for ( int corner = 0; corner < 4; ++corner )
+				{
+					const float col = ( corner & 1 ) ? cols : 0;
+					const float row = ( corner & 2 ) ? rows : 0;
+					region.Add
+					(
+						origin[ 0 ] + xStep[ 0 ] * col + zStep[ 0 ] * row,
+						origin[ 1 ] + xStep[ 1 ] * col + zStep[ 1 ] * row,
+						origin[ 2 ] + xStep[ 2 ] * col + zStep[ 2 ] * row
+					);
+				}
+				m_Displacer.GetHeightBounds( region, minHeight, maxHeight );
+			}
+
 			//	-----------------------------------------------------------------------------------
 
 		}; //Terrain
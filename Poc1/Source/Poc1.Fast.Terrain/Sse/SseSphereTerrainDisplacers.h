@@ -1,11 +1,14 @@
 #pragma once
 #pragma managed(push, off)
 
-#include <Sse\SseSimpleFractal.h>
-#include <Sse\SseRidgedFractal.h>
+#include <Sse/SseSimpleFractal.h>
+#include <Sse/SseRidgedFractal.h>
+#include <Sse/SseFunctionBounds.h>
 
 #include "SseTerrainDisplacer.h"
 
+#include <math.h>
+
 namespace Poc1
 {
 	namespace Fast
@@ -19,14 +22,16 @@ namespace Poc1
 			{
 				public :
 
+					template < typename Precision >
 					inline void GetUpVector( __m128& xxxx, __m128& yyyy, __m128& zzzz )
 					{
-						SetLength( xxxx, yyyy, zzzz, Constants::Fc_1 );
+						SetLength< Precision >( xxxx, yyyy, zzzz, Constants::Fc_1 );
 					}
 
+					template < typename Precision >
 					inline void MapToDisplacementSpace( __m128& xxxx, __m128& yyyy, __m128& zzzz )
 					{
-						SetLength( xxxx, yyyy, zzzz, GetFunctionScale( ) );
+						SetLength< Precision >( xxxx, yyyy, zzzz, GetFunctionScale( ) );
 					}
 
 				protected :
@@ -41,35 +46,77 @@ namespace Poc1
 				public :
 
 					///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of this displacer.
+					template < typename Precision >
 					inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
 					{
-						__m128 absVal = xxxx;
+						FAST_INSTRUMENT_COUNT( CounterDisplaceCalls, 1 );
 
-						if ( ( absVal.m128_f32[ 0 ] > 0.0f ) && ( absVal.m128_f32[ 0 ] < 0.1f ) )
-						{
-							xxxx = _mm_mul_ps( xxxx, m_MaxHeight );
-							yyyy = _mm_mul_ps( yyyy, m_MaxHeight );
-							zzzz = _mm_mul_ps( zzzz, m_MaxHeight );
-							return _mm_set1_ps( 1 );
-						}
+						//	Points with 0 < x < 0.1 are raised to the maximum height. Each lane is tested separately
+						const __m128 maxMask = _mm_and_ps( _mm_cmpgt_ps( xxxx, Constants::Fc_0 ), _mm_cmplt_ps( xxxx, _mm_set1_ps( 0.1f ) ) );
+						const __m128 scale = _mm_or_ps( _mm_and_ps( maxMask, m_MaxHeight ), _mm_andnot_ps( maxMask, m_MinHeight ) );
 
-						xxxx = _mm_mul_ps( xxxx, m_MinHeight );
-						yyyy = _mm_mul_ps( yyyy, m_MinHeight );
-						zzzz = _mm_mul_ps( zzzz, m_MinHeight );
-						return _mm_set1_ps( 0.1f );
+						xxxx = _mm_mul_ps( xxxx, scale );
+						yyyy = _mm_mul_ps( yyyy, scale );
+						zzzz = _mm_mul_ps( zzzz, scale );
+						return _mm_or_ps( _mm_and_ps( maxMask, Constants::Fc_1 ), _mm_andnot_ps( maxMask, _mm_set1_ps( 0.1f ) ) );
+					}
+
+					///	\brief	Gets the range of heights that Displace() can return for positions in a region
+					void GetHeightBounds( const SseFunctionRegion& region, float& minHeight, float& maxHeight ) const
+					{
+						const float minX = region.GetMinimum( )[ 0 ];
+						const float maxX = region.GetMaximum( )[ 0 ];
+						minHeight = ( minX > 0 ) && ( maxX < 0.1f ) ? 1.0f : 0.1f;
+						maxHeight = ( maxX > 0 ) && ( minX < 0.1f ) ? 1.0f : 0.1f;
 					}
 			};
 			///	\brief	Displacer decorator class. Adds x-z displacement to an existing displacer
 			template < typename BaseDisplacer, typename FunctionType >
-			class _CRT_ALIGN( 16 ) SseSphereFunction3dGroundDisplacer : public SseSphereTerrainDisplacer
+			class FAST_ALIGN( 16 ) SseSphereFunction3dGroundDisplacer : public SseSphereTerrainDisplacer
 			{
 				public :
 
+					///	\brief	Displaces samples by the base displacer, after moving them by ground offsets from GetGroundOffsets()
+					///
+					///	Used by SseSphereTerrainGeneratorT to share the ground offsets of a vertex with the neighbours
+					///	used for its normal (see SetGroundField()).
+					///
+					class FAST_ALIGN( 16 ) OffsetDisplacer
+					{
+						public :
+
+							OffsetDisplacer( const SseSphereFunction3dGroundDisplacer& displacer, const __m128& offsetXxxx, const __m128& offsetYyyy, const __m128& offsetZzzz ) :
+								m_Displacer( displacer ),
+								m_OffsetXxxx( offsetXxxx ),
+								m_OffsetYyyy( offsetYyyy ),
+								m_OffsetZzzz( offsetZzzz )
+							{
+							}
+
+							///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of the displacer
+							template < typename Precision >
+							inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
+							{
+								return m_Displacer.template DisplaceOffsets< Precision >( xxxx, yyyy, zzzz, m_OffsetXxxx, m_OffsetYyyy, m_OffsetZzzz );
+							}
+
+						private :
+
+							const SseSphereFunction3dGroundDisplacer&	m_Displacer;
+							__m128										m_OffsetXxxx;
+							__m128										m_OffsetYyyy;
+							__m128										m_OffsetZzzz;
+
+							OffsetDisplacer& operator = ( const OffsetDisplacer& );
+					};
+
 					SseSphereFunction3dGroundDisplacer( )
 					{
 						m_XOffset = _mm_set1_ps( 3.14f );
 						m_ZOffset = _mm_set1_ps( 6.28f );
 						m_Influence = _mm_set1_ps( 0.1f );
+						m_GroundField = false;
+						m_GroundFieldSpacing = 0;
 					}
 
 					///	\brief	Sets the influence of this displacer. 0 means no influence, 1 means that offsets
@@ -80,6 +127,49 @@ namespace Poc1
 						m_Influence = _mm_set1_ps( influence );
 					}
 
+					///	\brief	Sets up the ground field used by SseSphereTerrainGeneratorT::GenerateVertices()
+					///
+					///	With the ground field, each vertex gets its ground offsets once, and the neighbours used for its
+					///	normal are moved by the same offsets (so normals ignore the change in ground offsets between a
+					///	vertex and its neighbours). If 2 vertex steps of a patch are no longer than spacing, in function
+					///	space (see IsGroundFieldReduced()), the ground values are only evaluated at every second vertex of every second row, and interpolated
+					///	in between. A quarter of the wavelength of the finest detail of the ground function keeps the
+					///	interpolation close. The values, rather than the offsets, are interpolated, and each vertex turns
+					///	them into offsets in its own tangent frame (see GetFrameOffsets()), so the error doesn't grow where
+					///	the frame turns quickly, near the poles. Patches need an odd number of rows and columns for this, so that their edges
+					///	are sampled in the same places as the edges of their neighbours.
+					///
+					///	Vertex errors, cube map faces and Displace() are not affected.
+					///
+					void SetGroundField( const bool enabled, const float spacing = 0 )
+					{
+						m_GroundField = enabled;
+						m_GroundFieldSpacing = spacing;
+					}
+
+					///	\brief	Returns true if the ground field is used by SseSphereTerrainGeneratorT::GenerateVertices()
+					bool IsGroundFieldEnabled( ) const
+					{
+						return m_GroundField;
+					}
+
+					///	\brief	Returns true if the steps of a patch are small enough to evaluate the ground field at every second vertex
+					///
+					///	Steps are scaled onto the sphere by the distance of the patch's cube face from the centre (the
+					///	largest component of origin), rather than by the length of origin. Every patch on the cube has the
+					///	same face distance, so every patch of a LOD level (which all have the same steps) makes the same
+					///	choice, and neighbouring patches sample their shared edges in the same places. Steps are never
+					///	longer on the sphere than they are scaled to here.
+					///
+					bool IsGroundFieldReduced( const float* origin, const float* xStep, const float* zStep ) const
+					{
+						const float faceDistance = fabsf( origin[ 0 ] ) > fabsf( origin[ 1 ] ) ? fabsf( origin[ 0 ] ) : fabsf( origin[ 1 ] );
+						const float limit = m_GroundFieldSpacing * ( fabsf( origin[ 2 ] ) > faceDistance ? fabsf( origin[ 2 ] ) : faceDistance );
+						const float xLength = sqrtf( xStep[ 0 ] * xStep[ 0 ] + ( xStep[ 1 ] * xStep[ 1 ] + xStep[ 2 ] * xStep[ 2 ] ) ) * 2 * m_ScaleF;
+						const float zLength = sqrtf( zStep[ 0 ] * zStep[ 0 ] + ( zStep[ 1 ] * zStep[ 1 ] + zStep[ 2 ] * zStep[ 2 ] ) ) * 2 * m_ScaleF;
+						return ( xLength <= limit ) && ( zLength <= limit );
+					}
+
 					///	\brief	Gets the function object used to generate ground displacement values
 					FunctionType& GetFunction( )
 					{
@@ -112,40 +202,81 @@ namespace Poc1
 					}
 					
 					///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of this displacer.
+					template < typename Precision >
 					inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
 					{
-						__m128 dispXxxx = m_Function.GetSignedValue( xxxx, yyyy, zzzz );
-						__m128 dispZzzz = m_Function.GetSignedValue( _mm_add_ps( xxxx, m_XOffset ), yyyy, _mm_add_ps( zzzz, m_ZOffset ) );
-						dispXxxx = _mm_mul_ps( dispXxxx, m_Influence );
-						dispZzzz = _mm_mul_ps( dispZzzz, m_Influence );
-
-						__m128 xAxisX, xAxisY, xAxisZ;
-						__m128 yAxisX, yAxisY, yAxisZ;
-						__m128 zAxisX, zAxisY, zAxisZ;
-						yAxisX = xxxx; yAxisY = yyyy; yAxisZ = zzzz;
-						GetCrossProducts( xAxisX, xAxisY, xAxisZ, xxxx, yyyy, zzzz, Constants::Fc_0, Constants::Fc_1, Constants::Fc_0 );
-						GetCrossProducts( zAxisX, zAxisY, zAxisZ, xxxx, yyyy, zzzz, xAxisX, xAxisY, xAxisZ );
-						SetLength( xAxisX, xAxisY, xAxisZ, dispXxxx );
-						SetLength( yAxisX, yAxisY, yAxisZ, dispZzzz );
-						SetLength( zAxisX, zAxisY, zAxisZ, dispZzzz );
-
-						xxxx = _mm_add_ps( xxxx, xAxisX );
-						yyyy = _mm_add_ps( yyyy, xAxisY );
-						zzzz = _mm_add_ps( zzzz, xAxisZ );
-						
-						xxxx = _mm_add_ps( xxxx, yAxisX );
-						yyyy = _mm_add_ps( yyyy, yAxisY );
-						zzzz = _mm_add_ps( zzzz, yAxisZ );
-						
-						xxxx = _mm_add_ps( xxxx, zAxisX );
-						yyyy = _mm_add_ps( yyyy, zAxisY );
-						zzzz = _mm_add_ps( zzzz, zAxisZ );
-						
-					//	xxxx = _mm_add_ps( xxxx, dispXxxx );
-					//	zzzz = _mm_add_ps( zzzz, dispZzzz );
-
-						__m128 heights = m_Base.Displace( xxxx, yyyy, zzzz );
-						return heights;
+						__m128 offsetXxxx, offsetYyyy, offsetZzzz;
+						GetGroundOffsets< Precision >( xxxx, yyyy, zzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+						return DisplaceOffsets< Precision >( xxxx, yyyy, zzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+					}
+
+					///	\brief	Gets the ground offsets that Displace() adds to 4 (x,y,z) vectors, before they are passed to the base displacer
+					template < typename Precision >
+					inline void GetGroundOffsets( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128& offsetXxxx, __m128& offsetYyyy, __m128& offsetZzzz ) const
+					{
+						__m128 dispXxxx, dispZzzz;
+						GetGroundValues< Precision >( xxxx, yyyy, zzzz, dispXxxx, dispZzzz );
+						GetFrameOffsets< Precision >( xxxx, yyyy, zzzz, dispXxxx, dispZzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+					}
+
+					///	\brief	Gets the 2 ground values of 4 (x,y,z) vectors, scaled by the influence of this displacer
+					template < typename Precision >
+					inline void GetGroundValues( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128& dispXxxx, __m128& dispZzzz ) const
+					{
+						dispXxxx = _mm_mul_ps( m_Function.template GetSignedValue< Precision >( xxxx, yyyy, zzzz ), m_Influence );
+						dispZzzz = _mm_mul_ps( m_Function.template GetSignedValue< Precision >( _mm_add_ps( xxxx, m_XOffset ), yyyy, _mm_add_ps( zzzz, m_ZOffset ) ), m_Influence );
+					}
+
+					///	\brief	Turns the ground values of 4 (x,y,z) vectors into offsets in their tangent frames
+					///
+					///	The first ground value moves positions along the x axis of their tangent frame, p x (0,1,0). The
+					///	second moves them along the up axis, p, and the z axis, p x (x axis). The frame is not normalized
+					///	axis by axis: the x axis is (-z,0,x), and the z axis is (xy,-(x^2+z^2),yz), whose length is |p|
+					///	times the length of the x axis, so 2 square roots cover all 3 axes.
+					///
+					template < typename Precision >
+					inline void GetFrameOffsets( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& dispXxxx, const __m128& dispZzzz, __m128& offsetXxxx, __m128& offsetYyyy, __m128& offsetZzzz ) const
+					{
+						const __m128 xxxx2 = _mm_mul_ps( xxxx, xxxx );
+						const __m128 yyyy2 = _mm_mul_ps( yyyy, yyyy );
+						const __m128 zzzz2 = _mm_mul_ps( zzzz, zzzz );
+						const __m128 horizontal = _mm_add_ps( xxxx2, zzzz2 );
+						const __m128 invHorizontal = Precision::DivSqrt( Constants::Fc_1, horizontal );
+						const __m128 xScale = _mm_mul_ps( dispXxxx, invHorizontal );
+						const __m128 upScale = Precision::DivSqrt( dispZzzz, _mm_add_ps( xxxx2, _mm_add_ps( yyyy2, zzzz2 ) ) );
+						const __m128 zScale = _mm_mul_ps( upScale, invHorizontal );
+
+						offsetXxxx = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( xxxx, upScale ), _mm_mul_ps( zzzz, xScale ) ), _mm_mul_ps( _mm_mul_ps( xxxx, yyyy ), zScale ) );
+						offsetYyyy = _mm_sub_ps( _mm_mul_ps( yyyy, upScale ), _mm_mul_ps( horizontal, zScale ) );
+						offsetZzzz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( xxxx, xScale ), _mm_mul_ps( zzzz, upScale ) ), _mm_mul_ps( _mm_mul_ps( yyyy, zzzz ), zScale ) );
+					}
+
+					///	\brief	Moves 4 (x,y,z) vectors by ground offsets, then maps them onto the minimum distance of the base displacer
+					template < typename Precision >
+					inline __m128 DisplaceOffsets( __m128& xxxx, __m128& yyyy, __m128& zzzz, const __m128& offsetXxxx, const __m128& offsetYyyy, const __m128& offsetZzzz ) const
+					{
+						xxxx = _mm_add_ps( xxxx, offsetXxxx );
+						yyyy = _mm_add_ps( yyyy, offsetYyyy );
+						zzzz = _mm_add_ps( zzzz, offsetZzzz );
+						return m_Base.template Displace< Precision >( xxxx, yyyy, zzzz );
+					}
+
+					///	\brief	Gets the range of heights that Displace() can return for positions in a region
+					void GetHeightBounds( const SseFunctionRegion& region, float& minHeight, float& maxHeight ) const
+					{
+						//	Displace() moves positions by up to |dispX| + 2|dispZ|, then passes them to the base displacer
+						float minDispX, maxDispX, minDispZ, maxDispZ;
+						m_Function.GetSignedBounds( region, minDispX, maxDispX );
+						SseFunctionRegion offsetRegion( region );
+						offsetRegion.Offset( GetLane( m_XOffset, 0 ), 0, GetLane( m_ZOffset, 0 ) );
+						m_Function.GetSignedBounds( offsetRegion, minDispZ, maxDispZ );
+
+						const float influence = FunctionBounds::GetMaxMagnitude( GetLane( m_Influence, 0 ), GetLane( m_Influence, 0 ) );
+						const float maxDispXMagnitude = FunctionBounds::GetMaxMagnitude( minDispX, maxDispX ) * influence;
+						const float maxDispZMagnitude = FunctionBounds::GetMaxMagnitude( minDispZ, maxDispZ ) * influence;
+						SseFunctionRegion displacedRegion( region );
+						displacedRegion.Expand( maxDispXMagnitude + maxDispZMagnitude * 2 );
+						m_Base.GetHeightBounds( displacedRegion, minHeight, maxHeight );
 					}
 
 				private :
@@ -153,15 +284,17 @@ namespace Poc1
 					__m128 m_XOffset;
 					__m128 m_ZOffset;
 					__m128 m_Influence;
-					_CRT_ALIGN( 16 ) BaseDisplacer m_Base;
-					_CRT_ALIGN( 16 ) FunctionType m_Function;
+					FAST_ALIGN( 16 ) BaseDisplacer m_Base;
+					FAST_ALIGN( 16 ) FunctionType m_Function;
+					float m_GroundFieldSpacing;
+					bool m_GroundField;
 
 			}; //SseFractalOffsetDisplacer
 
 
 			///	\brief	SseSphereTerrainGenerator Displacer type. Uses a function taking 4 3d input vectors to generate 4 heights
 			template < typename FunctionType >
-			class _CRT_ALIGN( 16 ) SseSphereFunction3dDisplacer : public SseSphereTerrainDisplacer
+			class FAST_ALIGN( 16 ) SseSphereFunction3dDisplacer : public SseSphereTerrainDisplacer
 			{
 				public :
 
@@ -178,9 +311,12 @@ namespace Poc1
 					}
 
 					///	\brief	Maps 4 (x,y,z) vectors onto the minimum distance of this displacer.
+					template < typename Precision >
 					inline __m128 Displace( __m128& xxxx, __m128& yyyy, __m128& zzzz ) const
 					{
-						__m128 heights = m_Function.GetValue( xxxx, yyyy, zzzz );
+						FAST_INSTRUMENT_COUNT( CounterDisplaceCalls, 1 );
+
+						__m128 heights = m_Function.template GetValue< Precision >( xxxx, yyyy, zzzz );
 
 						__m128 actualHeights = MapToHeightRange( heights );
 						xxxx = _mm_mul_ps( xxxx, actualHeights );
@@ -189,9 +325,15 @@ namespace Poc1
 						return heights;
 					}
 
+					///	\brief	Gets the range of heights that Displace() can return for positions in a region
+					void GetHeightBounds( const SseFunctionRegion& region, float& minHeight, float& maxHeight ) const
+					{
+						m_Function.GetBounds( region, minHeight, maxHeight );
+					}
+
 				private :
 
-					_CRT_ALIGN( 16 ) FunctionType m_Function;
+					FAST_ALIGN( 16 ) FunctionType m_Function;
 			};
 			
 			///	\brief	Helper class
@@ -3,10 +3,16 @@
 
 #include "SseTerrainGenerator.h"
 #include "SseSphereTerrainDisplacers.h"
+#include "UTerrainTypeSelector.h"
+#include "UMipChain.h"
+#include "UBlockCompressor.h"
+#include "UCubeMapSeams.h"
 
 #include <UColour.h>
+#include <Mem.h>
 
 #include <math.h>
+#include <string.h>
 #include <vector>
 
 namespace Poc1
@@ -16,7 +22,100 @@ namespace Poc1
 		namespace Terrain
 		{
 			//	----------------------------------------------------------------------------- Types
-			
+
+			///	\brief	Writes slopes and heights of 4 texels to terrain property cube map face pixels (b8g8r8)
+			class SsePropertyPixelWriter
+			{
+				public :
+
+					///	\brief	Gets the size of a pixel, in bytes
+					int GetPixelSize( ) const
+					{
+						return 3;
+					}
+
+					///	\brief	Gets the format of pixels
+					UPixelFormat GetFormat( ) const
+					{
+						return FormatB8G8R8;
+					}
+
+					///	\brief	Gets the filter used to make mip levels. Heights and slopes can be averaged
+					UMipChain::Filter GetMipFilter( ) const
+					{
+						return UMipChain::BoxFilter;
+					}
+
+					///	\brief	Gets the channels of pixels. Red is slope, and green is height, so BC5 blocks hold both
+					UPixelChannels GetChannels( ) const
+					{
+						return UPixelChannels( 3, 2, 1, 0, -1 );
+					}
+
+					///	\brief	Writes 4 pixels
+					void Write( unsigned char* pixels, const __m128& latitudes, const __m128& heights, const __m128& slopes ) const
+					{
+						//	Truncate, then saturate to bytes
+						const __m128i heights32 = _mm_cvttps_epi32( _mm_mul_ps( heights, _mm_set1_ps( 200 ) ) );
+						const __m128i slopes32 = _mm_cvttps_epi32( _mm_mul_ps( slopes, _mm_set1_ps( 256 ) ) );
+						FAST_ALIGN( 16 ) unsigned char bytes[ 16 ];
+						_mm_store_si128( ( __m128i* )bytes, _mm_packus_epi16( _mm_packs_epi32( slopes32, heights32 ), _mm_setzero_si128( ) ) );
+
+						//	Store in R,G components of pixels (B reserved for latitude later on)
+						pixels[ 0 ] = 0; pixels[ 1 ] = bytes[ 4 ]; pixels[ 2 ] = bytes[ 0 ];
+						pixels[ 3 ] = 0; pixels[ 4 ] = bytes[ 5 ]; pixels[ 5 ] = bytes[ 1 ];
+						pixels[ 6 ] = 0; pixels[ 7 ] = bytes[ 6 ]; pixels[ 8 ] = bytes[ 2 ];
+						pixels[ 9 ] = 0; pixels[ 10 ] = bytes[ 7 ]; pixels[ 11 ] = bytes[ 3 ];
+					}
+			};
+
+			///	\brief	Writes the terrain colours (or types) of 4 texels, from a UTerrainTypeSelector
+			class SseTerrainTypePixelWriter
+			{
+				public :
+
+					SseTerrainTypePixelWriter( const UTerrainTypeSelector& selector, const UPixelFormat format ) :
+						m_Selector( selector ),
+						m_Format( format )
+					{
+					}
+
+					///	\brief	Gets the size of a pixel, in bytes
+					int GetPixelSize( ) const
+					{
+						return GetBytesPerPixel( m_Format );
+					}
+
+					///	\brief	Gets the format of pixels
+					UPixelFormat GetFormat( ) const
+					{
+						return m_Format;
+					}
+
+					///	\brief	Gets the filter used to make mip levels. Colours can be averaged, terrain types can't
+					UMipChain::Filter GetMipFilter( ) const
+					{
+						return GetPixelSize( ) == 1 ? UMipChain::PointFilter : UMipChain::BoxFilter;
+					}
+
+					///	\brief	Gets the channels of pixels
+					UPixelChannels GetChannels( ) const
+					{
+						return UPixelChannels::FromFormat( m_Format );
+					}
+
+					///	\brief	Writes 4 pixels
+					void Write( unsigned char* pixels, const __m128& latitudes, const __m128& heights, const __m128& slopes ) const
+					{
+						m_Selector.WritePixels( m_Format, latitudes, heights, slopes, pixels );
+					}
+
+				private :
+
+					const UTerrainTypeSelector&	m_Selector;
+					const UPixelFormat			m_Format;
+			};
+
 			///	\brief	Base class for fast sphere terrain generators
 			class SseSphereTerrainGenerator : public SseTerrainGenerator
 			{
@@ -24,13 +123,39 @@ namespace Poc1
 
 					///	\brief	Generates a cube map texture face that encodes terrain properties
 					///
-					///	Pixel format must be r8g8b8a8
-					///	r = S (S component of spherical coordinate encoded normal
-					///	g = T (T component of spherical coordinate encoded normal
-					///	b = Altitude (normalized)
-					///	a = Unused, for now
+					///	Pixel format must be b8g8r8 (a 24bpp RGB bitmap)
+					///	r = Slope (from the normal of the displaced surface, at the resolution of the face)
+					///	g = Altitude (normalized)
+					///	b = Unused, for now (0)
+					///
+					///	Only whole blocks of 4 columns are written. If mipChain is not null, its levels are filled while the
+					///	face is generated, from the written columns (see UMipChain). If compressor is not null, the face is
+					///	also compressed while it is generated (see UBlockCompressor). BC5 blocks hold slope in red, and
+					///	height in green, like the face.
+					///
+					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor ) = 0;
+
+					///	\brief	Generates all six terrain property cube map faces, with seams that match across faces
+					///
+					///	Faces are size x size pixels, in the same format as GenerateTerrainPropertyCubeMapFace(). size must be
+					///	a multiple of 4, and at least 4. facePixels has a pointer to the pixels of each face, indexed by
+					///	UCubeMapFace. mipChains and compressors are either null, or have a (possibly null) pointer per face.
+					///
+					///	The edges and corners of the faces are shared (see UCubeMapSeams). Each shared texel is displaced,
+					///	and its slope calculated, once, from the face that owns it, and the same height, slope and latitude
+					///	are written to every face it is in. The normals of edge texels come from neighbouring texels in the
+					///	faces either side of the edge, so slopes are continuous across seams.
+					///
+					virtual void GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors ) = 0;
+
+					///	\brief	Generates a cube map texture face of terrain colours, or terrain types
+					///
+					///	Colours (or types, for FormatA8 and FormatR8) come from a UTerrainTypeSelector, using the
+					///	latitude, and the same heights and slopes as GenerateTerrainPropertyCubeMapFace(). Only whole
+					///	blocks of 4 columns are written. If mipChain is not null, its levels are filled while the face
+					///	is generated. Terrain type levels are point sampled, colour levels are box filtered.
 					///
-					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels ) = 0;
+					virtual void GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain ) = 0;
 
 				protected :
 
@@ -39,8 +164,12 @@ namespace Poc1
 
 
 			///	\brief	Sphere terrain generator implementation
-			template < typename DisplaceType = SseNoDisplacement >
-			class _CRT_ALIGN( 16 ) SseSphereTerrainGeneratorT : public SseSphereTerrainGenerator
+			///
+			///	Precision is one of the precision policies in SsePrecision.h. It controls the square roots and
+			///	divides used by the displacer and by the normal and slope calculations.
+			///
+			template < typename DisplaceType = SseFlatSphereTerrainDisplacer, typename Precision = SseExactPrecision >
+			class FAST_ALIGN( 16 ) SseSphereTerrainGeneratorT : public SseSphereTerrainGenerator
 			{
 				public :
 
@@ -78,19 +207,62 @@ namespace Poc1
 					virtual void GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& maxError );
 
 					///	\brief	Generates a cube map texture face
-					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels );
+					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor );
+
+					///	\brief	Generates all six terrain property cube map faces, with seams that match across faces
+					virtual void GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors );
+
+					///	\brief	Generates a cube map texture face of terrain colours, or terrain types
+					virtual void GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain );
+
+					///	\brief	Gets the range of heights that GenerateVertices() can produce for a patch, without generating it
+					virtual void GetPatchHeightBounds( const float* origin, const float* xStep, const float* zStep, const int width, const int height, float& minHeight, float& maxHeight );
 
 				private :
 
+					///	\brief	Number of patch positions along each side of the grid projected by GetPatchHeightBounds()
+					enum { PatchBoundsGridSize = 5 };
+
 					DisplaceType		m_Displacer;			///<	Height displacer object
 					float*				m_FpCacheLines[ 3 ];	///<	Cache for 3 lines of height/position values in texture/vertex generation
 					int					m_FpCacheSize;			///<	Size of each fp cache line	
+					UCubeMapSeams		m_Seams;				///<	Shared edges of cube map faces, for GenerateTerrainPropertyCubeMap()
 
 					///	\brief	Sets the height of the FP cache
 					void SetFpCacheSize( const int size );
 
-					///	\brief	Fills a line in the fp cache with height values
-					void FillHeightCacheLine( const int w4, float* line, const UCubeMapFace face, __m128 uuuu, const __m128& vvvv, const __m128& uuuuInc, float* latitudes );
+					///	\brief	Generates the heights, slopes and latitudes of a cube map face, and passes each block of 4 texels to a pixel writer
+					template < typename PixelWriter >
+					void GenerateCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor, const PixelWriter& writer );
+
+					///	\brief	Generates the heights, slopes and latitudes of all six cube map faces, with shared edges, and passes each block of 4 texels to a pixel writer
+					template < typename PixelWriter >
+					void GenerateCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors, const PixelWriter& writer );
+
+					///	\brief	Displaces texels first to first + count - 1 along a side of a face, inset texels into the face, and stores them in m_Seams
+					///
+					///	Edge texels (inset 0) are stored in every face that shares them.
+					///
+					void DisplaceSideTexels( const UCubeMapFace face, const UCubeMapSeams::Side side, const int inset, const int first, const int count );
+
+					///	\brief	Calculates the edge values of texels first to first + count - 1 along the edge of a side of a face, and stores them in every face that shares them
+					void SetSideEdgeValues( const UCubeMapFace face, const UCubeMapSeams::Side side, const int first, const int count );
+
+					///	\brief	Fills a line with the displaced positions and heights of an inner row of a face, in the same layout as UCubeMapSeams ring rows
+					void FillCubeMapCacheLine( const UCubeMapFace face, const int row, float* line );
+
+					///	\brief	Gets the slopes of 4 texels, from the displaced positions of their neighbours
+					///
+					///	Each pointer is to the x positions of 4 texels. y, z positions follow at planeSize and planeSize * 2
+					///	floats. The normal is the undisplaced sphere normal, of unit length.
+					///
+					static __m128 GetTexelSlopes( const float* origin, const float* left, const float* right, const float* up, const float* down, const int planeSize, const __m128& normalXxxx, const __m128& normalYyyy, const __m128& normalZzzz );
+
+					///	\brief	Fills a line in the fp cache with displaced positions and heights of cube map face texels
+					///
+					///	The line has 4 planes of planeSize floats: displaced x, y and z positions, then heights.
+					///
+					void FillHeightCacheLine( const int w4, const int planeSize, float* line, const UCubeMapFace face, __m128 uuuu, const __m128& vvvv, const __m128& uuuuInc );
 
 					///	\brief	Fills a line in the fp cache with positions
 					void FillPositionCacheLine( const int w4, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc );
@@ -98,6 +270,55 @@ namespace Poc1
 					///	\brief	Fills a line in the fp cache with positions and base height values
 					void FillPositionHeightCacheLine( const int w4, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc );
 
+					///	\brief	Generates terrain vertex points and normals with the ground field of a ground displacer (see SseSphereFunction3dGroundDisplacer::SetGroundField())
+					///
+					///	Returns false, and generates nothing, if the displacer doesn't use its ground field.
+					///
+					template < typename BaseDisplacer, typename FunctionType >
+					bool GenerateGroundFieldVertices( const SseSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionType >& displacer, const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, const float uvRes, UTerrainVertex* vertices );
+
+					///	\brief	Displacers without ground displacement have no ground field
+					bool GenerateGroundFieldVertices( const SseSphereTerrainDisplacer&, const float*, const float*, const float*, const int, const int, const float*, const float, UTerrainVertex* )
+					{
+						return false;
+					}
+
+					///	\brief	Fills a line in the fp cache with the ground values of every vertex in a row, from values evaluated at every second vertex
+					///
+					///	The line has a block of 8 floats for every 4 vertices: their first, then second ground values. xxxx, yyyy and zzzz
+					///	are the positions of vertices 0, 2, 4 and 6, and colXInc, colYInc and colZInc move them on 8 vertices.
+					///	w8 blocks of 8 vertices are filled.
+					///
+					template < typename GroundDisplacer >
+					void FillGroundFieldLine( const GroundDisplacer& displacer, const int w8, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc );
+
+					///	\brief	Gets the ground offsets of 4 vertices, from their positions on the patch
+					template < typename GroundDisplacer >
+					inline void GetGroundOffsets( const GroundDisplacer& displacer, __m128 xxxx, __m128 yyyy, __m128 zzzz, __m128& offsetXxxx, __m128& offsetYyyy, __m128& offsetZzzz ) const
+					{
+						SetLength< Precision >( xxxx, yyyy, zzzz, displacer.GetFunctionScale( ) );
+						displacer.template GetGroundOffsets< Precision >( xxxx, yyyy, zzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+					}
+
+					///	\brief	Gets the ground values of 4 vertices, from their positions on the patch
+					template < typename GroundDisplacer >
+					inline void GetGroundValues( const GroundDisplacer& displacer, __m128 xxxx, __m128 yyyy, __m128 zzzz, __m128& dispXxxx, __m128& dispZzzz ) const
+					{
+						SetLength< Precision >( xxxx, yyyy, zzzz, displacer.GetFunctionScale( ) );
+						displacer.template GetGroundValues< Precision >( xxxx, yyyy, zzzz, dispXxxx, dispZzzz );
+					}
+
+					///	\brief	Gets the ground offsets of 4 vertices, from their positions on the patch and their ground values
+					template < typename GroundDisplacer >
+					inline void GetFrameOffsets( const GroundDisplacer& displacer, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& dispXxxx, const __m128& dispZzzz, __m128& offsetXxxx, __m128& offsetYyyy, __m128& offsetZzzz ) const
+					{
+						SetLength< Precision >( xxxx, yyyy, zzzz, displacer.GetFunctionScale( ) );
+						displacer.template GetFrameOffsets< Precision >( xxxx, yyyy, zzzz, dispXxxx, dispZzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+					}
+
+					///	\brief	Stores 8 values, from the values of 4 even vertices, and the first value of the next 4. Odd vertices are halfway between their neighbours
+					static void InterpolateGroundField( const __m128& values, const __m128& nextValues, float* first, float* second );
+
 					///	\brief	Determines the maximum error between two arrays filled with height data
 					float GetMaximumError( const int count, const float* heights0 );
 
@@ -113,11 +334,11 @@ namespace Poc1
 						__m128 originXxxx = xxxx;
 						__m128 originYyyy = yyyy;
 						__m128 originZzzz = zzzz;
-						SetLength( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
-						__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+						SetLength< Precision >( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
+						__m128 heights = m_Displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
-						lastHeight = heights.m128_f32[ 2 ];
-						lastIntHeight = heights.m128_f32[ 3 ];
+						lastHeight = GetLane( heights, 2 );
+						lastIntHeight = GetLane( heights, 3 );
 					}
 					
 					inline void GetRowMaxError( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& incXxxx, const __m128& incYyyy, const __m128& incZzzz, const int rowLength, float& maxError )
@@ -131,23 +352,23 @@ namespace Poc1
 							__m128 originXxxx = xxxx;
 							__m128 originYyyy = yyyy;
 							__m128 originZzzz = zzzz;
-							SetLength( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
-							__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+							SetLength< Precision >( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
+							__m128 heights = m_Displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
 							const float currHeight0 = lastHeight;
-							const float currHeight1 = heights.m128_f32[ 0 ];
-							const float currHeight2 = heights.m128_f32[ 2 ];
+							const float currHeight1 = GetLane( heights, 0 );
+							const float currHeight2 = GetLane( heights, 2 );
 
 							const float estHeight0 = ( currHeight0 + currHeight1 ) / 2;
 							const float estHeight1 = ( currHeight1 + currHeight2 ) / 2;
 							const float actHeight0 = lastIntHeight;
-							const float actHeight1 = heights.m128_f32[ 1 ];
+							const float actHeight1 = GetLane( heights, 1 );
 
 							const float error0 = abs( estHeight0 - actHeight0 );
 							const float error1 = abs( estHeight1 - actHeight1 );
 
 							lastHeight = currHeight2;
-							lastIntHeight = heights.m128_f32[ 3 ];
+							lastIntHeight = GetLane( heights, 3 );
 
 							const float bigError = error0 > error1 ? error0 : error1;
 							maxError = bigError > maxError ? bigError : maxError;
@@ -163,37 +384,37 @@ namespace Poc1
 						__m128 normalXxxx = xxxx;
 						__m128 normalYyyy = yyyy;
 						__m128 normalZzzz = zzzz;
-						SetLength( normalXxxx, normalYyyy, normalZzzz, _mm_set1_ps( 1 ) );	//	Don't trust that normalize...
+						SetLength< Precision >( normalXxxx, normalYyyy, normalZzzz, _mm_set1_ps( 1 ) );	//	Don't trust that normalize...
 
 						__m128 originXxxx = xxxx;
 						__m128 originYyyy = yyyy;
 						__m128 originZzzz = zzzz;
-						SetLength( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
-						__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+						SetLength< Precision >( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
+						__m128 heights = m_Displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
 						__m128 leftXxxx = _mm_sub_ps( xxxx, m_ShiftRightXxxx );
 						__m128 leftYyyy = _mm_sub_ps( yyyy, m_ShiftRightYyyy );
 						__m128 leftZzzz = _mm_sub_ps( zzzz, m_ShiftRightZzzz );
-						SetLength( leftXxxx, leftYyyy, leftZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( leftXxxx, leftYyyy, leftZzzz );
+						SetLength< Precision >( leftXxxx, leftYyyy, leftZzzz, m_Displacer.GetFunctionScale( ) );
+						m_Displacer.template Displace< Precision >( leftXxxx, leftYyyy, leftZzzz );
 
 						__m128 upXxxx = _mm_sub_ps( xxxx, m_ShiftDownXxxx );
 						__m128 upYyyy = _mm_sub_ps( yyyy, m_ShiftDownYyyy );
 						__m128 upZzzz = _mm_sub_ps( zzzz, m_ShiftDownZzzz );
-						SetLength( upXxxx, upYyyy, upZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( upXxxx, upYyyy, upZzzz );
+						SetLength< Precision >( upXxxx, upYyyy, upZzzz, m_Displacer.GetFunctionScale( ) );
+						m_Displacer.template Displace< Precision >( upXxxx, upYyyy, upZzzz );
 						
 						__m128 rightXxxx = _mm_add_ps( xxxx, m_ShiftRightXxxx );
 						__m128 rightYyyy = _mm_add_ps( yyyy, m_ShiftRightYyyy );
 						__m128 rightZzzz = _mm_add_ps( zzzz, m_ShiftRightZzzz );
-						SetLength( rightXxxx, rightYyyy, rightZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( rightXxxx, rightYyyy, rightZzzz );
+						SetLength< Precision >( rightXxxx, rightYyyy, rightZzzz, m_Displacer.GetFunctionScale( ) );
+						m_Displacer.template Displace< Precision >( rightXxxx, rightYyyy, rightZzzz );
 
 						__m128 downXxxx = _mm_add_ps( xxxx, m_ShiftDownXxxx );
 						__m128 downYyyy = _mm_add_ps( yyyy, m_ShiftDownYyyy );
 						__m128 downZzzz = _mm_add_ps( zzzz, m_ShiftDownZzzz );
-						SetLength( downXxxx, downYyyy, downZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( downXxxx, downYyyy, downZzzz );
+						SetLength< Precision >( downXxxx, downYyyy, downZzzz, m_Displacer.GetFunctionScale( ) );
+						m_Displacer.template Displace< Precision >( downXxxx, downYyyy, downZzzz );
 
 						//	Move positions to the origin
 						leftXxxx = _mm_sub_ps( leftXxxx, originXxxx );
@@ -214,133 +435,81 @@ namespace Poc1
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, rightXxxx, rightYyyy, rightZzzz, upXxxx, upYyyy, upZzzz );
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, downXxxx, downYyyy, downZzzz, rightXxxx, rightYyyy, rightZzzz );
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, leftXxxx, leftYyyy, leftZzzz, downXxxx, downYyyy, downZzzz );
-						SetLength( cpXxxx, cpYyyy, cpZzzz, _mm_set1_ps( 1 ) );
+						SetLength< Precision >( cpXxxx, cpYyyy, cpZzzz, _mm_set1_ps( 1 ) );
 
 						__m128 slopes = _mm_sub_ps( _mm_set1_ps( 1 ), Dot( cpXxxx, cpYyyy, cpZzzz, normalXxxx, normalYyyy, normalZzzz ) );
-						slopes = _mm_div_ps( slopes, _mm_set1_ps( MaxSlope ) );
+						slopes = Precision::DivConstant( slopes, MaxSlope );
 
 						//	TODO: AP: Clamp slopes to 0-1 range
 						SetupVertex( v0, 0, originXxxx, originYyyy, originZzzz, cpXxxx, cpYyyy, cpZzzz, slopes, heights, uuuu, v );
 						SetupVertex( v1, 2, originXxxx, originYyyy, originZzzz, cpXxxx, cpYyyy, cpZzzz, slopes, heights, uuuu, v );
 
 						const float currHeight0 = lastHeight;
-						const float currHeight1 = heights.m128_f32[ 0 ];
-						const float currHeight2 = heights.m128_f32[ 2 ];
+						const float currHeight1 = GetLane( heights, 0 );
+						const float currHeight2 = GetLane( heights, 2 );
 
 						const float estHeight0 = ( currHeight0 + currHeight1 ) / 2;
 						const float estHeight1 = ( currHeight1 + currHeight2 ) / 2;
 						const float actHeight0 = lastIntHeight;
-						const float actHeight1 = heights.m128_f32[ 1 ];
+						const float actHeight1 = GetLane( heights, 1 );
 
 						const float error0 = abs( estHeight0 - actHeight0 );
 						const float error1 = abs( estHeight1 - actHeight1 );
 
 						lastHeight = currHeight2;
-						lastIntHeight = heights.m128_f32[ 3 ];
+						lastIntHeight = GetLane( heights, 3 );
 
 						const float bigError = error0 > error1 ? error0 : error1;
 						maxError = bigError > maxError ? bigError : maxError;
 					}
 
-					inline void GetHeightsAndSlopes( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128& heights, __m128& slopes ) const
+					inline void SetVertices( UTerrainVertex& v0, UTerrainVertex& v1, UTerrainVertex& v2, UTerrainVertex& v3, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v )
 					{
-						__m128 normalXxxx = xxxx;
-						__m128 normalYyyy = yyyy;
-						__m128 normalZzzz = zzzz;
-						SetLength( normalXxxx, normalYyyy, normalZzzz, _mm_set1_ps( 1 ) );	//	Don't trust that normalize...
-
-						__m128 originXxxx = xxxx;
-						__m128 originYyyy = yyyy;
-						__m128 originZzzz = zzzz;
-						SetLength( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
-						heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
-
-						__m128 leftXxxx = _mm_sub_ps( originXxxx, m_ShiftRightXxxx );
-						__m128 leftYyyy = _mm_sub_ps( originYyyy, m_ShiftRightYyyy );
-						__m128 leftZzzz = _mm_sub_ps( originZzzz, m_ShiftRightZzzz );
-						SetLength( leftXxxx, leftYyyy, leftZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( leftXxxx, leftYyyy, leftZzzz );
-
-						__m128 upXxxx = _mm_sub_ps( originXxxx, m_ShiftDownXxxx );
-						__m128 upYyyy = _mm_sub_ps( originYyyy, m_ShiftDownYyyy );
-						__m128 upZzzz = _mm_sub_ps( originZzzz, m_ShiftDownZzzz );
-						SetLength( upXxxx, upYyyy, upZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( upXxxx, upYyyy, upZzzz );
-						
-						__m128 rightXxxx = _mm_add_ps( originXxxx, m_ShiftRightXxxx );
-						__m128 rightYyyy = _mm_add_ps( originYyyy, m_ShiftRightYyyy );
-						__m128 rightZzzz = _mm_add_ps( originZzzz, m_ShiftRightZzzz );
-						SetLength( rightXxxx, rightYyyy, rightZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( rightXxxx, rightYyyy, rightZzzz );
-
-						__m128 downXxxx = _mm_add_ps( originXxxx, m_ShiftDownXxxx );
-						__m128 downYyyy = _mm_add_ps( originYyyy, m_ShiftDownYyyy );
-						__m128 downZzzz = _mm_add_ps( originZzzz, m_ShiftDownZzzz );
-						SetLength( downXxxx, downYyyy, downZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( downXxxx, downYyyy, downZzzz );
-
-						//	Move positions to the origin
-						leftXxxx = _mm_sub_ps( leftXxxx, originXxxx );
-						leftYyyy = _mm_sub_ps( leftYyyy, originYyyy );
-						leftZzzz = _mm_sub_ps( leftZzzz, originZzzz );
-						upXxxx = _mm_sub_ps( upXxxx, originXxxx );
-						upYyyy = _mm_sub_ps( upYyyy, originYyyy );
-						upZzzz = _mm_sub_ps( upZzzz, originZzzz );
-						rightXxxx = _mm_sub_ps( rightXxxx, originXxxx );
-						rightYyyy = _mm_sub_ps( rightYyyy, originYyyy );
-						rightZzzz = _mm_sub_ps( rightZzzz, originZzzz );
-						downXxxx = _mm_sub_ps( downXxxx, originXxxx );
-						downYyyy = _mm_sub_ps( downYyyy, originYyyy );
-						downZzzz = _mm_sub_ps( downZzzz, originZzzz );
-
-						__m128 cpXxxx, cpYyyy, cpZzzz;
-						GetCrossProducts( cpXxxx, cpYyyy, cpZzzz, upXxxx, upYyyy, upZzzz, leftXxxx, leftYyyy, leftZzzz );
-						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, rightXxxx, rightYyyy, rightZzzz, upXxxx, upYyyy, upZzzz );
-						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, downXxxx, downYyyy, downZzzz, rightXxxx, rightYyyy, rightZzzz );
-						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, leftXxxx, leftYyyy, leftZzzz, downXxxx, downYyyy, downZzzz );
-						SetLength( cpXxxx, cpYyyy, cpZzzz, _mm_set1_ps( 1 ) );
-						
-						slopes = _mm_sub_ps( _mm_set1_ps( 1 ), Dot( cpXxxx, cpYyyy, cpZzzz, normalXxxx, normalYyyy, normalZzzz ) );
-						slopes = _mm_div_ps( slopes, _mm_set1_ps( MaxSlope ) );
-						Clamp( slopes, _mm_set1_ps( 0 ), _mm_set1_ps( 1 ) );
+						SetVertices( m_Displacer, v0, v1, v2, v3, xxxx, yyyy, zzzz, uuuu, v );
 					}
 
-					inline void SetVertices( UTerrainVertex& v0, UTerrainVertex& v1, UTerrainVertex& v2, UTerrainVertex& v3, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v )
+					///	\brief	Sets up 4 vertices, using a displacer for the vertices and the neighbours used for their normals
+					///
+					///	The displacer is m_Displacer, or an offset displacer that shares ground offsets between a vertex
+					///	and its neighbours (see SseSphereFunction3dGroundDisplacer::SetGroundField()).
+					///
+					template < typename SampleDisplacer >
+					inline void SetVertices( const SampleDisplacer& displacer, UTerrainVertex& v0, UTerrainVertex& v1, UTerrainVertex& v2, UTerrainVertex& v3, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v )
 					{
 						__m128 normalXxxx = xxxx;
 						__m128 normalYyyy = yyyy;
 						__m128 normalZzzz = zzzz;
-						SetLength( normalXxxx, normalYyyy, normalZzzz, _mm_set1_ps( 1 ) );	//	Don't trust that normalize...
+						SetLength< Precision >( normalXxxx, normalYyyy, normalZzzz, _mm_set1_ps( 1 ) );	//	Don't trust that normalize...
 
 						__m128 originXxxx = xxxx;
 						__m128 originYyyy = yyyy;
 						__m128 originZzzz = zzzz;
-						SetLength( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
-						__m128 heights = m_Displacer.Displace( originXxxx, originYyyy, originZzzz );
+						SetLength< Precision >( originXxxx, originYyyy, originZzzz, m_Displacer.GetFunctionScale( ) );
+						__m128 heights = displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
 						__m128 leftXxxx = _mm_sub_ps( xxxx, m_ShiftRightXxxx );
 						__m128 leftYyyy = _mm_sub_ps( yyyy, m_ShiftRightYyyy );
 						__m128 leftZzzz = _mm_sub_ps( zzzz, m_ShiftRightZzzz );
-						SetLength( leftXxxx, leftYyyy, leftZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( leftXxxx, leftYyyy, leftZzzz );
+						SetLength< Precision >( leftXxxx, leftYyyy, leftZzzz, m_Displacer.GetFunctionScale( ) );
+						displacer.template Displace< Precision >( leftXxxx, leftYyyy, leftZzzz );
 
 						__m128 upXxxx = _mm_sub_ps( xxxx, m_ShiftDownXxxx );
 						__m128 upYyyy = _mm_sub_ps( yyyy, m_ShiftDownYyyy );
 						__m128 upZzzz = _mm_sub_ps( zzzz, m_ShiftDownZzzz );
-						SetLength( upXxxx, upYyyy, upZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( upXxxx, upYyyy, upZzzz );
+						SetLength< Precision >( upXxxx, upYyyy, upZzzz, m_Displacer.GetFunctionScale( ) );
+						displacer.template Displace< Precision >( upXxxx, upYyyy, upZzzz );
 						
 						__m128 rightXxxx = _mm_add_ps( xxxx, m_ShiftRightXxxx );
 						__m128 rightYyyy = _mm_add_ps( yyyy, m_ShiftRightYyyy );
 						__m128 rightZzzz = _mm_add_ps( zzzz, m_ShiftRightZzzz );
-						SetLength( rightXxxx, rightYyyy, rightZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( rightXxxx, rightYyyy, rightZzzz );
+						SetLength< Precision >( rightXxxx, rightYyyy, rightZzzz, m_Displacer.GetFunctionScale( ) );
+						displacer.template Displace< Precision >( rightXxxx, rightYyyy, rightZzzz );
 
 						__m128 downXxxx = _mm_add_ps( xxxx, m_ShiftDownXxxx );
 						__m128 downYyyy = _mm_add_ps( yyyy, m_ShiftDownYyyy );
 						__m128 downZzzz = _mm_add_ps( zzzz, m_ShiftDownZzzz );
-						SetLength( downXxxx, downYyyy, downZzzz, m_Displacer.GetFunctionScale( ) );
-						m_Displacer.Displace( downXxxx, downYyyy, downZzzz );
+						SetLength< Precision >( downXxxx, downYyyy, downZzzz, m_Displacer.GetFunctionScale( ) );
+						displacer.template Displace< Precision >( downXxxx, downYyyy, downZzzz );
 
 						//	Move positions to the origin
 						leftXxxx = _mm_sub_ps( leftXxxx, originXxxx );
@@ -361,10 +530,10 @@ namespace Poc1
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, rightXxxx, rightYyyy, rightZzzz, upXxxx, upYyyy, upZzzz );
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, downXxxx, downYyyy, downZzzz, rightXxxx, rightYyyy, rightZzzz );
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, leftXxxx, leftYyyy, leftZzzz, downXxxx, downYyyy, downZzzz );
-						SetLength( cpXxxx, cpYyyy, cpZzzz, _mm_set1_ps( 1 ) );
+						SetLength< Precision >( cpXxxx, cpYyyy, cpZzzz, _mm_set1_ps( 1 ) );
 						
 						__m128 slopes = _mm_sub_ps( _mm_set1_ps( 1 ), Dot( cpXxxx, cpYyyy, cpZzzz, normalXxxx, normalYyyy, normalZzzz ) );
-						slopes = _mm_div_ps( slopes, _mm_set1_ps( MaxSlope ) );
+						slopes = Precision::DivConstant( slopes, MaxSlope );
 						Clamp( slopes, _mm_set1_ps( 0 ), _mm_set1_ps( 1 ) );
 
 						SetupVertex( v0, 0, originXxxx, originYyyy, originZzzz, cpXxxx, cpYyyy, cpZzzz, slopes, heights, uuuu, v );
@@ -378,32 +547,32 @@ namespace Poc1
 
 			//	--------------------------------------------- SseSphereTerrainGeneratorT Inline Methods
 
-			template < typename DisplaceType >
-			inline DisplaceType& SseSphereTerrainGeneratorT< DisplaceType >::GetDisplacer( )
+			template < typename DisplaceType, typename Precision >
+			inline DisplaceType& SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetDisplacer( )
 			{
 				return m_Displacer;
 			}
 			
-			template < typename DisplaceType >
-			inline const DisplaceType& SseSphereTerrainGeneratorT< DisplaceType >::GetDisplacer( ) const
+			template < typename DisplaceType, typename Precision >
+			inline const DisplaceType& SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetDisplacer( ) const
 			{
 				return m_Displacer;
 			}
 
-			template < typename DisplaceType >
-			inline SseTerrainDisplacer& SseSphereTerrainGeneratorT< DisplaceType >::GetBaseDisplacer( )
+			template < typename DisplaceType, typename Precision >
+			inline SseTerrainDisplacer& SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetBaseDisplacer( )
 			{
 				return m_Displacer;
 			}
 			
-			template < typename DisplaceType >
-			inline const SseTerrainDisplacer& SseSphereTerrainGeneratorT< DisplaceType >::GetBaseDisplacer( ) const
+			template < typename DisplaceType, typename Precision >
+			inline const SseTerrainDisplacer& SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetBaseDisplacer( ) const
 			{
 				return m_Displacer;
 			}
 
-			template < typename DisplaceType >
-			void SseSphereTerrainGeneratorT< DisplaceType >::SetFpCacheSize( const int size )
+			template < typename DisplaceType, typename Precision >
+			void SseSphereTerrainGeneratorT< DisplaceType, Precision >::SetFpCacheSize( const int size )
 			{
 				if ( m_FpCacheSize >= size )
 				{
@@ -418,8 +587,8 @@ namespace Poc1
 				m_FpCacheSize = size;
 			}
 
-			template < typename DisplaceType >
-			inline void SseSphereTerrainGeneratorT< DisplaceType >::FillPositionCacheLine( const int w4, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc )
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::FillPositionCacheLine( const int w4, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc )
 			{
 				__m128 tmpXxxx, tmpYyyy, tmpZzzz;
 				float* curPos = line;
@@ -430,8 +599,8 @@ namespace Poc1
 					tmpZzzz = zzzz;
 
 					//	Disable normalize to remove sphere mapping
-					SetLength( tmpXxxx, tmpYyyy, tmpZzzz, m_Displacer.GetFunctionScale( ) );
-					m_Displacer.Displace( tmpXxxx, tmpYyyy, tmpZzzz );
+					SetLength< Precision >( tmpXxxx, tmpYyyy, tmpZzzz, m_Displacer.GetFunctionScale( ) );
+					m_Displacer.template Displace< Precision >( tmpXxxx, tmpYyyy, tmpZzzz );
 
 					_mm_store_ps( curPos, tmpXxxx ); curPos += 4;
 					_mm_store_ps( curPos, tmpYyyy ); curPos += 4;
@@ -443,8 +612,8 @@ namespace Poc1
 				}
 			}
 
-			template < typename DisplaceType >
-			inline void SseSphereTerrainGeneratorT< DisplaceType >::FillPositionHeightCacheLine( const int w4, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc )
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::FillPositionHeightCacheLine( const int w4, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc )
 			{
 				__m128 tmpXxxx, tmpYyyy, tmpZzzz;
 				float* curPos = line;
@@ -456,8 +625,8 @@ namespace Poc1
 
 					//	Disable normalize to remove sphere mapping
 				//	Normalize( tmpXxxx, tmpYyyy, tmpZzzz );
-					SetLength( tmpXxxx, tmpYyyy, tmpZzzz, m_Displacer.GetFunctionScale( ) );
-					__m128 heights = m_Displacer.Displace( tmpXxxx, tmpYyyy, tmpZzzz );
+					SetLength< Precision >( tmpXxxx, tmpYyyy, tmpZzzz, m_Displacer.GetFunctionScale( ) );
+					__m128 heights = m_Displacer.template Displace< Precision >( tmpXxxx, tmpYyyy, tmpZzzz );
 				
 					//	Uncomment following to clamp the points to the sphere
 				//	tmpXxxx = xxxx;
@@ -478,8 +647,176 @@ namespace Poc1
 				}
 			}
 
-			template < typename DisplaceType >
-			inline float SseSphereTerrainGeneratorT< DisplaceType >::GetMaximumError( const int count, const float* heights0 )
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::InterpolateGroundField( const __m128& values, const __m128& nextValues, float* first, float* second )
+			{
+				//	following[ i ] is values[ i + 1 ], where values[ 4 ] is nextValues[ 0 ]
+				const __m128 shifted = _mm_move_ss( values, nextValues );
+				const __m128 following = _mm_shuffle_ps( shifted, shifted, _MM_SHUFFLE( 0, 3, 2, 1 ) );
+				const __m128 odd = _mm_mul_ps( _mm_add_ps( values, following ), _mm_set1_ps( 0.5f ) );
+				_mm_store_ps( first, _mm_unpacklo_ps( values, odd ) );
+				_mm_store_ps( second, _mm_unpackhi_ps( values, odd ) );
+			}
+
+			template < typename DisplaceType, typename Precision >
+			template < typename GroundDisplacer >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::FillGroundFieldLine( const GroundDisplacer& displacer, const int w8, float* line, __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& colXInc, const __m128& colYInc, const __m128& colZInc )
+			{
+				__m128 dispXxxx, dispZzzz;
+				GetGroundValues( displacer, xxxx, yyyy, zzzz, dispXxxx, dispZzzz );
+				for ( int index = 0; index < w8; ++index )
+				{
+					xxxx = _mm_add_ps( xxxx, colXInc );
+					yyyy = _mm_add_ps( yyyy, colYInc );
+					zzzz = _mm_add_ps( zzzz, colZInc );
+
+					//	The last odd vertices are past the end of the row, so don't need the next values
+					__m128 nextXxxx = dispXxxx;
+					__m128 nextZzzz = dispZzzz;
+					if ( index + 1 < w8 )
+					{
+						GetGroundValues( displacer, xxxx, yyyy, zzzz, nextXxxx, nextZzzz );
+					}
+
+					InterpolateGroundField( dispXxxx, nextXxxx, line, line + 8 );
+					InterpolateGroundField( dispZzzz, nextZzzz, line + 4, line + 12 );
+					line += 16;
+
+					dispXxxx = nextXxxx;
+					dispZzzz = nextZzzz;
+				}
+			}
+
+			template < typename DisplaceType, typename Precision >
+			template < typename BaseDisplacer, typename FunctionType >
+			inline bool SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateGroundFieldVertices( const SseSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionType >& displacer, const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, const float uvRes, UTerrainVertex* vertices )
+			{
+				typedef typename SseSphereFunction3dGroundDisplacer< BaseDisplacer, FunctionType >::OffsetDisplacer OffsetDisplacer;
+				if ( !displacer.IsGroundFieldEnabled( ) )
+				{
+					return false;
+				}
+
+				//	The field is only evaluated at every second vertex of every second row if that samples the first
+				//	and last rows and columns, and the steps are small enough
+				const bool reduced = ( width > 1 ) && ( height > 1 ) && ( ( width % 2 ) != 0 ) && ( ( height % 2 ) != 0 ) && displacer.IsGroundFieldReduced( origin, xStep, zStep );
+
+				//	Vertex positions are the same as GenerateVertices()
+				__m128 startXxxx = _mm_set_ps( origin[ 0 ] + xStep[ 0 ] * 3, origin[ 0 ] + xStep[ 0 ] * 2, origin[ 0 ] + xStep[ 0 ], origin[ 0 ] );
+				__m128 startYyyy = _mm_set_ps( origin[ 1 ] + xStep[ 1 ] * 3, origin[ 1 ] + xStep[ 1 ] * 2, origin[ 1 ] + xStep[ 1 ], origin[ 1 ] );
+				__m128 startZzzz = _mm_set_ps( origin[ 2 ] + xStep[ 2 ] * 3, origin[ 2 ] + xStep[ 2 ] * 2, origin[ 2 ] + xStep[ 2 ], origin[ 2 ] );
+				const __m128 colXInc = _mm_set1_ps( xStep[ 0 ] * 4 );
+				const __m128 colYInc = _mm_set1_ps( xStep[ 1 ] * 4 );
+				const __m128 colZInc = _mm_set1_ps( xStep[ 2 ] * 4 );
+				const __m128 rowXInc = _mm_set1_ps( zStep[ 0 ] );
+				const __m128 rowYInc = _mm_set1_ps( zStep[ 1 ] );
+				const __m128 rowZInc = _mm_set1_ps( zStep[ 2 ] );
+
+				//	Field samples start at vertices 0, 2, 4 and 6 of the first row, and move on 8 vertices, or 2 rows
+				__m128 fieldXxxx = _mm_set_ps( origin[ 0 ] + xStep[ 0 ] * 6, origin[ 0 ] + xStep[ 0 ] * 4, origin[ 0 ] + xStep[ 0 ] * 2, origin[ 0 ] );
+				__m128 fieldYyyy = _mm_set_ps( origin[ 1 ] + xStep[ 1 ] * 6, origin[ 1 ] + xStep[ 1 ] * 4, origin[ 1 ] + xStep[ 1 ] * 2, origin[ 1 ] );
+				__m128 fieldZzzz = _mm_set_ps( origin[ 2 ] + xStep[ 2 ] * 6, origin[ 2 ] + xStep[ 2 ] * 4, origin[ 2 ] + xStep[ 2 ] * 2, origin[ 2 ] );
+				const __m128 fieldColXInc = _mm_set1_ps( xStep[ 0 ] * 8 );
+				const __m128 fieldColYInc = _mm_set1_ps( xStep[ 1 ] * 8 );
+				const __m128 fieldColZInc = _mm_set1_ps( xStep[ 2 ] * 8 );
+				const __m128 fieldRowXInc = _mm_set1_ps( zStep[ 0 ] * 2 );
+				const __m128 fieldRowYInc = _mm_set1_ps( zStep[ 1 ] * 2 );
+				const __m128 fieldRowZInc = _mm_set1_ps( zStep[ 2 ] * 2 );
+
+				//	field has the ground values of the last even row, and nextField the values of the row after it
+				FAST_TRACE_PHASES( );
+				const int w8 = ( width + 8 ) / 8;
+				float* field = 0;
+				float* nextField = 0;
+				if ( reduced )
+				{
+					FAST_TRACE_PHASE( TracePhaseCacheFill );
+					SetFpCacheSize( w8 * 16 );
+					field = m_FpCacheLines[ 0 ];
+					nextField = m_FpCacheLines[ 1 ];
+					FillGroundFieldLine( displacer, w8, field, fieldXxxx, fieldYyyy, fieldZzzz, fieldColXInc, fieldColYInc, fieldColZInc );
+				}
+
+				const int widthDiv4 = width / 4;
+				const int widthMod4 = width % 4;
+				const int blocks = ( width + 3 ) / 4;
+				const float uInc = uvRes / ( float )( width - 1 );
+				const float vInc = uvRes / ( float )( height - 1 );
+				const __m128 uuuuInc = _mm_set1_ps( uInc * 4 );
+				const __m128 half = _mm_set1_ps( 0.5f );
+				float v = uv[ 1 ];
+				UTerrainVertex* vertex = vertices;
+				UTerrainVertex dummyVertex;
+
+				for ( int row = 0; row < height; ++row, v += vInc )
+				{
+					const bool oddRow = ( row % 2 ) != 0;
+					if ( reduced && oddRow )
+					{
+						FAST_TRACE_PHASE( TracePhaseCacheFill );
+						fieldXxxx = _mm_add_ps( fieldXxxx, fieldRowXInc );
+						fieldYyyy = _mm_add_ps( fieldYyyy, fieldRowYInc );
+						fieldZzzz = _mm_add_ps( fieldZzzz, fieldRowZInc );
+						FillGroundFieldLine( displacer, w8, nextField, fieldXxxx, fieldYyyy, fieldZzzz, fieldColXInc, fieldColYInc, fieldColZInc );
+					}
+					else if ( reduced && ( row > 0 ) )
+					{
+						float* evenField = nextField;
+						nextField = field;
+						field = evenField;
+					}
+
+					//	Displacement, normals and stores are fused for each block of 4 vertices
+					FAST_TRACE_PHASE( TracePhaseDisplacement );
+					__m128 uuuu = _mm_set_ps( uv[ 0 ] + uInc * 3, uv[ 0 ] + uInc * 2, uv[ 0 ] + uInc, uv[ 0 ] );
+					__m128 xxxx = startXxxx;
+					__m128 yyyy = startYyyy;
+					__m128 zzzz = startZzzz;
+					const float* values = field;
+					const float* nextValues = nextField;
+					for ( int block = 0; block < blocks; ++block )
+					{
+						__m128 offsetXxxx, offsetYyyy, offsetZzzz;
+						if ( reduced )
+						{
+							//	Odd rows are halfway between the even rows either side
+							__m128 dispXxxx = _mm_load_ps( values );
+							__m128 dispZzzz = _mm_load_ps( values + 4 );
+							if ( oddRow )
+							{
+								dispXxxx = _mm_mul_ps( _mm_add_ps( dispXxxx, _mm_load_ps( nextValues ) ), half );
+								dispZzzz = _mm_mul_ps( _mm_add_ps( dispZzzz, _mm_load_ps( nextValues + 4 ) ), half );
+							}
+							GetFrameOffsets( displacer, xxxx, yyyy, zzzz, dispXxxx, dispZzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+							values += 8;
+							nextValues += 8;
+						}
+						else
+						{
+							GetGroundOffsets( displacer, xxxx, yyyy, zzzz, offsetXxxx, offsetYyyy, offsetZzzz );
+						}
+
+						//	The last block of a row fills out dummy vertices past its end
+						const int count = ( block < widthDiv4 ) ? 4 : widthMod4;
+						const OffsetDisplacer offsetDisplacer( displacer, offsetXxxx, offsetYyyy, offsetZzzz );
+						SetVertices( offsetDisplacer, vertex[ 0 ], count > 1 ? vertex[ 1 ] : dummyVertex, count > 2 ? vertex[ 2 ] : dummyVertex, count > 3 ? vertex[ 3 ] : dummyVertex, xxxx, yyyy, zzzz, uuuu, v );
+						vertex += count;
+
+						xxxx = _mm_add_ps( xxxx, colXInc );
+						yyyy = _mm_add_ps( yyyy, colYInc );
+						zzzz = _mm_add_ps( zzzz, colZInc );
+						uuuu = _mm_add_ps( uuuu, uuuuInc );
+					}
+
+					startXxxx = _mm_add_ps( startXxxx, rowXInc );
+					startYyyy = _mm_add_ps( startYyyy, rowYInc );
+					startZzzz = _mm_add_ps( startZzzz, rowZInc );
+				}
+				return true;
+			}
+
+			template < typename DisplaceType, typename Precision >
+			inline float SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetMaximumError( const int count, const float* heights0 )
 			{
 				//	TODO: AP: This is incomplete - it only calculates errors for vertices between x step positions
 				float maxError = 0;
@@ -507,12 +844,21 @@ namespace Poc1
 				return m_Displacer.MapToHeightScale( maxError );
 			}
 
-			template < typename DisplaceType >
-			inline void SseSphereTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices )
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices )
 			{
+				FAST_TRACE_SCOPE_ARG( "SphereTerrainPatch", width * height );
+				FAST_INSTRUMENT_TIME( CounterPatches, CounterPatchTicks );
+				FAST_INSTRUMENT_COUNT( CounterPatchVertices, width * height );
+
 				//*
 				AssignShiftVectors( xStep, zStep );
 
+				if ( GenerateGroundFieldVertices( m_Displacer, origin, xStep, zStep, width, height, uv, uvRes, vertices ) )
+				{
+					return;
+				}
+
 				//	Get start x, y and z positions for the first 4 vertices in the first row
 				//	NOTE: AP: Vectors are apparently reversed, so memory access is more natural (xyzw comes out as [ w, z, y, x ] normally)
 				__m128 startXxxx = _mm_set_ps( origin[ 0 ] + xStep[ 0 ] * 3, origin[ 0 ] + xStep[ 0 ] * 2, origin[ 0 ] + xStep[ 0 ], origin[ 0 ] );
@@ -637,7 +983,7 @@ namespace Poc1
 				float vInc = uvRes / ( float )( height - 1 );
 				float v = 0;
 				__m128 uuuuInc = _mm_set1_ps( uInc * 4 );
-				_CRT_ALIGN( 16 ) float uArr[ 4 ];
+				FAST_ALIGN( 16 ) float uArr[ 4 ];
 
 				for ( int row = 0; row < height; ++row, v += vInc )
 				{
@@ -729,9 +1075,13 @@ namespace Poc1
 				//*/
 			}
 
-			template < typename DisplaceType >
-			inline void SseSphereTerrainGeneratorT< DisplaceType >::GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& error )
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& error )
 			{
+				FAST_TRACE_SCOPE_ARG( "SphereTerrainErrorPatch", width * height );
+				FAST_INSTRUMENT_TIME( CounterPatches, CounterPatchTicks );
+				FAST_INSTRUMENT_COUNT( CounterPatchVertices, width * height );
+
 				//*
 				AssignShiftVectors( xStep, zStep );
 
@@ -819,8 +1169,9 @@ namespace Poc1
 							case 3 : SetErrorVertices( *v0, *v1, xxxx, yyyy, zzzz, uuuu, v, lastHeight, lastIntHeight, error ); break;
 						}
 
-						v0 += widthMod4;
-						v1 += widthMod4;
+						//	The last block writes the vertices from its even lanes (1 or 2 of them)
+						v0 += ( widthMod4 + 1 ) / 2;
+						v1 += ( widthMod4 + 1 ) / 2;
 					}
 
 					startXxxx = _mm_add_ps( startXxxx, rowXInc );
@@ -958,153 +1309,536 @@ namespace Poc1
 				//*/
 			}
 
-			template < typename DisplaceType >
-			inline void SseSphereTerrainGeneratorT< DisplaceType >::FillHeightCacheLine( const int w4, float* line, const UCubeMapFace face, __m128 uuuu, const __m128& vvvv, const __m128& uuuuInc, float* latitudes )
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::FillHeightCacheLine( const int w4, const int planeSize, float* line, const UCubeMapFace face, __m128 uuuu, const __m128& vvvv, const __m128& uuuuInc )
 			{
-				bool storeLatitides = ( latitudes != 0 );
-				for ( int index = 0; index < w4; ++index )
+				float* xLine = line;
+				float* yLine = line + planeSize;
+				float* zLine = line + planeSize * 2;
+				float* heightLine = line + planeSize * 3;
+				for ( int index = 0; index < w4 * 4; index += 4 )
 				{
 					__m128 xxxx, yyyy, zzzz;
-					CubeFacePosition( face, uuuu, vvvv, xxxx, yyyy, zzzz );
-					Normalize( xxxx, yyyy, zzzz );
-					if ( storeLatitides )
-					{
-						_mm_store_ps( latitudes, _mm_sub_ps( _mm_set1_ps( 1 ), Abs( yyyy ) ) );
-						latitudes += 4;
-					}
-
-					__m128 heights = m_Displacer.Displace( xxxx, yyyy, zzzz );
-					_mm_store_ps( line, heights );
-					line += 4;
+					CubeFacePosition( face, m_CubeMapProjection, uuuu, vvvv, xxxx, yyyy, zzzz );
+					SetLength< Precision >( xxxx, yyyy, zzzz, m_Displacer.GetFunctionScale( ) );
+					const __m128 heights = m_Displacer.template Displace< Precision >( xxxx, yyyy, zzzz );
+
+					_mm_store_ps( xLine + index, xxxx );
+					_mm_store_ps( yLine + index, yyyy );
+					_mm_store_ps( zLine + index, zzzz );
+					_mm_store_ps( heightLine + index, heights );
 					uuuu = _mm_add_ps( uuuu, uuuuInc );
 				}
 			}
 
-			template < typename DisplaceType >
-			inline void SseSphereTerrainGeneratorT< DisplaceType >::GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels )
+			template < typename DisplaceType, typename Precision >
+			inline __m128 SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetTexelSlopes( const float* origin, const float* left, const float* right, const float* up, const float* down, const int planeSize, const __m128& normalXxxx, const __m128& normalYyyy, const __m128& normalZzzz )
 			{
-				float incU 			= 2.0f / float( width - 1 );
-				float incV 			= 2.0f / float( height - 1 );
-				__m128 vvvv			= _mm_set1_ps( -1 );
-				__m128 vvvvInc		= _mm_set1_ps( incV );
-				__m128 uuuuStart	= _mm_set_ps( -1 , -1 + incU, -1 + incU * 2, -1 + incU * 3 );
-				__m128 uuuuInc		= _mm_set1_ps( incU * 4 );
-				int w4 = width / 4;
-				
-				const int slopeIndex = 2;	//	Red
-				const int heightIndex = 1;	//	Green
-				const int unusedIndex = 0;
+				const __m128 one = _mm_set1_ps( 1 );
+				const __m128 originXxxx = _mm_loadu_ps( origin );
+				const __m128 originYyyy = _mm_loadu_ps( origin + planeSize );
+				const __m128 originZzzz = _mm_loadu_ps( origin + planeSize * 2 );
+
+				//	Move neighbours to the origin
+				const __m128 leftXxxx = _mm_sub_ps( _mm_loadu_ps( left ), originXxxx );
+				const __m128 leftYyyy = _mm_sub_ps( _mm_loadu_ps( left + planeSize ), originYyyy );
+				const __m128 leftZzzz = _mm_sub_ps( _mm_loadu_ps( left + planeSize * 2 ), originZzzz );
+				const __m128 rightXxxx = _mm_sub_ps( _mm_loadu_ps( right ), originXxxx );
+				const __m128 rightYyyy = _mm_sub_ps( _mm_loadu_ps( right + planeSize ), originYyyy );
+				const __m128 rightZzzz = _mm_sub_ps( _mm_loadu_ps( right + planeSize * 2 ), originZzzz );
+				const __m128 upXxxx = _mm_sub_ps( _mm_loadu_ps( up ), originXxxx );
+				const __m128 upYyyy = _mm_sub_ps( _mm_loadu_ps( up + planeSize ), originYyyy );
+				const __m128 upZzzz = _mm_sub_ps( _mm_loadu_ps( up + planeSize * 2 ), originZzzz );
+				const __m128 downXxxx = _mm_sub_ps( _mm_loadu_ps( down ), originXxxx );
+				const __m128 downYyyy = _mm_sub_ps( _mm_loadu_ps( down + planeSize ), originYyyy );
+				const __m128 downZzzz = _mm_sub_ps( _mm_loadu_ps( down + planeSize * 2 ), originZzzz );
+
+				//	u and v increase to the right and down, on every face, so this winding gives outward normals
+				__m128 cpXxxx, cpYyyy, cpZzzz;
+				GetCrossProducts( cpXxxx, cpYyyy, cpZzzz, leftXxxx, leftYyyy, leftZzzz, upXxxx, upYyyy, upZzzz );
+				AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, downXxxx, downYyyy, downZzzz, leftXxxx, leftYyyy, leftZzzz );
+				AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, rightXxxx, rightYyyy, rightZzzz, downXxxx, downYyyy, downZzzz );
+				AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, upXxxx, upYyyy, upZzzz, rightXxxx, rightYyyy, rightZzzz );
+				SetLength< Precision >( cpXxxx, cpYyyy, cpZzzz, one );
+
+				const __m128 slopes = _mm_sub_ps( one, Dot( cpXxxx, cpYyyy, cpZzzz, normalXxxx, normalYyyy, normalZzzz ) );
+				return Clamp( Precision::DivConstant( slopes, MaxSlope ), _mm_setzero_ps( ), one );
+			}
+
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor )
+			{
+				FAST_TRACE_SCOPE_ARG( "TerrainPropertyFace", face );
+				GenerateCubeMapFace( face, width, height, stride, pixels, mipChain, compressor, SsePropertyPixelWriter( ) );
+			}
+
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain )
+			{
+				FAST_TRACE_SCOPE_ARG( "TerrainTypeFace", face );
+				GenerateCubeMapFace( face, width, height, stride, pixels, mipChain, 0, SseTerrainTypePixelWriter( selector, format ) );
+			}
+
+			template < typename DisplaceType, typename Precision >
+			template < typename PixelWriter >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor, const PixelWriter& writer )
+			{
+				const int w4 = width / 4;
+				if ( w4 == 0 )
+				{
+					return;
+				}
+				FAST_INSTRUMENT_TIME( CounterFaces, CounterFaceTicks );
+				FAST_INSTRUMENT_COUNT( CounterFaceBytes, height * stride );
+
+				//	Each texel is displaced once. Displaced positions are kept for 3 rows of texels, and the normal
+				//	at a texel comes from its neighbours in the rows above and below, and the columns either side.
+				//	Cache lines have a border block either side of the face, and there is a border row above and
+				//	below it, so edge texels have neighbours too
+				FAST_TRACE_PHASES( );
+				FAST_TRACE_PHASE( TracePhaseCacheFill );
+				const int cacheW4 = w4 + 2;
+				const int planeSize = cacheW4 * 4;
+				SetFpCacheSize( planeSize * 4 );
+				float** cacheLines = m_FpCacheLines;
+
+				//	Lane 0 is the leftmost texel, so neighbouring columns can be loaded at an offset of 1
+				const float incU 		= 2.0f / float( width - 1 );
+				const float incV 		= 2.0f / float( height - 1 );
+				const __m128 uuuuInc	= _mm_set1_ps( incU * 4 );
+				const __m128 uuuuStart	= _mm_sub_ps( _mm_set_ps( -1 + incU * 3, -1 + incU * 2, -1 + incU, -1 ), uuuuInc );
+
+				FillHeightCacheLine( cacheW4, planeSize, cacheLines[ 0 ], face, uuuuStart, _mm_set1_ps( -1 - incV ), uuuuInc );
+				FillHeightCacheLine( cacheW4, planeSize, cacheLines[ 1 ], face, uuuuStart, _mm_set1_ps( -1 ), uuuuInc );
 
-				AssignCubeFaceShiftVectors( face );
+				const int blockSize = writer.GetPixelSize( ) * 4;
+				const __m128 one = _mm_set1_ps( 1 );
 
+				int prevCacheLine = 0;
+				int curCacheLine = 1;
+				int nextCacheLine = 2;
 				unsigned char* rowPixel = pixels;
-				for ( int row = 0; row < height; ++row )
+				for ( int row = 0; row < height; ++row, rowPixel += stride )
 				{
-					__m128 uuuu = uuuuStart;
+					FAST_TRACE_PHASE( TracePhaseDisplacement );
+					const __m128 vvvv = _mm_set1_ps( -1 + incV * float( row ) );
+					FillHeightCacheLine( cacheW4, planeSize, cacheLines[ nextCacheLine ], face, uuuuStart, _mm_set1_ps( -1 + incV * float( row + 1 ) ), uuuuInc );
+
+					const float* above = cacheLines[ prevCacheLine ];
+					const float* current = cacheLines[ curCacheLine ];
+					const float* below = cacheLines[ nextCacheLine ];
+
+					//	Pixels are packed as the slopes are calculated
+					FAST_TRACE_PHASE( TracePhaseNormals );
+					__m128 uuuu = _mm_add_ps( uuuuStart, uuuuInc );
 					unsigned char* curPixel = rowPixel;
-					for ( int col = 0; col < w4; ++col )
+					for ( int index = 4; index < ( w4 + 1 ) * 4; index += 4, curPixel += blockSize )
 					{
-						//	Get the position on the cube face, then project onto unit sphere
-						__m128 xxxx, yyyy, zzzz;
-						CubeFacePosition( face, uuuu, vvvv, xxxx, yyyy, zzzz );
-
-						//	Find heights and slopes at current point
-						__m128 heights, slopes;
-						GetHeightsAndSlopes( xxxx, yyyy, zzzz, heights, slopes );
-
-						//SetLength( xxxx, yyyy, zzzz, _mm_set1_ps( 128 ) );
-						//xxxx = _mm_add_ps( xxxx, _mm_set1_ps( 128 ) );
-						//yyyy = _mm_add_ps( yyyy, _mm_set1_ps( 128 ) );
-						//zzzz = _mm_add_ps( zzzz, _mm_set1_ps( 128 ) );
-
-						//if ( row == 0 || col == 0 || row == height - 1 || col == w4 - 1 )
-						//{
-						//	xxxx = _mm_set1_ps( 0 );
-						//	yyyy = _mm_set1_ps( 0 );
-						//	yyyy = _mm_set1_ps( 0 );
-						//}
-
-						//	Scale up heights and slopes
-						heights = _mm_mul_ps( heights, _mm_set1_ps( 200 ) );
-						slopes = _mm_mul_ps( slopes, _mm_set1_ps( 256 ) );
-
-						//curPixel[ 0 ] = ( unsigned char )xxxx.m128_f32[ 3 ]; curPixel[ 1 ] = ( unsigned char )yyyy.m128_f32[ 3 ]; curPixel[ 2 ] = ( unsigned char )zzzz.m128_f32[ 3 ]; curPixel += 3;
-						//curPixel[ 0 ] = ( unsigned char )xxxx.m128_f32[ 2 ]; curPixel[ 1 ] = ( unsigned char )yyyy.m128_f32[ 2 ]; curPixel[ 2 ] = ( unsigned char )zzzz.m128_f32[ 2 ]; curPixel += 3;
-						//curPixel[ 0 ] = ( unsigned char )xxxx.m128_f32[ 1 ]; curPixel[ 1 ] = ( unsigned char )yyyy.m128_f32[ 1 ]; curPixel[ 2 ] = ( unsigned char )zzzz.m128_f32[ 1 ]; curPixel += 3;
-						//curPixel[ 0 ] = ( unsigned char )xxxx.m128_f32[ 0 ]; curPixel[ 1 ] = ( unsigned char )yyyy.m128_f32[ 0 ]; curPixel[ 2 ] = ( unsigned char )zzzz.m128_f32[ 0 ]; curPixel += 3;
+						const __m128 heights = _mm_load_ps( current + planeSize * 3 + index );
 
-						//	Store in R,G components of pixels (B reserved for latitude later on)
-						curPixel[ slopeIndex ] = ( unsigned char )slopes.m128_f32[ 3 ];  curPixel[ heightIndex ] = ( unsigned char )heights.m128_f32[ 3 ]; curPixel[ unusedIndex ] = 0; curPixel += 3;
-						curPixel[ slopeIndex ] = ( unsigned char )slopes.m128_f32[ 2 ];  curPixel[ heightIndex ] = ( unsigned char )heights.m128_f32[ 2 ]; curPixel[ unusedIndex ] = 0; curPixel += 3;
-						curPixel[ slopeIndex ] = ( unsigned char )slopes.m128_f32[ 1 ];  curPixel[ heightIndex ] = ( unsigned char )heights.m128_f32[ 1 ]; curPixel[ unusedIndex ] = 0; curPixel += 3;
-						curPixel[ slopeIndex ] = ( unsigned char )slopes.m128_f32[ 0 ];  curPixel[ heightIndex ] = ( unsigned char )heights.m128_f32[ 0 ]; curPixel[ unusedIndex ] = 0; curPixel += 3;
+						//	Slope is measured against the undisplaced sphere normal
+						__m128 normalXxxx, normalYyyy, normalZzzz;
+						CubeFacePosition( face, m_CubeMapProjection, uuuu, vvvv, normalXxxx, normalYyyy, normalZzzz );
+						SetLength< Precision >( normalXxxx, normalYyyy, normalZzzz, one );
+						const __m128 slopes = GetTexelSlopes( current + index, current + index - 1, current + index + 1, above + index, below + index, planeSize, normalXxxx, normalYyyy, normalZzzz );
+
+						writer.Write( curPixel, Abs( normalYyyy ), heights, slopes );
 
 						uuuu = _mm_add_ps( uuuu, uuuuInc );
 					}
-					rowPixel += stride;
-					vvvv = _mm_add_ps( vvvv, vvvvInc );
+
+					FAST_TRACE_PHASE( TracePhaseStore );
+					if ( mipChain )
+					{
+						mipChain->WriteRow( writer.GetFormat( ), writer.GetMipFilter( ), w4 * 4, height, pixels, stride, row );
+					}
+					if ( compressor )
+					{
+						compressor->WriteRow( writer.GetChannels( ), w4 * 4, height, pixels, stride, row );
+					}
+
+					prevCacheLine = curCacheLine;
+					curCacheLine = nextCacheLine;
+					nextCacheLine = ( nextCacheLine + 1 ) % 3;
 				}
+			}
 
-				/*
-				//	Determine the required size of the height cache
-				//	This is the width + 8 (4 pixels boundary either side), multiplied by 3 (3 rows of samples are
-				//	needed to calculate derivatives)
-				const int heightCacheSize = ( width + 8 );
-				const int heightCacheSizeDiv4 = heightCacheSize / 4;
-				SetFpCacheSize( heightCacheSize );
-				float** cacheLines = m_FpCacheLines;
-				float* latitudes = new ( Aligned( 16 ) ) float[ heightCacheSize ];
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors )
+			{
+				FAST_TRACE_SCOPE_ARG( "TerrainPropertyCubeMap", size );
+				GenerateCubeMap( size, stride, facePixels, mipChains, compressors, SsePropertyPixelWriter( ) );
+			}
 
-				FillHeightCacheLine( heightCacheSizeDiv4, cacheLines[ 0 ], face, uuuuStart, vvvv, uuuuInc, 0 );
-				vvvv = _mm_add_ps( vvvv, vvvvInc );
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::DisplaceSideTexels( const UCubeMapFace face, const UCubeMapSeams::Side side, const int inset, const int first, const int count )
+			{
+				const int size = m_Seams.GetSize( );
+				const float inc = 2.0f / float( size - 1 );
+				const int end = first + count;
+				for ( int block = first; block < end; block += 4 )
+				{
+					//	Lanes past the last texel repeat it
+					int rows[ 4 ], cols[ 4 ];
+					FAST_ALIGN( 16 ) float us[ 4 ];
+					FAST_ALIGN( 16 ) float vs[ 4 ];
+					for ( int lane = 0; lane < 4; ++lane )
+					{
+						const int k = block + lane < end ? block + lane : end - 1;
+						UCubeMapSeams::GetSideTexel( size, side, inset, k, rows[ lane ], cols[ lane ] );
+						us[ lane ] = -1 + inc * float( cols[ lane ] );
+						vs[ lane ] = -1 + inc * float( rows[ lane ] );
+					}
 
-				FillHeightCacheLine( heightCacheSizeDiv4, cacheLines[ 1 ], face, uuuuStart, vvvv, uuuuInc, 0 );
-				vvvv = _mm_add_ps( vvvv, vvvvInc );
+					__m128 xxxx, yyyy, zzzz;
+					CubeFacePosition( face, m_CubeMapProjection, _mm_load_ps( us ), _mm_load_ps( vs ), xxxx, yyyy, zzzz );
+					SetLength< Precision >( xxxx, yyyy, zzzz, m_Displacer.GetFunctionScale( ) );
+					const __m128 heights = m_Displacer.template Displace< Precision >( xxxx, yyyy, zzzz );
+
+					FAST_ALIGN( 16 ) float samples[ 4 ][ 4 ];
+					_mm_store_ps( samples[ UCubeMapSeams::PlaneX ], xxxx );
+					_mm_store_ps( samples[ UCubeMapSeams::PlaneY ], yyyy );
+					_mm_store_ps( samples[ UCubeMapSeams::PlaneZ ], zzzz );
+					_mm_store_ps( samples[ UCubeMapSeams::PlaneHeight ], heights );
+					for ( int lane = 0; ( lane < 4 ) && ( block + lane < end ); ++lane )
+					{
+						UCubeMapFace faces[ 3 ] = { face, face, face };
+						int texelRows[ 3 ] = { rows[ lane ], 0, 0 };
+						int texelCols[ 3 ] = { cols[ lane ], 0, 0 };
+						const int texels = inset == 0 ? UCubeMapSeams::GetEdgeTexels( size, face, side, block + lane, faces, texelRows, texelCols ) : 1;
+						for ( int texel = 0; texel < texels; ++texel )
+						{
+							m_Seams.SetSample( faces[ texel ], texelRows[ texel ], texelCols[ texel ], samples[ 0 ][ lane ], samples[ 1 ][ lane ], samples[ 2 ][ lane ], samples[ 3 ][ lane ] );
+						}
+					}
+				}
+			}
 
-				FillHeightCacheLine( heightCacheSizeDiv4, cacheLines[ 2 ], face, uuuuStart, vvvv, uuuuInc, &latitudes[ 0 ] );
-				vvvv = _mm_add_ps( vvvv, vvvvInc );
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::SetSideEdgeValues( const UCubeMapFace face, const UCubeMapSeams::Side side, const int first, const int count )
+			{
+				const int size = m_Seams.GetSize( );
+				const float inc = 2.0f / float( size - 1 );
+				const int end = first + count;
+
+				UCubeMapFace neighbourFace;
+				UCubeMapSeams::Side neighbourSide;
+				UCubeMapSeams::GetNeighbour( face, side, neighbourFace, neighbourSide );
+
+				//	Neighbours are taken along the side (left is texel k - 1, and right is texel k + 1), so up is across
+				//	the edge, in the neighbouring face, and down is into the face. This turns the usual neighbours of a
+				//	texel, which keeps the winding. Corners have three neighbours: the one across the edge is used for
+				//	both left and up
+				enum { Origin, Left, Right, Up, Down, Neighbours };
+				for ( int block = first; block < end; block += 4 )
+				{
+					FAST_ALIGN( 16 ) float samples[ Neighbours ][ 4 * 4 ];
+					FAST_ALIGN( 16 ) float us[ 4 ];
+					FAST_ALIGN( 16 ) float vs[ 4 ];
+					for ( int lane = 0; lane < 4; ++lane )
+					{
+						const int k = block + lane < end ? block + lane : end - 1;
+						int rows[ Neighbours ], cols[ Neighbours ];
+						UCubeMapFace faces[ Neighbours ] = { face, face, face, neighbourFace, face };
+						UCubeMapSeams::GetSideTexel( size, side, 0, k, rows[ Origin ], cols[ Origin ] );
+						UCubeMapSeams::GetSideTexel( size, side, 0, k + 1, rows[ Right ], cols[ Right ] );
+						UCubeMapSeams::GetSideTexel( size, neighbourSide, 1, size - 1 - k, rows[ Up ], cols[ Up ] );
+						UCubeMapSeams::GetSideTexel( size, side, 1, k, rows[ Down ], cols[ Down ] );
+						if ( k == 0 )
+						{
+							faces[ Left ] = neighbourFace;
+							rows[ Left ] = rows[ Up ];
+							cols[ Left ] = cols[ Up ];
+						}
+						else
+						{
+							UCubeMapSeams::GetSideTexel( size, side, 0, k - 1, rows[ Left ], cols[ Left ] );
+						}
 
-				int w4 = width / 4;
-				int prevCacheLine = 0;
-				int currentCacheLine = 1;
-				int nextCacheLine = 2;
-				unsigned char* rowPixel = pixels;
-				for ( int row = 0; row < height; ++row )
+						for ( int neighbour = Origin; neighbour < Neighbours; ++neighbour )
+						{
+							float sample[ 4 ];
+							m_Seams.GetSample( faces[ neighbour ], rows[ neighbour ], cols[ neighbour ], sample );
+							for ( int plane = 0; plane < 4; ++plane )
+							{
+								samples[ neighbour ][ plane * 4 + lane ] = sample[ plane ];
+							}
+						}
+						us[ lane ] = -1 + inc * float( cols[ Origin ] );
+						vs[ lane ] = -1 + inc * float( rows[ Origin ] );
+					}
+
+					const __m128 one = _mm_set1_ps( 1 );
+					__m128 normalXxxx, normalYyyy, normalZzzz;
+					CubeFacePosition( face, m_CubeMapProjection, _mm_load_ps( us ), _mm_load_ps( vs ), normalXxxx, normalYyyy, normalZzzz );
+					SetLength< Precision >( normalXxxx, normalYyyy, normalZzzz, one );
+
+					FAST_ALIGN( 16 ) float slopes[ 4 ];
+					FAST_ALIGN( 16 ) float latitudes[ 4 ];
+					_mm_store_ps( slopes, GetTexelSlopes( samples[ Origin ], samples[ Left ], samples[ Right ], samples[ Up ], samples[ Down ], 4, normalXxxx, normalYyyy, normalZzzz ) );
+					_mm_store_ps( latitudes, Abs( normalYyyy ) );
+
+					for ( int lane = 0; ( lane < 4 ) && ( block + lane < end ); ++lane )
+					{
+						UCubeMapFace faces[ 3 ];
+						int rows[ 3 ], cols[ 3 ];
+						const int texels = UCubeMapSeams::GetEdgeTexels( size, face, side, block + lane, faces, rows, cols );
+						for ( int texel = 0; texel < texels; ++texel )
+						{
+							m_Seams.SetEdgeValue( faces[ texel ], rows[ texel ], cols[ texel ], samples[ Origin ][ UCubeMapSeams::PlaneHeight * 4 + lane ], slopes[ lane ], latitudes[ lane ] );
+						}
+					}
+				}
+			}
+
+			template < typename DisplaceType, typename Precision >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::FillCubeMapCacheLine( const UCubeMapFace face, const int row, float* line )
+			{
+				const int size = m_Seams.GetSize( );
+				const int planeSize = m_Seams.GetRowLineSize( );
+				const float inc = 2.0f / float( size - 1 );
+
+				//	The two columns either side of the row are in the rings kept by m_Seams
+				const int ringCols[ 4 ] = { 0, 1, size - 2, size - 1 };
+				for ( int ringCol = 0; ringCol < 4; ++ringCol )
 				{
-					unsigned char* curPixel = rowPixel;
-					float* curHeight = cacheLines[ currentCacheLine ] + 4;
-					float* curLatitude = &( latitudes[ 0 ] );
-					for ( int col = 0; col < w4; ++col, curHeight += 4, curLatitude += 4 )
+					const float* column = m_Seams.GetRingColumn( face, ringCols[ ringCol ] ) + row;
+					for ( int plane = 0; plane < 4; ++plane )
 					{
-						//	TODO: AP: Can determine slope from the 3 cache lines. Use this to determine terrain type from selector
-						//	NOTE: AP: The way latitude is cached means the next line of latitude is being used, rather than the current - should be OK though
-
-						const UColour b0;// = selector.GetColour( curLatitude[ 3 ], curHeight[ 3 ], 0, 1 );
-						const UColour b1;// = selector.GetColour( curLatitude[ 2 ], curHeight[ 2 ], 0, 1 );
-						const UColour b2;// = selector.GetColour( curLatitude[ 1 ], curHeight[ 1 ], 0, 1 );
-						const UColour b3;// = selector.GetColour( curLatitude[ 0 ], curHeight[ 0 ], 0, 1 );
-
-						curPixel[ 0 ]  = b0.R( ); curPixel[ 1 ]  = b0.G( ); curPixel[ 2 ]  = b0.B( );
-						curPixel[ 3 ]  = b1.R( ); curPixel[ 4 ]  = b1.G( ); curPixel[ 5 ]  = b1.B( );
-						curPixel[ 6 ]  = b2.R( ); curPixel[ 7 ]  = b2.G( ); curPixel[ 8 ] = b2.B( );
-						curPixel[ 9 ] = b3.R( ); curPixel[ 10 ] = b3.G( ); curPixel[ 11 ] = b3.B( );
-						curPixel += 12;
+						line[ plane * planeSize + UCubeMapSeams::LinePadding + ringCols[ ringCol ] ] = column[ plane * size ];
 					}
+				}
 
-					//	Move to next row
-					rowPixel += stride;
-					vvvv = _mm_add_ps( vvvv, vvvvInc );
-					prevCacheLine = currentCacheLine;
-					currentCacheLine = nextCacheLine;
-					nextCacheLine = ( nextCacheLine + 1 ) % 3;
-					if ( row < ( height - 1 ) )
+				//	Inner columns start at column 2, so blocks are stored unaligned
+				const __m128 incs = _mm_set1_ps( inc );
+				const __m128 vvvv = _mm_set1_ps( -1 + inc * float( row ) );
+				__m128 cols = _mm_set_ps( 5, 4, 3, 2 );
+				for ( int col = 2; col < size - 2; col += 4 )
+				{
+					__m128 xxxx, yyyy, zzzz;
+					CubeFacePosition( face, m_CubeMapProjection, _mm_add_ps( _mm_set1_ps( -1 ), _mm_mul_ps( incs, cols ) ), vvvv, xxxx, yyyy, zzzz );
+					SetLength< Precision >( xxxx, yyyy, zzzz, m_Displacer.GetFunctionScale( ) );
+					const __m128 heights = m_Displacer.template Displace< Precision >( xxxx, yyyy, zzzz );
+
+					float* curPos = line + UCubeMapSeams::LinePadding + col;
+					_mm_storeu_ps( curPos, xxxx );
+					_mm_storeu_ps( curPos + planeSize, yyyy );
+					_mm_storeu_ps( curPos + planeSize * 2, zzzz );
+					_mm_storeu_ps( curPos + planeSize * 3, heights );
+					cols = _mm_add_ps( cols, _mm_set1_ps( 4 ) );
+				}
+			}
+
+			template < typename DisplaceType, typename Precision >
+			template < typename PixelWriter >
+			inline void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GenerateCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors, const PixelWriter& writer )
+			{
+				//	Callers check the size (the managed TerrainGenerator throws). This only guards the seam buffers
+				if ( ( size < 4 ) || ( ( size % 4 ) != 0 ) )
+				{
+					return;
+				}
+				FAST_TRACE_PHASES( );
+				FAST_TRACE_PHASE( TracePhaseCacheFill );
+				m_Seams.SetSize( size );
+
+				//	Displace the edges and corners of every face from the faces that own them, then the ring of texels
+				//	inside the edges of each face. Every texel in the rings is displaced once
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
 					{
-						FillHeightCacheLine( heightCacheSizeDiv4, cacheLines[ nextCacheLine ], face, uuuuStart, vvvv, uuuuInc, &latitudes[ 0 ] );
+						UCubeMapFace cornerFace;
+						UCubeMapSeams::Side cornerSide;
+						UCubeMapSeams::GetCornerOwner( UCubeMapFace( face ), UCubeMapSeams::Side( side ), cornerFace, cornerSide );
+						if ( cornerFace == face )
+						{
+							DisplaceSideTexels( UCubeMapFace( face ), UCubeMapSeams::Side( side ), 0, 0, 1 );
+						}
+						if ( UCubeMapSeams::OwnsEdge( UCubeMapFace( face ), UCubeMapSeams::Side( side ) ) )
+						{
+							DisplaceSideTexels( UCubeMapFace( face ), UCubeMapSeams::Side( side ), 0, 1, size - 2 );
+						}
 					}
 				}
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
+					{
+						DisplaceSideTexels( UCubeMapFace( face ), UCubeMapSeams::Side( side ), 1, 1, size - 3 );
+					}
+				}
+
+				//	Edge heights, slopes and latitudes, again from the faces that own them
+				FAST_TRACE_PHASE( TracePhaseNormals );
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					for ( int side = UCubeMapSeams::Top; side <= UCubeMapSeams::Left; ++side )
+					{
+						UCubeMapFace cornerFace;
+						UCubeMapSeams::Side cornerSide;
+						UCubeMapSeams::GetCornerOwner( UCubeMapFace( face ), UCubeMapSeams::Side( side ), cornerFace, cornerSide );
+						if ( cornerFace == face )
+						{
+							SetSideEdgeValues( UCubeMapFace( face ), UCubeMapSeams::Side( side ), 0, 1 );
+						}
+						if ( UCubeMapSeams::OwnsEdge( UCubeMapFace( face ), UCubeMapSeams::Side( side ) ) )
+						{
+							SetSideEdgeValues( UCubeMapFace( face ), UCubeMapSeams::Side( side ), 1, size - 2 );
+						}
+					}
+				}
+
+				//	Inner rows are displaced into a rolling cache of 3 lines, laid out like the ring rows. The padding
+				//	either side of each line is read as neighbours of edge texels, whose values are then replaced
+				const int planeSize = m_Seams.GetRowLineSize( );
+				SetFpCacheSize( planeSize * 4 );
+				for ( int cacheLine = 0; cacheLine < 3; ++cacheLine )
+				{
+					memset( m_FpCacheLines[ cacheLine ], 0, planeSize * 4 * sizeof( float ) );
+				}
 
-				AlignedArrayDelete( latitudes );
-				*/
+				const int blockSize = writer.GetPixelSize( ) * 4;
+				const float inc = 2.0f / float( size - 1 );
+				const __m128 one = _mm_set1_ps( 1 );
+				const __m128 incs = _mm_set1_ps( inc );
+				const __m128 lastLane = _mm_castsi128_ps( _mm_set_epi32( -1, 0, 0, 0 ) );
+				for ( int face = NegativeX; face <= PositiveZ; ++face )
+				{
+					FAST_INSTRUMENT_TIME( CounterFaces, CounterFaceTicks );
+					FAST_INSTRUMENT_COUNT( CounterFaceBytes, size * stride );
+
+					const UCubeMapFace uFace = UCubeMapFace( face );
+					unsigned char* pixels = facePixels[ face ];
+					const UMipChain* mipChain = mipChains ? mipChains[ face ] : 0;
+					const UBlockCompressor* compressor = compressors ? compressors[ face ] : 0;
+					const float* leftValues = m_Seams.GetEdgeValues( uFace, UCubeMapSeams::Left );
+					const float* rightValues = m_Seams.GetEdgeValues( uFace, UCubeMapSeams::Right );
+
+					unsigned char* rowPixel = pixels;
+					for ( int row = 0; row < size; ++row, rowPixel += stride )
+					{
+						unsigned char* curPixel = rowPixel;
+						if ( ( row == 0 ) || ( row == size - 1 ) )
+						{
+							//	Top and bottom rows are all edge texels, whose values are already known
+							FAST_TRACE_PHASE( TracePhaseStore );
+							const float* values = m_Seams.GetEdgeValues( uFace, row == 0 ? UCubeMapSeams::Top : UCubeMapSeams::Bottom );
+							for ( int col = 0; col < size; col += 4, curPixel += blockSize )
+							{
+								const __m128 heights = _mm_load_ps( values + size * UCubeMapSeams::ValueHeight + col );
+								const __m128 slopes = _mm_load_ps( values + size * UCubeMapSeams::ValueSlope + col );
+								const __m128 latitudes = _mm_load_ps( values + size * UCubeMapSeams::ValueLatitude + col );
+								writer.Write( curPixel, latitudes, heights, slopes );
+							}
+						}
+						else
+						{
+							if ( !m_Seams.IsRingLine( row + 1 ) )
+							{
+								FAST_TRACE_PHASE( TracePhaseDisplacement );
+								FillCubeMapCacheLine( uFace, row + 1, m_FpCacheLines[ ( row + 1 ) % 3 ] );
+							}
+							FAST_TRACE_PHASE( TracePhaseNormals );
+							const float* above = m_Seams.IsRingLine( row - 1 ) ? m_Seams.GetRingRow( uFace, row - 1 ) : m_FpCacheLines[ ( row - 1 ) % 3 ];
+							const float* current = m_Seams.IsRingLine( row ) ? m_Seams.GetRingRow( uFace, row ) : m_FpCacheLines[ row % 3 ];
+							const float* below = m_Seams.IsRingLine( row + 1 ) ? m_Seams.GetRingRow( uFace, row + 1 ) : m_FpCacheLines[ ( row + 1 ) % 3 ];
+
+							//	u and v are calculated for each texel, rather than accumulated, so they match the edge texels
+							const __m128 vvvv = _mm_set1_ps( -1 + inc * float( row ) );
+							__m128 cols = _mm_set_ps( 3, 2, 1, 0 );
+							for ( int col = 0; col < size; col += 4, curPixel += blockSize )
+							{
+								const int index = UCubeMapSeams::LinePadding + col;
+								__m128 heights = _mm_load_ps( current + planeSize * 3 + index );
+
+								__m128 normalXxxx, normalYyyy, normalZzzz;
+								CubeFacePosition( uFace, m_CubeMapProjection, _mm_add_ps( _mm_set1_ps( -1 ), _mm_mul_ps( incs, cols ) ), vvvv, normalXxxx, normalYyyy, normalZzzz );
+								SetLength< Precision >( normalXxxx, normalYyyy, normalZzzz, one );
+								__m128 slopes = GetTexelSlopes( current + index, current + index - 1, current + index + 1, above + index, below + index, planeSize, normalXxxx, normalYyyy, normalZzzz );
+								__m128 latitudes = Abs( normalYyyy );
+
+								//	The first and last texels of the row are edge texels
+								if ( col == 0 )
+								{
+									heights = _mm_move_ss( heights, _mm_load_ss( leftValues + size * UCubeMapSeams::ValueHeight + row ) );
+									slopes = _mm_move_ss( slopes, _mm_load_ss( leftValues + size * UCubeMapSeams::ValueSlope + row ) );
+									latitudes = _mm_move_ss( latitudes, _mm_load_ss( leftValues + size * UCubeMapSeams::ValueLatitude + row ) );
+								}
+								if ( col == size - 4 )
+								{
+									heights = _mm_or_ps( _mm_andnot_ps( lastLane, heights ), _mm_and_ps( lastLane, _mm_set1_ps( rightValues[ size * UCubeMapSeams::ValueHeight + row ] ) ) );
+									slopes = _mm_or_ps( _mm_andnot_ps( lastLane, slopes ), _mm_and_ps( lastLane, _mm_set1_ps( rightValues[ size * UCubeMapSeams::ValueSlope + row ] ) ) );
+									latitudes = _mm_or_ps( _mm_andnot_ps( lastLane, latitudes ), _mm_and_ps( lastLane, _mm_set1_ps( rightValues[ size * UCubeMapSeams::ValueLatitude + row ] ) ) );
+								}
+
+								writer.Write( curPixel, latitudes, heights, slopes );
+								cols = _mm_add_ps( cols, _mm_set1_ps( 4 ) );
+							}
+						}
+
+						FAST_TRACE_PHASE( TracePhaseStore );
+						if ( mipChain )
+						{
+							mipChain->WriteRow( writer.GetFormat( ), writer.GetMipFilter( ), size, size, pixels, stride, row );
+						}
+						if ( compressor )
+						{
+							compressor->WriteRow( writer.GetChannels( ), size, size, pixels, stride, row );
+						}
+					}
+				}
+			}
+
+			template < typename DisplaceType, typename Precision >
+			void SseSphereTerrainGeneratorT< DisplaceType, Precision >::GetPatchHeightBounds( const float* origin, const float* xStep, const float* zStep, const int width, const int height, float& minHeight, float& maxHeight )
+			{
+				//	Patch positions are projected onto the function sphere before they are displaced. A grid of
+				//	projected positions is bounded, then the bounds are grown to cover the positions between them
+				const float radius = GetLane( m_Displacer.GetFunctionScale( ), 0 );
+				const float colsPerCell = float( width - 1 ) / float( PatchBoundsGridSize - 1 );
+				const float rowsPerCell = float( height - 1 ) / float( PatchBoundsGridSize - 1 );
+
+				SseFunctionRegion region;
+				for ( int row = 0; row < PatchBoundsGridSize; ++row )
+				{
+					for ( int col = 0; col < PatchBoundsGridSize; ++col )
+					{
+						float position[ 3 ];
+						float sqrLength = 0;
+						for ( int axis = 0; axis < 3; ++axis )
+						{
+							position[ axis ] = origin[ axis ] + xStep[ axis ] * colsPerCell * float( col ) + zStep[ axis ] * rowsPerCell * float( row );
+							sqrLength += position[ axis ] * position[ axis ];
+						}
+						const float scale = radius / sqrtf( sqrLength );
+						region.Add( position[ 0 ] * scale, position[ 1 ] * scale, position[ 2 ] * scale );
+					}
+				}
+
+				//	Every patch position is within half a grid cell, along each step vector, of a grid position. Projection
+				//	scales distances down by radius over the distance from the sphere centre, which is at least the
+				//	distance to the patch plane. Degenerate patches get the whole sphere
+				const float normal[ 3 ] =
+				{
+					xStep[ 1 ] * zStep[ 2 ] - xStep[ 2 ] * zStep[ 1 ],
+					xStep[ 2 ] * zStep[ 0 ] - xStep[ 0 ] * zStep[ 2 ],
+					xStep[ 0 ] * zStep[ 1 ] - xStep[ 1 ] * zStep[ 0 ]
+				};
+				const float normalLength = sqrtf( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+				const float planeDistance = fabsf( origin[ 0 ] * normal[ 0 ] + origin[ 1 ] * normal[ 1 ] + origin[ 2 ] * normal[ 2 ] );
+				const float xStepLength = sqrtf( xStep[ 0 ] * xStep[ 0 ] + xStep[ 1 ] * xStep[ 1 ] + xStep[ 2 ] * xStep[ 2 ] );
+				const float zStepLength = sqrtf( zStep[ 0 ] * zStep[ 0 ] + zStep[ 1 ] * zStep[ 1 ] + zStep[ 2 ] * zStep[ 2 ] );
+				const float cellReach = ( xStepLength * colsPerCell + zStepLength * rowsPerCell ) * 0.5f;
+				const float sphereReach = radius * 2;
+				const bool nearPlane = planeDistance * sphereReach > radius * cellReach * normalLength;
+				region.Expand( nearPlane ? radius * cellReach * normalLength / planeDistance : sphereReach );
+
+				const float sphereMin[ 3 ] = { -radius, -radius, -radius };
+				const float sphereMax[ 3 ] = { radius, radius, radius };
+				region.Intersect( SseFunctionRegion( sphereMin, sphereMax ) );
+
+				m_Displacer.GetHeightBounds( region, minHeight, maxHeight );
 			}
 
 			//	-----------------------------------------------------------------------------------
@@ -1,5 +1,6 @@
 #pragma once
 #include <emmintrin.h>
+#include <Instrumentation.h>
 
 namespace Poc1
 {
@@ -3,8 +3,9 @@
 
 #include "UTerrainGenerator.h"
 
-#include <Sse\SseUtils.h>
+#include <Sse/SseUtils.h>
 #include <UVector3.h>
+#include <Trace.h>
 
 namespace Poc1
 {
@@ -30,10 +31,10 @@ namespace Poc1
 
 					inline void SetupVertex( UTerrainVertex& vertex, const int offset, const __m128& x, const __m128& y, const __m128& z, const __m128& nX, const __m128& nY, const __m128& nZ, const __m128& s, const __m128& e, const __m128& u, const float v  )
 					{
-						vertex.SetPosition( x.m128_f32[ offset ], y.m128_f32[ offset ], z.m128_f32[ offset ] );
-						vertex.SetNormal( nX.m128_f32[ offset ], nY.m128_f32[ offset ], nZ.m128_f32[ offset ] );
-						vertex.SetTerrainUv( u.m128_f32[ offset ], v );
-						vertex.SetTerrainParameters( e.m128_f32[ offset ], s.m128_f32[ offset ] );
+						vertex.SetPosition( GetLane( x, offset ), GetLane( y, offset ), GetLane( z, offset ) );
+						vertex.SetNormal( GetLane( nX, offset ), GetLane( nY, offset ), GetLane( nZ, offset ) );
+						vertex.SetTerrainUv( GetLane( u, offset ), v );
+						vertex.SetTerrainParameters( GetLane( e, offset ), GetLane( s, offset ) );
 					}
 
 					inline void SetupVertex( UTerrainVertex& vertex, const int offset, const float* x, const float* y, const float* z, const float* nX, const float* nY, const float* nZ, const float* s, const float* e, const float* u, const float v )
@@ -44,43 +45,43 @@ namespace Poc1
 						vertex.SetTerrainParameters( s[ offset ], e[ offset ] );
 					}
 
-					template < typename DisplaceType >
+					template < typename Precision, typename DisplaceType >
 					inline void DisplaceVertices( DisplaceType& displacer, UTerrainVertex& v0, UTerrainVertex& v1, UTerrainVertex& v2, UTerrainVertex& v3, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, const __m128& uuuu, const float v )
 					{
 						__m128 normalXxxx = xxxx;
 						__m128 normalYyyy = yyyy;
 						__m128 normalZzzz = zzzz;
-						displacer.GetUpVector( normalXxxx, normalYyyy, normalZzzz );
+						displacer.template GetUpVector< Precision >( normalXxxx, normalYyyy, normalZzzz );
 
 						__m128 originXxxx = xxxx;
 						__m128 originYyyy = yyyy;
 						__m128 originZzzz = zzzz;
-						displacer.MapToDisplacementSpace( originXxxx, originYyyy, originZzzz );
-						__m128 heights = displacer.Displace( originXxxx, originYyyy, originZzzz );
+						displacer.template MapToDisplacementSpace< Precision >( originXxxx, originYyyy, originZzzz );
+						__m128 heights = displacer.template Displace< Precision >( originXxxx, originYyyy, originZzzz );
 
 						__m128 leftXxxx = _mm_sub_ps( xxxx, m_ShiftRightXxxx );
 						__m128 leftYyyy = _mm_sub_ps( yyyy, m_ShiftRightYyyy );
 						__m128 leftZzzz = _mm_sub_ps( zzzz, m_ShiftRightZzzz );
-						displacer.MapToDisplacementSpace( leftXxxx, leftYyyy, leftZzzz );
-						displacer.Displace( leftXxxx, leftYyyy, leftZzzz );
+						displacer.template MapToDisplacementSpace< Precision >( leftXxxx, leftYyyy, leftZzzz );
+						displacer.template Displace< Precision >( leftXxxx, leftYyyy, leftZzzz );
 
 						__m128 upXxxx = _mm_sub_ps( xxxx, m_ShiftDownXxxx );
 						__m128 upYyyy = _mm_sub_ps( yyyy, m_ShiftDownYyyy );
 						__m128 upZzzz = _mm_sub_ps( zzzz, m_ShiftDownZzzz );
-						displacer.MapToDisplacementSpace( upXxxx, upYyyy, upZzzz );
-						displacer.Displace( upXxxx, upYyyy, upZzzz );
+						displacer.template MapToDisplacementSpace< Precision >( upXxxx, upYyyy, upZzzz );
+						displacer.template Displace< Precision >( upXxxx, upYyyy, upZzzz );
 						
 						__m128 rightXxxx = _mm_add_ps( xxxx, m_ShiftRightXxxx );
 						__m128 rightYyyy = _mm_add_ps( yyyy, m_ShiftRightYyyy );
 						__m128 rightZzzz = _mm_add_ps( zzzz, m_ShiftRightZzzz );
-						displacer.MapToDisplacementSpace( rightXxxx, rightYyyy, rightZzzz );
-						displacer.Displace( rightXxxx, rightYyyy, rightZzzz );
+						displacer.template MapToDisplacementSpace< Precision >( rightXxxx, rightYyyy, rightZzzz );
+						displacer.template Displace< Precision >( rightXxxx, rightYyyy, rightZzzz );
 
 						__m128 downXxxx = _mm_add_ps( xxxx, m_ShiftDownXxxx );
 						__m128 downYyyy = _mm_add_ps( yyyy, m_ShiftDownYyyy );
 						__m128 downZzzz = _mm_add_ps( zzzz, m_ShiftDownZzzz );
-						displacer.MapToDisplacementSpace( downXxxx, downYyyy, downZzzz );
-						displacer.Displace( downXxxx, downYyyy, downZzzz );
+						displacer.template MapToDisplacementSpace< Precision >( downXxxx, downYyyy, downZzzz );
+						displacer.template Displace< Precision >( downXxxx, downYyyy, downZzzz );
 
 						//	Move positions to the origin
 						leftXxxx = _mm_sub_ps( leftXxxx, originXxxx );
@@ -101,10 +102,10 @@ namespace Poc1
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, rightXxxx, rightYyyy, rightZzzz, upXxxx, upYyyy, upZzzz );
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, downXxxx, downYyyy, downZzzz, rightXxxx, rightYyyy, rightZzzz );
 						AccumulateCrossProducts( cpXxxx, cpYyyy, cpZzzz, leftXxxx, leftYyyy, leftZzzz, downXxxx, downYyyy, downZzzz );
-						SetLength( cpXxxx, cpYyyy, cpZzzz, Constants::Fc_1 );
+						SetLength< Precision >( cpXxxx, cpYyyy, cpZzzz, Constants::Fc_1 );
 						
 						__m128 slopes = _mm_sub_ps( Constants::Fc_1, Dot( cpXxxx, cpYyyy, cpZzzz, Constants::Fc_0, Constants::Fc_1, Constants::Fc_0 ) );
-						slopes = _mm_div_ps( slopes, _mm_set1_ps( 0.3f ) );
+						slopes = Precision::DivConstant( slopes, 0.3f );
 						Clamp( slopes, Constants::Fc_0, Constants::Fc_1 );
 
 						//	TODO: AP: Clamp slopes to 0-1 range
@@ -11,6 +11,7 @@ namespace Poc1
 
 			class UTerrainGenerator;
 			class SseTerrainDisplacer;
+			struct UTerrainFunctionConfig;
 
 			#pragma managed( on )
 
@@ -24,7 +25,23 @@ namespace Poc1
 			{
 				Flat,
 				SimpleFractal,
-				RidgedFractal
+				RidgedFractal,
+				Heightmap		///<	Heights sampled from a heightmap file (see HeightmapTerrainParameters)
+			};
+
+			///	\brief	Precision of the square roots and divides used by generated terrain (see SsePrecision.h)
+			public enum class TerrainPrecision
+			{
+				Exact,		///<	Full precision square roots and divides
+				Fast,		///<	Reciprocal approximations, refined by a Newton-Raphson step
+				Fastest		///<	Raw reciprocal approximations
+			};
+
+			///	\brief	Mappings from cube map face coordinates to sphere positions. MUST MATCH values in UCubeMapProjection
+			public enum class CubeMapProjection
+			{
+				Gnomonic,	///<	Face coordinates are positions on the cube face
+				Tangent		///<	Face coordinates are angles, for near-uniform texel areas. Sample with the tangent cube map lookup (Effects/Shared/cubeMapProjection.cg)
 			};
 
 			///	\brief	Base class for terrain function parameter classes
@@ -55,6 +72,9 @@ namespace Poc1
 					///	\brief	Sets up a terrain displacer
 					void Setup( SseTerrainDisplacer& displacer );
 
+					///	\brief	Copies these parameters into a function configuration
+					virtual void GetConfig( UTerrainFunctionConfig& config );
+
 				private :
 
 					float m_Scale;
@@ -83,6 +103,9 @@ namespace Poc1
 					///	\brief	Gets the name of a specified terrain function type
 					static System::String^ Name( TerrainFunctionType functionType );
 
+					///	\brief	Copies a function and its parameters into a function configuration. function can be null
+					static void GetConfig( TerrainFunction^ function, UTerrainFunctionConfig& config );
+
 					///	\brief	Creates a parameters object for a specified terrain function type
 					static TerrainFunctionParameters^ CreateParameters( TerrainFunctionType functionType );
 
@@ -92,6 +115,9 @@ namespace Poc1
 					///	\brief	Creates a height and ground displacement terrain generator
 					static UTerrainGenerator* CreateGenerator( TerrainGeometry geometry, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction );
 
+					///	\brief	Creates a height and (optional) ground displacement terrain generator, with a specified precision
+					static UTerrainGenerator* CreateGenerator( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction );
+
 				private :
 
 					TerrainFunctionType m_FunctionType;
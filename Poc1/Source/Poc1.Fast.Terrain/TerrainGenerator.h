@@ -14,8 +14,13 @@ namespace Poc1
 		namespace Terrain
 		{
 			class UTerrainGenerator;
+			struct UTerrainGeneratorConfig;
+			ref class TerrainTypeSelector;
 
 			///	\brief	Generates terrain on a sphere
+			///
+			///	GenerateVertices() calls are written to the current terrain recording, if there is one (see TerrainRecorder).
+			///
 			public ref class TerrainGenerator
 			{
 				public :
@@ -30,6 +35,9 @@ namespace Poc1
 					///	\brief	Sets the terrain type generated by this object, and the seed used to initialize the terrain PRN generators
 					TerrainGenerator( TerrainGeometry geometry, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction );
 
+					///	\brief	Sets the terrain type and precision used by this object. groundFunction can be null
+					TerrainGenerator( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction );
+
 					///	\brief	Finalizer. Frees up unmanaged resources
 					!TerrainGenerator( );
 
@@ -39,28 +47,68 @@ namespace Poc1
 					///	\brief	Sets the magnitude of smallest x and z steps that can be passed to GenerateVertices
 					void SetSmallestStepSize( const float x, const float z );
 
+					///	\brief	Sets the mapping from cube map face coordinates to sphere positions, used by the cube map generators
+					void SetCubeMapProjection( CubeMapProjection projection );
+
 					///	\brief	Sets the minimum and maximum heights that can be generated
 					void Setup( const float patchScale, const float minHeight, const float maxHeight );
 
 					///	\brief	Generates a side of a cube map texture used to render this terrain in marble mode
 					///
-					///	Pixel format must be r8g8b8a8
-					///	r = S (S component of spherical coordinate encoded normal
-					///	g = T (T component of spherical coordinate encoded normal
-					///	b = Altitude (normalized)
-					///	a = Unused, for now
+					///	Pixel format must be Format24bppRgb
+					///	r = Slope
+					///	g = Altitude (normalized)
+					///	b = Unused, for now
 					///
 					void GenerateTerrainPropertyCubeMapFace( const CubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels );
 
+					///	\brief	Generates a side of a cube map texture used to render this terrain in marble mode, its mip levels, and a compressed copy
+					///
+					///	mipPixels and mipStrides describe the levels below the face, starting with the level half its size.
+					///	If blocks is not null, the face is also compressed to BC5 blocks (red = slope, green = altitude),
+					///	blockRowStride bytes apart. All levels and blocks are filled in the same pass as the face.
+					///
+					void GenerateTerrainPropertyCubeMapFace( const CubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides, unsigned char* blocks, const int blockRowStride );
+
+					///	\brief	Generates all six sides of the marble mode cube map texture, with seams that match across sides
+					///
+					///	facePixels has the pixels of each side, indexed by CubeMapFace. Sides are size x size pixels, in the
+					///	same format as GenerateTerrainPropertyCubeMapFace(). size must be a multiple of 4, and at least 4,
+					///	or an ArgumentException is thrown. Edge texels are generated once, and written to both sides that
+					///	share them.
+					///
+					void GenerateTerrainPropertyCubeMap( const int size, const int stride, array< System::IntPtr >^ facePixels );
+
+					///	\brief	Generates a side of a cube map texture of terrain colours, so terrain types don't have to be classified per pixel in a shader
+					///
+					///	Colours are blended from the cells of the selector, indexed by latitude, and the altitude and slope
+					///	written by GenerateTerrainPropertyCubeMapFace(). Format8bppIndexed faces get the terrain type of
+					///	the nearest cell instead.
+					///
+					void GenerateTerrainTypeCubeMapFace( const CubeMapFace face, TerrainTypeSelector^ selector, PixelFormat format, const int width, const int height, const int stride, unsigned char* pixels );
+
+					///	\brief	Generates a side of a cube map texture of terrain colours, and its mip levels, in one pass
+					void GenerateTerrainTypeCubeMapFace( const CubeMapFace face, TerrainTypeSelector^ selector, PixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, array< System::IntPtr >^ mipPixels, array< int >^ mipStrides );
+
 					///	\brief	Generates terrain vertex points and normals
 					void GenerateVertices( Point3^ origin, Vector3^ xStep, Vector3^ zStep, const int width, const int height, Point2^ uv, float uvRes, void* vertices );
 
 					///	\brief	Generates terrain vertex points and normals. Calculates maximum patch error
 					void GenerateVertices( Point3^ origin, Vector3^ xStep, Vector3^ zStep, const int width, const int height, Point2^ uv, float uvRes, void* vertices, [System::Runtime::InteropServices::Out]float% error );
 
+					///	\brief	Gets the range of normalized heights that GenerateVertices() can produce for a patch, without generating it
+					void GetPatchHeightBounds( Point3^ origin, Vector3^ xStep, Vector3^ zStep, const int width, const int height, [System::Runtime::InteropServices::Out]float% minHeight, [System::Runtime::InteropServices::Out]float% maxHeight );
+
 				private :
 
+					///	\brief	Stores the generator configuration, for recording
+					void SetConfig( TerrainGeometry geometry, TerrainPrecision precision, TerrainFunction^ heightFunction, TerrainFunction^ groundFunction );
+
+					///	\brief	Writes a GenerateVertices() call to the current terrain recording
+					void RecordCall( const long long startTicks, const int flags, const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, const float uvRes );
+
 					UTerrainGenerator* m_pImpl;
+					UTerrainGeneratorConfig* m_pConfig;
 			};
 
 		}; //Terrain
@@ -0,0 +1,35 @@
+#pragma once
+#include "UTerrainRecorder.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Managed access to the terrain recorder
+			///
+			///	While a recording is running, every TerrainGenerator.GenerateVertices() call is written to the
+			///	recording file, along with the configuration of the generator that made it. The recording can
+			///	be replayed with the native replay tool (Poc1.Fast.Replay).
+			///
+			public ref class TerrainRecorder abstract sealed
+			{
+				public :
+
+					///	\brief	Returns true if a recording is running
+					static property bool Recording
+					{
+						bool get( ) { return UTerrainRecorder::IsRecording( ); }
+					}
+
+					///	\brief	Starts recording to a file, stopping any current recording
+					static void Start( System::String^ path );
+
+					///	\brief	Stops the current recording
+					static void Stop( );
+			};
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,48 @@
+#pragma once
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			class UTerrainTypeSelector;
+
+			///	\brief	Table of terrain types and colours, indexed by latitude, height and slope
+			///
+			///	Used by TerrainGenerator::GenerateTerrainTypeCubeMapFace(). See UTerrainTypeSelector for how cells are
+			///	laid out and looked up.
+			///
+			public ref class TerrainTypeSelector
+			{
+				public :
+
+					///	\brief	Sets up a table with a single white cell, of type 0
+					TerrainTypeSelector( );
+
+					~TerrainTypeSelector( );
+
+					!TerrainTypeSelector( );
+
+					///	\brief	Resizes the table. All cells are set to white, type 0
+					void SetSize( int latitudes, int heights, int slopes );
+
+					///	\brief	Sets the colour and type of a cell
+					void SetCell( int latitude, int height, int slope, System::Drawing::Color colour, int type );
+
+				internal :
+
+					///	\brief	Gets the unmanaged table
+					const UTerrainTypeSelector& GetImpl( );
+
+				private :
+
+					UTerrainTypeSelector* m_pImpl;
+
+			}; //TerrainTypeSelector
+
+		}; //Terrain
+
+	}; //Fast
+
+}; //Poc1
@@ -0,0 +1,166 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <UEnums.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Byte offsets of the red, green, blue and alpha channels in the pixels of a face. Missing channels are -1
+			class UPixelChannels
+			{
+				public :
+
+					enum Channel
+					{
+						Red,
+						Green,
+						Blue,
+						Alpha
+					};
+
+					///	\brief	Sets up the pixel size and channel offsets
+					UPixelChannels( const int bytesPerPixel, const int red, const int green, const int blue, const int alpha );
+
+					///	\brief	Gets the channels of a pixel format. A8 pixels only have alpha, and R8 pixels only have red
+					static UPixelChannels FromFormat( const UPixelFormat format );
+
+					///	\brief	Gets the size of a pixel, in bytes
+					int GetBytesPerPixel( ) const;
+
+					///	\brief	Gets the byte offset of a channel in a pixel, or -1 if pixels don't have the channel
+					int GetOffset( const Channel channel ) const;
+
+				private :
+
+					int m_BytesPerPixel;
+					int m_Offsets[ 4 ];
+			};
+
+			///	\brief	Compresses the rows of a face into a caller-provided buffer of BC3, BC4 or BC5 blocks, while the face is generated
+			///
+			///	Face generators call WriteRow() after writing each row of the face. Each row of 4x4 blocks is compressed
+			///	as soon as its 4 rows of pixels have been written, so the compressed face is complete when generation
+			///	ends. Blocks past the right or bottom edge of a face repeat its last column or row.
+			///
+			///	Channels are taken from the face pixels (see UPixelChannels):
+			///		- Bc4 stores red, or alpha for faces without red
+			///		- Bc5 stores red and green
+			///		- Bc3 stores red, green and blue as a BC1 colour block, and alpha as a BC4 block
+			///	Missing colour channels are read as 0, and missing alpha channels as 255.
+			///
+			///	BC4 blocks (and BC3 alpha blocks) are fitted to the range of their values with SSE2. BC1 colour blocks
+			///	are fitted to the bounding box of their colours, a texel at a time.
+			///
+			class UBlockCompressor
+			{
+				public :
+
+					enum Format
+					{
+						Bc3,		///<	16 bytes per block: BC4 alpha block, then BC1 colour block
+						Bc4,		///<	8 bytes per block: one channel
+						Bc5			///<	16 bytes per block: BC4 red block, then BC4 green block
+					};
+
+					///	\brief	Sets up the compressed format, and the buffer of blocks
+					///
+					///	blockRowStride is the distance between rows of blocks in bytes, at least GetBlockRowSize().
+					///
+					UBlockCompressor( const Format format, unsigned char* blocks, const int blockRowStride );
+
+					///	\brief	Gets the compressed format
+					Format GetFormat( ) const;
+
+					///	\brief	Gets the size of a block in a given format, in bytes
+					static int GetBlockSize( const Format format );
+
+					///	\brief	Gets the size of a row of blocks covering a given face width, in bytes
+					static int GetBlockRowSize( const Format format, const int width );
+
+					///	\brief	Updates the compressed face after a row of the face has been written
+					///
+					///	Rows must be written in order, from row 0. Rows are read back, so the last 4 rows must not have
+					///	been changed since they were written.
+					///
+					void WriteRow( const UPixelChannels& channels, const int width, const int height, const unsigned char* pixels, const int stride, const int row ) const;
+
+					///	\brief	Compresses a row of blocks, from 4 rows of pixels. Rows can repeat
+					static void CompressBlockRow( const Format format, const UPixelChannels& channels, const int width, const unsigned char* const* rows, unsigned char* blocks );
+
+				private :
+
+					Format			m_Format;
+					unsigned char*	m_Blocks;
+					int				m_BlockRowStride;
+			};
+
+			//	---------------------------------------------------- UPixelChannels Inline Methods
+
+			inline UPixelChannels::UPixelChannels( const int bytesPerPixel, const int red, const int green, const int blue, const int alpha ) :
+				m_BytesPerPixel( bytesPerPixel )
+			{
+				m_Offsets[ Red ] = red;
+				m_Offsets[ Green ] = green;
+				m_Offsets[ Blue ] = blue;
+				m_Offsets[ Alpha ] = alpha;
+			}
+
+			inline UPixelChannels UPixelChannels::FromFormat( const UPixelFormat format )
+			{
+				switch ( format )
+				{
+					case FormatR8G8B8	: return UPixelChannels( 3, 0, 1, 2, -1 );
+					case FormatR8G8B8A8	: return UPixelChannels( 4, 0, 1, 2, 3 );
+					case FormatB8G8R8A8	: return UPixelChannels( 4, 2, 1, 0, 3 );
+					case FormatA8		: return UPixelChannels( 1, -1, -1, -1, 0 );
+					case FormatR8		: return UPixelChannels( 1, 0, -1, -1, -1 );
+					case FormatB8G8R8	: return UPixelChannels( 3, 2, 1, 0, -1 );
+				};
+				return UPixelChannels( Fast::GetBytesPerPixel( format ), -1, -1, -1, -1 );
+			}
+
+			inline int UPixelChannels::GetBytesPerPixel( ) const
+			{
+				return m_BytesPerPixel;
+			}
+
+			inline int UPixelChannels::GetOffset( const Channel channel ) const
+			{
+				return m_Offsets[ channel ];
+			}
+
+			//	-------------------------------------------------- UBlockCompressor Inline Methods
+
+			inline UBlockCompressor::UBlockCompressor( const Format format, unsigned char* blocks, const int blockRowStride ) :
+				m_Format( format ),
+				m_Blocks( blocks ),
+				m_BlockRowStride( blockRowStride )
+			{
+			}
+
+			inline UBlockCompressor::Format UBlockCompressor::GetFormat( ) const
+			{
+				return m_Format;
+			}
+
+			inline int UBlockCompressor::GetBlockSize( const Format format )
+			{
+				return format == Bc4 ? 8 : 16;
+			}
+
+			inline int UBlockCompressor::GetBlockRowSize( const Format format, const int width )
+			{
+				return ( ( width + 3 ) / 4 ) * GetBlockSize( format );
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
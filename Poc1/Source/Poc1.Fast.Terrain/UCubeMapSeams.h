@@ -0,0 +1,214 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <UEnums.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	The shared edges of the six faces of a cube map, and the texels kept along them while the faces are generated
+			///
+			///	Faces are size x size texels, and the first and last texels of every row and column lie on the edges
+			///	of the cube, so every edge texel belongs to two faces, and every corner texel to three. The sides of
+			///	a face run clockwise (Top from left to right, Right from top to bottom, Bottom from right to left,
+			///	Left from bottom to top), so the two faces that share an edge run along it in opposite directions:
+			///	texel k along one side is texel size - 1 - k along the other.
+			///
+			///	Each edge is owned by the lower numbered of its two faces, and each corner by the lowest numbered of
+			///	its three. Edges and corners are evaluated once, from the face that owns them, and handed to the others.
+			///
+			///	For each face, the two outermost rings of texels are kept as displaced x, y and z positions and
+			///	heights, and the outermost ring as the heights, slopes and latitudes written to the face. Generators
+			///	fill them before any face is written (see SseSphereTerrainGeneratorT::GenerateTerrainPropertyCubeMap()).
+			///
+			class UCubeMapSeams
+			{
+				public :
+
+					///	\brief	Sides of a face, in clockwise order
+					enum Side
+					{
+						Top,
+						Right,
+						Bottom,
+						Left
+					};
+
+					///	\brief	Planes of ring lines
+					enum Plane
+					{
+						PlaneX,
+						PlaneY,
+						PlaneZ,
+						PlaneHeight
+					};
+
+					///	\brief	Arrays of edge values
+					enum Value
+					{
+						ValueHeight,
+						ValueSlope,
+						ValueLatitude
+					};
+
+					///	\brief	Ring row lines start with this many floats of padding, and end with as many
+					enum { LinePadding = 4 };
+
+					///	\brief	Sets up empty seams
+					UCubeMapSeams( );
+
+					///	\brief	Frees samples
+					~UCubeMapSeams( );
+
+					///	\brief	Sets the size of faces. size must be a multiple of 4. Samples are kept until the size changes
+					void SetSize( const int size );
+
+					///	\brief	Gets the size of faces
+					int GetSize( ) const;
+
+					///	\brief	Gets the face, and the side of that face, that shares the edge along a side of a face
+					static void GetNeighbour( const UCubeMapFace face, const Side side, UCubeMapFace& neighbourFace, Side& neighbourSide );
+
+					///	\brief	Returns true if a face owns the edge along one of its sides
+					static bool OwnsEdge( const UCubeMapFace face, const Side side );
+
+					///	\brief	Gets the face that owns the corner at the start of a side, and the side of that face that starts at the corner
+					static void GetCornerOwner( const UCubeMapFace face, const Side side, UCubeMapFace& ownerFace, Side& ownerSide );
+
+					///	\brief	Gets the row and column of texel k along a side of a size x size face, inset texels into the face
+					static void GetSideTexel( const int size, const Side side, const int inset, const int k, int& row, int& col );
+
+					///	\brief	Gets every face texel at texel k along the edge of a side of a face
+					///
+					///	Texel 0 is the corner at the start of the side, which is in three faces. Other edge texels are in
+					///	two. Returns the number of texels, the first of which is the texel in face.
+					///
+					static int GetEdgeTexels( const int size, const UCubeMapFace face, const Side side, const int k, UCubeMapFace* faces, int* rows, int* cols );
+
+					///	\brief	Returns true if a row (or column) is in the two outermost rings of a face
+					bool IsRingLine( const int line ) const;
+
+					///	\brief	Gets the size of each plane of a ring row line (size, plus padding either side)
+					int GetRowLineSize( ) const;
+
+					///	\brief	Gets a row in the two outermost rings of a face
+					///
+					///	The line has 4 planes (see Plane) of GetRowLineSize() floats. Column col is at index col + LinePadding
+					///	of each plane, and the padding is 0.
+					///
+					float* GetRingRow( const UCubeMapFace face, const int row ) const;
+
+					///	\brief	Gets a column in the two outermost rings of a face. The line has 4 planes (see Plane) of size floats, one per row
+					float* GetRingColumn( const UCubeMapFace face, const int col ) const;
+
+					///	\brief	Stores the displaced position and height of a texel in the two outermost rings of a face
+					void SetSample( const UCubeMapFace face, const int row, const int col, const float x, const float y, const float z, const float height );
+
+					///	\brief	Gets the displaced position and height of a texel in the two outermost rings of a face
+					void GetSample( const UCubeMapFace face, const int row, const int col, float* sample ) const;
+
+					///	\brief	Gets the edge values along a side of a face
+					///
+					///	There are 3 arrays (see Value) of size floats. Top and Bottom values are indexed by column, Left
+					///	and Right values by row.
+					///
+					float* GetEdgeValues( const UCubeMapFace face, const Side side ) const;
+
+					///	\brief	Stores the height, slope and latitude of an edge texel of a face
+					void SetEdgeValue( const UCubeMapFace face, const int row, const int col, const float height, const float slope, const float latitude );
+
+				private :
+
+					int		m_Size;
+					float*	m_RingRows;
+					float*	m_RingColumns;
+					float*	m_EdgeValues;
+
+					///	\brief	Gets the index of a row (or column) among the 4 ring lines of a face, or -1
+					int GetRingIndex( const int line ) const;
+
+					UCubeMapSeams( const UCubeMapSeams& );
+					UCubeMapSeams& operator = ( const UCubeMapSeams& );
+			};
+
+			//	----------------------------------------------------- UCubeMapSeams Inline Methods
+
+			inline int UCubeMapSeams::GetSize( ) const
+			{
+				return m_Size;
+			}
+
+			inline void UCubeMapSeams::GetSideTexel( const int size, const Side side, const int inset, const int k, int& row, int& col )
+			{
+				switch ( side )
+				{
+					case Top	: row = inset;				col = k;					break;
+					case Right	: row = k;					col = size - 1 - inset;		break;
+					case Bottom	: row = size - 1 - inset;	col = size - 1 - k;			break;
+					default		: row = size - 1 - k;		col = inset;				break;
+				};
+			}
+
+			inline int UCubeMapSeams::GetRingIndex( const int line ) const
+			{
+				return line < 2 ? line : ( line >= m_Size - 2 ? line - m_Size + 4 : -1 );
+			}
+
+			inline bool UCubeMapSeams::IsRingLine( const int line ) const
+			{
+				return GetRingIndex( line ) >= 0;
+			}
+
+			inline int UCubeMapSeams::GetRowLineSize( ) const
+			{
+				return m_Size + LinePadding * 2;
+			}
+
+			inline float* UCubeMapSeams::GetRingRow( const UCubeMapFace face, const int row ) const
+			{
+				return m_RingRows + ( int( face ) * 4 + GetRingIndex( row ) ) * GetRowLineSize( ) * 4;
+			}
+
+			inline float* UCubeMapSeams::GetRingColumn( const UCubeMapFace face, const int col ) const
+			{
+				return m_RingColumns + ( int( face ) * 4 + GetRingIndex( col ) ) * m_Size * 4;
+			}
+
+			inline float* UCubeMapSeams::GetEdgeValues( const UCubeMapFace face, const Side side ) const
+			{
+				return m_EdgeValues + ( int( face ) * 4 + int( side ) ) * m_Size * 3;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+			#ifdef _MANAGED
+
+			#pragma managed
+
+			///	\brief	Gets the pixels of each face, indexed by UCubeMapFace, from a managed array indexed by CubeMapFace
+			inline void GetUCubeMapFacePixels( array< System::IntPtr >^ facePixels, unsigned char** uFacePixels )
+			{
+				if ( facePixels == nullptr )
+				{
+					throw gcnew System::ArgumentNullException( "facePixels" );
+				}
+				if ( facePixels->Length != 6 )
+				{
+					throw gcnew System::ArgumentException( "There must be pixels for each cube map face", "facePixels" );
+				}
+				for ( int face = 0; face < 6; ++face )
+				{
+					uFacePixels[ GetUCubeMapFace( ( Rb::Rendering::Interfaces::Objects::CubeMapFace )face ) ] = ( unsigned char* )facePixels[ face ].ToPointer( );
+				}
+			}
+
+			#endif
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,145 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <UEnums.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Caller-provided buffers for the mip levels of a generated face, filled while the face is generated
+			///
+			///	Face generators call WriteRow() after writing each row of the face (the base level). As soon as the two
+			///	rows under a row of the next level have been written, that row is downsampled from them, and so on down
+			///	the chain, so every level is built from rows that are still in the cache. Level sizes halve, down to a
+			///	minimum of 1. Odd sizes drop their last row or column.
+			///
+			///	Level 0 of the chain is mip level 1 (half the size of the base level).
+			///
+			class UMipChain
+			{
+				public :
+
+					enum { MaxLevels = 16 };
+
+					///	\brief	How each pixel is made from the 2x2 pixels above it
+					enum Filter
+					{
+						BoxFilter,		///<	Rounded average of each channel
+						PointFilter		///<	Top left pixel. Used for faces of terrain types, which can't be averaged
+					};
+
+					///	\brief	Sets up an empty chain
+					UMipChain( );
+
+					///	\brief	Adds the next level to the chain. Ignored once the chain has MaxLevels levels
+					void AddLevel( unsigned char* pixels, const int stride );
+
+					///	\brief	Gets the number of levels in the chain
+					int GetLevels( ) const;
+
+					///	\brief	Gets the pixels of a level
+					unsigned char* GetPixels( const int level ) const;
+
+					///	\brief	Gets the distance between rows of a level, in bytes
+					int GetStride( const int level ) const;
+
+					///	\brief	Gets the width or height of a level, from the width or height of the base level
+					static int GetLevelSize( const int baseSize, const int level );
+
+					///	\brief	Updates the chain after a row of the base level has been written
+					///
+					///	Rows of the base level must be written in order, from row 0. Rows of the base level and the levels
+					///	of the chain are read back, so they must not have been changed since they were written.
+					///
+					void WriteRow( const UPixelFormat format, const Filter filter, const int width, const int height, const unsigned char* base, const int baseStride, const int row ) const;
+
+					///	\brief	Downsamples a pair of rows into a row of the next level
+					///
+					///	dstWidth is half of srcWidth, rounded down, unless srcWidth is 1. row0 and row1 can be the same row.
+					///
+					static void DownsampleRow( const int bytesPerPixel, const Filter filter, const unsigned char* row0, const unsigned char* row1, const int srcWidth, unsigned char* dst, const int dstWidth );
+
+				private :
+
+					unsigned char*	m_Pixels[ MaxLevels ];
+					int				m_Strides[ MaxLevels ];
+					int				m_Levels;
+			};
+
+			//	--------------------------------------------------------- UMipChain Inline Methods
+
+			inline UMipChain::UMipChain( ) :
+				m_Levels( 0 )
+			{
+			}
+
+			inline void UMipChain::AddLevel( unsigned char* pixels, const int stride )
+			{
+				if ( m_Levels < MaxLevels )
+				{
+					m_Pixels[ m_Levels ] = pixels;
+					m_Strides[ m_Levels ] = stride;
+					++m_Levels;
+				}
+			}
+
+			inline int UMipChain::GetLevels( ) const
+			{
+				return m_Levels;
+			}
+
+			inline unsigned char* UMipChain::GetPixels( const int level ) const
+			{
+				return m_Pixels[ level ];
+			}
+
+			inline int UMipChain::GetStride( const int level ) const
+			{
+				return m_Strides[ level ];
+			}
+
+			inline int UMipChain::GetLevelSize( const int baseSize, const int level )
+			{
+				const int size = baseSize >> ( level + 1 );
+				return size < 1 ? 1 : size;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+			#ifdef _MANAGED
+
+			#pragma managed
+
+			///	\brief	Makes a UMipChain from managed arrays of level pixels and strides. Null arrays give an empty chain
+			inline UMipChain GetUMipChain( array< System::IntPtr >^ mipPixels, array< int >^ mipStrides )
+			{
+				UMipChain chain;
+				if ( ( mipPixels == nullptr ) || ( mipStrides == nullptr ) )
+				{
+					return chain;
+				}
+				if ( mipPixels->Length != mipStrides->Length )
+				{
+					throw gcnew System::ArgumentException( "There must be a stride for each mip level", "mipStrides" );
+				}
+				if ( mipPixels->Length > UMipChain::MaxLevels )
+				{
+					throw gcnew System::ArgumentOutOfRangeException( "mipPixels" );
+				}
+				for ( int level = 0; level < mipPixels->Length; ++level )
+				{
+					chain.AddLevel( ( unsigned char* )mipPixels[ level ].ToPointer( ), mipStrides[ level ] );
+				}
+				return chain;
+			}
+
+			#endif
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,90 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "USphereCloudsBitmap.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Animated cloud cube map, with a fixed amount of cloud generation per frame
+			///
+			///	Clouds move by shifting the cloud fractal offsets (see USphereCloudsBitmap::Setup()). Rather than
+			///	regenerating all 6 faces whenever the offsets change, cloud alpha is generated for keyframes, spaced
+			///	a fixed offset change apart, and each frame blends between the current and next keyframes. The
+			///	keyframe after those is generated a few rows per Update(), so that it is complete by the time the
+			///	blend reaches the next keyframe. Generating the first two keyframes in Start() is the only full
+			///	regeneration.
+			///
+			///	SphereCloudsAnimation is a thin managed wrapper around this class.
+			///
+			class USphereCloudsAnimation
+			{
+				public :
+
+					///	\brief	Sets up the face size, and the number of frames between keyframes
+					USphereCloudsAnimation( const int width, const int height, const int framesPerKey );
+
+					///	\brief	Destructor
+					~USphereCloudsAnimation( );
+
+					///	\brief	Starts the animation at a pair of offsets. Generates the first two keyframes
+					///
+					///	xVelocity and zVelocity are the offset changes between keyframes. cloudCutoff and cloudBorder are
+					///	passed to USphereCloudsBitmap::Setup().
+					///
+					void Start( const float xOffset, const float zOffset, const float xVelocity, const float zVelocity, const float cloudCutoff, const float cloudBorder );
+
+					///	\brief	Advances the animation by a frame. Generates GetRowsPerFrame() rows of the keyframe after next
+					void Update( );
+
+					///	\brief	Gets the number of face rows (over all 6 faces) generated by each call to Update()
+					int GetRowsPerFrame( ) const;
+
+					///	\brief	Gets the blend between the current and next keyframes, from 0 (current) to 256 (next)
+					int GetBlend( ) const;
+
+					///	\brief	Writes a cube map face, blended between the current and next keyframes
+					///
+					///	Pixels are laid out in the same way as USphereCloudsBitmap::GenerateCloudsFace(). If mipChain is not
+					///	null, its levels are filled while the face is written, and if compressor is not null, the face is
+					///	compressed while it is written.
+					///
+					void GetCloudsFace( const UCubeMapFace face, const UPixelFormat format, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor ) const;
+
+					///	\brief	Gets the alpha values of a face of a keyframe (0 is the current keyframe, 1 the next, and 2 the keyframe being generated)
+					const unsigned char* GetKeyframeFace( const int key, const UCubeMapFace face ) const;
+
+				private :
+
+					///	\brief	Generates rows [firstRow,firstRow+rows) of a keyframe. Rows run through each face in turn
+					void GenerateKeyframeRows( const int keyframe, unsigned char* alpha, const int firstRow, const int rows );
+
+				private :
+
+					enum { NumKeyframes = 3 };
+
+					USphereCloudsBitmap*	m_Clouds;
+					unsigned char*			m_Keyframes[ NumKeyframes ];	///<	Current, next and generating keyframes. Faces are stored one after another
+					int						m_Width;
+					int						m_Height;
+					int						m_FramesPerKey;
+					int						m_RowsPerFrame;
+					int						m_Keyframe;						///<	Number of the current keyframe since Start()
+					int						m_Frame;						///<	Frames since the current keyframe
+					int						m_NextRow;						///<	Next row of the generating keyframe
+					float					m_XOffset;
+					float					m_ZOffset;
+					float					m_XVelocity;
+					float					m_ZVelocity;
+					float					m_CloudCutoff;
+					float					m_CloudBorder;
+			};
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,107 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <Sse/SseSimpleFractal.h>
+#include <UEnums.h>
+#include "UMipChain.h"
+#include "UBlockCompressor.h"
+#include "UCubeMapSeams.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Unmanaged cloud bitmap generator, for cube mapping onto a sphere
+			///
+			///	SphereCloudsBitmap is a thin managed wrapper around this class.
+			///
+			class FAST_ALIGN( 16 ) USphereCloudsBitmap
+			{
+				public :
+
+					///	\brief	Sets up the cloud fractal
+					USphereCloudsBitmap( );
+
+					///	\brief	Sets generation parameters
+					void Setup( const float xOffset, const float zOffset, const float cloudCutoff, const float cloudBorder );
+
+					///	\brief	Sets the mapping from face coordinates to sphere positions. The default is ProjectionGnomonic
+					///
+					///	Faces generated with ProjectionTangent must be sampled with the tangent cube map lookup (see
+					///	Effects/Shared/cubeMapProjection.cg).
+					///
+					void SetProjection( const UCubeMapProjection projection );
+
+					///	\brief	Generates a face of a cube map
+					///
+					///	If mipChain is not null, its levels are filled while the face is generated (see UMipChain). If
+					///	compressor is not null, the face is also compressed while it is generated (see UBlockCompressor):
+					///	BC4 suits A8 and R8 faces, and BC3 suits faces with colour and alpha.
+					///
+					void GenerateCloudsFace( const UCubeMapFace face, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor );
+
+					///	\brief	Generates all six faces of a cube map, with seams that match across faces
+					///
+					///	Faces are size x size pixels. facePixels has a pointer to the pixels of each face, indexed by
+					///	UCubeMapFace. mipChains and compressors are either null, or have a (possibly null) pointer per face.
+					///
+					///	Edge and corner pixels are shared by faces (see UCubeMapSeams), and get the values of the face that
+					///	owns them, so each face is the same as GenerateCloudsFace() output, apart from the edges it doesn't
+					///	own. Top and bottom rows along edges owned by other faces aren't generated at all.
+					///
+					void GenerateCloudsCubeMap( const UPixelFormat format, const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors );
+
+					///	\brief	Generates the cloud alpha values of rows [firstRow,firstRow+rows) of a width x height face
+					///
+					///	Writes one byte per pixel, the same value as the alpha channel written by GenerateCloudsFace(). Row
+					///	firstRow is written to alpha[0], and each following row stride bytes further on.
+					///
+					void GenerateCloudsAlpha( const UCubeMapFace face, const int width, const int height, const int firstRow, const int rows, const int stride, unsigned char* alpha ) const;
+
+					///	\brief	Writes a row of pixels in a given format, from a row of cloud alpha values
+					///
+					///	Colour channels are white. A8 and R8 rows are the alpha values themselves, so alpha and pixels can be
+					///	the same row for those formats.
+					///
+					static void WriteCloudsPixels( const UPixelFormat format, const int width, const unsigned char* alpha, unsigned char* pixels );
+
+					///	\brief	Gets the block compression format that suits cloud faces of a given format
+					///
+					///	BC4 for single channel faces, which are all alpha, and BC3 for the rest.
+					///
+					static UBlockCompressor::Format GetCompressedFormat( const UPixelFormat format );
+
+				private :
+
+					///	\brief	Cloud values end up as 8-bit alpha, so full precision divides and square roots are wasted
+					typedef SseFastPrecision Precision;
+
+					///	\brief	Gets the alpha values (0-255) of 4 pixels
+					__m128 GetCloudAlpha( const UCubeMapFace face, const __m128& uuuu, const __m128& vvvv ) const;
+
+					///	\brief	Replaces the alpha value of texel k along a side of a face, if the face across the edge has a lower number
+					///
+					///	edgeAlpha has the final alpha values along each side of each face (size values per side).
+					///
+					static void CopySharedAlpha( const UCubeMapFace face, const UCubeMapSeams::Side side, const int k, const int size, const unsigned char* edgeAlpha, unsigned char& alpha );
+
+					__m128 m_XOffset;
+					__m128 m_ZOffset;
+					__m128 m_CloudCutoff;
+					__m128 m_CloudBorder;
+					__m128 m_CloudBorderDiff;
+					__m128 m_MinFractalValue;		///<	Cloud fractal values below this are clear sky
+					__m128 m_MaxFractalValue;		///<	Cloud fractal values above this have saturated alpha
+					UCubeMapProjection m_Projection;
+				//	SseRidgedFractal m_Gen;
+					SseSimpleFractal m_Gen;
+
+			};
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
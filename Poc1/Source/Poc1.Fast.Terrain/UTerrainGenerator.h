@@ -2,7 +2,6 @@
 
 #include "UTerrainVertex.h"
 #include "UEnums.h"
-#include "TerrainFunction.h"
 
 #pragma managed( push, off )
 
@@ -13,6 +12,9 @@ namespace Poc1
 		namespace Terrain
 		{
 			class SseTerrainDisplacer;
+			class UTerrainTypeSelector;
+			class UMipChain;
+			class UBlockCompressor;
 
 			class UTerrainGenerator
 			{
@@ -29,8 +31,20 @@ namespace Poc1
 					///	\brief	Sets the smallest possible step size (finest LOD)
 					void SetSmallestStepSize( const float x, const float z );
 
+					///	\brief	Sets the mapping from cube map face coordinates to sphere positions, used by the cube map generators. The default is ProjectionGnomonic
+					void SetCubeMapProjection( const UCubeMapProjection projection );
+
+					///	\brief	Gets the mapping from cube map face coordinates to sphere positions
+					UCubeMapProjection GetCubeMapProjection( ) const;
+
 					///	\brief	Generates a cube map face bitmap
-					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels ) = 0;
+					virtual void GenerateTerrainPropertyCubeMapFace( const UCubeMapFace face, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain, const UBlockCompressor* compressor ) = 0;
+
+					///	\brief	Generates all six cube map face bitmaps, with seams that match across faces
+					virtual void GenerateTerrainPropertyCubeMap( const int size, const int stride, unsigned char* const* facePixels, const UMipChain* const* mipChains, const UBlockCompressor* const* compressors ) = 0;
+
+					///	\brief	Generates a cube map face bitmap of terrain colours (or terrain types, for single channel formats)
+					virtual void GenerateTerrainTypeCubeMapFace( const UCubeMapFace face, const UTerrainTypeSelector& selector, const UPixelFormat format, const int width, const int height, const int stride, unsigned char* pixels, const UMipChain* mipChain ) = 0;
 
 					///	\brief	Generates terrain vertex points and normals
 					virtual void GenerateVertices( const float* origin, const float* xStep, const float* zStep, const int width, const int height, const float* uv, float uvRes, UTerrainVertex* vertices ) = 0;
@@ -38,10 +52,19 @@ namespace Poc1
 					///	\brief	Generates terrain vertex points and normals. Gets maximum patch error
 					virtual void GenerateVertices( const float* origin, float* xStep, float* zStep, int width, int height, const float* uv, float uvRes, UTerrainVertex* vertices, float& maxError ) = 0;
 
+					///	\brief	Gets the range of heights that GenerateVertices() can produce for a patch, without generating it
+					///
+					///	Heights are the normalized heights returned by the displacer (0 at the minimum height, 1 at the
+					///	maximum height, for the fractal displacers). The range is guaranteed to contain every vertex height,
+					///	but can be wider than the actual range. Patches can be as large as a cube map face.
+					///
+					virtual void GetPatchHeightBounds( const float* origin, const float* xStep, const float* zStep, const int width, const int height, float& minHeight, float& maxHeight ) = 0;
+
 				protected :
 
 					float m_SmallestX;
 					float m_SmallestZ;
+					UCubeMapProjection m_CubeMapProjection;
 
 			}; //UTerrainGenerator
 			
@@ -49,7 +72,8 @@ namespace Poc1
 
 			inline UTerrainGenerator::UTerrainGenerator( ) :
 				m_SmallestX( 0 ),
-				m_SmallestZ( 0 )
+				m_SmallestZ( 0 ),
+				m_CubeMapProjection( ProjectionGnomonic )
 			{
 			}
 
@@ -59,6 +83,16 @@ namespace Poc1
 				m_SmallestZ = z;
 			}
 
+			inline void UTerrainGenerator::SetCubeMapProjection( const UCubeMapProjection projection )
+			{
+				m_CubeMapProjection = projection;
+			}
+
+			inline UCubeMapProjection UTerrainGenerator::GetCubeMapProjection( ) const
+			{
+				return m_CubeMapProjection;
+			}
+
 			//	-----------------------------------------------------------------------------------
 
 		}; //Terrain
@@ -0,0 +1,119 @@
+#pragma once
+#pragma managed(push, off)
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Unmanaged terrain geometry types. MUST MATCH values in TerrainGeometry
+			enum UTerrainGeometry
+			{
+				GeometrySphere,
+				GeometryPlane
+			};
+
+			///	\brief	Unmanaged terrain function types. MUST MATCH values in TerrainFunctionType
+			enum UTerrainFunctionType
+			{
+				FunctionFlat,
+				FunctionSimpleFractal,
+				FunctionRidgedFractal,
+				FunctionHeightmap		///<	Can't be replayed: the heightmap file is not part of the configuration
+			};
+
+			///	\brief	Unmanaged terrain precisions. MUST MATCH values in TerrainPrecision
+			enum UTerrainPrecision
+			{
+				PrecisionExact,
+				PrecisionFast,
+				PrecisionFastest
+			};
+
+			///	\brief	Plain copy of a TerrainFunction and its parameters
+			struct UTerrainFunctionConfig
+			{
+				int		m_FunctionType;		///<	UTerrainFunctionType value
+				float	m_FunctionScale;	///<	TerrainFunctionParameters::FunctionScale
+				float	m_OutputScale;		///<	TerrainFunctionParameters::OutputScale
+				int		m_Seed;				///<	FractalTerrainParameters::Seed (-1 to keep the default seed)
+				int		m_Octaves;			///<	FractalTerrainParameters::Octaves
+				float	m_Frequency;		///<	FractalTerrainParameters::Frequency
+				float	m_Lacunarity;		///<	FractalTerrainParameters::Lacunarity
+
+				///	\brief	Sets up a flat function
+				void Reset( );
+			};
+
+			///	\brief	Plain copy of everything that affects the output of a terrain generator
+			///
+			///	Contains only 4 byte fields, so it has no padding, and can be hashed and written to file directly.
+			///	TerrainGenerator keeps this up to date, so recorded patch generation calls can be replayed
+			///	against an equivalent generator (see UTerrainRecorder).
+			///
+			struct UTerrainGeneratorConfig
+			{
+				int						m_Geometry;		///<	UTerrainGeometry value
+				int						m_Precision;	///<	UTerrainPrecision value
+				UTerrainFunctionConfig	m_Height;		///<	Height function
+				UTerrainFunctionConfig	m_Ground;		///<	Ground function. Flat if there is no ground function
+				int						m_IsSetup;		///<	Non-zero if TerrainGenerator::Setup() has been called
+				float					m_PatchScale;	///<	Last patch scale passed to TerrainGenerator::Setup()
+				float					m_MinHeight;	///<	Last minimum height passed to TerrainGenerator::Setup()
+				float					m_MaxHeight;	///<	Last maximum height passed to TerrainGenerator::Setup()
+				float					m_SmallestX;	///<	Last x step passed to TerrainGenerator::SetSmallestStepSize()
+				float					m_SmallestZ;	///<	Last z step passed to TerrainGenerator::SetSmallestStepSize()
+
+				///	\brief	Sets up a flat sphere generator, with exact precision
+				void Reset( );
+
+				///	\brief	Gets a 32-bit FNV-1a hash of this configuration
+				unsigned int GetHash( ) const;
+			};
+
+			//	--------------------------------------------------- UTerrainGeneratorConfig Inline Methods
+
+			inline void UTerrainFunctionConfig::Reset( )
+			{
+				m_FunctionType = FunctionFlat;
+				m_FunctionScale = 8.0f;
+				m_OutputScale = 1.0f;
+				m_Seed = -1;
+				m_Octaves = 0;
+				m_Frequency = 0;
+				m_Lacunarity = 0;
+			}
+
+			inline void UTerrainGeneratorConfig::Reset( )
+			{
+				m_Geometry = GeometrySphere;
+				m_Precision = PrecisionExact;
+				m_Height.Reset( );
+				m_Ground.Reset( );
+				m_IsSetup = 0;
+				m_PatchScale = 0;
+				m_MinHeight = 0;
+				m_MaxHeight = 0;
+				m_SmallestX = 0;
+				m_SmallestZ = 0;
+			}
+
+			inline unsigned int UTerrainGeneratorConfig::GetHash( ) const
+			{
+				const unsigned char* bytes = ( const unsigned char* )this;
+				unsigned int hash = 2166136261u;
+				for ( int index = 0; index < int( sizeof( UTerrainGeneratorConfig ) ); ++index )
+				{
+					hash = ( hash ^ bytes[ index ] ) * 16777619u;
+				}
+				return hash;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,94 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UTerrainGeneratorConfig.h"
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	A recorded GenerateVertices() call
+			struct UTerrainGenerationCall
+			{
+				enum
+				{
+					CallError = 1		///<	Set if the call calculated the maximum patch error
+				};
+
+				long long		m_StartTicks;		///<	Start time, in ticks since recording started
+				long long		m_DurationTicks;	///<	Time taken by the call, in ticks
+				unsigned int	m_ConfigHash;		///<	Hash of the generator configuration (see UTerrainGeneratorConfig::GetHash())
+				int				m_Flags;			///<	Call flags
+				float			m_Origin[ 3 ];		///<	Patch origin
+				float			m_XStep[ 3 ];		///<	Patch x step, before any adjustment made by the generator
+				float			m_ZStep[ 3 ];		///<	Patch z step, before any adjustment made by the generator
+				int				m_Width;			///<	Patch width, in vertices
+				int				m_Height;			///<	Patch height, in vertices
+				float			m_Uv[ 2 ];			///<	Patch UV origin
+				float			m_UvRes;			///<	Patch UV resolution
+			};
+
+			///	\brief	Records terrain patch generation calls to a binary file, for replaying later
+			///
+			///	File layout: a header (4 byte magic "P1TR", 4 byte version, 8 byte tick frequency), followed by
+			///	blocks. Each block is a 4 byte tag followed by a UTerrainGeneratorConfig (ConfigTag) or a
+			///	UTerrainGenerationCall (CallTag). Each configuration is written once, before the first call that
+			///	uses it. Values are written in native byte order.
+			///
+			///	Recording takes a lock and writes to the file on every call, so it should only be switched on
+			///	when capturing a workload.
+			///
+			class UTerrainRecorder
+			{
+				public :
+
+					enum
+					{
+						Magic		= 0x52543150,	///<	"P1TR"
+						Version		= 1,
+						ConfigTag	= 1,
+						CallTag		= 2
+					};
+
+					///	\brief	Starts recording to a file, stopping any current recording. Returns false if the file could not be opened
+					static bool Start( const char* path );
+
+					///	\brief	Stops recording, and closes the file
+					static void Stop( );
+
+					///	\brief	Returns true if calls are being recorded
+					static bool IsRecording( );
+
+					///	\brief	Records a call. m_StartTicks is absolute (from Instrumentation::GetTicks()) and is made relative to the start of the recording
+					static void Record( const UTerrainGeneratorConfig& config, const UTerrainGenerationCall& call );
+			};
+
+			///	\brief	A recording loaded from file
+			class UTerrainRecording
+			{
+				public :
+
+					///	\brief	Loads a recording. Returns false if the file could not be read, or is not a recording
+					bool Load( const char* path );
+
+					///	\brief	Finds the configuration with a specified hash. Returns 0 if there isn't one
+					const UTerrainGeneratorConfig* FindConfig( const unsigned int hash ) const;
+
+					///	\brief	Tick frequency of the machine the recording was made on
+					long long								m_TicksPerSecond;
+
+					///	\brief	All configurations in the recording
+					std::vector< UTerrainGeneratorConfig >	m_Configs;
+
+					///	\brief	All calls in the recording, in the order they were recorded
+					std::vector< UTerrainGenerationCall >	m_Calls;
+			};
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
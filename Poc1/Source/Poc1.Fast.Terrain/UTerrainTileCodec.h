@@ -0,0 +1,56 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Compresses grids of interleaved float samples, such as the vertices of terrain tiles
+			///
+			///	Each channel is quantized to 16 bits between its smallest and largest value in the grid, so decoded
+			///	values are within GetMaxError() of the originals. Each quantized value is predicted from its left,
+			///	upper and upper-left neighbours (left + upper - upper left), and the difference is zig-zag coded and
+			///	written 7 bits per byte. Smooth channels, like positions and UVs, mostly take a byte per sample.
+			///
+			///	Samples on the edges of the grid are kept exactly, so grids that share an edge, such as neighbouring
+			///	tiles, decode to the same values along it, whatever their ranges. The bits of each edge sample are
+			///	predicted from the previous sample along its edge (the left neighbour along the first and last rows,
+			///	and the upper neighbour along the first and last columns), and the difference is coded in the same way.
+			///
+			///	Encoded layout: the smallest and largest value of each channel (2 floats per channel, in native byte
+			///	order), then the differences of each channel in turn, in row order.
+			///
+			class UTerrainTileCodec
+			{
+				public :
+
+					///	\brief	Encodes a width x height grid of samples, with channels floats per sample. The encoded bytes replace the contents of encoded
+					static void Encode( const float* samples, const int width, const int height, const int channels, std::vector< unsigned char >& encoded );
+
+					///	\brief	Decodes a grid encoded by Encode(). Returns false if the encoded bytes run out before the grid is complete
+					static bool Decode( const unsigned char* encoded, const int size, const int width, const int height, const int channels, float* samples );
+
+					///	\brief	Gets the largest difference between an encoded value and its decoded value, for a channel with a given range
+					static float GetMaxError( const float minValue, const float maxValue );
+			};
+
+			//	------------------------------------------------- UTerrainTileCodec Inline Methods
+
+			inline float UTerrainTileCodec::GetMaxError( const float minValue, const float maxValue )
+			{
+				//	Half a quantization step, plus rounding the decoded value to a float. Values are quantized and decoded
+				//	in doubles, whose rounding is covered by the 0.1% added to the step
+				return ( maxValue - minValue ) * ( 1.0f / 131070.0f ) * 1.001f + ( ( minValue < 0 ? -minValue : minValue ) + ( maxValue < 0 ? -maxValue : maxValue ) ) * 1e-7f;
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
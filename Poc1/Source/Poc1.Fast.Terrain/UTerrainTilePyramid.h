@@ -0,0 +1,267 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UTerrainVertex.h"
+#include <UMappedFileWindows.h>
+#include <map>
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			class UTerrainGenerator;
+
+			///	\brief	The patch covering a whole cube face, at the root of its quadtree of tiles
+			///
+			///	Axes run across the face, from its first vertex to its last, in the space that patches are passed
+			///	to UTerrainGenerator::GenerateVertices().
+			///
+			struct UTerrainTileRoot
+			{
+				float	m_Origin[ 3 ];		///<	Position of the first vertex of the face
+				float	m_UAxis[ 3 ];		///<	Vector along the rows of the face
+				float	m_VAxis[ 3 ];		///<	Vector along the columns of the face
+				float	m_Uv[ 2 ];			///<	Terrain UV of the first vertex
+				float	m_UvRes;			///<	Terrain UV range across the face
+			};
+
+			///	\brief	Index entry of a baked tile. Entries can be read without decoding their tiles
+			struct UTerrainTileEntry
+			{
+				long long	m_Offset;		///<	Offset of the encoded tile from the start of the file
+				int			m_Size;			///<	Size of the encoded tile, in bytes
+				float		m_Error;		///<	Maximum error of the tile, from GenerateVertices()
+				float		m_Centre[ 3 ];	///<	Centre of a sphere around the tile vertex positions
+				float		m_Radius;		///<	Radius of a sphere around the tile vertex positions
+			};
+
+			///	\brief	Header of a tile pyramid file
+			struct UTerrainTilePyramidHeader
+			{
+				unsigned int		m_Magic;			///<	UTerrainTilePyramid::Magic
+				unsigned int		m_Version;			///<	UTerrainTilePyramid::Version
+				int					m_Resolution;		///<	Vertices along each side of a tile
+				int					m_Depth;			///<	Levels of tiles in each face quadtree
+				long long			m_IndexOffset;		///<	Offset of the tile index from the start of the file
+				UTerrainTileRoot	m_Roots[ 6 ];		///<	Root patch of each face
+			};
+
+			///	\brief	A quadtree of pre-generated terrain tiles for each face of a cube, in a single memory mapped file
+			///
+			///	Level 0 of each face is its root patch. Each tile at level l is split into 4 tiles at level l + 1, in
+			///	the same way that terrain patches are split: tile (x, y) covers the part of the root starting at
+			///	( x, y ) / 2^l, and tiles on every level have the same resolution. Tiles hold the UTerrainVertex array
+			///	that GenerateVertices() makes for their patch (positions, normals, UVs and terrain parameters),
+			///	compressed by UTerrainTileCodec.
+			///
+			///	Neighbouring patches don't generate exactly the same vertices along the edge they share, so the
+			///	vertices on the left and top edges of a tile are copied from the tiles to its left and above (see
+			///	GetTileVertices()). UTerrainTileCodec keeps edge vertices exactly, so neighbouring tiles in a face
+			///	decode to the same edge vertices, bit for bit. Edges between faces are not matched.
+			///
+			///	File layout: a UTerrainTilePyramidHeader, then every encoded tile in index order, then the index (a
+			///	UTerrainTileEntry for every tile, starting at a multiple of 8 bytes). Tiles are indexed face by face,
+			///	level by level, then row by row (see GetTileIndex()), so the children of a tile are stored in two runs
+			///	of 2. Values are written in native byte order.
+			///
+			///	Below the baked depth, patches are generated at runtime, as before.
+			///
+			class UTerrainTilePyramid
+			{
+				public :
+
+					enum
+					{
+						Magic		= 0x50543150,	///<	"P1TP"
+						Version		= 2,			///<	2: edge vertices are kept exactly
+						MaxDepth	= 14			///<	Deepest pyramid whose tile indices fit in an int
+					};
+
+					///	\brief	Gets the number of tiles in each face of a pyramid
+					static int GetTilesPerFace( const int depth );
+
+					///	\brief	Gets the index of a tile. The tile must be in the pyramid
+					static int GetTileIndex( const int depth, const int face, const int level, const int x, const int y );
+
+					///	\brief	Gets the patch covered by a tile, as GenerateVertices() parameters
+					static void GetTilePatch( const UTerrainTileRoot& root, const int resolution, const int level, const int x, const int y, float* origin, float* xStep, float* zStep, float* uv, float& uvRes );
+
+					///	\brief	Gets the vertices that Bake() stores for a tile, and the maximum error of its patch
+					///
+					///	The tile is generated, and its shared edges are replaced with the vertices generated for the
+					///	neighbouring tiles to its left, above, and above and to the left (for its first vertex). Bake()
+					///	keeps the edges of the last tiles it generated instead, so only this needs the neighbours generating.
+					///
+					static void GetTileVertices( UTerrainGenerator& generator, const UTerrainTileRoot& root, const int resolution, const int level, const int x, const int y, UTerrainVertex* vertices, float& error );
+
+					///	\brief	Sets up the roots of a pyramid over a cube with corners at ( -1, -1, -1 ) and ( 1, 1, 1 ), with each face covering UVs from 0 to 1
+					static void GetCubeRoots( UTerrainTileRoot* roots );
+
+					///	\brief	Bakes every tile of a pyramid to a file. Returns false if the file could not be written
+					///
+					///	Each tile is generated by generator with GenerateVertices() (the version that calculates the
+					///	maximum error). resolution must be at least 2, and depth between 1 and MaxDepth. A pyramid of depth d
+					///	has 6 * ( 4^d - 1 ) / 3 tiles of resolution^2 vertices, so baking deep pyramids takes a long time.
+					///
+					static bool Bake( const char* path, UTerrainGenerator& generator, const UTerrainTileRoot* roots, const int resolution, const int depth );
+			};
+
+			///	\brief	Streams tiles from a tile pyramid file into a bounded set of decoded tiles
+			///
+			///	The file is memory mapped through a bounded set of windows (see UMappedFileWindows), so only the index
+			///	and the tiles that are decoded are read from disk, and pyramids can be larger than address space. Each
+			///	frame, the caller calls Request() for every tile it wants, with a priority (see GetPriority()), then
+			///	calls Update(). Update() decodes missing tiles in priority order, up to a limit, into the least recently
+			///	requested resident tiles. Tiles requested in the frame are never replaced, so tiles past the resident
+			///	set are left undecoded; the caller generates those patches itself, or uses their resident parents.
+			///
+			///	Update() also asks the operating system to read ahead the encoded children of the tiles that were
+			///	requested, so that they are in memory by the time the camera gets close enough to want them.
+			///
+			///	Streamers are not thread safe.
+			///
+			class UTerrainTileStreamer
+			{
+				public :
+
+					enum
+					{
+						DefaultWindowSize	= 16 << 20,		///<	Default size of the windows that the file is mapped through, in bytes
+						DefaultMaxWindows	= 16			///<	Default number of windows mapped at once
+					};
+
+					///	\brief	Sets up a closed streamer
+					UTerrainTileStreamer( );
+
+					///	\brief	Closes the file, and frees resident tiles
+					~UTerrainTileStreamer( );
+
+					///	\brief	Opens a pyramid file. Returns false if the file could not be opened, or is not a tile pyramid
+					///
+					///	At most maxResidentTiles tiles are decoded at once, and at most maxWindows windows of windowSize
+					///	bytes are mapped at once.
+					///
+					bool Open( const char* path, const int maxResidentTiles, const long long windowSize = DefaultWindowSize, const int maxWindows = DefaultMaxWindows );
+
+					///	\brief	Closes the file, and frees resident tiles
+					void Close( );
+
+					///	\brief	Returns true if a file is open
+					bool IsOpen( ) const;
+
+					///	\brief	Gets the header of the open file
+					const UTerrainTilePyramidHeader& GetHeader( ) const;
+
+					///	\brief	Gets the index entry of a tile, without decoding it. Returns false if the tile is deeper than the pyramid
+					bool GetEntry( const int face, const int level, const int x, const int y, UTerrainTileEntry& entry );
+
+					///	\brief	Gets the priority of a tile seen from a given position: the ratio of its bounding radius to its distance
+					static float GetPriority( const UTerrainTileEntry& entry, const float* position );
+
+					///	\brief	Asks for a tile to be resident after the next Update(). Tiles with higher priorities are decoded first
+					void Request( const int face, const int level, const int x, const int y, const float priority );
+
+					///	\brief	Decodes up to maxDecodes requested tiles that aren't resident. Returns the number of tiles decoded
+					///
+					///	Requests are cleared, and the frame ends.
+					///
+					int Update( const int maxDecodes );
+
+					///	\brief	Gets the vertices of a resident tile, or 0 if the tile isn't resident
+					///
+					///	The vertices stay valid until the tile is replaced, which can happen in an Update() that the tile
+					///	wasn't requested for.
+					///
+					const UTerrainVertex* GetTile( const int face, const int level, const int x, const int y ) const;
+
+					///	\brief	Gets the number of resident tiles
+					int GetResidentCount( ) const;
+
+				private :
+
+					///	\brief	A decoded tile
+					struct Slot
+					{
+						int					m_Tile;			///<	Index of the tile in the slot, or -1
+						unsigned int		m_LastUsed;		///<	Last frame the tile was requested in
+						UTerrainVertex*		m_Vertices;		///<	Decoded vertices. Allocated when the slot is first used
+					};
+
+					///	\brief	A requested tile
+					struct TileRequest
+					{
+						float	m_Priority;
+						int		m_Tile;
+
+						///	\brief	Orders requests by decreasing priority, then by tile index
+						bool operator < ( const TileRequest& request ) const;
+					};
+
+					UMappedFileWindows					m_Windows;
+					UTerrainTilePyramidHeader			m_Header;
+					int									m_TileCount;
+					unsigned int						m_Frame;
+					std::vector< Slot >					m_Slots;
+					std::map< int, int >				m_Resident;
+					std::vector< TileRequest >			m_Requests;
+
+					///	\brief	Gets the index of a tile, or -1 if the tile is deeper than the pyramid
+					int GetTileIndex( const int face, const int level, const int x, const int y ) const;
+
+					///	\brief	Finds a free slot, or the least recently used slot that wasn't requested this frame. Returns -1 if there isn't one
+					int FindFreeSlot( ) const;
+
+					///	\brief	Reads the index entry of a tile. Returns false if the entry couldn't be mapped
+					bool ReadEntry( const int tile, UTerrainTileEntry& entry );
+
+					///	\brief	Asks the operating system to read in the children of a tile
+					void PrefetchChildren( const int tile );
+
+					UTerrainTileStreamer( const UTerrainTileStreamer& );
+					UTerrainTileStreamer& operator = ( const UTerrainTileStreamer& );
+			};
+
+			//	----------------------------------------------- UTerrainTilePyramid Inline Methods
+
+			inline int UTerrainTilePyramid::GetTilesPerFace( const int depth )
+			{
+				return ( ( 1 << ( depth * 2 ) ) - 1 ) / 3;
+			}
+
+			inline int UTerrainTilePyramid::GetTileIndex( const int depth, const int face, const int level, const int x, const int y )
+			{
+				return face * GetTilesPerFace( depth ) + GetTilesPerFace( level ) + ( y << level ) + x;
+			}
+
+			//	---------------------------------------------- UTerrainTileStreamer Inline Methods
+
+			inline bool UTerrainTileStreamer::IsOpen( ) const
+			{
+				return m_Windows.IsOpen( );
+			}
+
+			inline const UTerrainTilePyramidHeader& UTerrainTileStreamer::GetHeader( ) const
+			{
+				return m_Header;
+			}
+
+			inline int UTerrainTileStreamer::GetResidentCount( ) const
+			{
+				return int( m_Resident.size( ) );
+			}
+
+			inline bool UTerrainTileStreamer::TileRequest::operator < ( const TileRequest& request ) const
+			{
+				return ( m_Priority > request.m_Priority ) || ( ( m_Priority == request.m_Priority ) && ( m_Tile < request.m_Tile ) );
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
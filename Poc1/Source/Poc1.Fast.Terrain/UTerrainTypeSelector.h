@@ -0,0 +1,99 @@
+#pragma once
+#pragma managed(push, off)
+
+#include <Sse/SseUtils.h>
+#include <UColour.h>
+#include <UEnums.h>
+
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Terrain
+		{
+			///	\brief	Table of terrain types and colours, indexed by latitude, height and slope
+			///
+			///	The table is a grid of cells. Cell 0 along each axis is at 0, and the last cell is at 1. Latitude is
+			///	the magnitude of the y component of the sphere normal (0 at the equator, 1 at the poles), height is the
+			///	normalized displacer height, and slope is the slope written to terrain property cube map faces. Values
+			///	outside [0,1] are clamped. An axis with a single cell is ignored, so a table with 1 latitude cell is a
+			///	2D height/slope table.
+			///
+			///	Colours are blended from the 8 cells around a position, with 8-bit weights. Types are not blended: the
+			///	type of the nearest cell is used.
+			///
+			///	TerrainTypeSelector is a thin managed wrapper around this class.
+			///
+			class UTerrainTypeSelector
+			{
+				public :
+
+					///	\brief	Axes of the table
+					enum Axis
+					{
+						LatitudeAxis,
+						HeightAxis,
+						SlopeAxis
+					};
+
+					///	\brief	Sets up a table with a single white cell, of type 0
+					UTerrainTypeSelector( );
+
+					///	\brief	Resizes the table. All cells are set to white, type 0
+					void SetSize( const int latitudes, const int heights, const int slopes );
+
+					///	\brief	Gets the number of cells along an axis of the table
+					int GetCells( const Axis axis ) const;
+
+					///	\brief	Sets the colour and type of a cell
+					void SetCell( const int latitude, const int height, const int slope, const UColour& colour, const unsigned char type );
+
+					///	\brief	Gets the colour of a cell
+					UColour GetCellColour( const int latitude, const int height, const int slope ) const;
+
+					///	\brief	Gets the type of a cell
+					unsigned char GetCellType( const int latitude, const int height, const int slope ) const;
+
+					///	\brief	Writes 4 pixels
+					///
+					///	Colour formats get blended cell colours. Single channel formats (FormatA8, FormatR8) get the
+					///	type of the nearest cell.
+					///
+					void WritePixels( const UPixelFormat format, const __m128& latitudes, const __m128& heights, const __m128& slopes, unsigned char* pixels ) const;
+
+				private :
+
+					int								m_Cells[ 3 ];	///<	Number of cells along each Axis
+					std::vector< unsigned int >		m_Colours;		///<	Cell colours, as R, G, B, A bytes in memory
+					std::vector< unsigned char >	m_Types;		///<	Cell types
+
+					///	\brief	Gets the index of a cell in m_Colours and m_Types
+					int GetCellIndex( const int latitude, const int height, const int slope ) const;
+			};
+
+			//	------------------------------------------------ UTerrainTypeSelector Inline Methods
+
+			inline int UTerrainTypeSelector::GetCells( const Axis axis ) const
+			{
+				return m_Cells[ axis ];
+			}
+
+			inline int UTerrainTypeSelector::GetCellIndex( const int latitude, const int height, const int slope ) const
+			{
+				return ( ( latitude * m_Cells[ HeightAxis ] ) + height ) * m_Cells[ SlopeAxis ] + slope;
+			}
+
+			inline unsigned char UTerrainTypeSelector::GetCellType( const int latitude, const int height, const int slope ) const
+			{
+				return m_Types[ GetCellIndex( latitude, height, slope ) ];
+			}
+
+			//	-----------------------------------------------------------------------------------
+
+		}; //Terrain
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,49 @@
+#pragma once
+#include "Sse/SseBulkEvaluation.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Runs bulk evaluation functions from managed code, optionally splitting the points between threads
+		///
+		///	Buffers are pinned for the duration of the call, so there is one managed/native transition per
+		///	thread, rather than one per 4 points.
+		///
+		ref class BulkEvaluator
+		{
+			public :
+
+				///	\brief	Evaluates points stored in separate x, y and z arrays
+				static void Evaluate( SseBulkFunction function, const void* impl, array< float >^ x, array< float >^ y, array< float >^ z, array< float >^ results, const int numThreads );
+
+				///	\brief	Evaluates points stored as packed xyz triples
+				static void Evaluate( SseBulkFunction function, const void* impl, array< float >^ points, array< float >^ results, const int numThreads );
+
+				///	\brief	Evaluates count points
+				static void Evaluate( SseBulkFunction function, const void* impl, const SseBulkPoints& points, float* results, const int count, const int numThreads );
+
+			private :
+
+				///	\brief	Minimum number of points worth handing to a separate thread
+				static const int MinPointsPerThread = 4096;
+
+				///	\brief	Sets up a partition of a bulk evaluation
+				BulkEvaluator( SseBulkFunction function, const void* impl, const SseBulkPoints& points, float* results, const int start, const int count );
+
+				///	\brief	Evaluates this partition (thread entry point)
+				void Run( );
+
+				SseBulkFunction	m_Function;
+				const void*		m_Impl;
+				const float*	m_X;
+				const float*	m_Y;
+				const float*	m_Z;
+				bool			m_Packed;
+				float*			m_Results;
+				int				m_Start;
+				int				m_Count;
+		};
+
+	}; //Fast
+}; //Poc1
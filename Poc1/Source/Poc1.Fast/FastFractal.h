@@ -0,0 +1,90 @@
+#pragma once
+#include "Sse/SseSimpleFractal.h"
+#include "Sse/SseRidgedFractal.h"
+#include "BulkEvaluator.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Fractal types supported by FastFractal
+		public enum class FastFractalType
+		{
+			Simple,
+			Ridged
+		};
+
+		///	\brief	Managed wrapper around SSE2 fractal implementations. Evaluates buffers of points in bulk
+		public ref class FastFractal
+		{
+			public :
+
+				///	\brief	Setup constructor. Fractal noise is seeded with value zero
+				FastFractal( FastFractalType type );
+
+				///	\brief	Setup constructor. Fractal noise is seeded with specified value
+				FastFractal( FastFractalType type, unsigned int seed );
+
+				///	\brief	Finalizer. Frees up unmanaged resources
+				!FastFractal( );
+
+				///	\brief	Destructor. Frees up unmanaged resources
+				~FastFractal( );
+
+				///	\brief	Sets up fractal parameters. For ridged fractals, persistence is used as the gain
+				void Setup( float frequency, float persistence, int octaves );
+
+				///	\brief	Gets the type of this fractal
+				property FastFractalType Type
+				{
+					FastFractalType get( ) { return m_Type; }
+				}
+
+				///	\brief	Gets/sets the maximum number of threads used by the bulk methods (default is 1)
+				property int Threads
+				{
+					int get( ) { return m_Threads; }
+					void set( int value ) { m_Threads = value < 1 ? 1 : value; }
+				}
+
+				///	\brief	Generates fractal values in the range [0,1] for points stored in separate x, y and z arrays
+				inline void GetValues( array< float >^ x, array< float >^ y, array< float >^ z, array< float >^ results )
+				{
+					BulkEvaluator::Evaluate( m_BulkFunction, m_pImpl, x, y, z, results, m_Threads );
+				}
+
+				///	\brief	Generates fractal values in the range [0,1] for points stored as packed xyz triples
+				inline void GetValues( array< float >^ points, array< float >^ results )
+				{
+					BulkEvaluator::Evaluate( m_BulkFunction, m_pImpl, points, results, m_Threads );
+				}
+
+				///	\brief	Generates fractal values in the range [0,1] for count points stored in separate x, y and z buffers
+				inline void GetValues( const float* x, const float* y, const float* z, float* results, const int count )
+				{
+					SseBulkPoints points = { x, y, z, false };
+					BulkEvaluator::Evaluate( m_BulkFunction, m_pImpl, points, results, count, m_Threads );
+				}
+
+				///	\brief	Generates fractal values in the range [0,1] for count points stored as packed xyz triples
+				inline void GetValues( const float* points, float* results, const int count )
+				{
+					SseBulkPoints packedPoints = { points, 0, 0, true };
+					BulkEvaluator::Evaluate( m_BulkFunction, m_pImpl, packedPoints, results, count, m_Threads );
+				}
+
+			private :
+
+				///	\brief	Creates the fractal implementation
+				void Create( unsigned int seed );
+
+				///	\brief	Destroys the fractal implementation
+				void Destroy( );
+
+				FastFractalType	m_Type;
+				void*			m_pImpl;
+				SseBulkFunction	m_BulkFunction;
+				int				m_Threads;
+		};
+	};
+};
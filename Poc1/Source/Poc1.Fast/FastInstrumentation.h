@@ -0,0 +1,66 @@
+#pragma once
+#include "Instrumentation.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Snapshot of the native instrumentation counters, returned by FastInstrumentation::GetSnapshot()
+		public value struct FastInstrumentationSnapshot
+		{
+			public :
+
+				const long long NoiseCalls;			///<	Number of 4-point noise evaluations
+				const long long Octaves;			///<	Number of 4-point fractal octaves evaluated
+				const long long DisplaceCalls;		///<	Number of 4-point terrain displacements
+				const long long Patches;			///<	Number of terrain patches generated
+				const long long PatchVertices;		///<	Number of terrain patch vertices generated
+				const double PatchSeconds;			///<	Time spent generating terrain patches
+				const long long Faces;				///<	Number of cube map faces generated
+				const long long FaceBytes;			///<	Number of bytes written to cube map faces
+				const double FaceSeconds;			///<	Time spent generating cube map faces
+				const long long AlignedAllocations;	///<	Number of aligned allocations
+				const long long AlignedBytes;		///<	Number of bytes allocated by aligned allocations
+
+			internal :
+
+				///	\brief	Setup constructor
+				FastInstrumentationSnapshot( const long long* counters, const double secondsPerTick ) :
+					NoiseCalls( counters[ CounterNoiseCalls ] ),
+					Octaves( counters[ CounterOctaves ] ),
+					DisplaceCalls( counters[ CounterDisplaceCalls ] ),
+					Patches( counters[ CounterPatches ] ),
+					PatchVertices( counters[ CounterPatchVertices ] ),
+					PatchSeconds( double( counters[ CounterPatchTicks ] ) * secondsPerTick ),
+					Faces( counters[ CounterFaces ] ),
+					FaceBytes( counters[ CounterFaceBytes ] ),
+					FaceSeconds( double( counters[ CounterFaceTicks ] ) * secondsPerTick ),
+					AlignedAllocations( counters[ CounterAlignedAllocations ] ),
+					AlignedBytes( counters[ CounterAlignedBytes ] )
+				{
+				}
+		};
+
+		///	\brief	Managed access to the native instrumentation counters
+		///
+		///	Counters are only updated if Poc1.Fast was built with POC1_FAST_INSTRUMENTATION set to 1. Otherwise,
+		///	snapshots are all zero.
+		///
+		public ref class FastInstrumentation abstract sealed
+		{
+			public :
+
+				///	\brief	Returns true if instrumentation counters were compiled in
+				static property bool Enabled
+				{
+					bool get( ) { return Instrumentation::IsEnabled( ); }
+				}
+
+				///	\brief	Gets the current totals of all counters, over all threads
+				static FastInstrumentationSnapshot GetSnapshot( );
+
+				///	\brief	Resets all counters to zero
+				static void Reset( );
+		};
+	};
+};
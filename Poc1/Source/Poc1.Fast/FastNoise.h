@@ -1,5 +1,6 @@
 #pragma once
-#include "Sse\SseNoise.h"
+#include "Sse/SseNoise.h"
+#include "BulkEvaluator.h"
 
 namespace Poc1
 {
@@ -56,10 +57,52 @@ namespace Poc1
 					m_pImpl->GenerateRgbBitmap( width, height, pixels, originArr, xAxisArr, yAxisArr );
 				}
 
-				///	\brief	Fills an R8G8B8 bitmap with noise values (different noise in each channel). Noise is tiled
-				inline void GenerateTiledBitmap( const int width, const int height, const int stride, unsigned char* pixels, const float startX, const float startY, const float noiseWidth, const float noiseHeight )
+				///	\brief	Fills a bitmap with seamlessly tiling noise values
+				///
+				///	channels is the number of bytes per pixel (1 to 4), and stride is the distance between rows, in bytes.
+				///	If independentChannels is true, each channel gets different noise, otherwise all channels have the
+				///	same value. noiseWidth and noiseHeight are rounded to whole numbers, so the noise can tile.
+				///
+				inline void GenerateTiledBitmap( const int width, const int height, const int stride, const int channels, const bool independentChannels, unsigned char* pixels, const float startX, const float startY, const float noiseWidth, const float noiseHeight )
 				{
-					m_pImpl->GenerateTiledBitmap( width, height, stride, pixels, startX, startY, noiseWidth, noiseHeight );
+					if ( ( channels < 1 ) || ( channels > 4 ) )
+					{
+						throw gcnew System::ArgumentOutOfRangeException( "channels" );
+					}
+					m_pImpl->GenerateTiledBitmap( width, height, stride, channels, independentChannels, pixels, startX, startY, noiseWidth, noiseHeight );
+				}
+
+				///	\brief	Gets/sets the maximum number of threads used by the bulk noise methods (default is 1)
+				property int Threads
+				{
+					int get( ) { return m_Threads; }
+					void set( int value ) { m_Threads = value < 1 ? 1 : value; }
+				}
+
+				///	\brief	Generates noise values in the range [-1,1] for points stored in separate x, y and z arrays
+				inline void Noise( array< float >^ x, array< float >^ y, array< float >^ z, array< float >^ results )
+				{
+					BulkEvaluator::Evaluate( &SseBulkEvaluateFunction< SseNoise >, m_pImpl, x, y, z, results, m_Threads );
+				}
+
+				///	\brief	Generates noise values in the range [-1,1] for points stored as packed xyz triples
+				inline void Noise( array< float >^ points, array< float >^ results )
+				{
+					BulkEvaluator::Evaluate( &SseBulkEvaluateFunction< SseNoise >, m_pImpl, points, results, m_Threads );
+				}
+
+				///	\brief	Generates noise values in the range [-1,1] for count points stored in separate x, y and z buffers
+				inline void Noise( const float* x, const float* y, const float* z, float* results, const int count )
+				{
+					SseBulkPoints points = { x, y, z, false };
+					BulkEvaluator::Evaluate( &SseBulkEvaluateFunction< SseNoise >, m_pImpl, points, results, count, m_Threads );
+				}
+
+				///	\brief	Generates noise values in the range [-1,1] for count points stored as packed xyz triples
+				inline void Noise( const float* points, float* results, const int count )
+				{
+					SseBulkPoints packedPoints = { points, 0, 0, true };
+					BulkEvaluator::Evaluate( &SseBulkEvaluateFunction< SseNoise >, m_pImpl, packedPoints, results, count, m_Threads );
 				}
 
 				///	\brief	Generates 4 noise values from 4 3d points
@@ -78,6 +121,7 @@ namespace Poc1
 			private :
 
 				SseNoise* m_pImpl;
+				int m_Threads;
 		};
 	};
 };
@@ -0,0 +1,31 @@
+#pragma once
+#include "Trace.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Managed access to the native generator trace
+		///
+		///	While Recording is true, the native generators record spans for each face, patch and bulk evaluation.
+		///	Write() saves them in Chrome trace event format, which can be loaded into chrome://tracing or Perfetto.
+		///
+		public ref class FastTrace abstract sealed
+		{
+			public :
+
+				///	\brief	Gets/sets the recording flag
+				static property bool Recording
+				{
+					bool get( ) { return Trace::IsRecording( ); }
+					void set( bool value ) { Trace::SetRecording( value ); }
+				}
+
+				///	\brief	Discards all recorded spans
+				static void Clear( );
+
+				///	\brief	Writes all recorded spans to a Chrome trace JSON file
+				static void Write( System::String^ path );
+		};
+	};
+};
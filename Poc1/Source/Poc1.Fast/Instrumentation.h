@@ -0,0 +1,108 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Poc1.Fast.h"
+
+///	\brief	Set to 1 to compile instrumentation counters into the noise and terrain hot paths
+///
+///	When this is 0 (the default), the FAST_INSTRUMENT_ macros expand to nothing, and the snapshot
+///	functions return zeroes.
+///
+#ifndef POC1_FAST_INSTRUMENTATION
+#define POC1_FAST_INSTRUMENTATION 0
+#endif
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Instrumentation counters
+		enum UInstrumentationCounter
+		{
+			CounterNoiseCalls,			///<	Number of 4-point noise evaluations
+			CounterOctaves,				///<	Number of 4-point fractal octaves evaluated
+			CounterDisplaceCalls,		///<	Number of 4-point terrain displacements
+			CounterPatches,				///<	Number of terrain patches generated
+			CounterPatchVertices,		///<	Number of terrain patch vertices generated
+			CounterPatchTicks,			///<	Time spent generating terrain patches, in ticks
+			CounterFaces,				///<	Number of cube map faces generated
+			CounterFaceBytes,			///<	Number of bytes written to cube map faces
+			CounterFaceTicks,			///<	Time spent generating cube map faces, in ticks
+			CounterAlignedAllocations,	///<	Number of aligned allocations
+			CounterAlignedBytes,		///<	Number of bytes allocated by aligned allocations
+
+			NumInstrumentationCounters
+		};
+
+		///	\brief	Per-thread instrumentation counters, aggregated on demand
+		///
+		///	Each thread that updates a counter gets its own block of counters, so the hot paths never
+		///	contend for cache lines. Snapshots add up the blocks for all threads. Blocks are not read
+		///	atomically, so a snapshot taken while generators are running is approximate.
+		///
+		class FAST_API Instrumentation
+		{
+			public :
+
+				///	\brief	Returns true if instrumentation was compiled in
+				static bool IsEnabled( );
+
+				///	\brief	Adds a value to a counter on the calling thread
+				static void Add( const UInstrumentationCounter counter, const long long value );
+
+				///	\brief	Fills counters with the sum of the counters on all threads
+				static void GetSnapshot( long long* counters );
+
+				///	\brief	Resets counters on all threads to zero
+				static void Reset( );
+
+				///	\brief	Gets the current time, in ticks
+				static long long GetTicks( );
+
+				///	\brief	Gets the number of ticks per second
+				static long long GetTicksPerSecond( );
+		};
+
+		///	\brief	Adds a count and the elapsed time over its lifetime to a pair of counters
+		class InstrumentationTimer
+		{
+			public :
+
+				///	\brief	Starts timing
+				InstrumentationTimer( const UInstrumentationCounter countCounter, const UInstrumentationCounter tickCounter ) :
+					m_CountCounter( countCounter ),
+					m_TickCounter( tickCounter ),
+					m_Start( Instrumentation::GetTicks( ) )
+				{
+				}
+
+				///	\brief	Stops timing, and updates counters
+				~InstrumentationTimer( )
+				{
+					Instrumentation::Add( m_CountCounter, 1 );
+					Instrumentation::Add( m_TickCounter, Instrumentation::GetTicks( ) - m_Start );
+				}
+
+			private :
+
+				UInstrumentationCounter	m_CountCounter;
+				UInstrumentationCounter	m_TickCounter;
+				long long				m_Start;
+		};
+
+	}; //Fast
+}; //Poc1
+
+#if POC1_FAST_INSTRUMENTATION
+
+	#define FAST_INSTRUMENT_COUNT( Counter, Value )	::Poc1::Fast::Instrumentation::Add( ::Poc1::Fast::Counter, ( Value ) )
+	#define FAST_INSTRUMENT_TIME( Counter, TickCounter )	::Poc1::Fast::InstrumentationTimer instrumentationTimer_( ::Poc1::Fast::Counter, ::Poc1::Fast::TickCounter )
+
+#else
+
+	#define FAST_INSTRUMENT_COUNT( Counter, Value )
+	#define FAST_INSTRUMENT_TIME( Counter, TickCounter )
+
+#endif
+
+#pragma managed(pop)
@@ -1,5 +1,31 @@
 #pragma once
 #include <stdlib.h>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+#include "Instrumentation.h"
+
+///	\brief	Allocates memory aligned to a power of 2 boundary. Returns null if the allocation fails
+inline void* AlignedAlloc( const size_t numBytes, const size_t alignment )
+{
+#ifdef _MSC_VER
+	return _aligned_malloc( numBytes, alignment );
+#else
+	//	posix_memalign() requires an alignment of at least sizeof( void* )
+	void* mem = 0;
+	return ( posix_memalign( &mem, alignment < sizeof( void* ) ? sizeof( void* ) : alignment, numBytes ) == 0 ) ? mem : 0;
+#endif
+}
+
+///	\brief	Frees memory allocated by AlignedAlloc()
+inline void AlignedFree( void* mem )
+{
+#ifdef _MSC_VER
+	_aligned_free( mem );
+#else
+	free( mem );
+#endif
+}
 
 ///	\brief	Tag for placement new
 struct PlacementNew { };
@@ -13,7 +39,7 @@ struct Aligned
 	Aligned( int alignment ) : m_Alignment( alignment ) { }
 };
 
-///	\bref	Placement new
+///	\brief	Placement new
 ///
 ///	Usage:
 ///	\code
@@ -29,7 +55,7 @@ inline void operator delete( void*, const PlacementNew&, void* )
 {
 }
 
-///	\bref	Aligned new
+///	\brief	Aligned new
 ///
 ///	Usage:
 ///	\code
@@ -37,13 +63,34 @@ inline void operator delete( void*, const PlacementNew&, void* )
 ///	\endcode
 inline void* operator new( const size_t numBytes, const Aligned& aligned )
 {
-	return _aligned_malloc( numBytes, aligned.m_Alignment );
+	FAST_INSTRUMENT_COUNT( CounterAlignedAllocations, 1 );
+	FAST_INSTRUMENT_COUNT( CounterAlignedBytes, numBytes );
+	return AlignedAlloc( numBytes, aligned.m_Alignment );
 }
 
 ///	\brief	Aligned delete
 inline void operator delete( void* mem, const Aligned& aligned )
 {
-	_aligned_free( mem );
+	AlignedFree( mem );
+}
+
+///	\brief	Aligned array new. Arrays must be freed with AlignedArrayDelete()
+///
+///	Usage:
+///	\code
+///	new ( Aligned( 16 ) ) Type[ count ];
+///	\endcode
+inline void* operator new[]( const size_t numBytes, const Aligned& aligned )
+{
+	FAST_INSTRUMENT_COUNT( CounterAlignedAllocations, 1 );
+	FAST_INSTRUMENT_COUNT( CounterAlignedBytes, numBytes );
+	return AlignedAlloc( numBytes, aligned.m_Alignment );
+}
+
+///	\brief	Aligned array delete
+inline void operator delete[]( void* mem, const Aligned& aligned )
+{
+	AlignedFree( mem );
 }
 
 ///	\brief	Frees an object that was allocated with aligned new
@@ -53,7 +100,7 @@ inline void AlignedDelete( T* obj )
 	if ( obj != 0 )
 	{
 		obj->~T( );
-		_aligned_free( obj );
+		AlignedFree( obj );
 	}
 }
 
@@ -62,5 +109,5 @@ template < typename T >
 inline void AlignedArrayDelete( T* obj )
 {
 	//	TODO: AP: Add non-POD destructor calls
-	_aligned_free( obj );
+	AlignedFree( obj );
 }
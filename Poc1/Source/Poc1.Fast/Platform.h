@@ -0,0 +1,87 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Poc1.Fast.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Operating system services used by the native code
+		///
+		///	Implemented with the Win32 API on Windows, and with POSIX elsewhere, so that windows.h is only
+		///	included by Platform.cpp.
+		///
+		namespace Platform
+		{
+			///	\brief	Thread local storage slot
+			typedef unsigned long ThreadLocalSlot;
+
+			///	\brief	Slot value that is never returned by AllocateThreadLocalSlot() (equal to TLS_OUT_OF_INDEXES)
+			const ThreadLocalSlot NoThreadLocalSlot = 0xffffffff;
+
+			///	\brief	Atomically sets a value, and returns its previous value. Acts as a full memory barrier
+			FAST_API long AtomicExchange( volatile long* target, const long value );
+
+			///	\brief	Atomically increments a value, and returns the incremented value. Acts as a full memory barrier
+			FAST_API long AtomicIncrement( volatile long* target );
+
+			///	\brief	Gives up the remainder of the calling thread's time slice
+			FAST_API void YieldThread( );
+
+			///	\brief	Allocates a thread local storage slot. Returns NoThreadLocalSlot if no slots are available
+			FAST_API ThreadLocalSlot AllocateThreadLocalSlot( );
+
+			///	\brief	Gets the calling thread's value in a thread local storage slot. Values are initially null
+			FAST_API void* GetThreadLocal( const ThreadLocalSlot slot );
+
+			///	\brief	Sets the calling thread's value in a thread local storage slot
+			FAST_API void SetThreadLocal( const ThreadLocalSlot slot, void* value );
+
+			///	\brief	Gets the current value of a monotonic high resolution timer, in ticks
+			FAST_API long long GetTicks( );
+
+			///	\brief	Gets the number of ticks per second returned by GetTicks()
+			FAST_API long long GetTicksPerSecond( );
+
+			///	\brief	Gets an identifier for the calling thread
+			FAST_API unsigned long GetThreadId( );
+
+			///	\brief	Gets an identifier for the current process
+			FAST_API unsigned long GetProcessId( );
+
+			///	\brief	A file opened for read-only mapping, a view at a time
+			struct MappedFile
+			{
+				long long	m_Size;		///<	Size of the file, in bytes. 0 if no file is open
+				void*		m_Handle;	///<	File mapping object on Windows, and the file descriptor elsewhere
+			};
+
+			///	\brief	Opens a file for mapping. Returns false if the file could not be opened (empty files can't be mapped)
+			FAST_API bool OpenMappedFile( const char* path, MappedFile& file );
+
+			///	\brief	Closes a file opened by OpenMappedFile(). Views of the file must be unmapped first. Does nothing if no file is open
+			FAST_API void CloseMappedFile( MappedFile& file );
+
+			///	\brief	Gets the alignment of view offsets, in bytes (the allocation granularity on Windows, and the page size elsewhere)
+			FAST_API long long GetViewAlignment( );
+
+			///	\brief	Maps a view of a file into memory, read-only. Returns null if the view could not be mapped
+			///
+			///	offset must be a multiple of GetViewAlignment(), and the view must be inside the file. Pages are read
+			///	from the file when they are first touched, and can be dropped again by the operating system. Views
+			///	take up address space, so a 32-bit process should keep them small (see UMappedFileWindows).
+			///
+			FAST_API const unsigned char* MapView( const MappedFile& file, const long long offset, const long long size );
+
+			///	\brief	Unmaps a view mapped by MapView()
+			FAST_API void UnmapView( const unsigned char* view, const long long size );
+
+			///	\brief	Hints that a range of a view will be read soon, so that it can be read in the background
+			FAST_API void PrefetchView( const unsigned char* view, const long long offset, const long long size );
+
+		}; //Platform
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
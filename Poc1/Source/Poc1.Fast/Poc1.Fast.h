@@ -1,6 +1,15 @@
 #pragma once
 
-#ifdef POC1_FAST_EXPORTS
+///	\brief	Import/export specifier for classes and functions in Poc1.Fast
+///
+///	Empty when the native code is built as a static library (POC1_FAST_STATIC, or any compiler other
+///	than MSVC).
+///
+#if defined( POC1_FAST_STATIC ) || !defined( _MSC_VER )
+
+	#define FAST_API
+
+#elif defined( POC1_FAST_EXPORTS )
 
 	#define FAST_API __declspec( dllexport )
 
@@ -8,4 +17,15 @@
 
 	#define FAST_API __declspec( dllimport )
 
+#endif
+
+///	\brief	Aligns a type or variable to a boundary, in bytes
+#ifdef _MSC_VER
+
+	#define FAST_ALIGN( alignment ) __declspec( align( alignment ) )
+
+#else
+
+	#define FAST_ALIGN( alignment ) __attribute__( ( aligned( alignment ) ) )
+
 #endif
\ No newline at end of file
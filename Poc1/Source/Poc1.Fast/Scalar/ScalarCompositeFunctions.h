@@ -0,0 +1,323 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Scalar/ScalarUtils.h"
+#include <math.h>
+
+///	\file	Scalar reference implementations of the composite functions in Sse/SseCompositeFunctions.h
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Blends between 2 values, in the same way as Blend() in SseCompositeFunctions.h
+		inline float ScalarBlend( const float t, const float first, const float second )
+		{
+			return first * ( 1.0f - t ) + second * t;
+		}
+
+		///	\brief	Scalar reference implementation of SseSumFunction
+		template < typename FirstFunction, typename SecondFunction >
+		class ScalarSumFunction
+		{
+			public :
+
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				float GetValue( const float x, const float y, const float z ) const
+				{
+					return m_First.GetValue( x, y, z ) + m_Second.GetValue( x, y, z );
+				}
+
+				float GetSignedValue( const float x, const float y, const float z ) const
+				{
+					return GetValue( x, y, z ) * 2.0f - 1.0f;
+				}
+
+			private :
+
+				FirstFunction	m_First;
+				SecondFunction	m_Second;
+		};
+
+		///	\brief	Scalar reference implementation of SseScaleFunction
+		template < typename FunctionType >
+		class ScalarScaleFunction
+		{
+			public :
+
+				ScalarScaleFunction( ) :
+					m_Scale( 1 ),
+					m_Offset( 0 )
+				{
+				}
+
+				FunctionType& GetFunction( )
+				{
+					return m_Function;
+				}
+
+				void SetScale( const float scale, const float offset )
+				{
+					m_Scale = scale;
+					m_Offset = offset;
+				}
+
+				float GetValue( const float x, const float y, const float z ) const
+				{
+					return m_Function.GetValue( x, y, z ) * m_Scale + m_Offset;
+				}
+
+				float GetSignedValue( const float x, const float y, const float z ) const
+				{
+					return GetValue( x, y, z ) * 2.0f - 1.0f;
+				}
+
+			private :
+
+				float			m_Scale;
+				float			m_Offset;
+				FunctionType	m_Function;
+		};
+
+		///	\brief	Scalar reference implementation of SseMaxFunction
+		template < typename FirstFunction, typename SecondFunction >
+		class ScalarMaxFunction
+		{
+			public :
+
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				float GetValue( const float x, const float y, const float z ) const
+				{
+					//	Same operand order as _mm_max_ps
+					const float first = m_First.GetValue( x, y, z );
+					const float second = m_Second.GetValue( x, y, z );
+					return first > second ? first : second;
+				}
+
+				float GetSignedValue( const float x, const float y, const float z ) const
+				{
+					return GetValue( x, y, z ) * 2.0f - 1.0f;
+				}
+
+			private :
+
+				FirstFunction	m_First;
+				SecondFunction	m_Second;
+		};
+
+		///	\brief	Scalar reference implementation of SseMinFunction
+		template < typename FirstFunction, typename SecondFunction >
+		class ScalarMinFunction
+		{
+			public :
+
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				float GetValue( const float x, const float y, const float z ) const
+				{
+					//	Same operand order as _mm_min_ps
+					const float first = m_First.GetValue( x, y, z );
+					const float second = m_Second.GetValue( x, y, z );
+					return first < second ? first : second;
+				}
+
+				float GetSignedValue( const float x, const float y, const float z ) const
+				{
+					return GetValue( x, y, z ) * 2.0f - 1.0f;
+				}
+
+			private :
+
+				FirstFunction	m_First;
+				SecondFunction	m_Second;
+		};
+
+		///	\brief	Scalar reference implementation of SseWarpFunction
+		template < typename WarpFunction, typename FunctionType >
+		class ScalarWarpFunction
+		{
+			public :
+
+				ScalarWarpFunction( ) :
+					m_YOffset( 3.14f ),
+					m_ZOffset( 6.28f ),
+					m_Amplitude( 0.1f )
+				{
+				}
+
+				WarpFunction& GetWarp( )
+				{
+					return m_Warp;
+				}
+
+				FunctionType& GetFunction( )
+				{
+					return m_Function;
+				}
+
+				void SetAmplitude( const float amplitude )
+				{
+					m_Amplitude = amplitude;
+				}
+
+				float GetValue( float x, float y, float z ) const
+				{
+					Warp( x, y, z );
+					return m_Function.GetValue( x, y, z );
+				}
+
+				float GetSignedValue( float x, float y, float z ) const
+				{
+					Warp( x, y, z );
+					return m_Function.GetSignedValue( x, y, z );
+				}
+
+			private :
+
+				float			m_YOffset;
+				float			m_ZOffset;
+				float			m_Amplitude;
+				WarpFunction	m_Warp;
+				FunctionType	m_Function;
+
+				void Warp( float& x, float& y, float& z ) const
+				{
+					const float offsetX = m_Warp.GetSignedValue( x, y, z );
+					const float offsetY = m_Warp.GetSignedValue( x + m_YOffset, y, z );
+					const float offsetZ = m_Warp.GetSignedValue( x, y, z + m_ZOffset );
+					x = x + offsetX * m_Amplitude;
+					y = y + offsetY * m_Amplitude;
+					z = z + offsetZ * m_Amplitude;
+				}
+		};
+
+		///	\brief	Scalar reference implementation of SseSelectFunction
+		template < typename ControlFunction, typename FirstFunction, typename SecondFunction >
+		class ScalarSelectFunction
+		{
+			public :
+
+				ScalarSelectFunction( )
+				{
+					SetThreshold( 0.5f, 0.1f );
+				}
+
+				ControlFunction& GetControl( )
+				{
+					return m_Control;
+				}
+
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				void SetThreshold( const float threshold, const float falloff )
+				{
+					const float width = ( falloff > 1e-4f ? falloff : 1e-4f ) * 2;
+					m_Lower = threshold - width * 0.5f;
+					m_InvWidth = 1 / width;
+				}
+
+				float GetValue( const float x, const float y, const float z ) const
+				{
+					const float t = ScalarSmoothStep( ScalarClamp( ( m_Control.GetValue( x, y, z ) - m_Lower ) * m_InvWidth, 0, 1 ) );
+					return ScalarBlend( t, m_First.GetValue( x, y, z ), m_Second.GetValue( x, y, z ) );
+				}
+
+				float GetSignedValue( const float x, const float y, const float z ) const
+				{
+					return GetValue( x, y, z ) * 2.0f - 1.0f;
+				}
+
+			private :
+
+				float			m_Lower;
+				float			m_InvWidth;
+				ControlFunction	m_Control;
+				FirstFunction	m_First;
+				SecondFunction	m_Second;
+		};
+
+		///	\brief	Scalar reference implementation of SseLatitudeBlendFunction
+		template < typename EquatorFunction, typename PoleFunction >
+		class ScalarLatitudeBlendFunction
+		{
+			public :
+
+				ScalarLatitudeBlendFunction( )
+				{
+					SetLatitudes( 0.6f, 0.8f );
+				}
+
+				EquatorFunction& GetEquator( )
+				{
+					return m_Equator;
+				}
+
+				PoleFunction& GetPole( )
+				{
+					return m_Pole;
+				}
+
+				void SetLatitudes( const float start, const float end )
+				{
+					m_Start = start;
+					m_InvRange = 1 / ( end - start );
+				}
+
+				float GetValue( const float x, const float y, const float z ) const
+				{
+					const float latitude = fabsf( y ) / ScalarGetLength( x, y, z );
+					const float t = ScalarSmoothStep( ScalarClamp( ( latitude - m_Start ) * m_InvRange, 0, 1 ) );
+					return ScalarBlend( t, m_Equator.GetValue( x, y, z ), m_Pole.GetValue( x, y, z ) );
+				}
+
+				float GetSignedValue( const float x, const float y, const float z ) const
+				{
+					return GetValue( x, y, z ) * 2.0f - 1.0f;
+				}
+
+			private :
+
+				float			m_Start;
+				float			m_InvRange;
+				EquatorFunction	m_Equator;
+				PoleFunction	m_Pole;
+		};
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
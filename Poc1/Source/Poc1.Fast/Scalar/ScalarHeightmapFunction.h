@@ -0,0 +1,152 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Scalar/ScalarSimpleFractal.h"
+#include "Scalar/ScalarUtils.h"
+#include "UHeightmapFile.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Scalar reference implementation of SseHeightmapFunction
+		///
+		///	Samples a heightmap file that is opened elsewhere (usually by the SseHeightmapFunction being checked).
+		///
+		class ScalarHeightmapFunction
+		{
+			public :
+
+				///	\brief	Sets up a function that samples a heightmap file, with no detail
+				ScalarHeightmapFunction( const UHeightmapFile& file, const bool bicubic );
+
+				///	\brief	Gets the detail fractal
+				ScalarSimpleFractal& GetDetail( );
+
+				///	\brief	Sets the amount of detail added to the heights
+				void SetDetailAmplitude( const float amplitude );
+
+				///	\brief	Gets a height from a point. Returns a value in the range [0,1], plus detail
+				float GetValue( const float x, const float y, const float z ) const;
+
+				///	\brief	Gets a height from a point, mapped to [-1,1]
+				float GetSignedValue( const float x, const float y, const float z ) const;
+
+			private :
+
+				const UHeightmapFile&	m_File;
+				ScalarSimpleFractal		m_Detail;
+				float					m_DetailAmplitude;
+				bool					m_Bicubic;
+
+				///	\brief	Samples the heightmap in the direction of a point
+				float Sample( const float x, const float y, const float z ) const;
+
+				///	\brief	Gets the Catmull-Rom weights of the 4 texels around a position t in [0,1] between the middle 2
+				static void GetCubicWeights( const float t, float* weights );
+
+				ScalarHeightmapFunction& operator = ( const ScalarHeightmapFunction& );
+		};
+
+		//	--------------------------------------------------- ScalarHeightmapFunction Inline Methods
+
+		inline ScalarHeightmapFunction::ScalarHeightmapFunction( const UHeightmapFile& file, const bool bicubic ) :
+			m_File( file ),
+			m_DetailAmplitude( 0 ),
+			m_Bicubic( bicubic )
+		{
+		}
+
+		inline ScalarSimpleFractal& ScalarHeightmapFunction::GetDetail( )
+		{
+			return m_Detail;
+		}
+
+		inline void ScalarHeightmapFunction::SetDetailAmplitude( const float amplitude )
+		{
+			m_DetailAmplitude = amplitude;
+		}
+
+		inline void ScalarHeightmapFunction::GetCubicWeights( const float t, float* weights )
+		{
+			const float t2 = t * t;
+			const float t3 = t2 * t;
+			weights[ 0 ] = ( ( t2 * 2.0f - t3 ) - t ) * 0.5f;
+			weights[ 1 ] = ( ( t3 * 3.0f - t2 * 5.0f ) + 2.0f ) * 0.5f;
+			weights[ 2 ] = ( ( t2 * 4.0f - t3 * 3.0f ) + t ) * 0.5f;
+			weights[ 3 ] = ( t3 - t2 ) * 0.5f;
+		}
+
+		inline float ScalarHeightmapFunction::Sample( const float x, const float y, const float z ) const
+		{
+			if ( !m_File.IsOpen( ) )
+			{
+				return 0;
+			}
+
+			UCubeMapFace face;
+			float u, v, major;
+			ScalarGetCubeFaceCoordinates( x, y, z, face, u, v, major );
+			u = u / major;
+			v = v / major;
+			if ( m_File.GetProjection( ) == ProjectionTangent )
+			{
+				u = ScalarInverseTangentCubeFaceCoordinate( u );
+				v = ScalarInverseTangentCubeFaceCoordinate( v );
+			}
+
+			const int maxTexel = m_File.GetResolution( ) - 1;
+			const float halfSize = float( maxTexel ) * 0.5f;
+			u = ScalarClamp( ( u + 1.0f ) * halfSize, 0, float( maxTexel ) );
+			v = ScalarClamp( ( v + 1.0f ) * halfSize, 0, float( maxTexel ) );
+			const float maxCell = float( maxTexel ) - 1.0f;
+			const float cellU = float( int( u ) ) < maxCell ? float( int( u ) ) : maxCell;
+			const float cellV = float( int( v ) ) < maxCell ? float( int( v ) ) : maxCell;
+			const int col = int( cellU );
+			const int row = int( cellV );
+			const float tU = u - cellU;
+			const float tV = v - cellV;
+
+			if ( !m_Bicubic )
+			{
+				const float top = ScalarLerp( tU, m_File.GetTexel( face, row, col ), m_File.GetTexel( face, row, col + 1 ) );
+				const float bottom = ScalarLerp( tU, m_File.GetTexel( face, row + 1, col ), m_File.GetTexel( face, row + 1, col + 1 ) );
+				return ScalarLerp( tV, top, bottom );
+			}
+
+			float uWeights[ 4 ], vWeights[ 4 ];
+			GetCubicWeights( tU, uWeights );
+			GetCubicWeights( tV, vWeights );
+			float result = 0;
+			for ( int j = 0; j < 4; ++j )
+			{
+				const int texelRow = row + j - 1 < 0 ? 0 : ( row + j - 1 > maxTexel ? maxTexel : row + j - 1 );
+				float line = 0;
+				for ( int i = 0; i < 4; ++i )
+				{
+					const int texelCol = col + i - 1 < 0 ? 0 : ( col + i - 1 > maxTexel ? maxTexel : col + i - 1 );
+					const float term = uWeights[ i ] * m_File.GetTexel( face, texelRow, texelCol );
+					line = ( i == 0 ) ? term : line + term;
+				}
+				result = ( j == 0 ) ? vWeights[ 0 ] * line : result + vWeights[ j ] * line;
+			}
+			return result;
+		}
+
+		inline float ScalarHeightmapFunction::GetValue( const float x, const float y, const float z ) const
+		{
+			const float height = Sample( x, y, z );
+			return m_DetailAmplitude == 0 ? height : height + m_Detail.GetSignedValue( x, y, z ) * m_DetailAmplitude;
+		}
+
+		inline float ScalarHeightmapFunction::GetSignedValue( const float x, const float y, const float z ) const
+		{
+			return GetValue( x, y, z ) * 2.0f - 1.0f;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,170 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Scalar/ScalarUtils.h"
+#include "Sse/SsePermutationTables.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Scalar reference implementation of SseNoise
+		///
+		///	Evaluates one point at a time, with plain float arithmetic, in the same order as SseNoise evaluates
+		///	each SSE lane. It uses the same shared permutation tables, so it produces the same noise field for
+		///	a given seed. This is not intended to be fast - it defines the expected output of the SSE noise
+		///	(see Poc1.Fast.Differential).
+		///
+		class ScalarNoise
+		{
+			public :
+
+				///	\brief	Initializes this noise object with a seed value of zero
+				ScalarNoise( );
+
+				///	\brief	Initializes this noise object with a supplied seed value
+				ScalarNoise( const unsigned int seed );
+
+				///	\brief	Sets a new seed value
+				void SetNewSeed( const unsigned int seed );
+
+				///	\brief	Generates a noise value, in the range -1..1. Reference for SseNoise::Noise()
+				float Noise( float x, float y, float z ) const;
+
+				///	\brief	Generates a noise value, in the range -1..1, from a periodic lattice. Reference for SseNoise::PeriodicNoise()
+				float PeriodicNoise( float x, float y, float z, const int periodX, const int periodY, const int originX, const int originY ) const;
+
+			private :
+
+				const SsePermutationTables::Entry* m_Perms;	///<	Shared permutation table (see SsePermutationTables)
+
+				///	\brief	Generates a permutation of an input value
+				int Perm( const int val ) const;
+
+				///	\brief	Blends the gradients at the corners of the lattice cell containing a point
+				float BlendCorners( int AA, int BA, int AB, int BB, const float x, const float y, const float z ) const;
+		};
+
+		//	--------------------------------------------------------------- ScalarNoise Inline Methods
+
+		inline ScalarNoise::ScalarNoise( ) :
+			m_Perms( SsePermutationTables::Get( 0 ) )
+		{
+		}
+
+		inline ScalarNoise::ScalarNoise( const unsigned int seed ) :
+			m_Perms( SsePermutationTables::Get( seed ) )
+		{
+		}
+
+		inline void ScalarNoise::SetNewSeed( const unsigned int seed )
+		{
+			m_Perms = SsePermutationTables::Get( seed );
+		}
+
+		inline int ScalarNoise::Perm( const int val ) const
+		{
+			return m_Perms[ val ];
+		}
+
+		inline float ScalarNoise::BlendCorners( int AA, int BA, int AB, int BB, const float x, const float y, const float z ) const
+		{
+			const float fade0 = ScalarFade( x );
+			const float fade1 = ScalarFade( y );
+			const float fade2 = ScalarFade( z );
+
+			const float lx = x - 1;
+			const float ly = y - 1;
+			const float lz = z - 1;
+
+			const int AA1 = Perm( AA + 1 );
+			const int BA1 = Perm( BA + 1 );
+			const int AB1 = Perm( AB + 1 );
+			const int BB1 = Perm( BB + 1 );
+			AA = Perm( AA );
+			BA = Perm( BA );
+			AB = Perm( AB );
+			BB = Perm( BB );
+
+			return
+				ScalarLerp
+				(
+					fade2,
+					ScalarLerp
+					(
+						fade1,
+						ScalarLerp( fade0, ScalarGrad( AA, x, y, z ), ScalarGrad( BA, lx, y, z ) ),
+						ScalarLerp( fade0, ScalarGrad( AB, x, ly, z ), ScalarGrad( BB, lx, ly, z ) )
+					),
+					ScalarLerp
+					(
+						fade1,
+						ScalarLerp( fade0, ScalarGrad( AA1, x, y, lz ), ScalarGrad( BA1, lx, y, lz ) ),
+						ScalarLerp( fade0, ScalarGrad( AB1, x, ly, lz ), ScalarGrad( BB1, lx, ly, lz ) )
+					)
+				);
+		}
+
+		inline float ScalarNoise::Noise( float x, float y, float z ) const
+		{
+			int ix = ScalarRoundToInt( x );
+			int iy = ScalarRoundToInt( y );
+			int iz = ScalarRoundToInt( z );
+
+			x -= float( ix );
+			y -= float( iy );
+			z -= float( iz );
+
+			ix &= 0xff;
+			iy &= 0xff;
+			iz &= 0xff;
+
+			//	Determine corner hash values
+			const int A = Perm( ix ) + iy;
+			const int AA = Perm( A ) + iz;
+			const int AB = Perm( A + 1 ) + iz;
+			const int B = Perm( ix + 1 ) + iy;
+			const int BA = Perm( B ) + iz;
+			const int BB = Perm( B + 1 ) + iz;
+
+			return BlendCorners( AA, BA, AB, BB, x, y, z ) / 0.888f;
+		}
+
+		inline float ScalarNoise::PeriodicNoise( float x, float y, float z, const int periodX, const int periodY, const int originX, const int originY ) const
+		{
+			int ix = ScalarRoundToInt( x );
+			int iy = ScalarRoundToInt( y );
+			int iz = ScalarRoundToInt( z );
+
+			x -= float( ix );
+			y -= float( iy );
+			z -= float( iz );
+
+			//	Wrap the cell corners at the period, before they are hashed
+			ix = ScalarWrapToPeriod( ix, periodX );
+			iy = ScalarWrapToPeriod( iy, periodY );
+			int ix1 = ScalarWrapToPeriod( ix + 1, periodX );
+			int iy1 = ScalarWrapToPeriod( iy + 1, periodY );
+
+			ix = ( ix + originX ) & 0xff;
+			ix1 = ( ix1 + originX ) & 0xff;
+			iy = ( iy + originY ) & 0xff;
+			iy1 = ( iy1 + originY ) & 0xff;
+			iz &= 0xff;
+
+			const int A = Perm( ix );
+			const int B = Perm( ix1 );
+			const int AA = Perm( A + iy ) + iz;
+			const int AB = Perm( A + iy1 ) + iz;
+			const int BA = Perm( B + iy ) + iz;
+			const int BB = Perm( B + iy1 ) + iz;
+
+			return BlendCorners( AA, BA, AB, BB, x, y, z ) / 0.888f;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,122 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Scalar/ScalarNoise.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Scalar reference implementation of SseRidgedFractal
+		class ScalarRidgedFractal
+		{
+			public :
+
+				///	\brief	Seed for the noise basis function is default (zero)
+				ScalarRidgedFractal( );
+
+				///	\brief	Sets the seed for the noise basis function
+				ScalarRidgedFractal( const unsigned int seed );
+
+				///	\brief	Gets the noise object
+				ScalarNoise& GetNoise( );
+
+				///	\brief	Gets the noise object
+				const ScalarNoise& GetNoise( ) const;
+
+				///	\brief	Sets up fractal parameters
+				void Setup( const float freq, const float gain, const int numOctaves );
+
+				///	\brief	Gets a fractal value from a point
+				float GetValue( float x, float y, float z ) const;
+
+				///	\brief	Gets a fractal value from a point
+				float GetSignedValue( const float x, const float y, const float z ) const;
+
+			private :
+
+				ScalarNoise	m_Noise;
+				float		m_Max;
+				float		m_Freq;
+				float		m_Gain;
+				int			m_NumOctaves;
+		};
+
+		//	------------------------------------------------------- ScalarRidgedFractal Inline Methods
+
+		inline ScalarRidgedFractal::ScalarRidgedFractal( )
+		{
+			Setup( 1.8f, 0.9f, 8 );
+		}
+
+		inline ScalarRidgedFractal::ScalarRidgedFractal( const unsigned int seed ) :
+			m_Noise( seed )
+		{
+			Setup( 1.8f, 0.9f, 8 );
+		}
+
+		inline ScalarNoise& ScalarRidgedFractal::GetNoise( )
+		{
+			return m_Noise;
+		}
+
+		inline const ScalarNoise& ScalarRidgedFractal::GetNoise( ) const
+		{
+			return m_Noise;
+		}
+
+		inline void ScalarRidgedFractal::Setup( const float freq, const float gain, const int numOctaves )
+		{
+			m_Freq = freq;
+			m_Gain = gain;
+			m_NumOctaves = numOctaves;
+
+			m_Max = 1;
+			float amp = 1;
+			for ( int octave = 0; octave < numOctaves; ++octave )
+			{
+				m_Max += 1 / amp;
+				amp *= m_Freq;
+			}
+		}
+
+		inline float ScalarRidgedFractal::GetValue( float x, float y, float z ) const
+		{
+			const float offset = 1;
+			float signal = offset - fabsf( m_Noise.Noise( x, y, z ) );
+			signal *= signal;
+			float result = signal;
+			float exp = 1;
+
+			for ( int octave = 1; octave < m_NumOctaves; ++octave )
+			{
+				x *= m_Freq;
+				y *= m_Freq;
+				z *= m_Freq;
+
+				//	Clamp the weight to [0,1]. NaNs become 0, as they do in SseRidgedFractal
+				float weight = signal * m_Gain;
+				weight = ( weight > 0 ) ? weight : 0;
+				weight = ( weight <= 1 ) ? weight : 1;
+
+				signal = offset - fabsf( m_Noise.Noise( x, y, z ) );
+				signal *= signal;
+				signal *= weight;
+				result += signal / exp;
+				exp *= m_Freq;
+			}
+
+			return result / m_Max;
+		}
+
+		inline float ScalarRidgedFractal::GetSignedValue( const float x, const float y, const float z ) const
+		{
+			return GetValue( x, y, z ) * 2 - 1;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
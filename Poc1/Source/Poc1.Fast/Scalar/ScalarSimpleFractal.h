@@ -0,0 +1,122 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Scalar/ScalarNoise.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Scalar reference implementation of SseSimpleFractal
+		class ScalarSimpleFractal
+		{
+			public :
+
+				///	\brief	Seed for the noise basis function is default (zero)
+				ScalarSimpleFractal( );
+
+				///	\brief	Sets the seed for the noise basis function
+				ScalarSimpleFractal( const unsigned int seed );
+
+				///	\brief	Gets the noise object
+				ScalarNoise& GetNoise( );
+
+				///	\brief	Gets the noise object
+				const ScalarNoise& GetNoise( ) const;
+
+				///	\brief	Sets up fractal parameters
+				void Setup( const float freq, const float persistence, const int numOctaves );
+
+				///	\brief	Gets a fractal value from a point. Returns a value in the range [0,1]
+				float GetValue( const float x, const float y, const float z ) const;
+
+				///	\brief	Gets a fractal value from a point. Returns a value in the range [-1,1]
+				float GetSignedValue( const float x, const float y, const float z ) const;
+
+			private :
+
+				ScalarNoise	m_Noise;
+				float		m_Max;
+				float		m_Freq;
+				float		m_Persistence;
+				int			m_NumOctaves;
+
+				///	\brief	Sums the octaves at a point
+				float GetTotal( float x, float y, float z ) const;
+		};
+
+		//	------------------------------------------------------- ScalarSimpleFractal Inline Methods
+
+		inline ScalarSimpleFractal::ScalarSimpleFractal( ) :
+			m_Max( 0 ),
+			m_Freq( 0 ),
+			m_Persistence( 0 ),
+			m_NumOctaves( 0 )
+		{
+		}
+
+		inline ScalarSimpleFractal::ScalarSimpleFractal( const unsigned int seed ) :
+			m_Noise( seed ),
+			m_Max( 0 ),
+			m_Freq( 0 ),
+			m_Persistence( 0 ),
+			m_NumOctaves( 0 )
+		{
+		}
+
+		inline ScalarNoise& ScalarSimpleFractal::GetNoise( )
+		{
+			return m_Noise;
+		}
+
+		inline const ScalarNoise& ScalarSimpleFractal::GetNoise( ) const
+		{
+			return m_Noise;
+		}
+
+		inline void ScalarSimpleFractal::Setup( const float freq, const float persistence, const int numOctaves )
+		{
+			m_Freq = freq;
+			m_Persistence = persistence;
+			m_NumOctaves = numOctaves;
+
+			m_Max = 0;
+			float amp = 1;
+			for ( int octave = 0; octave < numOctaves; ++octave )
+			{
+				m_Max += amp;
+				amp *= m_Persistence;
+			}
+		}
+
+		inline float ScalarSimpleFractal::GetTotal( float x, float y, float z ) const
+		{
+			float total = 0;
+			float amp = 1;
+			for ( int octave = 0; octave < m_NumOctaves; ++octave )
+			{
+				total += m_Noise.Noise( x, y, z ) * amp;
+				amp *= m_Persistence;
+				x *= m_Freq;
+				y *= m_Freq;
+				z *= m_Freq;
+			}
+			return total;
+		}
+
+		inline float ScalarSimpleFractal::GetValue( const float x, const float y, const float z ) const
+		{
+			return ( GetTotal( x, y, z ) + m_Max ) / ( m_Max * 2 );
+		}
+
+		inline float ScalarSimpleFractal::GetSignedValue( const float x, const float y, const float z ) const
+		{
+			return GetTotal( x, y, z ) / m_Max;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,203 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UEnums.h"
+
+#include <math.h>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Returns the negative of a value (as 0 - val, like Neg() in SseUtils.h)
+		inline float ScalarNeg( const float val )
+		{
+			return 0.0f - val;
+		}
+
+		///	\brief	Clamps a value, in the same way as Clamp() in SseUtils.h (NaN values are clamped to max)
+		inline float ScalarClamp( const float val, const float min, const float max )
+		{
+			const float upper = val < max ? val : max;
+			return upper > min ? upper : min;
+		}
+
+		///	\brief	Gets the position on a cube map face
+		inline void ScalarCubeFacePosition( const UCubeMapFace face, const float u, const float v, float& x, float& y, float& z )
+		{
+			switch ( face )
+			{
+				default:
+				case NegativeX	: x = -1;				y = v;		z = u;				break;
+				case PositiveX	: x = 1;				y = v;		z = ScalarNeg( u );	break;
+				case NegativeY	: x = ScalarNeg( u );	y = -1;		z = ScalarNeg( v );	break;
+				case PositiveY	: x = ScalarNeg( u );	y = 1;		z = v;				break;
+				case NegativeZ	: x = ScalarNeg( u );	y = v;		z = -1;				break;
+				case PositiveZ	: x = u;				y = v;		z = 1;				break;
+			}
+		}
+
+		///	\brief	Evaluates an odd polynomial at a value, in the same order as OddPolynomial() in SseUtils.h
+		inline float ScalarOddPolynomial( const float t, const float* coefficients, const int count )
+		{
+			const float t2 = t * t;
+			float res = coefficients[ count - 1 ];
+			for ( int power = count - 2; power >= 0; --power )
+			{
+				res = res * t2 + coefficients[ power ];
+			}
+			return t * res;
+		}
+
+		///	\brief	Maps a tangent-adjusted face coordinate to a position on a cube face (TangentCubeFaceCoordinate() in SseUtils.h)
+		inline float ScalarTangentCubeFaceCoordinate( const float t )
+		{
+			static const float Coefficients[ 6 ] = { 0.785396874f, 0.161528096f, 0.0395636559f, 0.0108593898f, 0.00110479607f, 0.00154716952f };
+			return ScalarOddPolynomial( t, Coefficients, 6 );
+		}
+
+		///	\brief	Maps a position on a cube face to a tangent-adjusted face coordinate (InverseTangentCubeFaceCoordinate() in SseUtils.h)
+		inline float ScalarInverseTangentCubeFaceCoordinate( const float p )
+		{
+			static const float Coefficients[ 8 ] = { 1.27323878f, -0.424368978f, 0.253967494f, -0.177089885f, 0.122767568f, -0.0711888671f, 0.0278361719f, -0.00516227214f };
+			return ScalarOddPolynomial( p, Coefficients, 8 );
+		}
+
+		///	\brief	Gets the position on a cube map face, from face coordinates in a given projection
+		inline void ScalarCubeFacePosition( const UCubeMapFace face, const UCubeMapProjection projection, const float u, const float v, float& x, float& y, float& z )
+		{
+			if ( projection == ProjectionTangent )
+			{
+				ScalarCubeFacePosition( face, ScalarTangentCubeFaceCoordinate( u ), ScalarTangentCubeFaceCoordinate( v ), x, y, z );
+				return;
+			}
+			ScalarCubeFacePosition( face, u, v, x, y, z );
+		}
+
+		///	\brief	Gets the cube map face that a direction points at, in the same way as GetCubeFaceCoordinates() in SseUtils.h
+		inline void ScalarGetCubeFaceCoordinates( const float x, const float y, const float z, UCubeMapFace& face, float& u, float& v, float& major )
+		{
+			const float absX = fabsf( x );
+			const float absY = fabsf( y );
+			const float absZ = fabsf( z );
+			if ( ( absX >= absY ) && ( absX >= absZ ) )
+			{
+				face = x < 0 ? NegativeX : PositiveX;
+				u = x < 0 ? z : ScalarNeg( z );
+				v = y;
+				major = absX;
+			}
+			else if ( absY >= absZ )
+			{
+				face = y < 0 ? NegativeY : PositiveY;
+				u = ScalarNeg( x );
+				v = y < 0 ? ScalarNeg( z ) : z;
+				major = absY;
+			}
+			else
+			{
+				face = z < 0 ? NegativeZ : PositiveZ;
+				u = z < 0 ? ScalarNeg( x ) : x;
+				v = y;
+				major = absZ;
+			}
+		}
+
+		///	\brief	Rounds a value to an integer, in the same way as RoundToInt() in SseUtils.h
+		///
+		///	RoundToInt() converts v - 0.5 using the default SSE rounding mode (round half to even), so this
+		///	does the same, rather than using floorf().
+		///
+		inline int ScalarRoundToInt( const float v )
+		{
+			const float shifted = v - 0.5f;
+			const float lower = floorf( shifted );
+			const float fraction = shifted - lower;
+			int result = int( lower );
+			if ( ( fraction > 0.5f ) || ( ( fraction == 0.5f ) && ( ( result & 1 ) != 0 ) ) )
+			{
+				++result;
+			}
+			return result;
+		}
+
+		///	\brief	Wraps an integer in the range [-period,2*period) into the range [0,period)
+		inline int ScalarWrapToPeriod( int i, const int period )
+		{
+			i = ( i < 0 ) ? ( i + period ) : i;
+			return ( i < period ) ? i : ( i - period );
+		}
+
+		///	\brief	Sets the length of a vector
+		inline void ScalarSetLength( float& x, float& y, float& z, const float len )
+		{
+			const float scale = len / sqrtf( x * x + ( y * y + z * z ) );
+			x *= scale;
+			y *= scale;
+			z *= scale;
+		}
+
+		///	\brief	Gets the length of a vector
+		inline float ScalarGetLength( const float x, const float y, const float z )
+		{
+			return sqrtf( x * x + ( y * y + z * z ) );
+		}
+
+		///	\brief	Calculates the dot product of 2 vectors
+		inline float ScalarDot( const float x0, const float y0, const float z0, const float x1, const float y1, const float z1 )
+		{
+			return x0 * x1 + ( y0 * y1 + z0 * z1 );
+		}
+
+		///	\brief	Gets the cross product of 2 vectors
+		inline void ScalarGetCrossProduct( float& cpX, float& cpY, float& cpZ, const float x0, const float y0, const float z0, const float x1, const float y1, const float z1 )
+		{
+			cpX = y0 * z1 - z0 * y1;
+			cpY = z0 * x1 - x0 * z1;
+			cpZ = x0 * y1 - y0 * x1;
+		}
+
+		///	\brief	Gets the cross product of 2 vectors, and adds it to cp-
+		inline void ScalarAccumulateCrossProduct( float& cpX, float& cpY, float& cpZ, const float x0, const float y0, const float z0, const float x1, const float y1, const float z1 )
+		{
+			cpX = cpX + ( y0 * z1 - z0 * y1 );
+			cpY = cpY + ( z0 * x1 - x0 * z1 );
+			cpZ = cpZ + ( x0 * y1 - y0 * x1 );
+		}
+
+		///	\brief	Fades a value (6v5-15v4+10v3)
+		inline float ScalarFade( const float v )
+		{
+			const float v3 = v * ( v * v );
+			const float res = ( v * 6 - 15 ) * v + 10;
+			return res * v3;
+		}
+
+		///	\brief	Linearly interpolates between 2 values
+		inline float ScalarLerp( const float t, const float a, const float b )
+		{
+			return a + ( b - a ) * t;
+		}
+
+		///	\brief	Smooths a value in the range [0,1], in the same way as SmoothStep() in SseUtils.h
+		inline float ScalarSmoothStep( const float t )
+		{
+			return ( t * t ) * ( 3.0f - t * 2.0f );
+		}
+
+		///	\brief	Noise utility function: Returns the gradient for a given hash value
+		///
+		///	Ken Perlin's Improved Noise gradient function: http://mrl.nyu.edu/~perlin/noise/
+		///
+		inline float ScalarGrad( int h, const float x, const float y, const float z )
+		{
+			h &= 15;
+			const float u = h < 8 ? x : y;
+			const float v = h < 4 ? y : ( ( h == 12 ) || ( h == 14 ) ? x : z );
+			return ( ( h & 1 ) == 0 ? u : ScalarNeg( u ) ) + ( ( h & 2 ) == 0 ? v : ScalarNeg( v ) );
+		}
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include "BulkEvaluator.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		void BulkEvaluator::Evaluate( SseBulkFunction function, const void* impl, array< float >^ x, array< float >^ y, array< float >^ z, array< float >^ results, const int numThreads )
+		{
+			if ( ( x == nullptr ) || ( y == nullptr ) || ( z == nullptr ) )
+			{
+				throw gcnew System::ArgumentNullException( "Point arrays cannot be null" );
+			}
+			if ( results == nullptr )
+			{
+				throw gcnew System::ArgumentNullException( "results" );
+			}
+			const int count = x->Length;
+			if ( ( y->Length != count ) || ( z->Length != count ) )
+			{
+				throw gcnew System::ArgumentException( "Point arrays must be the same length" );
+			}
+			if ( results->Length < count )
+			{
+				throw gcnew System::ArgumentException( "Results array is too small", "results" );
+			}
+			if ( count == 0 )
+			{
+				return;
+			}
+
+			pin_ptr< float > pinnedX = &x[ 0 ];
+			pin_ptr< float > pinnedY = &y[ 0 ];
+			pin_ptr< float > pinnedZ = &z[ 0 ];
+			pin_ptr< float > pinnedResults = &results[ 0 ];
+
+			SseBulkPoints points;
+			points.m_X = pinnedX;
+			points.m_Y = pinnedY;
+			points.m_Z = pinnedZ;
+			points.m_Packed = false;
+
+			Evaluate( function, impl, points, pinnedResults, count, numThreads );
+		}
+
+		void BulkEvaluator::Evaluate( SseBulkFunction function, const void* impl, array< float >^ points, array< float >^ results, const int numThreads )
+		{
+			if ( points == nullptr )
+			{
+				throw gcnew System::ArgumentNullException( "points" );
+			}
+			if ( results == nullptr )
+			{
+				throw gcnew System::ArgumentNullException( "results" );
+			}
+			if ( ( points->Length % 3 ) != 0 )
+			{
+				throw gcnew System::ArgumentException( "Point array must contain xyz triples", "points" );
+			}
+			const int count = points->Length / 3;
+			if ( results->Length < count )
+			{
+				throw gcnew System::ArgumentException( "Results array is too small", "results" );
+			}
+			if ( count == 0 )
+			{
+				return;
+			}
+
+			pin_ptr< float > pinnedPoints = &points[ 0 ];
+			pin_ptr< float > pinnedResults = &results[ 0 ];
+
+			SseBulkPoints packedPoints;
+			packedPoints.m_X = pinnedPoints;
+			packedPoints.m_Y = 0;
+			packedPoints.m_Z = 0;
+			packedPoints.m_Packed = true;
+
+			Evaluate( function, impl, packedPoints, pinnedResults, count, numThreads );
+		}
+
+		void BulkEvaluator::Evaluate( SseBulkFunction function, const void* impl, const SseBulkPoints& points, float* results, const int count, const int numThreads )
+		{
+			int threads = count / MinPointsPerThread;
+			threads = ( threads < numThreads ) ? threads : numThreads;
+			if ( threads <= 1 )
+			{
+				function( impl, points, results, 0, count );
+				return;
+			}
+
+			//	Partitions are multiples of 4 points. The calling thread takes the last partition
+			const int pointsPerThread = ( ( count / threads ) + 3 ) & ~3;
+			array< System::Threading::Thread^ >^ workers = gcnew array< System::Threading::Thread^ >( threads - 1 );
+			int start = 0;
+			for ( int worker = 0; worker < workers->Length; ++worker, start += pointsPerThread )
+			{
+				BulkEvaluator^ partition = gcnew BulkEvaluator( function, impl, points, results, start, pointsPerThread );
+				workers[ worker ] = gcnew System::Threading::Thread( gcnew System::Threading::ThreadStart( partition, &BulkEvaluator::Run ) );
+				workers[ worker ]->Start( );
+			}
+
+			function( impl, points, results, start, count - start );
+
+			for ( int worker = 0; worker < workers->Length; ++worker )
+			{
+				workers[ worker ]->Join( );
+			}
+		}
+
+		BulkEvaluator::BulkEvaluator( SseBulkFunction function, const void* impl, const SseBulkPoints& points, float* results, const int start, const int count ) :
+			m_Function( function ),
+			m_Impl( impl ),
+			m_X( points.m_X ),
+			m_Y( points.m_Y ),
+			m_Z( points.m_Z ),
+			m_Packed( points.m_Packed ),
+			m_Results( results ),
+			m_Start( start ),
+			m_Count( count )
+		{
+		}
+
+		void BulkEvaluator::Run( )
+		{
+			SseBulkPoints points;
+			points.m_X = m_X;
+			points.m_Y = m_Y;
+			points.m_Z = m_Z;
+			points.m_Packed = m_Packed;
+			m_Function( m_Impl, points, m_Results, m_Start, m_Count );
+		}
+
+	};
+};
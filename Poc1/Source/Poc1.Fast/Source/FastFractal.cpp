@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "FastFractal.h"
+#include "Mem.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		FastFractal::FastFractal( FastFractalType type ) :
+			m_Type( type ),
+			m_Threads( 1 )
+		{
+			Create( 0 );
+		}
+
+		FastFractal::FastFractal( FastFractalType type, unsigned int seed ) :
+			m_Type( type ),
+			m_Threads( 1 )
+		{
+			Create( seed );
+		}
+
+		FastFractal::!FastFractal( )
+		{
+			Destroy( );
+		}
+
+		FastFractal::~FastFractal( )
+		{
+			Destroy( );
+		}
+
+		void FastFractal::Setup( float frequency, float persistence, int octaves )
+		{
+			if ( octaves < 1 )
+			{
+				throw gcnew System::ArgumentOutOfRangeException( "octaves" );
+			}
+			switch ( m_Type )
+			{
+				case FastFractalType::Simple	: ( ( SseSimpleFractal* )m_pImpl )->Setup( frequency, persistence, octaves ); break;
+				case FastFractalType::Ridged	: ( ( SseRidgedFractal* )m_pImpl )->Setup( frequency, persistence, octaves ); break;
+			}
+		}
+
+		void FastFractal::Create( unsigned int seed )
+		{
+			switch ( m_Type )
+			{
+				case FastFractalType::Simple	:
+				{
+					SseSimpleFractal* fractal = new ( Aligned( 16 ) ) SseSimpleFractal( seed );
+					fractal->Setup( 2.0f, 0.5f, 8 );
+					m_pImpl = fractal;
+					m_BulkFunction = &SseBulkEvaluateFunction< SseSimpleFractal >;
+					break;
+				}
+				case FastFractalType::Ridged	:
+				{
+					m_pImpl = new ( Aligned( 16 ) ) SseRidgedFractal( seed );
+					m_BulkFunction = &SseBulkEvaluateFunction< SseRidgedFractal >;
+					break;
+				}
+				default :
+					throw gcnew System::ArgumentOutOfRangeException( "type" );
+			}
+		}
+
+		void FastFractal::Destroy( )
+		{
+			switch ( m_Type )
+			{
+				case FastFractalType::Simple	: AlignedDelete( ( SseSimpleFractal* )m_pImpl ); break;
+				case FastFractalType::Ridged	: AlignedDelete( ( SseRidgedFractal* )m_pImpl ); break;
+			}
+			m_pImpl = 0;
+		}
+	};
+};
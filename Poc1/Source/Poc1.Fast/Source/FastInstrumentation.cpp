@@ -0,0 +1,20 @@
+#include "stdafx.h"
+#include "FastInstrumentation.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		FastInstrumentationSnapshot FastInstrumentation::GetSnapshot( )
+		{
+			long long counters[ NumInstrumentationCounters ];
+			Instrumentation::GetSnapshot( counters );
+			return FastInstrumentationSnapshot( counters, 1.0 / double( Instrumentation::GetTicksPerSecond( ) ) );
+		}
+
+		void FastInstrumentation::Reset( )
+		{
+			Instrumentation::Reset( );
+		}
+	};
+};
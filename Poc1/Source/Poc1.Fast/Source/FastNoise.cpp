@@ -6,12 +6,14 @@ namespace Poc1
 {
 	namespace Fast
 	{
-		FastNoise::FastNoise( )
+		FastNoise::FastNoise( ) :
+			m_Threads( 1 )
 		{
 			m_pImpl = new ( Aligned( 16 ) ) SseNoise;
 		}
 
-		FastNoise::FastNoise( unsigned int seed )
+		FastNoise::FastNoise( unsigned int seed ) :
+			m_Threads( 1 )
 		{
 			m_pImpl = new ( Aligned( 16 ) ) SseNoise( seed );
 		}
@@ -0,0 +1,28 @@
+#include "stdafx.h"
+#include "FastTrace.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		void FastTrace::Clear( )
+		{
+			Trace::Clear( );
+		}
+
+		void FastTrace::Write( System::String^ path )
+		{
+			if ( path == nullptr )
+			{
+				throw gcnew System::ArgumentNullException( "path" );
+			}
+			System::IntPtr ansiPath = System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi( path );
+			bool written = Trace::WriteChromeTrace( ( const char* )ansiPath.ToPointer( ) );
+			System::Runtime::InteropServices::Marshal::FreeHGlobal( ansiPath );
+			if ( !written )
+			{
+				throw gcnew System::IO::IOException( System::String::Format( "Failed to write trace to \"{0}\"", path ) );
+			}
+		}
+	};
+};
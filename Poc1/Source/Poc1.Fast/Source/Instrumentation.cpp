@@ -0,0 +1,124 @@
+#include "Stdafx.h"
+#include "Instrumentation.h"
+#include "Mem.h"
+#include "Platform.h"
+
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Counter block for a single thread. Cache line aligned, so threads never share a line
+		struct FAST_ALIGN( 64 ) ThreadCounters
+		{
+			long long		m_Counters[ NumInstrumentationCounters ];
+			ThreadCounters*	m_Next;
+		};
+
+		///	\brief	Head of the list of all thread counter blocks. Blocks outlive their threads, so totals are kept
+		static ThreadCounters* s_Threads = 0;
+
+		///	\brief	TLS slot storing the calling thread's counter block
+		static Platform::ThreadLocalSlot s_TlsIndex = Platform::NoThreadLocalSlot;
+
+		///	\brief	Thread list lock. Zero-initialized, so it can be used before any dynamic initializers run
+		static volatile long s_ThreadsLock = 0;
+
+		///	\brief	Scoped spin lock around s_ThreadsLock
+		///
+		///	Only taken when a thread first updates a counter, and when counters are aggregated or reset.
+		///
+		class ThreadsLock
+		{
+			public :
+
+				ThreadsLock( )
+				{
+					while ( Platform::AtomicExchange( &s_ThreadsLock, 1 ) != 0 )
+					{
+						Platform::YieldThread( );
+					}
+				}
+
+				~ThreadsLock( )
+				{
+					Platform::AtomicExchange( &s_ThreadsLock, 0 );
+				}
+		};
+
+		///	\brief	Gets the calling thread's counter block, creating it if necessary
+		static ThreadCounters* GetThreadCounters( )
+		{
+			if ( s_TlsIndex != Platform::NoThreadLocalSlot )
+			{
+				ThreadCounters* counters = ( ThreadCounters* )Platform::GetThreadLocal( s_TlsIndex );
+				if ( counters != 0 )
+				{
+					return counters;
+				}
+			}
+
+			ThreadsLock lock;
+			if ( s_TlsIndex == Platform::NoThreadLocalSlot )
+			{
+				s_TlsIndex = Platform::AllocateThreadLocalSlot( );
+			}
+
+			//	NOTE: AP: Not allocated with aligned new, because that would count as an aligned allocation
+			ThreadCounters* counters = ( ThreadCounters* )AlignedAlloc( sizeof( ThreadCounters ), 64 );
+			memset( counters, 0, sizeof( ThreadCounters ) );
+			counters->m_Next = s_Threads;
+			s_Threads = counters;
+
+			Platform::SetThreadLocal( s_TlsIndex, counters );
+			return counters;
+		}
+
+		bool Instrumentation::IsEnabled( )
+		{
+			return POC1_FAST_INSTRUMENTATION != 0;
+		}
+
+		void Instrumentation::Add( const UInstrumentationCounter counter, const long long value )
+		{
+			GetThreadCounters( )->m_Counters[ counter ] += value;
+		}
+
+		void Instrumentation::GetSnapshot( long long* counters )
+		{
+			memset( counters, 0, sizeof( long long ) * NumInstrumentationCounters );
+
+			ThreadsLock lock;
+			for ( const ThreadCounters* thread = s_Threads; thread != 0; thread = thread->m_Next )
+			{
+				for ( int counter = 0; counter < NumInstrumentationCounters; ++counter )
+				{
+					counters[ counter ] += thread->m_Counters[ counter ];
+				}
+			}
+		}
+
+		void Instrumentation::Reset( )
+		{
+			ThreadsLock lock;
+			for ( ThreadCounters* thread = s_Threads; thread != 0; thread = thread->m_Next )
+			{
+				memset( thread->m_Counters, 0, sizeof( thread->m_Counters ) );
+			}
+		}
+
+		long long Instrumentation::GetTicks( )
+		{
+			return Platform::GetTicks( );
+		}
+
+		long long Instrumentation::GetTicksPerSecond( )
+		{
+			return Platform::GetTicksPerSecond( );
+		}
+
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,277 @@
+#include "Stdafx.h"
+#include "Platform.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		namespace Platform
+		{
+		#ifdef _WIN32
+
+			long AtomicExchange( volatile long* target, const long value )
+			{
+				return InterlockedExchange( target, value );
+			}
+
+			long AtomicIncrement( volatile long* target )
+			{
+				return InterlockedIncrement( target );
+			}
+
+			void YieldThread( )
+			{
+				Sleep( 0 );
+			}
+
+			ThreadLocalSlot AllocateThreadLocalSlot( )
+			{
+				return TlsAlloc( );
+			}
+
+			void* GetThreadLocal( const ThreadLocalSlot slot )
+			{
+				return TlsGetValue( slot );
+			}
+
+			void SetThreadLocal( const ThreadLocalSlot slot, void* value )
+			{
+				TlsSetValue( slot, value );
+			}
+
+			long long GetTicks( )
+			{
+				LARGE_INTEGER ticks;
+				QueryPerformanceCounter( &ticks );
+				return ticks.QuadPart;
+			}
+
+			long long GetTicksPerSecond( )
+			{
+				LARGE_INTEGER frequency;
+				QueryPerformanceFrequency( &frequency );
+				return frequency.QuadPart;
+			}
+
+			unsigned long GetThreadId( )
+			{
+				return GetCurrentThreadId( );
+			}
+
+			unsigned long GetProcessId( )
+			{
+				return GetCurrentProcessId( );
+			}
+
+			bool OpenMappedFile( const char* path, MappedFile& file )
+			{
+				file.m_Size = 0;
+				file.m_Handle = 0;
+
+				HANDLE fileHandle = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, 0 );
+				if ( fileHandle == INVALID_HANDLE_VALUE )
+				{
+					return false;
+				}
+				LARGE_INTEGER size;
+				HANDLE mapping = 0;
+				if ( GetFileSizeEx( fileHandle, &size ) && ( size.QuadPart > 0 ) )
+				{
+					mapping = CreateFileMappingA( fileHandle, 0, PAGE_READONLY, 0, 0, 0 );
+				}
+
+				//	The mapping keeps the file open
+				CloseHandle( fileHandle );
+				if ( mapping == 0 )
+				{
+					return false;
+				}
+				file.m_Size = size.QuadPart;
+				file.m_Handle = mapping;
+				return true;
+			}
+
+			void CloseMappedFile( MappedFile& file )
+			{
+				if ( file.m_Handle != 0 )
+				{
+					CloseHandle( ( HANDLE )file.m_Handle );
+				}
+				file.m_Size = 0;
+				file.m_Handle = 0;
+			}
+
+			long long GetViewAlignment( )
+			{
+				SYSTEM_INFO info;
+				GetSystemInfo( &info );
+				return info.dwAllocationGranularity;
+			}
+
+			const unsigned char* MapView( const MappedFile& file, const long long offset, const long long size )
+			{
+				const DWORD offsetHigh = DWORD( ( unsigned long long )offset >> 32 );
+				const DWORD offsetLow = DWORD( offset & 0xffffffff );
+				return ( const unsigned char* )MapViewOfFile( ( HANDLE )file.m_Handle, FILE_MAP_READ, offsetHigh, offsetLow, SIZE_T( size ) );
+			}
+
+			void UnmapView( const unsigned char* view, const long long )
+			{
+				UnmapViewOfFile( view );
+			}
+
+			void PrefetchView( const unsigned char*, const long long, const long long )
+			{
+				//	PrefetchVirtualMemory() needs Windows 8, so pages are read when they are first touched
+			}
+
+		#else
+
+			long AtomicExchange( volatile long* target, const long value )
+			{
+				//	__sync_lock_test_and_set() is only an acquire barrier, so add the release half explicitly
+				__sync_synchronize( );
+				return __sync_lock_test_and_set( target, value );
+			}
+
+			long AtomicIncrement( volatile long* target )
+			{
+				return __sync_add_and_fetch( target, 1 );
+			}
+
+			void YieldThread( )
+			{
+				sched_yield( );
+			}
+
+			ThreadLocalSlot AllocateThreadLocalSlot( )
+			{
+				pthread_key_t key;
+				return ( pthread_key_create( &key, 0 ) == 0 ) ? ThreadLocalSlot( key ) : NoThreadLocalSlot;
+			}
+
+			void* GetThreadLocal( const ThreadLocalSlot slot )
+			{
+				return pthread_getspecific( pthread_key_t( slot ) );
+			}
+
+			void SetThreadLocal( const ThreadLocalSlot slot, void* value )
+			{
+				pthread_setspecific( pthread_key_t( slot ), value );
+			}
+
+			long long GetTicks( )
+			{
+				timespec now;
+				clock_gettime( CLOCK_MONOTONIC, &now );
+				return ( long long )now.tv_sec * 1000000000LL + now.tv_nsec;
+			}
+
+			long long GetTicksPerSecond( )
+			{
+				return 1000000000LL;
+			}
+
+			unsigned long GetThreadId( )
+			{
+			#ifdef __linux__
+				return ( unsigned long )syscall( SYS_gettid );
+			#else
+				return ( unsigned long )pthread_self( );
+			#endif
+			}
+
+			unsigned long GetProcessId( )
+			{
+				return ( unsigned long )getpid( );
+			}
+
+			bool OpenMappedFile( const char* path, MappedFile& file )
+			{
+				file.m_Size = 0;
+				file.m_Handle = 0;
+
+				const int descriptor = open( path, O_RDONLY );
+				if ( descriptor < 0 )
+				{
+					return false;
+				}
+				struct stat status;
+				if ( ( fstat( descriptor, &status ) != 0 ) || ( status.st_size <= 0 ) )
+				{
+					close( descriptor );
+					return false;
+				}
+				file.m_Size = status.st_size;
+				file.m_Handle = ( void* )( size_t )descriptor;
+				return true;
+			}
+
+			void CloseMappedFile( MappedFile& file )
+			{
+				if ( file.m_Size > 0 )
+				{
+					close( int( ( size_t )file.m_Handle ) );
+				}
+				file.m_Size = 0;
+				file.m_Handle = 0;
+			}
+
+			long long GetViewAlignment( )
+			{
+				return sysconf( _SC_PAGESIZE );
+			}
+
+			const unsigned char* MapView( const MappedFile& file, const long long offset, const long long size )
+			{
+				void* view = mmap( 0, size_t( size ), PROT_READ, MAP_SHARED, int( ( size_t )file.m_Handle ), off_t( offset ) );
+				if ( view == MAP_FAILED )
+				{
+					return 0;
+				}
+
+				//	Mapped files are read a tile (or a block) at a time, in no particular order, so read-around doesn't help
+				madvise( view, size_t( size ), MADV_RANDOM );
+				return ( const unsigned char* )view;
+			}
+
+			void UnmapView( const unsigned char* view, const long long size )
+			{
+				munmap( ( void* )view, size_t( size ) );
+			}
+
+			void PrefetchView( const unsigned char* view, const long long offset, const long long size )
+			{
+				if ( size <= 0 )
+				{
+					return;
+				}
+
+				//	madvise() needs a page aligned start
+				const long long pageSize = sysconf( _SC_PAGESIZE );
+				const long long start = offset - ( offset % pageSize );
+				madvise( ( void* )( view + start ), size_t( offset + size - start ), MADV_WILLNEED );
+			}
+
+		#endif
+
+		}; //Platform
+	}; //Fast
+}; //Poc1
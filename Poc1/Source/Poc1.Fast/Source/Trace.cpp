@@ -0,0 +1,238 @@
+#include "Stdafx.h"
+#include "Trace.h"
+#include "Mem.h"
+#include "Platform.h"
+
+#include <stdio.h>
+#include <vector>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Span names of each trace phase
+		static const char* const PhaseNames[ NumTracePhases ] =
+		{
+			"CacheFill",
+			"Displacement",
+			"Normals",
+			"Store"
+		};
+
+		//	----------------------------------------------------------------- TracePhases Methods
+
+		TracePhases::~TracePhases( )
+		{
+			if ( m_Start < 0 )
+			{
+				return;
+			}
+			EndPhase( Instrumentation::GetTicks( ) );
+
+			long long start = m_Start;
+			for ( int phase = 0; phase < NumTracePhases; ++phase )
+			{
+				if ( m_Entries[ phase ] > 0 )
+				{
+					Trace::AddSpan( PhaseNames[ phase ], start, start + m_Ticks[ phase ], m_Entries[ phase ] );
+					start += m_Ticks[ phase ];
+				}
+			}
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+		///	\brief	Recorded span
+		struct TraceSpan
+		{
+			const char*	m_Name;
+			long long	m_Start;
+			long long	m_End;
+			int			m_Arg;
+		};
+
+		///	\brief	Ring buffer of spans for a single thread
+		///
+		///	Only the owning thread writes to m_Spans and m_Count. m_Count is the total number of spans ever
+		///	written, and m_ClearedCount is the value of m_Count when Trace::Clear() was last called.
+		///
+		struct FAST_ALIGN( 64 ) ThreadTrace
+		{
+			TraceSpan		m_Spans[ Trace::RingSize ];
+			volatile long	m_Count;
+			volatile long	m_ClearedCount;
+			unsigned long	m_ThreadId;
+			ThreadTrace*	m_Next;
+		};
+
+		///	\brief	Head of the list of all thread ring buffers. Buffers outlive their threads, so spans are kept
+		static ThreadTrace* s_Threads = 0;
+
+		///	\brief	TLS slot storing the calling thread's ring buffer
+		static Platform::ThreadLocalSlot s_TlsIndex = Platform::NoThreadLocalSlot;
+
+		///	\brief	Recording flag
+		static volatile bool s_Recording = false;
+
+		///	\brief	Thread list lock. Zero-initialized, so it can be used before any dynamic initializers run
+		static volatile long s_ThreadsLock = 0;
+
+		///	\brief	Scoped spin lock around s_ThreadsLock
+		///
+		///	Only taken when a thread first records a span, and when spans are cleared or written out.
+		///
+		class TraceLock
+		{
+			public :
+
+				TraceLock( )
+				{
+					while ( Platform::AtomicExchange( &s_ThreadsLock, 1 ) != 0 )
+					{
+						Platform::YieldThread( );
+					}
+				}
+
+				~TraceLock( )
+				{
+					Platform::AtomicExchange( &s_ThreadsLock, 0 );
+				}
+		};
+
+		///	\brief	Gets the calling thread's ring buffer, creating it if necessary
+		static ThreadTrace* GetThreadTrace( )
+		{
+			if ( s_TlsIndex != Platform::NoThreadLocalSlot )
+			{
+				ThreadTrace* trace = ( ThreadTrace* )Platform::GetThreadLocal( s_TlsIndex );
+				if ( trace != 0 )
+				{
+					return trace;
+				}
+			}
+
+			TraceLock lock;
+			if ( s_TlsIndex == Platform::NoThreadLocalSlot )
+			{
+				s_TlsIndex = Platform::AllocateThreadLocalSlot( );
+			}
+
+			ThreadTrace* trace = ( ThreadTrace* )AlignedAlloc( sizeof( ThreadTrace ), 64 );
+			trace->m_Count = 0;
+			trace->m_ClearedCount = 0;
+			trace->m_ThreadId = Platform::GetThreadId( );
+			trace->m_Next = s_Threads;
+			s_Threads = trace;
+
+			Platform::SetThreadLocal( s_TlsIndex, trace );
+			return trace;
+		}
+
+		void Trace::SetRecording( const bool recording )
+		{
+			s_Recording = recording;
+		}
+
+		bool Trace::IsRecording( )
+		{
+			return s_Recording;
+		}
+
+		void Trace::AddSpan( const char* name, const long long startTicks, const long long endTicks, const int arg )
+		{
+			ThreadTrace* trace = GetThreadTrace( );
+			const long count = trace->m_Count;
+			TraceSpan& span = trace->m_Spans[ count & ( RingSize - 1 ) ];
+			span.m_Name = name;
+			span.m_Start = startTicks;
+			span.m_End = endTicks;
+			span.m_Arg = arg;
+
+			//	Publish the span after it has been written (AtomicExchange() is a full barrier)
+			Platform::AtomicExchange( &trace->m_Count, count + 1 );
+		}
+
+		void Trace::Clear( )
+		{
+			TraceLock lock;
+			for ( ThreadTrace* trace = s_Threads; trace != 0; trace = trace->m_Next )
+			{
+				trace->m_ClearedCount = trace->m_Count;
+			}
+		}
+
+		bool Trace::WriteChromeTrace( const char* path )
+		{
+			//	Copy spans out of the ring buffers first, so the file isn't written under the lock
+			std::vector< TraceSpan > spans;
+			std::vector< unsigned long > threadIds;
+			{
+				TraceLock lock;
+				for ( const ThreadTrace* trace = s_Threads; trace != 0; trace = trace->m_Next )
+				{
+					const long end = trace->m_Count;
+					long begin = end - RingSize;
+					begin = ( begin > trace->m_ClearedCount ) ? begin : trace->m_ClearedCount;
+
+					const size_t firstSpan = spans.size( );
+					for ( long index = begin; index < end; ++index )
+					{
+						spans.push_back( trace->m_Spans[ index & ( RingSize - 1 ) ] );
+					}
+
+					//	The owning thread may have wrapped around and overwritten spans while they were being
+					//	copied. Those spans are discarded, along with the span in the slot the owning thread may
+					//	still be writing (m_Count is only bumped once a span has been written)
+					const long overwritten = ( trace->m_Count + 1 - RingSize ) - begin;
+					if ( overwritten > 0 )
+					{
+						const size_t discard = ( size_t )overwritten < ( spans.size( ) - firstSpan ) ? ( size_t )overwritten : ( spans.size( ) - firstSpan );
+						spans.erase( spans.begin( ) + firstSpan, spans.begin( ) + firstSpan + discard );
+					}
+					threadIds.resize( spans.size( ), trace->m_ThreadId );
+				}
+			}
+
+			FILE* file = fopen( path, "w" );
+			if ( file == 0 )
+			{
+				return false;
+			}
+
+			//	Timestamps are in microseconds, relative to the earliest span
+			long long origin = 0;
+			for ( size_t index = 0; index < spans.size( ); ++index )
+			{
+				origin = ( ( index == 0 ) || ( spans[ index ].m_Start < origin ) ) ? spans[ index ].m_Start : origin;
+			}
+			const double microsecondsPerTick = 1000000.0 / double( Instrumentation::GetTicksPerSecond( ) );
+			const unsigned long processId = Platform::GetProcessId( );
+
+			fprintf( file, "{\"traceEvents\":[" );
+			for ( size_t index = 0; index < spans.size( ); ++index )
+			{
+				const TraceSpan& span = spans[ index ];
+				fprintf
+				(
+					file,
+					"%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu,\"args\":{\"arg\":%d}}",
+					( index == 0 ) ? "" : ",",
+					span.m_Name,
+					double( span.m_Start - origin ) * microsecondsPerTick,
+					double( span.m_End - span.m_Start ) * microsecondsPerTick,
+					processId,
+					threadIds[ index ],
+					span.m_Arg
+				);
+			}
+			fprintf( file, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+
+			const bool ok = ( ferror( file ) == 0 );
+			fclose( file );
+			return ok;
+		}
+
+	}; //Fast
+}; //Poc1
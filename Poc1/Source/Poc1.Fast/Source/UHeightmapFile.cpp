@@ -0,0 +1,370 @@
+#include "Stdafx.h"
+#include "UHeightmapFile.h"
+
+#include <algorithm>
+#include <string.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Largest 16-bit texel value
+		static const int MaxUnsigned16 = 65535;
+
+		///	\brief	Returns true if a value is a power of 2
+		inline bool IsPowerOf2( const int value )
+		{
+			return ( value > 0 ) && ( ( value & ( value - 1 ) ) == 0 );
+		}
+
+		///	\brief	Gets the size of a texel in a given format, in bytes
+		inline int GetBytesPerTexel( const int format )
+		{
+			return format == HeightmapUnsigned16 ? 2 : 4;
+		}
+
+		///	\brief	Gets the number of tiles along each side of a face
+		inline int GetTilesPerSide( const UHeightmapHeader& header )
+		{
+			return ( header.m_Resolution + header.m_TileSize - 1 ) / header.m_TileSize;
+		}
+
+		///	\brief	Gets the bias and scale that normalize texels of a heightmap (see UHeightmapFile::GetTexel()), as
+		///	( texel - bias ) * scale. Subtracting the bias first keeps the precision of heights far from zero
+		static void GetTexelNormalization( const UHeightmapHeader& header, float& bias, float& scale )
+		{
+			if ( header.m_Format == HeightmapUnsigned16 )
+			{
+				bias = 0;
+				scale = 1.0f / float( MaxUnsigned16 );
+				return;
+			}
+			bias = header.m_MinHeight;
+			scale = 1.0f / ( header.m_MaxHeight - header.m_MinHeight );
+		}
+
+		///	\brief	Holds the lock on the windows of a heightmap file while in scope
+		class HeightmapWindowsLock
+		{
+			public :
+
+				HeightmapWindowsLock( volatile long& lock ) :
+					m_Lock( lock )
+				{
+					while ( Platform::AtomicExchange( &m_Lock, 1 ) != 0 )
+					{
+						Platform::YieldThread( );
+					}
+				}
+
+				~HeightmapWindowsLock( )
+				{
+					Platform::AtomicExchange( &m_Lock, 0 );
+				}
+
+			private :
+
+				volatile long&	m_Lock;
+
+				HeightmapWindowsLock& operator = ( const HeightmapWindowsLock& );
+		};
+
+		//	----------------------------------------------------------- UHeightmapFile Methods
+
+		UHeightmapFile::UHeightmapFile( ) :
+			m_WindowsLock( 0 ),
+			m_TilesPerSide( 0 ),
+			m_TileShift( 0 ),
+			m_TileMask( 0 ),
+			m_TexelBias( 0 ),
+			m_TexelScale( 0 )
+		{
+			memset( &m_Header, 0, sizeof( m_Header ) );
+		}
+
+		UHeightmapFile::~UHeightmapFile( )
+		{
+			Close( );
+		}
+
+		bool UHeightmapFile::Open( const char* path, const long long windowSize, const int maxWindows )
+		{
+			//	Windows overlap by enough to read the header, the range of a tile, or a texel, from any window
+			Close( );
+			if ( !m_Windows.Open( path, windowSize, sizeof( UHeightmapHeader ), maxWindows ) )
+			{
+				return false;
+			}
+
+			//	Check that the header describes a heightmap, and that its ranges and tiles are inside the file
+			const long long fileSize = m_Windows.GetSize( );
+			const UHeightmapHeader* header = ( const UHeightmapHeader* )m_Windows.GetRange( 0, sizeof( UHeightmapHeader ) );
+			bool valid =
+				( header != 0 ) &&
+				( header->m_Magic == Magic ) && ( header->m_Version == Version ) &&
+				( ( header->m_Format == HeightmapUnsigned16 ) || ( header->m_Format == HeightmapFloat32 ) ) &&
+				( ( header->m_Projection == ProjectionGnomonic ) || ( header->m_Projection == ProjectionTangent ) ) &&
+				( header->m_Resolution >= 2 ) && IsPowerOf2( header->m_TileSize ) && ( header->m_TileSize <= 4096 ) &&
+				( header->m_MaxHeight > header->m_MinHeight );
+			const long long tileCount = valid ? ( long long )GetTilesPerSide( *header ) * GetTilesPerSide( *header ) * 6 : 0;
+			const long long tileBytes = valid ? ( long long )header->m_TileSize * header->m_TileSize * GetBytesPerTexel( header->m_Format ) : 0;
+			valid = valid &&
+				( header->m_RangeOffset >= ( long long )sizeof( UHeightmapHeader ) ) && ( ( header->m_RangeOffset % 4 ) == 0 ) &&
+				( header->m_RangeOffset + tileCount * 2 * ( long long )sizeof( float ) <= header->m_TexelOffset ) &&
+				( ( header->m_TexelOffset % 16 ) == 0 ) && ( header->m_TexelOffset + tileCount * tileBytes <= fileSize );
+			if ( !valid )
+			{
+				m_Windows.Close( );
+				return false;
+			}
+
+			m_Header = *header;
+			m_TilesPerSide = GetTilesPerSide( m_Header );
+			m_TileShift = 0;
+			while ( ( 1 << m_TileShift ) < m_Header.m_TileSize )
+			{
+				++m_TileShift;
+			}
+			m_TileMask = m_Header.m_TileSize - 1;
+			GetTexelNormalization( m_Header, m_TexelBias, m_TexelScale );
+			return true;
+		}
+
+		void UHeightmapFile::Close( )
+		{
+			HeightmapWindowsLock lock( m_WindowsLock );
+			m_Windows.Close( );
+			memset( &m_Header, 0, sizeof( m_Header ) );
+		}
+
+		float UHeightmapFile::ReadTexel( const int face, const int row, const int col ) const
+		{
+			const int tile = ( face * m_TilesPerSide + ( row >> m_TileShift ) ) * m_TilesPerSide + ( col >> m_TileShift );
+			const long long index = ( ( long long )tile << ( m_TileShift * 2 ) ) + ( ( row & m_TileMask ) << m_TileShift ) + ( col & m_TileMask );
+			const int bytesPerTexel = GetBytesPerTexel( m_Header.m_Format );
+			const unsigned char* data = m_Windows.GetRange( m_Header.m_TexelOffset + index * bytesPerTexel, bytesPerTexel );
+			if ( data == 0 )
+			{
+				//	The window couldn't be mapped (the process is out of address space)
+				return 0;
+			}
+			if ( m_Header.m_Format == HeightmapUnsigned16 )
+			{
+				unsigned short texel;
+				memcpy( &texel, data, 2 );
+				return ( float( texel ) - m_TexelBias ) * m_TexelScale;
+			}
+			float texel;
+			memcpy( &texel, data, 4 );
+			return ( texel - m_TexelBias ) * m_TexelScale;
+		}
+
+		float UHeightmapFile::GetTexel( const int face, const int row, const int col ) const
+		{
+			HeightmapWindowsLock lock( m_WindowsLock );
+			return ReadTexel( face, row, col );
+		}
+
+		void UHeightmapFile::GetTexels( const int count, const int* faces, const int* rows, const int* cols, float* texels ) const
+		{
+			HeightmapWindowsLock lock( m_WindowsLock );
+			for ( int texel = 0; texel < count; ++texel )
+			{
+				texels[ texel ] = ReadTexel( faces[ texel ], rows[ texel ], cols[ texel ] );
+			}
+		}
+
+		void UHeightmapFile::GetRange( const int face, const int minRow, const int minCol, const int maxRow, const int maxCol, float& minValue, float& maxValue ) const
+		{
+			const int maxTexel = m_Header.m_Resolution - 1;
+			const int firstRow = ( minRow < 0 ? 0 : ( minRow > maxTexel ? maxTexel : minRow ) ) >> m_TileShift;
+			const int firstCol = ( minCol < 0 ? 0 : ( minCol > maxTexel ? maxTexel : minCol ) ) >> m_TileShift;
+			const int lastRow = ( maxRow < 0 ? 0 : ( maxRow > maxTexel ? maxTexel : maxRow ) ) >> m_TileShift;
+			const int lastCol = ( maxCol < 0 ? 0 : ( maxCol > maxTexel ? maxTexel : maxCol ) ) >> m_TileShift;
+
+			minValue = 1;
+			maxValue = 0;
+			HeightmapWindowsLock lock( m_WindowsLock );
+			for ( int tileRow = firstRow; tileRow <= lastRow; ++tileRow )
+			{
+				const long long firstTile = ( face * m_TilesPerSide + tileRow ) * m_TilesPerSide + firstCol;
+				for ( int tileCol = firstCol; tileCol <= lastCol; ++tileCol )
+				{
+					//	Tiles whose range can't be mapped could hold any texel value
+					float range[ 2 ] = { 0, 1 };
+					const unsigned char* data = m_Windows.GetRange( m_Header.m_RangeOffset + ( firstTile + tileCol - firstCol ) * ( long long )sizeof( range ), sizeof( range ) );
+					if ( data != 0 )
+					{
+						memcpy( range, data, sizeof( range ) );
+					}
+					minValue = range[ 0 ] < minValue ? range[ 0 ] : minValue;
+					maxValue = range[ 1 ] > maxValue ? range[ 1 ] : maxValue;
+				}
+			}
+		}
+
+		//	--------------------------------------------------------- UHeightmapWriter Methods
+
+		UHeightmapWriter::UHeightmapWriter( ) :
+			m_File( 0 ),
+			m_TilesPerSide( 0 ),
+			m_Row( 0 ),
+			m_Written( false )
+		{
+			memset( &m_Header, 0, sizeof( m_Header ) );
+		}
+
+		UHeightmapWriter::~UHeightmapWriter( )
+		{
+			if ( m_File != 0 )
+			{
+				fclose( m_File );
+			}
+		}
+
+		bool UHeightmapWriter::Start( const char* path, const UHeightmapFormat format, const UCubeMapProjection projection, const int resolution, const int tileSize, const float minHeight, const float maxHeight )
+		{
+			if ( m_File != 0 )
+			{
+				fclose( m_File );
+				m_File = 0;
+			}
+			if ( ( resolution < 2 ) || !IsPowerOf2( tileSize ) || ( tileSize > 4096 ) || !( maxHeight > minHeight ) )
+			{
+				return false;
+			}
+			m_File = fopen( path, "wb" );
+			if ( m_File == 0 )
+			{
+				return false;
+			}
+
+			memset( &m_Header, 0, sizeof( m_Header ) );
+			m_Header.m_Magic = UHeightmapFile::Magic;
+			m_Header.m_Version = UHeightmapFile::Version;
+			m_Header.m_Format = format;
+			m_Header.m_Projection = projection;
+			m_Header.m_Resolution = resolution;
+			m_Header.m_TileSize = tileSize;
+			m_Header.m_MinHeight = minHeight;
+			m_Header.m_MaxHeight = maxHeight;
+			m_TilesPerSide = GetTilesPerSide( m_Header );
+
+			const long long tileCount = ( long long )m_TilesPerSide * m_TilesPerSide * 6;
+			m_Header.m_RangeOffset = sizeof( UHeightmapHeader );
+			m_Header.m_TexelOffset = ( m_Header.m_RangeOffset + tileCount * 2 * ( long long )sizeof( float ) + 15 ) & ~15LL;
+			m_Row = 0;
+			m_Rows.assign( ( size_t )tileSize * m_TilesPerSide * tileSize, 0.0f );
+			m_Ranges.assign( ( size_t )tileCount * 2, 0.0f );
+
+			//	The header and ranges are written again by Finish(). Until then, they reserve their space
+			std::vector< unsigned char > reserved( ( size_t )m_Header.m_TexelOffset, 0 );
+			m_Written = fwrite( &reserved[ 0 ], reserved.size( ), 1, m_File ) == 1;
+			return true;
+		}
+
+		void UHeightmapWriter::WriteRow( const float* heights )
+		{
+			const int resolution = m_Header.m_Resolution;
+			if ( ( m_File == 0 ) || ( m_Row >= resolution * 6 ) )
+			{
+				m_Written = false;
+				return;
+			}
+			const int faceRow = m_Row % resolution;
+			float* row = &m_Rows[ ( size_t )( faceRow & ( m_Header.m_TileSize - 1 ) ) * m_TilesPerSide * m_Header.m_TileSize ];
+			for ( int col = 0; col < resolution; ++col )
+			{
+				const float height = heights[ col ];
+				row[ col ] = height < m_Header.m_MinHeight ? m_Header.m_MinHeight : ( height > m_Header.m_MaxHeight ? m_Header.m_MaxHeight : height );
+			}
+			++m_Row;
+			if ( ( ( faceRow + 1 ) % m_Header.m_TileSize == 0 ) || ( faceRow + 1 == resolution ) )
+			{
+				WriteTileRow( );
+			}
+		}
+
+		void UHeightmapWriter::WriteTileRow( )
+		{
+			const int resolution = m_Header.m_Resolution;
+			const int tileSize = m_Header.m_TileSize;
+			const int lastRow = m_Row - 1;
+			const int face = lastRow / resolution;
+			const int tileRow = ( lastRow % resolution ) / tileSize;
+			const int rows = ( lastRow % resolution ) - tileRow * tileSize + 1;
+			const int lineSize = m_TilesPerSide * tileSize;
+
+			float bias, scale;
+			GetTexelNormalization( m_Header, bias, scale );
+			const float quantizeScale = float( MaxUnsigned16 ) / ( m_Header.m_MaxHeight - m_Header.m_MinHeight );
+
+			const int bytesPerTexel = GetBytesPerTexel( m_Header.m_Format );
+			std::vector< unsigned char > tile( ( size_t )tileSize * tileSize * bytesPerTexel, 0 );
+			for ( int tileCol = 0; tileCol < m_TilesPerSide; ++tileCol )
+			{
+				const int cols = ( resolution - tileCol * tileSize ) < tileSize ? ( resolution - tileCol * tileSize ) : tileSize;
+				float minValue = 1;
+				float maxValue = 0;
+				for ( int row = 0; row < tileSize; ++row )
+				{
+					for ( int col = 0; col < tileSize; ++col )
+					{
+						//	Padding texels are zero, and don't count towards the range of the tile
+						const bool padding = ( row >= rows ) || ( col >= cols );
+						const float height = padding ? m_Header.m_MinHeight : m_Rows[ ( size_t )row * lineSize + tileCol * tileSize + col ];
+						const int index = row * tileSize + col;
+
+						//	Normalize stored values in the same way as UHeightmapFile::GetTexel()
+						float value;
+						if ( m_Header.m_Format == HeightmapUnsigned16 )
+						{
+							const int quantized = int( ( height - m_Header.m_MinHeight ) * quantizeScale + 0.5f );
+							const unsigned short texel = ( unsigned short )( padding ? 0 : ( quantized < 0 ? 0 : ( quantized > MaxUnsigned16 ? MaxUnsigned16 : quantized ) ) );
+							memcpy( &tile[ index * 2 ], &texel, 2 );
+							value = ( float( texel ) - bias ) * scale;
+						}
+						else
+						{
+							const float texel = padding ? 0.0f : height;
+							memcpy( &tile[ index * 4 ], &texel, 4 );
+							value = ( texel - bias ) * scale;
+						}
+						if ( !padding )
+						{
+							minValue = value < minValue ? value : minValue;
+							maxValue = value > maxValue ? value : maxValue;
+						}
+					}
+				}
+				float* range = &m_Ranges[ ( ( size_t )( face * m_TilesPerSide + tileRow ) * m_TilesPerSide + tileCol ) * 2 ];
+				range[ 0 ] = minValue;
+				range[ 1 ] = maxValue;
+				m_Written = m_Written && ( fwrite( &tile[ 0 ], tile.size( ), 1, m_File ) == 1 );
+			}
+			std::fill( m_Rows.begin( ), m_Rows.end( ), 0.0f );
+		}
+
+		bool UHeightmapWriter::Finish( )
+		{
+			if ( m_File == 0 )
+			{
+				return false;
+			}
+			bool written = m_Written && ( m_Row == m_Header.m_Resolution * 6 );
+			written = written && ( fseek( m_File, 0, SEEK_SET ) == 0 );
+			written = written && ( fwrite( &m_Header, sizeof( m_Header ), 1, m_File ) == 1 );
+			written = written && ( fwrite( &m_Ranges[ 0 ], m_Ranges.size( ) * sizeof( float ), 1, m_File ) == 1 );
+			written = ( fclose( m_File ) == 0 ) && written;
+			m_File = 0;
+			m_Rows.clear( );
+			m_Ranges.clear( );
+			return written;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
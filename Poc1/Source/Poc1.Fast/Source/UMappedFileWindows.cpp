@@ -0,0 +1,122 @@
+#include "Stdafx.h"
+#include "UMappedFileWindows.h"
+
+#include <stddef.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		//	------------------------------------------------------- UMappedFileWindows Methods
+
+		UMappedFileWindows::UMappedFileWindows( ) :
+			m_WindowSize( 0 ),
+			m_Overlap( 0 ),
+			m_MaxWindows( 0 ),
+			m_Clock( 0 )
+		{
+			m_File.m_Size = 0;
+			m_File.m_Handle = 0;
+		}
+
+		UMappedFileWindows::~UMappedFileWindows( )
+		{
+			Close( );
+		}
+
+		bool UMappedFileWindows::Open( const char* path, const long long windowSize, const long long overlap, const int maxWindows )
+		{
+			Close( );
+			if ( !Platform::OpenMappedFile( path, m_File ) )
+			{
+				return false;
+			}
+			const long long alignment = Platform::GetViewAlignment( );
+			m_WindowSize = windowSize < alignment ? alignment : ( ( windowSize + alignment - 1 ) / alignment ) * alignment;
+			m_Overlap = overlap < 0 ? 0 : overlap;
+			m_MaxWindows = maxWindows < 1 ? 1 : maxWindows;
+			m_Clock = 0;
+
+			const Window unmapped = { 0, 0 };
+			m_Windows.assign( size_t( ( m_File.m_Size + m_WindowSize - 1 ) / m_WindowSize ), unmapped );
+			m_Mapped.reserve( m_MaxWindows );
+			return true;
+		}
+
+		void UMappedFileWindows::Close( )
+		{
+			for ( size_t mapped = 0; mapped < m_Mapped.size( ); ++mapped )
+			{
+				Platform::UnmapView( m_Windows[ m_Mapped[ mapped ] ].m_Data, GetViewSize( m_Mapped[ mapped ] ) );
+			}
+			m_Mapped.clear( );
+			m_Windows.clear( );
+			Platform::CloseMappedFile( m_File );
+		}
+
+		long long UMappedFileWindows::GetViewSize( const int window ) const
+		{
+			const long long start = window * m_WindowSize;
+			const long long end = start + m_WindowSize + m_Overlap;
+			return ( end < m_File.m_Size ? end : m_File.m_Size ) - start;
+		}
+
+		int UMappedFileWindows::MapWindow( const long long offset, const long long size )
+		{
+			if ( ( offset < 0 ) || ( size < 0 ) || ( size > m_Overlap ) || ( offset + size > m_File.m_Size ) )
+			{
+				return -1;
+			}
+			const int window = int( offset / m_WindowSize );
+			Window& found = m_Windows[ window ];
+			if ( found.m_Data == 0 )
+			{
+				//	Unmap the least recently used window to make room
+				if ( int( m_Mapped.size( ) ) >= m_MaxWindows )
+				{
+					size_t oldest = 0;
+					for ( size_t mapped = 1; mapped < m_Mapped.size( ); ++mapped )
+					{
+						if ( m_Windows[ m_Mapped[ mapped ] ].m_LastUsed < m_Windows[ m_Mapped[ oldest ] ].m_LastUsed )
+						{
+							oldest = mapped;
+						}
+					}
+					Window& evicted = m_Windows[ m_Mapped[ oldest ] ];
+					Platform::UnmapView( evicted.m_Data, GetViewSize( m_Mapped[ oldest ] ) );
+					evicted.m_Data = 0;
+					m_Mapped[ oldest ] = m_Mapped.back( );
+					m_Mapped.pop_back( );
+				}
+				found.m_Data = Platform::MapView( m_File, window * m_WindowSize, GetViewSize( window ) );
+				if ( found.m_Data == 0 )
+				{
+					return -1;
+				}
+				m_Mapped.push_back( window );
+			}
+			found.m_LastUsed = ++m_Clock;
+			return window;
+		}
+
+		const unsigned char* UMappedFileWindows::GetRange( const long long offset, const long long size )
+		{
+			const int window = MapWindow( offset, size );
+			return window < 0 ? 0 : m_Windows[ window ].m_Data + ( offset - window * m_WindowSize );
+		}
+
+		void UMappedFileWindows::Prefetch( const long long offset, const long long size )
+		{
+			const int window = MapWindow( offset, size );
+			if ( window >= 0 )
+			{
+				Platform::PrefetchView( m_Windows[ window ].m_Data, offset - window * m_WindowSize, size );
+			}
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
@@ -1,4 +1,4 @@
-#include "stdafx.h"
+#include "Stdafx.h"
 #include "UVector3.h"
 
 const Poc1::Fast::UVector3 Poc1::Fast::UVector3::XAxis( 1, 0, 0 );
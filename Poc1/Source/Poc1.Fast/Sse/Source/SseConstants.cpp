@@ -1,4 +1,4 @@
-#include "stdafx.h"
+#include "Stdafx.h"
 #include "Sse/SseConstants.h"
 #include <emmintrin.h>
 
@@ -49,5 +49,22 @@ namespace Poc1
 			Fc_Neg1 = _mm_set1_ps( -1 );
 		}
 
+	#ifndef _MANAGED
+
+		///	\brief	Sets up the constants before main() in native builds, where there is no DllMain
+		static const bool s_ConstantsInitialized = ( Constants::InitializeConstants( ), true );
+
+	#endif
+
 	}; //Fast
-}; //Poc1
\ No newline at end of file
+}; //Poc1
+
+#ifdef _MANAGED
+
+extern "C" bool __stdcall DllMain( void*, int, void* )
+{
+	Poc1::Fast::Constants::InitializeConstants( );
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "Stdafx.h"
+#include "Sse/SseContinentMask.h"
+#include "Mem.h"
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		//	-------------------------------------------------------- SseContinentMask Methods
+
+		SseContinentMask::SseContinentMask( ) :
+			m_Texels( 0 ),
+			m_Radius( 0 ),
+			m_Resolution( 0 ),
+			m_Octaves( 0 )
+		{
+			m_HalfSize = Constants::Fc_0;
+			m_MaxTexel = Constants::Fc_0;
+		}
+
+		SseContinentMask::~SseContinentMask( )
+		{
+			AlignedArrayDelete( m_Texels );
+		}
+
+		void SseContinentMask::Allocate( const int resolution, const int octaves )
+		{
+			//	At least 2 texels are needed along each side, for bilinear interpolation
+			const int newResolution = resolution < 2 ? 2 : resolution;
+			const int newOctaves = octaves < 1 ? 1 : ( octaves > MaxOctaves ? MaxOctaves : octaves );
+			if ( ( newResolution != m_Resolution ) || ( newOctaves != m_Octaves ) )
+			{
+				AlignedArrayDelete( m_Texels );
+				m_Texels = new ( Aligned( 16 ) ) float[ newResolution * newResolution * 6 * newOctaves ];
+				m_Resolution = newResolution;
+				m_Octaves = newOctaves;
+			}
+			m_MaxTexel = _mm_set1_ps( float( m_Resolution - 1 ) );
+			m_HalfSize = _mm_set1_ps( float( m_Resolution - 1 ) * 0.5f );
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,242 @@
+#include "Stdafx.h"
+#include "Sse/SseFunctionBounds.h"
+
+#include <float.h>
+#include <math.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		//	------------------------------------------------------- SseFunctionRegion Methods
+
+		SseFunctionRegion::SseFunctionRegion( )
+		{
+			m_Min[ 0 ] = m_Min[ 1 ] = m_Min[ 2 ] = FLT_MAX;
+			m_Max[ 0 ] = m_Max[ 1 ] = m_Max[ 2 ] = -FLT_MAX;
+		}
+
+		SseFunctionRegion::SseFunctionRegion( const float* minimum, const float* maximum )
+		{
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				m_Min[ axis ] = minimum[ axis ];
+				m_Max[ axis ] = maximum[ axis ];
+			}
+		}
+
+		float SseFunctionRegion::GetMinimumLength( ) const
+		{
+			float sqrLength = 0;
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				const float distance = FunctionBounds::GetMinMagnitude( m_Min[ axis ], m_Max[ axis ] );
+				sqrLength += distance * distance;
+			}
+			return sqrtf( sqrLength );
+		}
+
+		float SseFunctionRegion::GetMaximumLength( ) const
+		{
+			float sqrLength = 0;
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				const float distance = FunctionBounds::GetMaxMagnitude( m_Min[ axis ], m_Max[ axis ] );
+				sqrLength += distance * distance;
+			}
+			return sqrtf( sqrLength );
+		}
+
+		void SseFunctionRegion::Expand( const float distance )
+		{
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				m_Min[ axis ] -= distance;
+				m_Max[ axis ] += distance;
+			}
+		}
+
+		void SseFunctionRegion::Offset( const float x, const float y, const float z )
+		{
+			const float offset[ 3 ] = { x, y, z };
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				m_Min[ axis ] += offset[ axis ];
+				m_Max[ axis ] += offset[ axis ];
+			}
+		}
+
+		void SseFunctionRegion::Scale( const float scale )
+		{
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				FunctionBounds::Scale( m_Min[ axis ], m_Max[ axis ], scale );
+			}
+		}
+
+		void SseFunctionRegion::Intersect( const SseFunctionRegion& region )
+		{
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				m_Min[ axis ] = region.m_Min[ axis ] > m_Min[ axis ] ? region.m_Min[ axis ] : m_Min[ axis ];
+				m_Max[ axis ] = region.m_Max[ axis ] < m_Max[ axis ] ? region.m_Max[ axis ] : m_Max[ axis ];
+			}
+		}
+
+		//	---------------------------------------------------------- FunctionBounds Functions
+
+		void FunctionBounds::GetNoiseOctaveBounds( const SseNoise& noise, const SseFunctionRegion& region, const float freq, const int octaves, const int samples, OctaveBounds& bounds )
+		{
+			float* minNoise = bounds.m_Min;
+			float* maxNoise = bounds.m_Max;
+			const int axisSamples = samples < 1 ? 1 : samples;
+			const float* minimum = region.GetMinimum( );
+			const float* maximum = region.GetMaximum( );
+
+			//	Every position in the region is within half a cell of a sample, along each axis
+			float cellSize[ 3 ];
+			float slack = 0;
+			for ( int axis = 0; axis < 3; ++axis )
+			{
+				cellSize[ axis ] = ( maximum[ axis ] - minimum[ axis ] ) / float( axisSamples );
+				slack += cellSize[ axis ] * 0.5f;
+			}
+			slack *= NoiseMaxSlope;
+
+			//	Octaves whose noise can change by more than its whole range inside a cell are not worth sampling
+			int sampledOctaves = 0;
+			float octaveSlack[ MaxOctaves ];
+			for ( int octave = 0; octave < MaxOctaves; ++octave )
+			{
+				const bool sampled = ( octave < octaves ) && ( octave == sampledOctaves ) && ( slack < NoiseMaxValue * 2 );
+				if ( sampled )
+				{
+					octaveSlack[ sampledOctaves++ ] = slack;
+				}
+				minNoise[ octave ] = -NoiseMaxValue;
+				maxNoise[ octave ] = NoiseMaxValue;
+				slack *= freq < 0 ? -freq : freq;
+			}
+			if ( sampledOctaves == 0 )
+			{
+				return;
+			}
+
+			__m128 minValues[ MaxOctaves ];
+			__m128 maxValues[ MaxOctaves ];
+			for ( int octave = 0; octave < sampledOctaves; ++octave )
+			{
+				minValues[ octave ] = _mm_set1_ps( FLT_MAX );
+				maxValues[ octave ] = _mm_set1_ps( -FLT_MAX );
+			}
+
+			const __m128 freqFfff = _mm_set1_ps( freq );
+			const int count = axisSamples * axisSamples * axisSamples;
+			FAST_ALIGN( 16 ) float x[ 4 ], y[ 4 ], z[ 4 ];
+			for ( int start = 0; start < count; start += 4 )
+			{
+				//	The last block is padded with the first sample
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					const int index = ( start + lane < count ) ? start + lane : start;
+					const int col = index % axisSamples;
+					const int row = ( index / axisSamples ) % axisSamples;
+					const int layer = index / ( axisSamples * axisSamples );
+					x[ lane ] = minimum[ 0 ] + cellSize[ 0 ] * ( float( col ) + 0.5f );
+					y[ lane ] = minimum[ 1 ] + cellSize[ 1 ] * ( float( row ) + 0.5f );
+					z[ lane ] = minimum[ 2 ] + cellSize[ 2 ] * ( float( layer ) + 0.5f );
+				}
+
+				__m128 xxxx = _mm_load_ps( x );
+				__m128 yyyy = _mm_load_ps( y );
+				__m128 zzzz = _mm_load_ps( z );
+				for ( int octave = 0; octave < sampledOctaves; ++octave )
+				{
+					const __m128 values = noise.Noise< SseExactPrecision >( xxxx, yyyy, zzzz );
+					minValues[ octave ] = _mm_min_ps( minValues[ octave ], values );
+					maxValues[ octave ] = _mm_max_ps( maxValues[ octave ], values );
+					xxxx = _mm_mul_ps( xxxx, freqFfff );
+					yyyy = _mm_mul_ps( yyyy, freqFfff );
+					zzzz = _mm_mul_ps( zzzz, freqFfff );
+				}
+			}
+
+			for ( int octave = 0; octave < sampledOctaves; ++octave )
+			{
+				FAST_ALIGN( 16 ) float mins[ 4 ], maxs[ 4 ];
+				_mm_store_ps( mins, minValues[ octave ] );
+				_mm_store_ps( maxs, maxValues[ octave ] );
+				float minValue = mins[ 0 ];
+				float maxValue = maxs[ 0 ];
+				for ( int lane = 1; lane < 4; ++lane )
+				{
+					minValue = mins[ lane ] < minValue ? mins[ lane ] : minValue;
+					maxValue = maxs[ lane ] > maxValue ? maxs[ lane ] : maxValue;
+				}
+				minNoise[ octave ] = minValue - octaveSlack[ octave ];
+				maxNoise[ octave ] = maxValue + octaveSlack[ octave ];
+				Clamp( minNoise[ octave ], maxNoise[ octave ], -NoiseMaxValue, NoiseMaxValue );
+			}
+		}
+
+		void FunctionBounds::GetRidgeBounds( const float minNoise, const float maxNoise, float& minSignal, float& maxSignal )
+		{
+			//	Range of |n|
+			float minAbs = minNoise;
+			float maxAbs = maxNoise;
+			if ( maxNoise <= 0 )
+			{
+				minAbs = -maxNoise;
+				maxAbs = -minNoise;
+			}
+			else if ( minNoise < 0 )
+			{
+				minAbs = 0;
+				maxAbs = GetMaxMagnitude( minNoise, maxNoise );
+			}
+
+			//	(1-a)^2 falls to zero at a=1, then rises again (the noise can be slightly larger than 1)
+			const float atMin = ( 1 - minAbs ) * ( 1 - minAbs );
+			const float atMax = ( 1 - maxAbs ) * ( 1 - maxAbs );
+			minSignal = ( minAbs <= 1 ) && ( maxAbs >= 1 ) ? 0 : ( atMin < atMax ? atMin : atMax );
+			maxSignal = atMin > atMax ? atMin : atMax;
+		}
+
+		void FunctionBounds::GetRidgedFractalBounds( const OctaveBounds& noise, const int octaves, const float freq, const float gain, const float max, float& minValue, float& maxValue )
+		{
+			//	Follows SseRidgedFractal::GetValue(). Every term is positive, and grows with the signal of the previous octave
+			float minSignal, maxSignal;
+			GetRidgeBounds( noise.GetMin( 0 ), noise.GetMax( 0 ), minSignal, maxSignal );
+			minValue = minSignal;
+			maxValue = maxSignal;
+
+			float exp = 1;
+			for ( int octave = 1; octave < octaves; ++octave )
+			{
+				float minWeight = minSignal;
+				float maxWeight = maxSignal;
+				Scale( minWeight, maxWeight, gain );
+				Clamp( minWeight, maxWeight, 0, 1 );
+
+				GetRidgeBounds( noise.GetMin( octave ), noise.GetMax( octave ), minSignal, maxSignal );
+				minSignal *= minWeight;
+				maxSignal *= maxWeight;
+
+				float minTerm = minSignal;
+				float maxTerm = maxSignal;
+				Scale( minTerm, maxTerm, 1 / exp );
+				minValue += minTerm;
+				maxValue += maxTerm;
+				exp *= freq;
+			}
+
+			Scale( minValue, maxValue, 1 / max );
+			Widen( minValue, maxValue );
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
@@ -0,0 +1,170 @@
+#include "Stdafx.h"
+#include "Sse/SseHeightmapFunction.h"
+#include "Scalar/ScalarUtils.h"
+
+#include <math.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Axes of the face coordinates of each cube map face (see GetCubeFaceCoordinates() in SseUtils.h)
+		///
+		///	Each face has its major axis and the sign of the major axis on the face, then the axis and sign of
+		///	u, then the axis and sign of v.
+		///
+		static const int FaceAxes[ 6 ][ 6 ] =
+		{
+			{ 0, -1,	2, 1,	1, 1 },		//	NegativeX: u = z	v = y
+			{ 0, 1,		2, -1,	1, 1 },		//	PositiveX: u = -z	v = y
+			{ 1, -1,	0, -1,	2, -1 },	//	NegativeY: u = -x	v = -z
+			{ 1, 1,		0, -1,	2, 1 },		//	PositiveY: u = -x	v = z
+			{ 2, -1,	0, -1,	1, 1 },		//	NegativeZ: u = -x	v = y
+			{ 2, 1,		0, 1,	1, 1 }		//	PositiveZ: u = x	v = y
+		};
+
+		///	\brief	Gets the range of sign * value along an axis of a region
+		inline void GetAxisRange( const SseFunctionRegion& region, const int axis, const int sign, float& minValue, float& maxValue )
+		{
+			minValue = sign > 0 ? region.GetMinimum( )[ axis ] : -region.GetMaximum( )[ axis ];
+			maxValue = sign > 0 ? region.GetMaximum( )[ axis ] : -region.GetMinimum( )[ axis ];
+		}
+
+		///	\brief	Gets the range of a face coordinate ( value / major ), clamped to [-1,1]
+		inline void GetFaceCoordinateRange( const float minValue, const float maxValue, const float minMajor, const float maxMajor, float& minCoordinate, float& maxCoordinate )
+		{
+			if ( minMajor <= 0 )
+			{
+				//	The region reaches the plane through the centre of the cube, where face coordinates are unbounded
+				minCoordinate = -1;
+				maxCoordinate = 1;
+				return;
+			}
+			minCoordinate = minValue / ( minValue < 0 ? minMajor : maxMajor );
+			maxCoordinate = maxValue / ( maxValue > 0 ? minMajor : maxMajor );
+			FunctionBounds::Clamp( minCoordinate, maxCoordinate, -1, 1 );
+		}
+
+		//	----------------------------------------------------- SseHeightmapFunction Methods
+
+		SseHeightmapFunction::SseHeightmapFunction( ) :
+			m_Filter( FilterBilinear )
+		{
+			m_DetailAmplitude = Constants::Fc_0;
+			m_HalfSize = Constants::Fc_0;
+			m_MaxTexel = Constants::Fc_0;
+		}
+
+		bool SseHeightmapFunction::Open( const char* path )
+		{
+			m_HalfSize = Constants::Fc_0;
+			m_MaxTexel = Constants::Fc_0;
+			if ( !m_File.Open( path ) )
+			{
+				return false;
+			}
+			const float maxTexel = float( m_File.GetResolution( ) - 1 );
+			m_HalfSize = _mm_set1_ps( maxTexel * 0.5f );
+			m_MaxTexel = _mm_set1_ps( maxTexel );
+			return true;
+		}
+
+		void SseHeightmapFunction::Close( )
+		{
+			m_File.Close( );
+			m_HalfSize = Constants::Fc_0;
+			m_MaxTexel = Constants::Fc_0;
+		}
+
+		void SseHeightmapFunction::GetSampleBounds( const SseFunctionRegion& region, float& minValue, float& maxValue ) const
+		{
+			//	Sample() reads texels up to a cell past the texel coordinate (2 for the bicubic filter). Another texel
+			//	either side allows for rounding in the texel coordinates
+			const int padding = m_Filter == FilterBicubic ? 2 : 1;
+			const float halfSize = GetLane( m_HalfSize, 0 );
+			const bool tangent = m_File.GetProjection( ) == ProjectionTangent;
+
+			minValue = 1;
+			maxValue = 0;
+			bool anyFace = false;
+			for ( int face = 0; face < 6; ++face )
+			{
+				const int* axes = FaceAxes[ face ];
+				float minMajor, maxMajor, minU, maxU, minV, maxV;
+				GetAxisRange( region, axes[ 0 ], axes[ 1 ], minMajor, maxMajor );
+				GetAxisRange( region, axes[ 2 ], axes[ 3 ], minU, maxU );
+				GetAxisRange( region, axes[ 4 ], axes[ 5 ], minV, maxV );
+
+				//	Points are on a face if its major axis is at least as large as the other two
+				if ( ( maxMajor <= 0 ) || ( maxMajor < FunctionBounds::GetMinMagnitude( minU, maxU ) ) || ( maxMajor < FunctionBounds::GetMinMagnitude( minV, maxV ) ) )
+				{
+					continue;
+				}
+
+				float coordinates[ 4 ];
+				GetFaceCoordinateRange( minU, maxU, minMajor, maxMajor, coordinates[ 0 ], coordinates[ 1 ] );
+				GetFaceCoordinateRange( minV, maxV, minMajor, maxMajor, coordinates[ 2 ], coordinates[ 3 ] );
+				int texels[ 4 ];
+				for ( int index = 0; index < 4; ++index )
+				{
+					const float coordinate = tangent ? ScalarInverseTangentCubeFaceCoordinate( coordinates[ index ] ) : coordinates[ index ];
+					texels[ index ] = int( floorf( ( coordinate + 1 ) * halfSize ) );
+				}
+
+				float minFace, maxFace;
+				m_File.GetRange( face, texels[ 2 ] - padding, texels[ 0 ] - padding, texels[ 3 ] + 1 + padding, texels[ 1 ] + 1 + padding, minFace, maxFace );
+				FunctionBounds::Union( minValue, maxValue, minFace, maxFace );
+				anyFace = true;
+			}
+
+			if ( !anyFace )
+			{
+				//	Only the centre of the cube, which has no face
+				minValue = 0;
+				maxValue = 1;
+			}
+			if ( m_Filter == FilterBicubic )
+			{
+				//	Catmull-Rom weights sum to 1, and their negative lobes sum to at most 0.125 on each axis, so
+				//	the negative weights of the 4x4 filter sum to at most 2 * 0.125 * 1.125
+				const float overshoot = ( maxValue - minValue ) * 0.28125f;
+				minValue -= overshoot;
+				maxValue += overshoot;
+			}
+		}
+
+		void SseHeightmapFunction::GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			minValue = 0;
+			maxValue = 0;
+			if ( m_File.IsOpen( ) )
+			{
+				GetSampleBounds( region, minValue, maxValue );
+			}
+
+			const float amplitude = GetDetailAmplitude( );
+			if ( amplitude != 0 )
+			{
+				float minDetail, maxDetail;
+				m_Detail.GetSignedBounds( region, minDetail, maxDetail, samples );
+				FunctionBounds::Scale( minDetail, maxDetail, amplitude );
+				minValue += minDetail;
+				maxValue += maxDetail;
+			}
+			FunctionBounds::Widen( minValue, maxValue );
+		}
+
+		void SseHeightmapFunction::GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			//	GetSignedValue() is GetValue() * 2 - 1
+			GetBounds( region, minValue, maxValue, samples );
+			minValue = minValue * 2 - 1;
+			maxValue = maxValue * 2 - 1;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
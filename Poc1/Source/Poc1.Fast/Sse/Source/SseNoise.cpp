@@ -1,17 +1,13 @@
-#include "stdafx.h"
+#include "Stdafx.h"
 #include "Sse/SseNoise.h"
+#include "Trace.h"
 
 #include <stdlib.h>
+#include <math.h>
 #include <emmintrin.h>
 
 #pragma managed(off)
 
-extern "C" bool __stdcall DllMain( void*, int, void* )
-{
-	Poc1::Fast::Constants::InitializeConstants( );
-	return true;
-}
-
 namespace Poc1
 {
 	namespace Fast
@@ -75,7 +71,7 @@ namespace Poc1
 			__m128 incRowyyyy = _mm_set_ps( incRow[ 1 ], incRow[ 1 ], incRow[ 1 ], incRow[ 1 ] );
 			__m128 incRowzzzz = _mm_set_ps( incRow[ 2 ], incRow[ 2 ], incRow[ 2 ], incRow[ 2 ] );
 
-			_CRT_ALIGN(16) float res[ 4 ];
+			FAST_ALIGN(16) float res[ 4 ];
 
 			unsigned char* firstRowPixel = pixels;
 			int stride = width * 3;
@@ -110,57 +106,91 @@ namespace Poc1
 			}
 		}
 
-		void Poc1::Fast::SseNoise::GenerateTiledBitmap( const int width, const int height, const int stride, unsigned char* pixels, const float startX, const float startY, const float noiseWidth, const float noiseHeight ) const
+		///	\brief	Rounds a noise dimension to a whole number of lattice cells, for periodic noise
+		inline static int LatticePeriod( const float size )
+		{
+			const int period = int( size + 0.5f );
+			return period < 1 ? 1 : ( period > 256 ? 256 : period );
+		}
+
+		void Poc1::Fast::SseNoise::GenerateTiledBitmap( const int width, const int height, const int stride, const int channels, const bool independentChannels, unsigned char* pixels, const float startX, const float startY, const float noiseWidth, const float noiseHeight ) const
 		{
-			float incX = noiseWidth / ( float )width;
-			float incY = noiseHeight / ( float )height;
-
-			__m128 originXxxx = _mm_set_ps( startX, startX + incX, startX + incX * 2, startX + incX * 3 );
-			__m128 incXxxx = _mm_set_ps( incX * 4, incX * 4, incX * 4, incX * 4 );
-			const __m128 zzzz = _mm_set1_ps( 2.222f );
-
-			__m128 normalize = _mm_div_ps( _mm_set1_ps( 128 ), _mm_set1_ps( noiseWidth * noiseHeight ) );
-			__m128 wwww = _mm_set1_ps( noiseWidth );
-			__m128 hhhh = _mm_set1_ps( noiseHeight );
-			_CRT_ALIGN(16) float tileNArr[ 4 ];
-
-			unsigned char* curPixel = pixels;
-			float y = startY;
-			int w4 = width / 4;
-			for ( int row = 0; row < height; ++row, y += incY )
+			FAST_TRACE_SCOPE_ARG( "TiledNoiseBitmap", channels );
+
+			//	The lattice wraps at the bitmap edges, so the sample spacing is derived from the rounded period
+			const int periodX = LatticePeriod( noiseWidth );
+			const int periodY = LatticePeriod( noiseHeight );
+			const float incX = float( periodX ) / float( width );
+			const float incY = float( periodY ) / float( height );
+
+			//	The integer part of the start position offsets the lattice hash, the fractional part offsets the samples
+			const float originX = floorf( startX );
+			const float originY = floorf( startY );
+			const __m128i periodXxxx = _mm_set1_epi32( periodX );
+			const __m128i periodYyyy = _mm_set1_epi32( periodY );
+			const __m128i originXxxx = _mm_set1_epi32( int( originX ) );
+			const __m128i originYyyy = _mm_set1_epi32( int( originY ) );
+
+			//	Each channel takes its noise from a different z slice through the lattice
+			const int noiseChannels = independentChannels ? channels : 1;
+			const __m128 channelZzzz[ 4 ] = { _mm_set1_ps( 2.222f ), _mm_set1_ps( 19.222f ), _mm_set1_ps( 36.222f ), _mm_set1_ps( 53.222f ) };
+
+			//	Pixels are stored in lane order (lane 0 is the left-most pixel), so they can be packed straight into memory
+			const __m128 xxxxStart = _mm_add_ps( _mm_set1_ps( startX - originX ), _mm_set_ps( incX * 3, incX * 2, incX, 0 ) );
+			const __m128 xxxxInc = _mm_set1_ps( incX * 4 );
+			const __m128 scale = _mm_set1_ps( 128.0f );
+
+			FAST_ALIGN( 16 ) unsigned char packed[ 16 ];
+
+			unsigned char* rowPixel = pixels;
+			for ( int row = 0; row < height; ++row, rowPixel += stride )
 			{
-				const __m128 wrapYyyy = _mm_set1_ps( y - noiseHeight );
-				const __m128 fYyyy = _mm_set1_ps( y - startY );
-				const __m128 invYyyy = _mm_sub_ps( hhhh, fYyyy );
-				const __m128 yyyy = _mm_set1_ps( y );
-				__m128 xxxx = originXxxx;
-				for ( int col = 0; col < w4; ++col )
+				const __m128 yyyy = _mm_set1_ps( ( startY - originY ) + incY * float( row ) );
+				__m128 xxxx = xxxxStart;
+				unsigned char* curPixel = rowPixel;
+				for ( int col = 0; col < width; col += 4 )
 				{
-					__m128 wrapXxxx = _mm_sub_ps( xxxx, wwww );
-					__m128 fXxxx = _mm_sub_ps( xxxx, _mm_set1_ps( startX ) );
-					__m128 invXxxx= _mm_sub_ps( wwww, fXxxx );
-					__m128 n0 = Noise( xxxx, yyyy, zzzz );
-					__m128 n1 = Noise( wrapXxxx, yyyy, zzzz );
-					__m128 n2 = Noise( wrapXxxx, wrapYyyy, zzzz );
-					__m128 n3 = Noise( xxxx, wrapYyyy, zzzz );
-
-					n0 = _mm_mul_ps( n0, _mm_mul_ps( invXxxx, invYyyy ) );
-					n1 = _mm_mul_ps( n1, _mm_mul_ps( fXxxx, invYyyy ) );
-					n2 = _mm_mul_ps( n2, _mm_mul_ps( fXxxx, fYyyy ) );
-					n3 = _mm_mul_ps( n3, _mm_mul_ps( invXxxx, fYyyy ) );
-
-					const __m128 sumN =_mm_add_ps( _mm_add_ps( n0, n1 ), _mm_add_ps( n2, n3 ) );
-					__m128 tileN = _mm_add_ps( _mm_mul_ps( sumN, normalize ), _mm_set1_ps( 128 ) );
-					tileN = Clamp( tileN, _mm_set1_ps( 0 ), _mm_set1_ps( 256 ) );
-
-					_mm_store_ps( tileNArr, tileN );
-
-					*curPixel = ( unsigned char )( tileNArr[ 3 ] ); curPixel += stride;
-					*curPixel = ( unsigned char )( tileNArr[ 2 ] ); curPixel += stride;
-					*curPixel = ( unsigned char )( tileNArr[ 1 ] ); curPixel += stride;
-					*curPixel = ( unsigned char )( tileNArr[ 0 ] ); curPixel += stride;
-
-					xxxx = _mm_add_ps( xxxx, incXxxx );
+					__m128 c0 = Constants::Fc_0;
+					__m128 c1 = Constants::Fc_0;
+					__m128 c2 = Constants::Fc_0;
+					__m128 c3 = Constants::Fc_0;
+					__m128* values[ 4 ] = { &c0, &c1, &c2, &c3 };
+					for ( int channel = 0; channel < noiseChannels; ++channel )
+					{
+						__m128 noise = PeriodicNoise( xxxx, yyyy, channelZzzz[ channel ], periodXxxx, periodYyyy, originXxxx, originYyyy );
+						*values[ channel ] = _mm_add_ps( _mm_mul_ps( noise, scale ), scale );
+					}
+					for ( int channel = noiseChannels; channel < channels; ++channel )
+					{
+						*values[ channel ] = c0;
+					}
+
+					//	Transpose so that each register holds the channels of one pixel, then pack down to bytes
+					//	(saturation handles the clamp to [0,255])
+					_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+					const __m128i p01 = _mm_packs_epi32( _mm_cvtps_epi32( c0 ), _mm_cvtps_epi32( c1 ) );
+					const __m128i p23 = _mm_packs_epi32( _mm_cvtps_epi32( c2 ), _mm_cvtps_epi32( c3 ) );
+					const __m128i bytes = _mm_packus_epi16( p01, p23 );
+
+					const int numPixels = ( width - col ) < 4 ? ( width - col ) : 4;
+					if ( ( channels == 4 ) && ( numPixels == 4 ) )
+					{
+						_mm_storeu_si128( ( __m128i* )curPixel, bytes );
+						curPixel += 16;
+					}
+					else
+					{
+						_mm_store_si128( ( __m128i* )packed, bytes );
+						for ( int pixel = 0; pixel < numPixels; ++pixel )
+						{
+							for ( int channel = 0; channel < channels; ++channel )
+							{
+								*curPixel++ = packed[ pixel * 4 + channel ];
+							}
+						}
+					}
+
+					xxxx = _mm_add_ps( xxxx, xxxxInc );
 				}
 			}
 		}
@@ -172,35 +202,16 @@ namespace Poc1
 			__m128 zzzz = _mm_set_ps( pVec0[ 2 ], pVec1[ 2 ], pVec2[ 2 ], pVec3[ 2 ] );
 
 			__m128 res = Noise( xxxx, yyyy, zzzz );
-			pResults[ 0 ] = res.m128_f32[ 3 ];
-			pResults[ 1 ] = res.m128_f32[ 2 ];
-			pResults[ 2 ] = res.m128_f32[ 1 ];
-			pResults[ 3 ] = res.m128_f32[ 0 ];
+			pResults[ 0 ] = GetLane( res, 3 );
+			pResults[ 1 ] = GetLane( res, 2 );
+			pResults[ 2 ] = GetLane( res, 1 );
+			pResults[ 3 ] = GetLane( res, 0 );
 		}
 
 		void Poc1::Fast::SseNoise::InitializePerms( const unsigned int seed )
 		{
-			int perms[ 256 ];
-
-			for ( int i = 0; i < 256; ++i )
-			{
-				perms[ i ] = i;
-			}
-			srand( seed );
-			for ( int i = 0; i < 256; ++i )
-			{
-				int index0 = rand( ) & 0xff;
-				int index1 = rand( ) & 0xff;
-
-				int tmp = perms[ index0 ];
-				perms[ index0 ] = perms[ index1 ];
-				perms[ index1 ] = tmp;
-			}
-
-			for ( int i = 0; i < 256; ++i )
-			{
-				m_Perms[ i ] = m_Perms[ i + 256 ] = perms[ i ];
-			}
+			//	Tables are shared between all noise objects with the same seed
+			m_Perms = SsePermutationTables::Get( seed );
 		}
 
 	}; //Fast
@@ -0,0 +1,99 @@
+#include "Stdafx.h"
+#include "Sse/SsePermutationTables.h"
+#include "Mem.h"
+#include "Platform.h"
+
+#include <stdlib.h>
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Registry node. Stores the permutation table for a single seed
+		struct FAST_ALIGN( 64 ) PermutationTableNode
+		{
+			SsePermutationTables::Entry	m_Perms[ SsePermutationTables::TableSize ];
+			unsigned int				m_Seed;
+			PermutationTableNode*		m_Next;
+		};
+
+		///	\brief	Head of the registry list
+		static PermutationTableNode* s_Tables = 0;
+
+		///	\brief	Registry lock. Zero-initialized, so it can be used before any dynamic initializers run
+		static volatile long s_TablesLock = 0;
+
+		///	\brief	Scoped spin lock around s_TablesLock
+		///
+		///	Only taken when noise objects are created or re-seeded, so contention is not an issue.
+		///
+		class TablesLock
+		{
+			public :
+
+				TablesLock( )
+				{
+					while ( Platform::AtomicExchange( &s_TablesLock, 1 ) != 0 )
+					{
+						Platform::YieldThread( );
+					}
+				}
+
+				~TablesLock( )
+				{
+					Platform::AtomicExchange( &s_TablesLock, 0 );
+				}
+		};
+
+		const SsePermutationTables::Entry* SsePermutationTables::Get( const unsigned int seed )
+		{
+			TablesLock lock;
+
+			for ( PermutationTableNode* node = s_Tables; node != 0; node = node->m_Next )
+			{
+				if ( node->m_Seed == seed )
+				{
+					return node->m_Perms;
+				}
+			}
+
+			PermutationTableNode* node = new ( Aligned( 64 ) ) PermutationTableNode;
+			InitializePerms( node->m_Perms, seed );
+			node->m_Seed = seed;
+			node->m_Next = s_Tables;
+			s_Tables = node;
+
+			return node->m_Perms;
+		}
+
+		void SsePermutationTables::InitializePerms( Entry* perms, const unsigned int seed )
+		{
+			int basePerms[ 256 ];
+
+			for ( int i = 0; i < 256; ++i )
+			{
+				basePerms[ i ] = i;
+			}
+
+			//	NOTE: AP: Called under the registry lock, so nothing else in here is using rand() state
+			srand( seed );
+			for ( int i = 0; i < 256; ++i )
+			{
+				int index0 = rand( ) & 0xff;
+				int index1 = rand( ) & 0xff;
+
+				int tmp = basePerms[ index0 ];
+				basePerms[ index0 ] = basePerms[ index1 ];
+				basePerms[ index1 ] = tmp;
+			}
+
+			for ( int i = 0; i < 256; ++i )
+			{
+				perms[ i ] = perms[ i + 256 ] = ( Entry )basePerms[ i ];
+			}
+		}
+
+	}; //Fast
+}; //Poc1
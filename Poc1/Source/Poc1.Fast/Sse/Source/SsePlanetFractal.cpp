@@ -1,3 +1,3 @@
-#include "StdAfx.h"
+#include "Stdafx.h"
 #include "../SsePlanetFractal.h"
 
@@ -0,0 +1,122 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Sse/SseNoise.h"
+#include "Trace.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Point buffer used by bulk evaluation functions
+		///
+		///	Points are either stored as separate x, y and z arrays (SoA), or packed as consecutive xyz triples
+		///	in m_X (AoS). m_Y and m_Z are not used for packed points.
+		///
+		struct SseBulkPoints
+		{
+			const float*	m_X;
+			const float*	m_Y;
+			const float*	m_Z;
+			bool			m_Packed;
+		};
+
+		///	\brief	Bulk evaluation function. Evaluates count points, starting at point index start
+		typedef void ( *SseBulkFunction )( const void* function, const SseBulkPoints& points, float* results, const int start, const int count );
+
+		///	\brief	Loads 4 packed xyz points, and splits them into x, y and z components
+		inline void LoadPackedPoints( const float* points, __m128& xxxx, __m128& yyyy, __m128& zzzz )
+		{
+			const __m128 a = _mm_loadu_ps( points );		//	x0 y0 z0 x1
+			const __m128 b = _mm_loadu_ps( points + 4 );	//	y1 z1 x2 y2
+			const __m128 c = _mm_loadu_ps( points + 8 );	//	z2 x3 y3 z3
+
+			const __m128 x2z2x3 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 0, 2, 2 ) );
+			xxxx = _mm_shuffle_ps( a, x2z2x3, _MM_SHUFFLE( 3, 0, 3, 0 ) );
+
+			const __m128 y0y1 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) );
+			const __m128 y2y3 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) );
+			yyyy = _mm_shuffle_ps( y0y1, y2y3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+			const __m128 z0z1 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+			const __m128 z2z3 = _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) );
+			zzzz = _mm_shuffle_ps( z0z1, z2z3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+		}
+
+		///	\brief	Bulk sample adaptor for noise. Returns values in the range [-1,1]
+		inline __m128 BulkSample( const SseNoise& noise, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz )
+		{
+			return noise.Noise( xxxx, yyyy, zzzz );
+		}
+
+		///	\brief	Bulk sample adaptor for fractals. Returns values in the range [0,1]
+		template < typename FractalType >
+		inline __m128 BulkSample( const FractalType& fractal, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz )
+		{
+			return fractal.GetValue( xxxx, yyyy, zzzz );
+		}
+
+		///	\brief	Evaluates a function at count points, starting at point index start. Points and results are
+		///	stored in lane order, so there are no alignment requirements on either buffer
+		template < typename FunctionType >
+		void SseBulkEvaluate( const FunctionType& function, const SseBulkPoints& points, float* results, const int start, const int count )
+		{
+			FAST_TRACE_SCOPE_ARG( "BulkEvaluate", count );
+
+			const int end = start + count;
+			const int end4 = start + ( count & ~3 );
+			__m128 xxxx, yyyy, zzzz;
+
+			int index = start;
+			if ( points.m_Packed )
+			{
+				for ( ; index < end4; index += 4 )
+				{
+					LoadPackedPoints( points.m_X + index * 3, xxxx, yyyy, zzzz );
+					_mm_storeu_ps( results + index, BulkSample( function, xxxx, yyyy, zzzz ) );
+				}
+			}
+			else
+			{
+				for ( ; index < end4; index += 4 )
+				{
+					xxxx = _mm_loadu_ps( points.m_X + index );
+					yyyy = _mm_loadu_ps( points.m_Y + index );
+					zzzz = _mm_loadu_ps( points.m_Z + index );
+					_mm_storeu_ps( results + index, BulkSample( function, xxxx, yyyy, zzzz ) );
+				}
+			}
+
+			if ( index == end )
+			{
+				return;
+			}
+
+			//	Remaining 1-3 points are copied into a padded buffer
+			FAST_ALIGN( 16 ) float tail[ 3 ][ 4 ] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+			for ( int tailIndex = 0; index + tailIndex < end; ++tailIndex )
+			{
+				const int pt = index + tailIndex;
+				tail[ 0 ][ tailIndex ] = points.m_Packed ? points.m_X[ pt * 3 ] : points.m_X[ pt ];
+				tail[ 1 ][ tailIndex ] = points.m_Packed ? points.m_X[ pt * 3 + 1 ] : points.m_Y[ pt ];
+				tail[ 2 ][ tailIndex ] = points.m_Packed ? points.m_X[ pt * 3 + 2 ] : points.m_Z[ pt ];
+			}
+			FAST_ALIGN( 16 ) float tailResults[ 4 ];
+			_mm_store_ps( tailResults, BulkSample( function, _mm_load_ps( tail[ 0 ] ), _mm_load_ps( tail[ 1 ] ), _mm_load_ps( tail[ 2 ] ) ) );
+			for ( ; index < end; ++index )
+			{
+				results[ index ] = tailResults[ index - end4 ];
+			}
+		}
+
+		///	\brief	SseBulkFunction implementation for a given function type
+		template < typename FunctionType >
+		void SseBulkEvaluateFunction( const void* function, const SseBulkPoints& points, float* results, const int start, const int count )
+		{
+			SseBulkEvaluate( *( const FunctionType* )function, points, results, start, count );
+		}
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -0,0 +1,804 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "SseUtils.h"
+#include "SsePrecision.h"
+#include "SseFunctionBounds.h"
+
+///	\file	Compile-time composition of terrain functions
+///
+///	Each class here combines one or more functions (fractals, heightmaps, or other composites) into a new
+///	function, with the same interface as the fractals: GetValue(), GetSignedValue() and their precision
+///	policy templates, GetBounds() and GetSignedBounds(). A composite can be used wherever a fractal can,
+///	including as the function of SseSphereFunction3dDisplacer and SsePlaneFunction3dDisplacer, so a
+///	composed planet is a single displacer type:
+///
+///		typedef SseLatitudeBlendFunction
+///		<
+///			SseSumFunction< SseRidgedFractal, SseScaleFunction< SseSimpleFractal > >,
+///			SseMaxFunction< SseSimpleFractal, SseRidgedFractal >
+///		> PlanetFunction;
+///		typedef SseSphereTerrainGeneratorT< SseSphereFunction3dDisplacer< PlanetFunction > > PlanetGenerator;
+///
+///	Composites hold their functions by value, and every method is inline, so the compiler sees the whole
+///	expression and generates one kernel for it. There are no virtual calls, and the displacer maps positions
+///	into function space once for the whole expression. Each composite only adds its own arithmetic, except
+///	for SseWarpFunction, which evaluates its warp function 3 times.
+///
+///	Composites combine function values (GetValue()). Their GetSignedValue() is GetValue() * 2 - 1, as for
+///	SseRidgedFractal, except for SseWarpFunction, which passes GetSignedValue() through to its function.
+///	Poc1.Fast/Scalar/ScalarCompositeFunctions.h has the scalar reference implementations.
+///
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Maps 4 function values in the range [0,1] onto the range [-1,1]
+		inline __m128 GetSignedValues( const __m128& values )
+		{
+			return _mm_sub_ps( _mm_mul_ps( values, Constants::Fc_2 ), Constants::Fc_1 );
+		}
+
+		///	\brief	Blends between 2 sets of 4 values. Returns first where t is 0, and second where t is 1, exactly
+		inline __m128 Blend( const __m128& t, const __m128& first, const __m128& second )
+		{
+			return _mm_add_ps( _mm_mul_ps( first, _mm_sub_ps( Constants::Fc_1, t ) ), _mm_mul_ps( second, t ) );
+		}
+
+		///	\brief	Composite function. Adds the values of 2 functions
+		template < typename FirstFunction, typename SecondFunction >
+		class FAST_ALIGN( 16 ) SseSumFunction
+		{
+			public :
+
+				///	\brief	Gets the first function
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the first function
+				const FirstFunction& GetFirst( ) const
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the second function
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets the second function
+				const SecondFunction& GetSecond( ) const
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return _mm_add_ps( m_First.template GetValue< Precision >( xxxx, yyyy, zzzz ), m_Second.template GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1], using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValues( GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1]
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					float minSecond, maxSecond;
+					m_First.GetBounds( region, minValue, maxValue, samples );
+					m_Second.GetBounds( region, minSecond, maxSecond, samples );
+					minValue += minSecond;
+					maxValue += maxSecond;
+					FunctionBounds::Widen( minValue, maxValue );
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					GetBounds( region, minValue, maxValue, samples );
+					minValue = minValue * 2 - 1;
+					maxValue = maxValue * 2 - 1;
+				}
+
+			private :
+
+				FAST_ALIGN( 16 ) FirstFunction	m_First;
+				FAST_ALIGN( 16 ) SecondFunction	m_Second;
+		};
+
+		///	\brief	Composite function. Scales and offsets the values of a function
+		template < typename FunctionType >
+		class FAST_ALIGN( 16 ) SseScaleFunction
+		{
+			public :
+
+				///	\brief	Sets up a function that returns the values of its function unchanged
+				SseScaleFunction( )
+				{
+					SetScale( 1, 0 );
+				}
+
+				///	\brief	Gets the scaled function
+				FunctionType& GetFunction( )
+				{
+					return m_Function;
+				}
+
+				///	\brief	Gets the scaled function
+				const FunctionType& GetFunction( ) const
+				{
+					return m_Function;
+				}
+
+				///	\brief	Sets the scale and offset. Values are value * scale + offset
+				void SetScale( const float scale, const float offset )
+				{
+					m_Scale = _mm_set1_ps( scale );
+					m_Offset = _mm_set1_ps( offset );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return _mm_add_ps( _mm_mul_ps( m_Function.template GetValue< Precision >( xxxx, yyyy, zzzz ), m_Scale ), m_Offset );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1], using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValues( GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1]
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					m_Function.GetBounds( region, minValue, maxValue, samples );
+					FunctionBounds::Scale( minValue, maxValue, GetLane( m_Scale, 0 ) );
+					minValue += GetLane( m_Offset, 0 );
+					maxValue += GetLane( m_Offset, 0 );
+					FunctionBounds::Widen( minValue, maxValue );
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					GetBounds( region, minValue, maxValue, samples );
+					minValue = minValue * 2 - 1;
+					maxValue = maxValue * 2 - 1;
+				}
+
+			private :
+
+				__m128							m_Scale;
+				__m128							m_Offset;
+				FAST_ALIGN( 16 ) FunctionType	m_Function;
+		};
+
+		///	\brief	Composite function. Returns the larger of the values of 2 functions
+		template < typename FirstFunction, typename SecondFunction >
+		class FAST_ALIGN( 16 ) SseMaxFunction
+		{
+			public :
+
+				///	\brief	Gets the first function
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the first function
+				const FirstFunction& GetFirst( ) const
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the second function
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets the second function
+				const SecondFunction& GetSecond( ) const
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return _mm_max_ps( m_First.template GetValue< Precision >( xxxx, yyyy, zzzz ), m_Second.template GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1], using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValues( GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1]
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					float minSecond, maxSecond;
+					m_First.GetBounds( region, minValue, maxValue, samples );
+					m_Second.GetBounds( region, minSecond, maxSecond, samples );
+					minValue = minSecond > minValue ? minSecond : minValue;
+					maxValue = maxSecond > maxValue ? maxSecond : maxValue;
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					GetBounds( region, minValue, maxValue, samples );
+					minValue = minValue * 2 - 1;
+					maxValue = maxValue * 2 - 1;
+				}
+
+			private :
+
+				FAST_ALIGN( 16 ) FirstFunction	m_First;
+				FAST_ALIGN( 16 ) SecondFunction	m_Second;
+		};
+
+		///	\brief	Composite function. Returns the smaller of the values of 2 functions
+		template < typename FirstFunction, typename SecondFunction >
+		class FAST_ALIGN( 16 ) SseMinFunction
+		{
+			public :
+
+				///	\brief	Gets the first function
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the first function
+				const FirstFunction& GetFirst( ) const
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the second function
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets the second function
+				const SecondFunction& GetSecond( ) const
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return _mm_min_ps( m_First.template GetValue< Precision >( xxxx, yyyy, zzzz ), m_Second.template GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1], using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValues( GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1]
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					float minSecond, maxSecond;
+					m_First.GetBounds( region, minValue, maxValue, samples );
+					m_Second.GetBounds( region, minSecond, maxSecond, samples );
+					minValue = minSecond < minValue ? minSecond : minValue;
+					maxValue = maxSecond < maxValue ? maxSecond : maxValue;
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					GetBounds( region, minValue, maxValue, samples );
+					minValue = minValue * 2 - 1;
+					maxValue = maxValue * 2 - 1;
+				}
+
+			private :
+
+				FAST_ALIGN( 16 ) FirstFunction	m_First;
+				FAST_ALIGN( 16 ) SecondFunction	m_Second;
+		};
+
+		///	\brief	Composite function. Evaluates a function at positions moved by a warp function (domain warping)
+		///
+		///	Each position is moved by the signed values of the warp function, times the amplitude. The offsets
+		///	along y and z come from the warp function at fixed offsets from the position, so the 3 offsets are
+		///	uncorrelated.
+		///
+		template < typename WarpFunction, typename FunctionType >
+		class FAST_ALIGN( 16 ) SseWarpFunction
+		{
+			public :
+
+				///	\brief	Sets up a function with a warp amplitude of 0.1
+				SseWarpFunction( )
+				{
+					m_YOffset = _mm_set1_ps( 3.14f );
+					m_ZOffset = _mm_set1_ps( 6.28f );
+					SetAmplitude( 0.1f );
+				}
+
+				///	\brief	Gets the warp function
+				WarpFunction& GetWarp( )
+				{
+					return m_Warp;
+				}
+
+				///	\brief	Gets the warp function
+				const WarpFunction& GetWarp( ) const
+				{
+					return m_Warp;
+				}
+
+				///	\brief	Gets the warped function
+				FunctionType& GetFunction( )
+				{
+					return m_Function;
+				}
+
+				///	\brief	Gets the warped function
+				const FunctionType& GetFunction( ) const
+				{
+					return m_Function;
+				}
+
+				///	\brief	Sets the largest distance that positions are moved along each axis (for warp functions with signed values in [-1,1])
+				void SetAmplitude( const float amplitude )
+				{
+					m_Amplitude = _mm_set1_ps( amplitude );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					__m128 warpXxxx, warpYyyy, warpZzzz;
+					Warp< Precision >( xxxx, yyyy, zzzz, warpXxxx, warpYyyy, warpZzzz );
+					return m_Function.template GetValue< Precision >( warpXxxx, warpYyyy, warpZzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 signed function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					__m128 warpXxxx, warpYyyy, warpZzzz;
+					Warp< Precision >( xxxx, yyyy, zzzz, warpXxxx, warpYyyy, warpZzzz );
+					return m_Function.template GetSignedValue< Precision >( warpXxxx, warpYyyy, warpZzzz );
+				}
+
+				///	\brief	Gets 4 signed function values from 4 points
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					m_Function.GetBounds( GetWarpedRegion( region, samples ), minValue, maxValue, samples );
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					m_Function.GetSignedBounds( GetWarpedRegion( region, samples ), minValue, maxValue, samples );
+				}
+
+			private :
+
+				__m128							m_YOffset;
+				__m128							m_ZOffset;
+				__m128							m_Amplitude;
+				FAST_ALIGN( 16 ) WarpFunction	m_Warp;
+				FAST_ALIGN( 16 ) FunctionType	m_Function;
+
+				///	\brief	Moves 4 positions by the warp function
+				template < typename Precision >
+				inline void Warp( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128& warpXxxx, __m128& warpYyyy, __m128& warpZzzz ) const
+				{
+					const __m128 offsetXxxx = m_Warp.template GetSignedValue< Precision >( xxxx, yyyy, zzzz );
+					const __m128 offsetYyyy = m_Warp.template GetSignedValue< Precision >( _mm_add_ps( xxxx, m_YOffset ), yyyy, zzzz );
+					const __m128 offsetZzzz = m_Warp.template GetSignedValue< Precision >( xxxx, yyyy, _mm_add_ps( zzzz, m_ZOffset ) );
+					warpXxxx = _mm_add_ps( xxxx, _mm_mul_ps( offsetXxxx, m_Amplitude ) );
+					warpYyyy = _mm_add_ps( yyyy, _mm_mul_ps( offsetYyyy, m_Amplitude ) );
+					warpZzzz = _mm_add_ps( zzzz, _mm_mul_ps( offsetZzzz, m_Amplitude ) );
+				}
+
+				///	\brief	Gets the region that Warp() can move positions in a region to
+				SseFunctionRegion GetWarpedRegion( const SseFunctionRegion& region, const int samples ) const
+				{
+					const float amplitude = GetLane( m_Amplitude, 0 );
+					float minOffset[ 3 ], maxOffset[ 3 ];
+					m_Warp.GetSignedBounds( region, minOffset[ 0 ], maxOffset[ 0 ], samples );
+					SseFunctionRegion offsetRegion( region );
+					offsetRegion.Offset( GetLane( m_YOffset, 0 ), 0, 0 );
+					m_Warp.GetSignedBounds( offsetRegion, minOffset[ 1 ], maxOffset[ 1 ], samples );
+					offsetRegion = region;
+					offsetRegion.Offset( 0, 0, GetLane( m_ZOffset, 0 ) );
+					m_Warp.GetSignedBounds( offsetRegion, minOffset[ 2 ], maxOffset[ 2 ], samples );
+
+					float minimum[ 3 ], maximum[ 3 ];
+					for ( int axis = 0; axis < 3; ++axis )
+					{
+						FunctionBounds::Scale( minOffset[ axis ], maxOffset[ axis ], amplitude );
+						minimum[ axis ] = region.GetMinimum( )[ axis ] + minOffset[ axis ];
+						maximum[ axis ] = region.GetMaximum( )[ axis ] + maxOffset[ axis ];
+					}
+					return SseFunctionRegion( minimum, maximum );
+				}
+		};
+
+		///	\brief	Composite function. Selects between 2 functions, from the value of a control function
+		///
+		///	Returns the first function where the control value is below threshold - falloff, the second where it
+		///	is above threshold + falloff, and a smooth blend of the 2 in between. A function is only evaluated if
+		///	one of the 4 positions needs it.
+		///
+		template < typename ControlFunction, typename FirstFunction, typename SecondFunction >
+		class FAST_ALIGN( 16 ) SseSelectFunction
+		{
+			public :
+
+				///	\brief	Sets up a function that selects at a control value of 0.5, with a falloff of 0.1
+				SseSelectFunction( )
+				{
+					SetThreshold( 0.5f, 0.1f );
+				}
+
+				///	\brief	Gets the control function
+				ControlFunction& GetControl( )
+				{
+					return m_Control;
+				}
+
+				///	\brief	Gets the control function
+				const ControlFunction& GetControl( ) const
+				{
+					return m_Control;
+				}
+
+				///	\brief	Gets the function used below the threshold
+				FirstFunction& GetFirst( )
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the function used below the threshold
+				const FirstFunction& GetFirst( ) const
+				{
+					return m_First;
+				}
+
+				///	\brief	Gets the function used above the threshold
+				SecondFunction& GetSecond( )
+				{
+					return m_Second;
+				}
+
+				///	\brief	Gets the function used above the threshold
+				const SecondFunction& GetSecond( ) const
+				{
+					return m_Second;
+				}
+
+				///	\brief	Sets the control value that the selection is made at, and the control distance either side of it that the functions are blended over
+				///
+				///	Falloffs are at least MinFalloff.
+				///
+				void SetThreshold( const float threshold, const float falloff )
+				{
+					const float width = ( falloff > MinFalloff ? falloff : MinFalloff ) * 2;
+					m_Lower = _mm_set1_ps( threshold - width * 0.5f );
+					m_InvWidth = _mm_set1_ps( 1 / width );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					const __m128 t = GetBlend< Precision >( xxxx, yyyy, zzzz );
+					if ( _mm_movemask_ps( _mm_cmpgt_ps( t, Constants::Fc_0 ) ) == 0 )
+					{
+						return m_First.template GetValue< Precision >( xxxx, yyyy, zzzz );
+					}
+					if ( _mm_movemask_ps( _mm_cmplt_ps( t, Constants::Fc_1 ) ) == 0 )
+					{
+						return m_Second.template GetValue< Precision >( xxxx, yyyy, zzzz );
+					}
+					return Blend( t, m_First.template GetValue< Precision >( xxxx, yyyy, zzzz ), m_Second.template GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1], using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValues( GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1]
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					//	Blends are between the 2 functions, so they are inside the union of their bounds
+					float minControl, maxControl;
+					m_Control.GetBounds( region, minControl, maxControl, samples );
+					const float lower = GetLane( m_Lower, 0 );
+					const float upper = lower + 1 / GetLane( m_InvWidth, 0 );
+					if ( maxControl < lower )
+					{
+						m_First.GetBounds( region, minValue, maxValue, samples );
+					}
+					else if ( minControl > upper )
+					{
+						m_Second.GetBounds( region, minValue, maxValue, samples );
+					}
+					else
+					{
+						float minSecond, maxSecond;
+						m_First.GetBounds( region, minValue, maxValue, samples );
+						m_Second.GetBounds( region, minSecond, maxSecond, samples );
+						FunctionBounds::Union( minValue, maxValue, minSecond, maxSecond );
+					}
+					FunctionBounds::Widen( minValue, maxValue );
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					GetBounds( region, minValue, maxValue, samples );
+					minValue = minValue * 2 - 1;
+					maxValue = maxValue * 2 - 1;
+				}
+
+				///	\brief	Smallest falloff. Keeps the blend width away from 0
+				static const float MinFalloff;
+
+			private :
+
+				__m128							m_Lower;		///<	Control value where the blend starts
+				__m128							m_InvWidth;		///<	1 / ( 2 * falloff )
+				FAST_ALIGN( 16 ) ControlFunction	m_Control;
+				FAST_ALIGN( 16 ) FirstFunction	m_First;
+				FAST_ALIGN( 16 ) SecondFunction	m_Second;
+
+				///	\brief	Gets the weights of the second function at 4 points
+				template < typename Precision >
+				inline __m128 GetBlend( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					const __m128 control = m_Control.template GetValue< Precision >( xxxx, yyyy, zzzz );
+					return SmoothStep( Clamp( _mm_mul_ps( _mm_sub_ps( control, m_Lower ), m_InvWidth ), Constants::Fc_0, Constants::Fc_1 ) );
+				}
+		};
+
+		template < typename ControlFunction, typename FirstFunction, typename SecondFunction >
+		const float SseSelectFunction< ControlFunction, FirstFunction, SecondFunction >::MinFalloff = 1e-4f;
+
+		///	\brief	Composite function. Blends between an equatorial and a polar function, by latitude
+		///
+		///	Latitudes are measured as |y| / length, so 0 is the equator and 1 is a pole, as for the bands of
+		///	LatitudeTerrainFunction. Below the start latitude the equatorial function is used, above the end
+		///	latitude the polar function, and the 2 are smoothly blended in between. A function is only evaluated
+		///	if one of the 4 positions needs it.
+		///
+		template < typename EquatorFunction, typename PoleFunction >
+		class FAST_ALIGN( 16 ) SseLatitudeBlendFunction
+		{
+			public :
+
+				///	\brief	Sets up a function that blends between latitudes 0.6 and 0.8
+				SseLatitudeBlendFunction( )
+				{
+					SetLatitudes( 0.6f, 0.8f );
+				}
+
+				///	\brief	Gets the function used at the equator
+				EquatorFunction& GetEquator( )
+				{
+					return m_Equator;
+				}
+
+				///	\brief	Gets the function used at the equator
+				const EquatorFunction& GetEquator( ) const
+				{
+					return m_Equator;
+				}
+
+				///	\brief	Gets the function used at the poles
+				PoleFunction& GetPole( )
+				{
+					return m_Pole;
+				}
+
+				///	\brief	Gets the function used at the poles
+				const PoleFunction& GetPole( ) const
+				{
+					return m_Pole;
+				}
+
+				///	\brief	Sets the latitudes (in [0,1]) that the blend starts and ends at. The end must be above the start
+				void SetLatitudes( const float start, const float end )
+				{
+					m_Start = _mm_set1_ps( start );
+					m_InvRange = _mm_set1_ps( 1 / ( end - start ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, using a given precision policy
+				template < typename Precision >
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					const __m128 t = GetBlend< Precision >( xxxx, yyyy, zzzz );
+					if ( _mm_movemask_ps( _mm_cmpgt_ps( t, Constants::Fc_0 ) ) == 0 )
+					{
+						return m_Equator.template GetValue< Precision >( xxxx, yyyy, zzzz );
+					}
+					if ( _mm_movemask_ps( _mm_cmplt_ps( t, Constants::Fc_1 ) ) == 0 )
+					{
+						return m_Pole.template GetValue< Precision >( xxxx, yyyy, zzzz );
+					}
+					return Blend( t, m_Equator.template GetValue< Precision >( xxxx, yyyy, zzzz ), m_Pole.template GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points
+				inline __m128 GetValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1], using a given precision policy
+				template < typename Precision >
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValues( GetValue< Precision >( xxxx, yyyy, zzzz ) );
+				}
+
+				///	\brief	Gets 4 function values from 4 points, mapped from [0,1] to [-1,1]
+				inline __m128 GetSignedValue( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+				}
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					//	Latitudes in the region range from the smallest |y| at the largest length, to the largest |y| at the smallest length
+					const float minY = region.GetMinimum( )[ 1 ];
+					const float maxY = region.GetMaximum( )[ 1 ];
+					const float minLength = region.GetMinimumLength( );
+					const float minLatitude = FunctionBounds::GetMinMagnitude( minY, maxY ) / region.GetMaximumLength( );
+					const float maxLatitude = minLength > 0 ? FunctionBounds::GetMaxMagnitude( minY, maxY ) / minLength : 1;
+					const float start = GetLane( m_Start, 0 );
+					const float end = start + 1 / GetLane( m_InvRange, 0 );
+					if ( maxLatitude < start )
+					{
+						m_Equator.GetBounds( region, minValue, maxValue, samples );
+					}
+					else if ( minLatitude > end )
+					{
+						m_Pole.GetBounds( region, minValue, maxValue, samples );
+					}
+					else
+					{
+						float minPole, maxPole;
+						m_Equator.GetBounds( region, minValue, maxValue, samples );
+						m_Pole.GetBounds( region, minPole, maxPole, samples );
+						FunctionBounds::Union( minValue, maxValue, minPole, maxPole );
+					}
+					FunctionBounds::Widen( minValue, maxValue );
+				}
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const
+				{
+					GetBounds( region, minValue, maxValue, samples );
+					minValue = minValue * 2 - 1;
+					maxValue = maxValue * 2 - 1;
+				}
+
+			private :
+
+				__m128							m_Start;		///<	Latitude that the blend starts at
+				__m128							m_InvRange;		///<	1 / ( end - start )
+				FAST_ALIGN( 16 ) EquatorFunction	m_Equator;
+				FAST_ALIGN( 16 ) PoleFunction	m_Pole;
+
+				///	\brief	Gets the weights of the polar function at 4 points
+				template < typename Precision >
+				inline __m128 GetBlend( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+				{
+					//	Zero length positions have NaN latitudes, which Clamp() maps to 1
+					const __m128 latitude = Precision::Div( Abs( yyyy ), GetLengths< Precision >( xxxx, yyyy, zzzz ) );
+					return SmoothStep( Clamp( _mm_mul_ps( _mm_sub_ps( latitude, m_Start ), m_InvRange ), Constants::Fc_0, Constants::Fc_1 ) );
+				}
+		};
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -47,7 +47,9 @@ namespace Poc1
 			///	Trying to initialize directly causes the following warning, followed by error:
 			///	warning C4793: 'aligned data types not supported in managed code' : causes native code generation for function '`dynamic initializer for 'Poc1::Fast::Constants::Ic_FF'''
 			///
-			///	InitializeConstants() is called by the SseNoise constructor
+			///	In the mixed-mode assembly, InitializeConstants() is called from DllMain. Native builds (the
+			///	static library) call it from a dynamic initializer in SseConstants.cpp. The SseNoise constructor
+			///	also calls it.
 			///
 			static void InitializeConstants( );
 		};
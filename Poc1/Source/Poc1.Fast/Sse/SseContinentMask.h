@@ -0,0 +1,220 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "SseUtils.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Cube map of the low octave ("continent") noise values of a planet fractal
+		///
+		///	The low octaves of SsePlanetFractal vary over thousands of kilometres, and are the same for every
+		///	patch generated on a planet. Bake() evaluates their noise values once, at the vertices of a
+		///	resolution x resolution grid on each cube face, at a given radius. Sample() bilinearly interpolates
+		///	the baked values for 4 directions, so SsePlanetFractal::GetValue() only has to evaluate the high
+		///	octaves per sample.
+		///
+		///	The raw noise values are stored, rather than the accumulated fractal value, because they are smooth.
+		///	The ridges (1-|n|)^2 that SsePlanetFractal builds from them are not, and interpolate badly.
+		///	Texels on face edges are baked from the same directions as the matching texels on the neighbouring
+		///	faces, so sampling is continuous across cube face seams.
+		///
+		///	Masks are not baked automatically. SsePlanetFractal is not one of the terrain function types that
+		///	TerrainFunction::CreateGenerator() builds, so whoever sets up a planet fractal also has to bake its mask
+		///	(at the function scale of its displacer) and pass it to SsePlanetFractal::SetContinentMask().
+		///
+		class FAST_ALIGN( 16 ) SseContinentMask
+		{
+			public :
+
+				///	\brief	Maximum number of octaves that can be baked
+				enum { MaxOctaves = 8 };
+
+				///	\brief	Sets up an empty mask
+				SseContinentMask( );
+
+				///	\brief	Releases the mask texels
+				~SseContinentMask( );
+
+				///	\brief	Bakes the low octaves of a fractal, on a sphere of a given radius (the function scale of the displacer using the fractal)
+				template < typename Precision, typename FractalType >
+				void Bake( const FractalType& fractal, const float radius, const int resolution );
+
+				///	\brief	Returns true if Bake() has been called
+				bool IsBaked( ) const;
+
+				///	\brief	Gets the number of texels along each side of a cube face
+				int GetResolution( ) const;
+
+				///	\brief	Gets the number of octaves stored in each texel
+				int GetOctaves( ) const;
+
+				///	\brief	Gets the size of the baked texels, in bytes
+				int GetSizeInBytes( ) const;
+
+				///	\brief	Gets the radius of the sphere that the mask was baked on
+				float GetRadius( ) const;
+
+				///	\brief	Gets the largest distance between a point on the mask sphere, and the texels that Sample() interpolates between for it
+				///
+				///	Sample() interpolates between the corners of a texel cell on a cube face. Projecting the face onto the
+				///	sphere does not stretch distances, so this is the cell diagonal, at the mask radius.
+				///
+				float GetMaxTexelDistance( ) const;
+
+				///	\brief	Samples the low octave noise values in the direction of 4 (x,y,z) vectors. Writes GetOctaves() values to noise
+				template < typename Precision >
+				void Sample( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128* noise ) const;
+
+			private :
+
+				__m128	m_HalfSize;		///<	( resolution - 1 ) / 2, maps the range [-1,1] onto texel coordinates
+				__m128	m_MaxTexel;		///<	resolution - 1
+				float*	m_Texels;		///<	6 faces of resolution x resolution texels. Each texel stores m_Octaves noise values
+				float	m_Radius;		///<	Radius of the sphere that the mask was baked on
+				int		m_Resolution;	///<	Number of texels along each side of a cube face
+				int		m_Octaves;		///<	Number of noise values stored in each texel
+
+				///	\brief	Reallocates the texel array
+				void Allocate( const int resolution, const int octaves );
+
+				///	\brief	Not copyable
+				SseContinentMask( const SseContinentMask& );
+
+				///	\brief	Not copyable
+				SseContinentMask& operator = ( const SseContinentMask& );
+		};
+
+		//	--------------------------------------------------------- SseContinentMask Inline Methods
+
+		inline bool SseContinentMask::IsBaked( ) const
+		{
+			return m_Texels != 0;
+		}
+
+		inline int SseContinentMask::GetResolution( ) const
+		{
+			return m_Resolution;
+		}
+
+		inline int SseContinentMask::GetOctaves( ) const
+		{
+			return m_Octaves;
+		}
+
+		inline int SseContinentMask::GetSizeInBytes( ) const
+		{
+			return m_Resolution * m_Resolution * 6 * m_Octaves * sizeof( float );
+		}
+
+		inline float SseContinentMask::GetRadius( ) const
+		{
+			return m_Radius;
+		}
+
+		inline float SseContinentMask::GetMaxTexelDistance( ) const
+		{
+			//	Cells are 2/(resolution-1) wide on a face that spans [-1,1]. 2.83 rounds up 2*sqrt(2)
+			return m_Radius * 2.83f / float( m_Resolution - 1 );
+		}
+
+		template < typename Precision, typename FractalType >
+		inline void SseContinentMask::Bake( const FractalType& fractal, const float radius, const int resolution )
+		{
+			Allocate( resolution, fractal.GetLowOctaves( ) );
+			m_Radius = radius;
+
+			const __m128 radiusRrrr = _mm_set1_ps( radius );
+			const float inc = 2.0f / float( m_Resolution - 1 );
+			const __m128 uuuuInc = _mm_set1_ps( inc * 4 );
+			const __m128 uuuuStart = _mm_add_ps( Constants::Fc_Neg1, _mm_set_ps( inc * 3, inc * 2, inc, 0 ) );
+
+			FAST_ALIGN( 16 ) float values[ MaxOctaves ][ 4 ];
+			for ( int face = 0; face < 6; ++face )
+			{
+				for ( int row = 0; row < m_Resolution; ++row )
+				{
+					const int rowStart = ( face * m_Resolution + row ) * m_Resolution;
+					const __m128 vvvv = _mm_set1_ps( -1.0f + inc * float( row ) );
+					__m128 uuuu = uuuuStart;
+					for ( int col = 0; col < m_Resolution; col += 4 )
+					{
+						__m128 xxxx, yyyy, zzzz;
+						CubeFacePosition( UCubeMapFace( face ), uuuu, vvvv, xxxx, yyyy, zzzz );
+						SetLength< Precision >( xxxx, yyyy, zzzz, radiusRrrr );
+
+						__m128 noise[ MaxOctaves ];
+						fractal.template GetContinentNoise< Precision >( xxxx, yyyy, zzzz, noise );
+						for ( int octave = 0; octave < m_Octaves; ++octave )
+						{
+							_mm_store_ps( values[ octave ], noise[ octave ] );
+						}
+
+						//	The last block of a row can run past the edge of the face
+						for ( int lane = 0; ( lane < 4 ) && ( col + lane < m_Resolution ); ++lane )
+						{
+							float* texel = m_Texels + ( rowStart + col + lane ) * m_Octaves;
+							for ( int octave = 0; octave < m_Octaves; ++octave )
+							{
+								texel[ octave ] = values[ octave ][ lane ];
+							}
+						}
+						uuuu = _mm_add_ps( uuuu, uuuuInc );
+					}
+				}
+			}
+		}
+
+		template < typename Precision >
+		inline void SseContinentMask::Sample( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128* noise ) const
+		{
+			__m128 faces, uuuu, vvvv, major;
+			GetCubeFaceCoordinates( xxxx, yyyy, zzzz, faces, uuuu, vvvv, major );
+
+			//	Map [-1,1] onto texel coordinates. The last texel on each axis shares the last cell
+			const __m128 recipMajor = Precision::Div( m_HalfSize, major );
+			uuuu = Clamp( _mm_add_ps( _mm_mul_ps( uuuu, recipMajor ), m_HalfSize ), Constants::Fc_0, m_MaxTexel );
+			vvvv = Clamp( _mm_add_ps( _mm_mul_ps( vvvv, recipMajor ), m_HalfSize ), Constants::Fc_0, m_MaxTexel );
+			const __m128 maxCell = _mm_sub_ps( m_MaxTexel, Constants::Fc_1 );
+			const __m128 cellU = _mm_min_ps( _mm_cvtepi32_ps( _mm_cvttps_epi32( uuuu ) ), maxCell );
+			const __m128 cellV = _mm_min_ps( _mm_cvtepi32_ps( _mm_cvttps_epi32( vvvv ) ), maxCell );
+			const __m128 tU = _mm_sub_ps( uuuu, cellU );
+			const __m128 tV = _mm_sub_ps( vvvv, cellV );
+
+			//	SSE2 has no gather, so the 4 corners of each cell are fetched one lane at a time
+			const __m128 resolution = _mm_set1_ps( float( m_Resolution ) );
+			const __m128i offsets = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( faces, resolution ), cellV ), resolution ), cellU ) );
+			FAST_ALIGN( 16 ) int texels[ 4 ];
+			FAST_ALIGN( 16 ) float corners[ MaxOctaves ][ 4 ][ 4 ];
+			_mm_store_si128( ( __m128i* )texels, offsets );
+			const int rowStride = m_Resolution * m_Octaves;
+			for ( int lane = 0; lane < 4; ++lane )
+			{
+				const float* texel = m_Texels + texels[ lane ] * m_Octaves;
+				for ( int octave = 0; octave < m_Octaves; ++octave )
+				{
+					corners[ octave ][ 0 ][ lane ] = texel[ octave ];
+					corners[ octave ][ 1 ][ lane ] = texel[ m_Octaves + octave ];
+					corners[ octave ][ 2 ][ lane ] = texel[ rowStride + octave ];
+					corners[ octave ][ 3 ][ lane ] = texel[ rowStride + m_Octaves + octave ];
+				}
+			}
+
+			for ( int octave = 0; octave < m_Octaves; ++octave )
+			{
+				noise[ octave ] = Lerp
+					(
+						tV,
+						Lerp( tU, _mm_load_ps( corners[ octave ][ 0 ] ), _mm_load_ps( corners[ octave ][ 1 ] ) ),
+						Lerp( tU, _mm_load_ps( corners[ octave ][ 2 ] ), _mm_load_ps( corners[ octave ][ 3 ] ) )
+					);
+			}
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
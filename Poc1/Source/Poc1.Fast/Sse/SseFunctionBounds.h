@@ -0,0 +1,220 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "SseNoise.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Axis-aligned box of function input positions
+		///
+		///	The fractal GetBounds() methods (and the terrain displacer GetHeightBounds() methods) get the range of
+		///	values that a function can return for any position inside a region, without evaluating the function
+		///	at every position.
+		///
+		class SseFunctionRegion
+		{
+			public :
+
+				///	\brief	Sets up an empty region. Add() positions to grow it
+				SseFunctionRegion( );
+
+				///	\brief	Sets up a region from its minimum and maximum corners
+				SseFunctionRegion( const float* minimum, const float* maximum );
+
+				///	\brief	Returns true if no positions have been added to this region
+				bool IsEmpty( ) const;
+
+				///	\brief	Returns true if a position is inside this region
+				bool Contains( const float x, const float y, const float z ) const;
+
+				///	\brief	Gets the minimum corner of this region
+				const float* GetMinimum( ) const;
+
+				///	\brief	Gets the maximum corner of this region
+				const float* GetMaximum( ) const;
+
+				///	\brief	Gets the distance from the origin to the nearest position in this region
+				float GetMinimumLength( ) const;
+
+				///	\brief	Gets the distance from the origin to the furthest position in this region
+				float GetMaximumLength( ) const;
+
+				///	\brief	Grows this region to include a position
+				void Add( const float x, const float y, const float z );
+
+				///	\brief	Grows this region by a distance along each axis, in both directions
+				void Expand( const float distance );
+
+				///	\brief	Moves this region
+				void Offset( const float x, const float y, const float z );
+
+				///	\brief	Scales this region about the origin
+				void Scale( const float scale );
+
+				///	\brief	Shrinks this region to its overlap with another region
+				void Intersect( const SseFunctionRegion& region );
+
+			private :
+
+				float m_Min[ 3 ];
+				float m_Max[ 3 ];
+		};
+
+		///	\brief	Interval arithmetic helpers for the fractal GetBounds() methods
+		///
+		///	Bounds are computed for values at full precision (SseExactPrecision). The approximate precision policies
+		///	can return values outside the bounds by up to their approximation error.
+		///
+		namespace FunctionBounds
+		{
+			///	\brief	Largest magnitude returned by SseNoise::Noise()
+			///
+			///	The gradient noise is not quite normalized: the largest possible value, over every choice of corner
+			///	gradients, is 1.0364 before SseNoise divides it by 0.888.
+			///
+			const float NoiseMaxValue = 1.17f;
+
+			///	\brief	Largest change in SseNoise::Noise() per unit distance along one axis
+			///
+			///	The steepest possible slope along an axis, over every choice of corner gradients, is 3.75 before
+			///	SseNoise divides by 0.888. The change between two points is bounded by this, times the sum of their
+			///	distances along each axis.
+			///
+			const float NoiseMaxSlope = 4.25f;
+
+			///	\brief	Largest second derivative of SseNoise::Noise() along a unit vector
+			///
+			///	The largest possible second derivative along any direction, over every choice of corner gradients, is
+			///	14.3 before SseNoise divides by 0.888.
+			///
+			const float NoiseMaxCurvature = 16.5f;
+
+			///	\brief	Default number of samples along each axis of a region
+			const int DefaultSamples = 4;
+
+			///	\brief	Largest number of octaves that GetNoiseOctaveBounds() will sample
+			const int MaxOctaves = 32;
+
+			///	\brief	Ranges of the basis noise of each octave of a fractal. Octaves past MaxOctaves have the full noise range
+			class OctaveBounds
+			{
+				public :
+
+					///	\brief	Gets the smallest noise value of an octave
+					float GetMin( const int octave ) const
+					{
+						return octave < MaxOctaves ? m_Min[ octave ] : -NoiseMaxValue;
+					}
+
+					///	\brief	Gets the largest noise value of an octave
+					float GetMax( const int octave ) const
+					{
+						return octave < MaxOctaves ? m_Max[ octave ] : NoiseMaxValue;
+					}
+
+					float m_Min[ MaxOctaves ];
+					float m_Max[ MaxOctaves ];
+			};
+
+			///	\brief	Gets the range of the basis noise of the first octaves octaves of a fractal, over a region
+			///
+			///	The noise of octave n is evaluated at the centres of samples^3 cells covering the region, scaled by
+			///	freq^n, and the range of the samples is widened by the furthest the noise can change inside a cell.
+			///	Once that exceeds the noise range, the remaining octaves are not sampled.
+			///
+			void GetNoiseOctaveBounds( const SseNoise& noise, const SseFunctionRegion& region, const float freq, const int octaves, const int samples, OctaveBounds& bounds );
+
+			///	\brief	Gets the range of (1-|n|)^2, the ridge function of the ridged fractals, for n in [minNoise,maxNoise]
+			void GetRidgeBounds( const float minNoise, const float maxNoise, float& minSignal, float& maxSignal );
+
+			///	\brief	Gets the range of the values of a ridged fractal (SseRidgedFractal, SsePlanetFractal), from the noise ranges of its octaves
+			void GetRidgedFractalBounds( const OctaveBounds& noise, const int octaves, const float freq, const float gain, const float max, float& minValue, float& maxValue );
+
+			///	\brief	Allowance for the difference in rounding between bounds arithmetic and SSE evaluation
+			const float RoundingAllowance = 1e-5f;
+
+			///	\brief	Widens the interval [minValue,maxValue] by RoundingAllowance
+			inline void Widen( float& minValue, float& maxValue )
+			{
+				minValue -= RoundingAllowance;
+				maxValue += RoundingAllowance;
+			}
+
+			///	\brief	Multiplies the interval [minValue,maxValue] by a scalar
+			inline void Scale( float& minValue, float& maxValue, const float scale )
+			{
+				const float a = minValue * scale;
+				const float b = maxValue * scale;
+				minValue = a < b ? a : b;
+				maxValue = a < b ? b : a;
+			}
+
+			///	\brief	Clamps the interval [minValue,maxValue] to [low,high]
+			inline void Clamp( float& minValue, float& maxValue, const float low, const float high )
+			{
+				minValue = minValue < low ? low : ( minValue > high ? high : minValue );
+				maxValue = maxValue < low ? low : ( maxValue > high ? high : maxValue );
+			}
+
+			///	\brief	Gets the largest magnitude of a value in the interval [minValue,maxValue]
+			inline float GetMaxMagnitude( const float minValue, const float maxValue )
+			{
+				return -minValue > maxValue ? -minValue : maxValue;
+			}
+
+			///	\brief	Gets the smallest magnitude of a value in the interval [minValue,maxValue]
+			inline float GetMinMagnitude( const float minValue, const float maxValue )
+			{
+				return minValue > 0 ? minValue : ( maxValue < 0 ? -maxValue : 0 );
+			}
+
+			///	\brief	Sets [minValue,maxValue] to the smallest interval containing [minValue,maxValue] and [otherMin,otherMax]
+			inline void Union( float& minValue, float& maxValue, const float otherMin, const float otherMax )
+			{
+				minValue = otherMin < minValue ? otherMin : minValue;
+				maxValue = otherMax > maxValue ? otherMax : maxValue;
+			}
+		};
+
+		//	------------------------------------------------------- SseFunctionRegion Inline Methods
+
+		inline const float* SseFunctionRegion::GetMinimum( ) const
+		{
+			return m_Min;
+		}
+
+		inline const float* SseFunctionRegion::GetMaximum( ) const
+		{
+			return m_Max;
+		}
+
+		inline bool SseFunctionRegion::IsEmpty( ) const
+		{
+			return m_Min[ 0 ] > m_Max[ 0 ];
+		}
+
+		inline bool SseFunctionRegion::Contains( const float x, const float y, const float z ) const
+		{
+			return	( x >= m_Min[ 0 ] ) && ( x <= m_Max[ 0 ] ) &&
+					( y >= m_Min[ 1 ] ) && ( y <= m_Max[ 1 ] ) &&
+					( z >= m_Min[ 2 ] ) && ( z <= m_Max[ 2 ] );
+		}
+
+		inline void SseFunctionRegion::Add( const float x, const float y, const float z )
+		{
+			m_Min[ 0 ] = x < m_Min[ 0 ] ? x : m_Min[ 0 ];
+			m_Min[ 1 ] = y < m_Min[ 1 ] ? y : m_Min[ 1 ];
+			m_Min[ 2 ] = z < m_Min[ 2 ] ? z : m_Min[ 2 ];
+			m_Max[ 0 ] = x > m_Max[ 0 ] ? x : m_Max[ 0 ];
+			m_Max[ 1 ] = y > m_Max[ 1 ] ? y : m_Max[ 1 ];
+			m_Max[ 2 ] = z > m_Max[ 2 ] ? z : m_Max[ 2 ];
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
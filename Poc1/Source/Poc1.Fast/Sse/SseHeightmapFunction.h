@@ -0,0 +1,303 @@
+#pragma once
+#include "SseSimpleFractal.h"
+#include "SseUtils.h"
+#include "UHeightmapFile.h"
+
+#pragma unmanaged
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Terrain function that samples a cube map of heights, from a memory mapped heightmap file (see UHeightmapFile)
+		///
+		///	The cube map is looked up in the direction of each point, so the sphere displacers place the heightmap
+		///	over the whole planet. Heights are filtered bilinearly, or with a Catmull-Rom bicubic filter, which
+		///	is smoother across texels but can overshoot the texel range. Fractal detail (GetDetail()) can be added
+		///	to the heights, to break up the texels of the heightmap when they are closer than its resolution.
+		///
+		///	GetValue() returns heights normalized to [0,1] over the range of the file, plus the detail. If no
+		///	file is open, the heights are 0.
+		///
+		class FAST_ALIGN( 16 ) SseHeightmapFunction
+		{
+			public :
+
+				///	\brief	Height filters
+				enum Filter
+				{
+					FilterBilinear,
+					FilterBicubic
+				};
+
+				///	\brief	Sets up a function with no heightmap, a bilinear filter, and no detail
+				SseHeightmapFunction( );
+
+				///	\brief	Opens a heightmap file. Returns false if the file could not be opened, and leaves the function with no heightmap
+				bool Open( const char* path );
+
+				///	\brief	Closes the heightmap file
+				void Close( );
+
+				///	\brief	Gets the heightmap file
+				const UHeightmapFile& GetFile( ) const;
+
+				///	\brief	Gets the height filter
+				Filter GetFilter( ) const;
+
+				///	\brief	Sets the height filter
+				void SetFilter( const Filter filter );
+
+				///	\brief	Gets the detail fractal
+				SseSimpleFractal& GetDetail( );
+
+				///	\brief	Gets the detail fractal
+				const SseSimpleFractal& GetDetail( ) const;
+
+				///	\brief	Gets the amount of detail added to the heights
+				float GetDetailAmplitude( ) const;
+
+				///	\brief	Sets the amount of detail added to the heights. The signed detail fractal value is scaled by amplitude. Zero turns detail off
+				void SetDetailAmplitude( const float amplitude );
+
+				///	\brief	Gets 4 heights from 4 points. Returns values in the range [0,1], plus detail
+				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets 4 heights from 4 points, using a given precision policy for texel coordinates and the detail fractal
+				///
+				///	The raw reciprocal of SseFastestPrecision moves samples by a texel or more on heightmaps larger
+				///	than a few thousand texels across, so large heightmaps need at least SseFastPrecision.
+				///
+				template < typename Precision >
+				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets 4 heights from 4 points, mapped to [-1,1]
+				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets 4 heights from 4 points, mapped to [-1,1], using a given precision policy for the detail fractal
+				template < typename Precision >
+				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				///
+				///	The region is projected onto each cube face it can touch, and the ranges of the heightmap tiles
+				///	under the projection are combined. The bicubic filter can overshoot the texels it reads, by up to
+				///	0.28125 times their range.
+				///
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
+
+			private :
+
+				SseSimpleFractal	m_Detail;
+				__m128				m_DetailAmplitude;
+				__m128				m_HalfSize;		///<	( resolution - 1 ) / 2, maps the range [-1,1] onto texel coordinates
+				__m128				m_MaxTexel;		///<	resolution - 1
+				UHeightmapFile		m_File;
+				Filter				m_Filter;
+
+				///	\brief	Samples the heightmap in the direction of 4 points
+				template < typename Precision >
+				__m128 Sample( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const;
+
+				///	\brief	Bilinearly filters the texel cells starting at ( rows, cols ) on faces
+				__m128 SampleBilinear( const int* faces, const int* rows, const int* cols, const __m128& tU, const __m128& tV ) const;
+
+				///	\brief	Bicubically filters the 4x4 texels around the texel cells starting at ( rows, cols ) on faces
+				__m128 SampleBicubic( const int* faces, const int* rows, const int* cols, const __m128& tU, const __m128& tV ) const;
+
+				///	\brief	Gets the range of Sample() for points in a region
+				void GetSampleBounds( const SseFunctionRegion& region, float& minValue, float& maxValue ) const;
+
+				///	\brief	Gets the Catmull-Rom weights of the 4 texels around a position t in [0,1] between the middle 2
+				static void GetCubicWeights( const __m128& tttt, __m128* weights );
+
+				///	\brief	Not copyable
+				SseHeightmapFunction( const SseHeightmapFunction& );
+
+				///	\brief	Not copyable
+				SseHeightmapFunction& operator = ( const SseHeightmapFunction& );
+		};
+
+		//	----------------------------------------------------- SseHeightmapFunction Inline Methods
+
+		inline const UHeightmapFile& SseHeightmapFunction::GetFile( ) const
+		{
+			return m_File;
+		}
+
+		inline SseHeightmapFunction::Filter SseHeightmapFunction::GetFilter( ) const
+		{
+			return m_Filter;
+		}
+
+		inline void SseHeightmapFunction::SetFilter( const Filter filter )
+		{
+			m_Filter = filter;
+		}
+
+		inline SseSimpleFractal& SseHeightmapFunction::GetDetail( )
+		{
+			return m_Detail;
+		}
+
+		inline const SseSimpleFractal& SseHeightmapFunction::GetDetail( ) const
+		{
+			return m_Detail;
+		}
+
+		inline float SseHeightmapFunction::GetDetailAmplitude( ) const
+		{
+			return GetLane( m_DetailAmplitude, 0 );
+		}
+
+		inline void SseHeightmapFunction::SetDetailAmplitude( const float amplitude )
+		{
+			m_DetailAmplitude = _mm_set1_ps( amplitude );
+		}
+
+		inline void SseHeightmapFunction::GetCubicWeights( const __m128& tttt, __m128* weights )
+		{
+			//	w0 = (-t^3 + 2t^2 - t) / 2		w1 = (3t^3 - 5t^2 + 2) / 2
+			//	w2 = (-3t^3 + 4t^2 + t) / 2		w3 = (t^3 - t^2) / 2
+			const __m128 half = _mm_set1_ps( 0.5f );
+			const __m128 t2 = _mm_mul_ps( tttt, tttt );
+			const __m128 t3 = _mm_mul_ps( t2, tttt );
+			weights[ 0 ] = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_mul_ps( t2, Constants::Fc_2 ), t3 ), tttt ), half );
+			weights[ 1 ] = _mm_mul_ps( _mm_add_ps( _mm_sub_ps( _mm_mul_ps( t3, _mm_set1_ps( 3.0f ) ), _mm_mul_ps( t2, _mm_set1_ps( 5.0f ) ) ), Constants::Fc_2 ), half );
+			weights[ 2 ] = _mm_mul_ps( _mm_add_ps( _mm_sub_ps( _mm_mul_ps( t2, _mm_set1_ps( 4.0f ) ), _mm_mul_ps( t3, _mm_set1_ps( 3.0f ) ) ), tttt ), half );
+			weights[ 3 ] = _mm_mul_ps( _mm_sub_ps( t3, t2 ), half );
+		}
+
+		inline __m128 SseHeightmapFunction::SampleBilinear( const int* faces, const int* rows, const int* cols, const __m128& tU, const __m128& tV ) const
+		{
+			//	SSE2 has no gather, so the 4 corners of each cell are fetched one lane at a time, in one call to the file
+			int cornerFaces[ 4 ][ 4 ], cornerRows[ 4 ][ 4 ], cornerCols[ 4 ][ 4 ];
+			for ( int corner = 0; corner < 4; ++corner )
+			{
+				for ( int lane = 0; lane < 4; ++lane )
+				{
+					cornerFaces[ corner ][ lane ] = faces[ lane ];
+					cornerRows[ corner ][ lane ] = rows[ lane ] + ( corner >> 1 );
+					cornerCols[ corner ][ lane ] = cols[ lane ] + ( corner & 1 );
+				}
+			}
+			FAST_ALIGN( 16 ) float corners[ 4 ][ 4 ];
+			m_File.GetTexels( 16, cornerFaces[ 0 ], cornerRows[ 0 ], cornerCols[ 0 ], corners[ 0 ] );
+			const __m128 top = Lerp( tU, _mm_load_ps( corners[ 0 ] ), _mm_load_ps( corners[ 1 ] ) );
+			const __m128 bottom = Lerp( tU, _mm_load_ps( corners[ 2 ] ), _mm_load_ps( corners[ 3 ] ) );
+			return Lerp( tV, top, bottom );
+		}
+
+		inline __m128 SseHeightmapFunction::SampleBicubic( const int* faces, const int* rows, const int* cols, const __m128& tU, const __m128& tV ) const
+		{
+			//	Texels past the edges of a face are clamped to the edge
+			const int maxTexel = m_File.GetResolution( ) - 1;
+			int texelFaces[ 4 ][ 4 ][ 4 ], texelRows[ 4 ][ 4 ][ 4 ], texelCols[ 4 ][ 4 ][ 4 ];
+			for ( int lane = 0; lane < 4; ++lane )
+			{
+				for ( int j = 0; j < 4; ++j )
+				{
+					const int row = rows[ lane ] + j - 1;
+					const int clampedRow = row < 0 ? 0 : ( row > maxTexel ? maxTexel : row );
+					for ( int i = 0; i < 4; ++i )
+					{
+						const int col = cols[ lane ] + i - 1;
+						texelFaces[ j ][ i ][ lane ] = faces[ lane ];
+						texelRows[ j ][ i ][ lane ] = clampedRow;
+						texelCols[ j ][ i ][ lane ] = col < 0 ? 0 : ( col > maxTexel ? maxTexel : col );
+					}
+				}
+			}
+			FAST_ALIGN( 16 ) float texels[ 4 ][ 4 ][ 4 ];
+			m_File.GetTexels( 64, texelFaces[ 0 ][ 0 ], texelRows[ 0 ][ 0 ], texelCols[ 0 ][ 0 ], texels[ 0 ][ 0 ] );
+
+			__m128 uWeights[ 4 ], vWeights[ 4 ];
+			GetCubicWeights( tU, uWeights );
+			GetCubicWeights( tV, vWeights );
+			__m128 result = Constants::Fc_0;
+			for ( int j = 0; j < 4; ++j )
+			{
+				__m128 line = _mm_mul_ps( uWeights[ 0 ], _mm_load_ps( texels[ j ][ 0 ] ) );
+				line = _mm_add_ps( line, _mm_mul_ps( uWeights[ 1 ], _mm_load_ps( texels[ j ][ 1 ] ) ) );
+				line = _mm_add_ps( line, _mm_mul_ps( uWeights[ 2 ], _mm_load_ps( texels[ j ][ 2 ] ) ) );
+				line = _mm_add_ps( line, _mm_mul_ps( uWeights[ 3 ], _mm_load_ps( texels[ j ][ 3 ] ) ) );
+				result = ( j == 0 ) ? _mm_mul_ps( vWeights[ 0 ], line ) : _mm_add_ps( result, _mm_mul_ps( vWeights[ j ], line ) );
+			}
+			return result;
+		}
+
+		template < typename Precision >
+		inline __m128 SseHeightmapFunction::Sample( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
+		{
+			if ( !m_File.IsOpen( ) )
+			{
+				return Constants::Fc_0;
+			}
+
+			__m128 faces, uuuu, vvvv, major;
+			GetCubeFaceCoordinates( xxxx, yyyy, zzzz, faces, uuuu, vvvv, major );
+			uuuu = Precision::Div( uuuu, major );
+			vvvv = Precision::Div( vvvv, major );
+			if ( m_File.GetProjection( ) == ProjectionTangent )
+			{
+				uuuu = InverseTangentCubeFaceCoordinate( uuuu );
+				vvvv = InverseTangentCubeFaceCoordinate( vvvv );
+			}
+
+			//	Map [-1,1] onto texel coordinates. The last texel on each axis shares the last cell
+			uuuu = Clamp( _mm_mul_ps( _mm_add_ps( uuuu, Constants::Fc_1 ), m_HalfSize ), Constants::Fc_0, m_MaxTexel );
+			vvvv = Clamp( _mm_mul_ps( _mm_add_ps( vvvv, Constants::Fc_1 ), m_HalfSize ), Constants::Fc_0, m_MaxTexel );
+			const __m128 maxCell = _mm_sub_ps( m_MaxTexel, Constants::Fc_1 );
+			const __m128 cellU = _mm_min_ps( _mm_cvtepi32_ps( _mm_cvttps_epi32( uuuu ) ), maxCell );
+			const __m128 cellV = _mm_min_ps( _mm_cvtepi32_ps( _mm_cvttps_epi32( vvvv ) ), maxCell );
+
+			FAST_ALIGN( 16 ) int faceIndices[ 4 ];
+			FAST_ALIGN( 16 ) int rows[ 4 ];
+			FAST_ALIGN( 16 ) int cols[ 4 ];
+			_mm_store_si128( ( __m128i* )faceIndices, _mm_cvttps_epi32( faces ) );
+			_mm_store_si128( ( __m128i* )rows, _mm_cvttps_epi32( cellV ) );
+			_mm_store_si128( ( __m128i* )cols, _mm_cvttps_epi32( cellU ) );
+
+			const __m128 tU = _mm_sub_ps( uuuu, cellU );
+			const __m128 tV = _mm_sub_ps( vvvv, cellV );
+			if ( m_Filter == FilterBicubic )
+			{
+				return SampleBicubic( faceIndices, rows, cols, tU, tV );
+			}
+			return SampleBilinear( faceIndices, rows, cols, tU, tV );
+		}
+
+		template < typename Precision >
+		inline __m128 SseHeightmapFunction::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			const __m128 heights = Sample< Precision >( xxxx, yyyy, zzzz );
+			if ( _mm_movemask_ps( _mm_cmpneq_ps( m_DetailAmplitude, Constants::Fc_0 ) ) == 0 )
+			{
+				return heights;
+			}
+			return _mm_add_ps( heights, _mm_mul_ps( m_Detail.GetSignedValue< Precision >( xxxx, yyyy, zzzz ), m_DetailAmplitude ) );
+		}
+
+		inline __m128 SseHeightmapFunction::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		template < typename Precision >
+		inline __m128 SseHeightmapFunction::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return _mm_sub_ps( _mm_mul_ps( GetValue< Precision >( xxxx, yyyy, zzzz ), Constants::Fc_2 ), Constants::Fc_1 );
+		}
+
+		inline __m128 SseHeightmapFunction::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
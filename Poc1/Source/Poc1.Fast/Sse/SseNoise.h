@@ -1,7 +1,9 @@
 #pragma once
 #pragma managed(push, off)
 
-#include "Sse\SseUtils.h"
+#include "Sse/SseUtils.h"
+#include "Sse/SsePermutationTables.h"
+#include "Instrumentation.h"
 #include "Poc1.Fast.h"
 
 namespace Poc1
@@ -9,7 +11,7 @@ namespace Poc1
 	namespace Fast
 	{
 		///	\brief	Fast noise implementation using SSE SIMD instructions
-		class FAST_API _CRT_ALIGN(16) SseNoise
+		class FAST_API FAST_ALIGN(16) SseNoise
 		{
 			public :
 
@@ -25,8 +27,14 @@ namespace Poc1
 				///	\brief	Fills a bitmap with noise values
 				void GenerateRgbBitmap( const int width, const int height, unsigned char* pixels, const float* origin, const float* incCol, const float* incRow ) const;
 				
-				///	\brief	Fills a bitmap with tiled noise values. Tiles the noise
-				void GenerateTiledBitmap( const int width, const int height, const int stride, unsigned char* pixels, const float startX, const float startY, const float noiseWidth, const float noiseHeight ) const;
+				///	\brief	Fills a bitmap with seamlessly tiling noise values
+				///
+				///	Pixels are channels bytes wide (1 to 4), and rows are stride bytes apart. If independentChannels is true, each
+				///	channel is filled with different noise, otherwise all channels get the same value. The noise covers
+				///	(startX,startY) to (startX+noiseWidth,startY+noiseHeight). noiseWidth and noiseHeight are rounded to a
+				///	whole number of lattice cells (between 1 and 256), so that the lattice can wrap at the bitmap edges.
+				///
+				void GenerateTiledBitmap( const int width, const int height, const int stride, const int channels, const bool independentChannels, unsigned char* pixels, const float startX, const float startY, const float noiseWidth, const float noiseHeight ) const;
 
 				//	TODO: AP: Add SSE detection
 
@@ -40,15 +48,32 @@ namespace Poc1
 				///	\brief	Generates 4 noise values, in the range -1..1 from 4 input vectors
 				__m128 Noise( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 
+				///	\brief	Generates 4 noise values, in the range -1..1 from 4 input vectors, using a given precision policy
+				template < typename Precision >
+				__m128 Noise( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Generates 4 noise values, in the range -1..1, from a lattice that repeats every periodX cells in x and periodY cells in y
+				///
+				///	x and y are relative to the lattice cell (originX,originY), and must be in the range [-period,2*period).
+				///
+				__m128 PeriodicNoise( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128i& periodX, const __m128i& periodY, const __m128i& originX, const __m128i& originY ) const;
+
 			private :
 				
-				int m_Perms[ 512 ];
+				const SsePermutationTables::Entry* m_Perms;	///<	Shared permutation table (see SsePermutationTables)
 
 				///	\brief	Initializes permutation table, using a given seed value
 				void InitializePerms( const unsigned int seed );
 
 				///	\brief	Generates a permutation of an input vector
 				__m128i Perm( __m128i vec ) const;
+
+				///	\brief	Blends the gradients at the corners of the lattice cells containing 4 points
+				///
+				///	AA, BA, AB and BB are the hashed (x,y), (x+1,y), (x,y+1) and (x+1,y+1) cell corners, offset by the z cell.
+				///	xxxx, yyyy and zzzz are the positions of the points inside their cells.
+				///
+				__m128 BlendCorners( __m128i AA, __m128i BA, __m128i AB, __m128i BB, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const;
 		};
 
 		inline __m128i Poc1::Fast::SseNoise::Perm( __m128i vec ) const
@@ -66,36 +91,17 @@ namespace Poc1
 			//	But it produced odd patterns in the noise, so I switched back to the standard improved noise
 			//	method of using a pre-computed permutation table as a temporary measure...
 			//	I don't know why, but doing it like this has not slowed things down at all...
-			return _mm_set_epi32( m_Perms[vec.m128i_i32[3]], m_Perms[vec.m128i_i32[2]], m_Perms[vec.m128i_i32[1]], m_Perms[vec.m128i_i32[0]]);
+			FAST_ALIGN( 16 ) int indices[ 4 ];
+			_mm_store_si128( ( __m128i* )indices, vec );
+			return _mm_set_epi32( m_Perms[ indices[ 3 ] ], m_Perms[ indices[ 2 ] ], m_Perms[ indices[ 1 ] ], m_Perms[ indices[ 0 ] ] );
 		}
 
-		///	\brief	Generates 4 noise values in the range [-1..1].
-		inline __m128 Poc1::Fast::SseNoise::Noise( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		inline __m128 Poc1::Fast::SseNoise::BlendCorners( __m128i AA, __m128i BA, __m128i AB, __m128i BB, const __m128& xxxx, const __m128& yyyy, const __m128& zzzz ) const
 		{
-			__m128i ixxxx = RoundToInt( xxxx );
-			__m128i iyyyy = RoundToInt( yyyy );
-			__m128i izzzz = RoundToInt( zzzz );
-
-			xxxx = _mm_sub_ps( xxxx, _mm_cvtepi32_ps( ixxxx ) );
-			yyyy = _mm_sub_ps( yyyy, _mm_cvtepi32_ps( iyyyy ) );
-			zzzz = _mm_sub_ps( zzzz, _mm_cvtepi32_ps( izzzz ) );
-			
-			ixxxx = _mm_and_si128( ixxxx, Constants::Ic_FF );
-			iyyyy = _mm_and_si128( iyyyy, Constants::Ic_FF );
-			izzzz = _mm_and_si128( izzzz, Constants::Ic_FF );
-
 			__m128 fade0 = Fade( xxxx );
 			__m128 fade1 = Fade( yyyy );
 			__m128 fade2 = Fade( zzzz );
 
-			//	Determine corner hash values
-			__m128i A = _mm_add_epi32( Perm( ixxxx ), iyyyy );
-			__m128i AA = _mm_add_epi32( Perm( A ), izzzz );
-			__m128i AB = _mm_add_epi32( Perm( _mm_add_epi32( A, Constants::Ic_1 ) ), izzzz );
-			__m128i B = _mm_add_epi32( Perm( _mm_add_epi32( ixxxx, Constants::Ic_1 ) ), iyyyy );
-			__m128i BA = _mm_add_epi32( Perm( B ), izzzz );
-			__m128i BB = _mm_add_epi32( Perm( _mm_add_epi32( B, Constants::Ic_1 ) ), izzzz );
-
 			__m128 lxxxx = _mm_sub_ps( xxxx, Constants::Fc_1 );
 			__m128 lyyyy = _mm_sub_ps( yyyy, Constants::Fc_1 );
 			__m128 lzzzz = _mm_sub_ps( zzzz, Constants::Fc_1 );
@@ -109,8 +115,7 @@ namespace Poc1
 			AB = Perm( AB );
 			BB = Perm( BB );
 
-
-			__m128 res =
+			return
 				Lerp
 				(
 					fade2,
@@ -126,12 +131,85 @@ namespace Poc1
 						Lerp( fade0, Grad( AA1, xxxx, yyyy, lzzzz ), Grad( BA1, lxxxx, yyyy, lzzzz ) ),
 						Lerp( fade0, Grad( AB1, xxxx, lyyyy, lzzzz ), Grad( BB1, lxxxx, lyyyy, lzzzz ) )
 					)
-				); 
-			res = _mm_div_ps( res, _mm_set1_ps( 0.888f ) );	//	TODO: AP: Factor out crappy scaling factor
+				);
+		}
+
+		///	\brief	Generates 4 noise values in the range [-1..1].
+		template < typename Precision >
+		inline __m128 Poc1::Fast::SseNoise::Noise( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			FAST_INSTRUMENT_COUNT( CounterNoiseCalls, 1 );
+
+			__m128i ixxxx = RoundToInt( xxxx );
+			__m128i iyyyy = RoundToInt( yyyy );
+			__m128i izzzz = RoundToInt( zzzz );
+
+			xxxx = _mm_sub_ps( xxxx, _mm_cvtepi32_ps( ixxxx ) );
+			yyyy = _mm_sub_ps( yyyy, _mm_cvtepi32_ps( iyyyy ) );
+			zzzz = _mm_sub_ps( zzzz, _mm_cvtepi32_ps( izzzz ) );
+			
+			ixxxx = _mm_and_si128( ixxxx, Constants::Ic_FF );
+			iyyyy = _mm_and_si128( iyyyy, Constants::Ic_FF );
+			izzzz = _mm_and_si128( izzzz, Constants::Ic_FF );
+
+			//	Determine corner hash values
+			__m128i A = _mm_add_epi32( Perm( ixxxx ), iyyyy );
+			__m128i AA = _mm_add_epi32( Perm( A ), izzzz );
+			__m128i AB = _mm_add_epi32( Perm( _mm_add_epi32( A, Constants::Ic_1 ) ), izzzz );
+			__m128i B = _mm_add_epi32( Perm( _mm_add_epi32( ixxxx, Constants::Ic_1 ) ), iyyyy );
+			__m128i BA = _mm_add_epi32( Perm( B ), izzzz );
+			__m128i BB = _mm_add_epi32( Perm( _mm_add_epi32( B, Constants::Ic_1 ) ), izzzz );
+
+			__m128 res = BlendCorners( AA, BA, AB, BB, xxxx, yyyy, zzzz );
+			res = Precision::DivConstant( res, 0.888f );	//	TODO: AP: Factor out crappy scaling factor
 
 			return res;
 		}
 
+		///	\brief	Generates 4 noise values in the range [-1..1], at full precision
+		inline __m128 Poc1::Fast::SseNoise::Noise( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return Noise< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		///	\brief	Generates 4 periodic noise values in the range [-1..1].
+		inline __m128 Poc1::Fast::SseNoise::PeriodicNoise( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128i& periodX, const __m128i& periodY, const __m128i& originX, const __m128i& originY ) const
+		{
+			FAST_INSTRUMENT_COUNT( CounterNoiseCalls, 1 );
+
+			__m128i ixxxx = RoundToInt( xxxx );
+			__m128i iyyyy = RoundToInt( yyyy );
+			__m128i izzzz = RoundToInt( zzzz );
+
+			xxxx = _mm_sub_ps( xxxx, _mm_cvtepi32_ps( ixxxx ) );
+			yyyy = _mm_sub_ps( yyyy, _mm_cvtepi32_ps( iyyyy ) );
+			zzzz = _mm_sub_ps( zzzz, _mm_cvtepi32_ps( izzzz ) );
+
+			//	Wrap the cell corners at the period, before they are hashed
+			ixxxx = WrapToPeriod( ixxxx, periodX );
+			iyyyy = WrapToPeriod( iyyyy, periodY );
+			__m128i ixxxx1 = WrapToPeriod( _mm_add_epi32( ixxxx, Constants::Ic_1 ), periodX );
+			__m128i iyyyy1 = WrapToPeriod( _mm_add_epi32( iyyyy, Constants::Ic_1 ), periodY );
+
+			ixxxx = _mm_and_si128( _mm_add_epi32( ixxxx, originX ), Constants::Ic_FF );
+			ixxxx1 = _mm_and_si128( _mm_add_epi32( ixxxx1, originX ), Constants::Ic_FF );
+			iyyyy = _mm_and_si128( _mm_add_epi32( iyyyy, originY ), Constants::Ic_FF );
+			iyyyy1 = _mm_and_si128( _mm_add_epi32( iyyyy1, originY ), Constants::Ic_FF );
+			izzzz = _mm_and_si128( izzzz, Constants::Ic_FF );
+
+			//	Determine corner hash values. Same as Noise(), but y+1 is wrapped explicitly, rather than being
+			//	added to the hash of y
+			__m128i A = Perm( ixxxx );
+			__m128i B = Perm( ixxxx1 );
+			__m128i AA = _mm_add_epi32( Perm( _mm_add_epi32( A, iyyyy ) ), izzzz );
+			__m128i AB = _mm_add_epi32( Perm( _mm_add_epi32( A, iyyyy1 ) ), izzzz );
+			__m128i BA = _mm_add_epi32( Perm( _mm_add_epi32( B, iyyyy ) ), izzzz );
+			__m128i BB = _mm_add_epi32( Perm( _mm_add_epi32( B, iyyyy1 ) ), izzzz );
+
+			__m128 res = BlendCorners( AA, BA, AB, BB, xxxx, yyyy, zzzz );
+			return _mm_div_ps( res, _mm_set1_ps( 0.888f ) );
+		}
+
 	};
 };
 
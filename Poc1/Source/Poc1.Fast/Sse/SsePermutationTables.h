@@ -0,0 +1,38 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Poc1.Fast.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Process-wide registry of noise permutation tables, interned by seed
+		///
+		///	Tables are created on first request for a given seed, and are never freed. They are immutable
+		///	once created, so any number of noise objects (and threads) can share them. Each table is stored
+		///	as bytes (permutation values are in the range [0,255]), so a table fits in 8 cache lines.
+		///
+		class FAST_API SsePermutationTables
+		{
+			public :
+
+				///	\brief	Permutation table entry type
+				typedef unsigned char Entry;
+
+				///	\brief	Number of entries in a table (256 permutation values, duplicated to avoid index wrapping)
+				static const int TableSize = 512;
+
+				///	\brief	Gets the shared permutation table for a given seed. The table is created if it doesn't exist
+				static const Entry* Get( const unsigned int seed );
+
+			private :
+
+				///	\brief	Fills a table with a permutation generated from a seed value
+				static void InitializePerms( Entry* perms, const unsigned int seed );
+		};
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
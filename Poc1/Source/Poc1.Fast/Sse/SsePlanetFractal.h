@@ -1,5 +1,8 @@
 #pragma once
 #include "SseNoise.h"
+#include "SseContinentMask.h"
+#include "SseFunctionBounds.h"
+#include <math.h>
 
 #pragma unmanaged
 
@@ -9,7 +12,12 @@ namespace Poc1
 	{
 		///	\brief	Planet fractal. Uses a low-frequency fractal to define continent regions, then a much
 		///	higher frequency fractal for terrain details (kind of breaks the notion of fractal scale...)
-		class _CRT_ALIGN( 16 ) SsePlanetFractal
+		///
+		///	The first lowOctaves octaves (see Setup()) are the continent octaves. They can be baked into a
+		///	SseContinentMask and set with SetContinentMask(), after which GetValue() samples the mask, and only
+		///	evaluates the remaining detail octaves.
+		///
+		class FAST_ALIGN( 16 ) SsePlanetFractal
 		{
 			public :
 
@@ -25,15 +33,61 @@ namespace Poc1
 				///	\brief	Gets the noise object
 				const SseNoise& GetNoise( ) const;
 
-				///	\brief	Sets up fractal parameters
+				///	\brief	Sets up fractal parameters. highOctaves is the total number of octaves, including the lowOctaves continent octaves
 				void Setup( const float freq, const float gain, const int lowOctaves, const int highOctaves, const float coordinateMultiplier );
 
+				///	\brief	Sets the continent mask used by GetValue(). The mask is not owned by this object. Pass null to evaluate every octave
+				///
+				///	The mask must have been baked from this fractal, at the radius of the points passed to GetValue().
+				///
+				void SetContinentMask( const SseContinentMask* mask );
+
+				///	\brief	Gets the continent mask used by GetValue(). Returns null if there is no mask
+				const SseContinentMask* GetContinentMask( ) const;
+
+				///	\brief	Gets the number of continent octaves
+				int GetLowOctaves( ) const;
+
+				///	\brief	Gets a continent mask resolution, for a given radius, that puts texelsPerCell mask texels across each
+				///	noise lattice cell of the highest frequency continent octave (measured at the centre of a cube face)
+				int GetContinentMaskResolution( const float radius, const float texelsPerCell ) const;
+
+				///	\brief	Evaluates the basis noise of each continent octave at 4 points. Writes GetLowOctaves() values to noise
+				template < typename Precision >
+				void GetContinentNoise( __m128 xxxx, __m128 yyyy, __m128 zzzz, __m128* noise ) const;
+
+				///	\brief	Combines continent octave noise values. Gets the accumulated value, and the last octave signal
+				template < typename Precision >
+				void GetContinentValue( const __m128* noise, __m128& result, __m128& signal ) const;
+
+				///	\brief	Evaluates the detail octaves at 4 points, continuing from a continent value. Returns the final fractal value
+				template < typename Precision >
+				__m128 GetDetailValue( __m128 xxxx, __m128 yyyy, __m128 zzzz, __m128 result, __m128 signal ) const;
+
 				///	\brief	Gets 4 fractal values from 4 points
 				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 
+				///	\brief	Gets 4 fractal values from 4 points, using a given precision policy
+				template < typename Precision >
+				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
 				///	\brief	Gets 4 fractal values from 4 points
 				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 
+				///	\brief	Gets 4 fractal values from 4 points, using a given precision policy
+				template < typename Precision >
+				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				///
+				///	If there is a continent mask, the continent octave noise ranges cover every texel that the mask
+				///	can interpolate between, for any point in the region.
+				///
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
+
 			private :
 
 				SseNoise	m_Noise;
@@ -42,15 +96,19 @@ namespace Poc1
 				__m128 		m_Freq;
 				__m128 		m_Gain;
 				int			m_NumOctaves;
+				int			m_LowOctaves;
+				const SseContinentMask*	m_ContinentMask;
 		};
 		
-		inline SsePlanetFractal::SsePlanetFractal( )
+		inline SsePlanetFractal::SsePlanetFractal( ) :
+			m_ContinentMask( 0 )
 		{
 			Setup( 1.8f, 0.9f, 2, 8, 2.0f );
 		}
 		
 		inline SsePlanetFractal::SsePlanetFractal( const unsigned int seed ) :
-			m_Noise( seed )
+			m_Noise( seed ),
+			m_ContinentMask( 0 )
 		{
 			Setup( 1.8f, 0.9f, 2, 8, 2.0f );
 		}
@@ -71,6 +129,11 @@ namespace Poc1
 			m_Gain = _mm_set1_ps( gain );
 			m_CoordinateMultiplier = _mm_set1_ps( coordinateMultiplier );
 			m_NumOctaves = highOctaves;
+
+			//	The first octave is always a continent octave
+			m_LowOctaves = lowOctaves > highOctaves ? highOctaves : lowOctaves;
+			m_LowOctaves = m_LowOctaves > SseContinentMask::MaxOctaves ? SseContinentMask::MaxOctaves : m_LowOctaves;
+			m_LowOctaves = m_LowOctaves < 1 ? 1 : m_LowOctaves;
 			
 			m_Max = Constants::Fc_1;
 			__m128 amp = Constants::Fc_1;
@@ -81,15 +144,91 @@ namespace Poc1
 			}
 		}
 
-		inline __m128 SsePlanetFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		inline void SsePlanetFractal::SetContinentMask( const SseContinentMask* mask )
+		{
+			m_ContinentMask = mask;
+		}
+
+		inline const SseContinentMask* SsePlanetFractal::GetContinentMask( ) const
 		{
+			return m_ContinentMask;
+		}
+
+		inline int SsePlanetFractal::GetLowOctaves( ) const
+		{
+			return m_LowOctaves;
+		}
+
+		inline int SsePlanetFractal::GetContinentMaskResolution( const float radius, const float texelsPerCell ) const
+		{
+			//	Texels are 2r/(resolution-1) apart at the centre of a face. Lattice cells of octave n are 1/freq^n apart
+			float cells = 2 * radius;
+			for ( int octave = 1; octave < m_LowOctaves; ++octave )
+			{
+				cells *= GetLane( m_Freq, 0 );
+			}
+			return 1 + int( ceilf( cells * texelsPerCell ) );
+		}
+
+		template < typename Precision >
+		inline void SsePlanetFractal::GetContinentNoise( __m128 xxxx, __m128 yyyy, __m128 zzzz, __m128* noise ) const
+		{
+			noise[ 0 ] = m_Noise.Noise< Precision >( xxxx, yyyy, zzzz );
+			for ( int octave = 1; octave < m_LowOctaves; ++octave )
+			{
+				xxxx = _mm_mul_ps( xxxx, m_Freq );
+				yyyy = _mm_mul_ps( yyyy, m_Freq );
+				zzzz = _mm_mul_ps( zzzz, m_Freq );
+				noise[ octave ] = m_Noise.Noise< Precision >( xxxx, yyyy, zzzz );
+			}
+		}
+
+		template < typename Precision >
+		inline void SsePlanetFractal::GetContinentValue( const __m128* noise, __m128& result, __m128& signal ) const
+		{
+			FAST_INSTRUMENT_COUNT( CounterOctaves, m_LowOctaves );
+
 			__m128 offset = Constants::Fc_1;
-			__m128 signal = _mm_sub_ps( offset, Abs( m_Noise.Noise( xxxx, yyyy, zzzz ) ) );
+			signal = _mm_sub_ps( offset, Abs( noise[ 0 ] ) );
 			signal = _mm_mul_ps( signal, signal );
-			__m128 result = signal;
+			result = signal;
 			__m128 exp = Constants::Fc_1;
 
-			for ( int octave = 1; octave < m_NumOctaves; ++octave )
+			for ( int octave = 1; octave < m_LowOctaves; ++octave )
+			{
+				__m128 weight = _mm_mul_ps( signal, m_Gain );
+				weight = _mm_and_ps( weight, _mm_cmpgt_ps( weight, Constants::Fc_0 ) );
+
+				__m128 weightMask = _mm_cmple_ps( weight, Constants::Fc_1 );
+				weight = _mm_or_ps( _mm_and_ps( weightMask, weight ), _mm_andnot_ps( weightMask, Constants::Fc_1 ) );
+
+				__m128 basis = Abs( noise[ octave ] );
+				signal = _mm_sub_ps( offset, basis );
+				signal = _mm_mul_ps( signal, signal );
+				signal = _mm_mul_ps( signal, weight );
+				result = _mm_add_ps( result, Precision::Div( signal, exp ) );
+				exp = _mm_mul_ps( exp, m_Freq );
+			}
+		}
+
+		template < typename Precision >
+		inline __m128 SsePlanetFractal::GetDetailValue( __m128 xxxx, __m128 yyyy, __m128 zzzz, __m128 result, __m128 signal ) const
+		{
+			FAST_INSTRUMENT_COUNT( CounterOctaves, m_NumOctaves - m_LowOctaves );
+
+			//	Scale the inputs by the continent octave frequencies, in the same order as GetContinentValue(),
+			//	so the result is the same as evaluating every octave in one go
+			__m128 offset = Constants::Fc_1;
+			__m128 exp = Constants::Fc_1;
+			for ( int octave = 1; octave < m_LowOctaves; ++octave )
+			{
+				xxxx = _mm_mul_ps( xxxx, m_Freq );
+				yyyy = _mm_mul_ps( yyyy, m_Freq );
+				zzzz = _mm_mul_ps( zzzz, m_Freq );
+				exp = _mm_mul_ps( exp, m_Freq );
+			}
+
+			for ( int octave = m_LowOctaves; octave < m_NumOctaves; ++octave )
 			{
 				xxxx = _mm_mul_ps( xxxx, m_Freq );
 				yyyy = _mm_mul_ps( yyyy, m_Freq );
@@ -101,21 +240,83 @@ namespace Poc1
 				__m128 weightMask = _mm_cmple_ps( weight, Constants::Fc_1 );
 				weight = _mm_or_ps( _mm_and_ps( weightMask, weight ), _mm_andnot_ps( weightMask, Constants::Fc_1 ) );
 
-				__m128 basis = m_Noise.Noise( xxxx, yyyy, zzzz );
+				__m128 basis = m_Noise.Noise< Precision >( xxxx, yyyy, zzzz );
 				basis = Abs( basis );
 				signal = _mm_sub_ps( offset, basis );
 				signal = _mm_mul_ps( signal, signal );
 				signal = _mm_mul_ps( signal, weight );
-				result = _mm_add_ps( result, _mm_div_ps( signal, exp ) );
+				result = _mm_add_ps( result, Precision::Div( signal, exp ) );
 				exp = _mm_mul_ps( exp, m_Freq );
 			}
 
-			return _mm_div_ps( result, m_Max );
+			return Precision::Div( result, m_Max );
+		}
+
+		template < typename Precision >
+		inline __m128 SsePlanetFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			__m128 noise[ SseContinentMask::MaxOctaves ];
+			if ( m_ContinentMask != 0 )
+			{
+				m_ContinentMask->Sample< Precision >( xxxx, yyyy, zzzz, noise );
+			}
+			else
+			{
+				GetContinentNoise< Precision >( xxxx, yyyy, zzzz, noise );
+			}
+
+			__m128 result, signal;
+			GetContinentValue< Precision >( noise, result, signal );
+			return GetDetailValue< Precision >( xxxx, yyyy, zzzz, result, signal );
+		}
+
+		inline __m128 SsePlanetFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
 		}
 		
+		template < typename Precision >
+		inline __m128 SsePlanetFractal::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return _mm_sub_ps( _mm_mul_ps( GetValue< Precision >( xxxx, yyyy, zzzz ), Constants::Fc_2 ), Constants::Fc_1 );
+		}
+
 		inline __m128 SsePlanetFractal::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
 		{
-			return _mm_sub_ps( _mm_mul_ps( GetValue( xxxx, yyyy, zzzz ), Constants::Fc_2 ), Constants::Fc_1 );
+			return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		inline void SsePlanetFractal::GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			const float freq = GetLane( m_Freq, 0 );
+			FunctionBounds::OctaveBounds noise;
+			FunctionBounds::GetNoiseOctaveBounds( m_Noise, region, freq, m_NumOctaves, samples, noise );
+			if ( m_ContinentMask != 0 )
+			{
+				//	Mask texels are baked on the mask sphere, so they can be further from a point than the texel
+				//	spacing, if the point is off the sphere
+				const float radius = m_ContinentMask->GetRadius( );
+				const float aboveSphere = region.GetMaximumLength( ) - radius;
+				const float belowSphere = radius - region.GetMinimumLength( );
+				SseFunctionRegion maskRegion( region );
+				maskRegion.Expand( m_ContinentMask->GetMaxTexelDistance( ) + ( aboveSphere > belowSphere ? aboveSphere : belowSphere ) );
+
+				FunctionBounds::OctaveBounds continentNoise;
+				FunctionBounds::GetNoiseOctaveBounds( m_Noise, maskRegion, freq, m_LowOctaves, samples, continentNoise );
+				for ( int octave = 0; octave < m_LowOctaves; ++octave )
+				{
+					noise.m_Min[ octave ] = continentNoise.m_Min[ octave ];
+					noise.m_Max[ octave ] = continentNoise.m_Max[ octave ];
+				}
+			}
+			FunctionBounds::GetRidgedFractalBounds( noise, m_NumOctaves, freq, GetLane( m_Gain, 0 ), GetLane( m_Max, 0 ), minValue, maxValue );
+		}
+
+		inline void SsePlanetFractal::GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			GetBounds( region, minValue, maxValue, samples );
+			minValue = minValue * 2 - 1;
+			maxValue = maxValue * 2 - 1;
 		}
 	}; //Fast
 }; //Poc1
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "SseConstants.h"
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Precision policy. Uses full precision divides and square roots
+		///
+		///	Precision policies are passed as template parameters to noise, fractal, displacer and generator
+		///	functions, so the choice of precision is made when the generator type is chosen, rather than
+		///	at run-time. SseExactPrecision produces exactly the same output as the non-templated functions.
+		///
+		struct SseExactPrecision
+		{
+			///	\brief	Returns num / den
+			static inline __m128 Div( const __m128& num, const __m128& den )
+			{
+				return _mm_div_ps( num, den );
+			}
+
+			///	\brief	Returns num / den, where den is a constant
+			static inline __m128 DivConstant( const __m128& num, const float den )
+			{
+				return _mm_div_ps( num, _mm_set1_ps( den ) );
+			}
+
+			///	\brief	Returns sqrt( val )
+			static inline __m128 Sqrt( const __m128& val )
+			{
+				return _mm_sqrt_ps( val );
+			}
+
+			///	\brief	Returns num / sqrt( val )
+			static inline __m128 DivSqrt( const __m128& num, const __m128& val )
+			{
+				return _mm_div_ps( num, _mm_sqrt_ps( val ) );
+			}
+		};
+
+		///	\brief	Precision policy. Uses reciprocal and reciprocal square root approximations, refined with
+		///	a single Newton-Raphson step (about 22 bits of precision)
+		struct SseFastPrecision
+		{
+			///	\brief	Returns 1 / val
+			static inline __m128 Rcp( const __m128& val )
+			{
+				//	r' = r(2 - vr) = 2r - vr^2
+				const __m128 r = _mm_rcp_ps( val );
+				return _mm_sub_ps( _mm_add_ps( r, r ), _mm_mul_ps( val, _mm_mul_ps( r, r ) ) );
+			}
+
+			///	\brief	Returns 1 / sqrt( val )
+			static inline __m128 RcpSqrt( const __m128& val )
+			{
+				//	r' = 0.5r(3 - vr^2)
+				const __m128 r = _mm_rsqrt_ps( val );
+				const __m128 vr2 = _mm_mul_ps( val, _mm_mul_ps( r, r ) );
+				return _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( 0.5f ), r ), _mm_sub_ps( _mm_set1_ps( 3.0f ), vr2 ) );
+			}
+
+			///	\brief	Returns num / den
+			static inline __m128 Div( const __m128& num, const __m128& den )
+			{
+				return _mm_mul_ps( num, Rcp( den ) );
+			}
+
+			///	\brief	Returns num / den, where den is a constant
+			static inline __m128 DivConstant( const __m128& num, const float den )
+			{
+				return _mm_mul_ps( num, _mm_set1_ps( 1.0f / den ) );
+			}
+
+			///	\brief	Returns sqrt( val ). Zero inputs return zero
+			static inline __m128 Sqrt( const __m128& val )
+			{
+				const __m128 nonZero = _mm_cmpgt_ps( val, Constants::Fc_0 );
+				return _mm_and_ps( nonZero, _mm_mul_ps( val, RcpSqrt( val ) ) );
+			}
+
+			///	\brief	Returns num / sqrt( val )
+			static inline __m128 DivSqrt( const __m128& num, const __m128& val )
+			{
+				return _mm_mul_ps( num, RcpSqrt( val ) );
+			}
+		};
+
+		///	\brief	Precision policy. Uses raw reciprocal and reciprocal square root approximations (about 12
+		///	bits of precision)
+		struct SseFastestPrecision
+		{
+			///	\brief	Returns num / den
+			static inline __m128 Div( const __m128& num, const __m128& den )
+			{
+				return _mm_mul_ps( num, _mm_rcp_ps( den ) );
+			}
+
+			///	\brief	Returns num / den, where den is a constant
+			static inline __m128 DivConstant( const __m128& num, const float den )
+			{
+				return _mm_mul_ps( num, _mm_set1_ps( 1.0f / den ) );
+			}
+
+			///	\brief	Returns sqrt( val ). Zero inputs return zero
+			static inline __m128 Sqrt( const __m128& val )
+			{
+				const __m128 nonZero = _mm_cmpgt_ps( val, Constants::Fc_0 );
+				return _mm_and_ps( nonZero, _mm_mul_ps( val, _mm_rsqrt_ps( val ) ) );
+			}
+
+			///	\brief	Returns num / sqrt( val )
+			static inline __m128 DivSqrt( const __m128& num, const __m128& val )
+			{
+				return _mm_mul_ps( num, _mm_rsqrt_ps( val ) );
+			}
+		};
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
@@ -1,5 +1,6 @@
 #pragma once
 #include "SseNoise.h"
+#include "SseFunctionBounds.h"
 
 #pragma unmanaged
 
@@ -7,7 +8,7 @@ namespace Poc1
 {
 	namespace Fast
 	{
-		class _CRT_ALIGN( 16 ) SseRidgedFractal
+		class FAST_ALIGN( 16 ) SseRidgedFractal
 		{
 			public :
 
@@ -26,12 +27,42 @@ namespace Poc1
 				///	\brief	Sets up fractal parameters
 				void Setup( const float freq, const float gain, const int numOctaves );
 
+				///	\brief	Gets the wavelength of the finest octave, in input units (the noise lattice spacing, divided by the scale of its inputs)
+				float GetFinestWavelength( ) const;
+
 				///	\brief	Gets 4 fractal values from 4 points
 				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 
+				///	\brief	Gets 4 fractal values from 4 points, using a given precision policy
+				template < typename Precision >
+				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
 				///	\brief	Gets 4 fractal values from 4 points
 				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 
+				///	\brief	Gets 4 fractal values from 4 points, using a given precision policy
+				template < typename Precision >
+				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets 4 fractal values from 4 points, clamped to [minValue,maxValue]
+				///
+				///	Returns Clamp( GetValue(), minValue, maxValue ), but stops evaluating octaves once the remaining
+				///	octaves can't move any of the 4 values back inside the range. Octaves only ever add to the value,
+				///	so values above the range stop as soon as they cross it.
+				///
+				template < typename Precision >
+				__m128 GetClampedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& minValue, const __m128& maxValue ) const;
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				///
+				///	The noise ranges of each octave (see FunctionBounds::GetNoiseOctaveBounds()) are passed through the
+				///	ridge and weight functions, so the bounds get tighter when low octave ridges damp the high octaves.
+				///
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
+
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
+
 			private :
 
 				SseNoise	m_Noise;
@@ -77,10 +108,25 @@ namespace Poc1
 			}
 		}
 
+		inline float SseRidgedFractal::GetFinestWavelength( ) const
+		{
+			//	Each octave after the first scales its inputs by freq
+			const float freq = GetLane( m_Freq, 0 );
+			float wavelength = 1;
+			for ( int octave = 1; octave < m_NumOctaves; ++octave )
+			{
+				wavelength /= freq;
+			}
+			return wavelength;
+		}
+
+		template < typename Precision >
 		inline __m128 SseRidgedFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
 		{
+			FAST_INSTRUMENT_COUNT( CounterOctaves, m_NumOctaves );
+
 			__m128 offset = Constants::Fc_1;
-			__m128 signal = _mm_sub_ps( offset, Abs( m_Noise.Noise( xxxx, yyyy, zzzz ) ) );
+			__m128 signal = _mm_sub_ps( offset, Abs( m_Noise.Noise< Precision >( xxxx, yyyy, zzzz ) ) );
 			signal = _mm_mul_ps( signal, signal );
 			__m128 result = signal;
 			__m128 exp = Constants::Fc_1;
@@ -97,21 +143,103 @@ namespace Poc1
 				__m128 weightMask = _mm_cmple_ps( weight, Constants::Fc_1 );
 				weight = _mm_or_ps( _mm_and_ps( weightMask, weight ), _mm_andnot_ps( weightMask, Constants::Fc_1 ) );
 
-				__m128 basis = m_Noise.Noise( xxxx, yyyy, zzzz );
+				__m128 basis = m_Noise.Noise< Precision >( xxxx, yyyy, zzzz );
+				basis = Abs( basis );
+				signal = _mm_sub_ps( offset, basis );
+				signal = _mm_mul_ps( signal, signal );
+				signal = _mm_mul_ps( signal, weight );
+				result = _mm_add_ps( result, Precision::Div( signal, exp ) );
+				exp = _mm_mul_ps( exp, m_Freq );
+			}
+
+			return Precision::Div( result, m_Max );
+		}
+
+		inline __m128 SseRidgedFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		template < typename Precision >
+		inline __m128 SseRidgedFractal::GetClampedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& minValue, const __m128& maxValue ) const
+		{
+			//	GetValue() is result / m_Max, so the range is mapped back onto results. The range is widened slightly, so
+			//	that rounding in the remaining octaves can't move a value across it
+			const __m128 allowance = _mm_mul_ps( m_Max, _mm_set1_ps( FunctionBounds::RoundingAllowance ) );
+			const __m128 minResult = _mm_sub_ps( _mm_mul_ps( minValue, m_Max ), allowance );
+			const __m128 maxResult = _mm_add_ps( _mm_mul_ps( maxValue, m_Max ), allowance );
+
+			__m128 offset = Constants::Fc_1;
+			__m128 signal = _mm_sub_ps( offset, Abs( m_Noise.Noise< Precision >( xxxx, yyyy, zzzz ) ) );
+			signal = _mm_mul_ps( signal, signal );
+			__m128 result = signal;
+			__m128 exp = Constants::Fc_1;
+
+			//	Octave n adds at most 1 / freq^(n-1) (signal and weight are at most 1), so m_Max - 1 covers the rest
+			__m128 remaining = _mm_sub_ps( m_Max, Constants::Fc_1 );
+			__m128 remainingTerm = Constants::Fc_1;
+			const __m128 invFreq = _mm_div_ps( Constants::Fc_1, m_Freq );
+
+			int octave = 1;
+			while ( octave < m_NumOctaves )
+			{
+				const __m128 below = _mm_cmplt_ps( _mm_add_ps( result, remaining ), minResult );
+				const __m128 above = _mm_cmpgt_ps( result, maxResult );
+				if ( _mm_movemask_ps( _mm_or_ps( below, above ) ) == 0xf )
+				{
+					break;
+				}
+
+				xxxx = _mm_mul_ps( xxxx, m_Freq );
+				yyyy = _mm_mul_ps( yyyy, m_Freq );
+				zzzz = _mm_mul_ps( zzzz, m_Freq );
+
+				__m128 weight = _mm_mul_ps( signal, m_Gain );
+				weight = _mm_and_ps( weight, _mm_cmpgt_ps( weight, Constants::Fc_0 ) );
+
+				__m128 weightMask = _mm_cmple_ps( weight, Constants::Fc_1 );
+				weight = _mm_or_ps( _mm_and_ps( weightMask, weight ), _mm_andnot_ps( weightMask, Constants::Fc_1 ) );
+
+				__m128 basis = m_Noise.Noise< Precision >( xxxx, yyyy, zzzz );
 				basis = Abs( basis );
 				signal = _mm_sub_ps( offset, basis );
 				signal = _mm_mul_ps( signal, signal );
 				signal = _mm_mul_ps( signal, weight );
-				result = _mm_add_ps( result, _mm_div_ps( signal, exp ) );
+				result = _mm_add_ps( result, Precision::Div( signal, exp ) );
+				remaining = _mm_sub_ps( remaining, remainingTerm );
+				remainingTerm = _mm_mul_ps( remainingTerm, invFreq );
 				exp = _mm_mul_ps( exp, m_Freq );
+				++octave;
 			}
+			FAST_INSTRUMENT_COUNT( CounterOctaves, octave );
 
-			return _mm_div_ps( result, m_Max );
+			return Clamp( Precision::Div( result, m_Max ), minValue, maxValue );
 		}
 		
+		template < typename Precision >
+		inline __m128 SseRidgedFractal::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return _mm_sub_ps( _mm_mul_ps( GetValue< Precision >( xxxx, yyyy, zzzz ), Constants::Fc_2 ), Constants::Fc_1 );
+		}
+
 		inline __m128 SseRidgedFractal::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
 		{
-			return _mm_sub_ps( _mm_mul_ps( GetValue( xxxx, yyyy, zzzz ), Constants::Fc_2 ), Constants::Fc_1 );
+			return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		inline void SseRidgedFractal::GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			const float freq = GetLane( m_Freq, 0 );
+			FunctionBounds::OctaveBounds noise;
+			FunctionBounds::GetNoiseOctaveBounds( m_Noise, region, freq, m_NumOctaves, samples, noise );
+			FunctionBounds::GetRidgedFractalBounds( noise, m_NumOctaves, freq, GetLane( m_Gain, 0 ), GetLane( m_Max, 0 ), minValue, maxValue );
+		}
+
+		inline void SseRidgedFractal::GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			GetBounds( region, minValue, maxValue, samples );
+			minValue = minValue * 2 - 1;
+			maxValue = maxValue * 2 - 1;
 		}
 	};
 };
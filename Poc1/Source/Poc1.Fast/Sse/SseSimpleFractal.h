@@ -1,5 +1,6 @@
 #pragma once
 #include "SseNoise.h"
+#include "SseFunctionBounds.h"
 
 #pragma unmanaged
 
@@ -7,7 +8,7 @@ namespace Poc1
 {
 	namespace Fast
 	{
-		class _CRT_ALIGN( 16 ) SseSimpleFractal
+		class FAST_ALIGN( 16 ) SseSimpleFractal
 		{
 			public :
 
@@ -26,13 +27,40 @@ namespace Poc1
 				///	\brief	Sets up fractal parameters
 				void Setup( const float freq, const float persistence, const int numOctaves );
 
+				///	\brief	Gets the wavelength of the finest octave, in input units (the noise lattice spacing, divided by the scale of its inputs)
+				float GetFinestWavelength( ) const;
+
 				///	\brief	Gets 4 fractal values from 4 points. Returns a value in the range [0,1]
 				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets 4 fractal values from 4 points. Returns a value in the range [0,1], using a given precision policy
+				template < typename Precision >
+				__m128 GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 				
 				///	\brief	Gets 4 fractal values from 4 points. Returns a value in the range [-1,1]
 				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
 
+				///	\brief	Gets 4 fractal values from 4 points. Returns a value in the range [-1,1], using a given precision policy
+				template < typename Precision >
+				__m128 GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const;
+
+				///	\brief	Gets 4 fractal values from 4 points, clamped to [minValue,maxValue]
+				///
+				///	Returns Clamp( GetValue(), minValue, maxValue ), but stops evaluating octaves once the remaining
+				///	octaves can't move any of the 4 values back inside the range. Useful for consumers that saturate
+				///	the fractal output (clouds, for example), where most points end up clamped.
+				///
+				template < typename Precision >
+				__m128 GetClampedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& minValue, const __m128& maxValue ) const;
+
+				///	\brief	Gets the range of values that GetValue() can return for points in a region
+				void GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
 
+				///	\brief	Gets the range of values that GetSignedValue() can return for points in a region
+				///
+				///	Each octave adds its noise range (see FunctionBounds::GetNoiseOctaveBounds()), scaled by its amplitude.
+				///
+				void GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples = FunctionBounds::DefaultSamples ) const;
 
 			private :
 
@@ -77,38 +105,137 @@ namespace Poc1
 			}
 		}
 
+		inline float SseSimpleFractal::GetFinestWavelength( ) const
+		{
+			//	Each octave after the first scales its inputs by freq
+			const float freq = GetLane( m_Freq, 0 );
+			float wavelength = 1;
+			for ( int octave = 1; octave < m_NumOctaves; ++octave )
+			{
+				wavelength /= freq;
+			}
+			return wavelength;
+		}
+
+		template < typename Precision >
 		inline __m128 SseSimpleFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
 		{
+			FAST_INSTRUMENT_COUNT( CounterOctaves, m_NumOctaves );
+
 			__m128 total = Constants::Fc_0;
 			__m128 amp = Constants::Fc_1;
 
 			for ( int octave = 0; octave < m_NumOctaves; ++octave )
 			{
-				total = _mm_add_ps( total, _mm_mul_ps( m_Noise.Noise( xxxx, yyyy, zzzz ), amp ) );
+				total = _mm_add_ps( total, _mm_mul_ps( m_Noise.Noise< Precision >( xxxx, yyyy, zzzz ), amp ) );
 				amp = _mm_mul_ps( amp, m_Persistence );
 				xxxx = _mm_mul_ps( xxxx, m_Freq );
 				yyyy = _mm_mul_ps( yyyy, m_Freq );
 				zzzz = _mm_mul_ps( zzzz, m_Freq );
 			}
 
-			return _mm_div_ps( _mm_add_ps( total, m_Max ), _mm_mul_ps( m_Max, Constants::Fc_2 ) );
+			return Precision::Div( _mm_add_ps( total, m_Max ), _mm_mul_ps( m_Max, Constants::Fc_2 ) );
+		}
+
+		inline __m128 SseSimpleFractal::GetValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return GetValue< SseExactPrecision >( xxxx, yyyy, zzzz );
 		}
 		
+		template < typename Precision >
 		inline __m128 SseSimpleFractal::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
 		{
+			FAST_INSTRUMENT_COUNT( CounterOctaves, m_NumOctaves );
+
 			__m128 total = Constants::Fc_0;
 			__m128 amp = Constants::Fc_1;
 
 			for ( int octave = 0; octave < m_NumOctaves; ++octave )
 			{
-				total = _mm_add_ps( total, _mm_mul_ps( m_Noise.Noise( xxxx, yyyy, zzzz ), amp ) );
+				total = _mm_add_ps( total, _mm_mul_ps( m_Noise.Noise< Precision >( xxxx, yyyy, zzzz ), amp ) );
 				amp = _mm_mul_ps( amp,m_Persistence );
 				xxxx = _mm_mul_ps( xxxx, m_Freq );
 				yyyy = _mm_mul_ps( yyyy, m_Freq );
 				zzzz = _mm_mul_ps( zzzz, m_Freq );
 			}
 
-			return _mm_div_ps( total, m_Max );
+			return Precision::Div( total, m_Max );
+		}
+
+		inline __m128 SseSimpleFractal::GetSignedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz ) const
+		{
+			return GetSignedValue< SseExactPrecision >( xxxx, yyyy, zzzz );
+		}
+
+		template < typename Precision >
+		inline __m128 SseSimpleFractal::GetClampedValue( __m128 xxxx, __m128 yyyy, __m128 zzzz, const __m128& minValue, const __m128& maxValue ) const
+		{
+			//	GetValue() is ( total + m_Max ) / ( m_Max * 2 ), so the range is mapped back onto octave totals. The range
+			//	is widened slightly, so that rounding in the remaining octaves can't move a value across it
+			const __m128 scale = _mm_mul_ps( m_Max, Constants::Fc_2 );
+			const __m128 allowance = _mm_mul_ps( m_Max, _mm_set1_ps( FunctionBounds::RoundingAllowance ) );
+			const __m128 minTotal = _mm_sub_ps( _mm_sub_ps( _mm_mul_ps( minValue, scale ), m_Max ), allowance );
+			const __m128 maxTotal = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( maxValue, scale ), m_Max ), allowance );
+			const __m128 noiseMax = _mm_set1_ps( FunctionBounds::NoiseMaxValue );
+
+			__m128 total = Constants::Fc_0;
+			__m128 amp = Constants::Fc_1;
+			__m128 remainingAmp = m_Max;
+
+			int octave = 0;
+			while ( octave < m_NumOctaves )
+			{
+				total = _mm_add_ps( total, _mm_mul_ps( m_Noise.Noise< Precision >( xxxx, yyyy, zzzz ), amp ) );
+				remainingAmp = _mm_sub_ps( remainingAmp, amp );
+				amp = _mm_mul_ps( amp, m_Persistence );
+				xxxx = _mm_mul_ps( xxxx, m_Freq );
+				yyyy = _mm_mul_ps( yyyy, m_Freq );
+				zzzz = _mm_mul_ps( zzzz, m_Freq );
+				++octave;
+
+				//	Stop if every value is below the range, or above it, whatever the remaining octaves add
+				const __m128 remaining = _mm_mul_ps( remainingAmp, noiseMax );
+				const __m128 below = _mm_cmplt_ps( _mm_add_ps( total, remaining ), minTotal );
+				const __m128 above = _mm_cmpgt_ps( _mm_sub_ps( total, remaining ), maxTotal );
+				if ( _mm_movemask_ps( _mm_or_ps( below, above ) ) == 0xf )
+				{
+					break;
+				}
+			}
+			FAST_INSTRUMENT_COUNT( CounterOctaves, octave );
+
+			return Clamp( Precision::Div( _mm_add_ps( total, m_Max ), scale ), minValue, maxValue );
+		}
+
+		inline void SseSimpleFractal::GetBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			//	GetValue() is ( GetSignedValue() + 1 ) / 2
+			GetSignedBounds( region, minValue, maxValue, samples );
+			minValue = ( minValue + 1 ) * 0.5f;
+			maxValue = ( maxValue + 1 ) * 0.5f;
+		}
+
+		inline void SseSimpleFractal::GetSignedBounds( const SseFunctionRegion& region, float& minValue, float& maxValue, const int samples ) const
+		{
+			FunctionBounds::OctaveBounds noise;
+			FunctionBounds::GetNoiseOctaveBounds( m_Noise, region, GetLane( m_Freq, 0 ), m_NumOctaves, samples, noise );
+
+			const float persistence = GetLane( m_Persistence, 0 );
+			float amp = 1;
+			minValue = 0;
+			maxValue = 0;
+			for ( int octave = 0; octave < m_NumOctaves; ++octave )
+			{
+				float minTerm = noise.GetMin( octave );
+				float maxTerm = noise.GetMax( octave );
+				FunctionBounds::Scale( minTerm, maxTerm, amp );
+				minValue += minTerm;
+				maxValue += maxTerm;
+				amp *= persistence;
+			}
+
+			FunctionBounds::Scale( minValue, maxValue, 1 / GetLane( m_Max, 0 ) );
+			FunctionBounds::Widen( minValue, maxValue );
 		}
 	};
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SseConstants.h"
+#include "SsePrecision.h"
 #include "UEnums.h"
 
 #pragma managed(push, off)
@@ -20,6 +21,22 @@ namespace Poc1
 		{
 			return _mm_max_ps( _mm_min_ps( val, max ), min );
 		}
+
+		///	\brief	Gets a single value from a floating point vector. Lane 0 is the last argument of _mm_set_ps()
+		inline float GetLane( const __m128& val, const int lane )
+		{
+			FAST_ALIGN( 16 ) float lanes[ 4 ];
+			_mm_store_ps( lanes, val );
+			return lanes[ lane ];
+		}
+
+		///	\brief	Gets a single value from an integer vector. Lane 0 is the last argument of _mm_set_epi32()
+		inline int GetLane( const __m128i& val, const int lane )
+		{
+			FAST_ALIGN( 16 ) int lanes[ 4 ];
+			_mm_store_si128( ( __m128i* )lanes, val );
+			return lanes[ lane ];
+		}
 		
 		///	\brief	Gets the position on a cube map face
 		inline void CubeFacePosition( const UCubeMapFace face, const __m128& uuuu, const __m128& vvvv, __m128& xxxx, __m128& yyyy, __m128& zzzz )
@@ -67,27 +84,90 @@ namespace Poc1
 
 		}
 
+		///	\brief	Coefficients of the odd polynomial used by TangentCubeFaceCoordinate(), lowest power first
+		const float TangentCubeFaceCoefficients[ 6 ] = { 0.785396874f, 0.161528096f, 0.0395636559f, 0.0108593898f, 0.00110479607f, 0.00154716952f };
+
+		///	\brief	Coefficients of the odd polynomial used by InverseTangentCubeFaceCoordinate(), lowest power first
+		const float InverseTangentCubeFaceCoefficients[ 8 ] = { 1.27323878f, -0.424368978f, 0.253967494f, -0.177089885f, 0.122767568f, -0.0711888671f, 0.0278361719f, -0.00516227214f };
+
+		///	\brief	Evaluates an odd polynomial t.( c0 + c1.t^2 + c2.t^4 ... ) at 4 values, by Horner's rule in t^2
+		inline __m128 OddPolynomial( const __m128& tttt, const float* coefficients, const int count )
+		{
+			const __m128 tttt2 = _mm_mul_ps( tttt, tttt );
+			__m128 res = _mm_set1_ps( coefficients[ count - 1 ] );
+			for ( int power = count - 2; power >= 0; --power )
+			{
+				res = _mm_add_ps( _mm_mul_ps( res, tttt2 ), _mm_set1_ps( coefficients[ power ] ) );
+			}
+			return _mm_mul_ps( tttt, res );
+		}
+
+		///	\brief	Maps 4 tangent-adjusted face coordinates in [-1,1] to positions on a cube face, by tan( t * pi / 4 )
+		///
+		///	Tangent-adjusted coordinates are proportional to the angle from the face centre, so texels spaced evenly
+		///	in them cover nearly equal areas of the sphere. The tangent is approximated by an odd polynomial (error
+		///	below 3e-7) that maps -1, 0 and 1 exactly onto themselves, so faces still meet at their edges.
+		///
+		inline __m128 TangentCubeFaceCoordinate( const __m128& tttt )
+		{
+			return OddPolynomial( tttt, TangentCubeFaceCoefficients, 6 );
+		}
+
+		///	\brief	Inverse of TangentCubeFaceCoordinate(). Maps 4 positions in [-1,1] on a cube face to tangent-adjusted face coordinates, by atan( p ) * 4 / pi
+		///
+		///	This is the lookup used to sample tangent-adjusted cube maps (see Effects/Shared/cubeMapProjection.cg). The
+		///	arctangent is approximated by an odd polynomial, with an error below 3e-7.
+		///
+		inline __m128 InverseTangentCubeFaceCoordinate( const __m128& pppp )
+		{
+			return OddPolynomial( pppp, InverseTangentCubeFaceCoefficients, 8 );
+		}
+
+		///	\brief	Gets the position on a cube map face, from face coordinates in a given projection
+		inline void CubeFacePosition( const UCubeMapFace face, const UCubeMapProjection projection, const __m128& uuuu, const __m128& vvvv, __m128& xxxx, __m128& yyyy, __m128& zzzz )
+		{
+			if ( projection == ProjectionTangent )
+			{
+				CubeFacePosition( face, TangentCubeFaceCoordinate( uuuu ), TangentCubeFaceCoordinate( vvvv ), xxxx, yyyy, zzzz );
+				return;
+			}
+			CubeFacePosition( face, uuuu, vvvv, xxxx, yyyy, zzzz );
+		}
+
 		///	\brief	Rounds 4 floating point values to integers
 		inline __m128i RoundToInt( __m128 v )
 		{
 			return _mm_cvtps_epi32( _mm_sub_ps( v, _mm_set1_ps( 0.5f ) ) );
 		}
 
-		///	\brief	Sets the length of 4 vectors
+		///	\brief	Wraps 4 integers in the range [-period,2*period) into the range [0,period)
+		inline __m128i WrapToPeriod( __m128i iiii, const __m128i& period )
+		{
+			iiii = _mm_add_epi32( iiii, _mm_and_si128( period, _mm_cmplt_epi32( iiii, _mm_setzero_si128( ) ) ) );
+			return _mm_sub_epi32( iiii, _mm_andnot_si128( _mm_cmplt_epi32( iiii, period ), period ) );
+		}
+
+		///	\brief	Sets the length of 4 vectors, using a given precision policy (see SsePrecision.h)
+		template < typename Precision >
 		inline void SetLength( __m128& xxxx, __m128& yyyy, __m128& zzzz, const __m128& len )
 		{
 			__m128 xxxx2 = _mm_mul_ps( xxxx, xxxx );
 			__m128 yyyy2 = _mm_mul_ps( yyyy, yyyy );
 			__m128 zzzz2 = _mm_mul_ps( zzzz, zzzz );
 
-			//	NOTE: AP: Don't use reciprocal sqrt - has dubious precision
-			__m128 sqr = _mm_sqrt_ps( _mm_add_ps( xxxx2, _mm_add_ps( yyyy2, zzzz2 ) ) );
-			sqr = _mm_div_ps( len, sqr );
+			__m128 sqr = Precision::DivSqrt( len, _mm_add_ps( xxxx2, _mm_add_ps( yyyy2, zzzz2 ) ) );
 			xxxx = _mm_mul_ps( xxxx, sqr );
 			yyyy = _mm_mul_ps( yyyy, sqr );
 			zzzz = _mm_mul_ps( zzzz, sqr );
 		}
 
+		///	\brief	Sets the length of 4 vectors
+		inline void SetLength( __m128& xxxx, __m128& yyyy, __m128& zzzz, const __m128& len )
+		{
+			//	NOTE: AP: Don't use reciprocal sqrt - has dubious precision
+			SetLength< SseExactPrecision >( xxxx, yyyy, zzzz, len );
+		}
+
 		///	\brief	Sets the length of 4 vectors
 		inline void SetLength( __m128& xxxx, __m128& yyyy, __m128& zzzz, const float len )
 		{
@@ -95,17 +175,34 @@ namespace Poc1
 			SetLength( xxxx, yyyy, zzzz, llll );
 		}
 
+		///	\brief	Gets the lengths of 4 vectors, using a given precision policy (see SsePrecision.h)
+		template < typename Precision >
 		inline __m128 GetLengths( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz )
 		{
 			__m128 xxxx2 = _mm_mul_ps( xxxx, xxxx );
 			__m128 yyyy2 = _mm_mul_ps( yyyy, yyyy );
 			__m128 zzzz2 = _mm_mul_ps( zzzz, zzzz );
-			
+
+			return Precision::Sqrt( _mm_add_ps( xxxx2, _mm_add_ps( yyyy2, zzzz2 ) ) );
+		}
+
+		inline __m128 GetLengths( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz )
+		{
 			//	NOTE: AP: Don't use reciprocal sqrt - has dubious precision
-			return _mm_sqrt_ps( _mm_add_ps( xxxx2, _mm_add_ps( yyyy2, zzzz2 ) ) );
+			return GetLengths< SseExactPrecision >( xxxx, yyyy, zzzz );
 		}
-		
+
+		///	\brief	Normalizes 4 vectors, using a given precision policy (see SsePrecision.h)
+		template < typename Precision >
+		inline void Normalize( __m128& xxxx, __m128& yyyy, __m128& zzzz )
+		{
+			SetLength< Precision >( xxxx, yyyy, zzzz, Constants::Fc_1 );
+		}
+
 		///	\brief	Normalizes 4 vectors, stored component-wise in 4 SSE values
+		///
+		///	Uses an unrefined reciprocal square root. Use Normalize< SseExactPrecision > for full precision.
+		///
 		inline void Normalize( __m128& xxxx, __m128& yyyy, __m128& zzzz )
 		{
 			__m128 xxxx2 = _mm_mul_ps( xxxx, xxxx );
@@ -156,6 +253,51 @@ namespace Poc1
 			return _mm_and_ps( val, Constants::Fc_Sign );
 		}
 
+		///	\brief	Gets the cube map faces that 4 directions point at. Inverts CubeFacePosition()
+		///
+		///	Each direction is on the face of its major (largest magnitude) axis. Ties go to x, then y, so every
+		///	direction has one face. Faces are UCubeMapFace values, as floats. The gnomonic face coordinates of each
+		///	direction are ( uuuu, vvvv ) / major, where major is the magnitude of the major axis.
+		///
+		inline void GetCubeFaceCoordinates( const __m128& xxxx, const __m128& yyyy, const __m128& zzzz, __m128& faces, __m128& uuuu, __m128& vvvv, __m128& major )
+		{
+			//	Values are selected from the x axis where xMajor is set, then the y axis where yMajor is set,
+			//	otherwise from the z axis
+			const __m128 absXxxx = Abs( xxxx );
+			const __m128 absYyyy = Abs( yyyy );
+			const __m128 absZzzz = Abs( zzzz );
+			const __m128 xMajor = _mm_and_ps( _mm_cmpge_ps( absXxxx, absYyyy ), _mm_cmpge_ps( absXxxx, absZzzz ) );
+			const __m128 yMajor = _mm_cmpge_ps( absYyyy, absZzzz );
+
+			const __m128 xNegative = _mm_cmplt_ps( xxxx, Constants::Fc_0 );
+			const __m128 yNegative = _mm_cmplt_ps( yyyy, Constants::Fc_0 );
+			const __m128 zNegative = _mm_cmplt_ps( zzzz, Constants::Fc_0 );
+
+			//	Invert CubeFacePosition() for each face:
+			//		NegativeX: u = z	v = y		PositiveX: u = -z	v = y
+			//		NegativeY: u = -x	v = -z		PositiveY: u = -x	v = z
+			//		NegativeZ: u = -x	v = y		PositiveZ: u = x	v = y
+			const __m128 negXxxx = Neg( xxxx );
+			const __m128 negZzzz = Neg( zzzz );
+			const __m128 xFaceU = _mm_or_ps( _mm_and_ps( xNegative, zzzz ), _mm_andnot_ps( xNegative, negZzzz ) );
+			const __m128 yFaceV = _mm_or_ps( _mm_and_ps( yNegative, negZzzz ), _mm_andnot_ps( yNegative, zzzz ) );
+			const __m128 zFaceU = _mm_or_ps( _mm_and_ps( zNegative, negXxxx ), _mm_andnot_ps( zNegative, xxxx ) );
+
+			const __m128 yzFaceU = _mm_or_ps( _mm_and_ps( yMajor, negXxxx ), _mm_andnot_ps( yMajor, zFaceU ) );
+			const __m128 yzFaceV = _mm_or_ps( _mm_and_ps( yMajor, yFaceV ), _mm_andnot_ps( yMajor, yyyy ) );
+			const __m128 yzMajor = _mm_or_ps( _mm_and_ps( yMajor, absYyyy ), _mm_andnot_ps( yMajor, absZzzz ) );
+			uuuu = _mm_or_ps( _mm_and_ps( xMajor, xFaceU ), _mm_andnot_ps( xMajor, yzFaceU ) );
+			vvvv = _mm_or_ps( _mm_and_ps( xMajor, yyyy ), _mm_andnot_ps( xMajor, yzFaceV ) );
+			major = _mm_or_ps( _mm_and_ps( xMajor, absXxxx ), _mm_andnot_ps( xMajor, yzMajor ) );
+
+			//	Faces are ordered -x, +x, -y, +y, -z, +z (see UCubeMapFace)
+			const __m128 yzFaces = _mm_or_ps( _mm_and_ps( yMajor, Constants::Fc_2 ), _mm_andnot_ps( yMajor, Constants::Fc_4 ) );
+			const __m128 yzNegative = _mm_or_ps( _mm_and_ps( yMajor, yNegative ), _mm_andnot_ps( yMajor, zNegative ) );
+			const __m128 negative = _mm_or_ps( _mm_and_ps( xMajor, xNegative ), _mm_andnot_ps( xMajor, yzNegative ) );
+			faces = _mm_andnot_ps( xMajor, yzFaces );
+			faces = _mm_add_ps( faces, _mm_andnot_ps( negative, Constants::Fc_1 ) );
+		}
+
 		///	\brief	Fades floating point values
 		inline static __m128 Fade( const __m128& v )
 		{
@@ -190,6 +332,12 @@ namespace Poc1
 			return _mm_add_ps( a, _mm_mul_ps( _mm_sub_ps( b, a ), t ) );
 		}
 
+		///	\brief	Smooths 4 values in the range [0,1] (3t2-2t3)
+		inline __m128 SmoothStep( const __m128& t )
+		{
+			return _mm_mul_ps( _mm_mul_ps( t, t ), _mm_sub_ps( _mm_set1_ps( 3.0f ), _mm_mul_ps( t, Constants::Fc_2 ) ) );
+		}
+
 		///	\brief	Noise utility function: Returns the gradient for a given hash value
 		///
 		///	Adapted to SSE2 from Ken Perlin's Improved Noise function:
@@ -13,7 +13,7 @@ namespace Poc1
 
 
 		///	\brief	A group of 4 vectors
-		class _CRT_ALIGN( 16 ) SseVectorGroup
+		class FAST_ALIGN( 16 ) SseVectorGroup
 		{
 
 			public :
@@ -0,0 +1,162 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Instrumentation.h"
+
+///	\brief	Set to 0 to compile trace spans out of the generators
+///
+///	Spans are only recorded while tracing is switched on (see Trace::SetRecording()), so they cost a
+///	flag check when compiled in but not recording.
+///
+#ifndef POC1_FAST_TRACING
+#define POC1_FAST_TRACING 1
+#endif
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Records scoped trace spans into per-thread ring buffers, and writes them out as Chrome trace JSON
+		///
+		///	Each thread writes to its own ring buffer, so recording never takes a lock. When a ring buffer
+		///	fills up, the oldest spans are overwritten. Output can be loaded into chrome://tracing or Perfetto.
+		///
+		class FAST_API Trace
+		{
+			public :
+
+				///	\brief	Maximum number of spans kept per thread
+				static const int RingSize = 8192;
+
+				///	\brief	Starts or stops recording spans
+				static void SetRecording( const bool recording );
+
+				///	\brief	Returns true if spans are being recorded
+				static bool IsRecording( );
+
+				///	\brief	Adds a span to the calling thread's ring buffer. name must be a string literal
+				static void AddSpan( const char* name, const long long startTicks, const long long endTicks, const int arg );
+
+				///	\brief	Discards all recorded spans
+				static void Clear( );
+
+				///	\brief	Writes all recorded spans to a file, in Chrome trace event format. Returns false on failure
+				static bool WriteChromeTrace( const char* path );
+		};
+
+		///	\brief	Phases of face and patch generation
+		enum UTracePhase
+		{
+			TracePhaseCacheFill,		///<	Filling caches before the main loop (seams, rings, first rows)
+			TracePhaseDisplacement,		///<	Displacing positions
+			TracePhaseNormals,			///<	Calculating normals or slopes from displaced positions
+			TracePhaseStore,			///<	Writing pixels out to mip chains and compressed blocks
+
+			NumTracePhases
+		};
+
+		///	\brief	Adds a span for each phase of a face or patch, when this object is destroyed
+		///
+		///	Phases alternate row by row, so a span for each phase change would flood the ring buffer. Instead,
+		///	the time spent in each phase is added up, and the phase spans are laid end to end from the start of
+		///	the first phase. The argument of each phase span is the number of times the phase was entered.
+		///
+		class FAST_API TracePhases
+		{
+			public :
+
+				///	\brief	Starts timing phases, if tracing is recording
+				TracePhases( ) :
+					m_Phase( -1 ),
+					m_PhaseStart( 0 ),
+					m_Start( Trace::IsRecording( ) ? Instrumentation::GetTicks( ) : -1 )
+				{
+					for ( int phase = 0; phase < NumTracePhases; ++phase )
+					{
+						m_Ticks[ phase ] = 0;
+						m_Entries[ phase ] = 0;
+					}
+				}
+
+				///	\brief	Adds the phase spans
+				~TracePhases( );
+
+				///	\brief	Ends the current phase, and starts another
+				void Begin( const UTracePhase phase )
+				{
+					if ( m_Start >= 0 )
+					{
+						const long long now = Instrumentation::GetTicks( );
+						EndPhase( now );
+						m_Phase = phase;
+						m_PhaseStart = now;
+						++m_Entries[ phase ];
+					}
+				}
+
+			private :
+
+				int			m_Phase;
+				long long	m_PhaseStart;
+				long long	m_Start;
+				long long	m_Ticks[ NumTracePhases ];
+				int			m_Entries[ NumTracePhases ];
+
+				void EndPhase( const long long now )
+				{
+					if ( m_Phase >= 0 )
+					{
+						m_Ticks[ m_Phase ] += now - m_PhaseStart;
+					}
+				}
+		};
+
+		///	\brief	Adds a span to the trace covering the lifetime of this object
+		class TraceScope
+		{
+			public :
+
+				///	\brief	Starts the span, if tracing is recording
+				TraceScope( const char* name, const int arg ) :
+					m_Name( name ),
+					m_Arg( arg ),
+					m_Start( Trace::IsRecording( ) ? Instrumentation::GetTicks( ) : -1 )
+				{
+				}
+
+				///	\brief	Ends the span
+				~TraceScope( )
+				{
+					if ( m_Start >= 0 )
+					{
+						Trace::AddSpan( m_Name, m_Start, Instrumentation::GetTicks( ), m_Arg );
+					}
+				}
+
+			private :
+
+				const char*	m_Name;
+				int			m_Arg;
+				long long	m_Start;
+		};
+
+	}; //Fast
+}; //Poc1
+
+#if POC1_FAST_TRACING
+
+	#define FAST_TRACE_SCOPE( Name )			::Poc1::Fast::TraceScope traceScope_( Name, 0 )
+	#define FAST_TRACE_SCOPE_ARG( Name, Arg )	::Poc1::Fast::TraceScope traceScope_( Name, ( Arg ) )
+	#define FAST_TRACE_PHASES( )				::Poc1::Fast::TracePhases tracePhases_
+	#define FAST_TRACE_PHASE( Phase )			tracePhases_.Begin( ::Poc1::Fast::Phase )
+
+#else
+
+	#define FAST_TRACE_SCOPE( Name )
+	#define FAST_TRACE_SCOPE_ARG( Name, Arg )
+	#define FAST_TRACE_PHASES( )
+	#define FAST_TRACE_PHASE( Phase )
+
+#endif
+
+#pragma managed(pop)
@@ -17,14 +17,42 @@ namespace Poc1
 			NegativeZ,
 			PositiveZ
 		};
+
+		///	\brief	Mappings from cube map face coordinates to positions on cube faces (see CubeFacePosition() in SseUtils.h)
+		enum UCubeMapProjection
+		{
+			ProjectionGnomonic,		///<	Face coordinates are positions on the face. Corner texels cover about a fifth of the sphere area of centre texels
+			ProjectionTangent		///<	Face coordinates are angles, warped onto the face by tan( u * pi / 4 ). Texel areas vary by about 1.4x
+		};
 		
 		///	\brief	Unmanaged pixel formats
 		enum UPixelFormat
 		{
 			FormatR8G8B8,
 			FormatR8G8B8A8,
+			FormatB8G8R8A8,
+			FormatA8,			///<	Single channel alpha
+			FormatR8,			///<	Single channel red (also used for luminance and 8 bit palette indices)
+			FormatB8G8R8,		///<	Blue first, as GDI+ stores 24 bit pixels
 		};
 
+		///	\brief	Gets the size of a pixel in a given format, in bytes
+		inline int GetBytesPerPixel( const UPixelFormat format )
+		{
+			switch ( format )
+			{
+				case FormatR8G8B8	:
+				case FormatB8G8R8	: return 3;
+				case FormatR8G8B8A8	:
+				case FormatB8G8R8A8	: return 4;
+				case FormatA8		:
+				case FormatR8		: return 1;
+			}
+			return 4;
+		}
+
+		#ifdef _MANAGED
+
 		#pragma managed
 
 		///	\brief	Converts a PixelFormat value to a UPixelFormat value
@@ -32,8 +60,9 @@ namespace Poc1
 		{
 			switch ( format )
 			{
-				case System::Drawing::Imaging::PixelFormat::Format24bppRgb : return FormatR8G8B8;
-				case System::Drawing::Imaging::PixelFormat::Format32bppArgb : return FormatR8G8B8A8;
+				case System::Drawing::Imaging::PixelFormat::Format24bppRgb : return FormatB8G8R8;
+				case System::Drawing::Imaging::PixelFormat::Format32bppArgb : return FormatB8G8R8A8;
+				case System::Drawing::Imaging::PixelFormat::Format8bppIndexed : return FormatR8;
 			}
 			throw gcnew System::ArgumentException( "Unhandled pixel format", "format" );
 		}
@@ -52,6 +81,8 @@ namespace Poc1
 			}
 			return NegativeX;
 		}
+
+		#endif
 		
 		#pragma managed(pop)
 	};
@@ -0,0 +1,194 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "UEnums.h"
+#include "UMappedFileWindows.h"
+#include <stdio.h>
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Texel formats of heightmap files
+		enum UHeightmapFormat
+		{
+			HeightmapUnsigned16,	///<	16-bit unsigned texels, mapping 0 and 65535 onto the minimum and maximum heights
+			HeightmapFloat32		///<	32-bit float texels, storing heights
+		};
+
+		///	\brief	Header of a heightmap file
+		struct UHeightmapHeader
+		{
+			unsigned int	m_Magic;			///<	UHeightmapFile::Magic
+			unsigned int	m_Version;			///<	UHeightmapFile::Version
+			int				m_Format;			///<	UHeightmapFormat of the texels
+			int				m_Projection;		///<	UCubeMapProjection of the faces
+			int				m_Resolution;		///<	Texels along each side of a face
+			int				m_TileSize;			///<	Texels along each side of a tile. A power of 2
+			float			m_MinHeight;		///<	Smallest height in the file
+			float			m_MaxHeight;		///<	Largest height in the file
+			long long		m_RangeOffset;		///<	Offset of the tile ranges from the start of the file
+			long long		m_TexelOffset;		///<	Offset of the first tile from the start of the file
+		};
+
+		///	\brief	A cube map of heights, read from a tiled heightmap file through memory mapped windows
+		///
+		///	Each face is resolution x resolution texels. Texel ( row, col ) is at face coordinates
+		///	( 2 * col / ( resolution - 1 ) - 1, 2 * row / ( resolution - 1 ) - 1 ), passed to CubeFacePosition()
+		///	with the projection of the file, so texels along the edges of a face are repeated in the faces
+		///	that share the edge.
+		///
+		///	Faces are split into square tiles, which are stored whole, so neighbouring texels are nearby in the
+		///	file whichever way they neighbour each other. Tiles past the last row or column of a face are
+		///	padded with zeros. The file is mapped a window at a time (see UMappedFileWindows), and only the pages
+		///	that are sampled are read, so heightmaps can be much larger than memory and address space. Texels
+		///	can be read from more than one thread at once.
+		///
+		///	File layout: a UHeightmapHeader, then the smallest and largest height of each tile (2 floats per
+		///	tile, normalized like GetTexel() values), then the tiles (starting at a multiple of 16 bytes). Tiles
+		///	are ordered face by face, then row by row. Values are written in native byte order.
+		///
+		class FAST_API UHeightmapFile
+		{
+			public :
+
+				enum
+				{
+					Magic				= 0x4d483150,	///<	"P1HM"
+					Version				= 1,
+					DefaultWindowSize	= 16 << 20,		///<	Default size of the windows that the file is mapped through, in bytes
+					DefaultMaxWindows	= 32			///<	Default number of windows mapped at once
+				};
+
+				///	\brief	Sets up a closed heightmap
+				UHeightmapFile( );
+
+				///	\brief	Closes the file
+				~UHeightmapFile( );
+
+				///	\brief	Opens a heightmap file. Returns false if the file could not be opened, or is not a heightmap
+				///
+				///	At most maxWindows windows of windowSize bytes are mapped at once.
+				///
+				bool Open( const char* path, const long long windowSize = DefaultWindowSize, const int maxWindows = DefaultMaxWindows );
+
+				///	\brief	Closes the file
+				void Close( );
+
+				///	\brief	Returns true if a file is open
+				bool IsOpen( ) const;
+
+				///	\brief	Gets the header of the open file
+				const UHeightmapHeader& GetHeader( ) const;
+
+				///	\brief	Gets the number of texels along each side of a face
+				int GetResolution( ) const;
+
+				///	\brief	Gets the cube map projection of the faces
+				UCubeMapProjection GetProjection( ) const;
+
+				///	\brief	Gets the height of a texel, normalized so that the minimum and maximum heights of the file map to 0 and 1
+				float GetTexel( const int face, const int row, const int col ) const;
+
+				///	\brief	Gets the heights of count texels, normalized like GetTexel(). Cheaper than calling GetTexel() for each
+				void GetTexels( const int count, const int* faces, const int* rows, const int* cols, float* texels ) const;
+
+				///	\brief	Gets the range of texels in a rectangle of a face, normalized like GetTexel()
+				///
+				///	The range is made from the ranges of the tiles that overlap the rectangle, so it can be wider than
+				///	the range of the texels in the rectangle. Rows and columns are clamped to the face.
+				///
+				void GetRange( const int face, const int minRow, const int minCol, const int maxRow, const int maxCol, float& minValue, float& maxValue ) const;
+
+			private :
+
+				mutable UMappedFileWindows	m_Windows;
+				mutable volatile long		m_WindowsLock;
+				UHeightmapHeader			m_Header;
+				int							m_TilesPerSide;
+				int							m_TileShift;
+				int							m_TileMask;
+				float						m_TexelBias;
+				float						m_TexelScale;
+
+				///	\brief	Reads a texel. The caller must hold m_WindowsLock
+				float ReadTexel( const int face, const int row, const int col ) const;
+
+				UHeightmapFile( const UHeightmapFile& );
+				UHeightmapFile& operator = ( const UHeightmapFile& );
+		};
+
+		///	\brief	Writes heightmap files, a row at a time, for UHeightmapFile
+		///
+		///	Rows are written face by face, from the first row of NegativeX to the last row of PositiveZ. Only one
+		///	row of tiles is kept in memory.
+		///
+		class FAST_API UHeightmapWriter
+		{
+			public :
+
+				///	\brief	Sets up a writer with no file
+				UHeightmapWriter( );
+
+				///	\brief	Closes any unfinished file
+				~UHeightmapWriter( );
+
+				///	\brief	Creates a heightmap file. Returns false if the file could not be created
+				///
+				///	resolution must be at least 2, and tileSize a power of 2. Heights are clamped to
+				///	[minHeight,maxHeight], which must not be empty.
+				///
+				bool Start( const char* path, const UHeightmapFormat format, const UCubeMapProjection projection, const int resolution, const int tileSize, const float minHeight, const float maxHeight );
+
+				///	\brief	Writes the next row of heights (resolution values)
+				void WriteRow( const float* heights );
+
+				///	\brief	Writes the header, and closes the file. Returns false if any part of the file could not be written, or rows are missing
+				bool Finish( );
+
+			private :
+
+				FILE*						m_File;
+				UHeightmapHeader			m_Header;
+				int							m_TilesPerSide;
+				int							m_Row;
+				bool						m_Written;
+				std::vector< float >		m_Rows;
+				std::vector< float >		m_Ranges;
+
+				///	\brief	Writes the buffered row of tiles
+				void WriteTileRow( );
+
+				UHeightmapWriter( const UHeightmapWriter& );
+				UHeightmapWriter& operator = ( const UHeightmapWriter& );
+		};
+
+		//	------------------------------------------------------- UHeightmapFile Inline Methods
+
+		inline bool UHeightmapFile::IsOpen( ) const
+		{
+			return m_Windows.IsOpen( );
+		}
+
+		inline const UHeightmapHeader& UHeightmapFile::GetHeader( ) const
+		{
+			return m_Header;
+		}
+
+		inline int UHeightmapFile::GetResolution( ) const
+		{
+			return m_Header.m_Resolution;
+		}
+
+		inline UCubeMapProjection UHeightmapFile::GetProjection( ) const
+		{
+			return UCubeMapProjection( m_Header.m_Projection );
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
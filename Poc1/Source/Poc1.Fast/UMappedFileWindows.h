@@ -0,0 +1,109 @@
+#pragma once
+#pragma managed(push, off)
+
+#include "Platform.h"
+#include <vector>
+
+namespace Poc1
+{
+	namespace Fast
+	{
+		///	\brief	Reads a file through a bounded set of memory mapped windows
+		///
+		///	The file is split into windows of a fixed size. A window is mapped when a range inside it is first
+		///	read, and the least recently used window is unmapped when too many are mapped, so files of any size
+		///	can be read with little address space (a 32-bit process can't map a file of more than a gigabyte or
+		///	two in one view). Each window also maps the first overlap bytes of the next window, so any range of
+		///	up to overlap bytes can be read from the window that it starts in.
+		///
+		///	Offsets are 64-bit. Windows are not thread safe.
+		///
+		class FAST_API UMappedFileWindows
+		{
+			public :
+
+				///	\brief	Sets up a closed file
+				UMappedFileWindows( );
+
+				///	\brief	Closes the file
+				~UMappedFileWindows( );
+
+				///	\brief	Opens a file. Returns false if the file could not be opened
+				///
+				///	windowSize is rounded up to a multiple of Platform::GetViewAlignment(). At most maxWindows windows
+				///	(at least 1) are mapped at once.
+				///
+				bool Open( const char* path, const long long windowSize, const long long overlap, const int maxWindows );
+
+				///	\brief	Unmaps all windows, and closes the file
+				void Close( );
+
+				///	\brief	Returns true if a file is open
+				bool IsOpen( ) const;
+
+				///	\brief	Gets the size of the file, in bytes
+				long long GetSize( ) const;
+
+				///	\brief	Gets the number of bytes past the end of each window that can be read from it
+				long long GetOverlap( ) const;
+
+				///	\brief	Gets a range of the file. Returns null if the range isn't inside the file, or is longer than the overlap
+				///
+				///	The range stays mapped until the next call to GetRange() or Prefetch() (or longer, if fewer than
+				///	maxWindows windows are read in between).
+				///
+				const unsigned char* GetRange( const long long offset, const long long size );
+
+				///	\brief	Hints that a range of the file, of up to overlap bytes, will be read soon
+				void Prefetch( const long long offset, const long long size );
+
+			private :
+
+				///	\brief	A window of the file
+				struct Window
+				{
+					const unsigned char*	m_Data;			///<	Mapped view, or null if the window isn't mapped
+					long long				m_LastUsed;		///<	Value of m_Clock when the window was last read
+				};
+
+				Platform::MappedFile		m_File;
+				long long					m_WindowSize;
+				long long					m_Overlap;
+				int							m_MaxWindows;
+				long long					m_Clock;
+				std::vector< Window >		m_Windows;
+				std::vector< int >			m_Mapped;
+
+				///	\brief	Gets the size of the view of a window
+				long long GetViewSize( const int window ) const;
+
+				///	\brief	Maps the window that a range starts in, making it the most recently used. Returns the window, or -1 if the range can't be read
+				int MapWindow( const long long offset, const long long size );
+
+				UMappedFileWindows( const UMappedFileWindows& );
+				UMappedFileWindows& operator = ( const UMappedFileWindows& );
+		};
+
+		//	--------------------------------------------------- UMappedFileWindows Inline Methods
+
+		inline bool UMappedFileWindows::IsOpen( ) const
+		{
+			return m_File.m_Size > 0;
+		}
+
+		inline long long UMappedFileWindows::GetSize( ) const
+		{
+			return m_File.m_Size;
+		}
+
+		inline long long UMappedFileWindows::GetOverlap( ) const
+		{
+			return m_Overlap;
+		}
+
+		//	-----------------------------------------------------------------------------------
+
+	}; //Fast
+}; //Poc1
+
+#pragma managed(pop)
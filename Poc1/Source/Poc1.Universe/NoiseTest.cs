@@ -186,5 +186,46 @@ namespace Poc1.Universe
 			bmp.Save( "FastNoiseTest.bmp", ImageFormat.Bmp );
 		}
 
+		public static unsafe void TestBulkFastNoise( )
+		{
+			FastNoise n = new FastNoise( );
+			n.Threads = System.Environment.ProcessorCount;
+			Bitmap bmp = new Bitmap( Res, Res, PixelFormat.Format24bppRgb );
+
+			float[] x = new float[ Res * Res ];
+			float[] y = new float[ Res * Res ];
+			float[] z = new float[ Res * Res ];
+			float[] results = new float[ Res * Res ];
+			for ( int row = 0; row < Res; ++row )
+			{
+				for ( int col = 0; col < Res; ++col )
+				{
+					x[ row * Res + col ] = RowStart.X + IncCol.X * col;
+					y[ row * Res + col ] = RowStart.Y + IncRow.Y * row;
+					z[ row * Res + col ] = RowStart.Z;
+				}
+			}
+
+			long start = TinyTime.CurrentTime;
+			n.Noise( x, y, z, results );
+			GraphicsLog.Info( "Time taken to generate bulk fast noise: {0:F2} seconds", TinyTime.ToSeconds( start, TinyTime.CurrentTime ) );
+
+			BitmapData bmpData = bmp.LockBits( new Rectangle( 0, 0, bmp.Width, bmp.Height ), ImageLockMode.WriteOnly, bmp.PixelFormat );
+			byte* curRow = ( byte* )bmpData.Scan0;
+			for ( int row = 0; row < bmp.Height; ++row, curRow += bmpData.Stride )
+			{
+				byte* curPixel = curRow;
+				for ( int col = 0; col < bmp.Width; ++col, curPixel += 3 )
+				{
+					curPixel[ 0 ] = ( byte )( 128 + ( byte )( results[ row * Res + col ] * 127.0f ) );
+					curPixel[ 1 ] = curPixel[ 0 ];
+					curPixel[ 2 ] = curPixel[ 0 ];
+				}
+			}
+			bmp.UnlockBits( bmpData );
+
+			bmp.Save( "BulkFastNoiseTest.bmp", ImageFormat.Bmp );
+		}
+
 	}
 }
@@ -29,23 +29,22 @@ namespace Poc1.Tools.TerrainTextures.Core
 
 			byte* pixels = ( byte* )bmpData.Scan0;
 
+			bool independentChannels;
 			if ( parameters.GenerationType == NoiseGenerationType.Grayscale )
 			{
-				noise.GenerateTiledBitmap( bmp.Width, bmp.Height, 3, pixels, parameters.NoiseX, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );
-				noise.GenerateTiledBitmap( bmp.Width, bmp.Height, 3, pixels + 1, parameters.NoiseX, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );
-				noise.GenerateTiledBitmap( bmp.Width, bmp.Height, 3, pixels + 2, parameters.NoiseX, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );
+				independentChannels = false;
 			}
 			else if ( parameters.GenerationType == NoiseGenerationType.MultiChannel )
 			{
-				noise.GenerateTiledBitmap( bmp.Width, bmp.Height, 3, pixels, parameters.NoiseX, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );
-				noise.GenerateTiledBitmap( bmp.Width, bmp.Height, 3, pixels + 1, parameters.NoiseX + parameters.NoiseWidth, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );
-				noise.GenerateTiledBitmap( bmp.Width, bmp.Height, 3, pixels + 2, parameters.NoiseX + parameters.NoiseWidth * 2, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );	
+				independentChannels = true;
 			}
 			else
 			{
 				throw new NotImplementedException( "Unsupported generation type " + parameters.GenerationType );
 			}
 
+			noise.GenerateTiledBitmap( bmp.Width, bmp.Height, bmpData.Stride, 3, independentChannels, pixels, parameters.NoiseX, parameters.NoiseY, parameters.NoiseWidth, parameters.NoiseHeight );
+
 			bmp.UnlockBits( bmpData );
 			return bmp;
 		}